@@ -36,7 +36,10 @@
 #include <asc-hint.h>
 #include <asc-unit.h>
 #include <asc-directory-unit.h>
+#include <asc-memory-unit.h>
+#include <asc-tar-unit.h>
 #include <asc-result.h>
+#include <asc-tarball.h>
 #include <asc-enums-types.h>
 
 #include <asc-image.h>
@@ -24,25 +24,43 @@
  * @include: appstream-compose.h
  */
 
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <sched.h>
+#endif
+
 #include "config.h"
 #include "asc-compose.h"
 
 #include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
 #include <glib/gi18n.h>
+#include <glib/gstdio.h>
 
 #include "as-utils-private.h"
+#include "as-component-private.h"
+#include "as-metadata-private.h"
+#include "as-validator-private.h"
+#include "as-profile.h"
 #include "as-yaml.h"
 #include "as-curl.h"
 
 #include "asc-globals-private.h"
 #include "asc-utils.h"
+#include "asc-directory-unit.h"
 #include "asc-hint.h"
 #include "asc-result.h"
+#include "asc-result-private.h"
 
 #include "asc-utils-metainfo.h"
 #include "asc-utils-l10n.h"
 #include "asc-utils-screenshots.h"
 #include "asc-utils-fonts.h"
+#include "asc-tarball.h"
 #include "asc-image.h"
 
 typedef struct {
@@ -62,15 +80,34 @@ typedef struct {
 
 	AscComposeFlags flags;
 	AscIconPolicy *icon_policy;
+	AsProfile *profile;
 
 	gchar *data_result_dir;
 	gchar *icons_result_dir;
+	gchar *icon_tarball_fname;
 	gchar *media_result_dir;
 	gchar *hints_result_dir;
+	gchar *checkpoint_dir;
 
 	GHashTable *known_cids;
+	GHashTable *known_icon_hashes;
+	AscScreenshotDedup *scr_dedup;
 	GMutex mutex;
 
+	guint64 max_mem_bytes; /* memory budget for parallel processing, 0 for no limit */
+	guint64 mem_reserved_bytes;
+	guint mem_active_tasks;
+	GCond mem_cond;
+
+	guint stage_time_budget; /* soft per-stage time budget in seconds, 0 for no limit */
+	gchar *timing_report;
+
+	gchar *stats_cache_fname;  /* persistent per-unit statistics store, or NULL */
+	GKeyFile *prev_unit_stats; /* statistics loaded from the previous run, or NULL */
+
+	GPtrArray *spill_files; /* spilled result fragment files, in write order */
+	guint spilled_cpts;
+
 	AscCheckMetadataEarlyFn check_md_early_fn;
 	gpointer check_md_early_fn_udata;
 
@@ -81,6 +118,8 @@ typedef struct {
 G_DEFINE_TYPE_WITH_PRIVATE (AscCompose, asc_compose, G_TYPE_OBJECT)
 #define GET_PRIVATE(o) (asc_compose_get_instance_private (o))
 
+static void asc_compose_spill_result (AscCompose *compose, AscResult *cres);
+
 static void
 asc_compose_init (AscCompose *compose)
 {
@@ -90,8 +129,12 @@ asc_compose_init (AscCompose *compose)
 	priv->results = g_ptr_array_new_with_free_func (g_object_unref);
 	priv->allowed_cids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 	priv->known_cids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	priv->known_icon_hashes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	priv->scr_dedup = asc_screenshot_dedup_new ();
 	priv->custom_allowed = g_ptr_array_new_with_free_func (g_free);
+	priv->spill_files = g_ptr_array_new_with_free_func (g_free);
 	g_mutex_init (&priv->mutex);
+	g_cond_init (&priv->mem_cond);
 
 	/* defaults */
 	priv->format = AS_FORMAT_KIND_XML;
@@ -105,6 +148,8 @@ asc_compose_init (AscCompose *compose)
 
 	/* the icon policy will initialize with default settings */
 	priv->icon_policy = asc_icon_policy_new ();
+
+	priv->profile = as_profile_new ();
 }
 
 static void
@@ -116,22 +161,33 @@ asc_compose_finalize (GObject *object)
 	g_ptr_array_unref (priv->units);
 	g_ptr_array_unref (priv->results);
 	g_ptr_array_unref (priv->custom_allowed);
+	g_ptr_array_unref (priv->spill_files);
 	g_free (priv->cainfo);
 
 	g_hash_table_unref (priv->allowed_cids);
 	g_hash_table_unref (priv->known_cids);
+	g_hash_table_unref (priv->known_icon_hashes);
+	asc_screenshot_dedup_free (priv->scr_dedup);
 	as_ref_string_release (priv->prefix);
 	as_ref_string_release (priv->origin);
 	g_free (priv->media_baseurl);
 
 	g_free (priv->data_result_dir);
 	g_free (priv->icons_result_dir);
+	g_free (priv->icon_tarball_fname);
 	g_free (priv->media_result_dir);
 	g_free (priv->hints_result_dir);
+	g_free (priv->checkpoint_dir);
+	g_free (priv->timing_report);
+	g_free (priv->stats_cache_fname);
+	g_clear_pointer (&priv->prev_unit_stats, g_key_file_unref);
+
+	g_object_unref (priv->profile);
 
 	if (priv->locale_unit != NULL)
 		g_object_unref (priv->locale_unit);
 
+	g_cond_clear (&priv->mem_cond);
 	g_mutex_clear (&priv->mutex);
 
 	G_OBJECT_CLASS (asc_compose_parent_class)->finalize (object);
@@ -161,6 +217,12 @@ asc_compose_reset (AscCompose *compose)
 	g_ptr_array_set_size (priv->units, 0);
 	g_ptr_array_set_size (priv->results, 0);
 	g_hash_table_remove_all (priv->known_cids);
+	g_hash_table_remove_all (priv->known_icon_hashes);
+	asc_screenshot_dedup_reset (priv->scr_dedup);
+	g_free (g_steal_pointer (&priv->timing_report));
+	g_clear_pointer (&priv->prev_unit_stats, g_key_file_unref);
+	g_ptr_array_set_size (priv->spill_files, 0);
+	priv->spilled_cpts = 0;
 }
 
 /**
@@ -497,6 +559,38 @@ asc_compose_set_icons_result_dir (AscCompose *compose, const gchar *dir)
 	as_assign_string_safe (priv->icons_result_dir, dir);
 }
 
+/**
+ * asc_compose_get_icon_tarball_file:
+ * @compose: an #AscCompose instance.
+ *
+ * Get the filename of the icon tarball to create, or %NULL if
+ * no tarball will be written.
+ */
+const gchar *
+asc_compose_get_icon_tarball_file (AscCompose *compose)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	return priv->icon_tarball_fname;
+}
+
+/**
+ * asc_compose_set_icon_tarball_file:
+ * @compose: an #AscCompose instance.
+ * @fname: the tarball filename, e.g. `icons.tar.zst`.
+ *
+ * Set a filename to pack the contents of the icon result directory
+ * into once a compose run has completed. The compression is selected
+ * from the filename suffix, a `.zst` suffix enabling multithreaded
+ * Zstandard compression.
+ */
+void
+asc_compose_set_icon_tarball_file (AscCompose *compose, const gchar *fname)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
+	as_assign_string_safe (priv->icon_tarball_fname, fname);
+}
+
 /**
  * asc_compose_get_media_result_dir:
  * @compose: an #AscCompose instance.
@@ -555,6 +649,47 @@ asc_compose_set_hints_result_dir (AscCompose *compose, const gchar *dir)
 	as_assign_string_safe (priv->hints_result_dir, dir);
 }
 
+/**
+ * asc_compose_get_checkpoint_dir:
+ * @compose: an #AscCompose instance.
+ *
+ * Get the checkpoint data directory for incremental compose runs.
+ *
+ * Since: 1.0.5
+ */
+const gchar *
+asc_compose_get_checkpoint_dir (AscCompose *compose)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	return priv->checkpoint_dir;
+}
+
+/**
+ * asc_compose_set_checkpoint_dir:
+ * @compose: an #AscCompose instance.
+ * @dir: the checkpoint data location.
+ *
+ * Set a directory to store per-unit checkpoint data in.
+ * If a checkpoint directory is set, the result of each successfully
+ * processed unit is recorded there together with a fingerprint of the
+ * unit's input data. A subsequent run will restore the recorded result
+ * for any unit whose inputs are unchanged, instead of processing the
+ * unit again.
+ *
+ * For restored units to be complete, the icon/media/data output
+ * directories of the previous run must still be present, as exported
+ * files are not written again for units restored from a checkpoint.
+ *
+ * Since: 1.0.5
+ */
+void
+asc_compose_set_checkpoint_dir (AscCompose *compose, const gchar *dir)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
+	as_assign_string_safe (priv->checkpoint_dir, dir);
+}
+
 /**
  * asc_compose_remove_custom_allowed:
  * @compose: an #AscCompose instance.
@@ -622,6 +757,135 @@ asc_compose_set_max_screenshot_size (AscCompose *compose, gssize size_bytes)
 	priv->max_scr_size_bytes = size_bytes;
 }
 
+/**
+ * asc_compose_get_max_memory_usage:
+ * @compose: an #AscCompose instance.
+ *
+ * Get the memory budget for parallel unit processing, in bytes.
+ * Zero is returned if no limit is set.
+ */
+guint64
+asc_compose_get_max_memory_usage (AscCompose *compose)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	return priv->max_mem_bytes;
+}
+
+/**
+ * asc_compose_set_max_memory_usage:
+ * @compose: an #AscCompose instance.
+ * @usage_bytes: memory budget for parallel unit processing, in bytes
+ *
+ * Set a memory budget for parallel unit processing. When running with
+ * %ASC_COMPOSE_FLAG_USE_THREADS, a unit is only admitted for processing
+ * once the estimated memory demand of all units currently in flight
+ * leaves enough headroom for it, keeping the peak memory usage of the
+ * compose process roughly below the budget on image-heavy input.
+ * Set a budget of 0 (the default) to not limit memory usage.
+ */
+void
+asc_compose_set_max_memory_usage (AscCompose *compose, guint64 usage_bytes)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	priv->max_mem_bytes = usage_bytes;
+}
+
+/**
+ * asc_compose_get_stage_time_budget:
+ * @compose: an #AscCompose instance.
+ *
+ * Get the per-stage time budget for unit processing, in seconds.
+ *
+ * Since: 1.0.5
+ */
+guint
+asc_compose_get_stage_time_budget (AscCompose *compose)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	return priv->stage_time_budget;
+}
+
+/**
+ * asc_compose_set_stage_time_budget:
+ * @compose: an #AscCompose instance.
+ * @seconds: time budget for a single processing stage, in seconds.
+ *
+ * Set a soft time budget for the individual processing stages (metainfo
+ * parsing, media rendering, font processing) of a single unit.
+ * The budget does not abort any work, but a unit whose stage exceeds it
+ * receives an issue hint, so pathological packages (e.g. ones containing
+ * an extremely expensive SVG graphic) show up in the issue report and
+ * can be quarantined, instead of being discovered by watching run logs.
+ * Set a budget of 0 (the default) to not flag slow stages.
+ *
+ * Since: 1.0.5
+ */
+void
+asc_compose_set_stage_time_budget (AscCompose *compose, guint seconds)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	priv->stage_time_budget = seconds;
+}
+
+/**
+ * asc_compose_get_timing_report:
+ * @compose: an #AscCompose instance.
+ *
+ * Get a human-readable report of the units that took the longest to
+ * process in the last compose run, including a per-stage time breakdown
+ * where one is available (units processed in isolated worker processes
+ * only report their total wall-clock time).
+ *
+ * Returns: (nullable): the timing report, or %NULL if no run has completed yet.
+ *
+ * Since: 1.0.5
+ */
+const gchar *
+asc_compose_get_timing_report (AscCompose *compose)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	return priv->timing_report;
+}
+
+/**
+ * asc_compose_get_stats_cache_file:
+ * @compose: an #AscCompose instance.
+ *
+ * Get the filename of the persistent per-unit statistics store.
+ *
+ * Returns: (nullable): the statistics store filename, or %NULL if none is set.
+ *
+ * Since: 1.0.5
+ */
+const gchar *
+asc_compose_get_stats_cache_file (AscCompose *compose)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	return priv->stats_cache_fname;
+}
+
+/**
+ * asc_compose_set_stats_cache_file:
+ * @compose: an #AscCompose instance.
+ * @fname: the statistics store filename, or %NULL to disable the store.
+ *
+ * Set a filename for a persistent per-unit statistics store. After a run,
+ * the processing time (total and per stage) and input size of every unit
+ * are recorded there, and the next run reads the store to schedule the
+ * previously most expensive units first, which gives a much better cost
+ * estimate than the input size alone. The store is a plain key file, so
+ * external tooling can also use it to track per-unit cost trends and
+ * predict run completion times.
+ *
+ * Since: 1.0.5
+ */
+void
+asc_compose_set_stats_cache_file (AscCompose *compose, const gchar *fname)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	as_assign_string_safe (priv->stats_cache_fname, fname);
+}
+
 /**
  * asc_compose_set_check_metadata_early_func:
  * @compose: an #AscCompose instance.
@@ -769,10 +1033,26 @@ asc_compose_has_errors (AscCompose *compose)
 	return FALSE;
 }
 
+/* the individually timed stages of processing a single unit */
+typedef enum {
+	ASC_TIMED_STAGE_METAINFO,
+	ASC_TIMED_STAGE_MEDIA,
+	ASC_TIMED_STAGE_FONTS,
+	/*< private >*/
+	ASC_TIMED_STAGE_LAST
+} AscTimedStage;
+
+static const gchar *asc_timed_stage_names[ASC_TIMED_STAGE_LAST] = { "metainfo", "media", "fonts" };
+
 typedef struct {
 	AscUnit *unit;
 	AscResult *result;
 	GHashTable *files_units_map; /* no ref */
+	guint reg_index;	     /* registration order of the unit */
+
+	gdouble stage_secs[ASC_TIMED_STAGE_LAST];
+	gdouble total_secs;
+	gdouble prev_secs; /* total processing time in the previous run, 0 if unknown */
 } AscComposeTask;
 
 static AscComposeTask *
@@ -793,6 +1073,240 @@ asc_compose_task_free (AscComposeTask *ctask)
 	g_free (ctask);
 }
 
+/**
+ * asc_compose_task_stage_finished:
+ *
+ * Record the duration of a finished processing stage for the given task,
+ * emit an issue hint if it overran the configured time budget, and restart
+ * @timer for the next stage.
+ **/
+static void
+asc_compose_task_stage_finished (AscCompose *compose,
+				 AscComposeTask *ctask,
+				 AscTimedStage stage,
+				 GTimer *timer)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	gdouble elapsed = g_timer_elapsed (timer, NULL);
+
+	ctask->stage_secs[stage] = elapsed;
+	if (priv->stage_time_budget > 0 && elapsed > priv->stage_time_budget) {
+		g_autofree gchar *duration_str = g_strdup_printf ("%.1f", elapsed);
+		g_autofree gchar *budget_str = g_strdup_printf ("%u", priv->stage_time_budget);
+		asc_result_add_hint (ctask->result,
+				     NULL,
+				     "unit-stage-too-slow",
+				     "name",
+				     asc_unit_get_bundle_id (ctask->unit),
+				     "stage",
+				     asc_timed_stage_names[stage],
+				     "duration",
+				     duration_str,
+				     "budget",
+				     budget_str,
+				     NULL);
+	}
+
+	g_timer_start (timer);
+}
+
+/**
+ * asc_compose_task_cmp_cost_cb:
+ *
+ * Order compose tasks by their expected processing cost, most expensive
+ * first. The measured time of the previous run is the best predictor and
+ * wins when available, the unit size hint serves as fallback.
+ */
+static gint
+asc_compose_task_cmp_cost_cb (gconstpointer a, gconstpointer b)
+{
+	const AscComposeTask *ctask1 = *((AscComposeTask **) a);
+	const AscComposeTask *ctask2 = *((AscComposeTask **) b);
+	guint64 size1 = asc_unit_get_size_hint (ctask1->unit);
+	guint64 size2 = asc_unit_get_size_hint (ctask2->unit);
+
+	if (ctask1->prev_secs > ctask2->prev_secs)
+		return -1;
+	if (ctask1->prev_secs < ctask2->prev_secs)
+		return 1;
+
+	if (size1 > size2)
+		return -1;
+	if (size1 < size2)
+		return 1;
+
+	/* keep registration order for units of equal (or unknown) size */
+	if (ctask1->reg_index < ctask2->reg_index)
+		return -1;
+	if (ctask1->reg_index > ctask2->reg_index)
+		return 1;
+	return 0;
+}
+
+/**
+ * asc_compose_task_cmp_time_cb:
+ *
+ * Order compose tasks by the time it took to process them, slowest first.
+ */
+static gint
+asc_compose_task_cmp_time_cb (gconstpointer a, gconstpointer b)
+{
+	const AscComposeTask *ctask1 = *((AscComposeTask **) a);
+	const AscComposeTask *ctask2 = *((AscComposeTask **) b);
+
+	if (ctask1->total_secs > ctask2->total_secs)
+		return -1;
+	if (ctask1->total_secs < ctask2->total_secs)
+		return 1;
+	return 0;
+}
+
+/**
+ * asc_compose_load_unit_stats:
+ *
+ * Load the per-unit statistics recorded by the previous compose run
+ * from the configured statistics store, if one is set.
+ **/
+static void
+asc_compose_load_unit_stats (AscCompose *compose)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GKeyFile) kf = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+
+	g_clear_pointer (&priv->prev_unit_stats, g_key_file_unref);
+	if (priv->stats_cache_fname == NULL)
+		return;
+
+	kf = g_key_file_new ();
+	if (!g_key_file_load_from_file (kf, priv->stats_cache_fname, G_KEY_FILE_NONE, &tmp_error)) {
+		/* a missing store is expected on the first run */
+		if (!g_error_matches (tmp_error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+			g_debug ("Unable to load unit statistics from '%s': %s",
+				 priv->stats_cache_fname,
+				 tmp_error->message);
+		return;
+	}
+
+	priv->prev_unit_stats = g_steal_pointer (&kf);
+}
+
+/**
+ * asc_compose_save_unit_stats:
+ *
+ * Write the measured per-unit costs of the just-finished run to the
+ * statistics store, so the next run can schedule by them and external
+ * tooling can track cost trends across runs.
+ **/
+static void
+asc_compose_save_unit_stats (AscCompose *compose, GPtrArray *tasks)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GKeyFile) kf = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	gdouble prev_total = 0;
+	gdouble cur_total = 0;
+	guint known_units = 0;
+
+	if (priv->stats_cache_fname == NULL)
+		return;
+
+	kf = g_key_file_new ();
+	for (guint i = 0; i < tasks->len; i++) {
+		AscComposeTask *ctask = g_ptr_array_index (tasks, i);
+		const gchar *bid = asc_unit_get_bundle_id (ctask->unit);
+
+		if (bid == NULL)
+			continue;
+		g_key_file_set_double (kf, bid, "total-secs", ctask->total_secs);
+		for (guint j = 0; j < ASC_TIMED_STAGE_LAST; j++) {
+			if (ctask->stage_secs[j] <= 0)
+				continue;
+			g_autofree gchar *key = g_strconcat (asc_timed_stage_names[j],
+							     "-secs",
+							     NULL);
+			g_key_file_set_double (kf, bid, key, ctask->stage_secs[j]);
+		}
+		g_key_file_set_uint64 (kf, bid, "size-bytes", asc_unit_get_size_hint (ctask->unit));
+		g_key_file_set_int64 (kf, bid, "timestamp", g_get_real_time () / G_USEC_PER_SEC);
+
+		cur_total += ctask->total_secs;
+		if (ctask->prev_secs > 0) {
+			prev_total += ctask->prev_secs;
+			known_units++;
+		}
+	}
+
+	if (!g_key_file_save_to_file (kf, priv->stats_cache_fname, &tmp_error)) {
+		g_warning ("Unable to save unit statistics to '%s': %s",
+			   priv->stats_cache_fname,
+			   tmp_error->message);
+		return;
+	}
+
+	if (known_units > 0 && prev_total > 0)
+		g_debug ("Unit statistics saved (%u/%u units had previous data, "
+			 "processing time %.1fs vs. %.1fs before).",
+			 known_units,
+			 tasks->len,
+			 cur_total,
+			 prev_total);
+	else
+		g_debug ("Unit statistics saved for %u units.", tasks->len);
+}
+
+/**
+ * asc_compose_update_timing_report:
+ *
+ * Build the slowest-units report from the per-task timing data of the
+ * just-finished run, before the tasks are freed.
+ **/
+static void
+asc_compose_update_timing_report (AscCompose *compose, GPtrArray *tasks)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GPtrArray) sorted = NULL;
+	GString *report = NULL;
+	guint limit;
+
+	g_free (g_steal_pointer (&priv->timing_report));
+	if (tasks->len == 0)
+		return;
+
+	sorted = g_ptr_array_sized_new (tasks->len);
+	for (guint i = 0; i < tasks->len; i++)
+		g_ptr_array_add (sorted, g_ptr_array_index (tasks, i));
+	g_ptr_array_sort (sorted, asc_compose_task_cmp_time_cb);
+
+	/* the report exists to single out pathological units, so listing
+	 * more than the slowest handful would just be noise */
+	limit = MIN (sorted->len, 10);
+	report = g_string_new ("Slowest units:");
+	for (guint i = 0; i < limit; i++) {
+		AscComposeTask *ctask = g_ptr_array_index (sorted, i);
+		g_string_append_printf (report,
+					"\n%8.2fs  %s",
+					ctask->total_secs,
+					asc_unit_get_bundle_id (ctask->unit));
+		/* units run in isolated worker processes only have a total time */
+		if (ctask->stage_secs[ASC_TIMED_STAGE_METAINFO] > 0 ||
+		    ctask->stage_secs[ASC_TIMED_STAGE_MEDIA] > 0 ||
+		    ctask->stage_secs[ASC_TIMED_STAGE_FONTS] > 0)
+			g_string_append_printf (report,
+						"  (metainfo: %.2fs, media: %.2fs, fonts: %.2fs)",
+						ctask->stage_secs[ASC_TIMED_STAGE_METAINFO],
+						ctask->stage_secs[ASC_TIMED_STAGE_MEDIA],
+						ctask->stage_secs[ASC_TIMED_STAGE_FONTS]);
+		if (ctask->prev_secs > 0)
+			g_string_append_printf (report,
+						"  [last run: %.2fs]",
+						ctask->prev_secs);
+	}
+
+	priv->timing_report = g_string_free (report, FALSE);
+	g_debug ("%s", priv->timing_report);
+}
+
 /**
  * asc_compose_find_icon_filename:
  */
@@ -936,6 +1450,118 @@ asc_compose_find_icon_filename (AscCompose *compose,
 	return NULL;
 }
 
+/**
+ * asc_compose_store_icon_deduped:
+ *
+ * Register the checksum of a freshly written icon in our content-addressed
+ * icon store, and replace the file with a hardlink to a previously written,
+ * byte-identical icon if we have already stored one.
+ * Many applications ship identical icons (e.g. the same themed stock icon),
+ * so this shrinks the exported icon tree considerably.
+ **/
+static void
+asc_compose_store_icon_deduped (AscCompose *compose, const gchar *fname)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autofree gchar *contents = NULL;
+	g_autofree gchar *checksum = NULL;
+	const gchar *existing_fname;
+	gsize len;
+
+	if (!g_file_get_contents (fname, &contents, &len, NULL))
+		return;
+	checksum = g_compute_checksum_for_data (G_CHECKSUM_SHA256, (const guchar *) contents, len);
+
+	locker = g_mutex_locker_new (&priv->mutex);
+	existing_fname = g_hash_table_lookup (priv->known_icon_hashes, checksum);
+	if (existing_fname == NULL) {
+		g_hash_table_insert (priv->known_icon_hashes,
+				     g_steal_pointer (&checksum),
+				     g_strdup (fname));
+		return;
+	}
+	if (g_strcmp0 (existing_fname, fname) == 0)
+		return;
+
+	/* if hardlinking fails (e.g. on odd filesystems), we just keep the copy */
+	if (g_unlink (fname) != 0)
+		return;
+	if (link (existing_fname, fname) != 0) {
+		g_autoptr(GError) tmp_error = NULL;
+		if (!as_copy_file (existing_fname, fname, &tmp_error))
+			g_warning ("Unable to restore deduplicated icon %s: %s",
+				   fname,
+				   tmp_error->message);
+	}
+}
+
+typedef struct {
+	AscImage *img;
+	gchar *src_fname;
+	gchar *res_fname;
+	gchar *res_size_str;
+	gchar *res_basename;
+	gint res_dirfd;
+	guint size;
+	guint scale_factor;
+	AscIconState state;
+	GError *error;
+} AscIconSaveJob;
+
+static void
+asc_icon_save_job_free (AscIconSaveJob *job)
+{
+	g_object_unref (job->img);
+	g_free (job->src_fname);
+	g_free (job->res_fname);
+	g_free (job->res_size_str);
+	g_free (job->res_basename);
+	if (job->res_dirfd >= 0)
+		close (job->res_dirfd);
+	if (job->error != NULL)
+		g_error_free (job->error);
+	g_free (job);
+}
+
+/**
+ * asc_compose_icon_save_job_run_cb:
+ *
+ * Scale and encode one size variant of a component icon. This is safe to
+ * run in parallel: the decoded source image is only read, and each job
+ * writes (and optimizes) its own output file.
+ */
+static void
+asc_compose_icon_save_job_run_cb (gpointer job_data, gpointer user_data)
+{
+	AscIconSaveJob *job = job_data;
+
+	g_debug ("Saving icon: %s", job->res_fname);
+	if (job->res_dirfd >= 0) {
+		/* write relative to the already-open size directory, so the finished
+		 * icon is published atomically and no path is resolved twice */
+		if (asc_image_save_filename_at (job->img,
+						job->res_dirfd,
+						job->res_basename,
+						job->size * job->scale_factor,
+						job->size * job->scale_factor,
+						ASC_IMAGE_SAVE_FLAG_OPTIMIZE,
+						&job->error)) {
+			/* an explicitly configured external optimizer only works on
+			 * paths, so it has to run on the already published file */
+			if (asc_globals_get_optipng_explicit ())
+				asc_optimize_png (job->res_fname, &job->error);
+		}
+	} else {
+		asc_image_save_filename (job->img,
+					 job->res_fname,
+					 job->size * job->scale_factor,
+					 job->size * job->scale_factor,
+					 ASC_IMAGE_SAVE_FLAG_OPTIMIZE,
+					 &job->error);
+	}
+}
+
 static void
 asc_compose_process_icons (AscCompose *compose,
 			   AscResult *cres,
@@ -946,6 +1572,7 @@ asc_compose_process_icons (AscCompose *compose,
 	AscComposePrivate *priv = GET_PRIVATE (compose);
 	GPtrArray *icons = NULL;
 	g_autoptr(AsIcon) stock_icon = NULL;
+	g_autoptr(GPtrArray) save_jobs = NULL;
 	const gchar *icon_name = NULL;
 	AscIconPolicyIter iter;
 	guint size;
@@ -985,6 +1612,8 @@ asc_compose_process_icons (AscCompose *compose,
 		return;
 	}
 
+	save_jobs = g_ptr_array_new_with_free_func ((GDestroyNotify) asc_icon_save_job_free);
+
 	asc_icon_policy_iter_init (&iter, priv->icon_policy);
 	while (asc_icon_policy_iter_next (&iter, &size, &scale_factor, &icon_state)) {
 		g_autofree gchar *icon_fname = NULL;
@@ -993,11 +1622,12 @@ asc_compose_process_icons (AscCompose *compose,
 		g_autofree gchar *res_icon_sizedir = NULL;
 		g_autofree gchar *res_icon_basename = NULL;
 		g_autoptr(AscImage) img = NULL;
-		g_autoptr(AsIcon) icon = NULL;
 		g_autoptr(GBytes) img_bytes = NULL;
 		gboolean is_vector_icon = FALSE;
 		const void *img_data;
 		gsize img_len;
+		AscImageLoadFlags img_lflags;
+		AscIconSaveJob *job = NULL;
 		g_autoptr(GError) error = NULL;
 
 		/* skip icon if its size should be skipped */
@@ -1039,11 +1669,16 @@ asc_compose_process_icons (AscCompose *compose,
 			return;
 		}
 		img_data = g_bytes_get_data (img_bytes, &img_len);
+		/* the same icon data is frequently shared between many components,
+		 * so cache decoded pixbufs by content hash */
+		img_lflags = ASC_IMAGE_LOAD_FLAG_ALWAYS_RESIZE | ASC_IMAGE_LOAD_FLAG_SHARED_CACHE;
+		if (is_vector_icon && as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_SANDBOX_SVG))
+			img_lflags |= ASC_IMAGE_LOAD_FLAG_SANDBOX_SVG;
 		img = asc_image_new_from_data (img_data,
 					       img_len,
 					       is_vector_icon ? size * scale_factor : 0,
 					       g_str_has_suffix (icon_fname, ".svgz"),
-					       ASC_IMAGE_LOAD_FLAG_ALWAYS_RESIZE,
+					       img_lflags,
 					       &error);
 		if (img == NULL) {
 			asc_result_add_hint (cres,
@@ -1070,27 +1705,73 @@ asc_compose_process_icons (AscCompose *compose,
 		res_icon_basename = g_strdup_printf ("%s.png", as_component_get_id (cpt));
 		res_icon_fname = g_build_filename (res_icon_sizedir, res_icon_basename, NULL);
 
-		/* scale & save the image */
-		g_debug ("Saving icon: %s", res_icon_fname);
-		if (!asc_image_save_filename (img,
-					      res_icon_fname,
-					      size * scale_factor,
-					      size * scale_factor,
-					      ASC_IMAGE_SAVE_FLAG_OPTIMIZE,
-					      &error)) {
+		/* defer scale & save, so all size variants can be encoded in parallel */
+		job = g_new0 (AscIconSaveJob, 1);
+		job->img = g_object_ref (img);
+		job->src_fname = g_steal_pointer (&icon_fname);
+		job->res_fname = g_steal_pointer (&res_icon_fname);
+		job->res_size_str = g_steal_pointer (&res_icon_size_str);
+		job->res_basename = g_steal_pointer (&res_icon_basename);
+		/* write via the directory descriptor if possible, with a path-based fallback */
+		job->res_dirfd = open (res_icon_sizedir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		job->size = size;
+		job->scale_factor = scale_factor;
+		job->state = icon_state;
+		g_ptr_array_add (save_jobs, job);
+	}
+
+	/* scale & encode all size variants in parallel from their decoded sources */
+	if (save_jobs->len > 1 && as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_USE_THREADS)) {
+		guint n_threads = MIN (g_get_num_processors (), save_jobs->len);
+		GThreadPool *tpool = NULL;
+		g_autoptr(GError) pool_error = NULL;
+
+		tpool = g_thread_pool_new (asc_compose_icon_save_job_run_cb,
+					   NULL,
+					   n_threads,
+					   FALSE,
+					   &pool_error);
+		if (tpool == NULL) {
+			/* creating the thread pool failed - just save sequentially */
+			g_warning ("Unable to create thread pool for icon encoding: %s",
+				   pool_error->message);
+			for (guint i = 0; i < save_jobs->len; i++)
+				asc_compose_icon_save_job_run_cb (g_ptr_array_index (save_jobs, i),
+								  NULL);
+		} else {
+			for (guint i = 0; i < save_jobs->len; i++)
+				g_thread_pool_push (tpool, g_ptr_array_index (save_jobs, i), NULL);
+			/* wait for all encode jobs to finish */
+			g_thread_pool_free (tpool, FALSE, TRUE);
+		}
+	} else {
+		for (guint i = 0; i < save_jobs->len; i++)
+			asc_compose_icon_save_job_run_cb (g_ptr_array_index (save_jobs, i), NULL);
+	}
+
+	/* emit hints & register icons on the coordinating thread, in policy order */
+	for (guint i = 0; i < save_jobs->len; i++) {
+		AscIconSaveJob *job = g_ptr_array_index (save_jobs, i);
+		g_autoptr(AsIcon) icon = NULL;
+		g_autoptr(GError) error = NULL;
+
+		if (job->error != NULL) {
 			asc_result_add_hint (cres,
 					     cpt,
 					     "icon-write-error",
 					     "fname",
-					     icon_fname,
+					     job->src_fname,
 					     "msg",
-					     error->message,
+					     job->error->message,
 					     NULL);
 			return;
 		}
 
+		/* hardlink to an identical, previously exported icon if we have one */
+		asc_compose_store_icon_deduped (compose, job->res_fname);
+
 		/* create a remote reference if we have data for it */
-		if (priv->media_result_dir != NULL && icon_state != ASC_ICON_STATE_CACHED_ONLY) {
+		if (priv->media_result_dir != NULL && job->state != ASC_ICON_STATE_CACHED_ONLY) {
 			g_autofree gchar *icons_media_urlpart_dir = NULL;
 			g_autofree gchar *icon_media_urlpart_fname = NULL;
 			g_autofree gchar *icons_media_path = NULL;
@@ -1100,26 +1781,28 @@ asc_compose_process_icons (AscCompose *compose,
 			    "%s/%s/%s",
 			    asc_result_gcid_for_component (cres, cpt),
 			    "icons",
-			    res_icon_size_str);
+			    job->res_size_str);
 			icon_media_urlpart_fname = g_strdup_printf ("%s/%s",
 								    icons_media_urlpart_dir,
-								    res_icon_basename);
+								    job->res_basename);
 			icons_media_path = g_build_filename (priv->media_result_dir,
 							     icons_media_urlpart_dir,
 							     NULL);
 			icon_media_fname = g_build_filename (icons_media_path,
-							     res_icon_basename,
+							     job->res_basename,
 							     NULL);
 			g_mkdir_with_parents (icons_media_path, 0755);
 
 			g_debug ("Adding media pool icon: %s", icon_media_fname);
-			if (!as_copy_file (res_icon_fname, icon_media_fname, &error)) {
+			/* hardlink from the export tree if possible, to save I/O and space */
+			if (link (job->res_fname, icon_media_fname) != 0 &&
+			    !as_copy_file (job->res_fname, icon_media_fname, &error)) {
 				g_warning ("Unable to write media pool icon: %s", icon_media_fname);
 				asc_result_add_hint (cres,
 						     cpt,
 						     "icon-write-error",
 						     "fname",
-						     icon_fname,
+						     job->src_fname,
 						     "msg",
 						     error->message,
 						     NULL);
@@ -1129,9 +1812,9 @@ asc_compose_process_icons (AscCompose *compose,
 			/* add remote icon to metadata */
 			remote_icon = as_icon_new ();
 			as_icon_set_kind (remote_icon, AS_ICON_KIND_REMOTE);
-			as_icon_set_width (remote_icon, size);
-			as_icon_set_height (remote_icon, size);
-			as_icon_set_scale (remote_icon, scale_factor);
+			as_icon_set_width (remote_icon, job->size);
+			as_icon_set_height (remote_icon, job->size);
+			as_icon_set_scale (remote_icon, job->scale_factor);
 
 			/* We can only make use of the media-baseurl-using partial URLs if screenshot storage
 			 * is also enabled, because otherwise screenshots will use full URLs which conflicts
@@ -1153,13 +1836,13 @@ asc_compose_process_icons (AscCompose *compose,
 		}
 
 		/* add icon to metadata */
-		if (icon_state != ASC_ICON_STATE_REMOTE_ONLY) {
+		if (job->state != ASC_ICON_STATE_REMOTE_ONLY) {
 			icon = as_icon_new ();
 			as_icon_set_kind (icon, AS_ICON_KIND_CACHED);
-			as_icon_set_width (icon, size);
-			as_icon_set_height (icon, size);
-			as_icon_set_scale (icon, scale_factor);
-			as_icon_set_name (icon, res_icon_basename);
+			as_icon_set_width (icon, job->size);
+			as_icon_set_height (icon, job->size);
+			as_icon_set_scale (icon, job->scale_factor);
+			as_icon_set_name (icon, job->res_basename);
 			as_component_add_icon (cpt, icon);
 		}
 	}
@@ -1198,12 +1881,21 @@ as_compose_yaml_write_handler_cb (void *ptr, unsigned char *buffer, size_t size)
 	return 1;
 }
 
-static gboolean
-asc_compose_component_known (AscCompose *compose, AsComponent *cpt)
-{
-	AscComposePrivate *priv = GET_PRIVATE (compose);
+/**
+ * asc_compose_claim_component:
+ *
+ * Atomically register a component-ID as known, so concurrent workers
+ * agree on exactly one claimant without racing between a separate
+ * check and insert.
+ *
+ * Returns: %TRUE if the ID was not known before and is now claimed by the caller.
+ */
+static gboolean
+asc_compose_claim_component (AscCompose *compose, AsComponent *cpt)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
 	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
-	return g_hash_table_contains (priv->known_cids, as_component_get_id (cpt));
+	return g_hash_table_add (priv->known_cids, g_strdup (as_component_get_id (cpt)));
 }
 
 /**
@@ -1354,8 +2046,430 @@ asc_compose_finalize_components (AscCompose *compose, AscResult *cres)
 	}
 }
 
+/* file format version of unit checkpoint data */
+#define ASC_CHECKPOINT_FORMAT_VERSION 1
+
+/**
+ * asc_compose_get_checkpoint_fname:
+ *
+ * Get the checkpoint filename for the unit of the given task, or %NULL
+ * if no checkpoint can be created for it.
+ **/
+static gchar *
+asc_compose_get_checkpoint_fname (AscCompose *compose, AscComposeTask *ctask)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autofree gchar *safe_bid = NULL;
+	g_autofree gchar *basename = NULL;
+	const gchar *bundle_id = asc_unit_get_bundle_id (ctask->unit);
+
+	if (priv->checkpoint_dir == NULL || as_is_empty (bundle_id))
+		return NULL;
+
+	safe_bid = g_strdup (bundle_id);
+	g_strdelimit (safe_bid, "/\\ :", '_');
+	basename = g_strdup_printf ("%s.ckpt", safe_bid);
+	return g_build_filename (priv->checkpoint_dir, basename, NULL);
+}
+
+static gint
+asc_compose_strptr_cmp (gconstpointer a, gconstpointer b)
+{
+	return g_strcmp0 (*(const gchar **) a, *(const gchar **) b);
+}
+
+/**
+ * asc_compose_get_unit_fingerprint:
+ *
+ * Compute a fingerprint over the input data of a unit as well as all compose
+ * settings that affect the generated output. If the fingerprint of a unit is
+ * unchanged between runs, its previous result can be reused.
+ *
+ * Returns: (transfer full) (nullable): The fingerprint, or %NULL if one could not be computed.
+ **/
+static gchar *
+asc_compose_get_unit_fingerprint (AscCompose *compose,
+				  AscComposeTask *ctask,
+				  GPtrArray *mi_fnames,
+				  GHashTable *de_fname_map)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GChecksum) cksum = NULL;
+	g_autoptr(GPtrArray) sorted_contents = NULL;
+	g_autoptr(GPtrArray) data_fnames = NULL;
+	g_autofree gchar *settings_str = NULL;
+	GHashTableIter ht_iter;
+	gpointer ht_value;
+	GPtrArray *contents;
+
+	cksum = g_checksum_new (G_CHECKSUM_SHA256);
+
+	/* settings that change the generated output invalidate any previous checkpoint */
+	settings_str = g_strdup_printf ("%s\n%s\n%s\n%i\n%i\n",
+					priv->prefix != NULL ? priv->prefix : "",
+					priv->origin != NULL ? priv->origin : "",
+					priv->media_baseurl != NULL ? priv->media_baseurl : "",
+					priv->format,
+					priv->flags);
+	g_checksum_update (cksum, (const guchar *) settings_str, -1);
+
+	/* the full contents listing, so added or removed files (e.g. icons) are noticed */
+	contents = asc_unit_get_contents (ctask->unit);
+	sorted_contents = g_ptr_array_sized_new (contents->len);
+	for (guint i = 0; i < contents->len; i++)
+		g_ptr_array_add (sorted_contents, g_ptr_array_index (contents, i));
+	g_ptr_array_sort (sorted_contents, asc_compose_strptr_cmp);
+	for (guint i = 0; i < sorted_contents->len; i++) {
+		const gchar *fname = g_ptr_array_index (sorted_contents, i);
+		g_checksum_update (cksum, (const guchar *) fname, -1);
+		g_checksum_update (cksum, (const guchar *) "\n", 1);
+	}
+
+	/* hash the contents of the primary metadata inputs */
+	data_fnames = g_ptr_array_new_with_free_func (g_free);
+	for (guint i = 0; i < mi_fnames->len; i++)
+		g_ptr_array_add (data_fnames, g_strdup (g_ptr_array_index (mi_fnames, i)));
+	g_hash_table_iter_init (&ht_iter, de_fname_map);
+	while (g_hash_table_iter_next (&ht_iter, NULL, &ht_value))
+		g_ptr_array_add (data_fnames, g_strdup ((const gchar *) ht_value));
+	g_ptr_array_sort (data_fnames, asc_compose_strptr_cmp);
+
+	for (guint i = 0; i < data_fnames->len; i++) {
+		const gchar *fname = g_ptr_array_index (data_fnames, i);
+		g_autoptr(GBytes) bytes = NULL;
+		g_autoptr(GError) tmp_error = NULL;
+
+		bytes = asc_unit_read_data (ctask->unit, fname, &tmp_error);
+		if (bytes == NULL) {
+			g_debug ("Unable to fingerprint unit %s: Failed to read %s: %s",
+				 asc_unit_get_bundle_id (ctask->unit),
+				 fname,
+				 tmp_error->message);
+			return NULL;
+		}
+		g_checksum_update (cksum,
+				   g_bytes_get_data (bytes, NULL),
+				   g_bytes_get_size (bytes));
+	}
+
+	return g_strdup (g_checksum_get_string (cksum));
+}
+
+/**
+ * asc_compose_task_result_from_keyfile:
+ *
+ * Restore a serialized task result (components with their metadata checksums
+ * as well as hints) into the task's #AscResult. Shared between checkpoint
+ * restoration and receiving results from isolated worker processes.
+ *
+ * Returns: %TRUE if the stored result could be read.
+ **/
+static gboolean
+asc_compose_task_result_from_keyfile (AscCompose *compose, AscComposeTask *ctask, GKeyFile *kf)
+{
+	g_autofree gchar *mdata_xml = NULL;
+	g_auto(GStrv) groups = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+
+	/* restore components */
+	mdata_xml = g_key_file_get_string (kf, "checkpoint", "metadata", NULL);
+	if (mdata_xml != NULL) {
+		g_autoptr(AsMetadata) mdata = as_metadata_new ();
+		AsComponentBox *cbox = NULL;
+
+		as_metadata_set_locale (mdata, "ALL");
+		as_metadata_set_format_style (mdata, AS_FORMAT_STYLE_CATALOG);
+		if (!as_metadata_parse_data (mdata,
+					     mdata_xml,
+					     -1,
+					     AS_FORMAT_KIND_XML,
+					     &tmp_error)) {
+			g_debug ("Failed to read stored result data for unit %s: %s",
+				 asc_unit_get_bundle_id (ctask->unit),
+				 tmp_error->message);
+			return FALSE;
+		}
+
+		cbox = as_metadata_get_components (mdata);
+		for (guint i = 0; i < as_component_box_len (cbox); i++) {
+			g_autofree gchar *checksum = NULL;
+			g_autoptr(GError) local_error = NULL;
+			AsComponent *cpt = as_component_box_index (cbox, i);
+
+			/* restored components still take part in duplicate detection */
+			if (!asc_compose_claim_component (compose, cpt)) {
+				asc_result_add_hint_simple (ctask->result,
+							    cpt,
+							    "duplicate-component");
+				continue;
+			}
+
+			checksum = g_key_file_get_string (kf,
+							  "component_checksums",
+							  as_component_get_id (cpt),
+							  NULL);
+			if (!asc_result_add_component_with_checksum (ctask->result,
+								     cpt,
+								     checksum,
+								     &local_error)) {
+				g_debug ("Failed to restore component from checkpoint: %s",
+					 local_error->message);
+			}
+		}
+	}
+
+	/* restore hints */
+	groups = g_key_file_get_groups (kf, NULL);
+	for (guint i = 0; groups[i] != NULL; i++) {
+		g_auto(GStrv) keys = NULL;
+		const gchar *cid;
+
+		if (!g_str_has_prefix (groups[i], "hints:"))
+			continue;
+		cid = groups[i] + strlen ("hints:");
+
+		keys = g_key_file_get_keys (kf, groups[i], NULL, NULL);
+		for (guint j = 0; keys[j] != NULL; j++) {
+			g_auto(GStrv) hint_strv = NULL;
+			hint_strv = g_key_file_get_string_list (kf,
+								groups[i],
+								keys[j],
+								NULL,
+								NULL);
+			if (hint_strv == NULL || hint_strv[0] == NULL)
+				continue;
+			asc_result_add_hint_by_cid_v (ctask->result,
+						      cid,
+						      hint_strv[0],
+						      hint_strv + 1);
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * asc_compose_checkpoint_try_restore:
+ *
+ * Restore the result of a previous run for this unit, if a checkpoint
+ * exists and the unit's input fingerprint is unchanged.
+ *
+ * Returns: %TRUE if the result was restored and processing can be skipped.
+ **/
+static gboolean
+asc_compose_checkpoint_try_restore (AscCompose *compose,
+				    AscComposeTask *ctask,
+				    const gchar *fingerprint)
+{
+	g_autoptr(GKeyFile) kf = g_key_file_new ();
+	g_autofree gchar *ckpt_fname = NULL;
+	g_autofree gchar *stored_fingerprint = NULL;
+
+	ckpt_fname = asc_compose_get_checkpoint_fname (compose, ctask);
+	if (ckpt_fname == NULL)
+		return FALSE;
+	if (!g_key_file_load_from_file (kf, ckpt_fname, G_KEY_FILE_NONE, NULL))
+		return FALSE;
+
+	if (g_key_file_get_integer (kf, "checkpoint", "version", NULL) !=
+	    ASC_CHECKPOINT_FORMAT_VERSION)
+		return FALSE;
+	stored_fingerprint = g_key_file_get_string (kf, "checkpoint", "fingerprint", NULL);
+	if (g_strcmp0 (stored_fingerprint, fingerprint) != 0) {
+		g_debug ("Checkpoint for unit %s is stale, reprocessing unit.",
+			 asc_unit_get_bundle_id (ctask->unit));
+		return FALSE;
+	}
+
+	return asc_compose_task_result_from_keyfile (compose, ctask, kf);
+}
+
+/**
+ * asc_compose_task_result_to_keyfile:
+ *
+ * Serialize the task's result (components with their metadata checksums
+ * as well as hints) into a #GKeyFile. Shared between checkpoint creation
+ * and sending results from isolated worker processes.
+ *
+ * Returns: %TRUE on success.
+ **/
+static gboolean
+asc_compose_task_result_to_keyfile (AscCompose *compose,
+				    AscComposeTask *ctask,
+				    GKeyFile *kf,
+				    GError **error)
+{
+	g_autoptr(GPtrArray) cpts = NULL;
+	g_autofree const gchar **hint_cids = NULL;
+
+	/* store components as catalog XML */
+	cpts = asc_result_fetch_components (ctask->result);
+	if (cpts->len > 0) {
+		g_autoptr(AsMetadata) mdata = as_metadata_new ();
+		g_autofree gchar *mdata_xml = NULL;
+
+		as_metadata_set_locale (mdata, "ALL");
+		as_metadata_set_format_style (mdata, AS_FORMAT_STYLE_CATALOG);
+		for (guint i = 0; i < cpts->len; i++) {
+			const gchar *checksum;
+			AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (cpts, i));
+
+			as_metadata_add_component (mdata, cpt);
+			checksum = asc_result_get_component_mdata_checksum (ctask->result, cpt);
+			if (checksum != NULL)
+				g_key_file_set_string (kf,
+						       "component_checksums",
+						       as_component_get_id (cpt),
+						       checksum);
+		}
+
+		mdata_xml = as_metadata_components_to_catalog (mdata, AS_FORMAT_KIND_XML, error);
+		if (mdata_xml == NULL)
+			return FALSE;
+		g_key_file_set_string (kf, "checkpoint", "metadata", mdata_xml);
+	}
+
+	/* store hints with their explanation variables, grouped by component-ID */
+	hint_cids = asc_result_get_component_ids_with_hints (ctask->result);
+	for (guint i = 0; hint_cids[i] != NULL; i++) {
+		g_autofree gchar *group = g_strdup_printf ("hints:%s", hint_cids[i]);
+		GPtrArray *hints = asc_result_get_hints (ctask->result, hint_cids[i]);
+
+		for (guint j = 0; j < hints->len; j++) {
+			AscHint *hint = ASC_HINT (g_ptr_array_index (hints, j));
+			GPtrArray *vars = asc_hint_get_explanation_vars_list (hint);
+			g_autofree gchar *key = g_strdup_printf ("hint%u", j);
+			g_autofree const gchar **strv = NULL;
+			guint pos = 0;
+
+			strv = g_new0 (const gchar *, vars->len + 2);
+			strv[pos++] = asc_hint_get_tag (hint);
+			for (guint k = 0; k < vars->len; k++)
+				strv[pos++] = g_ptr_array_index (vars, k);
+			g_key_file_set_string_list (kf, group, key, strv, pos);
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * asc_compose_checkpoint_save:
+ *
+ * Record the result of a fully processed unit, so a future run can skip
+ * the unit if its inputs are unchanged.
+ **/
 static void
-asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
+asc_compose_checkpoint_save (AscCompose *compose, AscComposeTask *ctask, const gchar *fingerprint)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GKeyFile) kf = g_key_file_new ();
+	g_autoptr(GPtrArray) all_hints = NULL;
+	g_autofree gchar *ckpt_fname = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+
+	ckpt_fname = asc_compose_get_checkpoint_fname (compose, ctask);
+	if (ckpt_fname == NULL)
+		return;
+
+	/* don't memoize failed units: errors may be transient (e.g. network issues)
+	 * and should be retried on the next run */
+	all_hints = asc_result_fetch_hints_all (ctask->result);
+	for (guint i = 0; i < all_hints->len; i++) {
+		if (asc_hint_is_error (ASC_HINT (g_ptr_array_index (all_hints, i))))
+			return;
+	}
+
+	g_key_file_set_integer (kf, "checkpoint", "version", ASC_CHECKPOINT_FORMAT_VERSION);
+	g_key_file_set_string (kf, "checkpoint", "fingerprint", fingerprint);
+
+	if (!asc_compose_task_result_to_keyfile (compose, ctask, kf, &tmp_error)) {
+		g_warning ("Unable to serialize result of unit %s for checkpoint: %s",
+			   asc_unit_get_bundle_id (ctask->unit),
+			   tmp_error->message);
+		return;
+	}
+
+	if (g_mkdir_with_parents (priv->checkpoint_dir, 0755) != 0) {
+		g_warning ("Unable to create checkpoint directory: %s", priv->checkpoint_dir);
+		return;
+	}
+	if (!g_key_file_save_to_file (kf, ckpt_fname, &tmp_error))
+		g_warning ("Unable to save checkpoint for unit %s: %s",
+			   asc_unit_get_bundle_id (ctask->unit),
+			   tmp_error->message);
+	else
+		g_debug ("Saved checkpoint for unit %s", asc_unit_get_bundle_id (ctask->unit));
+}
+
+/* fallback memory estimate for units without a size hint */
+#define ASC_COMPOSE_TASK_MEM_ESTIMATE_FALLBACK ((guint64) 256 * 1024 * 1024)
+
+/**
+ * asc_compose_task_estimate_mem_usage:
+ *
+ * Estimate the peak amount of memory that processing a unit will need.
+ * Decoded images dominate memory usage during a run and usually take a
+ * multiple of their compressed on-disk size, so we scale the unit's size
+ * hint and fall back to a generous flat estimate if no hint is available.
+ */
+static guint64
+asc_compose_task_estimate_mem_usage (AscComposeTask *ctask)
+{
+	guint64 size_hint = asc_unit_get_size_hint (ctask->unit);
+
+	if (size_hint == 0)
+		return ASC_COMPOSE_TASK_MEM_ESTIMATE_FALLBACK;
+	return MAX (size_hint * 4, (guint64) 16 * 1024 * 1024);
+}
+
+/**
+ * asc_compose_mem_budget_acquire:
+ *
+ * Block until the memory budget has enough headroom to admit a task with
+ * the given estimated memory demand. At least one task is always allowed
+ * to run, so a unit larger than the whole budget can not deadlock the
+ * queue - it will simply run alone.
+ */
+static void
+asc_compose_mem_budget_acquire (AscCompose *compose, guint64 estimate)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
+
+	if (priv->max_mem_bytes == 0)
+		return;
+
+	while (priv->mem_active_tasks > 0 &&
+	       priv->mem_reserved_bytes + estimate > priv->max_mem_bytes)
+		g_cond_wait (&priv->mem_cond, &priv->mutex);
+
+	priv->mem_reserved_bytes += estimate;
+	priv->mem_active_tasks++;
+}
+
+/**
+ * asc_compose_mem_budget_release:
+ *
+ * Return the estimated memory demand of a completed task to the budget
+ * and wake up any tasks waiting for admission.
+ */
+static void
+asc_compose_mem_budget_release (AscCompose *compose, guint64 estimate)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
+
+	if (priv->max_mem_bytes == 0)
+		return;
+
+	priv->mem_reserved_bytes -= estimate;
+	priv->mem_active_tasks--;
+	g_cond_broadcast (&priv->mem_cond);
+}
+
+static void
+asc_compose_process_task (AscComposeTask *ctask, AscCompose *compose)
 {
 	AscComposePrivate *priv = GET_PRIVATE (compose);
 	g_autofree gchar *metainfo_dir = NULL;
@@ -1368,6 +2482,10 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 	g_autoptr(GPtrArray) found_cpts = NULL;
 	g_autoptr(AsCurl) acurl = NULL;
 	g_autoptr(GError) tmp_error = NULL;
+	g_autofree gchar *ckpt_fingerprint = NULL;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GTimer) stage_timer = g_timer_new ();
+	AsProfileTask *stage_ptask = NULL;
 	gboolean has_fonts = FALSE;
 	gboolean filter_cpts = FALSE;
 	GPtrArray *contents = NULL;
@@ -1376,6 +2494,10 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 	asc_result_set_bundle_id (ctask->result, asc_unit_get_bundle_id (ctask->unit));
 	asc_result_set_bundle_kind (ctask->result, asc_unit_get_bundle_kind (ctask->unit));
 
+	ptask = as_profile_start (priv->profile,
+				  "AscCompose:unit:%s",
+				  asc_unit_get_bundle_id (ctask->unit));
+
 	/* configure metadata loader */
 	mdata = as_metadata_new ();
 	as_metadata_set_locale (mdata, "ALL");
@@ -1436,10 +2558,32 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 		}
 	}
 
+	/* reuse the result of a previous run if this unit's inputs are unchanged */
+	if (priv->checkpoint_dir != NULL) {
+		ckpt_fingerprint = asc_compose_get_unit_fingerprint (compose,
+								     ctask,
+								     mi_fnames,
+								     de_fname_map);
+		if (ckpt_fingerprint != NULL &&
+		    asc_compose_checkpoint_try_restore (compose, ctask, ckpt_fingerprint)) {
+			g_debug ("Restored unit %s from checkpoint, skipping its processing.",
+				 asc_unit_get_bundle_id (ctask->unit));
+			if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_SPILL_RESULTS) &&
+			    !as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_ISOLATE_UNITS))
+				asc_compose_spill_result (compose, ctask->result);
+			asc_unit_close (ctask->unit);
+			return;
+		}
+	}
+
 	/* check if we need to filter components */
 	filter_cpts = g_hash_table_size (priv->allowed_cids) > 0;
 
 	/* process metadata */
+	g_timer_start (stage_timer);
+	stage_ptask = as_profile_start (priv->profile,
+					"AscCompose:unit:%s:metainfo",
+					asc_unit_get_bundle_id (ctask->unit));
 	for (guint i = 0; i < mi_fnames->len; i++) {
 		g_autoptr(GBytes) mi_bytes = NULL;
 		g_autoptr(GBytes) rel_bytes = NULL;
@@ -1480,12 +2624,9 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 		}
 
 		/* check if we have a duplicate */
-		if (asc_compose_component_known (compose, cpt)) {
+		if (!asc_compose_claim_component (compose, cpt)) {
 			asc_result_add_hint_simple (ctask->result, cpt, "duplicate-component");
 			continue;
-		} else {
-			g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
-			g_hash_table_add (priv->known_cids, g_strdup (as_component_get_id (cpt)));
 		}
 
 		/* process any release information of this component and download release data if needed */
@@ -1622,6 +2763,8 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 			}
 		} /* end of desktop-entry support */
 	}	  /* end of metadata parsing loop */
+	as_profile_task_free (g_steal_pointer (&stage_ptask));
+	asc_compose_task_stage_finished (compose, ctask, ASC_TIMED_STAGE_METAINFO, stage_timer);
 
 	/* process the remaining .desktop files */
 	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_PROCESS_UNPAIRED_DESKTOP)) {
@@ -1688,6 +2831,10 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 	}
 
 	/* process icons and screenshots */
+	g_timer_start (stage_timer);
+	stage_ptask = as_profile_start (priv->profile,
+					"AscCompose:unit:%s:media",
+					asc_unit_get_bundle_id (ctask->unit));
 	found_cpts = asc_result_fetch_components (ctask->result);
 	for (guint i = 0; i < found_cpts->len; i++) {
 		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (found_cpts, i));
@@ -1720,6 +2867,7 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 			    ctask->result,
 			    cpt,
 			    acurl,
+			    priv->scr_dedup,
 			    priv->media_result_dir,
 			    as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_NO_PARTIAL_URLS)
 				? priv->media_baseurl
@@ -1731,9 +2879,16 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 		if (as_component_get_kind (cpt) == AS_COMPONENT_KIND_FONT)
 			has_fonts = TRUE;
 	}
+	as_profile_task_free (g_steal_pointer (&stage_ptask));
+	asc_compose_task_stage_finished (compose, ctask, ASC_TIMED_STAGE_MEDIA, stage_timer);
 
 	/* handle all font components present in this unit */
 	if (has_fonts && as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_PROCESS_FONTS)) {
+		g_autoptr(AsProfileTask) font_ptask =
+		    as_profile_start (priv->profile,
+				      "AscCompose:unit:%s:fonts",
+				      asc_unit_get_bundle_id (ctask->unit));
+		g_timer_start (stage_timer);
 		asc_process_fonts (ctask->result,
 				   ctask->unit,
 				   priv->prefix,
@@ -1741,6 +2896,7 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 				   priv->icons_result_dir,
 				   priv->icon_policy,
 				   priv->flags);
+		asc_compose_task_stage_finished (compose, ctask, ASC_TIMED_STAGE_FONTS, stage_timer);
 	}
 
 	/* clean up superfluous hints in case we were filtering the results, as some rejected
@@ -1768,95 +2924,476 @@ asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
 	if (!as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_NO_FINAL_CHECK))
 		asc_compose_finalize_components (compose, ctask->result);
 
+	/* record a checkpoint, so the next run can skip this unit if its inputs are unchanged */
+	if (ckpt_fingerprint != NULL)
+		asc_compose_checkpoint_save (compose, ctask, ckpt_fingerprint);
+
+	/* move the finished components to the on-disk spill store, if requested.
+	 * In isolated-units mode the spilling is done by the parent process once
+	 * it has received the result, since our bookkeeping would be lost with
+	 * this worker process. */
+	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_SPILL_RESULTS) &&
+	    !as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_ISOLATE_UNITS))
+		asc_compose_spill_result (compose, ctask->result);
+
 	asc_unit_close (ctask->unit);
 }
 
-static gboolean
-asc_compose_export_hints_data_yaml (AscCompose *compose, GError **error)
+#ifdef __linux__
+/**
+ * asc_compose_get_numa_cpusets:
+ *
+ * Read the CPU lists of all memory nodes from sysfs.
+ *
+ * Returns: An array of cpu_set_t, one per NUMA node, or %NULL if the
+ * topology could not be read or the machine only has a single node.
+ */
+static GArray *
+asc_compose_get_numa_cpusets (void)
 {
-	AscComposePrivate *priv = GET_PRIVATE (compose);
-	yaml_emitter_t emitter;
-	yaml_event_t event;
-	gboolean res = FALSE;
-	g_auto(GStrv) all_hint_tags = NULL;
-	g_autofree gchar *yaml_fname = NULL;
-	g_autoptr(GString) yaml_result = g_string_new ("");
+	static GArray *cpusets = NULL;
+	static gsize initialized = 0;
 
-	/* don't export anything if export dir isn't set */
-	if (priv->hints_result_dir == NULL)
-		return TRUE;
+	if (g_once_init_enter (&initialized)) {
+		GArray *sets = g_array_new (FALSE, TRUE, sizeof (cpu_set_t));
+		g_autoptr(GDir) dir = g_dir_open ("/sys/devices/system/node", 0, NULL);
+		const gchar *entry;
 
-	yaml_emitter_initialize (&emitter);
-	yaml_emitter_set_indent (&emitter, 2);
-	yaml_emitter_set_unicode (&emitter, TRUE);
-	yaml_emitter_set_width (&emitter, 100);
-	yaml_emitter_set_output (&emitter, as_compose_yaml_write_handler_cb, yaml_result);
+		while (dir != NULL && (entry = g_dir_read_name (dir)) != NULL) {
+			g_autofree gchar *fname = NULL;
+			g_autofree gchar *cpulist = NULL;
+			g_auto(GStrv) ranges = NULL;
+			cpu_set_t set;
 
-	/* emit start event */
-	yaml_stream_start_event_initialize (&event, YAML_UTF8_ENCODING);
-	if (!yaml_emitter_emit (&emitter, &event)) {
-		g_set_error_literal (error,
-				     ASC_COMPOSE_ERROR,
-				     ASC_COMPOSE_ERROR_FAILED,
-				     "Failed to initialize YAML emitter.");
-		yaml_emitter_delete (&emitter);
-		return FALSE;
-	}
+			if (!g_str_has_prefix (entry, "node"))
+				continue;
+			fname = g_build_filename ("/sys/devices/system/node",
+						  entry,
+						  "cpulist",
+						  NULL);
+			if (!g_file_get_contents (fname, &cpulist, NULL, NULL))
+				continue;
 
-	/* new document for the tag list */
-	yaml_document_start_event_initialize (&event, NULL, NULL, NULL, FALSE);
-	res = yaml_emitter_emit (&emitter, &event);
-	g_assert (res);
-	all_hint_tags = asc_globals_get_hint_tags ();
+			/* parse a cpulist like "0-31,64-95" */
+			CPU_ZERO (&set);
+			ranges = g_strsplit (g_strstrip (cpulist), ",", -1);
+			for (guint i = 0; ranges[i] != NULL; i++) {
+				gchar *dash = strchr (ranges[i], '-');
+				guint64 first, last;
+
+				if (dash != NULL)
+					*dash = '\0';
+				first = g_ascii_strtoull (ranges[i], NULL, 10);
+				last = (dash != NULL) ? g_ascii_strtoull (dash + 1, NULL, 10)
+						      : first;
+				for (guint64 cpu = first; cpu <= last && cpu < CPU_SETSIZE;
+				     cpu++)
+					CPU_SET (cpu, &set);
+			}
 
-	as_yaml_sequence_start (&emitter);
-	for (guint i = 0; all_hint_tags[i] != NULL; i++) {
-		const gchar *tag = all_hint_tags[i];
-		/* main dict start */
-		as_yaml_mapping_start (&emitter);
+			if (CPU_COUNT (&set) > 0)
+				g_array_append_val (sets, set);
+		}
 
-		as_yaml_emit_entry (&emitter, "Tag", tag);
-		as_yaml_emit_entry (
-		    &emitter,
-		    "Severity",
-		    as_issue_severity_to_string (asc_globals_hint_tag_severity (tag)));
-		as_yaml_emit_entry (&emitter,
-				    "Explanation",
-				    asc_globals_hint_tag_explanation (tag));
-		/* main dict end */
-		as_yaml_mapping_end (&emitter);
-	}
-	as_yaml_sequence_end (&emitter);
+		/* pinning is pointless with just one memory node */
+		if (sets->len < 2)
+			g_clear_pointer (&sets, g_array_unref);
 
-	/* finalize the tag list document */
-	yaml_document_end_event_initialize (&event, 1);
-	res = yaml_emitter_emit (&emitter, &event);
-	g_assert (res);
+		cpusets = sets;
+		g_once_init_leave (&initialized, 1);
+	}
 
-	/* new document for the actual issue hints */
-	yaml_document_start_event_initialize (&event, NULL, NULL, NULL, FALSE);
-	res = yaml_emitter_emit (&emitter, &event);
-	g_assert (res);
+	return cpusets;
+}
 
-	as_yaml_sequence_start (&emitter);
-	for (guint i = 0; i < priv->results->len; i++) {
-		g_autofree const gchar **hints_cids = NULL;
-		AscResult *result = ASC_RESULT (g_ptr_array_index (priv->results, i));
+/**
+ * asc_compose_pin_to_numa_node:
+ *
+ * Pin the given process - or the calling thread, if @pid is 0 - to the CPUs
+ * of one NUMA node, chosen round-robin. All memory the worker allocates
+ * afterwards is placed on that node by first-touch, so a unit's working set
+ * stays local to one memory controller instead of bouncing between sockets.
+ */
+static void
+asc_compose_pin_to_numa_node (pid_t pid)
+{
+	static gint next_node = 0;
+	GArray *cpusets = asc_compose_get_numa_cpusets ();
+	cpu_set_t *set;
+	guint node;
 
-		hints_cids = asc_result_get_component_ids_with_hints (result);
-		if (hints_cids == NULL)
-			continue;
+	if (cpusets == NULL)
+		return;
 
-		as_yaml_mapping_start (&emitter);
-		as_yaml_emit_entry (&emitter, "Unit", asc_result_get_bundle_id (result));
-		as_yaml_emit_scalar (&emitter, "Hints");
-		as_yaml_sequence_start (&emitter);
-		for (guint j = 0; hints_cids[j] != NULL; j++) {
-			GPtrArray *hints = asc_result_get_hints (result, hints_cids[j]);
+	node = (guint) g_atomic_int_add (&next_node, 1) % cpusets->len;
+	set = &g_array_index (cpusets, cpu_set_t, node);
+	if (sched_setaffinity (pid, sizeof (cpu_set_t), set) != 0)
+		g_debug ("Unable to set NUMA node affinity: %s", g_strerror (errno));
+}
+#endif
 
-			as_yaml_mapping_start (&emitter);
-			as_yaml_emit_scalar (&emitter, hints_cids[j]);
-			as_yaml_sequence_start (&emitter);
+/**
+ * asc_compose_process_task_cb:
+ *
+ * Process a compose task, waiting for admission by the memory budget
+ * first if one was set.
+ */
+static void
+asc_compose_process_task_cb (AscComposeTask *ctask, AscCompose *compose)
+{
+	guint64 mem_estimate = asc_compose_task_estimate_mem_usage (ctask);
+
+#ifdef __linux__
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_NUMA_AWARE))
+		asc_compose_pin_to_numa_node (0);
+#endif
+
+	asc_compose_mem_budget_acquire (compose, mem_estimate);
+	{
+		/* measured after the memory gate, so time spent waiting for
+		 * budget does not count against the unit */
+		g_autoptr(GTimer) timer = g_timer_new ();
+		asc_compose_process_task (ctask, compose);
+		ctask->total_secs = g_timer_elapsed (timer, NULL);
+	}
+	asc_compose_mem_budget_release (compose, mem_estimate);
+}
+
+typedef struct {
+	AscComposeTask *ctask; /* currently processed task, or NULL if the slot is free */
+	GString *buf;	       /* received serialized result data */
+	gint64 start_time;     /* monotonic time the worker was launched at */
+	pid_t pid;
+	gint fd;
+} AscComposeWorker;
+
+/**
+ * asc_compose_worker_start:
+ *
+ * Process the given task in a forked worker process, which will send its
+ * serialized result back to us over a pipe.
+ *
+ * Returns: %TRUE if the worker process was launched.
+ **/
+static gboolean
+asc_compose_worker_start (AscCompose *compose, AscComposeWorker *worker, AscComposeTask *ctask)
+{
+	gint pipefd[2];
+	pid_t pid;
+
+	if (pipe (pipefd) != 0)
+		return FALSE;
+
+	pid = fork ();
+	if (pid < 0) {
+		close (pipefd[0]);
+		close (pipefd[1]);
+		return FALSE;
+	}
+
+	if (pid == 0) {
+		/* worker: process the unit, then send the serialized result to the parent */
+		g_autoptr(GKeyFile) kf = g_key_file_new ();
+		g_autofree gchar *data = NULL;
+		gsize len = 0;
+		gsize off = 0;
+
+		close (pipefd[0]);
+		/* the worker count already bounds concurrency here, so the
+		 * memory budget gate is bypassed */
+		asc_compose_process_task (ctask, compose);
+		if (asc_compose_task_result_to_keyfile (compose, ctask, kf, NULL))
+			data = g_key_file_to_data (kf, &len, NULL);
+
+		while (data != NULL && off < len) {
+			gssize bytes_written = write (pipefd[1], data + off, len - off);
+			if (bytes_written < 0) {
+				if (errno == EINTR)
+					continue;
+				break;
+			}
+			off += (gsize) bytes_written;
+		}
+		close (pipefd[1]);
+
+		/* exit immediately, so we never run any cleanup handlers on the
+		 * state shared with our parent process */
+		_exit ((data == NULL || off != len) ? 1 : 0);
+	}
+
+	/* parent: read the result data without ever blocking on a single worker */
+	close (pipefd[1]);
+	fcntl (pipefd[0], F_SETFL, O_NONBLOCK);
+
+#ifdef __linux__
+	{
+		AscComposePrivate *priv = GET_PRIVATE (compose);
+		if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_NUMA_AWARE))
+			asc_compose_pin_to_numa_node (pid);
+	}
+#endif
+
+	worker->ctask = ctask;
+	worker->pid = pid;
+	worker->fd = pipefd[0];
+	worker->buf = g_string_new (NULL);
+	worker->start_time = g_get_monotonic_time ();
+	return TRUE;
+}
+
+/**
+ * asc_compose_worker_finish:
+ *
+ * Reap a worker process that has closed its result pipe and restore the
+ * received result into the task, or record an error hint in case the
+ * worker crashed.
+ **/
+static void
+asc_compose_worker_finish (AscCompose *compose, AscComposeWorker *worker)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	AscComposeTask *ctask = worker->ctask;
+	g_autoptr(GKeyFile) kf = g_key_file_new ();
+	gint status = 0;
+
+	close (worker->fd);
+	while (waitpid (worker->pid, &status, 0) < 0) {
+		if (errno != EINTR)
+			break;
+	}
+
+	/* the stage timings were lost with the worker process, but the wall-clock
+	 * time of its whole lifetime is still a useful slowness signal */
+	ctask->total_secs = (g_get_monotonic_time () - worker->start_time) /
+			    (gdouble) G_USEC_PER_SEC;
+
+	/* propagate unit bundle ID */
+	asc_result_set_bundle_id (ctask->result, asc_unit_get_bundle_id (ctask->unit));
+	asc_result_set_bundle_kind (ctask->result, asc_unit_get_bundle_kind (ctask->unit));
+
+	if (!WIFEXITED (status) || WEXITSTATUS (status) != 0) {
+		g_autofree gchar *msg = NULL;
+
+		if (WIFSIGNALED (status))
+			msg = g_strdup_printf ("Worker process was terminated by signal %d (%s)",
+					       WTERMSIG (status),
+					       g_strsignal (WTERMSIG (status)));
+		else
+			msg = g_strdup_printf ("Worker process exited with status %d",
+					       WIFEXITED (status) ? WEXITSTATUS (status) : -1);
+
+		g_warning ("Unit %s: %s", asc_unit_get_bundle_id (ctask->unit), msg);
+		asc_result_add_hint (ctask->result,
+				     NULL,
+				     "unit-process-failed",
+				     "name",
+				     asc_unit_get_bundle_id (ctask->unit),
+				     "msg",
+				     msg,
+				     NULL);
+	} else if (worker->buf->len > 0 &&
+		   (!g_key_file_load_from_data (kf,
+						worker->buf->str,
+						worker->buf->len,
+						G_KEY_FILE_NONE,
+						NULL) ||
+		    !asc_compose_task_result_from_keyfile (compose, ctask, kf))) {
+		asc_result_add_hint (
+		    ctask->result,
+		    NULL,
+		    "unit-process-failed",
+		    "name",
+		    asc_unit_get_bundle_id (ctask->unit),
+		    "msg",
+		    "Unable to parse the result data received from the worker process",
+		    NULL);
+	}
+
+	/* the worker could not spill its own result, so do that now on its behalf */
+	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_SPILL_RESULTS))
+		asc_compose_spill_result (compose, ctask->result);
+
+	g_string_free (worker->buf, TRUE);
+	worker->buf = NULL;
+	worker->ctask = NULL;
+	worker->fd = -1;
+}
+
+/**
+ * asc_compose_process_tasks_isolated:
+ *
+ * Process all tasks with each unit running in its own forked worker process,
+ * with up to @n_workers units being processed at the same time.
+ * This isolates the run from crashes caused by pathological data in single
+ * units (e.g. images making the pixbuf loader run out of memory), and sidesteps
+ * allocator contention between threads on machines with many cores.
+ **/
+static void
+asc_compose_process_tasks_isolated (AscCompose *compose, GPtrArray *tasks, guint n_workers)
+{
+	g_autofree AscComposeWorker *workers = g_new0 (AscComposeWorker, n_workers);
+	g_autofree GPollFD *pollfds = g_new0 (GPollFD, n_workers);
+	guint next_task = 0;
+	guint n_running = 0;
+
+	for (guint i = 0; i < n_workers; i++)
+		workers[i].fd = -1;
+
+	while (next_task < tasks->len || n_running > 0) {
+		guint n_poll = 0;
+
+		/* launch workers for pending tasks into free slots */
+		for (guint i = 0; i < n_workers && next_task < tasks->len; i++) {
+			AscComposeTask *ctask;
+
+			if (workers[i].ctask != NULL)
+				continue;
+			ctask = g_ptr_array_index (tasks, next_task++);
+			if (asc_compose_worker_start (compose, &workers[i], ctask)) {
+				n_running++;
+			} else {
+				g_warning ("Unable to launch worker process for unit %s, "
+					   "processing it in-process.",
+					   asc_unit_get_bundle_id (ctask->unit));
+				asc_compose_process_task_cb (ctask, compose);
+			}
+		}
+		if (n_running == 0)
+			continue;
+
+		/* wait for data from the running workers */
+		for (guint i = 0; i < n_workers; i++) {
+			if (workers[i].ctask == NULL)
+				continue;
+			pollfds[n_poll].fd = workers[i].fd;
+			pollfds[n_poll].events = G_IO_IN | G_IO_HUP | G_IO_ERR;
+			pollfds[n_poll].revents = 0;
+			n_poll++;
+		}
+		if (g_poll (pollfds, n_poll, -1) < 0 && errno != EINTR)
+			g_warning ("Failed to poll compose worker pipes: %s", g_strerror (errno));
+
+		/* collect available data, finish workers that are done */
+		for (guint i = 0; i < n_workers; i++) {
+			AscComposeWorker *worker = &workers[i];
+			gboolean worker_done = FALSE;
+
+			if (worker->ctask == NULL)
+				continue;
+			while (TRUE) {
+				gchar iobuf[16 * 1024];
+				gssize bytes_read = read (worker->fd, iobuf, sizeof (iobuf));
+				if (bytes_read < 0) {
+					if (errno == EINTR)
+						continue;
+					if (errno == EAGAIN || errno == EWOULDBLOCK)
+						break;
+					/* treat read errors like a closed pipe */
+					worker_done = TRUE;
+					break;
+				}
+				if (bytes_read == 0) {
+					worker_done = TRUE;
+					break;
+				}
+				g_string_append_len (worker->buf, iobuf, bytes_read);
+			}
+
+			if (worker_done) {
+				asc_compose_worker_finish (compose, worker);
+				n_running--;
+			}
+		}
+	}
+}
+
+static gboolean
+asc_compose_export_hints_data_yaml (AscCompose *compose, GError **error)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	yaml_emitter_t emitter;
+	yaml_event_t event;
+	gboolean res = FALSE;
+	g_auto(GStrv) all_hint_tags = NULL;
+	g_autofree gchar *yaml_fname = NULL;
+	g_autoptr(GString) yaml_result = g_string_new ("");
+
+	/* don't export anything if export dir isn't set */
+	if (priv->hints_result_dir == NULL)
+		return TRUE;
+
+	yaml_emitter_initialize (&emitter);
+	yaml_emitter_set_indent (&emitter, 2);
+	yaml_emitter_set_unicode (&emitter, TRUE);
+	yaml_emitter_set_width (&emitter, 100);
+	yaml_emitter_set_output (&emitter, as_compose_yaml_write_handler_cb, yaml_result);
+
+	/* emit start event */
+	yaml_stream_start_event_initialize (&event, YAML_UTF8_ENCODING);
+	if (!yaml_emitter_emit (&emitter, &event)) {
+		g_set_error_literal (error,
+				     ASC_COMPOSE_ERROR,
+				     ASC_COMPOSE_ERROR_FAILED,
+				     "Failed to initialize YAML emitter.");
+		yaml_emitter_delete (&emitter);
+		return FALSE;
+	}
+
+	/* new document for the tag list */
+	yaml_document_start_event_initialize (&event, NULL, NULL, NULL, FALSE);
+	res = yaml_emitter_emit (&emitter, &event);
+	g_assert (res);
+	all_hint_tags = asc_globals_get_hint_tags ();
+
+	as_yaml_sequence_start (&emitter);
+	for (guint i = 0; all_hint_tags[i] != NULL; i++) {
+		const gchar *tag = all_hint_tags[i];
+		/* main dict start */
+		as_yaml_mapping_start (&emitter);
+
+		as_yaml_emit_entry (&emitter, "Tag", tag);
+		as_yaml_emit_entry (
+		    &emitter,
+		    "Severity",
+		    as_issue_severity_to_string (asc_globals_hint_tag_severity (tag)));
+		as_yaml_emit_entry (&emitter,
+				    "Explanation",
+				    asc_globals_hint_tag_explanation (tag));
+		/* main dict end */
+		as_yaml_mapping_end (&emitter);
+	}
+	as_yaml_sequence_end (&emitter);
+
+	/* finalize the tag list document */
+	yaml_document_end_event_initialize (&event, 1);
+	res = yaml_emitter_emit (&emitter, &event);
+	g_assert (res);
+
+	/* new document for the actual issue hints */
+	yaml_document_start_event_initialize (&event, NULL, NULL, NULL, FALSE);
+	res = yaml_emitter_emit (&emitter, &event);
+	g_assert (res);
+
+	as_yaml_sequence_start (&emitter);
+	for (guint i = 0; i < priv->results->len; i++) {
+		g_autofree const gchar **hints_cids = NULL;
+		AscResult *result = ASC_RESULT (g_ptr_array_index (priv->results, i));
+
+		hints_cids = asc_result_get_component_ids_with_hints (result);
+		if (hints_cids == NULL)
+			continue;
+
+		as_yaml_mapping_start (&emitter);
+		as_yaml_emit_entry (&emitter, "Unit", asc_result_get_bundle_id (result));
+		as_yaml_emit_scalar (&emitter, "Hints");
+		as_yaml_sequence_start (&emitter);
+		for (guint j = 0; hints_cids[j] != NULL; j++) {
+			GPtrArray *hints = asc_result_get_hints (result, hints_cids[j]);
+
+			as_yaml_mapping_start (&emitter);
+			as_yaml_emit_scalar (&emitter, hints_cids[j]);
+			as_yaml_sequence_start (&emitter);
 			for (guint k = 0; k < hints->len; k++) {
 				GPtrArray *vars;
 				AscHint *hint = ASC_HINT (g_ptr_array_index (hints, k));
@@ -1902,6 +3439,243 @@ asc_compose_export_hints_data_yaml (AscCompose *compose, GError **error)
 	return g_file_set_contents (yaml_fname, yaml_result->str, yaml_result->len, error);
 }
 
+/* serialization format version of the compact binary hint log */
+#define ASC_HINTS_BINARY_FORMAT_VERSION 1
+
+/* GVariant type of the binary hint log: format version, the tag registry
+ * (tag → severity & explanation template) and one flat record per hint
+ * (unit, component-ID, tag, template variables) */
+#define ASC_HINTS_BINARY_VTYPE "(ua{s(us)}a(sssas))"
+
+static gboolean
+asc_compose_export_hints_data_binary (AscCompose *compose, GError **error)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GVariant) data = NULL;
+	g_autoptr(GBytes) bytes = NULL;
+	g_autofree gchar *fname = NULL;
+	g_auto(GStrv) all_hint_tags = NULL;
+	GVariantBuilder tags_b;
+	GVariantBuilder hints_b;
+
+	/* don't export anything if export dir isn't set */
+	if (priv->hints_result_dir == NULL)
+		return TRUE;
+
+	/* embed the tag definitions, so the log can be expanded into a
+	 * report later without access to the hint-tag registry */
+	g_variant_builder_init (&tags_b, G_VARIANT_TYPE ("a{s(us)}"));
+	all_hint_tags = asc_globals_get_hint_tags ();
+	for (guint i = 0; all_hint_tags[i] != NULL; i++) {
+		const gchar *tag = all_hint_tags[i];
+		const gchar *explanation = asc_globals_hint_tag_explanation (tag);
+		g_variant_builder_add (&tags_b,
+				       "{s(us)}",
+				       tag,
+				       (guint32) asc_globals_hint_tag_severity (tag),
+				       explanation != NULL ? explanation : "");
+	}
+
+	/* one compact record per hint, with the raw, unexpanded variables */
+	g_variant_builder_init (&hints_b, G_VARIANT_TYPE ("a(sssas)"));
+	for (guint i = 0; i < priv->results->len; i++) {
+		g_autofree const gchar **hints_cids = NULL;
+		AscResult *result = ASC_RESULT (g_ptr_array_index (priv->results, i));
+		const gchar *bundle_id = asc_result_get_bundle_id (result);
+
+		hints_cids = asc_result_get_component_ids_with_hints (result);
+		if (hints_cids == NULL)
+			continue;
+		for (guint j = 0; hints_cids[j] != NULL; j++) {
+			GPtrArray *hints = asc_result_get_hints (result, hints_cids[j]);
+			for (guint k = 0; k < hints->len; k++) {
+				GVariantBuilder vars_b;
+				GPtrArray *vars;
+				AscHint *hint = ASC_HINT (g_ptr_array_index (hints, k));
+
+				g_variant_builder_init (&vars_b, G_VARIANT_TYPE ("as"));
+				vars = asc_hint_get_explanation_vars_list (hint);
+				for (guint l = 0; l < vars->len; l++)
+					g_variant_builder_add (&vars_b,
+							       "s",
+							       g_ptr_array_index (vars, l));
+
+				g_variant_builder_add (&hints_b,
+						       "(sssas)",
+						       bundle_id != NULL ? bundle_id : "",
+						       hints_cids[j],
+						       asc_hint_get_tag (hint),
+						       &vars_b);
+			}
+		}
+	}
+
+	data = g_variant_ref_sink (g_variant_new (ASC_HINTS_BINARY_VTYPE,
+						  (guint32) ASC_HINTS_BINARY_FORMAT_VERSION,
+						  &tags_b,
+						  &hints_b));
+	bytes = g_variant_get_data_as_bytes (data);
+
+	g_mkdir_with_parents (priv->hints_result_dir, 0755);
+	fname = g_strdup_printf ("%s/%s.hints.bin", priv->hints_result_dir, priv->origin);
+	return g_file_set_contents (fname,
+				    g_bytes_get_data (bytes, NULL),
+				    (gssize) g_bytes_get_size (bytes),
+				    error);
+}
+
+/**
+ * asc_compose_hints_binary_log_to_yaml:
+ * @fname: Path of a binary hint log written with %ASC_COMPOSE_FLAG_BINARY_HINTS.
+ * @error: A #GError or %NULL
+ *
+ * Expand a compact binary hint log into a YAML issue report.
+ * Explanation templates are only expanded at this point, so report
+ * generation can happen selectively after the compose run, instead of
+ * paying for it while composing.
+ *
+ * Returns: (transfer full): The YAML report data.
+ **/
+gchar *
+asc_compose_hints_binary_log_to_yaml (const gchar *fname, GError **error)
+{
+	yaml_emitter_t emitter;
+	yaml_event_t event;
+	gboolean res;
+	g_autoptr(GVariant) data = NULL;
+	g_autoptr(GVariant) tags_v = NULL;
+	g_autoptr(GVariant) hints_v = NULL;
+	g_autofree gchar *contents = NULL;
+	gsize contents_len;
+	guint32 version;
+	GVariantIter iter;
+	gchar *tag_name;
+	guint32 severity;
+	gchar *explanation;
+	gchar *unit_id;
+	gchar *cid;
+	gchar *tag;
+	GVariantIter *vars_iter;
+	g_autoptr(GString) yaml_result = g_string_new ("");
+
+	if (!g_file_get_contents (fname, &contents, &contents_len, error))
+		return NULL;
+	data = g_variant_new_from_data (G_VARIANT_TYPE (ASC_HINTS_BINARY_VTYPE),
+					contents,
+					contents_len,
+					FALSE,
+					NULL,
+					NULL);
+	if (data == NULL || !g_variant_is_normal_form (data)) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "File '%s' is not a valid binary hint log.",
+			     fname);
+		return NULL;
+	}
+	g_variant_ref_sink (data);
+	g_variant_get (data, "(u@a{s(us)}@a(sssas))", &version, &tags_v, &hints_v);
+	if (version != ASC_HINTS_BINARY_FORMAT_VERSION) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "Binary hint log '%s' has unsupported format version %u.",
+			     fname,
+			     version);
+		return NULL;
+	}
+
+	yaml_emitter_initialize (&emitter);
+	yaml_emitter_set_indent (&emitter, 2);
+	yaml_emitter_set_unicode (&emitter, TRUE);
+	yaml_emitter_set_width (&emitter, 100);
+	yaml_emitter_set_output (&emitter, as_compose_yaml_write_handler_cb, yaml_result);
+
+	yaml_stream_start_event_initialize (&event, YAML_UTF8_ENCODING);
+	if (!yaml_emitter_emit (&emitter, &event)) {
+		g_set_error_literal (error,
+				     ASC_COMPOSE_ERROR,
+				     ASC_COMPOSE_ERROR_FAILED,
+				     "Failed to initialize YAML emitter.");
+		yaml_emitter_delete (&emitter);
+		return NULL;
+	}
+
+	/* document with the tag definitions from the log */
+	yaml_document_start_event_initialize (&event, NULL, NULL, NULL, FALSE);
+	res = yaml_emitter_emit (&emitter, &event);
+	g_assert (res);
+
+	as_yaml_sequence_start (&emitter);
+	g_variant_iter_init (&iter, tags_v);
+	while (g_variant_iter_loop (&iter, "{s(us)}", &tag_name, &severity, &explanation)) {
+		as_yaml_mapping_start (&emitter);
+		as_yaml_emit_entry (&emitter, "Tag", tag_name);
+		as_yaml_emit_entry (&emitter,
+				    "Severity",
+				    as_issue_severity_to_string ((AsIssueSeverity) severity));
+		as_yaml_emit_entry (&emitter, "Explanation", explanation);
+		as_yaml_mapping_end (&emitter);
+	}
+	as_yaml_sequence_end (&emitter);
+
+	yaml_document_end_event_initialize (&event, 1);
+	res = yaml_emitter_emit (&emitter, &event);
+	g_assert (res);
+
+	/* document with the hints, now with their explanations expanded */
+	yaml_document_start_event_initialize (&event, NULL, NULL, NULL, FALSE);
+	res = yaml_emitter_emit (&emitter, &event);
+	g_assert (res);
+
+	as_yaml_sequence_start (&emitter);
+	g_variant_iter_init (&iter, hints_v);
+	while (g_variant_iter_loop (&iter, "(sssas)", &unit_id, &cid, &tag, &vars_iter)) {
+		g_autoptr(AscHint) hint = asc_hint_new ();
+		g_autofree gchar *expanded = NULL;
+		const gchar *var_name;
+		const gchar *var_value;
+		guint32 tag_severity = AS_ISSUE_SEVERITY_UNKNOWN;
+		g_autofree gchar *tag_explanation = NULL;
+
+		g_variant_lookup (tags_v, tag, "(us)", &tag_severity, &tag_explanation);
+		asc_hint_set_tag (hint, tag);
+		asc_hint_set_severity (hint, (AsIssueSeverity) tag_severity);
+		if (tag_explanation != NULL)
+			asc_hint_set_explanation_template (hint, tag_explanation);
+		while (g_variant_iter_next (vars_iter, "&s", &var_name) &&
+		       g_variant_iter_next (vars_iter, "&s", &var_value))
+			asc_hint_add_explanation_var (hint, var_name, var_value);
+		expanded = asc_hint_format_explanation (hint);
+
+		as_yaml_mapping_start (&emitter);
+		as_yaml_emit_entry (&emitter, "Unit", unit_id);
+		as_yaml_emit_entry (&emitter, "Component", cid);
+		as_yaml_emit_entry (&emitter, "Tag", tag);
+		as_yaml_emit_entry (
+		    &emitter,
+		    "Severity",
+		    as_issue_severity_to_string ((AsIssueSeverity) tag_severity));
+		as_yaml_emit_entry (&emitter, "Explanation", expanded);
+		as_yaml_mapping_end (&emitter);
+	}
+	as_yaml_sequence_end (&emitter);
+
+	yaml_document_end_event_initialize (&event, 1);
+	res = yaml_emitter_emit (&emitter, &event);
+	g_assert (res);
+
+	yaml_stream_end_event_initialize (&event);
+	res = yaml_emitter_emit (&emitter, &event);
+	g_assert (res);
+
+	yaml_emitter_flush (&emitter);
+	yaml_emitter_delete (&emitter);
+
+	return g_string_free (g_steal_pointer (&yaml_result), FALSE);
+}
+
 static gboolean
 asc_compose_export_hints_data_html (AscCompose *compose, GError **error)
 {
@@ -2055,13 +3829,18 @@ asc_compose_export_hints_data_html (AscCompose *compose, GError **error)
 	return g_file_set_contents (html_fname, html->str, html->len, error);
 }
 
-static gboolean
-asc_compose_save_metadata_result (AscCompose *compose, gboolean *results_not_empty, GError **error)
+/**
+ * asc_compose_new_metadata_writer:
+ *
+ * Create an #AsMetadata instance configured the way all catalog output
+ * of this compose run is serialized, so spilled result fragments and the
+ * final catalog write always use identical serialization settings.
+ */
+static AsMetadata *
+asc_compose_new_metadata_writer (AscCompose *compose)
 {
 	AscComposePrivate *priv = GET_PRIVATE (compose);
-	g_autoptr(AsMetadata) mdata = NULL;
-	g_autofree gchar *data_basename = NULL;
-	g_autofree gchar *data_fname = NULL;
+	AsMetadata *mdata;
 
 	mdata = as_metadata_new ();
 	as_metadata_set_format_style (mdata, AS_FORMAT_STYLE_CATALOG);
@@ -2075,6 +3854,107 @@ asc_compose_save_metadata_result (AscCompose *compose, gboolean *results_not_emp
 	    !as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_NO_PARTIAL_URLS))
 		as_metadata_set_media_baseurl (mdata, priv->media_baseurl);
 
+	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_EMIT_SEARCH_TOKENS))
+		as_metadata_set_write_search_tokens (mdata, TRUE);
+
+	return mdata;
+}
+
+/**
+ * asc_compose_write_ostream_cb:
+ *
+ * #AsDataWriteFn forwarding all chunks to a #GOutputStream.
+ */
+static gboolean
+asc_compose_write_ostream_cb (const gchar *data, gsize data_len, gpointer user_data)
+{
+	return g_output_stream_write_all (G_OUTPUT_STREAM (user_data),
+					  data,
+					  data_len,
+					  NULL,
+					  NULL,
+					  NULL);
+}
+
+/**
+ * asc_compose_save_metadata_spilled:
+ *
+ * Write the final catalog file by framing the spilled per-unit fragments -
+ * and any components still held in @mdata - with a catalog document header
+ * and footer, streaming everything through the compressor one fragment at
+ * a time instead of building the complete document in memory.
+ */
+static gboolean
+asc_compose_save_metadata_spilled (AscCompose *compose,
+				   AsMetadata *mdata,
+				   const gchar *data_fname,
+				   GError **error)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GFileOutputStream) fos = NULL;
+	g_autoptr(GOutputStream) out = NULL;
+
+	file = g_file_new_for_path (data_fname);
+	fos = g_file_replace (file, NULL, FALSE, G_FILE_CREATE_REPLACE_DESTINATION, NULL, error);
+	if (fos == NULL)
+		return FALSE;
+
+	if (g_str_has_suffix (data_fname, ".gz")) {
+		g_autoptr(GZlibCompressor) compressor =
+		    g_zlib_compressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP, -1);
+		out = g_converter_output_stream_new (G_OUTPUT_STREAM (fos),
+						     G_CONVERTER (compressor));
+	} else {
+		out = G_OUTPUT_STREAM (g_object_ref (fos));
+	}
+
+	if (!as_metadata_xml_write_catalog_header (mdata, asc_compose_write_ostream_cb, out)) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "failed to write catalog data to %s",
+			     data_fname);
+		return FALSE;
+	}
+
+	for (guint i = 0; i < priv->spill_files->len; i++) {
+		const gchar *frag_fname = g_ptr_array_index (priv->spill_files, i);
+		g_autofree gchar *frag_data = NULL;
+		gsize frag_len;
+
+		if (!g_file_get_contents (frag_fname, &frag_data, &frag_len, error))
+			return FALSE;
+		if (!g_output_stream_write_all (out, frag_data, frag_len, NULL, NULL, error))
+			return FALSE;
+	}
+
+	/* write any components that could not be spilled and are still held in memory */
+	if (!as_metadata_xml_write_catalog_components (mdata,
+						       asc_compose_write_ostream_cb,
+						       out) ||
+	    !as_metadata_xml_write_catalog_footer (mdata, asc_compose_write_ostream_cb, out)) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "failed to write catalog data to %s",
+			     data_fname);
+		return FALSE;
+	}
+
+	return g_output_stream_close (out, NULL, error);
+}
+
+static gboolean
+asc_compose_save_metadata_result (AscCompose *compose, gboolean *results_not_empty, GError **error)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(AsMetadata) mdata = NULL;
+	g_autofree gchar *data_basename = NULL;
+	g_autofree gchar *data_fname = NULL;
+
+	mdata = asc_compose_new_metadata_writer (compose);
+
 	if (priv->format == AS_FORMAT_KIND_YAML)
 		data_basename = g_strdup_printf ("%s.yml.gz", priv->origin);
 	else
@@ -2091,7 +3971,7 @@ asc_compose_save_metadata_result (AscCompose *compose, gboolean *results_not_emp
 	}
 
 	if (results_not_empty != NULL)
-		*results_not_empty = FALSE;
+		*results_not_empty = priv->spilled_cpts > 0;
 
 	for (guint i = 0; i < priv->results->len; i++) {
 		g_autoptr(GPtrArray) cpts = NULL;
@@ -2106,6 +3986,8 @@ asc_compose_save_metadata_result (AscCompose *compose, gboolean *results_not_emp
 	}
 
 	data_fname = g_build_filename (priv->data_result_dir, data_basename, NULL);
+	if (priv->spill_files->len > 0)
+		return asc_compose_save_metadata_spilled (compose, mdata, data_fname, error);
 	return as_metadata_save_catalog (mdata, data_fname, priv->format, error);
 }
 
@@ -2142,6 +4024,286 @@ asc_compose_finalize_result (AscCompose *compose, AscResult *result)
 	asc_compose_finalize_components (compose, result);
 }
 
+/**
+ * asc_compose_verify_result_cb:
+ *
+ * Validate the serialized form of all components in one result container
+ * and register any issues found as hints on the respective component.
+ * We build the catalog XML node for each component in-memory and hand it
+ * straight to the validator, so verifying the output does not need an
+ * extra write/read/parse cycle over the generated metadata.
+ */
+static void
+asc_compose_verify_result_cb (AscResult *cres, AscCompose *compose)
+{
+	g_autoptr(AsValidator) validator = NULL;
+	g_autoptr(AsContext) ctx = NULL;
+	g_autoptr(GPtrArray) cpts = NULL;
+
+	validator = as_validator_new ();
+	/* don't check web URLs for validity, we catch those issues differently */
+	as_validator_set_allow_net (validator, FALSE);
+
+	/* serialize the same way asc_compose_save_metadata_result() will */
+	ctx = as_context_new ();
+	as_context_set_locale (ctx, "ALL");
+	as_context_set_style (ctx, AS_FORMAT_STYLE_CATALOG);
+
+	cpts = asc_result_fetch_components (cres);
+	for (guint i = 0; i < cpts->len; i++) {
+		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (cpts, i));
+		g_autoptr(AsComponent) vcpt = NULL;
+		g_autoptr(GList) issues = NULL;
+		xmlNode *cnode;
+
+		cnode = as_component_to_xml_node (cpt, ctx, NULL, NULL);
+		if (cnode == NULL)
+			continue;
+
+		as_validator_clear_issues (validator);
+		vcpt = as_validator_validate_component_node (validator, ctx, cnode);
+
+		issues = as_validator_get_issues (validator);
+		for (GList *l = issues; l != NULL; l = l->next) {
+			AsValidatorIssue *issue = AS_VALIDATOR_ISSUE (l->data);
+			g_autofree gchar *asv_tag = NULL;
+			const gchar *issue_hint;
+
+			/* create a tag for asgen out of the AppStream validator tag by prefixing it */
+			asv_tag = g_strconcat ("asv-",
+					       as_validator_issue_get_tag (issue),
+					       NULL);
+			issue_hint = as_validator_issue_get_hint (issue);
+			if (issue_hint == NULL)
+				issue_hint = "";
+			asc_result_add_hint (cres,
+					     cpt,
+					     asv_tag,
+					     "location",
+					     as_component_get_id (cpt),
+					     "hint",
+					     issue_hint,
+					     NULL);
+		}
+
+		xmlFreeNode (cnode);
+	}
+}
+
+/**
+ * asc_compose_verify_results:
+ *
+ * Validate the in-memory serialization of all generated components, so a
+ * separate validation pass over the written catalog data is not needed.
+ * Each result container is verified by a worker of its own, with its own
+ * validator instance accumulating the issues.
+ */
+static void
+asc_compose_verify_results (AscCompose *compose)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(AsProfileTask) ptask = NULL;
+
+	ptask = as_profile_start_literal (priv->profile, "AscCompose:verify-results");
+
+	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_USE_THREADS) &&
+	    priv->results->len > 1) {
+		g_autoptr(GError) tmp_error = NULL;
+		GThreadPool *tpool;
+
+		tpool = g_thread_pool_new ((GFunc) asc_compose_verify_result_cb,
+					   compose,
+					   -1,	  /* max threads */
+					   FALSE, /* exclusive */
+					   &tmp_error);
+		if (tpool != NULL) {
+			for (guint i = 0; i < priv->results->len; i++)
+				g_thread_pool_push (tpool,
+						    g_ptr_array_index (priv->results, i),
+						    NULL);
+
+			/* wait for all verification tasks to complete */
+			g_thread_pool_free (tpool, FALSE, TRUE);
+			return;
+		}
+		g_warning ("Unable to create thread pool for result verification "
+			   "(will verify serially): %s",
+			   tmp_error->message);
+	}
+
+	for (guint i = 0; i < priv->results->len; i++)
+		asc_compose_verify_result_cb (g_ptr_array_index (priv->results, i), compose);
+}
+
+/**
+ * asc_compose_write_gstring_cb:
+ *
+ * #AsDataWriteFn appending all chunks to a #GString.
+ */
+static gboolean
+asc_compose_write_gstring_cb (const gchar *data, gsize data_len, gpointer user_data)
+{
+	g_string_append_len ((GString *) user_data, data, data_len);
+	return TRUE;
+}
+
+/**
+ * asc_compose_spill_result:
+ *
+ * Serialize the finished components of @cres as catalog-XML fragments into
+ * the on-disk spill store and drop them from memory, so a compose run does
+ * not need to hold the components of all processed units at once.
+ * The spilled fragments are streamed back into the final catalog write by
+ * asc_compose_save_metadata_spilled(). Hints and global component IDs stay
+ * attached to the result, so issue reports are unaffected.
+ */
+static void
+asc_compose_spill_result (AscCompose *compose, AscResult *cres)
+{
+	AscComposePrivate *priv = GET_PRIVATE (compose);
+	g_autoptr(AsMetadata) mdata = NULL;
+	g_autoptr(GPtrArray) cpts = NULL;
+	g_autoptr(GString) frag = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autofree gchar *spill_dir = NULL;
+	g_autofree gchar *fname = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+
+	cpts = asc_result_fetch_components (cres);
+	if (cpts->len == 0)
+		return;
+
+	/* the components are gone from this result once it is spilled, so any
+	 * requested output verification has to happen now */
+	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_VERIFY_RESULTS))
+		asc_compose_verify_result_cb (cres, compose);
+
+	mdata = asc_compose_new_metadata_writer (compose);
+	for (guint i = 0; i < cpts->len; i++)
+		as_metadata_add_component (mdata, AS_COMPONENT (g_ptr_array_index (cpts, i)));
+
+	frag = g_string_new (NULL);
+	as_metadata_xml_write_catalog_components (mdata, asc_compose_write_gstring_cb, frag);
+
+	locker = g_mutex_locker_new (&priv->mutex);
+	spill_dir = g_build_filename (asc_globals_get_tmp_dir (), "spill", NULL);
+	if (g_mkdir_with_parents (spill_dir, 0755) != 0) {
+		g_warning ("Unable to create spill directory '%s': %s - keeping the components "
+			   "of unit %s in memory.",
+			   spill_dir,
+			   strerror (errno),
+			   asc_result_get_bundle_id (cres));
+		return;
+	}
+
+	fname = g_strdup_printf ("%s" G_DIR_SEPARATOR_S "result-%05u.xml",
+				 spill_dir,
+				 priv->spill_files->len);
+	if (!g_file_set_contents (fname, frag->str, frag->len, &tmp_error)) {
+		g_warning ("Unable to spill result of unit %s to '%s': %s - keeping its "
+			   "components in memory.",
+			   asc_result_get_bundle_id (cres),
+			   fname,
+			   tmp_error->message);
+		return;
+	}
+	g_ptr_array_add (priv->spill_files, g_steal_pointer (&fname));
+	priv->spilled_cpts += cpts->len;
+	g_clear_pointer (&locker, g_mutex_locker_free);
+
+	/* drop the components, but keep their global IDs registered so media and
+	 * icon bookkeeping as well as the hint reports stay intact */
+	for (guint i = 0; i < cpts->len; i++)
+		asc_result_remove_component_full (cres,
+						  AS_COMPONENT (g_ptr_array_index (cpts, i)),
+						  FALSE);
+}
+
+typedef struct {
+	GPtrArray *tasks;    /* borrowed from asc_compose_run() */
+	const gchar *prefix; /* borrowed directory prefix, e.g. "/usr" */
+	gint stop;	     /* atomic */
+} AscPrefetchHelper;
+
+/**
+ * asc_compose_prefetch_file:
+ *
+ * Ask the kernel to asynchronously read the given file into the page
+ * cache, so a subsequent read of it will not stall on slow storage.
+ */
+static void
+asc_compose_prefetch_file (const gchar *fname)
+{
+	gint fd;
+
+	fd = g_open (fname, O_RDONLY | O_CLOEXEC, 0);
+	if (fd < 0)
+		return;
+	posix_fadvise (fd, 0, 0, POSIX_FADV_WILLNEED);
+	g_close (fd, NULL);
+}
+
+/**
+ * asc_compose_prefetch_thread:
+ *
+ * Walk the scheduled units in processing order and issue readahead requests
+ * for the files which the processing threads will most likely read, so I/O
+ * on slow (network) storage overlaps with CPU-bound work on other units.
+ */
+static gpointer
+asc_compose_prefetch_thread (gpointer user_data)
+{
+	AscPrefetchHelper *helper = user_data;
+
+	for (guint i = 0; i < helper->tasks->len; i++) {
+		AscComposeTask *ctask = g_ptr_array_index (helper->tasks, i);
+		AscDirectoryUnit *dirunit;
+		g_autofree gchar *metainfo_dir = NULL;
+		g_autofree gchar *apps_dir = NULL;
+		g_autoptr(GPtrArray) mi_files = NULL;
+		g_autoptr(GPtrArray) de_files = NULL;
+
+		if (g_atomic_int_get (&helper->stop))
+			break;
+
+		/* we can only guess the interesting files of plain directory trees
+		 * without opening the unit (which the processing thread will do) */
+		if (!ASC_IS_DIRECTORY_UNIT (ctask->unit))
+			continue;
+		dirunit = ASC_DIRECTORY_UNIT (ctask->unit);
+
+		metainfo_dir = g_build_filename (asc_directory_unit_get_root (dirunit),
+						 helper->prefix,
+						 "share",
+						 "metainfo",
+						 NULL);
+		apps_dir = g_build_filename (asc_directory_unit_get_root (dirunit),
+					     helper->prefix,
+					     "share",
+					     "applications",
+					     NULL);
+
+		/* metainfo files, both .metainfo.xml and legacy .appdata.xml */
+		mi_files = as_utils_find_files_matching (metainfo_dir, "*.xml", FALSE, NULL);
+		if (mi_files != NULL) {
+			for (guint j = 0; j < mi_files->len; j++)
+				asc_compose_prefetch_file (g_ptr_array_index (mi_files, j));
+		}
+
+		if (g_atomic_int_get (&helper->stop))
+			break;
+
+		/* desktop-entry files which may be merged into components */
+		de_files = as_utils_find_files_matching (apps_dir, "*.desktop", FALSE, NULL);
+		if (de_files != NULL) {
+			for (guint j = 0; j < de_files->len; j++)
+				asc_compose_prefetch_file (g_ptr_array_index (de_files, j));
+		}
+	}
+
+	return NULL;
+}
+
 /**
  * asc_compose_run:
  * @compose: an #AscCompose instance.
@@ -2158,9 +4320,14 @@ asc_compose_run (AscCompose *compose, GCancellable *cancellable, GError **error)
 {
 	AscComposePrivate *priv = GET_PRIVATE (compose);
 	g_autoptr(GPtrArray) tasks = NULL;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	AscPrefetchHelper prefetch_helper = { NULL, NULL, 0 };
+	GThread *prefetch_thread = NULL;
 	gboolean temp_dir_created = FALSE;
 	gboolean results_generated = FALSE;
 
+	ptask = as_profile_start_literal (priv->profile, "AscCompose:run");
+
 	/* ensure icon output dir is set, hint and data output dirs are optional */
 	if (priv->icons_result_dir == NULL &&
 	    !as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_IGNORE_ICONS)) {
@@ -2221,6 +4388,13 @@ asc_compose_run (AscCompose *compose, GCancellable *cancellable, GError **error)
 		}
 	}
 
+	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_SPILL_RESULTS) &&
+	    priv->format != AS_FORMAT_KIND_XML) {
+		g_debug ("Spilling results to disk is only supported for XML catalog output. "
+			 "Disabling result spilling.");
+		as_flags_remove (priv->flags, ASC_COMPOSE_FLAG_SPILL_RESULTS);
+	}
+
 	if (g_file_test (asc_globals_get_tmp_dir (), G_FILE_TEST_EXISTS)) {
 		g_debug ("Will use existing directory '%s' for temporary data (and will not delete "
 			 "it later).",
@@ -2238,18 +4412,63 @@ asc_compose_run (AscCompose *compose, GCancellable *cancellable, GError **error)
 		AscComposeTask *ctask;
 		AscUnit *unit = g_ptr_array_index (priv->units, i);
 		ctask = asc_compose_task_new (unit);
+		ctask->reg_index = i;
 		g_ptr_array_add (tasks, ctask);
 	}
 
-	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_USE_THREADS)) {
+	/* load the previous run's per-unit costs, if we have a statistics store */
+	asc_compose_load_unit_stats (compose);
+	if (priv->prev_unit_stats != NULL) {
+		for (guint i = 0; i < tasks->len; i++) {
+			AscComposeTask *ctask = g_ptr_array_index (tasks, i);
+			const gchar *bid = asc_unit_get_bundle_id (ctask->unit);
+			if (bid == NULL)
+				continue;
+			ctask->prev_secs = g_key_file_get_double (priv->prev_unit_stats,
+								  bid,
+								  "total-secs",
+								  NULL);
+		}
+	}
+
+	/* Schedule the most expensive units first: Workers pull the next task from
+	 * the shared queue as soon as they become idle, so starting the expensive
+	 * units early avoids a long-running unit being picked up last and stalling
+	 * the whole run at the end with all other workers idle. The measured times
+	 * of the previous run are the best cost predictor, unit sizes serve as
+	 * fallback; units with neither keep their registration order and are
+	 * processed last. */
+	g_ptr_array_sort (tasks, asc_compose_task_cmp_cost_cb);
+
+	/* start asynchronous readahead of the data the workers will most likely
+	 * read, so they stay CPU-bound even on slow storage */
+	prefetch_helper.tasks = tasks;
+	prefetch_helper.prefix = priv->prefix;
+	if (tasks->len > 0)
+		prefetch_thread = g_thread_new ("compose-prefetch",
+						asc_compose_prefetch_thread,
+						&prefetch_helper);
+
+	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_ISOLATE_UNITS)) {
+		/* run each unit in its own worker process for crash isolation */
+		guint n_workers = 1;
+		if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_USE_THREADS))
+			n_workers = MIN (g_get_num_processors (), tasks->len);
+		if (tasks->len > 0)
+			asc_compose_process_tasks_isolated (compose, tasks, n_workers);
+	} else if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_USE_THREADS)) {
 		GThreadPool *tpool = NULL;
 		tpool = g_thread_pool_new ((GFunc) asc_compose_process_task_cb,
 					   compose,
 					   -1,	  /* max threads */
 					   FALSE, /* exclusive */
 					   error);
-		if (tpool == NULL)
+		if (tpool == NULL) {
+			g_atomic_int_set (&prefetch_helper.stop, 1);
+			if (prefetch_thread != NULL)
+				g_thread_join (prefetch_thread);
 			return NULL;
+		}
 
 		/* launch all processing tasks in parallel */
 		for (guint i = 0; i < tasks->len; i++)
@@ -2265,12 +4484,29 @@ asc_compose_run (AscCompose *compose, GCancellable *cancellable, GError **error)
 			    compose);
 	}
 
+	/* all unit data was read at this point, stop any pending prefetching */
+	g_atomic_int_set (&prefetch_helper.stop, 1);
+	if (prefetch_thread != NULL)
+		g_thread_join (prefetch_thread);
+
 	/* collect results */
 	for (guint i = 0; i < tasks->len; i++) {
 		AscComposeTask *ctask = g_ptr_array_index (tasks, i);
 		g_ptr_array_add (priv->results, g_object_ref (ctask->result));
 	}
 
+	/* capture the per-unit timing data before the tasks are freed */
+	asc_compose_update_timing_report (compose, tasks);
+
+	/* record the measured unit costs for the next run */
+	asc_compose_save_unit_stats (compose, tasks);
+
+	/* verify the generated output in-memory, if requested - with result spilling
+	 * enabled, each result was already verified right before it was spilled */
+	if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_VERIFY_RESULTS) &&
+	    !as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_SPILL_RESULTS))
+		asc_compose_verify_results (compose);
+
 	/* write result */
 	if (priv->data_result_dir != NULL) {
 		if (!asc_compose_save_metadata_result (compose, &results_generated, error))
@@ -2286,9 +4522,27 @@ asc_compose_run (AscCompose *compose, GCancellable *cancellable, GError **error)
 
 	/* write hints */
 	if (priv->hints_result_dir != NULL) {
-		if (!asc_compose_export_hints_data_yaml (compose, error))
-			return NULL;
-		if (!asc_compose_export_hints_data_html (compose, error))
+		if (as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_BINARY_HINTS)) {
+			/* just dump the compact log - reports can be expanded
+			 * from it selectively later */
+			if (!asc_compose_export_hints_data_binary (compose, error))
+				return NULL;
+		} else {
+			if (!asc_compose_export_hints_data_yaml (compose, error))
+				return NULL;
+			if (!asc_compose_export_hints_data_html (compose, error))
+				return NULL;
+		}
+	}
+
+	/* pack the exported icons into a tarball, if requested */
+	if (priv->icon_tarball_fname != NULL && priv->icons_result_dir != NULL &&
+	    !as_flags_contains (priv->flags, ASC_COMPOSE_FLAG_IGNORE_ICONS)) {
+		g_autoptr(AsProfileTask) tar_ptask =
+		    as_profile_start_literal (priv->profile, "AscCompose:icon-tarball");
+		if (!asc_tarball_write_from_dir (priv->icon_tarball_fname,
+						 priv->icons_result_dir,
+						 error))
 			return NULL;
 	}
 
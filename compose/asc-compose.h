@@ -60,6 +60,13 @@ struct _AscComposeClass {
  * @ASC_COMPOSE_FLAG_PROPAGATE_ARTIFACTS:	Whether artifact data should be passed through to the generated output.
  * @ASC_COMPOSE_FLAG_NO_FINAL_CHECK:		Disable the automatic finalization check to perform it manually at a later time.
  * @ASC_COMPOSE_FLAG_NO_PARTIAL_URLS:		Do not use `media_baseurl` and always embed complete URLs in generated metadata.
+ * @ASC_COMPOSE_FLAG_ISOLATE_UNITS:		Process each unit in an isolated worker process.
+ * @ASC_COMPOSE_FLAG_VERIFY_RESULTS:		Validate the generated catalog output in-memory and register issues as hints.
+ * @ASC_COMPOSE_FLAG_NUMA_AWARE:		Pin worker threads to NUMA nodes, so unit working sets stay local to one memory controller. No-op on single-node machines and non-Linux systems.
+ * @ASC_COMPOSE_FLAG_SANDBOX_SVG:		Rasterize SVG icons in disposable helper processes, so crashes in the SVG renderer can not take down a compose worker.
+ * @ASC_COMPOSE_FLAG_BINARY_HINTS:		Write issue hints as a compact binary log instead of YAML/HTML reports, to be expanded with asc_compose_hints_binary_log_to_yaml() later.
+ * @ASC_COMPOSE_FLAG_SPILL_RESULTS:		Serialize finished unit results to temporary on-disk storage immediately and stream them into the final catalog write, so composing does not need to hold all components in memory at once. Results returned by asc_compose_run() then only carry hints, no components. Only effective for XML output.
+ * @ASC_COMPOSE_FLAG_EMIT_SEARCH_TOKENS:	Emit a prebuilt, stemmed search token index per component into XML catalog output, so clients with a compatible locale can search without tokenizing the data again.
  *
  * Flags that affect the compose process.
  **/
@@ -78,6 +85,13 @@ typedef enum {
 	ASC_COMPOSE_FLAG_PROPAGATE_ARTIFACTS	  = 1 << 10,
 	ASC_COMPOSE_FLAG_NO_FINAL_CHECK		  = 1 << 11,
 	ASC_COMPOSE_FLAG_NO_PARTIAL_URLS	  = 1 << 12,
+	ASC_COMPOSE_FLAG_ISOLATE_UNITS		  = 1 << 13,
+	ASC_COMPOSE_FLAG_VERIFY_RESULTS		  = 1 << 14,
+	ASC_COMPOSE_FLAG_NUMA_AWARE		  = 1 << 15,
+	ASC_COMPOSE_FLAG_SANDBOX_SVG		  = 1 << 16,
+	ASC_COMPOSE_FLAG_BINARY_HINTS		  = 1 << 17,
+	ASC_COMPOSE_FLAG_SPILL_RESULTS		  = 1 << 18,
+	ASC_COMPOSE_FLAG_EMIT_SEARCH_TOKENS	  = 1 << 19,
 } AscComposeFlags;
 
 /**
@@ -154,18 +168,30 @@ void		asc_compose_set_data_result_dir (AscCompose *compose, const gchar *dir);
 const gchar    *asc_compose_get_icons_result_dir (AscCompose *compose);
 void		asc_compose_set_icons_result_dir (AscCompose *compose, const gchar *dir);
 
+const gchar    *asc_compose_get_icon_tarball_file (AscCompose *compose);
+void		asc_compose_set_icon_tarball_file (AscCompose *compose, const gchar *fname);
+
 const gchar    *asc_compose_get_media_result_dir (AscCompose *compose);
 void		asc_compose_set_media_result_dir (AscCompose *compose, const gchar *dir);
 
 const gchar    *asc_compose_get_hints_result_dir (AscCompose *compose);
 void		asc_compose_set_hints_result_dir (AscCompose *compose, const gchar *dir);
 
+const gchar    *asc_compose_get_checkpoint_dir (AscCompose *compose);
+void		asc_compose_set_checkpoint_dir (AscCompose *compose, const gchar *dir);
+
 void		asc_compose_remove_custom_allowed (AscCompose *compose, const gchar *key_id);
 void		asc_compose_add_custom_allowed (AscCompose *compose, const gchar *key_id);
 
 gssize		asc_compose_get_max_screenshot_size (AscCompose *compose);
 void		asc_compose_set_max_screenshot_size (AscCompose *compose, gssize size_bytes);
 
+guint64		asc_compose_get_max_memory_usage (AscCompose *compose);
+void		asc_compose_set_max_memory_usage (AscCompose *compose, guint64 usage_bytes);
+
+guint		asc_compose_get_stage_time_budget (AscCompose *compose);
+void		asc_compose_set_stage_time_budget (AscCompose *compose, guint seconds);
+
 void		asc_compose_set_check_metadata_early_func (AscCompose		  *compose,
 							   AscCheckMetadataEarlyFn func,
 							   gpointer		   user_data);
@@ -182,7 +208,14 @@ gboolean	asc_compose_has_errors (AscCompose *compose);
 
 GPtrArray      *asc_compose_run (AscCompose *compose, GCancellable *cancellable, GError **error);
 
+const gchar    *asc_compose_get_timing_report (AscCompose *compose);
+
+const gchar    *asc_compose_get_stats_cache_file (AscCompose *compose);
+void		asc_compose_set_stats_cache_file (AscCompose *compose, const gchar *fname);
+
 void		asc_compose_finalize_results (AscCompose *compose);
 void		asc_compose_finalize_result (AscCompose *compose, AscResult *result);
 
+gchar	       *asc_compose_hints_binary_log_to_yaml (const gchar *fname, GError **error);
+
 G_END_DECLS
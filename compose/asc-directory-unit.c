@@ -27,11 +27,16 @@
 #include "config.h"
 #include "asc-directory-unit.h"
 
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+
 #include "as-utils-private.h"
 
 typedef struct {
 	gchar *root_dir;
 	GHashTable *files_map;
+	GStringChunk *contents_arena; /* backing storage for the contents index */
 } AscDirectoryUnitPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (AscDirectoryUnit, asc_directory_unit, ASC_TYPE_UNIT)
@@ -59,6 +64,8 @@ asc_directory_unit_finalize (GObject *object)
 
 	g_free (priv->root_dir);
 	g_hash_table_unref (priv->files_map);
+	if (priv->contents_arena != NULL)
+		g_string_chunk_free (priv->contents_arena);
 
 	G_OBJECT_CLASS (asc_directory_unit_parent_class)->finalize (object);
 }
@@ -80,35 +87,93 @@ asc_directory_unit_class_init (AscDirectoryUnitClass *klass)
 	unit_class->read_data = asc_directory_unit_read_data;
 }
 
+/**
+ * asc_directory_unit_scan_recursive:
+ *
+ * Enumerate a directory tree with raw readdir(), deciding from the dirent
+ * type whether to recurse and only falling back to (l)stat() for symlinks
+ * and filesystems that do not fill in d_type. The full path is kept in one
+ * reusable buffer and the relative paths of all found files are stored in
+ * a string chunk, so enumerating even very large units does not allocate
+ * per entry. This makes opening huge directory units dramatically cheaper
+ * than the previous per-entry GLib path construction and file tests.
+ */
 static gboolean
-asc_directory_unit_find_files_recursive_internal (GPtrArray *files,
-						  const gchar *path_orig,
-						  guint path_orig_len,
-						  const gchar *path,
-						  GHashTable *visited_dirs,
-						  GError **error)
+asc_directory_unit_scan_recursive (GPtrArray *files,
+				   GStringChunk *arena,
+				   GString *path_buf,
+				   guint path_orig_len,
+				   GHashTable *visited_dirs,
+				   GError **error)
 {
-	const gchar *tmp;
-	g_autoptr(GDir) dir = NULL;
-	g_autoptr(GError) tmp_error = NULL;
+	DIR *dir;
+	struct dirent *de;
+	gsize dir_path_len;
 
-	dir = g_dir_open (path, 0, &tmp_error);
+	dir = opendir (path_buf->str);
 	if (dir == NULL) {
 		/* just ignore locations we do not have access to */
-		if (g_error_matches (tmp_error, G_FILE_ERROR, G_FILE_ERROR_ACCES))
+		if (errno == EACCES)
 			return TRUE;
-		g_propagate_error (error, g_steal_pointer (&tmp_error));
+		g_set_error (error,
+			     G_FILE_ERROR,
+			     g_file_error_from_errno (errno),
+			     "Unable to enumerate directory '%s': %s",
+			     path_buf->str,
+			     g_strerror (errno));
 		return FALSE;
 	}
 
-	while ((tmp = g_dir_read_name (dir)) != NULL) {
-		g_autofree gchar *path_new = NULL;
-		path_new = g_build_filename (path, tmp, NULL);
+	dir_path_len = path_buf->len;
+	while ((de = readdir (dir)) != NULL) {
+		gboolean is_dir = FALSE;
+		gboolean is_link = FALSE;
+
+		if (de->d_name[0] == '.' &&
+		    (de->d_name[1] == '\0' || (de->d_name[1] == '.' && de->d_name[2] == '\0')))
+			continue;
+
+		/* extend the shared path buffer to point at the current entry */
+		g_string_truncate (path_buf, dir_path_len);
+		if (dir_path_len == 0 || path_buf->str[dir_path_len - 1] != G_DIR_SEPARATOR)
+			g_string_append_c (path_buf, G_DIR_SEPARATOR);
+		g_string_append (path_buf, de->d_name);
+
+		switch (de->d_type) {
+		case DT_DIR:
+			is_dir = TRUE;
+			break;
+		case DT_LNK:
+			is_link = TRUE;
+			break;
+		case DT_UNKNOWN: {
+			/* not all filesystems fill in d_type */
+			struct stat sbuf;
+			if (lstat (path_buf->str, &sbuf) != 0)
+				continue;
+			if (S_ISLNK (sbuf.st_mode))
+				is_link = TRUE;
+			else if (S_ISDIR (sbuf.st_mode))
+				is_dir = TRUE;
+			break;
+		}
+		default:
+			break;
+		}
+
+		if (is_link) {
+			/* only symlinks pointing at directories need the extra stat() */
+			struct stat sbuf;
+			if (stat (path_buf->str, &sbuf) == 0 && S_ISDIR (sbuf.st_mode))
+				is_dir = TRUE;
+			else
+				is_link = FALSE;
+		}
 
 		/* search recursively */
-		if (g_file_test (path_new, G_FILE_TEST_IS_DIR)) {
-			if (g_file_test (path_new, G_FILE_TEST_IS_SYMLINK)) {
-				g_autofree gchar *real_path = realpath (path_new, NULL);
+		if (is_dir) {
+			if (is_link) {
+				g_autofree gchar *real_path = realpath (path_buf->str, NULL);
 
 				if (!real_path) {
 					/* error if realpath fails (like memory allocation error or invalid path) */
@@ -116,52 +181,61 @@ asc_directory_unit_find_files_recursive_internal (GPtrArray *files,
 						     G_FILE_ERROR,
 						     g_file_error_from_errno (errno),
 						     "Failed to resolve real path");
+					closedir (dir);
 					return FALSE;
 				}
 
 				/* don't visit paths twice to avoid loops */
 				if (g_hash_table_contains (visited_dirs, real_path))
-					return TRUE;
+					continue;
 
 				g_hash_table_add (visited_dirs, g_steal_pointer (&real_path));
 			} else {
-				if (g_hash_table_contains (visited_dirs, path_new))
-					return TRUE;
+				if (g_hash_table_contains (visited_dirs, path_buf->str))
+					continue;
 
-				g_hash_table_add (visited_dirs, g_strdup (path_new));
+				g_hash_table_add (visited_dirs, g_strdup (path_buf->str));
 			}
 
-			if (!asc_directory_unit_find_files_recursive_internal (files,
-									       path_orig,
-									       path_orig_len,
-									       path_new,
-									       visited_dirs,
-									       error))
+			if (!asc_directory_unit_scan_recursive (files,
+								arena,
+								path_buf,
+								path_orig_len,
+								visited_dirs,
+								error)) {
+				closedir (dir);
 				return FALSE;
+			}
 		} else {
-			g_ptr_array_add (files, g_strdup (path_new + path_orig_len));
+			g_ptr_array_add (
+			    files,
+			    g_string_chunk_insert (arena, path_buf->str + path_orig_len));
 		}
 	}
+	closedir (dir);
 
 	return TRUE;
 }
 
 static gboolean
 asc_directory_unit_find_files_recursive (GPtrArray *files,
+					 GStringChunk *arena,
 					 const gchar *path_orig,
 					 guint path_orig_len,
 					 const gchar *path,
 					 GError **error)
 {
 	g_autoptr(GHashTable) visited_dirs = NULL;
+	g_autoptr(GString) path_buf = g_string_new (path);
+
 	visited_dirs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 
-	return asc_directory_unit_find_files_recursive_internal (files,
-								 path_orig,
-								 path_orig_len,
-								 path,
-								 visited_dirs,
-								 error);
+	return asc_directory_unit_scan_recursive (files,
+						  arena,
+						  path_buf,
+						  path_orig_len,
+						  visited_dirs,
+						  error);
 }
 
 static gboolean
@@ -175,14 +249,19 @@ asc_directory_unit_open (AscUnit *unit, GError **error)
 	if (g_str_has_suffix (priv->root_dir, G_DIR_SEPARATOR_S))
 		root_dir_len = root_dir_len > 0 ? root_dir_len - 1 : root_dir_len;
 
-	contents = g_ptr_array_new_with_free_func (g_free);
+	/* the filename strings live in an arena owned by this unit, so the index
+	 * is built without one heap allocation per found file */
+	if (priv->contents_arena != NULL)
+		g_string_chunk_free (priv->contents_arena);
+	priv->contents_arena = g_string_chunk_new (64 * 1024);
+	contents = g_ptr_array_new ();
 	relevant_paths = asc_unit_get_relevant_paths (unit);
 
 	g_debug ("Creating contents index for directory: %s", priv->root_dir);
 	if (relevant_paths->len == 0) {
-		/* create an index of all the data
-		 * TODO: All of this is super wasteful, and may need a completely different approach */
+		/* create an index of all the data */
 		if (!asc_directory_unit_find_files_recursive (contents,
+							      priv->contents_arena,
 							      priv->root_dir,
 							      root_dir_len,
 							      priv->root_dir,
@@ -196,6 +275,7 @@ asc_directory_unit_open (AscUnit *unit, GError **error)
 			check_path = g_build_filename (priv->root_dir, rel_path, NULL);
 
 			if (!asc_directory_unit_find_files_recursive (contents,
+								      priv->contents_arena,
 								      priv->root_dir,
 								      root_dir_len,
 								      check_path,
@@ -206,6 +286,10 @@ asc_directory_unit_open (AscUnit *unit, GError **error)
 	g_debug ("Index done for directory: %s", priv->root_dir);
 
 	asc_unit_set_contents (unit, contents);
+
+	/* use our file count as scheduling hint for subsequent compose runs */
+	asc_unit_set_size_hint (unit, contents->len);
+
 	return TRUE;
 }
 
@@ -65,6 +65,8 @@ typedef struct {
 	gchar *homepage;
 
 	gchar *file_basename;
+	gchar *source_fname;
+	gboolean fontconfig_loaded;
 } AscFontPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (AscFont, asc_font, G_TYPE_OBJECT)
@@ -111,6 +113,7 @@ asc_font_finalize (GObject *object)
 	g_free (priv->homepage);
 
 	g_free (priv->file_basename);
+	g_free (priv->source_fname);
 
 	G_OBJECT_CLASS (asc_font_parent_class)->finalize (object);
 }
@@ -197,8 +200,8 @@ asc_font_load_fontconfig_data_from_file (AscFont *font, const gchar *fname)
 
 	fpattern = FcFreeTypeQuery ((const guchar *) fname, 0, NULL, &c);
 
-	/* load information about the font */
-	g_hash_table_remove_all (priv->languages);
+	/* load information about the font, merging with any languages
+	 * that were added explicitly before we were called */
 	match = TRUE;
 	for (guint i = 0; match == TRUE; i++) {
 		FcLangSet *ls;
@@ -234,24 +237,48 @@ asc_font_load_fontconfig_data_from_file (AscFont *font, const gchar *fname)
 	}
 
 	/* assume 'en' is available */
-	if (!any_lang_added)
+	if (!any_lang_added && g_hash_table_size (priv->languages) == 0)
 		g_hash_table_add (priv->languages, g_strdup ("en"));
 
 	/* prefer the English language if possible
 	 * this is a hack since some people don't set their
 	 * <languages> tag properly. */
-	if (any_lang_added && g_hash_table_contains (priv->languages, "en")) {
+	if (any_lang_added && as_is_empty (priv->preferred_lang) &&
+	    g_hash_table_contains (priv->languages, "en")) {
 		g_free (priv->preferred_lang);
 		priv->preferred_lang = g_strdup ("en");
 	}
 
-	/* read font metadata, if any is there */
-	asc_font_read_sfnt_data (font);
-
 	/* cleanup */
 	FcPatternDestroy (fpattern);
 }
 
+/**
+ * asc_font_ensure_fontconfig_data:
+ *
+ * Run the (expensive) Fontconfig query for this font if we have not
+ * done so already. The language set, full name and style are only
+ * needed when a specimen is actually rendered, so we defer obtaining
+ * them until a getter asks for the data. This keeps a metadata-only
+ * probe of the font (family, name-table data) cheap.
+ */
+static void
+asc_font_ensure_fontconfig_data (AscFont *font)
+{
+	AscFontPrivate *priv = GET_PRIVATE (font);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	if (priv->fontconfig_loaded || priv->source_fname == NULL)
+		return;
+
+	locker = g_mutex_locker_new (&fontconfig_mutex);
+	if (priv->fontconfig_loaded)
+		return;
+
+	asc_font_load_fontconfig_data_from_file (font, priv->source_fname);
+	priv->fontconfig_loaded = TRUE;
+}
+
 static AscFont *
 asc_font_new (GError **error)
 {
@@ -280,6 +307,9 @@ asc_font_new (GError **error)
  * @error: A #GError or %NULL
  *
  * Creates a new #AscFont from a file on the filesystem.
+ *
+ * Only the font face and its name tables are read immediately,
+ * the Fontconfig language scan is performed lazily on first use.
  **/
 AscFont *
 asc_font_new_from_file (const gchar *fname, GError **error)
@@ -303,7 +333,13 @@ asc_font_new_from_file (const gchar *fname, GError **error)
 		return NULL;
 	}
 
-	asc_font_load_fontconfig_data_from_file (font, fname);
+	/* read font metadata from the name tables, if any is there */
+	asc_font_read_sfnt_data (font);
+
+	/* remember the filename, so the deferred Fontconfig query can use it */
+	g_free (priv->source_fname);
+	priv->source_fname = g_strdup (fname);
+
 	g_free (priv->file_basename);
 	priv->file_basename = g_path_get_basename (fname);
 
@@ -370,6 +406,7 @@ const gchar *
 asc_font_get_style (AscFont *font)
 {
 	AscFontPrivate *priv = GET_PRIVATE (font);
+	asc_font_ensure_fontconfig_data (font);
 	return priv->style;
 }
 
@@ -383,6 +420,7 @@ const gchar *
 asc_font_get_fullname (AscFont *font)
 {
 	AscFontPrivate *priv = GET_PRIVATE (font);
+	asc_font_ensure_fontconfig_data (font);
 	if (as_is_empty (priv->fullname)) {
 		g_free (priv->fullname);
 		priv->fullname = g_strdup_printf ("%s %s",
@@ -469,7 +507,9 @@ GList *
 asc_font_get_language_list (AscFont *font)
 {
 	AscFontPrivate *priv = GET_PRIVATE (font);
-	GList *list = g_hash_table_get_keys (priv->languages);
+	GList *list;
+	asc_font_ensure_fontconfig_data (font);
+	list = g_hash_table_get_keys (priv->languages);
 	list = g_list_sort (list, (GCompareFunc) g_strcmp0);
 	return list;
 }
@@ -497,6 +537,7 @@ const gchar *
 asc_font_get_preferred_language (AscFont *font)
 {
 	AscFontPrivate *priv = GET_PRIVATE (font);
+	asc_font_ensure_fontconfig_data (font);
 	return priv->preferred_lang;
 }
 
@@ -685,6 +726,9 @@ asc_font_determine_sample_texts (AscFont *font)
 			return;
 	}
 
+	/* picking sample texts needs the full language set */
+	asc_font_ensure_fontconfig_data (font);
+
 	/* always prefer English (even if not alphabetically first) */
 	if (g_hash_table_contains (priv->languages, "en")) {
 		g_free (priv->preferred_lang);
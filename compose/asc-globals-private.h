@@ -29,5 +29,7 @@ G_BEGIN_DECLS
 GPtrArray	      *asc_globals_get_pangrams_for (const gchar *lang);
 AscHintTag	      *asc_globals_get_hint_tag_details (const gchar *tag);
 
+gboolean	       asc_globals_get_optipng_explicit (void);
+
 #pragma GCC visibility pop
 G_END_DECLS
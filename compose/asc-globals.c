@@ -27,8 +27,11 @@
 #include "config.h"
 #include "asc-globals-private.h"
 
+#include <fontconfig/fontconfig.h>
+
 #include "as-utils-private.h"
 #include "as-validator-issue-tag.h"
+#include "asc-font-private.h"
 #include "asc-resources.h"
 
 #define ASC_TYPE_GLOBALS (asc_globals_get_type ())
@@ -40,9 +43,11 @@ struct _AscGlobalsClass {
 
 typedef struct {
 	gboolean use_optipng;
+	gboolean optipng_explicit;
 	gchar *optipng_bin;
 	gchar *ffprobe_bin;
 	gchar *tmp_dir;
+	gchar *fontconfig_cache_dir;
 
 	GMutex pangrams_mutex;
 	GPtrArray *pangrams_en;
@@ -111,6 +116,7 @@ asc_globals_finalize (GObject *object)
 	g_free (priv->tmp_dir);
 	g_free (priv->optipng_bin);
 	g_free (priv->ffprobe_bin);
+	g_free (priv->fontconfig_cache_dir);
 
 	g_mutex_clear (&priv->pangrams_mutex);
 	if (priv->pangrams_en != NULL)
@@ -136,9 +142,11 @@ asc_globals_init (AscGlobals *globals)
 	tmp_str2 = g_strconcat ("as-compose_", tmp_str1, NULL);
 	priv->tmp_dir = g_build_filename (g_get_tmp_dir (), tmp_str2, NULL);
 
+	/* PNG optimization runs in-process by default and needs no external
+	 * binary anymore; the optipng discovery only serves users who still
+	 * want to explicitly select the external tool */
 	priv->optipng_bin = g_find_program_in_path ("optipng");
-	if (priv->optipng_bin != NULL)
-		priv->use_optipng = TRUE;
+	priv->use_optipng = TRUE;
 
 	priv->ffprobe_bin = g_find_program_in_path ("ffprobe");
 
@@ -215,10 +223,87 @@ asc_globals_set_tmp_dir (const gchar *path)
 	priv->tmp_dir = g_strdup (path);
 }
 
+/**
+ * asc_globals_get_fontconfig_cache_dir:
+ *
+ * Get the prebuilt fontconfig cache directory, or %NULL if none is set.
+ **/
+const gchar *
+asc_globals_get_fontconfig_cache_dir (void)
+{
+	AscGlobalsPrivate *priv = asc_globals_get_priv ();
+	return priv->fontconfig_cache_dir;
+}
+
+/**
+ * asc_globals_set_fontconfig_cache_dir:
+ * @path: the location of a prebuilt fontconfig cache directory.
+ * @error: A #GError or %NULL
+ *
+ * Use a prebuilt, relocatable fontconfig cache bundle for any font rendering
+ * performed by appstream-compose. The caches in @path are only ever read,
+ * never modified, so the bundle can be shared between many (ephemeral)
+ * compose instances to avoid the expensive font cache rebuild that
+ * fontconfig would otherwise perform on its first use in each of them.
+ *
+ * Returns: %TRUE on success.
+ **/
+gboolean
+asc_globals_set_fontconfig_cache_dir (const gchar *path, GError **error)
+{
+	AscGlobalsPrivate *priv = asc_globals_get_priv ();
+	g_autofree gchar *config_xml = NULL;
+	FcConfig *fconfig;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&fontconfig_mutex);
+
+	if (!g_file_test (path, G_FILE_TEST_IS_DIR)) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "Fontconfig cache directory '%s' does not exist.",
+			     path);
+		return FALSE;
+	}
+
+	/* load the default configuration files, without scanning or building any caches yet */
+	fconfig = FcInitLoadConfig ();
+	if (fconfig == NULL) {
+		g_set_error_literal (error,
+				     ASC_COMPOSE_ERROR,
+				     ASC_COMPOSE_ERROR_FAILED,
+				     "Unable to load the fontconfig configuration.");
+		return FALSE;
+	}
+
+	/* register the bundle as an additional cache location - fontconfig will read it
+	 * like any other cache directory, but never writes to locations it has no write
+	 * access to, so a root-owned or read-only-mounted bundle stays untouched */
+	config_xml = g_markup_printf_escaped ("<?xml version=\"1.0\"?>\n"
+					      "<!DOCTYPE fontconfig SYSTEM \"fonts.dtd\">\n"
+					      "<fontconfig><cachedir>%s</cachedir></fontconfig>\n",
+					      path);
+	if (!FcConfigParseAndLoadFromMemory (fconfig, (const FcChar8 *) config_xml, FcFalse)) {
+		FcConfigDestroy (fconfig);
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "Unable to register fontconfig cache directory '%s'.",
+			     path);
+		return FALSE;
+	}
+
+	FcConfigSetCurrent (fconfig);
+	FcConfigDestroy (fconfig);
+
+	g_free (priv->fontconfig_cache_dir);
+	priv->fontconfig_cache_dir = g_strdup (path);
+	return TRUE;
+}
+
 /**
  * asc_globals_get_use_optipng:
  *
- * Get whether images should be optimized using optipng.
+ * Get whether PNG images should be size-optimized.
  **/
 gboolean
 asc_globals_get_use_optipng (void)
@@ -230,20 +315,30 @@ asc_globals_get_use_optipng (void)
 /**
  * asc_globals_set_use_optipng:
  *
- * Set whether images should be optimized using optipng.
+ * Set whether PNG images should be size-optimized.
+ * By default the optimization happens in-process; an external optipng
+ * binary is only used if one was set via asc_globals_set_optipng_binary().
  **/
 void
 asc_globals_set_use_optipng (gboolean enabled)
 {
 	AscGlobalsPrivate *priv = asc_globals_get_priv ();
-	if (enabled && priv->optipng_bin == NULL) {
-		g_critical ("Refusing to enable optipng: not found in $PATH");
-		priv->use_optipng = FALSE;
-		return;
-	}
 	priv->use_optipng = enabled;
 }
 
+/**
+ * asc_globals_get_optipng_explicit:
+ *
+ * Check whether an optipng binary was explicitly selected by the user,
+ * overriding the default in-process PNG optimization.
+ **/
+gboolean
+asc_globals_get_optipng_explicit (void)
+{
+	AscGlobalsPrivate *priv = asc_globals_get_priv ();
+	return priv->optipng_explicit && priv->optipng_bin != NULL;
+}
+
 /**
  * asc_globals_get_optipng_binary:
  *
@@ -267,8 +362,8 @@ asc_globals_set_optipng_binary (const gchar *path)
 	AscGlobalsPrivate *priv = asc_globals_get_priv ();
 	g_free (priv->optipng_bin);
 	priv->optipng_bin = g_strdup (path);
-	if (priv->optipng_bin == NULL)
-		priv->use_optipng = FALSE;
+	/* passing %NULL reverts to the default in-process optimization */
+	priv->optipng_explicit = priv->optipng_bin != NULL;
 }
 
 /**
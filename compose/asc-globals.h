@@ -49,6 +49,9 @@ const gchar    *asc_globals_get_tmp_dir (void);
 const gchar    *asc_globals_get_tmp_dir_create (void);
 void		asc_globals_set_tmp_dir (const gchar *path);
 
+const gchar    *asc_globals_get_fontconfig_cache_dir (void);
+gboolean	asc_globals_set_fontconfig_cache_dir (const gchar *path, GError **error);
+
 gboolean	asc_globals_get_use_optipng (void);
 void		asc_globals_set_use_optipng (gboolean enabled);
 
@@ -56,6 +56,18 @@ AscHintTagStatic asc_hint_tag_list[] =  {
 	  "Error while reading data from unit <code>{{name}}</code>: {{msg}}",
 	},
 
+	{ "unit-process-failed",
+	  AS_ISSUE_SEVERITY_ERROR,
+	  "The worker process for unit <code>{{name}}</code> failed: {{msg}}",
+	},
+
+	{ "unit-stage-too-slow",
+	  AS_ISSUE_SEVERITY_INFO,
+	  "The <em>{{stage}}</em> stage of processing unit <code>{{name}}</code> took {{duration}}s, "
+	  "exceeding its time budget of {{budget}}s. The unit likely contains pathological data, "
+	  "e.g. an excessively complex vector graphic."
+	},
+
 	{ "ancient-metadata",
 	  AS_ISSUE_SEVERITY_WARNING,
 	  "The AppStream metadata should be updated to follow a more recent version of the specification.<br/>"
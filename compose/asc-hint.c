@@ -31,8 +31,8 @@
 #include "asc-globals-private.h"
 
 typedef struct {
-	GPtrArray *vars;
-	gchar *tag;
+	GPtrArray *vars; /* interned key/value pairs, created on first use */
+	GRefString *tag;
 	AsIssueSeverity severity;
 	GRefString *explanation_tmpl;
 } AscHintPrivate;
@@ -42,10 +42,26 @@ G_DEFINE_TYPE_WITH_PRIVATE (AscHint, asc_hint, G_TYPE_OBJECT)
 
 static void
 asc_hint_init (AscHint *hint)
+{
+	/* most hints have no or very few explanation variables, so we
+	 * allocate the variable list lazily on first use */
+}
+
+/**
+ * asc_hint_ensure_vars:
+ *
+ * Get the explanation variable list for the given hint,
+ * creating it if it did not exist yet.
+ */
+static GPtrArray *
+asc_hint_ensure_vars (AscHint *hint)
 {
 	AscHintPrivate *priv = GET_PRIVATE (hint);
 
-	priv->vars = g_ptr_array_new_with_free_func (g_free);
+	if (priv->vars == NULL)
+		priv->vars = g_ptr_array_new_with_free_func (
+		    (GDestroyNotify) as_ref_string_release);
+	return priv->vars;
 }
 
 static void
@@ -54,7 +70,7 @@ asc_hint_finalize (GObject *object)
 	AscHint *hint = ASC_HINT (object);
 	AscHintPrivate *priv = GET_PRIVATE (hint);
 
-	g_free (priv->tag);
+	as_ref_string_release (priv->tag);
 	as_ref_string_release (priv->explanation_tmpl);
 	priv->severity = AS_ISSUE_SEVERITY_UNKNOWN;
 	if (priv->vars != NULL)
@@ -93,8 +109,7 @@ void
 asc_hint_set_tag (AscHint *hint, const gchar *tag)
 {
 	AscHintPrivate *priv = GET_PRIVATE (hint);
-	g_free (priv->tag);
-	priv->tag = g_strdup (tag);
+	as_ref_string_assign_safe (&priv->tag, tag);
 }
 
 /**
@@ -185,25 +200,29 @@ asc_hint_is_valid (AscHint *hint)
  * @text: Replacement for the variable name.
  *
  * Add a replacement variable for the explanation text.
+ *
+ * Both the variable name and its value are interned, so hint-heavy
+ * compose runs emitting the same key/value pairs over and over
+ * share a single allocation for each distinct string.
  **/
 void
 asc_hint_add_explanation_var (AscHint *hint, const gchar *var_name, const gchar *text)
 {
-	AscHintPrivate *priv = GET_PRIVATE (hint);
-	g_assert_cmpint (priv->vars->len % 2, ==, 0);
+	GPtrArray *vars = asc_hint_ensure_vars (hint);
+	g_assert_cmpint (vars->len % 2, ==, 0);
 
 	/* check if we can replace an existing value */
-	for (guint i = 0; i < priv->vars->len; i += 2) {
-		if (g_strcmp0 (g_ptr_array_index (priv->vars, i), var_name) == 0) {
-			g_free (g_ptr_array_index (priv->vars, i + 1));
-			g_ptr_array_index (priv->vars, i + 1) = g_strdup (text);
+	for (guint i = 0; i < vars->len; i += 2) {
+		if (g_strcmp0 (g_ptr_array_index (vars, i), var_name) == 0) {
+			as_ref_string_release (g_ptr_array_index (vars, i + 1));
+			g_ptr_array_index (vars, i + 1) = g_ref_string_new_intern (text);
 			return;
 		}
 	}
 
 	/* add new key-value pair */
-	g_ptr_array_add (priv->vars, g_strdup (var_name));
-	g_ptr_array_add (priv->vars, g_strdup (text));
+	g_ptr_array_add (vars, g_ref_string_new_intern (var_name));
+	g_ptr_array_add (vars, g_ref_string_new_intern (text));
 }
 
 /**
@@ -218,9 +237,9 @@ asc_hint_add_explanation_var (AscHint *hint, const gchar *var_name, const gchar
 GPtrArray *
 asc_hint_get_explanation_vars_list (AscHint *hint)
 {
-	AscHintPrivate *priv = GET_PRIVATE (hint);
-	g_assert_cmpint (priv->vars->len % 2, ==, 0);
-	return priv->vars;
+	GPtrArray *vars = asc_hint_ensure_vars (hint);
+	g_assert_cmpint (vars->len % 2, ==, 0);
+	return vars;
 }
 
 /**
@@ -236,9 +255,11 @@ gchar *
 asc_hint_format_explanation (AscHint *hint)
 {
 	AscHintPrivate *priv = GET_PRIVATE (hint);
+	GPtrArray *vars;
 	g_auto(GStrv) parts = NULL;
 
-	g_assert_cmpint (priv->vars->len % 2, ==, 0);
+	vars = asc_hint_ensure_vars (hint);
+	g_assert_cmpint (vars->len % 2, ==, 0);
 	if (priv->explanation_tmpl == NULL)
 		return NULL;
 
@@ -246,8 +267,8 @@ asc_hint_format_explanation (AscHint *hint)
 	for (guint i = 0; parts[i] != NULL; i++) {
 		gboolean replaced = FALSE;
 
-		for (guint j = 0; j < priv->vars->len; j += 2) {
-			g_autofree gchar *tmp = g_strconcat (g_ptr_array_index (priv->vars, j),
+		for (guint j = 0; j < vars->len; j += 2) {
+			g_autofree gchar *tmp = g_strconcat (g_ptr_array_index (vars, j),
 							     "}}",
 							     NULL);
 			g_autofree gchar *tmp2 = NULL;
@@ -257,9 +278,7 @@ asc_hint_format_explanation (AscHint *hint)
 			/* replace string */
 			tmp2 = parts[i];
 			parts[i] = parts[i] + strlen (tmp);
-			parts[i] = g_strconcat (g_ptr_array_index (priv->vars, j + 1),
-						parts[i],
-						NULL);
+			parts[i] = g_strconcat (g_ptr_array_index (vars, j + 1), parts[i], NULL);
 			replaced = TRUE;
 			break;
 		}
@@ -30,8 +30,16 @@
 
 #include <gio/gio.h>
 #include <math.h>
+#include <fcntl.h>
+#ifdef G_OS_UNIX
+#include <unistd.h>
+#include <errno.h>
+#include <sys/wait.h>
+#endif
+
+#include <glib/gstdio.h>
 
-#include "asc-globals.h"
+#include "asc-globals-private.h"
 
 struct _AscImage {
 	GObject parent_instance;
@@ -46,6 +54,64 @@ typedef struct {
 G_DEFINE_TYPE_WITH_PRIVATE (AscImage, asc_image, G_TYPE_OBJECT)
 #define GET_PRIVATE(o) (asc_image_get_instance_private (o))
 
+/* process-wide cache of decoded pixbufs, keyed by source content hash */
+static GMutex asc_image_dcache_mutex;
+static GHashTable *asc_image_dcache = NULL; /* utf8 -> GdkPixbuf */
+
+/**
+ * asc_image_dcache_build_key:
+ *
+ * Build a decode-cache key from the source data and all parameters
+ * that influence the decoded result.
+ */
+static gchar *
+asc_image_dcache_build_key (const void *data,
+			    gssize len,
+			    guint dest_size,
+			    gboolean compressed,
+			    AscImageLoadFlags flags)
+{
+	g_autofree gchar *content_hash = NULL;
+
+	content_hash = g_compute_checksum_for_data (G_CHECKSUM_SHA1, data, len);
+	return g_strdup_printf ("%s-%u-%d-%u", content_hash, dest_size, compressed, flags);
+}
+
+/**
+ * asc_image_dcache_lookup:
+ *
+ * Returns: (transfer full) (nullable): a cached pixbuf for the given key.
+ */
+static GdkPixbuf *
+asc_image_dcache_lookup (const gchar *key)
+{
+	GdkPixbuf *pix;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&asc_image_dcache_mutex);
+
+	if (asc_image_dcache == NULL)
+		return NULL;
+	pix = g_hash_table_lookup (asc_image_dcache, key);
+	if (pix == NULL)
+		return NULL;
+	return g_object_ref (pix);
+}
+
+/**
+ * asc_image_dcache_insert:
+ */
+static void
+asc_image_dcache_insert (const gchar *key, GdkPixbuf *pix)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&asc_image_dcache_mutex);
+
+	if (asc_image_dcache == NULL)
+		asc_image_dcache = g_hash_table_new_full (g_str_hash,
+							  g_str_equal,
+							  g_free,
+							  g_object_unref);
+	g_hash_table_insert (asc_image_dcache, g_strdup (key), g_object_ref (pix));
+}
+
 /**
  * asc_image_error_quark:
  *
@@ -189,13 +255,71 @@ asc_image_new (void)
 	return ASC_IMAGE (image);
 }
 
+/**
+ * asc_png_optimize_inprocess:
+ *
+ * Shrink a PNG file that we have just written ourselves, by re-encoding
+ * it at the highest zlib compression level, which also drops any
+ * ancillary chunks. The smaller result only replaces the original file
+ * if the re-encoding actually was an improvement.
+ *
+ * This is only lossless for the 8-bit images our own encoders emit,
+ * which is fine since we exclusively run it on their output.
+ */
+static gboolean
+asc_png_optimize_inprocess (const gchar *fname, GError **error)
+{
+	g_autoptr(GdkPixbuf) pixbuf = NULL;
+	g_autofree gchar *opt_data = NULL;
+	gsize opt_len = 0;
+	GStatBuf sbuf;
+	GError *tmp_error = NULL;
+
+	pixbuf = gdk_pixbuf_new_from_file (fname, &tmp_error);
+	if (pixbuf == NULL) {
+		g_propagate_prefixed_error (error,
+					    tmp_error,
+					    "Failed to load PNG for optimization: ");
+		return FALSE;
+	}
+
+	if (!gdk_pixbuf_save_to_buffer (pixbuf,
+					&opt_data,
+					&opt_len,
+					"png",
+					&tmp_error,
+					"compression",
+					"9",
+					NULL)) {
+		g_propagate_prefixed_error (error,
+					    tmp_error,
+					    "Failed to re-encode PNG for optimization: ");
+		return FALSE;
+	}
+
+	/* keep the existing file if it is already at least as small */
+	if (g_stat (fname, &sbuf) == 0 && (gsize) sbuf.st_size <= opt_len)
+		return TRUE;
+
+	if (!g_file_set_contents (fname, opt_data, (gssize) opt_len, &tmp_error)) {
+		g_propagate_prefixed_error (error,
+					    tmp_error,
+					    "Failed to write optimized PNG: ");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 /**
  * asc_optimize_png:
  * @fname: Filename of the PNG image to optimize.
  * @error: A #GError or %NULL
  *
- * Optimizes a PNG graphic for size with optipng, if its binary
- * is available and this feature is enabled.
+ * Optimizes a PNG graphic for size, if this feature is enabled.
+ * By default the optimization runs entirely in-process; an external
+ * optipng binary is only spawned if one was explicitly configured via
+ * asc_globals_set_optipng_binary().
  **/
 gboolean
 asc_optimize_png (const gchar *fname, GError **error)
@@ -211,15 +335,12 @@ asc_optimize_png (const gchar *fname, GError **error)
 	if (!asc_globals_get_use_optipng ())
 		return TRUE;
 
-	optipng_path = asc_globals_get_optipng_binary ();
-	if (optipng_path == NULL) {
-		g_set_error (error,
-			     ASC_IMAGE_ERROR,
-			     ASC_IMAGE_ERROR_FAILED,
-			     "optipng not found in $PATH");
-		return FALSE;
-	}
+	/* the in-process pass avoids one fork/exec per image, which adds up to
+	 * minutes of saved wall-clock time on a large compose run */
+	if (!asc_globals_get_optipng_explicit ())
+		return asc_png_optimize_inprocess (fname, error);
 
+	optipng_path = asc_globals_get_optipng_binary ();
 	argv = g_new0 (const gchar *, 2 + 1);
 	argv[0] = optipng_path;
 	argv[1] = fname;
@@ -418,6 +539,236 @@ asc_image_new_from_file (const gchar *fname,
 	return g_steal_pointer (&image);
 }
 
+#ifdef G_OS_UNIX
+
+/**
+ * asc_image_fd_write_all:
+ */
+static gboolean
+asc_image_fd_write_all (int fd, const guint8 *buf, gsize len)
+{
+	while (len > 0) {
+		gssize bytes = write (fd, buf, len);
+		if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			return FALSE;
+		}
+		buf += bytes;
+		len -= (gsize) bytes;
+	}
+	return TRUE;
+}
+
+/**
+ * asc_image_fd_read_all:
+ */
+static gboolean
+asc_image_fd_read_all (int fd, guint8 *buf, gsize len)
+{
+	while (len > 0) {
+		gssize bytes = read (fd, buf, len);
+		if (bytes <= 0) {
+			if (bytes < 0 && errno == EINTR)
+				continue;
+			return FALSE;
+		}
+		buf += bytes;
+		len -= (gsize) bytes;
+	}
+	return TRUE;
+}
+
+/**
+ * asc_image_decode_sandboxed:
+ *
+ * Decode image data in a short-lived forked helper process and stream the
+ * raw pixel rows back through a pipe. This is used for SVG graphics:
+ * librsvg parses complex, untrusted vector data, so a crash or
+ * memory-safety issue in the renderer only kills the disposable helper
+ * instead of a compose worker with many units in flight.
+ *
+ * Returns: (transfer full) (nullable): the decoded pixbuf.
+ */
+static GdkPixbuf *
+asc_image_decode_sandboxed (const void *data,
+			    gssize len,
+			    guint dest_size,
+			    gboolean compressed,
+			    GError **error)
+{
+	g_autoptr(GdkPixbuf) pix = NULL;
+	gint pipefd[2];
+	gint32 header[4];
+	gint status = 0;
+	pid_t pid;
+	gint width, height, n_channels;
+	guint8 *pixels;
+
+	if (pipe (pipefd) != 0) {
+		g_set_error (error,
+			     ASC_IMAGE_ERROR,
+			     ASC_IMAGE_ERROR_FAILED,
+			     "Unable to create pipe for SVG helper: %s",
+			     g_strerror (errno));
+		return NULL;
+	}
+
+	pid = fork ();
+	if (pid < 0) {
+		close (pipefd[0]);
+		close (pipefd[1]);
+		g_set_error (error,
+			     ASC_IMAGE_ERROR,
+			     ASC_IMAGE_ERROR_FAILED,
+			     "Unable to fork SVG helper: %s",
+			     g_strerror (errno));
+		return NULL;
+	}
+
+	if (pid == 0) {
+		/* helper: render the graphic and send the pixel data to the parent */
+		g_autoptr(GInputStream) istream = NULL;
+		g_autoptr(GInputStream) dstream = NULL;
+		g_autoptr(GConverter) conv = NULL;
+		g_autoptr(GdkPixbuf) hpix = NULL;
+
+		close (pipefd[0]);
+		istream = g_memory_input_stream_new_from_data (data, len, NULL);
+		if (compressed) {
+			conv = G_CONVERTER (
+			    g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP));
+			dstream = g_converter_input_stream_new (istream, conv);
+		} else {
+			dstream = g_object_ref (istream);
+		}
+
+		if (dest_size == 0)
+			hpix = gdk_pixbuf_new_from_stream (dstream, NULL, NULL);
+		else
+			hpix = gdk_pixbuf_new_from_stream_at_scale (dstream,
+								    dest_size,
+								    dest_size,
+								    TRUE,
+								    NULL,
+								    NULL);
+		if (hpix == NULL)
+			_exit (1);
+
+		width = gdk_pixbuf_get_width (hpix);
+		height = gdk_pixbuf_get_height (hpix);
+		n_channels = gdk_pixbuf_get_n_channels (hpix);
+		header[0] = width;
+		header[1] = height;
+		header[2] = n_channels;
+		header[3] = gdk_pixbuf_get_has_alpha (hpix) ? 1 : 0;
+		if (!asc_image_fd_write_all (pipefd[1],
+					     (const guint8 *) header,
+					     sizeof (header)))
+			_exit (1);
+
+		/* send the rows tightly packed, without any rowstride padding */
+		pixels = gdk_pixbuf_get_pixels (hpix);
+		for (gint y = 0; y < height; y++) {
+			if (!asc_image_fd_write_all (
+				pipefd[1],
+				pixels + (gsize) y * gdk_pixbuf_get_rowstride (hpix),
+				(gsize) width * n_channels))
+				_exit (1);
+		}
+		close (pipefd[1]);
+		_exit (0);
+	}
+
+	/* parent: receive the pixel data */
+	close (pipefd[1]);
+	if (asc_image_fd_read_all (pipefd[0], (guint8 *) header, sizeof (header))) {
+		width = header[0];
+		height = header[1];
+		n_channels = header[2];
+		if (width > 0 && height > 0 && width <= 32768 && height <= 32768 &&
+		    (n_channels == 3 || n_channels == 4)) {
+			pix = gdk_pixbuf_new (GDK_COLORSPACE_RGB,
+					      header[3] != 0,
+					      8,
+					      width,
+					      height);
+			pixels = gdk_pixbuf_get_pixels (pix);
+			for (gint y = 0; y < height; y++) {
+				if (!asc_image_fd_read_all (
+					pipefd[0],
+					pixels + (gsize) y * gdk_pixbuf_get_rowstride (pix),
+					(gsize) width * n_channels)) {
+					g_clear_object (&pix);
+					break;
+				}
+			}
+		}
+	}
+	close (pipefd[0]);
+
+	while (waitpid (pid, &status, 0) < 0) {
+		if (errno != EINTR)
+			break;
+	}
+
+	if (pix == NULL || !WIFEXITED (status) || WEXITSTATUS (status) != 0) {
+		g_clear_object (&pix);
+		if (WIFSIGNALED (status))
+			g_set_error (error,
+				     ASC_IMAGE_ERROR,
+				     ASC_IMAGE_ERROR_FAILED,
+				     "SVG rendering helper was killed by signal %i",
+				     WTERMSIG (status));
+		else
+			g_set_error_literal (error,
+					     ASC_IMAGE_ERROR,
+					     ASC_IMAGE_ERROR_FAILED,
+					     "SVG graphic could not be rendered");
+		return NULL;
+	}
+
+	return g_steal_pointer (&pix);
+}
+
+#else
+
+/**
+ * asc_image_decode_sandboxed:
+ *
+ * No process isolation without fork() - decode in-process.
+ */
+static GdkPixbuf *
+asc_image_decode_sandboxed (const void *data,
+			    gssize len,
+			    guint dest_size,
+			    gboolean compressed,
+			    GError **error)
+{
+	g_autoptr(GInputStream) istream = NULL;
+	g_autoptr(GInputStream) dstream = NULL;
+	g_autoptr(GConverter) conv = NULL;
+
+	istream = g_memory_input_stream_new_from_data (data, len, NULL);
+	if (compressed) {
+		conv = G_CONVERTER (g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP));
+		dstream = g_converter_input_stream_new (istream, conv);
+	} else {
+		dstream = g_object_ref (istream);
+	}
+
+	if (dest_size == 0)
+		return gdk_pixbuf_new_from_stream (dstream, NULL, error);
+	return gdk_pixbuf_new_from_stream_at_scale (dstream,
+						    dest_size,
+						    dest_size,
+						    TRUE,
+						    NULL,
+						    error);
+}
+
+#endif /* G_OS_UNIX */
+
 /**
  * asc_image_new_from_data:
  * @data: Data to load.
@@ -442,8 +793,36 @@ asc_image_new_from_data (const void *data,
 	g_autoptr(GInputStream) dstream = NULL;
 	g_autoptr(GConverter) conv = NULL;
 	g_autoptr(GdkPixbuf) pix = NULL;
+	g_autofree gchar *cache_key = NULL;
 	g_autoptr(AscImage) image = asc_image_new ();
 
+	/* check if we already decoded identical data before */
+	if (as_flags_contains (flags, ASC_IMAGE_LOAD_FLAG_SHARED_CACHE)) {
+		g_autoptr(GdkPixbuf) cached_pix = NULL;
+
+		cache_key = asc_image_dcache_build_key (data, len, dest_size, compressed, flags);
+		cached_pix = asc_image_dcache_lookup (cache_key);
+		if (cached_pix != NULL) {
+			asc_image_set_pixbuf (image, cached_pix);
+			return g_steal_pointer (&image);
+		}
+	}
+
+	/* rasterize in an isolated helper process, if requested */
+	if (as_flags_contains (flags, ASC_IMAGE_LOAD_FLAG_SANDBOX_SVG)) {
+		pix = asc_image_decode_sandboxed (data, len, dest_size, compressed, error);
+		if (pix == NULL)
+			return NULL;
+		if (dest_size == 0) {
+			asc_image_set_pixbuf (image, pix);
+		} else if (!asc_image_load_pixbuf (image, pix, dest_size, 0, flags, error)) {
+			return NULL;
+		}
+		if (cache_key != NULL)
+			asc_image_dcache_insert (cache_key, asc_image_get_pixbuf (image));
+		return g_steal_pointer (&image);
+	}
+
 	istream = g_memory_input_stream_new_from_data (data, len, NULL);
 	if (compressed) {
 		conv = G_CONVERTER (g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP));
@@ -459,6 +838,8 @@ asc_image_new_from_data (const void *data,
 			return NULL;
 
 		asc_image_set_pixbuf (image, pix);
+		if (cache_key != NULL)
+			asc_image_dcache_insert (cache_key, pix);
 		return g_steal_pointer (&image);
 	}
 
@@ -482,6 +863,8 @@ asc_image_new_from_data (const void *data,
 	if (!ret)
 		return NULL;
 
+	if (cache_key != NULL)
+		asc_image_dcache_insert (cache_key, asc_image_get_pixbuf (image));
 	return g_steal_pointer (&image);
 }
 
@@ -623,7 +1006,38 @@ asc_image_load_filename (AscImage *image,
 							   (gint) dest_size,
 							   error);
 	} else {
-		pixbuf_src = asc_image_pixbuf_new_from_gz (filename, 0, 0, error);
+		gint src_width = 0;
+		gint src_height = 0;
+
+		/* if we know the source dimensions from the image header and the image is
+		 * larger than its target size, we let the pixbuf loader scale it down
+		 * while decoding, so we never hold the full-resolution pixel buffer of a
+		 * large screenshot in memory.
+		 * If the size can not be determined (e.g. for gzipped image data), we
+		 * fall back to decoding the image in its native size. */
+		if (gdk_pixbuf_get_file_info (filename, &src_width, &src_height) != NULL &&
+		    (src_width > (gint) dest_size || src_height > (gint) dest_size)) {
+			/* check the source size limit on the real dimensions, as we will
+			 * only ever see the downscaled image from this point on */
+			if (src_width < (gint) src_size_min &&
+			    src_height < (gint) src_size_min) {
+				g_set_error (error,
+					     ASC_IMAGE_ERROR,
+					     ASC_IMAGE_ERROR_FAILED,
+					     "Image was too small %ix%i",
+					     src_width,
+					     src_height);
+				return FALSE;
+			}
+			src_size_min = 0;
+
+			pixbuf_src = asc_image_pixbuf_new_from_gz (filename,
+								   (gint) dest_size,
+								   (gint) dest_size,
+								   error);
+		} else {
+			pixbuf_src = asc_image_pixbuf_new_from_gz (filename, 0, 0, error);
+		}
 	}
 	if (pixbuf_src == NULL)
 		return FALSE;
@@ -718,6 +1132,41 @@ asc_image_scale (AscImage *image, guint new_width, guint new_height)
 	asc_image_set_pixbuf (image, res_pix);
 }
 
+/**
+ * asc_image_new_scaled:
+ * @image: an #AscImage instance.
+ * @new_width: The new width.
+ * @new_height: the new height.
+ *
+ * Create a new #AscImage scaled to the given size, leaving this
+ * image untouched.
+ * When rendering multiple target sizes of the same image, this allows
+ * scaling each size from the closest already-scaled version in a
+ * mipmap-like cascade, instead of resampling the large source image
+ * for every single size.
+ *
+ * Returns: (transfer full) (nullable): the scaled image, or %NULL if no pixbuf was set.
+ **/
+AscImage *
+asc_image_new_scaled (AscImage *image, guint new_width, guint new_height)
+{
+	AscImagePrivate *priv = GET_PRIVATE (image);
+	g_autoptr(GdkPixbuf) res_pix = NULL;
+	AscImage *res_image;
+
+	g_return_val_if_fail (ASC_IS_IMAGE (image), NULL);
+	if (priv->pix == NULL)
+		return NULL;
+
+	res_pix = gdk_pixbuf_scale_simple (priv->pix, new_width, new_height, GDK_INTERP_BILINEAR);
+	if (res_pix == NULL)
+		g_error ("Unable to allocate enough memory for image scaling.");
+
+	res_image = asc_image_new ();
+	asc_image_set_pixbuf (res_image, res_pix);
+	return res_image;
+}
+
 /**
  * asc_image_scale_to_width:
  * @image: an #AscImage instance.
@@ -879,17 +1328,217 @@ asc_image_save_filename (AscImage *image,
 			 GError **error)
 {
 	g_autoptr(GdkPixbuf) pixbuf = NULL;
+	gboolean encode_fast;
+
+	/* use the fastest zlib level if requested, or if the optimizer pass will
+	 * recompress the result anyway and spending time on a well-compressed
+	 * intermediate file would be wasted */
+	encode_fast = as_flags_contains (flags, ASC_IMAGE_SAVE_FLAG_ENCODE_FAST) ||
+		      (as_flags_contains (flags, ASC_IMAGE_SAVE_FLAG_OPTIMIZE) &&
+		       asc_globals_get_use_optipng ());
 
 	/* save source file */
 	pixbuf = asc_image_save_pixbuf (image, width, height, flags);
-	if (!gdk_pixbuf_save (pixbuf, filename, "png", error, NULL))
-		return FALSE;
+	if (encode_fast) {
+		if (!gdk_pixbuf_save (pixbuf, filename, "png", error, "compression", "1", NULL))
+			return FALSE;
+	} else {
+		if (!gdk_pixbuf_save (pixbuf, filename, "png", error, NULL))
+			return FALSE;
+	}
 
 	if (!as_flags_contains (flags, ASC_IMAGE_SAVE_FLAG_OPTIMIZE))
 		return TRUE;
 	return asc_optimize_png (filename, error);
 }
 
+/**
+ * asc_image_save_fd:
+ * @image: a #AscImage instance.
+ * @fd: an open, writable file descriptor.
+ * @width: target width, or 0 for default
+ * @height: target height, or 0 for default
+ * @flags: some #AscImageSaveFlags values, e.g. %ASC_IMAGE_SAVE_FLAG_PAD_16_9
+ * @error: A #GError or %NULL.
+ *
+ * Encode the image as PNG and write it to an already open file descriptor,
+ * without going through a filename. The descriptor is not closed.
+ *
+ * The image is encoded - and with %ASC_IMAGE_SAVE_FLAG_OPTIMIZE also
+ * optimized - entirely in memory, so the result is written in a single
+ * pass and the file is never rewritten afterwards. Only an explicitly
+ * configured external optipng binary can not be used here, as it operates
+ * on file paths; run asc_optimize_png() on the final file in that case.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+asc_image_save_fd (AscImage *image,
+		   gint fd,
+		   guint width,
+		   guint height,
+		   AscImageSaveFlags flags,
+		   GError **error)
+{
+	g_autoptr(GdkPixbuf) pixbuf = NULL;
+	g_autofree gchar *png_data = NULL;
+	const gchar *buf;
+	gsize png_len = 0;
+	gboolean optimize_inprocess;
+
+	pixbuf = asc_image_save_pixbuf (image, width, height, flags);
+	optimize_inprocess = as_flags_contains (flags, ASC_IMAGE_SAVE_FLAG_OPTIMIZE) &&
+			     asc_globals_get_use_optipng () &&
+			     !asc_globals_get_optipng_explicit ();
+
+	if (optimize_inprocess) {
+		/* this already is the final encoding pass, so use the best compression right away */
+		if (!gdk_pixbuf_save_to_buffer (pixbuf,
+						&png_data,
+						&png_len,
+						"png",
+						error,
+						"compression",
+						"9",
+						NULL))
+			return FALSE;
+	} else {
+		gboolean encode_fast = as_flags_contains (flags, ASC_IMAGE_SAVE_FLAG_ENCODE_FAST) ||
+				       (as_flags_contains (flags, ASC_IMAGE_SAVE_FLAG_OPTIMIZE) &&
+					asc_globals_get_use_optipng ());
+		if (encode_fast) {
+			if (!gdk_pixbuf_save_to_buffer (pixbuf,
+							&png_data,
+							&png_len,
+							"png",
+							error,
+							"compression",
+							"1",
+							NULL))
+				return FALSE;
+		} else {
+			if (!gdk_pixbuf_save_to_buffer (pixbuf,
+							&png_data,
+							&png_len,
+							"png",
+							error,
+							NULL))
+				return FALSE;
+		}
+	}
+
+	buf = png_data;
+	while (png_len > 0) {
+		gssize bytes_written = write (fd, buf, png_len);
+		if (bytes_written < 0) {
+			if (errno == EINTR)
+				continue;
+			g_set_error (error,
+				     ASC_IMAGE_ERROR,
+				     ASC_IMAGE_ERROR_FAILED,
+				     "Unable to write PNG data: %s",
+				     g_strerror (errno));
+			return FALSE;
+		}
+		buf += bytes_written;
+		png_len -= (gsize) bytes_written;
+	}
+
+	return TRUE;
+}
+
+/**
+ * asc_image_save_filename_at:
+ * @image: a #AscImage instance.
+ * @dirfd: an open file descriptor of the target directory.
+ * @basename: target filename, relative to @dirfd
+ * @width: target width, or 0 for default
+ * @height: target height, or 0 for default
+ * @flags: some #AscImageSaveFlags values, e.g. %ASC_IMAGE_SAVE_FLAG_PAD_16_9
+ * @error: A #GError or %NULL.
+ *
+ * Saves the image as PNG below an already open directory descriptor.
+ * The data is written to a temporary file first and only moved to its
+ * final name once it is complete, so other processes never observe a
+ * partially written image.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+asc_image_save_filename_at (AscImage *image,
+			    gint dirfd,
+			    const gchar *basename,
+			    guint width,
+			    guint height,
+			    AscImageSaveFlags flags,
+			    GError **error)
+{
+	gint fd = -1;
+	gboolean fd_is_anon = FALSE;
+	g_autofree gchar *tmp_name = NULL;
+
+#ifdef O_TMPFILE
+	/* prefer an anonymous file, which never leaves stale temporary files around */
+	fd = openat (dirfd, ".", O_TMPFILE | O_WRONLY | O_CLOEXEC, 0644);
+	if (fd >= 0)
+		fd_is_anon = TRUE;
+#endif
+	if (fd < 0) {
+		/* the filesystem (or OS) does not support O_TMPFILE, use a dot-file instead */
+		tmp_name = g_strdup_printf (".%s.tmp", basename);
+		fd = openat (dirfd, tmp_name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (fd < 0) {
+			g_set_error (error,
+				     ASC_IMAGE_ERROR,
+				     ASC_IMAGE_ERROR_FAILED,
+				     "Unable to create temporary file for '%s': %s",
+				     basename,
+				     g_strerror (errno));
+			return FALSE;
+		}
+	}
+
+	if (!asc_image_save_fd (image, fd, width, height, flags, error)) {
+		close (fd);
+		if (!fd_is_anon)
+			unlinkat (dirfd, tmp_name, 0);
+		return FALSE;
+	}
+
+	if (fd_is_anon) {
+		g_autofree gchar *fd_path = g_strdup_printf ("/proc/self/fd/%d", fd);
+
+		/* publish the finished file under its real name, replacing any old version */
+		if (linkat (AT_FDCWD, fd_path, dirfd, basename, AT_SYMLINK_FOLLOW) != 0 &&
+		    (errno != EEXIST || unlinkat (dirfd, basename, 0) != 0 ||
+		     linkat (AT_FDCWD, fd_path, dirfd, basename, AT_SYMLINK_FOLLOW) != 0)) {
+			g_set_error (error,
+				     ASC_IMAGE_ERROR,
+				     ASC_IMAGE_ERROR_FAILED,
+				     "Unable to link '%s' into place: %s",
+				     basename,
+				     g_strerror (errno));
+			close (fd);
+			return FALSE;
+		}
+		close (fd);
+		return TRUE;
+	}
+
+	close (fd);
+	if (renameat (dirfd, tmp_name, dirfd, basename) != 0) {
+		g_set_error (error,
+			     ASC_IMAGE_ERROR,
+			     ASC_IMAGE_ERROR_FAILED,
+			     "Unable to move '%s' into place: %s",
+			     basename,
+			     g_strerror (errno));
+		unlinkat (dirfd, tmp_name, 0);
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static void
 asc_pixbuf_blur_private (GdkPixbuf *src, GdkPixbuf *dest, gint radius, guchar *div_kernel_size)
 {
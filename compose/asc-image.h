@@ -39,15 +39,17 @@ G_DECLARE_FINAL_TYPE (AscImage, asc_image, ASC, IMAGE, GObject)
  * @ASC_IMAGE_SAVE_FLAG_PAD_16_9:	Pad with alpha to 16:9 aspect
  * @ASC_IMAGE_SAVE_FLAG_SHARPEN:	Sharpen the image to clarify detail
  * @ASC_IMAGE_SAVE_FLAG_BLUR:		Blur the image to clear detail
+ * @ASC_IMAGE_SAVE_FLAG_ENCODE_FAST:	Use the fastest zlib level when encoding the PNG, trading a slightly larger file for much faster encoding
  *
  * The flags used for saving images.
  **/
 typedef enum {
-	ASC_IMAGE_SAVE_FLAG_NONE     = 0,
-	ASC_IMAGE_SAVE_FLAG_OPTIMIZE = 1 << 0,
-	ASC_IMAGE_SAVE_FLAG_PAD_16_9 = 1 << 1,
-	ASC_IMAGE_SAVE_FLAG_SHARPEN  = 1 << 2,
-	ASC_IMAGE_SAVE_FLAG_BLUR     = 1 << 3,
+	ASC_IMAGE_SAVE_FLAG_NONE        = 0,
+	ASC_IMAGE_SAVE_FLAG_OPTIMIZE    = 1 << 0,
+	ASC_IMAGE_SAVE_FLAG_PAD_16_9    = 1 << 1,
+	ASC_IMAGE_SAVE_FLAG_SHARPEN     = 1 << 2,
+	ASC_IMAGE_SAVE_FLAG_BLUR        = 1 << 3,
+	ASC_IMAGE_SAVE_FLAG_ENCODE_FAST = 1 << 4,
 	/*< private >*/
 	ASC_IMAGE_SAVE_FLAG_LAST
 } AscImageSaveFlags;
@@ -58,6 +60,8 @@ typedef enum {
  * @ASC_IMAGE_LOAD_FLAG_SHARPEN:		Sharpen the resulting image
  * @ASC_IMAGE_LOAD_FLAG_ALLOW_UNSUPPORTED:	Allow loading of unsupported image types.
  * @ASC_IMAGE_LOAD_FLAG_ALWAYS_RESIZE:		Always resize the source image to the perfect size
+ * @ASC_IMAGE_LOAD_FLAG_SHARED_CACHE:		Share decoded pixbufs between images with identical source data. The resulting pixbuf must be treated as read-only.
+ * @ASC_IMAGE_LOAD_FLAG_SANDBOX_SVG:		Rasterize vector graphics in a disposable helper process, so renderer crashes can not take down the caller.
  *
  * The flags used for loading images.
  **/
@@ -66,6 +70,8 @@ typedef enum {
 	ASC_IMAGE_LOAD_FLAG_SHARPEN	      = 1 << 0,
 	ASC_IMAGE_LOAD_FLAG_ALLOW_UNSUPPORTED = 1 << 1,
 	ASC_IMAGE_LOAD_FLAG_ALWAYS_RESIZE     = 1 << 2,
+	ASC_IMAGE_LOAD_FLAG_SHARED_CACHE      = 1 << 3,
+	ASC_IMAGE_LOAD_FLAG_SANDBOX_SVG	      = 1 << 4,
 	/*< private >*/
 	ASC_IMAGE_LOAD_FLAG_LAST
 } AscImageLoadFlags;
@@ -151,6 +157,19 @@ gboolean       asc_image_save_filename (AscImage	 *image,
 					guint		  height,
 					AscImageSaveFlags flags,
 					GError		**error);
+gboolean       asc_image_save_fd (AscImage	   *image,
+				  gint		    fd,
+				  guint		    width,
+				  guint		    height,
+				  AscImageSaveFlags flags,
+				  GError	  **error);
+gboolean       asc_image_save_filename_at (AscImage	    *image,
+					   gint		     dirfd,
+					   const gchar	    *basename,
+					   guint	     width,
+					   guint	     height,
+					   AscImageSaveFlags flags,
+					   GError	   **error);
 
 GdkPixbuf     *asc_image_get_pixbuf (AscImage *image);
 void	       asc_image_set_pixbuf (AscImage *image, GdkPixbuf *pixbuf);
@@ -159,6 +178,7 @@ guint	       asc_image_get_width (AscImage *image);
 guint	       asc_image_get_height (AscImage *image);
 
 void	       asc_image_scale (AscImage *image, guint new_width, guint new_height);
+AscImage      *asc_image_new_scaled (AscImage *image, guint new_width, guint new_height);
 
 void	       asc_image_scale_to_width (AscImage *image, guint new_width);
 void	       asc_image_scale_to_height (AscImage *image, guint new_height);
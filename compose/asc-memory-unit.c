@@ -0,0 +1,202 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:asc-memory-unit
+ * @short_description: A data source unit serving file data directly from memory
+ * @include: appstream-compose.h
+ *
+ * This unit type accepts a mapping of file paths to data blobs and never
+ * touches the disk, which makes it useful for long-lived compose services
+ * that already hold metadata in memory (e.g. from a build sandbox) and
+ * want to feed it to a reusable #AscCompose instance.
+ */
+
+#include "config.h"
+#include "asc-memory-unit.h"
+
+#include <gio/gio.h>
+
+typedef struct {
+	GHashTable *files_map; /* utf8 -> GBytes */
+} AscMemoryUnitPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (AscMemoryUnit, asc_memory_unit, ASC_TYPE_UNIT)
+#define GET_PRIVATE(o) (asc_memory_unit_get_instance_private (o))
+
+static gboolean asc_memory_unit_open (AscUnit *unit, GError **error);
+static void asc_memory_unit_close (AscUnit *unit);
+
+static gboolean asc_memory_unit_file_exists (AscUnit *unit, const gchar *filename);
+static gboolean asc_memory_unit_dir_exists (AscUnit *unit, const gchar *dirname);
+static GBytes *asc_memory_unit_read_data (AscUnit *unit, const gchar *filename, GError **error);
+
+static void
+asc_memory_unit_init (AscMemoryUnit *munit)
+{
+	AscMemoryUnitPrivate *priv = GET_PRIVATE (munit);
+
+	priv->files_map = g_hash_table_new_full (g_str_hash,
+						 g_str_equal,
+						 g_free,
+						 (GDestroyNotify) g_bytes_unref);
+}
+
+static void
+asc_memory_unit_finalize (GObject *object)
+{
+	AscMemoryUnit *munit = ASC_MEMORY_UNIT (object);
+	AscMemoryUnitPrivate *priv = GET_PRIVATE (munit);
+
+	g_hash_table_unref (priv->files_map);
+
+	G_OBJECT_CLASS (asc_memory_unit_parent_class)->finalize (object);
+}
+
+static void
+asc_memory_unit_class_init (AscMemoryUnitClass *klass)
+{
+	AscUnitClass *unit_class;
+	GObjectClass *object_class;
+
+	object_class = G_OBJECT_CLASS (klass);
+	object_class->finalize = asc_memory_unit_finalize;
+
+	unit_class = ASC_UNIT_CLASS (klass);
+	unit_class->open = asc_memory_unit_open;
+	unit_class->close = asc_memory_unit_close;
+	unit_class->file_exists = asc_memory_unit_file_exists;
+	unit_class->dir_exists = asc_memory_unit_dir_exists;
+	unit_class->read_data = asc_memory_unit_read_data;
+}
+
+static gboolean
+asc_memory_unit_open (AscUnit *unit, GError **error)
+{
+	AscMemoryUnitPrivate *priv = GET_PRIVATE (ASC_MEMORY_UNIT (unit));
+	g_autoptr(GPtrArray) contents = NULL;
+	GHashTableIter iter;
+	gpointer key, value;
+	guint64 size_total = 0;
+
+	contents = g_ptr_array_new_with_free_func (g_free);
+	g_hash_table_iter_init (&iter, priv->files_map);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		g_ptr_array_add (contents, g_strdup ((const gchar *) key));
+		size_total += g_bytes_get_size ((GBytes *) value);
+	}
+	asc_unit_set_contents (unit, contents);
+
+	/* use the amount of data we hold as scheduling hint */
+	asc_unit_set_size_hint (unit, size_total);
+
+	return TRUE;
+}
+
+static void
+asc_memory_unit_close (AscUnit *unit)
+{
+	/* we don't actually need to do anything here */
+	return;
+}
+
+static gboolean
+asc_memory_unit_file_exists (AscUnit *unit, const gchar *filename)
+{
+	AscMemoryUnitPrivate *priv = GET_PRIVATE (ASC_MEMORY_UNIT (unit));
+
+	return g_hash_table_contains (priv->files_map, filename);
+}
+
+static gboolean
+asc_memory_unit_dir_exists (AscUnit *unit, const gchar *dirname)
+{
+	AscMemoryUnitPrivate *priv = GET_PRIVATE (ASC_MEMORY_UNIT (unit));
+	g_autofree gchar *dir_prefix = NULL;
+	GHashTableIter iter;
+	gpointer key;
+
+	/* we only know files, so a directory exists if any file is below it */
+	dir_prefix = g_str_has_suffix (dirname, G_DIR_SEPARATOR_S)
+			 ? g_strdup (dirname)
+			 : g_strconcat (dirname, G_DIR_SEPARATOR_S, NULL);
+
+	g_hash_table_iter_init (&iter, priv->files_map);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		if (g_str_has_prefix ((const gchar *) key, dir_prefix))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static GBytes *
+asc_memory_unit_read_data (AscUnit *unit, const gchar *filename, GError **error)
+{
+	AscMemoryUnitPrivate *priv = GET_PRIVATE (ASC_MEMORY_UNIT (unit));
+	GBytes *bytes;
+
+	bytes = g_hash_table_lookup (priv->files_map, filename);
+	if (bytes == NULL) {
+		g_set_error (error,
+			     G_IO_ERROR,
+			     G_IO_ERROR_NOT_FOUND,
+			     "No data found for '%s' in memory unit.",
+			     filename);
+		return NULL;
+	}
+
+	return g_bytes_ref (bytes);
+}
+
+/**
+ * asc_memory_unit_add_data:
+ * @munit: an #AscMemoryUnit instance.
+ * @fname: the filename the data should be registered under, e.g. `/usr/share/metainfo/org.example.app.metainfo.xml`
+ * @bytes: the data itself.
+ *
+ * Register a data blob under the given filename, as it would appear in
+ * the installed filesystem tree. Any previously registered data for the
+ * same filename is replaced.
+ **/
+void
+asc_memory_unit_add_data (AscMemoryUnit *munit, const gchar *fname, GBytes *bytes)
+{
+	AscMemoryUnitPrivate *priv = GET_PRIVATE (munit);
+
+	g_return_if_fail (fname != NULL);
+	g_return_if_fail (bytes != NULL);
+	g_hash_table_insert (priv->files_map, g_strdup (fname), g_bytes_ref (bytes));
+}
+
+/**
+ * asc_memory_unit_new:
+ * @bundle_id: the bundle name of this unit, e.g. a package name.
+ *
+ * Creates a new #AscMemoryUnit.
+ **/
+AscMemoryUnit *
+asc_memory_unit_new (const gchar *bundle_id)
+{
+	AscMemoryUnit *munit;
+	munit = g_object_new (ASC_TYPE_MEMORY_UNIT, NULL);
+	asc_unit_set_bundle_id (ASC_UNIT (munit), bundle_id);
+	return ASC_MEMORY_UNIT (munit);
+}
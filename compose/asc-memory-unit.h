@@ -0,0 +1,48 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(__APPSTREAM_COMPOSE_H) && !defined(ASC_COMPILATION)
+#error "Only <appstream-compose.h> can be included directly."
+#endif
+#pragma once
+
+#include <glib-object.h>
+#include "asc-unit.h"
+
+G_BEGIN_DECLS
+
+#define ASC_TYPE_MEMORY_UNIT (asc_memory_unit_get_type ())
+G_DECLARE_DERIVABLE_TYPE (AscMemoryUnit, asc_memory_unit, ASC, MEMORY_UNIT, AscUnit)
+
+struct _AscMemoryUnitClass {
+	AscUnitClass parent_class;
+
+	/*< private >*/
+	void (*_as_reserved1) (void);
+	void (*_as_reserved2) (void);
+	void (*_as_reserved3) (void);
+	void (*_as_reserved4) (void);
+};
+
+AscMemoryUnit *asc_memory_unit_new (const gchar *bundle_id);
+
+void	       asc_memory_unit_add_data (AscMemoryUnit *munit, const gchar *fname, GBytes *bytes);
+
+G_END_DECLS
@@ -22,10 +22,17 @@
  * SECTION:asc-result
  * @short_description: A composer result for a single unit.
  * @include: appstream-compose.h
+ *
+ * An #AscResult guards its internal state with its own lock, so multiple
+ * worker threads may accumulate components and hints into the same result
+ * concurrently. Since each processed unit owns a separate result, these
+ * locks are effectively uncontended and accumulation does not serialize
+ * on any shared compose-wide mutex.
  */
 
 #include "config.h"
 #include "asc-result.h"
+#include "asc-result-private.h"
 
 #include "as-utils-private.h"
 #include "asc-globals-private.h"
@@ -40,6 +47,8 @@ typedef struct {
 	GHashTable *mdata_hashes; /* AsComponent->utf8 */
 	GHashTable *hints;	  /* GRefString->GPtrArray */
 	GHashTable *gcids;	  /* GRefString->utf8 (component-id -> global component-id) */
+
+	GMutex mutex;
 } AscResultPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (AscResult, asc_result, G_TYPE_OBJECT)
@@ -51,6 +60,7 @@ asc_result_init (AscResult *result)
 	AscResultPrivate *priv = GET_PRIVATE (result);
 
 	priv->bundle_kind = AS_BUNDLE_KIND_UNKNOWN;
+	g_mutex_init (&priv->mutex);
 
 	priv->cpts = g_hash_table_new_full (g_str_hash,
 					    g_str_equal,
@@ -79,6 +89,7 @@ asc_result_finalize (GObject *object)
 	g_hash_table_unref (priv->mdata_hashes);
 	g_hash_table_unref (priv->hints);
 	g_hash_table_unref (priv->gcids);
+	g_mutex_clear (&priv->mutex);
 
 	G_OBJECT_CLASS (asc_result_parent_class)->finalize (object);
 }
@@ -100,6 +111,7 @@ gboolean
 asc_result_unit_ignored (AscResult *result)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	return (g_hash_table_size (priv->cpts) == 0) && (g_hash_table_size (priv->hints) == 0);
 }
 
@@ -113,6 +125,7 @@ guint
 asc_result_components_count (AscResult *result)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	return g_hash_table_size (priv->cpts);
 }
 
@@ -126,6 +139,7 @@ guint
 asc_result_hints_count (AscResult *result)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	GHashTableIter iter;
 	gpointer value;
 	guint count = 0;
@@ -150,6 +164,7 @@ gboolean
 asc_result_is_ignored (AscResult *result, AsComponent *cpt)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	return !g_hash_table_contains (priv->cpts, as_component_get_id (cpt));
 }
 
@@ -176,6 +191,7 @@ void
 asc_result_set_bundle_kind (AscResult *result, AsBundleKind kind)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	priv->bundle_kind = kind;
 }
 
@@ -204,6 +220,7 @@ void
 asc_result_set_bundle_id (AscResult *result, const gchar *id)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	g_free (priv->bundle_id);
 	priv->bundle_id = g_strdup (id);
 }
@@ -221,6 +238,7 @@ AsComponent *
 asc_result_get_component (AscResult *result, const gchar *cid)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	return g_hash_table_lookup (priv->cpts, cid);
 }
 
@@ -236,6 +254,7 @@ GPtrArray *
 asc_result_fetch_components (AscResult *result)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	GPtrArray *res;
 	GHashTableIter iter;
 	gpointer value;
@@ -261,6 +280,7 @@ GPtrArray *
 asc_result_get_hints (AscResult *result, const gchar *cid)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	return g_hash_table_lookup (priv->hints, cid);
 }
 
@@ -276,6 +296,7 @@ GPtrArray *
 asc_result_fetch_hints_all (AscResult *result)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	GPtrArray *res;
 	GHashTableIter iter;
 	gpointer value;
@@ -304,21 +325,18 @@ const gchar **
 asc_result_get_component_ids_with_hints (AscResult *result)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	return (const gchar **) g_hash_table_get_keys_as_array (priv->hints, NULL);
 }
 
 /**
- * asc_result_update_component_gcid:
- * @result: an #AscResult instance.
- * @cpt: The #AsComponent to edit.
- * @bytes: (nullable): The data to include in the global component ID, or %NULL
+ * asc_result_update_component_gcid_internal:
  *
- * Update the global component ID for the given component.
- *
- * Returns: %TRUE if the component existed and was updated.
+ * Update the global component ID for the given component,
+ * assuming the result lock is already held.
  **/
-gboolean
-asc_result_update_component_gcid (AscResult *result, AsComponent *cpt, GBytes *bytes)
+static gboolean
+asc_result_update_component_gcid_internal (AscResult *result, AsComponent *cpt, GBytes *bytes)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
 	g_autofree gchar *gcid = NULL;
@@ -367,6 +385,24 @@ asc_result_update_component_gcid (AscResult *result, AsComponent *cpt, GBytes *b
 	return TRUE;
 }
 
+/**
+ * asc_result_update_component_gcid:
+ * @result: an #AscResult instance.
+ * @cpt: The #AsComponent to edit.
+ * @bytes: (nullable): The data to include in the global component ID, or %NULL
+ *
+ * Update the global component ID for the given component.
+ *
+ * Returns: %TRUE if the component existed and was updated.
+ **/
+gboolean
+asc_result_update_component_gcid (AscResult *result, AsComponent *cpt, GBytes *bytes)
+{
+	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
+	return asc_result_update_component_gcid_internal (result, cpt, bytes);
+}
+
 /**
  * asc_result_update_component_gcid_with_string:
  * @result: an #AscResult instance.
@@ -400,6 +436,7 @@ const gchar *
 asc_result_gcid_for_cid (AscResult *result, const gchar *cid)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	return (const gchar *) g_hash_table_lookup (priv->gcids, cid);
 }
 
@@ -430,6 +467,7 @@ const gchar **
 asc_result_get_component_gcids (AscResult *result)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	const gchar **strv;
 	GHashTableIter iter;
 	gpointer value;
@@ -457,6 +495,7 @@ gboolean
 asc_result_add_component (AscResult *result, AsComponent *cpt, GBytes *bytes, GError **error)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = NULL;
 	AsComponentKind ckind;
 	const gchar *cid = as_component_get_id (cpt);
 
@@ -468,6 +507,8 @@ asc_result_add_component (AscResult *result, AsComponent *cpt, GBytes *bytes, GE
 		return FALSE;
 	}
 
+	locker = g_mutex_locker_new (&priv->mutex);
+
 	/* web applications, operating systems, repositories
 	 * and component-removal merges don't (need to) have a package/bundle name set */
 	ckind = as_component_get_kind (cpt);
@@ -486,7 +527,7 @@ asc_result_add_component (AscResult *result, AsComponent *cpt, GBytes *bytes, GE
 	}
 
 	g_hash_table_insert (priv->cpts, g_ref_string_new_intern (cid), g_object_ref (cpt));
-	asc_result_update_component_gcid (result, cpt, bytes);
+	asc_result_update_component_gcid_internal (result, cpt, bytes);
 	return TRUE;
 }
 
@@ -512,17 +553,65 @@ asc_result_add_component_with_string (AscResult *result,
 }
 
 /**
- * asc_result_remove_component_full:
+ * asc_result_add_component_with_checksum:
  * @result: an #AscResult instance.
- * @cpt: The #AsComponent to remove.
- * @remove_gcid: %TRUE if global component ID should be unregistered as well.
+ * @cpt: The #AsComponent to add.
+ * @checksum: The metadata checksum to build the GCID from.
+ * @error: A #GError or %NULL
  *
- * Remove a component from the results set.
+ * Add component to the results set, restoring its global component ID
+ * from a previously recorded metadata checksum instead of computing it
+ * from source data. This is used to rebuild a result from a checkpoint,
+ * so restored components keep their original media paths.
  *
- * Returns: %TRUE if the component was found and removed.
+ * Returns: %TRUE on success.
  **/
 gboolean
-asc_result_remove_component_full (AscResult *result, AsComponent *cpt, gboolean remove_gcid)
+asc_result_add_component_with_checksum (AscResult *result,
+					AsComponent *cpt,
+					const gchar *checksum,
+					GError **error)
+{
+	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autofree gchar *gcid = NULL;
+	const gchar *cid = as_component_get_id (cpt);
+
+	if (!asc_result_add_component (result, cpt, NULL, error))
+		return FALSE;
+
+	locker = g_mutex_locker_new (&priv->mutex);
+	g_hash_table_insert (priv->mdata_hashes, cpt, g_strdup (checksum));
+	gcid = asc_build_component_global_id (cid, checksum);
+	g_hash_table_insert (priv->gcids, g_ref_string_new_intern (cid), g_steal_pointer (&gcid));
+
+	return TRUE;
+}
+
+/**
+ * asc_result_get_component_mdata_checksum:
+ * @result: an #AscResult instance.
+ * @cpt: The #AsComponent to look up.
+ *
+ * Retrieve the metadata checksum that the global component ID of @cpt
+ * was built from, or %NULL if no data was hashed for this component.
+ **/
+const gchar *
+asc_result_get_component_mdata_checksum (AscResult *result, AsComponent *cpt)
+{
+	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
+	return (const gchar *) g_hash_table_lookup (priv->mdata_hashes, cpt);
+}
+
+/**
+ * asc_result_remove_component_internal:
+ *
+ * Remove a component from the results set,
+ * assuming the result lock is already held.
+ **/
+static gboolean
+asc_result_remove_component_internal (AscResult *result, AsComponent *cpt, gboolean remove_gcid)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
 	gboolean ret;
@@ -535,6 +624,24 @@ asc_result_remove_component_full (AscResult *result, AsComponent *cpt, gboolean
 	return ret;
 }
 
+/**
+ * asc_result_remove_component_full:
+ * @result: an #AscResult instance.
+ * @cpt: The #AsComponent to remove.
+ * @remove_gcid: %TRUE if global component ID should be unregistered as well.
+ *
+ * Remove a component from the results set.
+ *
+ * Returns: %TRUE if the component was found and removed.
+ **/
+gboolean
+asc_result_remove_component_full (AscResult *result, AsComponent *cpt, gboolean remove_gcid)
+{
+	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
+	return asc_result_remove_component_internal (result, cpt, remove_gcid);
+}
+
 /**
  * asc_result_remove_component:
  * @result: an #AscResult instance.
@@ -561,6 +668,7 @@ void
 asc_result_remove_hints_for_cid (AscResult *result, const gchar *cid)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	g_hash_table_remove (priv->hints, cid);
 }
 
@@ -578,6 +686,7 @@ gboolean
 asc_result_has_hint (AscResult *result, AsComponent *cpt, const gchar *tag)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	GPtrArray *hints;
 	const gchar *cid = as_component_get_id (cpt);
 
@@ -606,12 +715,13 @@ gboolean
 asc_result_remove_component_by_id (AscResult *result, const gchar *cid)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
 	AsComponent *cpt;
 
 	cpt = g_hash_table_lookup (priv->cpts, cid);
 	if (cpt == NULL)
 		return FALSE;
-	return asc_result_remove_component (result, cpt);
+	return asc_result_remove_component_internal (result, cpt, TRUE);
 }
 
 static gboolean
@@ -624,6 +734,7 @@ asc_result_add_hint_va (AscResult *result,
 			gchar **args_v)
 {
 	AscResultPrivate *priv = GET_PRIVATE (result);
+	g_autoptr(GMutexLocker) locker = NULL;
 	const gchar *cur_key;
 	const gchar *cur_val;
 	g_autoptr(AscHint) hint = NULL;
@@ -660,6 +771,8 @@ asc_result_add_hint_va (AscResult *result,
 			cur_key = args_v[i++];
 	}
 
+	locker = g_mutex_locker_new (&priv->mutex);
+
 	hints = g_hash_table_lookup (priv->hints, component_id);
 	if (hints == NULL) {
 		hints = g_ptr_array_new_with_free_func (g_object_unref);
@@ -669,9 +782,9 @@ asc_result_add_hint_va (AscResult *result,
 	/* we stop dealing with this component as soon as we encounter a fatal error. */
 	if (asc_hint_is_error (hint)) {
 		if (cpt == NULL)
-			asc_result_remove_component_by_id (result, component_id);
-		else
-			asc_result_remove_component (result, cpt);
+			cpt = g_hash_table_lookup (priv->cpts, component_id);
+		if (cpt != NULL)
+			asc_result_remove_component_internal (result, cpt, TRUE);
 		ret = FALSE;
 	}
 
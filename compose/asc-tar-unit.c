@@ -0,0 +1,683 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:asc-tar-unit
+ * @short_description: A data source unit reading files from a tarball
+ * @include: appstream-compose.h
+ *
+ * This unit type serves file data directly out of a (possibly compressed)
+ * POSIX tar archive, without ever extracting the archive to disk.
+ * On open, the archive is scanned once and an in-memory index of all
+ * file entries is built.
+ *
+ * For uncompressed archives, file contents are later read directly from
+ * the indexed offsets in the archive file. Gzip- and Zstandard-compressed
+ * archives can not be accessed randomly, so their tar stream is held
+ * decompressed in memory while the unit is open.
+ */
+
+#include "config.h"
+#include "asc-tar-unit.h"
+
+#include <gio/gio.h>
+#include <string.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "as-utils-private.h"
+#include "asc-compose.h"
+
+#define ASC_TAR_BLOCK_SIZE 512
+
+/* sanity limit for long-name and pax metadata entries, so a corrupt header
+ * can not request an absurd allocation */
+#define ASC_TAR_META_SIZE_MAX (1024 * 1024)
+
+typedef struct {
+	goffset offset;
+	gsize size;
+} AscTarIndexEntry;
+
+typedef struct {
+	gchar *fname;
+	GHashTable *index; /* utf8 -> AscTarIndexEntry */
+	GHashTable *dirs;  /* set of directory entry names */
+	GBytes *tar_data;  /* decompressed archive, %NULL if the archive file is uncompressed */
+} AscTarUnitPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (AscTarUnit, asc_tar_unit, ASC_TYPE_UNIT)
+#define GET_PRIVATE(o) (asc_tar_unit_get_instance_private (o))
+
+static gboolean asc_tar_unit_open (AscUnit *unit, GError **error);
+static void asc_tar_unit_close (AscUnit *unit);
+
+static gboolean asc_tar_unit_file_exists (AscUnit *unit, const gchar *filename);
+static gboolean asc_tar_unit_dir_exists (AscUnit *unit, const gchar *dirname);
+static GBytes *asc_tar_unit_read_data (AscUnit *unit, const gchar *filename, GError **error);
+
+static void
+asc_tar_unit_init (AscTarUnit *tarunit)
+{
+	AscTarUnitPrivate *priv = GET_PRIVATE (tarunit);
+
+	priv->index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	priv->dirs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+}
+
+static void
+asc_tar_unit_finalize (GObject *object)
+{
+	AscTarUnit *tarunit = ASC_TAR_UNIT (object);
+	AscTarUnitPrivate *priv = GET_PRIVATE (tarunit);
+
+	g_free (priv->fname);
+	g_hash_table_unref (priv->index);
+	g_hash_table_unref (priv->dirs);
+	if (priv->tar_data != NULL)
+		g_bytes_unref (priv->tar_data);
+
+	G_OBJECT_CLASS (asc_tar_unit_parent_class)->finalize (object);
+}
+
+static void
+asc_tar_unit_class_init (AscTarUnitClass *klass)
+{
+	AscUnitClass *unit_class;
+	GObjectClass *object_class;
+
+	object_class = G_OBJECT_CLASS (klass);
+	object_class->finalize = asc_tar_unit_finalize;
+
+	unit_class = ASC_UNIT_CLASS (klass);
+	unit_class->open = asc_tar_unit_open;
+	unit_class->close = asc_tar_unit_close;
+	unit_class->file_exists = asc_tar_unit_file_exists;
+	unit_class->dir_exists = asc_tar_unit_dir_exists;
+	unit_class->read_data = asc_tar_unit_read_data;
+}
+
+/**
+ * asc_tar_unit_normalize_name:
+ *
+ * Normalize a tar entry name into the absolute-path form used by
+ * the other unit types, e.g. `./usr/share/metainfo` becomes
+ * `/usr/share/metainfo`. Returns %NULL for empty or root entries.
+ */
+static gchar *
+asc_tar_unit_normalize_name (const gchar *name)
+{
+	gchar *result;
+	gsize len;
+
+	if (g_str_has_prefix (name, "./"))
+		name += 1;
+	if (name[0] == '\0' || g_strcmp0 (name, ".") == 0 || g_strcmp0 (name, "/") == 0)
+		return NULL;
+
+	if (name[0] == '/')
+		result = g_strdup (name);
+	else
+		result = g_strconcat ("/", name, NULL);
+
+	/* drop any trailing slash from directory entries */
+	len = strlen (result);
+	if (result[len - 1] == '/')
+		result[len - 1] = '\0';
+
+	return result;
+}
+
+/**
+ * asc_tar_unit_skip_data:
+ *
+ * Skip over exactly the given amount of bytes in the archive stream.
+ */
+static gboolean
+asc_tar_unit_skip_data (GInputStream *stream, gsize size, goffset *pos, GError **error)
+{
+	gsize remaining = size;
+
+	while (remaining > 0) {
+		gssize skipped = g_input_stream_skip (stream, remaining, NULL, error);
+		if (skipped < 0)
+			return FALSE;
+		if (skipped == 0) {
+			g_set_error_literal (error,
+					     ASC_COMPOSE_ERROR,
+					     ASC_COMPOSE_ERROR_FAILED,
+					     "Tar archive was truncated.");
+			return FALSE;
+		}
+		remaining -= (gsize) skipped;
+		*pos += skipped;
+	}
+
+	return TRUE;
+}
+
+/**
+ * asc_tar_unit_read_meta_entry:
+ *
+ * Read the data of a metadata entry (GNU long name or pax extended header)
+ * into a NUL-terminated buffer, consuming its block padding as well.
+ * The size is bounded, so a corrupt header can not request an absurd
+ * allocation.
+ */
+static gchar *
+asc_tar_unit_read_meta_entry (GInputStream *stream, gsize size, goffset *pos, GError **error)
+{
+	g_autofree gchar *data = NULL;
+	gsize padding = (ASC_TAR_BLOCK_SIZE - (size % ASC_TAR_BLOCK_SIZE)) % ASC_TAR_BLOCK_SIZE;
+	gsize bytes_read;
+
+	if (size > ASC_TAR_META_SIZE_MAX) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "Tar archive metadata entry claims an implausible size of %" G_GSIZE_FORMAT " bytes.",
+			     size);
+		return NULL;
+	}
+
+	data = g_malloc0 (size + 1);
+	if (!g_input_stream_read_all (stream, data, size, &bytes_read, NULL, error))
+		return NULL;
+	*pos += bytes_read;
+	if (padding > 0 && !asc_tar_unit_skip_data (stream, padding, pos, error))
+		return NULL;
+
+	return g_steal_pointer (&data);
+}
+
+/**
+ * asc_tar_unit_pax_get_path:
+ *
+ * Extract the value of the `path` record from pax extended header data.
+ * Each record has the form "LENGTH keyword=value\n", with LENGTH being the
+ * decimal byte count of the whole record including the length field itself.
+ *
+ * Returns: (nullable): the path value, or %NULL if the data has no path record.
+ */
+static gchar *
+asc_tar_unit_pax_get_path (const gchar *data, gsize len)
+{
+	gsize pos = 0;
+
+	while (pos < len) {
+		gchar *endptr = NULL;
+		guint64 rec_len = g_ascii_strtoull (data + pos, &endptr, 10);
+		const gchar *kv;
+		gsize kv_len;
+
+		if (endptr == NULL || *endptr != ' ' || rec_len == 0 || rec_len > len - pos)
+			break;
+		kv = endptr + 1;
+		kv_len = (data + pos + rec_len) - kv;
+		if (kv_len > 0 && kv[kv_len - 1] == '\n')
+			kv_len--;
+		if (kv_len > strlen ("path=") && memcmp (kv, "path=", 5) == 0)
+			return g_strndup (kv + 5, kv_len - 5);
+		pos += rec_len;
+	}
+
+	return NULL;
+}
+
+/**
+ * asc_tar_unit_index_archive:
+ *
+ * Walk over all entry headers of the (uncompressed) tar stream and
+ * record the name, data offset and size of every file entry.
+ */
+static gboolean
+asc_tar_unit_index_archive (AscTarUnit *tarunit,
+			    GInputStream *stream,
+			    GPtrArray *contents,
+			    guint64 *size_total,
+			    GError **error)
+{
+	AscTarUnitPrivate *priv = GET_PRIVATE (tarunit);
+	g_autofree gchar *pending_name = NULL;
+	goffset pos = 0;
+
+	while (TRUE) {
+		guint8 block[ASC_TAR_BLOCK_SIZE];
+		gchar size_field[13];
+		gchar name_buf[257];
+		g_autofree gchar *entry_name = NULL;
+		gboolean is_zero = TRUE;
+		gsize bytes_read;
+		gsize size;
+		gchar typeflag;
+
+		if (!g_input_stream_read_all (stream,
+					      block,
+					      sizeof (block),
+					      &bytes_read,
+					      NULL,
+					      error))
+			return FALSE;
+		if (bytes_read == 0)
+			break;
+		if (bytes_read != sizeof (block)) {
+			g_set_error_literal (error,
+					     ASC_COMPOSE_ERROR,
+					     ASC_COMPOSE_ERROR_FAILED,
+					     "Tar archive was truncated.");
+			return FALSE;
+		}
+		pos += bytes_read;
+
+		/* a zero-filled block marks the end of the archive */
+		for (guint i = 0; i < sizeof (block); i++) {
+			if (block[i] != 0) {
+				is_zero = FALSE;
+				break;
+			}
+		}
+		if (is_zero)
+			break;
+
+		/* the size field is a NUL/space-terminated octal number */
+		memcpy (size_field, block + 124, 12);
+		size_field[12] = '\0';
+		size = (gsize) g_ascii_strtoull (size_field, NULL, 8);
+		typeflag = (gchar) block[156];
+
+		if (typeflag == 'L') {
+			/* GNU long name: the data is the name of the next entry */
+			g_autofree gchar *lname = NULL;
+
+			lname = asc_tar_unit_read_meta_entry (stream, size, &pos, error);
+			if (lname == NULL)
+				return FALSE;
+			g_free (pending_name);
+			pending_name = g_steal_pointer (&lname);
+			continue;
+		}
+
+		if (typeflag == 'x') {
+			/* pax extended header: a path record overrides the
+			 * length-limited ustar name field of the next entry */
+			g_autofree gchar *pax_data = NULL;
+			g_autofree gchar *pax_path = NULL;
+
+			pax_data = asc_tar_unit_read_meta_entry (stream, size, &pos, error);
+			if (pax_data == NULL)
+				return FALSE;
+			pax_path = asc_tar_unit_pax_get_path (pax_data, size);
+			if (pax_path != NULL) {
+				g_free (pending_name);
+				pending_name = g_steal_pointer (&pax_path);
+			}
+			continue;
+		}
+
+		/* assemble the entry name from the ustar prefix & name fields,
+		 * unless a long-name or pax entry already provided it */
+		if (pending_name != NULL) {
+			entry_name = g_steal_pointer (&pending_name);
+		} else {
+			gchar prefix[156];
+			memcpy (prefix, block + 345, 155);
+			prefix[155] = '\0';
+			memcpy (name_buf, block, 100);
+			name_buf[100] = '\0';
+			if (prefix[0] != '\0')
+				entry_name = g_strconcat (prefix, "/", name_buf, NULL);
+			else
+				entry_name = g_strdup (name_buf);
+		}
+
+		if (typeflag == '0' || typeflag == '\0') {
+			/* regular file */
+			gchar *norm_name = asc_tar_unit_normalize_name (entry_name);
+			if (norm_name != NULL) {
+				AscTarIndexEntry *entry = g_new0 (AscTarIndexEntry, 1);
+				entry->offset = pos;
+				entry->size = size;
+				g_ptr_array_add (contents, g_strdup (norm_name));
+				g_hash_table_insert (priv->index, norm_name, entry);
+				*size_total += size;
+			}
+		} else if (typeflag == '5') {
+			/* directory */
+			gchar *norm_name = asc_tar_unit_normalize_name (entry_name);
+			if (norm_name != NULL)
+				g_hash_table_add (priv->dirs, norm_name);
+		}
+
+		/* skip the entry data, padded to the tar block size
+		 * (symlinks, pax global headers & other entry types are simply ignored) */
+		if (size > 0) {
+			gsize padded_size = size;
+			if (padded_size % ASC_TAR_BLOCK_SIZE != 0)
+				padded_size += ASC_TAR_BLOCK_SIZE -
+					       (padded_size % ASC_TAR_BLOCK_SIZE);
+			if (!asc_tar_unit_skip_data (stream, padded_size, &pos, error))
+				return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * asc_tar_unit_decompress_gzip:
+ *
+ * Decompress a gzip-compressed archive into memory.
+ */
+static GBytes *
+asc_tar_unit_decompress_gzip (GInputStream *stream, GError **error)
+{
+	g_autoptr(GZlibDecompressor) decomp = NULL;
+	g_autoptr(GInputStream) conv_stream = NULL;
+	g_autoptr(GByteArray) buf = NULL;
+	guint8 chunk[64 * 1024];
+	gssize len;
+
+	decomp = g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP);
+	conv_stream = g_converter_input_stream_new (stream, G_CONVERTER (decomp));
+
+	buf = g_byte_array_new ();
+	while ((len = g_input_stream_read (conv_stream, chunk, sizeof (chunk), NULL, error)) > 0)
+		g_byte_array_append (buf, chunk, (guint) len);
+	if (len < 0)
+		return NULL;
+
+	return g_byte_array_free_to_bytes (g_steal_pointer (&buf));
+}
+
+#ifdef HAVE_ZSTD
+/**
+ * asc_tar_unit_decompress_zstd:
+ *
+ * Decompress a Zstandard-compressed archive into memory.
+ */
+static GBytes *
+asc_tar_unit_decompress_zstd (GInputStream *stream, GError **error)
+{
+	ZSTD_DStream *zds;
+	g_autoptr(GByteArray) buf = NULL;
+	g_autofree guint8 *in_chunk = NULL;
+	g_autofree guint8 *out_chunk = NULL;
+	gsize in_chunk_size = ZSTD_DStreamInSize ();
+	gsize out_chunk_size = ZSTD_DStreamOutSize ();
+	gssize len;
+
+	zds = ZSTD_createDStream ();
+	in_chunk = g_malloc (in_chunk_size);
+	out_chunk = g_malloc (out_chunk_size);
+
+	buf = g_byte_array_new ();
+	while ((len = g_input_stream_read (stream, in_chunk, in_chunk_size, NULL, error)) > 0) {
+		ZSTD_inBuffer inb = { in_chunk, (gsize) len, 0 };
+
+		while (inb.pos < inb.size) {
+			ZSTD_outBuffer outb = { out_chunk, out_chunk_size, 0 };
+			gsize zret = ZSTD_decompressStream (zds, &outb, &inb);
+			if (ZSTD_isError (zret)) {
+				g_set_error (error,
+					     ASC_COMPOSE_ERROR,
+					     ASC_COMPOSE_ERROR_FAILED,
+					     "Zstd decompression failed: %s",
+					     ZSTD_getErrorName (zret));
+				ZSTD_freeDStream (zds);
+				return NULL;
+			}
+			if (outb.pos > 0)
+				g_byte_array_append (buf, out_chunk, (guint) outb.pos);
+		}
+	}
+	ZSTD_freeDStream (zds);
+	if (len < 0)
+		return NULL;
+
+	return g_byte_array_free_to_bytes (g_steal_pointer (&buf));
+}
+#endif
+
+static gboolean
+asc_tar_unit_open (AscUnit *unit, GError **error)
+{
+	AscTarUnitPrivate *priv = GET_PRIVATE (ASC_TAR_UNIT (unit));
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GFileInputStream) fis = NULL;
+	g_autoptr(GPtrArray) contents = NULL;
+	guint8 magic[4] = { 0 };
+	gsize bytes_read;
+	guint64 size_total = 0;
+
+	if (priv->fname == NULL) {
+		g_set_error_literal (error,
+				     ASC_COMPOSE_ERROR,
+				     ASC_COMPOSE_ERROR_FAILED,
+				     "No tarball filename was set for this unit.");
+		return FALSE;
+	}
+
+	file = g_file_new_for_path (priv->fname);
+	fis = g_file_read (file, NULL, error);
+	if (fis == NULL)
+		return FALSE;
+
+	/* sniff the compression format from the magic bytes */
+	if (!g_input_stream_read_all (G_INPUT_STREAM (fis),
+				      magic,
+				      sizeof (magic),
+				      &bytes_read,
+				      NULL,
+				      error))
+		return FALSE;
+	if (!g_seekable_seek (G_SEEKABLE (fis), 0, G_SEEK_SET, NULL, error))
+		return FALSE;
+
+	g_debug ("Creating contents index for tarball: %s", priv->fname);
+	if (magic[0] == 0x1f && magic[1] == 0x8b) {
+		priv->tar_data = asc_tar_unit_decompress_gzip (G_INPUT_STREAM (fis), error);
+		if (priv->tar_data == NULL)
+			return FALSE;
+	} else if (magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+#ifdef HAVE_ZSTD
+		priv->tar_data = asc_tar_unit_decompress_zstd (G_INPUT_STREAM (fis), error);
+		if (priv->tar_data == NULL)
+			return FALSE;
+#else
+		g_set_error_literal (error,
+				     ASC_COMPOSE_ERROR,
+				     ASC_COMPOSE_ERROR_FAILED,
+				     "Unable to read Zstandard-compressed tarball: AppStream was "
+				     "built without zstd support.");
+		return FALSE;
+#endif
+	}
+
+	contents = g_ptr_array_new_with_free_func (g_free);
+	if (priv->tar_data != NULL) {
+		g_autoptr(GInputStream) mis = g_memory_input_stream_new_from_bytes (priv->tar_data);
+		if (!asc_tar_unit_index_archive (ASC_TAR_UNIT (unit),
+						 mis,
+						 contents,
+						 &size_total,
+						 error))
+			return FALSE;
+	} else {
+		if (!asc_tar_unit_index_archive (ASC_TAR_UNIT (unit),
+						 G_INPUT_STREAM (fis),
+						 contents,
+						 &size_total,
+						 error))
+			return FALSE;
+	}
+	g_debug ("Index done for tarball: %s", priv->fname);
+
+	asc_unit_set_contents (unit, contents);
+
+	/* use the amount of data we serve as scheduling hint */
+	asc_unit_set_size_hint (unit, size_total);
+
+	return TRUE;
+}
+
+static void
+asc_tar_unit_close (AscUnit *unit)
+{
+	AscTarUnitPrivate *priv = GET_PRIVATE (ASC_TAR_UNIT (unit));
+
+	/* drop the index and any decompressed archive data - the unit
+	 * can be opened again later, which will rebuild both */
+	g_hash_table_remove_all (priv->index);
+	g_hash_table_remove_all (priv->dirs);
+	if (priv->tar_data != NULL) {
+		g_bytes_unref (priv->tar_data);
+		priv->tar_data = NULL;
+	}
+}
+
+static gboolean
+asc_tar_unit_file_exists (AscUnit *unit, const gchar *filename)
+{
+	AscTarUnitPrivate *priv = GET_PRIVATE (ASC_TAR_UNIT (unit));
+
+	return g_hash_table_contains (priv->index, filename);
+}
+
+static gboolean
+asc_tar_unit_dir_exists (AscUnit *unit, const gchar *dirname)
+{
+	AscTarUnitPrivate *priv = GET_PRIVATE (ASC_TAR_UNIT (unit));
+	g_autofree gchar *dir_prefix = NULL;
+	GHashTableIter iter;
+	gpointer key;
+
+	if (g_hash_table_contains (priv->dirs, dirname))
+		return TRUE;
+
+	/* some archives carry no explicit directory entries, so a
+	 * directory also exists if any indexed file is below it */
+	dir_prefix = g_str_has_suffix (dirname, G_DIR_SEPARATOR_S)
+			 ? g_strdup (dirname)
+			 : g_strconcat (dirname, G_DIR_SEPARATOR_S, NULL);
+
+	g_hash_table_iter_init (&iter, priv->index);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		if (g_str_has_prefix ((const gchar *) key, dir_prefix))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static GBytes *
+asc_tar_unit_read_data (AscUnit *unit, const gchar *filename, GError **error)
+{
+	AscTarUnitPrivate *priv = GET_PRIVATE (ASC_TAR_UNIT (unit));
+	AscTarIndexEntry *entry;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GFileInputStream) fis = NULL;
+	g_autofree guint8 *data = NULL;
+	gsize bytes_read;
+
+	entry = g_hash_table_lookup (priv->index, filename);
+	if (entry == NULL) {
+		g_set_error (error,
+			     G_IO_ERROR,
+			     G_IO_ERROR_NOT_FOUND,
+			     "No data found for '%s' in tarball unit.",
+			     filename);
+		return NULL;
+	}
+
+	/* compressed archives are held decompressed in memory, so we
+	 * can hand out a zero-copy view of the file data */
+	if (priv->tar_data != NULL)
+		return g_bytes_new_from_bytes (priv->tar_data, (gsize) entry->offset, entry->size);
+
+	file = g_file_new_for_path (priv->fname);
+	fis = g_file_read (file, NULL, error);
+	if (fis == NULL)
+		return NULL;
+	if (!g_seekable_seek (G_SEEKABLE (fis), entry->offset, G_SEEK_SET, NULL, error))
+		return NULL;
+
+	data = g_malloc (entry->size);
+	if (!g_input_stream_read_all (G_INPUT_STREAM (fis),
+				      data,
+				      entry->size,
+				      &bytes_read,
+				      NULL,
+				      error))
+		return NULL;
+	if (bytes_read != entry->size) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "Tar archive was truncated while reading '%s'.",
+			     filename);
+		return NULL;
+	}
+
+	return g_bytes_new_take (g_steal_pointer (&data), entry->size);
+}
+
+/**
+ * asc_tar_unit_get_filename:
+ * @tarunit: an #AscTarUnit instance.
+ *
+ * Get the tarball filename for this unit.
+ **/
+const gchar *
+asc_tar_unit_get_filename (AscTarUnit *tarunit)
+{
+	AscTarUnitPrivate *priv = GET_PRIVATE (tarunit);
+	return priv->fname;
+}
+
+/**
+ * asc_tar_unit_set_filename:
+ * @tarunit: an #AscTarUnit instance.
+ * @fname: Path to a tar archive, optionally gzip- or zstd-compressed.
+ *
+ * Sets the tarball filename for this unit.
+ **/
+void
+asc_tar_unit_set_filename (AscTarUnit *tarunit, const gchar *fname)
+{
+	AscTarUnitPrivate *priv = GET_PRIVATE (tarunit);
+	as_assign_string_safe (priv->fname, fname);
+	if (asc_unit_get_bundle_id (ASC_UNIT (tarunit)) == NULL)
+		asc_unit_set_bundle_id (ASC_UNIT (tarunit), priv->fname);
+}
+
+/**
+ * asc_tar_unit_new:
+ *
+ * Creates a new #AscTarUnit.
+ **/
+AscTarUnit *
+asc_tar_unit_new (const gchar *fname)
+{
+	AscTarUnit *tarunit;
+	tarunit = g_object_new (ASC_TYPE_TAR_UNIT, NULL);
+	asc_tar_unit_set_filename (ASC_TAR_UNIT (tarunit), fname);
+	return ASC_TAR_UNIT (tarunit);
+}
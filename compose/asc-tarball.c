@@ -0,0 +1,500 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:asc-tarball
+ * @short_description: Streaming tarball writer for compose artifacts.
+ * @include: appstream-compose.h
+ *
+ * Write the contents of a directory into a POSIX (ustar) tarball,
+ * streaming each file through the archive without collecting all data
+ * in memory first.
+ * The compression is selected from the target filename: `.zst` creates
+ * a Zstandard archive using multithreaded compression (if AppStream was
+ * built with zstd support), `.gz` creates a gzip archive, any other
+ * name creates an uncompressed tarball.
+ */
+
+#include "config.h"
+#include "asc-tarball.h"
+
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "asc-compose.h"
+
+#define ASC_TAR_BLOCK_SIZE 512
+
+typedef struct {
+	GOutputStream *base_stream; /* stream writing to the target file */
+	GOutputStream *tar_stream;  /* stream tar data goes to, may equal base_stream */
+#ifdef HAVE_ZSTD
+	ZSTD_CCtx *zcctx;
+	guint8 *zbuf;
+	gsize zbuf_size;
+#endif
+} AscTarSink;
+
+/**
+ * asc_tar_sink_write:
+ *
+ * Push raw tar data into the (possibly compressing) sink.
+ */
+static gboolean
+asc_tar_sink_write (AscTarSink *sink, const guint8 *data, gsize len, GError **error)
+{
+#ifdef HAVE_ZSTD
+	if (sink->zcctx != NULL) {
+		ZSTD_inBuffer inb = { data, len, 0 };
+
+		while (inb.pos < inb.size) {
+			ZSTD_outBuffer outb = { sink->zbuf, sink->zbuf_size, 0 };
+			gsize zret = ZSTD_compressStream2 (sink->zcctx,
+							   &outb,
+							   &inb,
+							   ZSTD_e_continue);
+			if (ZSTD_isError (zret)) {
+				g_set_error (error,
+					     ASC_COMPOSE_ERROR,
+					     ASC_COMPOSE_ERROR_FAILED,
+					     "Zstd compression failed: %s",
+					     ZSTD_getErrorName (zret));
+				return FALSE;
+			}
+			if (outb.pos > 0 && !g_output_stream_write_all (sink->base_stream,
+									sink->zbuf,
+									outb.pos,
+									NULL,
+									NULL,
+									error))
+				return FALSE;
+		}
+		return TRUE;
+	}
+#endif
+	return g_output_stream_write_all (sink->tar_stream, data, len, NULL, NULL, error);
+}
+
+/**
+ * asc_tar_sink_close:
+ *
+ * Finalize any pending compressed data and close the target file.
+ */
+static gboolean
+asc_tar_sink_close (AscTarSink *sink, GError **error)
+{
+#ifdef HAVE_ZSTD
+	if (sink->zcctx != NULL) {
+		ZSTD_inBuffer inb = { NULL, 0, 0 };
+		gsize zret;
+
+		do {
+			ZSTD_outBuffer outb = { sink->zbuf, sink->zbuf_size, 0 };
+			zret = ZSTD_compressStream2 (sink->zcctx, &outb, &inb, ZSTD_e_end);
+			if (ZSTD_isError (zret)) {
+				g_set_error (error,
+					     ASC_COMPOSE_ERROR,
+					     ASC_COMPOSE_ERROR_FAILED,
+					     "Zstd compression failed: %s",
+					     ZSTD_getErrorName (zret));
+				return FALSE;
+			}
+			if (outb.pos > 0 && !g_output_stream_write_all (sink->base_stream,
+									sink->zbuf,
+									outb.pos,
+									NULL,
+									NULL,
+									error))
+				return FALSE;
+		} while (zret != 0);
+	}
+#endif
+
+	if (sink->tar_stream != sink->base_stream &&
+	    !g_output_stream_close (sink->tar_stream, NULL, error))
+		return FALSE;
+	return g_output_stream_close (sink->base_stream, NULL, error);
+}
+
+static void
+asc_tar_sink_free (AscTarSink *sink)
+{
+	if (sink->tar_stream != NULL && sink->tar_stream != sink->base_stream)
+		g_object_unref (sink->tar_stream);
+	if (sink->base_stream != NULL)
+		g_object_unref (sink->base_stream);
+#ifdef HAVE_ZSTD
+	if (sink->zcctx != NULL)
+		ZSTD_freeCCtx (sink->zcctx);
+	g_free (sink->zbuf);
+#endif
+	g_free (sink);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (AscTarSink, asc_tar_sink_free)
+
+/**
+ * asc_tar_sink_open:
+ *
+ * Open the target file and set up the compressor selected by
+ * its filename extension.
+ */
+static AscTarSink *
+asc_tar_sink_open (const gchar *fname, GError **error)
+{
+	g_autoptr(AscTarSink) sink = g_new0 (AscTarSink, 1);
+	g_autoptr(GFile) file = g_file_new_for_path (fname);
+	GFileOutputStream *fos;
+
+	fos = g_file_replace (file, NULL, FALSE, G_FILE_CREATE_REPLACE_DESTINATION, NULL, error);
+	if (fos == NULL)
+		return NULL;
+	sink->base_stream = G_OUTPUT_STREAM (fos);
+	sink->tar_stream = sink->base_stream;
+
+	if (g_str_has_suffix (fname, ".zst")) {
+#ifdef HAVE_ZSTD
+		gsize zret;
+
+		sink->zcctx = ZSTD_createCCtx ();
+		sink->zbuf_size = ZSTD_CStreamOutSize ();
+		sink->zbuf = g_malloc (sink->zbuf_size);
+
+		/* distribute compression work over all cores - if this zstd build has
+		 * no threading support, the parameter is simply ignored */
+		zret = ZSTD_CCtx_setParameter (sink->zcctx,
+					       ZSTD_c_nbWorkers,
+					       g_get_num_processors ());
+		if (ZSTD_isError (zret))
+			g_debug ("Unable to enable multithreaded zstd compression: %s",
+				 ZSTD_getErrorName (zret));
+#else
+		g_set_error_literal (error,
+				     ASC_COMPOSE_ERROR,
+				     ASC_COMPOSE_ERROR_FAILED,
+				     "Unable to create Zstandard-compressed tarball: AppStream was "
+				     "built without zstd support.");
+		return NULL;
+#endif
+	} else if (g_str_has_suffix (fname, ".gz")) {
+		g_autoptr(GZlibCompressor) compressor = g_zlib_compressor_new (
+		    G_ZLIB_COMPRESSOR_FORMAT_GZIP,
+		    -1);
+		sink->tar_stream = g_converter_output_stream_new (sink->base_stream,
+								  G_CONVERTER (compressor));
+	}
+
+	return g_steal_pointer (&sink);
+}
+
+/**
+ * asc_tar_write_header:
+ *
+ * Emit a single ustar header block for a file or directory entry.
+ */
+static gboolean
+asc_tar_write_header (AscTarSink *sink,
+		      const gchar *name,
+		      gsize size,
+		      time_t mtime,
+		      guint mode,
+		      gchar typeflag,
+		      GError **error)
+{
+	guint8 block[ASC_TAR_BLOCK_SIZE];
+	gsize name_len = strlen (name);
+	const gchar *sname = name;
+	guint checksum = 0;
+
+	memset (block, 0, sizeof (block));
+
+	/* long names are split at a path separator into the ustar prefix field */
+	if (name_len > 100) {
+		const gchar *split = NULL;
+		for (const gchar *c = name + name_len - 101; c >= name; c--) {
+			if (*c == '/') {
+				split = c;
+				break;
+			}
+		}
+		if (split == NULL || split - name > 155) {
+			g_set_error (error,
+				     ASC_COMPOSE_ERROR,
+				     ASC_COMPOSE_ERROR_FAILED,
+				     "Path is too long for a tar archive entry: %s",
+				     name);
+			return FALSE;
+		}
+		memcpy (block + 345, name, split - name);
+		sname = split + 1;
+	}
+	memcpy (block, sname, strlen (sname));
+
+	g_snprintf ((gchar *) block + 100, 8, "%07o", mode & 07777);
+	g_snprintf ((gchar *) block + 108, 8, "%07o", 0); /* uid */
+	g_snprintf ((gchar *) block + 116, 8, "%07o", 0); /* gid */
+	g_snprintf ((gchar *) block + 124, 12, "%011" G_GSIZE_MODIFIER "o", size);
+	g_snprintf ((gchar *) block + 136, 12, "%011lo", (gulong) mtime);
+	block[156] = typeflag;
+	memcpy (block + 257, "ustar", 6);
+	memcpy (block + 263, "00", 2);
+	memcpy (block + 265, "root", 4);
+	memcpy (block + 297, "root", 4);
+
+	/* the checksum is computed with its own field set to spaces */
+	memset (block + 148, ' ', 8);
+	for (guint i = 0; i < ASC_TAR_BLOCK_SIZE; i++)
+		checksum += block[i];
+	g_snprintf ((gchar *) block + 148, 8, "%06o", checksum);
+	block[154] = '\0';
+	block[155] = ' ';
+
+	return asc_tar_sink_write (sink, block, ASC_TAR_BLOCK_SIZE, error);
+}
+
+/**
+ * asc_tar_write_file:
+ *
+ * Stream a single file into the archive, padding it to the tar block size.
+ * The file is opened relative to the already-open root directory descriptor,
+ * so no full path has to be resolved again per entry.
+ */
+static gboolean
+asc_tar_write_file (AscTarSink *sink,
+		    gint root_dirfd,
+		    const gchar *fname,
+		    const gchar *arcname,
+		    const GStatBuf *sb,
+		    GError **error)
+{
+	gint fd;
+	guint8 buf[64 * 1024];
+	gsize bytes_total = 0;
+	gssize len;
+
+	if (!asc_tar_write_header (sink,
+				   arcname,
+				   (gsize) sb->st_size,
+				   sb->st_mtime,
+				   sb->st_mode,
+				   '0',
+				   error))
+		return FALSE;
+
+	fd = openat (root_dirfd, fname, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "Unable to open '%s' for archiving: %s",
+			     fname,
+			     g_strerror (errno));
+		return FALSE;
+	}
+
+	while ((len = read (fd, buf, sizeof (buf))) != 0) {
+		if (len < 0) {
+			if (errno == EINTR)
+				continue;
+			g_set_error (error,
+				     ASC_COMPOSE_ERROR,
+				     ASC_COMPOSE_ERROR_FAILED,
+				     "Unable to read '%s' for archiving: %s",
+				     fname,
+				     g_strerror (errno));
+			close (fd);
+			return FALSE;
+		}
+		if (!asc_tar_sink_write (sink, buf, (gsize) len, error)) {
+			close (fd);
+			return FALSE;
+		}
+		bytes_total += (gsize) len;
+	}
+	close (fd);
+
+	if (bytes_total != (gsize) sb->st_size) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "File '%s' changed size while it was being archived.",
+			     fname);
+		return FALSE;
+	}
+
+	/* pad the entry to the tar block size */
+	if (bytes_total % ASC_TAR_BLOCK_SIZE != 0) {
+		guint8 padding[ASC_TAR_BLOCK_SIZE] = { 0 };
+		gsize pad_len = ASC_TAR_BLOCK_SIZE - (bytes_total % ASC_TAR_BLOCK_SIZE);
+		if (!asc_tar_sink_write (sink, padding, pad_len, error))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * asc_tarball_collect_entries:
+ *
+ * Recursively collect the relative paths of all entries below the root directory.
+ */
+static gboolean
+asc_tarball_collect_entries (const gchar *root_dir,
+			     const gchar *subdir,
+			     GPtrArray *entries,
+			     GError **error)
+{
+	g_autofree gchar *full_dir = NULL;
+	g_autoptr(GDir) dir = NULL;
+	const gchar *fname;
+
+	full_dir = (subdir == NULL) ? g_strdup (root_dir)
+				    : g_build_filename (root_dir, subdir, NULL);
+	dir = g_dir_open (full_dir, 0, error);
+	if (dir == NULL)
+		return FALSE;
+
+	while ((fname = g_dir_read_name (dir)) != NULL) {
+		g_autofree gchar *rel_path = NULL;
+		g_autofree gchar *full_path = NULL;
+
+		rel_path = (subdir == NULL) ? g_strdup (fname)
+					    : g_build_filename (subdir, fname, NULL);
+		full_path = g_build_filename (root_dir, rel_path, NULL);
+
+		if (g_file_test (full_path, G_FILE_TEST_IS_DIR)) {
+			g_ptr_array_add (entries, g_strdup (rel_path));
+			if (!asc_tarball_collect_entries (root_dir, rel_path, entries, error))
+				return FALSE;
+		} else if (g_file_test (full_path, G_FILE_TEST_IS_REGULAR)) {
+			g_ptr_array_add (entries, g_strdup (rel_path));
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * asc_tarball_entry_cmp:
+ */
+static gint
+asc_tarball_entry_cmp (gconstpointer a, gconstpointer b)
+{
+	return g_strcmp0 (*((const gchar *const *) a), *((const gchar *const *) b));
+}
+
+/**
+ * asc_tarball_write_from_dir:
+ * @tarball_fname: the filename of the tarball to create.
+ * @src_dir: the directory to archive.
+ * @error: A #GError or %NULL.
+ *
+ * Pack all files below @src_dir into a tarball, with their paths
+ * relative to @src_dir. Entries are streamed one by one, so memory
+ * usage stays constant regardless of the archive size.
+ *
+ * The archive compression is derived from @tarball_fname: a `.zst`
+ * suffix selects multithreaded Zstandard compression, `.gz` selects
+ * gzip and any other name produces an uncompressed archive.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+asc_tarball_write_from_dir (const gchar *tarball_fname, const gchar *src_dir, GError **error)
+{
+	g_autoptr(AscTarSink) sink = NULL;
+	g_autoptr(GPtrArray) entries = NULL;
+	gint root_dirfd;
+	guint8 eof_blocks[2 * ASC_TAR_BLOCK_SIZE] = { 0 };
+
+	/* collect & sort all entries first, so the archive layout is reproducible */
+	entries = g_ptr_array_new_with_free_func (g_free);
+	if (!asc_tarball_collect_entries (src_dir, NULL, entries, error))
+		return FALSE;
+	g_ptr_array_sort (entries, asc_tarball_entry_cmp);
+
+	/* resolve the source directory once; all entries are opened relative to it */
+	root_dirfd = open (src_dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (root_dirfd < 0) {
+		g_set_error (error,
+			     ASC_COMPOSE_ERROR,
+			     ASC_COMPOSE_ERROR_FAILED,
+			     "Unable to open '%s' for archiving: %s",
+			     src_dir,
+			     g_strerror (errno));
+		return FALSE;
+	}
+
+	sink = asc_tar_sink_open (tarball_fname, error);
+	if (sink == NULL) {
+		close (root_dirfd);
+		return FALSE;
+	}
+
+	for (guint i = 0; i < entries->len; i++) {
+		const gchar *rel_path = g_ptr_array_index (entries, i);
+		GStatBuf sb;
+
+		if (fstatat (root_dirfd, rel_path, &sb, 0) != 0) {
+			g_set_error (error,
+				     ASC_COMPOSE_ERROR,
+				     ASC_COMPOSE_ERROR_FAILED,
+				     "Unable to stat '%s' for archiving: %s",
+				     rel_path,
+				     g_strerror (errno));
+			close (root_dirfd);
+			return FALSE;
+		}
+
+		if (S_ISDIR (sb.st_mode)) {
+			g_autofree gchar *dir_name = g_strconcat (rel_path, "/", NULL);
+			if (!asc_tar_write_header (sink,
+						   dir_name,
+						   0,
+						   sb.st_mtime,
+						   sb.st_mode,
+						   '5',
+						   error)) {
+				close (root_dirfd);
+				return FALSE;
+			}
+		} else {
+			if (!asc_tar_write_file (sink, root_dirfd, rel_path, &sb, error)) {
+				close (root_dirfd);
+				return FALSE;
+			}
+		}
+	}
+	close (root_dirfd);
+
+	/* an end-of-archive marker is two zero-filled blocks */
+	if (!asc_tar_sink_write (sink, eof_blocks, sizeof (eof_blocks), error))
+		return FALSE;
+
+	return asc_tar_sink_close (sink, error);
+}
@@ -35,6 +35,7 @@ typedef struct {
 	gchar *bundle_id_safe;
 	GPtrArray *contents;
 	GPtrArray *relevant_paths;
+	guint64 size_hint;
 
 	gpointer user_data;
 } AscUnitPrivate;
@@ -192,6 +193,43 @@ asc_unit_set_contents (AscUnit *unit, GPtrArray *contents)
 	priv->contents = g_ptr_array_ref (contents);
 }
 
+/**
+ * asc_unit_get_size_hint:
+ * @unit: an #AscUnit instance.
+ *
+ * Get the rough size estimate of this unit, used to schedule
+ * expensive units first when processing units in parallel.
+ *
+ * Returns: the size hint, or 0 if unknown.
+ *
+ * Since: 1.0.5
+ **/
+guint64
+asc_unit_get_size_hint (AscUnit *unit)
+{
+	AscUnitPrivate *priv = GET_PRIVATE (unit);
+	return priv->size_hint;
+}
+
+/**
+ * asc_unit_set_size_hint:
+ * @unit: an #AscUnit instance.
+ * @size_hint: the approximate amount of data in this unit.
+ *
+ * Set a rough estimate of the amount of data contained in this unit,
+ * e.g. its file count or payload size in bytes. The value has no fixed
+ * unit, it is only compared against the hints of other units to order
+ * processing tasks.
+ *
+ * Since: 1.0.5
+ **/
+void
+asc_unit_set_size_hint (AscUnit *unit, guint64 size_hint)
+{
+	AscUnitPrivate *priv = GET_PRIVATE (unit);
+	priv->size_hint = size_hint;
+}
+
 /**
  * asc_unit_get_relevant_paths:
  * @unit: an #AscUnit instance.
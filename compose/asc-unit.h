@@ -60,6 +60,9 @@ void	     asc_unit_set_bundle_id (AscUnit *unit, const gchar *id);
 GPtrArray   *asc_unit_get_contents (AscUnit *unit);
 void	     asc_unit_set_contents (AscUnit *unit, GPtrArray *contents);
 
+guint64	     asc_unit_get_size_hint (AscUnit *unit);
+void	     asc_unit_set_size_hint (AscUnit *unit, guint64 size_hint);
+
 GPtrArray   *asc_unit_get_relevant_paths (AscUnit *unit);
 void	     asc_unit_add_relevant_path (AscUnit *unit, const gchar *path);
 
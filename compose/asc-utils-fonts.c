@@ -42,6 +42,45 @@ struct {
 	{ 0,   0 }
 };
 
+typedef struct {
+	AscCanvas *canvas;
+	gchar *filename;
+	gchar *font_fullname;
+	AsScreenshot *scr;
+	AsImage *img;
+	gchar *error_msg;
+} AscFontScrSaveJob;
+
+static void
+asc_font_scr_save_job_free (AscFontScrSaveJob *job)
+{
+	g_object_unref (job->canvas);
+	g_free (job->filename);
+	g_free (job->font_fullname);
+	g_object_unref (job->scr);
+	g_object_unref (job->img);
+	g_free (job->error_msg);
+	g_free (job);
+}
+
+/**
+ * asc_font_scr_save_job_run_cb:
+ *
+ * Encode and write a rendered font sample to disk. This step is safe
+ * to run in parallel, as each job owns its canvas and the expensive
+ * PNG encoding does not touch Fontconfig.
+ */
+static void
+asc_font_scr_save_job_run_cb (gpointer job_data, gpointer user_data)
+{
+	AscFontScrSaveJob *job = job_data;
+	g_autoptr(GError) tmp_error = NULL;
+
+	g_debug ("Saving font screenshot image: %s", job->filename);
+	if (!asc_canvas_save_png (job->canvas, job->filename, &tmp_error))
+		job->error_msg = g_strdup (tmp_error->message);
+}
+
 /**
  * asc_render_font_screenshots:
  *
@@ -54,7 +93,10 @@ asc_render_font_screenshots (AscResult *cres,
 			     AsComponent *cpt)
 {
 	gboolean first = TRUE;
+	g_autoptr(GPtrArray) save_jobs = NULL;
+
 	g_mkdir_with_parents (cpt_screenshots_path, 0755);
+	save_jobs = g_ptr_array_new_with_free_func ((GDestroyNotify) asc_font_scr_save_job_free);
 
 	for (guint i = 0; i < fonts->len; i++) {
 		const gchar *font_id = NULL;
@@ -110,12 +152,22 @@ asc_render_font_screenshots (AscResult *cres,
 			img_filename = g_build_filename (cpt_screenshots_path, img_name, NULL);
 			img_url = g_build_filename (scr_url_root, img_name, NULL);
 
+			img = as_image_new ();
+			as_image_set_kind (img, AS_IMAGE_KIND_THUMBNAIL);
+			as_image_set_width (img, font_screenshot_sizes[j].width);
+			as_image_set_height (img, font_screenshot_sizes[j].height);
+			as_image_set_url (img, img_url);
+
 			if (!g_file_test (img_filename, G_FILE_TEST_EXISTS)) {
 				g_autoptr(AscCanvas) cv = NULL;
 				g_autoptr(GError) tmp_error = NULL;
+				AscFontScrSaveJob *job = NULL;
 				gboolean ret;
 
-				/* we didn't create a screenshot image yet - let's render it! */
+				/* we didn't create a screenshot image yet - let's render it!
+				 * rendering itself must happen here, serialized by the global
+				 * Fontconfig lock, but we defer the expensive PNG encoding to
+				 * a worker thread. */
 				cv = asc_canvas_new (font_screenshot_sizes[j].width,
 						     font_screenshot_sizes[j].height);
 				ret = asc_canvas_draw_text_line (cv,
@@ -135,31 +187,65 @@ asc_render_font_screenshots (AscResult *cres,
 					continue;
 				}
 
-				g_debug ("Saving font screenshot image: %s", img_name);
-				ret = asc_canvas_save_png (cv, img_filename, &tmp_error);
-				if (!ret) {
-					asc_result_add_hint (cres,
-							     cpt,
-							     "font-render-error",
-							     "name",
-							     asc_font_get_fullname (font),
-							     "error",
-							     tmp_error->message,
-							     NULL);
-					continue;
-				}
+				job = g_new0 (AscFontScrSaveJob, 1);
+				job->canvas = g_object_ref (cv);
+				job->filename = g_strdup (img_filename);
+				job->font_fullname = g_strdup (asc_font_get_fullname (font));
+				job->scr = g_object_ref (scr);
+				job->img = g_object_ref (img);
+				g_ptr_array_add (save_jobs, job);
+				continue;
 			}
 
-			img = as_image_new ();
-			as_image_set_kind (img, AS_IMAGE_KIND_THUMBNAIL);
-			as_image_set_width (img, font_screenshot_sizes[j].width);
-			as_image_set_height (img, font_screenshot_sizes[j].height);
-			as_image_set_url (img, img_url);
-
 			as_screenshot_add_image (scr, img);
 		}
 	}
 
+	/* encode & write all new sample images in parallel */
+	if (save_jobs->len > 0) {
+		guint n_threads = MIN (g_get_num_processors (), save_jobs->len);
+		GThreadPool *tpool = NULL;
+		g_autoptr(GError) pool_error = NULL;
+
+		tpool = g_thread_pool_new (asc_font_scr_save_job_run_cb,
+					   NULL,
+					   n_threads,
+					   FALSE,
+					   &pool_error);
+		if (tpool == NULL) {
+			/* creating the thread pool failed - just save sequentially */
+			g_warning ("Unable to create thread pool for font screenshot encoding: %s",
+				   pool_error->message);
+			for (guint i = 0; i < save_jobs->len; i++)
+				asc_font_scr_save_job_run_cb (g_ptr_array_index (save_jobs, i),
+							      NULL);
+		} else {
+			for (guint i = 0; i < save_jobs->len; i++)
+				g_thread_pool_push (tpool, g_ptr_array_index (save_jobs, i), NULL);
+			/* wait for all encode jobs to finish */
+			g_thread_pool_free (tpool, FALSE, TRUE);
+		}
+
+		/* emit hints & register images on the coordinating thread,
+		 * as AscResult is not thread-safe */
+		for (guint i = 0; i < save_jobs->len; i++) {
+			AscFontScrSaveJob *job = g_ptr_array_index (save_jobs, i);
+
+			if (job->error_msg != NULL) {
+				asc_result_add_hint (cres,
+						     cpt,
+						     "font-render-error",
+						     "name",
+						     job->font_fullname,
+						     "error",
+						     job->error_msg,
+						     NULL);
+				continue;
+			}
+			as_screenshot_add_image (job->scr, job->img);
+		}
+	}
+
 	return TRUE;
 }
 
@@ -33,6 +33,7 @@
 
 #include "as-utils-private.h"
 #include "asc-globals.h"
+#include "asc-directory-unit.h"
 
 typedef struct {
 	gchar *locale;
@@ -41,6 +42,7 @@ typedef struct {
 } AscLocaleEntry;
 
 typedef struct {
+	GMutex mutex;
 	guint max_nstrings;
 	GList *data;
 	GPtrArray *translations; /* no ref */
@@ -66,6 +68,7 @@ asc_locale_ctx_new (void)
 {
 	AscLocaleContext *ctx;
 	ctx = g_new0 (AscLocaleContext, 1);
+	g_mutex_init (&ctx->mutex);
 	ctx->translations = NULL;
 	return ctx;
 }
@@ -74,15 +77,43 @@ static void
 asc_locale_ctx_free (AscLocaleContext *ctx)
 {
 	g_list_free_full (ctx->data, (GDestroyNotify) asc_locale_entry_free);
+	g_mutex_clear (&ctx->mutex);
 	g_free (ctx);
 }
 
 static void
 asc_locale_ctx_add_entry (AscLocaleContext *ctx, AscLocaleEntry *entry)
 {
+	g_mutex_lock (&ctx->mutex);
 	if (entry->nstrings > ctx->max_nstrings)
 		ctx->max_nstrings = entry->nstrings;
 	ctx->data = g_list_prepend (ctx->data, entry);
+	g_mutex_unlock (&ctx->mutex);
+}
+
+typedef struct {
+	AsTranslationKind kind;
+	gchar *locale;
+	gchar *fname;
+} AscLocaleParseJob;
+
+static AscLocaleParseJob *
+asc_locale_parse_job_new (AsTranslationKind kind, const gchar *locale, const gchar *fname)
+{
+	AscLocaleParseJob *job;
+	job = g_slice_new0 (AscLocaleParseJob);
+	job->kind = kind;
+	job->locale = g_strdup (locale);
+	job->fname = g_strdup (fname);
+	return job;
+}
+
+static void
+asc_locale_parse_job_free (AscLocaleParseJob *job)
+{
+	g_free (job->locale);
+	g_free (job->fname);
+	g_slice_free (AscLocaleParseJob, job);
 }
 
 static gint
@@ -150,11 +181,11 @@ asc_l10n_parse_file_gettext (AscLocaleContext *ctx,
 	return TRUE;
 }
 
-static gboolean
-asc_l10n_search_translations_gettext (AscLocaleContext *ctx,
-				      AscUnit *unit,
-				      const gchar *prefix,
-				      GError **error)
+static void
+asc_l10n_collect_jobs_gettext (AscLocaleContext *ctx,
+			       AscUnit *unit,
+			       const gchar *prefix,
+			       GPtrArray *jobs)
 {
 	GPtrArray *contents = NULL;
 	const gsize prefix_len = strlen (prefix) + 1;
@@ -181,12 +212,12 @@ asc_l10n_search_translations_gettext (AscLocaleContext *ctx,
 
 			/* fetch locale name from path */
 			segments = g_strsplit (fname + prefix_len, G_DIR_SEPARATOR_S, 4);
-			if (!asc_l10n_parse_file_gettext (ctx, unit, segments[2], fname, error))
-				return FALSE;
+			g_ptr_array_add (jobs,
+					 asc_locale_parse_job_new (AS_TRANSLATION_KIND_GETTEXT,
+								   segments[2],
+								   fname));
 		}
 	}
-
-	return TRUE;
 }
 
 typedef enum {
@@ -316,11 +347,11 @@ asc_l10n_parse_file_qt (AscLocaleContext *ctx,
 	return TRUE;
 }
 
-static gboolean
-asc_l10n_search_translations_qt (AscLocaleContext *ctx,
-				 AscUnit *unit,
-				 const gchar *prefix,
-				 GError **error)
+static void
+asc_l10n_collect_jobs_qt (AscLocaleContext *ctx,
+			  AscUnit *unit,
+			  const gchar *prefix,
+			  GPtrArray *jobs)
 {
 	GPtrArray *contents = asc_unit_get_contents (unit);
 	const gsize prefix_len = strlen (prefix) + 1;
@@ -358,8 +389,10 @@ asc_l10n_search_translations_qt (AscLocaleContext *ctx,
 					continue;
 
 				segments = g_strsplit (fname + prefix_len, G_DIR_SEPARATOR_S, 4);
-				if (!asc_l10n_parse_file_qt (ctx, unit, segments[2], fname, error))
-					return FALSE;
+				g_ptr_array_add (jobs,
+						 asc_locale_parse_job_new (AS_TRANSLATION_KIND_QT,
+									   segments[2],
+									   fname));
 			}
 		} else {
 			/* look in ${prefix}/share/${hint}_${locale}.qm
@@ -379,16 +412,90 @@ asc_l10n_search_translations_qt (AscLocaleContext *ctx,
 				g_strdelimit (locale, ".", '\0');
 				/* tmp == NULL means we have the ${hint}/${locale}.qm form */
 				tmp = g_strstr_len (locale, -1, "/");
-				if (!asc_l10n_parse_file_qt (ctx,
-							     unit,
-							     tmp == NULL ? locale : tmp + 1,
-							     fname,
-							     error))
-					return FALSE;
+				g_ptr_array_add (jobs,
+						 asc_locale_parse_job_new (AS_TRANSLATION_KIND_QT,
+									   tmp == NULL ? locale
+										       : tmp + 1,
+									   fname));
 			}
 		}
 	}
+}
+
+static gboolean
+asc_l10n_process_job (AscLocaleContext *ctx,
+		      AscUnit *unit,
+		      AscLocaleParseJob *job,
+		      GError **error)
+{
+	if (job->kind == AS_TRANSLATION_KIND_QT)
+		return asc_l10n_parse_file_qt (ctx, unit, job->locale, job->fname, error);
+	return asc_l10n_parse_file_gettext (ctx, unit, job->locale, job->fname, error);
+}
+
+typedef struct {
+	AscLocaleContext *ctx;
+	AscUnit *unit;
+	GMutex error_mutex;
+	GError *error;
+} AscLocaleScanHelper;
+
+static void
+asc_l10n_process_job_thread_cb (gpointer data, gpointer user_data)
+{
+	AscLocaleParseJob *job = data;
+	AscLocaleScanHelper *helper = user_data;
+	g_autoptr(GError) tmp_error = NULL;
+
+	if (!asc_l10n_process_job (helper->ctx, helper->unit, job, &tmp_error)) {
+		g_mutex_lock (&helper->error_mutex);
+		if (helper->error == NULL)
+			helper->error = g_steal_pointer (&tmp_error);
+		g_mutex_unlock (&helper->error_mutex);
+	}
+}
+
+static gboolean
+asc_l10n_process_jobs (AscLocaleContext *ctx, AscUnit *unit, GPtrArray *jobs, GError **error)
+{
+	/* parse translation files in parallel if there are enough of them to make the
+	 * thread pool worthwhile. We only do this for directory units, as their data
+	 * reads are just concurrency-safe memory mappings, while other unit types may
+	 * not permit simultaneous read access. */
+	if (jobs->len >= 4 && ASC_IS_DIRECTORY_UNIT (unit)) {
+		GThreadPool *tpool = NULL;
+		AscLocaleScanHelper helper = { ctx, unit, { 0 }, NULL };
+
+		g_mutex_init (&helper.error_mutex);
+		tpool = g_thread_pool_new (asc_l10n_process_job_thread_cb,
+					   &helper,
+					   (gint) g_get_num_processors (),
+					   FALSE,
+					   error);
+		if (tpool == NULL) {
+			g_mutex_clear (&helper.error_mutex);
+			return FALSE;
+		}
+
+		for (guint i = 0; i < jobs->len; i++)
+			g_thread_pool_push (tpool, g_ptr_array_index (jobs, i), NULL);
+
+		/* wait for all parse jobs to complete */
+		g_thread_pool_free (tpool, FALSE, TRUE);
+		g_mutex_clear (&helper.error_mutex);
+
+		if (helper.error != NULL) {
+			g_propagate_error (error, helper.error);
+			return FALSE;
+		}
+		return TRUE;
+	}
 
+	for (guint i = 0; i < jobs->len; i++) {
+		AscLocaleParseJob *job = g_ptr_array_index (jobs, i);
+		if (!asc_l10n_process_job (ctx, unit, job, error))
+			return FALSE;
+	}
 	return TRUE;
 }
 
@@ -423,6 +530,7 @@ asc_read_translation_status (AscResult *cres,
 	for (guint i = 0; i < cpts->len; i++) {
 		AscLocaleEntry *e;
 		g_autoptr(AscLocaleContext) ctx = NULL;
+		g_autoptr(GPtrArray) jobs = NULL;
 		g_autoptr(GError) error = NULL;
 		gboolean have_results = FALSE;
 		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (cpts, i));
@@ -434,19 +542,12 @@ asc_read_translation_status (AscResult *cres,
 		if (ctx->translations->len == 0)
 			continue;
 
-		/* search for Qt .qm files */
-		if (!asc_l10n_search_translations_qt (ctx, unit, prefix, &error)) {
-			asc_result_add_hint (cres,
-					     cpt,
-					     "translation-status-error",
-					     "msg",
-					     error->message,
-					     NULL);
-			continue;
-		}
+		/* find Qt .qm and gettext .mo files, then parse them */
+		jobs = g_ptr_array_new_with_free_func ((GDestroyNotify) asc_locale_parse_job_free);
+		asc_l10n_collect_jobs_qt (ctx, unit, prefix, jobs);
+		asc_l10n_collect_jobs_gettext (ctx, unit, prefix, jobs);
 
-		/* search for gettext .mo files */
-		if (!asc_l10n_search_translations_gettext (ctx, unit, prefix, &error)) {
+		if (!asc_l10n_process_jobs (ctx, unit, jobs, &error)) {
 			asc_result_add_hint (cres,
 					     cpt,
 					     "translation-status-error",
@@ -28,8 +28,10 @@
 #include "asc-utils-screenshots.h"
 
 #include <glib/gstdio.h>
+#include <gio/gio.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <math.h>
 
 #include "as-utils-private.h"
 
@@ -48,6 +50,246 @@ struct {
 	{ 0,   0  }
 };
 
+#define ASC_SCREENSHOT_PROBE_CACHE_NAME "media-probe.cache"
+
+/**
+ * asc_screenshot_probe_cache_load:
+ *
+ * Load the per-component media probe cache from the screenshot export
+ * directory. The cache maps upstream media URLs to the ETag they had
+ * when we last downloaded them, together with the probed properties and
+ * the files we generated, so unchanged media can be reused in
+ * subsequent compose runs without re-downloading it.
+ */
+static GKeyFile *
+asc_screenshot_probe_cache_load (const gchar *scr_export_dir)
+{
+	g_autoptr(GKeyFile) pcache = g_key_file_new ();
+	g_autofree gchar *fname = NULL;
+
+	fname = g_build_filename (scr_export_dir, ASC_SCREENSHOT_PROBE_CACHE_NAME, NULL);
+	/* a missing or broken cache file simply means we probe everything again */
+	g_key_file_load_from_file (pcache, fname, G_KEY_FILE_NONE, NULL);
+
+	return g_steal_pointer (&pcache);
+}
+
+static void
+asc_screenshot_probe_cache_save (GKeyFile *pcache, const gchar *scr_export_dir)
+{
+	g_autofree gchar *fname = NULL;
+	g_autoptr(GError) error = NULL;
+
+	if (!g_file_test (scr_export_dir, G_FILE_TEST_IS_DIR))
+		return;
+	fname = g_build_filename (scr_export_dir, ASC_SCREENSHOT_PROBE_CACHE_NAME, NULL);
+	if (!g_key_file_save_to_file (pcache, fname, &error))
+		g_debug ("Unable to save media probe cache '%s': %s", fname, error->message);
+}
+
+/**
+ * asc_screenshot_probe_cache_restore_images:
+ *
+ * Recreate the image entries for an unchanged screenshot from the probe
+ * cache, referencing the files generated by a previous run.
+ *
+ * Returns: %TRUE if all recorded files were still present and the
+ * screenshot could be restored completely.
+ */
+static gboolean
+asc_screenshot_probe_cache_restore_images (GKeyFile *pcache,
+					   AscResult *cres,
+					   AsComponent *cpt,
+					   AsScreenshot *scr,
+					   const gchar *orig_img_url,
+					   const gchar *locale,
+					   const gchar *scr_export_dir,
+					   const gchar *scr_base_url)
+{
+	g_auto(GStrv) entries = NULL;
+	g_autoptr(GPtrArray) imgs = NULL;
+	gboolean have_thumbnails = FALSE;
+
+	entries = g_key_file_get_string_list (pcache, orig_img_url, "images", NULL, NULL);
+	if (entries == NULL)
+		return FALSE;
+
+	imgs = g_ptr_array_new_with_free_func (g_object_unref);
+	for (guint i = 0; entries[i] != NULL; i++) {
+		g_auto(GStrv) fields = NULL;
+		g_autofree gchar *img_path = NULL;
+		g_autofree gchar *img_url = NULL;
+		g_autoptr(AsImage) img = NULL;
+		AsImageKind kind;
+
+		/* each entry is "kind;filename;width;height;scale" */
+		fields = g_strsplit (entries[i], ";", -1);
+		if (g_strv_length (fields) != 5)
+			return FALSE;
+
+		/* if any of the recorded files went missing, we regenerate everything */
+		img_path = g_build_filename (scr_export_dir, fields[1], NULL);
+		if (!g_file_test (img_path, G_FILE_TEST_EXISTS))
+			return FALSE;
+
+		kind = g_ascii_strtoll (fields[0], NULL, 10);
+		if (kind == AS_IMAGE_KIND_THUMBNAIL)
+			have_thumbnails = TRUE;
+
+		img_url = g_build_filename (scr_base_url, fields[1], NULL);
+		img = as_image_new ();
+		as_image_set_kind (img, kind);
+		as_image_set_locale (img, locale);
+		as_image_set_width (img, g_ascii_strtoll (fields[2], NULL, 10));
+		as_image_set_height (img, g_ascii_strtoll (fields[3], NULL, 10));
+		as_image_set_scale (img, g_ascii_strtoll (fields[4], NULL, 10));
+		as_image_set_url (img, img_url);
+		g_ptr_array_add (imgs, g_steal_pointer (&img));
+	}
+
+	for (guint i = 0; i < imgs->len; i++)
+		as_screenshot_add_image (scr, AS_IMAGE (g_ptr_array_index (imgs, i)));
+
+	if (!have_thumbnails)
+		asc_result_add_hint (cres,
+				     cpt,
+				     "screenshot-no-thumbnails",
+				     "url",
+				     orig_img_url,
+				     NULL);
+
+	g_debug ("Reusing unchanged screenshot media for %s", orig_img_url);
+	return TRUE;
+}
+
+/**
+ * AscScreenshotDedup:
+ *
+ * Run-wide index of already exported screenshot media, keyed by the
+ * checksum of the original image content. Many components (e.g. the
+ * tools of one application suite) ship bit-identical screenshots, and
+ * storing the generated media only once with shared URLs saves a
+ * sizable amount of media mirror space.
+ */
+struct _AscScreenshotDedup {
+	GMutex mutex;
+	GHashTable *media; /* content checksum -> GPtrArray of "kind;url;width;height;scale" */
+};
+
+AscScreenshotDedup *
+asc_screenshot_dedup_new (void)
+{
+	AscScreenshotDedup *dedup = g_new0 (AscScreenshotDedup, 1);
+	g_mutex_init (&dedup->mutex);
+	dedup->media = g_hash_table_new_full (g_str_hash,
+					      g_str_equal,
+					      g_free,
+					      (GDestroyNotify) g_ptr_array_unref);
+	return dedup;
+}
+
+void
+asc_screenshot_dedup_free (AscScreenshotDedup *dedup)
+{
+	if (dedup == NULL)
+		return;
+	g_hash_table_unref (dedup->media);
+	g_mutex_clear (&dedup->mutex);
+	g_free (dedup);
+}
+
+void
+asc_screenshot_dedup_reset (AscScreenshotDedup *dedup)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&dedup->mutex);
+	g_hash_table_remove_all (dedup->media);
+}
+
+/**
+ * asc_screenshot_dedup_apply:
+ *
+ * Check whether media with the given content checksum was already stored
+ * for a previously processed component, and if so, add image entries
+ * referencing the existing files to @scr.
+ *
+ * Returns: %TRUE if the screenshot could be served from existing media.
+ */
+static gboolean
+asc_screenshot_dedup_apply (AscScreenshotDedup *dedup,
+			    AscResult *cres,
+			    AsComponent *cpt,
+			    AsScreenshot *scr,
+			    const gchar *content_hash,
+			    const gchar *orig_img_url,
+			    const gchar *locale)
+{
+	g_autoptr(GPtrArray) entries = NULL;
+	g_autoptr(GPtrArray) imgs = NULL;
+	gboolean have_thumbnails = FALSE;
+
+	{
+		g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&dedup->mutex);
+		GPtrArray *tmp = g_hash_table_lookup (dedup->media, content_hash);
+		if (tmp == NULL)
+			return FALSE;
+		/* entry arrays are immutable once registered, so we can read
+		 * them outside of the lock with just a reference held */
+		entries = g_ptr_array_ref (tmp);
+	}
+
+	imgs = g_ptr_array_new_with_free_func (g_object_unref);
+	for (guint i = 0; i < entries->len; i++) {
+		g_auto(GStrv) fields = NULL;
+		g_autoptr(AsImage) img = NULL;
+		AsImageKind kind;
+
+		/* each entry is "kind;url;width;height;scale" */
+		fields = g_strsplit (g_ptr_array_index (entries, i), ";", -1);
+		if (g_strv_length (fields) != 5)
+			return FALSE;
+
+		kind = g_ascii_strtoll (fields[0], NULL, 10);
+		if (kind == AS_IMAGE_KIND_THUMBNAIL)
+			have_thumbnails = TRUE;
+
+		img = as_image_new ();
+		as_image_set_kind (img, kind);
+		as_image_set_locale (img, locale);
+		as_image_set_url (img, fields[1]);
+		as_image_set_width (img, g_ascii_strtoll (fields[2], NULL, 10));
+		as_image_set_height (img, g_ascii_strtoll (fields[3], NULL, 10));
+		as_image_set_scale (img, g_ascii_strtoll (fields[4], NULL, 10));
+		g_ptr_array_add (imgs, g_steal_pointer (&img));
+	}
+
+	for (guint i = 0; i < imgs->len; i++)
+		as_screenshot_add_image (scr, AS_IMAGE (g_ptr_array_index (imgs, i)));
+
+	if (!have_thumbnails)
+		asc_result_add_hint (cres,
+				     cpt,
+				     "screenshot-no-thumbnails",
+				     "url",
+				     orig_img_url,
+				     NULL);
+
+	g_debug ("Sharing already stored screenshot media for %s", orig_img_url);
+	return TRUE;
+}
+
+static void
+asc_screenshot_dedup_register (AscScreenshotDedup *dedup,
+			       const gchar *content_hash,
+			       GPtrArray *entries)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&dedup->mutex);
+
+	/* in case another worker beat us to it, keep the existing entry */
+	if (g_hash_table_contains (dedup->media, content_hash))
+		return;
+	g_hash_table_insert (dedup->media, g_strdup (content_hash), g_ptr_array_ref (entries));
+}
+
 static AscVideoInfo *
 asc_video_info_new (void)
 {
@@ -67,6 +309,110 @@ asc_video_info_free (AscVideoInfo *vinfo)
 	g_free (vinfo);
 }
 
+/* maximum time a single video probe subprocess may take before it is killed */
+#define ASC_VIDEO_PROBE_TIMEOUT_SEC 60
+
+typedef struct {
+	GSubprocess *proc;
+	gboolean done;
+	gboolean timed_out;
+	gchar *std_out;
+	gchar *std_err;
+	GError *error;
+} AscVideoProbeData;
+
+static void
+asc_video_probe_communicate_cb (GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	AscVideoProbeData *pdata = user_data;
+
+	g_subprocess_communicate_utf8_finish (G_SUBPROCESS (source),
+					      res,
+					      &pdata->std_out,
+					      &pdata->std_err,
+					      &pdata->error);
+	pdata->done = TRUE;
+}
+
+static gboolean
+asc_video_probe_timeout_cb (gpointer user_data)
+{
+	AscVideoProbeData *pdata = user_data;
+
+	pdata->timed_out = TRUE;
+	g_subprocess_force_exit (pdata->proc);
+	return G_SOURCE_REMOVE;
+}
+
+/**
+ * asc_video_probe_run:
+ *
+ * Run a media probe subprocess with timeout-based isolation: if the
+ * probe does not complete within a fixed deadline, the subprocess is
+ * killed and @timed_out is set, so one misbehaving video file can not
+ * stall a compose worker thread indefinitely.
+ *
+ * Concurrency is naturally bounded by the number of compose workers,
+ * as each worker runs at most one probe subprocess at a time.
+ */
+static gboolean
+asc_video_probe_run (const gchar *const *argv,
+		     gchar **stdout_out,
+		     gchar **stderr_out,
+		     gint *exit_status,
+		     gboolean *timed_out,
+		     GError **error)
+{
+	g_autoptr(GSubprocess) proc = NULL;
+	g_autoptr(GMainContext) mctx = NULL;
+	g_autoptr(GSource) timeout_source = NULL;
+	AscVideoProbeData pdata = { NULL };
+
+	/* use a private context, so we can wait for the subprocess without
+	 * depending on (or interfering with) any running main loop */
+	mctx = g_main_context_new ();
+	g_main_context_push_thread_default (mctx);
+
+	proc = g_subprocess_newv (argv,
+				  G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_PIPE,
+				  error);
+	if (proc == NULL) {
+		g_main_context_pop_thread_default (mctx);
+		return FALSE;
+	}
+	pdata.proc = proc;
+
+	timeout_source = g_timeout_source_new_seconds (ASC_VIDEO_PROBE_TIMEOUT_SEC);
+	g_source_set_callback (timeout_source, asc_video_probe_timeout_cb, &pdata, NULL);
+	g_source_attach (timeout_source, mctx);
+
+	g_subprocess_communicate_utf8_async (proc,
+					     NULL, /* stdin */
+					     NULL, /* cancellable */
+					     asc_video_probe_communicate_cb,
+					     &pdata);
+	while (!pdata.done)
+		g_main_context_iteration (mctx, TRUE);
+
+	g_source_destroy (timeout_source);
+	g_main_context_pop_thread_default (mctx);
+
+	*timed_out = pdata.timed_out;
+	if (pdata.error != NULL) {
+		g_propagate_error (error, g_steal_pointer (&pdata.error));
+		return FALSE;
+	}
+
+	*stdout_out = g_steal_pointer (&pdata.std_out);
+	*stderr_out = g_steal_pointer (&pdata.std_err);
+	if (g_subprocess_get_if_exited (proc))
+		*exit_status = g_subprocess_get_exit_status (proc);
+	else
+		*exit_status = -1;
+
+	return TRUE;
+}
+
 static gsize
 asc_get_filesize (const gchar *filename)
 {
@@ -90,6 +436,7 @@ asc_extract_video_info (AscResult *cres, AsComponent *cpt, const gchar *vid_fnam
 	g_autofree gchar *ff_stderr = NULL;
 	g_autofree gchar *vid_basename = NULL;
 	gint exit_status = 0;
+	gboolean timed_out = FALSE;
 	g_auto(GStrv) lines = NULL;
 	g_autofree gchar *prev_codec_name = NULL;
 	gboolean audio_okay = FALSE;
@@ -113,16 +460,12 @@ asc_extract_video_info (AscResult *cres, AsComponent *cpt, const gchar *vid_fnam
 		return NULL;
 	vid_basename = g_path_get_basename (vid_fname);
 
-	ret = g_spawn_sync (NULL, /* working directory */
-			    (gchar **) ffprobe_argv,
-			    NULL, /* envp */
-			    G_SPAWN_LEAVE_DESCRIPTORS_OPEN,
-			    NULL, /* child setup */
-			    NULL, /* user data */
-			    &ff_stdout,
-			    &ff_stderr,
-			    &exit_status,
-			    &error);
+	ret = asc_video_probe_run (ffprobe_argv,
+				   &ff_stdout,
+				   &ff_stderr,
+				   &exit_status,
+				   &timed_out,
+				   &error);
 	if (!ret) {
 		g_warning ("Failed to spawn ffprobe: %s", error->message);
 		asc_result_add_hint (cres,
@@ -136,6 +479,22 @@ asc_extract_video_info (AscResult *cres, AsComponent *cpt, const gchar *vid_fnam
 		return vinfo;
 	}
 
+	if (timed_out) {
+		g_autofree gchar *msg = NULL;
+		g_warning ("FFprobe on '%s' timed out and was killed.", vid_fname);
+		msg = g_strdup_printf ("Probe timed out after %i seconds.",
+				       ASC_VIDEO_PROBE_TIMEOUT_SEC);
+		asc_result_add_hint (cres,
+				     cpt,
+				     "screenshot-video-check-failed",
+				     "fname",
+				     vid_basename,
+				     "msg",
+				     msg,
+				     NULL);
+		return vinfo;
+	}
+
 	if (exit_status != 0) {
 		g_autofree gchar *msg = NULL;
 		if (ff_stderr == NULL) {
@@ -274,6 +633,7 @@ asc_process_screenshot_videos (AscResult *cres,
 			       AsComponent *cpt,
 			       AsScreenshot *scr,
 			       AsCurl *acurl,
+			       GKeyFile *pcache,
 			       const gchar *scr_export_dir,
 			       const gchar *scr_base_url,
 			       const gssize max_size_bytes,
@@ -305,6 +665,7 @@ asc_process_screenshot_videos (AscResult *cres,
 		g_autofree gchar *scr_vid_path = NULL;
 		g_autofree gchar *scr_vid_url = NULL;
 		g_autofree gchar *fname_from_url = NULL;
+		g_autofree gchar *etag = NULL;
 		AscVideoInfo *vinfo = NULL;
 		g_autoptr(GError) error = NULL;
 		gsize video_size;
@@ -328,6 +689,35 @@ asc_process_screenshot_videos (AscResult *cres,
 		scr_vid_path = g_build_filename (scr_export_dir, scr_vid_name, NULL);
 		scr_vid_url = g_build_filename (scr_base_url, scr_vid_name, NULL);
 
+		/* check the probe cache, so unchanged videos are neither re-downloaded nor re-probed */
+		if (pcache != NULL)
+			etag = as_curl_query_etag (acurl, orig_vid_url, NULL);
+		if (etag != NULL) {
+			g_autofree gchar *cached_etag = NULL;
+
+			cached_etag = g_key_file_get_string (pcache, orig_vid_url, "etag", NULL);
+			if (g_strcmp0 (cached_etag, etag) == 0 &&
+			    g_file_test (scr_vid_path, G_FILE_TEST_EXISTS)) {
+				as_video_set_codec_kind (
+				    vid,
+				    g_key_file_get_integer (pcache, orig_vid_url, "codec", NULL));
+				as_video_set_container_kind (
+				    vid,
+				    g_key_file_get_integer (pcache, orig_vid_url, "container", NULL));
+				as_video_set_width (
+				    vid,
+				    g_key_file_get_integer (pcache, orig_vid_url, "width", NULL));
+				as_video_set_height (
+				    vid,
+				    g_key_file_get_integer (pcache, orig_vid_url, "height", NULL));
+				as_video_set_url (vid, scr_vid_url);
+
+				g_debug ("Reusing unchanged screenshot video for %s", orig_vid_url);
+				g_ptr_array_add (valid_vids, g_object_ref (vid));
+				continue;
+			}
+		}
+
 		if (!as_curl_download_to_filename (acurl, orig_vid_url, scr_vid_path, &error)) {
 			asc_result_add_hint (cres,
 					     cpt,
@@ -377,6 +767,24 @@ asc_process_screenshot_videos (AscResult *cres,
 			as_video_set_width (vid, vinfo->width);
 			as_video_set_height (vid, vinfo->height);
 
+			/* remember the probe results for the next compose run */
+			if (pcache != NULL && etag != NULL) {
+				g_key_file_set_string (pcache, orig_vid_url, "etag", etag);
+				g_key_file_set_integer (pcache,
+							orig_vid_url,
+							"codec",
+							vinfo->codec_kind);
+				g_key_file_set_integer (pcache,
+							orig_vid_url,
+							"container",
+							vinfo->container_kind);
+				g_key_file_set_integer (pcache, orig_vid_url, "width", vinfo->width);
+				g_key_file_set_integer (pcache,
+							orig_vid_url,
+							"height",
+							vinfo->height);
+			}
+
 			asc_video_info_free (vinfo);
 		}
 
@@ -424,6 +832,10 @@ asc_process_screenshot_images_lang (AscResult *cres,
 				    AsImage *orig_img,
 				    const gchar *locale,
 				    AsCurl *acurl,
+				    GKeyFile *pcache,
+				    AscScreenshotDedup *dedup,
+				    GHashTable *prefetch_reqs,
+				    GHashTable *prefetch_etags,
 				    const gchar *scr_export_dir,
 				    const gchar *scr_base_url,
 				    const gssize max_size_bytes,
@@ -439,6 +851,12 @@ asc_process_screenshot_images_lang (AscResult *cres,
 	guint source_scr_height;
 	guint source_scr_scale;
 	gboolean thumbnails_generated = FALSE;
+	g_autofree gchar *etag = NULL;
+	g_autofree gchar *content_hash = NULL;
+	g_autoptr(GPtrArray) pcache_entries = NULL;
+	g_autoptr(GPtrArray) dedup_entries = NULL;
+	g_autoptr(AscImage) src_image = NULL;
+	g_autoptr(AscImage) last_thumb = NULL;
 	g_autoptr(GError) error = NULL;
 
 	orig_img_url = as_image_get_url (orig_img);
@@ -449,18 +867,62 @@ asc_process_screenshot_images_lang (AscResult *cres,
 	if (max_size_bytes == 0)
 		store_screenshots = FALSE;
 
-	/* download our image */
-	img_bytes = as_curl_download_bytes (acurl, orig_img_url, &error);
+	/* check the probe cache, so unchanged images are reused without being
+	 * re-downloaded and re-thumbnailed */
+	if (pcache != NULL && store_screenshots) {
+		if (prefetch_etags != NULL)
+			etag = g_strdup (g_hash_table_lookup (prefetch_etags, orig_img_url));
+		if (etag == NULL)
+			etag = as_curl_query_etag (acurl, orig_img_url, NULL);
+	}
+	if (etag != NULL) {
+		g_autofree gchar *cached_etag = NULL;
+
+		cached_etag = g_key_file_get_string (pcache, orig_img_url, "etag", NULL);
+		if (g_strcmp0 (cached_etag, etag) == 0 &&
+		    asc_screenshot_probe_cache_restore_images (pcache,
+							       cres,
+							       cpt,
+							       scr,
+							       orig_img_url,
+							       locale,
+							       scr_export_dir,
+							       scr_base_url))
+			return TRUE;
+	}
+	pcache_entries = g_ptr_array_new_with_free_func (g_free);
+
+	/* use the image data if it was already prefetched, otherwise download it now */
+	if (prefetch_reqs != NULL) {
+		AsCurlRequest *req = g_hash_table_lookup (prefetch_reqs, orig_img_url);
+		if (req != NULL) {
+			if (req->error != NULL) {
+				asc_result_add_hint (cres,
+						     cpt,
+						     "screenshot-download-error",
+						     "url",
+						     orig_img_url,
+						     "error",
+						     req->error->message,
+						     NULL);
+				return FALSE;
+			}
+			img_bytes = g_bytes_ref (req->bytes);
+		}
+	}
 	if (img_bytes == NULL) {
-		asc_result_add_hint (cres,
-				     cpt,
-				     "screenshot-download-error",
-				     "url",
-				     orig_img_url,
-				     "error",
-				     error->message,
-				     NULL);
-		return FALSE;
+		img_bytes = as_curl_download_bytes (acurl, orig_img_url, &error);
+		if (img_bytes == NULL) {
+			asc_result_add_hint (cres,
+					     cpt,
+					     "screenshot-download-error",
+					     "url",
+					     orig_img_url,
+					     "error",
+					     error->message,
+					     NULL);
+			return FALSE;
+		}
 	}
 	img_data = g_bytes_get_data (img_bytes, &img_data_len);
 
@@ -495,12 +957,28 @@ asc_process_screenshot_images_lang (AscResult *cres,
 		return FALSE;
 	}
 
+	/* if a previously processed component had a bit-identical screenshot, share
+	 * its already generated media instead of storing the same files again */
+	if (dedup != NULL && store_screenshots) {
+		content_hash = g_compute_checksum_for_data (G_CHECKSUM_SHA256,
+							    img_data,
+							    img_data_len);
+		if (asc_screenshot_dedup_apply (dedup,
+						cres,
+						cpt,
+						scr,
+						content_hash,
+						orig_img_url,
+						locale))
+			return TRUE;
+		dedup_entries = g_ptr_array_new_with_free_func (g_free);
+	}
+
 	/* ensure export dir exists */
 	if (g_mkdir_with_parents (scr_export_dir, 0755) != 0)
 		g_warning ("Failed to create directory tree '%s'", scr_export_dir);
 
 	{
-		g_autoptr(AscImage) src_image = NULL;
 		g_autofree gchar *src_img_name = NULL;
 		g_autofree gchar *src_img_path = NULL;
 		g_autofree gchar *src_img_url = NULL;
@@ -580,9 +1058,26 @@ asc_process_screenshot_images_lang (AscResult *cres,
 
 		as_image_set_url (simg, src_img_url);
 		as_screenshot_add_image (scr, simg);
+
+		g_ptr_array_add (pcache_entries,
+				 g_strdup_printf ("%d;%s;%u;%u;%u",
+						  AS_IMAGE_KIND_SOURCE,
+						  src_img_name,
+						  source_scr_width,
+						  source_scr_height,
+						  source_scr_scale));
+		if (dedup_entries != NULL)
+			g_ptr_array_add (dedup_entries,
+					 g_strdup_printf ("%d;%s;%u;%u;%u",
+							  AS_IMAGE_KIND_SOURCE,
+							  src_img_url,
+							  source_scr_width,
+							  source_scr_height,
+							  source_scr_scale));
 	}
 
-	/* generate & save thumbnails for the screenshot image */
+	/* generate & save thumbnails for the screenshot image, deriving each size from the
+	 * closest already-scaled version so the large source image is only resampled once */
 	thumbnails_generated = FALSE;
 	for (guint i = 0; target_screenshot_sizes[i].width != 0; i++) {
 		g_autoptr(AscImage) thumb = NULL;
@@ -590,6 +1085,10 @@ asc_process_screenshot_images_lang (AscResult *cres,
 		g_autofree gchar *thumb_img_name = NULL;
 		g_autofree gchar *thumb_img_path = NULL;
 		g_autofree gchar *thumb_img_url = NULL;
+		AscImage *scale_base;
+		double scale;
+		guint thumb_width;
+		guint thumb_height;
 
 		guint target_width = target_screenshot_sizes[i].width;
 		guint target_height = target_screenshot_sizes[i].height;
@@ -604,32 +1103,29 @@ asc_process_screenshot_images_lang (AscResult *cres,
 		if (source_scr_scale > 1)
 			continue;
 
-		thumb = asc_image_new_from_data (img_data,
-						 img_data_len,
-						 0,	/* destination size */
-						 FALSE, /* compressed */
-						 ASC_IMAGE_LOAD_FLAG_NONE,
-						 &error);
-		if (error != NULL) {
-			g_autofree gchar *msg = g_strdup_printf (
-			    "Could not load source screenshot for thumbnailing: %s",
-			    error->message);
-			asc_result_add_hint (cres,
-					     cpt,
-					     "screenshot-save-error",
-					     "url",
-					     orig_img_url,
-					     "error",
-					     msg,
-					     NULL);
-			g_error_free (g_steal_pointer (&error));
-			continue;
+		/* determine the final thumbnail size from the source image dimensions,
+		 * preserving the aspect ratio */
+		if (target_width > target_height) {
+			scale = (double) target_width / (double) source_scr_width;
+			thumb_width = target_width;
+			thumb_height = floor (source_scr_height * scale);
+		} else {
+			scale = (double) target_height / (double) source_scr_height;
+			thumb_width = floor (source_scr_width * scale);
+			thumb_height = target_height;
 		}
 
-		if (target_width > target_height)
-			asc_image_scale_to_width (thumb, target_width);
-		else
-			asc_image_scale_to_height (thumb, target_height);
+		/* the target sizes are sorted largest-first, so we can usually scale down
+		 * the previous (larger) thumbnail instead of the full-size source image */
+		scale_base = src_image;
+		if (last_thumb != NULL && asc_image_get_width (last_thumb) >= thumb_width &&
+		    asc_image_get_height (last_thumb) >= thumb_height)
+			scale_base = last_thumb;
+
+		thumb = asc_image_new_scaled (scale_base, thumb_width, thumb_height);
+		if (thumb == NULL)
+			continue;
+		g_set_object (&last_thumb, thumb);
 
 		/* create thumbnail storage path and URL component*/
 		if (g_strcmp0 (locale, "C") == 0)
@@ -679,6 +1175,22 @@ asc_process_screenshot_images_lang (AscResult *cres,
 		as_image_set_url (img, thumb_img_url);
 		as_screenshot_add_image (scr, img);
 
+		g_ptr_array_add (pcache_entries,
+				 g_strdup_printf ("%d;%s;%u;%u;%u",
+						  AS_IMAGE_KIND_THUMBNAIL,
+						  thumb_img_name,
+						  asc_image_get_width (thumb),
+						  asc_image_get_height (thumb),
+						  1));
+		if (dedup_entries != NULL)
+			g_ptr_array_add (dedup_entries,
+					 g_strdup_printf ("%d;%s;%u;%u;%u",
+							  AS_IMAGE_KIND_THUMBNAIL,
+							  thumb_img_url,
+							  asc_image_get_width (thumb),
+							  asc_image_get_height (thumb),
+							  1));
+
 		thumbnails_generated = TRUE;
 	}
 
@@ -690,41 +1202,46 @@ asc_process_screenshot_images_lang (AscResult *cres,
 				     orig_img_url,
 				     NULL);
 
+	/* all media was generated successfully, remember that for the next run */
+	if (pcache != NULL && etag != NULL) {
+		g_key_file_set_string (pcache, orig_img_url, "etag", etag);
+		g_key_file_set_string_list (pcache,
+					    orig_img_url,
+					    "images",
+					    (const gchar *const *) pcache_entries->pdata,
+					    pcache_entries->len);
+	}
+
+	/* let other components with identical screenshot content share this media */
+	if (dedup_entries != NULL)
+		asc_screenshot_dedup_register (dedup, content_hash, dedup_entries);
+
 	return TRUE;
 }
 
 /**
- * asc_process_screenshot_images:
+ * asc_screenshot_get_source_images:
  *
- * Returns: (transfer full): The processed screenshot.
+ * Select the source image per locale for the given screenshot,
+ * in case upstream has provided their own thumbnails.
+ *
+ * Returns: (transfer full): A mapping of locale to the #AsImage to process,
+ * or %NULL if the screenshot has no images at all.
  */
-static AsScreenshot *
-asc_process_screenshot_images (AscResult *cres,
-			       AsComponent *cpt,
-			       AsScreenshot *scr,
-			       AsCurl *acurl,
-			       const gchar *scr_export_dir,
-			       const gchar *scr_base_url,
-			       const gssize max_size_bytes,
-			       gboolean store_screenshots,
-			       guint scr_no)
+static GHashTable *
+asc_screenshot_get_source_images (AsScreenshot *scr)
 {
 	GPtrArray *imgs = NULL;
-	GHashTableIter ht_iter;
-	gpointer ht_key, ht_value;
 	g_autoptr(GHashTable) ht_lang_img = g_hash_table_new_full (g_str_hash,
 								    g_str_equal,
 								    g_free,
 								    g_object_unref);
 
 	imgs = as_screenshot_get_images_all (scr);
-	if (imgs->len == 0) {
-		asc_result_add_hint_simple (cres, cpt, "metainfo-screenshot-but-no-media");
+	if (imgs->len == 0)
 		return NULL;
-	}
 
-	/* try to find the source images, in case upstream has provided their own thumbnails.
-	 * We use a hash-table to remove any possible duplicate original images of the same locale */
+	/* we use a hash-table to remove any possible duplicate original images of the same locale */
 	for (guint i = 0; i < imgs->len; i++) {
 		AsImage *img = AS_IMAGE (g_ptr_array_index (imgs, i));
 		if (as_image_get_kind (img) == AS_IMAGE_KIND_SOURCE)
@@ -739,6 +1256,39 @@ asc_process_screenshot_images (AscResult *cres,
 				     g_strdup ("C"),
 				     g_object_ref (AS_IMAGE (g_ptr_array_index (imgs, 0))));
 
+	return g_steal_pointer (&ht_lang_img);
+}
+
+/**
+ * asc_process_screenshot_images:
+ *
+ * Returns: (transfer full): The processed screenshot.
+ */
+static AsScreenshot *
+asc_process_screenshot_images (AscResult *cres,
+			       AsComponent *cpt,
+			       AsScreenshot *scr,
+			       AsCurl *acurl,
+			       GKeyFile *pcache,
+			       AscScreenshotDedup *dedup,
+			       GHashTable *prefetch_reqs,
+			       GHashTable *prefetch_etags,
+			       const gchar *scr_export_dir,
+			       const gchar *scr_base_url,
+			       const gssize max_size_bytes,
+			       gboolean store_screenshots,
+			       guint scr_no)
+{
+	GHashTableIter ht_iter;
+	gpointer ht_key, ht_value;
+	g_autoptr(GHashTable) ht_lang_img = NULL;
+
+	ht_lang_img = asc_screenshot_get_source_images (scr);
+	if (ht_lang_img == NULL) {
+		asc_result_add_hint_simple (cres, cpt, "metainfo-screenshot-but-no-media");
+		return NULL;
+	}
+
 	/* drop metainfo images */
 	as_screenshot_clear_images (scr);
 
@@ -751,6 +1301,10 @@ asc_process_screenshot_images (AscResult *cres,
 							 AS_IMAGE (ht_value),
 							 (const gchar *) ht_key,
 							 acurl,
+							 pcache,
+							 dedup,
+							 prefetch_reqs,
+							 prefetch_etags,
 							 scr_export_dir,
 							 scr_base_url,
 							 max_size_bytes,
@@ -761,6 +1315,79 @@ asc_process_screenshot_images (AscResult *cres,
 	return g_object_ref (scr);
 }
 
+/**
+ * asc_screenshots_prefetch_media:
+ *
+ * Download all screenshot images of the component concurrently, so the
+ * per-screenshot processing below does not have to wait on the network
+ * for every single image in sequence.
+ * URLs which the probe cache will most likely satisfy are not fetched;
+ * their ETags are recorded in @prefetch_etags to avoid duplicate queries.
+ */
+static void
+asc_screenshots_prefetch_media (AsCurl *acurl,
+				GPtrArray *screenshots,
+				GKeyFile *pcache,
+				gboolean store_screenshots,
+				GHashTable *prefetch_reqs,
+				GHashTable *prefetch_etags)
+{
+	g_autoptr(GPtrArray) batch = g_ptr_array_new ();
+
+	for (guint i = 0; i < screenshots->len; i++) {
+		AsScreenshot *scr = AS_SCREENSHOT (g_ptr_array_index (screenshots, i));
+		g_autoptr(GHashTable) source_imgs = NULL;
+		GHashTableIter ht_iter;
+		gpointer ht_value;
+
+		/* videos are downloaded straight to files while being processed */
+		if (as_screenshot_get_media_kind (scr) == AS_SCREENSHOT_MEDIA_KIND_VIDEO)
+			continue;
+
+		source_imgs = asc_screenshot_get_source_images (scr);
+		if (source_imgs == NULL)
+			continue;
+
+		g_hash_table_iter_init (&ht_iter, source_imgs);
+		while (g_hash_table_iter_next (&ht_iter, NULL, &ht_value)) {
+			const gchar *url = as_image_get_url (AS_IMAGE (ht_value));
+			AsCurlRequest *req = NULL;
+
+			if (url == NULL || g_hash_table_contains (prefetch_reqs, url))
+				continue;
+
+			/* skip downloads which the probe cache will most likely satisfy */
+			if (pcache != NULL && store_screenshots) {
+				g_autofree gchar *etag = NULL;
+
+				etag = as_curl_query_etag (acurl, url, NULL);
+				if (etag != NULL) {
+					g_autofree gchar *cached_etag = NULL;
+
+					g_hash_table_insert (prefetch_etags,
+							     g_strdup (url),
+							     g_strdup (etag));
+					cached_etag = g_key_file_get_string (pcache,
+									     url,
+									     "etag",
+									     NULL);
+					if (g_strcmp0 (cached_etag, etag) == 0 &&
+					    g_key_file_has_key (pcache, url, "images", NULL))
+						continue;
+				}
+			}
+
+			req = as_curl_request_new (url, NULL);
+			g_hash_table_insert (prefetch_reqs, g_strdup (url), req);
+			g_ptr_array_add (batch, req);
+		}
+	}
+
+	/* failures are reported as hints when the individual screenshot is processed */
+	if (batch->len > 0)
+		as_curl_download_multi (acurl, batch, NULL);
+}
+
 /**
  * asc_process_screenshots:
  *
@@ -770,6 +1397,7 @@ void
 asc_process_screenshots (AscResult *cres,
 			 AsComponent *cpt,
 			 AsCurl *acurl,
+			 AscScreenshotDedup *dedup,
 			 const gchar *media_export_root,
 			 const gchar *media_url_prefix,
 			 const gssize max_size_bytes,
@@ -778,6 +1406,9 @@ asc_process_screenshots (AscResult *cres,
 {
 	GPtrArray *screenshots = NULL;
 	g_autoptr(GPtrArray) valid_scrs = NULL;
+	g_autoptr(GKeyFile) pcache = NULL;
+	g_autoptr(GHashTable) prefetch_reqs = NULL;
+	g_autoptr(GHashTable) prefetch_etags = NULL;
 	const gchar *gcid = NULL;
 	g_autofree gchar *scr_export_dir = NULL;
 	g_autofree gchar *scr_base_url = NULL;
@@ -818,6 +1449,24 @@ asc_process_screenshots (AscResult *cres,
 					     "screenshots",
 					     NULL);
 
+	/* in the temporary-directory mode all downloads are discarded anyway,
+	 * so a probe cache would never get a hit there */
+	if (store_screenshots)
+		pcache = asc_screenshot_probe_cache_load (scr_export_dir);
+
+	/* fetch all screenshot images of this component at once */
+	prefetch_reqs = g_hash_table_new_full (g_str_hash,
+					       g_str_equal,
+					       g_free,
+					       (GDestroyNotify) as_curl_request_free);
+	prefetch_etags = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	asc_screenshots_prefetch_media (acurl,
+					screenshots,
+					pcache,
+					store_screenshots,
+					prefetch_reqs,
+					prefetch_etags);
+
 	/* process screenshots */
 	valid_scrs = g_ptr_array_new_with_free_func (g_object_unref);
 	for (guint i = 0; i < screenshots->len; i++) {
@@ -830,6 +1479,7 @@ asc_process_screenshots (AscResult *cres,
 									 cpt,
 									 scr,
 									 acurl,
+									 pcache,
 									 scr_export_dir,
 									 scr_base_url,
 									 max_size_bytes,
@@ -840,6 +1490,10 @@ asc_process_screenshots (AscResult *cres,
 								 cpt,
 								 scr,
 								 acurl,
+								 pcache,
+								 dedup,
+								 prefetch_reqs,
+								 prefetch_etags,
 								 scr_export_dir,
 								 scr_base_url,
 								 max_size_bytes,
@@ -858,4 +1512,8 @@ asc_process_screenshots (AscResult *cres,
 	for (guint i = 0; i < valid_scrs->len; i++)
 		as_component_add_screenshot (cpt,
 					     AS_SCREENSHOT (g_ptr_array_index (valid_scrs, i)));
+
+	/* persist the probe cache for the next compose run */
+	if (pcache != NULL)
+		asc_screenshot_probe_cache_save (pcache, scr_export_dir);
 }
@@ -51,13 +51,26 @@ AscVideoInfo *asc_extract_video_info (AscResult *cres, AsComponent *cpt, const g
 AS_INTERNAL_VISIBLE
 void asc_video_info_free (AscVideoInfo *vinfo);
 
-void asc_process_screenshots (AscResult	  *cres,
-			      AsComponent *cpt,
-			      AsCurl	  *acurl,
-			      const gchar *media_export_root,
-			      const gchar *media_url_prefix,
-			      const gssize max_size_bytes,
-			      gboolean	   process_videos,
-			      gboolean	   store_screenshots);
+/**
+ * AscScreenshotDedup: (skip):
+ *
+ * Shared index of already exported screenshot media, used to store
+ * identical media only once across components.
+ */
+typedef struct _AscScreenshotDedup AscScreenshotDedup;
+
+AscScreenshotDedup *asc_screenshot_dedup_new (void);
+void		    asc_screenshot_dedup_free (AscScreenshotDedup *dedup);
+void		    asc_screenshot_dedup_reset (AscScreenshotDedup *dedup);
+
+void asc_process_screenshots (AscResult		 *cres,
+			      AsComponent	 *cpt,
+			      AsCurl		 *acurl,
+			      AscScreenshotDedup *dedup,
+			      const gchar	 *media_export_root,
+			      const gchar	 *media_url_prefix,
+			      const gssize	  max_size_bytes,
+			      gboolean		  process_videos,
+			      gboolean		  store_screenshots);
 
 AS_END_PRIVATE_DECLS
@@ -325,6 +325,11 @@ def update_gui_env_ids(data_header_fname):
         f.write('\n'.join(sorted(gui_envs_raw)))
         f.write('\n')
 
+    # the lookup code binary-searches the generated tables,
+    # so they must be sorted by ID in byte order
+    desktops_list.sort(key=lambda e: e['id'])
+    gui_env_list.sort(key=lambda e: e['id'])
+
     # write C header with all data
     _write_c_array_header(
         'desktop-env-header.tmpl',
@@ -101,26 +101,12 @@ QString Category::icon() const
 
 QList<Category> Category::children() const
 {
-    auto children = as_category_get_children(d->m_category);
-    QList<Category> ret;
-    ret.reserve(children->len);
-    for (uint i = 0; i < children->len; i++) {
-        auto ccat = AS_CATEGORY(g_ptr_array_index(children, i));
-        ret << Category(ccat);
-    }
-    return ret;
+    return wrapPtrArray<Category, AsCategory *>(as_category_get_children(d->m_category));
 }
 
 QStringList Category::desktopGroups() const
 {
-    auto dgs = as_category_get_desktop_groups(d->m_category);
-    QStringList ret;
-    ret.reserve(dgs->len);
-    for (uint i = 0; i < dgs->len; i++) {
-        auto dg = (const gchar *) g_ptr_array_index(dgs, i);
-        ret << valueWrap(dg);
-    }
-    return ret;
+    return valueWrap(as_category_get_desktop_groups(d->m_category));
 }
 
 QDebug operator<<(QDebug s, const AppStream::Category &category)
@@ -131,12 +117,5 @@ QDebug operator<<(QDebug s, const AppStream::Category &category)
 
 QList<Category> getDefaultCategories(bool withSpecial)
 {
-    auto cats = as_get_default_categories(withSpecial);
-    QList<Category> ret;
-    ret.reserve(cats->len);
-    for (uint i = 0; i < cats->len; i++) {
-        auto cat = AS_CATEGORY(g_ptr_array_index(cats, i));
-        ret << Category(cat);
-    }
-    return ret;
+    return wrapPtrArray<Category, AsCategory *>(as_get_default_categories(withSpecial));
 }
@@ -23,6 +23,7 @@
 #pragma GCC visibility push(hidden)
 
 #include <glib.h>
+#include <QList>
 #include <QStringList>
 
 namespace AppStream
@@ -78,6 +79,24 @@ inline QStringList valueWrap(GList *list)
     return res;
 }
 
+/**
+ * Wrap a GPtrArray of C objects into a QList of their Qt wrapper type.
+ * The list is sized once up front and the wrappers are constructed
+ * directly from the C pointers, so returning object lists does not
+ * reallocate or copy through temporaries.
+ */
+template<typename T, typename CPtrT>
+inline QList<T> wrapPtrArray(GPtrArray *array)
+{
+    QList<T> res;
+    if (array == nullptr)
+        return res;
+    res.reserve(array->len);
+    for (uint i = 0; i < array->len; i++)
+        res.append(T(static_cast<CPtrT>(g_ptr_array_index(array, i))));
+    return res;
+}
+
 inline char **stringListToCharArray(const QStringList &list)
 {
     char **array = (char **) g_malloc(sizeof(char *) * list.size() + 1);
@@ -68,6 +68,66 @@ Component ComponentBox::iterator::operator*() const
     return Component(cpt);
 }
 
+ComponentBox::Cursor::Cursor(const ComponentBox *cb)
+    : m_box(cb),
+      m_index(0),
+      m_cpt(nullptr)
+{
+}
+
+bool ComponentBox::Cursor::next()
+{
+    AsComponentBox *cbox = m_box->d->m_cbox;
+    if (m_index >= as_component_box_len(cbox)) {
+        m_cpt = nullptr;
+        return false;
+    }
+    m_cpt = as_component_box_index(cbox, m_index++);
+    return true;
+}
+
+void ComponentBox::Cursor::reset()
+{
+    m_index = 0;
+    m_cpt = nullptr;
+}
+
+static QByteArray rawStringView(const gchar *value)
+{
+    if (value == nullptr)
+        return QByteArray();
+    return QByteArray::fromRawData(value, qstrlen(value));
+}
+
+QByteArray ComponentBox::Cursor::id() const
+{
+    Q_ASSERT(m_cpt != nullptr);
+    return rawStringView(as_component_get_id(AS_COMPONENT(m_cpt)));
+}
+
+QByteArray ComponentBox::Cursor::name() const
+{
+    Q_ASSERT(m_cpt != nullptr);
+    return rawStringView(as_component_get_name(AS_COMPONENT(m_cpt)));
+}
+
+QByteArray ComponentBox::Cursor::summary() const
+{
+    Q_ASSERT(m_cpt != nullptr);
+    return rawStringView(as_component_get_summary(AS_COMPONENT(m_cpt)));
+}
+
+Component ComponentBox::Cursor::component() const
+{
+    Q_ASSERT(m_cpt != nullptr);
+    return Component(AS_COMPONENT(m_cpt));
+}
+
+_AsComponent *ComponentBox::Cursor::cPtr() const
+{
+    return m_cpt;
+}
+
 ComponentBox::ComponentBox(const ComponentBox &other)
     : d(other.d)
 {
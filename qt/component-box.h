@@ -21,6 +21,7 @@
 
 #include <QSharedDataPointer>
 #include <QObject>
+#include <QByteArray>
 #include "appstreamqt_export.h"
 
 #include "component.h"
@@ -89,6 +90,67 @@ public:
         const ComponentBox *data;
     };
 
+    /**
+     * A lightweight cursor over the components of a ComponentBox.
+     *
+     * Unlike the regular iterator, advancing the cursor does not wrap
+     * elements into AppStream::Component objects, and its accessors for
+     * hot fields return views into the underlying C data without copying
+     * or allocating. This makes it suitable for filtering large result
+     * sets in tight loops.
+     *
+     * The returned views borrow their data: they are only valid until the
+     * cursor is advanced or the component box is modified or destroyed.
+     */
+    class APPSTREAMQT_EXPORT Cursor
+    {
+    public:
+        /**
+         * Advance to the next component.
+         * \returns false if the end of the box was reached.
+         */
+        bool next();
+
+        /**
+         * Restart iteration from the beginning of the box.
+         */
+        void reset();
+
+        /**
+         * \returns a borrowed view on the component ID of the current component.
+         */
+        QByteArray id() const;
+
+        /**
+         * \returns a borrowed view on the localized name of the current component.
+         */
+        QByteArray name() const;
+
+        /**
+         * \returns a borrowed view on the localized summary of the current component.
+         */
+        QByteArray summary() const;
+
+        /**
+         * \returns the current component as full Component wrapper.
+         */
+        Component component() const;
+
+        /**
+         * \returns the internally stored AsComponent the cursor points at.
+         */
+        _AsComponent *cPtr() const;
+
+    private:
+        friend class ComponentBox;
+
+        explicit Cursor(const ComponentBox *cb);
+
+        const ComponentBox *m_box;
+        uint m_index;
+        _AsComponent *m_cpt;
+    };
+
     /**
      * ComponentBox::Flags:
      * FlagNone:               No flags.
@@ -119,6 +181,14 @@ public:
      */
     QList<Component> toList() const;
 
+    /**
+     * \returns a cursor for cheap iteration over this component box.
+     */
+    Cursor cursor() const
+    {
+        return Cursor(this);
+    }
+
     iterator begin() const
     {
         return iterator(0, this);
@@ -101,8 +101,51 @@ public:
         return cpt;
     }
 
+    enum StrField {
+        FieldName = 0,
+        FieldSummary,
+        FieldDescription,
+        FieldCount
+    };
+
+    /**
+     * Memoize the UTF-16 conversion of the hottest string getters: QML
+     * delegates call e.g. name() thousands of times per scroll, and
+     * converting the same C string over and over dominates those calls.
+     * The cache follows QString's implicit-sharing thread rules, so no
+     * locking is done here.
+     */
+    QString cachedValue(StrField field, const gchar *(*getter)(AsComponent *)) const
+    {
+        AsContext *ctx = as_component_get_context(cpt);
+        const gchar *locale = ctx ? as_context_get_locale(ctx) : nullptr;
+
+        /* a locale change makes the getters return different strings */
+        if (strCacheLocale != locale) {
+            for (uint i = 0; i < FieldCount; i++)
+                strCacheValid[i] = false;
+            strCacheLocale = locale;
+        }
+
+        if (!strCacheValid[field]) {
+            strCache[field] = valueWrap(getter(cpt));
+            strCacheValid[field] = true;
+        }
+        return strCache[field];
+    }
+
+    void invalidateCachedValue(StrField field)
+    {
+        strCacheValid[field] = false;
+    }
+
     AsComponent *cpt;
     QString lastError;
+
+private:
+    mutable QByteArray strCacheLocale;
+    mutable QString strCache[FieldCount];
+    mutable bool strCacheValid[FieldCount] = {};
 };
 
 Component::Component()
@@ -211,31 +254,34 @@ void AppStream::Component::setSourcePackageName(const QString &sourcePkg)
 
 QString Component::name() const
 {
-    return valueWrap(as_component_get_name(d->cpt));
+    return d->cachedValue(ComponentData::FieldName, as_component_get_name);
 }
 
 void Component::setName(const QString &name, const QString &lang)
 {
+    d->invalidateCachedValue(ComponentData::FieldName);
     as_component_set_name(d->cpt, qPrintable(name), lang.isEmpty() ? NULL : qPrintable(lang));
 }
 
 QString Component::summary() const
 {
-    return valueWrap(as_component_get_summary(d->cpt));
+    return d->cachedValue(ComponentData::FieldSummary, as_component_get_summary);
 }
 
 void Component::setSummary(const QString &summary, const QString &lang)
 {
+    d->invalidateCachedValue(ComponentData::FieldSummary);
     as_component_set_summary(d->cpt, qPrintable(summary), lang.isEmpty() ? NULL : qPrintable(lang));
 }
 
 QString Component::description() const
 {
-    return valueWrap(as_component_get_description(d->cpt));
+    return d->cachedValue(ComponentData::FieldDescription, as_component_get_description);
 }
 
 void Component::setDescription(const QString &description, const QString &lang)
 {
+    d->invalidateCachedValue(ComponentData::FieldDescription);
     as_component_set_description(d->cpt,
                                  qPrintable(description),
                                  lang.isEmpty() ? NULL : qPrintable(lang));
@@ -341,15 +387,7 @@ void AppStream::Component::addExtends(const QString &extend)
 
 QList<AppStream::Component> Component::addons() const
 {
-    QList<AppStream::Component> res;
-
-    auto addons = as_component_get_addons(d->cpt);
-    res.reserve(addons->len);
-    for (uint i = 0; i < addons->len; i++) {
-        auto cpt = AS_COMPONENT(g_ptr_array_index(addons, i));
-        res.append(Component(cpt));
-    }
-    return res;
+    return wrapPtrArray<Component, AsComponent *>(as_component_get_addons(d->cpt));
 }
 
 void AppStream::Component::addAddon(const AppStream::Component &addon)
@@ -369,41 +407,17 @@ void Component::addReplaces(const QString &cid)
 
 QList<Relation> Component::requirements() const
 {
-    QList<AppStream::Relation> res;
-
-    auto reqs = as_component_get_requires(d->cpt);
-    res.reserve(reqs->len);
-    for (uint i = 0; i < reqs->len; i++) {
-        auto rel = AS_RELATION(g_ptr_array_index(reqs, i));
-        res.append(Relation(rel));
-    }
-    return res;
+    return wrapPtrArray<Relation, AsRelation *>(as_component_get_requires(d->cpt));
 }
 
 QList<Relation> Component::recommends() const
 {
-    QList<AppStream::Relation> res;
-
-    auto recommends = as_component_get_recommends(d->cpt);
-    res.reserve(recommends->len);
-    for (uint i = 0; i < recommends->len; i++) {
-        auto rel = AS_RELATION(g_ptr_array_index(recommends, i));
-        res.append(Relation(rel));
-    }
-    return res;
+    return wrapPtrArray<Relation, AsRelation *>(as_component_get_recommends(d->cpt));
 }
 
 QList<Relation> Component::supports() const
 {
-    QList<AppStream::Relation> res;
-
-    auto supports = as_component_get_supports(d->cpt);
-    res.reserve(supports->len);
-    for (uint i = 0; i < supports->len; i++) {
-        auto rel = AS_RELATION(g_ptr_array_index(supports, i));
-        res.append(Relation(rel));
-    }
-    return res;
+    return wrapPtrArray<Relation, AsRelation *>(as_component_get_supports(d->cpt));
 }
 
 void Component::addRelation(const Relation &relation)
@@ -420,12 +434,7 @@ Component::checkRelations(SystemInfo *sysinfo, Pool *pool, Relation::Kind relKin
                                            pool == nullptr ? nullptr : pool->cPtr(),
                                            static_cast<AsRelationKind>(relKind));
 
-    QList<RelationCheckResult> res;
-    res.reserve(cresult->len);
-    for (guint i = 0; i < cresult->len; i++)
-        res.append(RelationCheckResult(AS_RELATION_CHECK_RESULT(g_ptr_array_index(cresult, i))));
-
-    return res;
+    return wrapPtrArray<RelationCheckResult, AsRelationCheckResult *>(cresult);
 }
 
 int Component::calculateSystemCompatibilityScore(SystemInfo *sysinfo,
@@ -469,15 +478,7 @@ void AppStream::Component::addLanguage(const QString &locale, int percentage)
 
 QList<AppStream::Translation> AppStream::Component::translations() const
 {
-    QList<Translation> res;
-
-    auto translations = as_component_get_translations(d->cpt);
-    res.reserve(translations->len);
-    for (uint i = 0; i < translations->len; i++) {
-        auto translation = AS_TRANSLATION(g_ptr_array_index(translations, i));
-        res.append(Translation(translation));
-    }
-    return res;
+    return wrapPtrArray<Translation, AsTranslation *>(as_component_get_translations(d->cpt));
 }
 
 void AppStream::Component::addTranslation(const AppStream::Translation &translation)
@@ -500,15 +501,7 @@ void AppStream::Component::addUrl(AppStream::Component::UrlKind kind, const QStr
 
 QList<Icon> Component::icons() const
 {
-    QList<Icon> res;
-
-    auto icons = as_component_get_icons(d->cpt);
-    res.reserve(icons->len);
-    for (uint i = 0; i < icons->len; i++) {
-        auto icon = AS_ICON(g_ptr_array_index(icons, i));
-        res.append(Icon(icon));
-    }
-    return res;
+    return wrapPtrArray<Icon, AsIcon *>(as_component_get_icons(d->cpt));
 }
 
 Icon Component::icon(const QSize &size) const
@@ -526,15 +519,7 @@ void AppStream::Component::addIcon(const AppStream::Icon &icon)
 
 QList<Provided> Component::provided() const
 {
-    QList<Provided> res;
-
-    auto provEntries = as_component_get_provided(d->cpt);
-    res.reserve(provEntries->len);
-    for (uint i = 0; i < provEntries->len; i++) {
-        auto prov = AS_PROVIDED(g_ptr_array_index(provEntries, i));
-        res.append(Provided(prov));
-    }
-    return res;
+    return wrapPtrArray<Provided, AsProvided *>(as_component_get_provided(d->cpt));
 }
 
 AppStream::Provided Component::provided(Provided::Kind kind) const
@@ -562,15 +547,7 @@ void Component::sortScreenshots(const QString &environment,
 
 QList<Screenshot> Component::screenshotsAll() const
 {
-    QList<Screenshot> res;
-
-    auto screenshots = as_component_get_screenshots_all(d->cpt);
-    res.reserve(screenshots->len);
-    for (uint i = 0; i < screenshots->len; i++) {
-        auto scr = AS_SCREENSHOT(g_ptr_array_index(screenshots, i));
-        res.append(Screenshot(scr));
-    }
-    return res;
+    return wrapPtrArray<Screenshot, AsScreenshot *>(as_component_get_screenshots_all(d->cpt));
 }
 
 void AppStream::Component::addScreenshot(const AppStream::Screenshot &screenshot)
@@ -614,15 +591,7 @@ bool AppStream::Component::hasBundle() const
 
 QList<Bundle> Component::bundles() const
 {
-    QList<Bundle> res;
-
-    auto bdls = as_component_get_bundles(d->cpt);
-    res.reserve(bdls->len);
-    for (uint i = 0; i < bdls->len; i++) {
-        auto bundle = AS_BUNDLE(g_ptr_array_index(bdls, i));
-        res.append(Bundle(bundle));
-    }
-    return res;
+    return wrapPtrArray<Bundle, AsBundle *>(as_component_get_bundles(d->cpt));
 }
 
 Bundle Component::bundle(Bundle::Kind kind) const
@@ -640,15 +609,7 @@ void AppStream::Component::addBundle(const AppStream::Bundle &bundle) const
 
 QList<AppStream::Suggested> AppStream::Component::suggested() const
 {
-    QList<Suggested> res;
-
-    auto suggestions = as_component_get_suggested(d->cpt);
-    res.reserve(suggestions->len);
-    for (uint i = 0; i < suggestions->len; i++) {
-        auto suggestion = AS_SUGGESTED(g_ptr_array_index(suggestions, i));
-        res.append(Suggested(suggestion));
-    }
-    return res;
+    return wrapPtrArray<Suggested, AsSuggested *>(as_component_get_suggested(d->cpt));
 }
 
 void AppStream::Component::addSuggested(const AppStream::Suggested &suggested)
@@ -725,15 +686,8 @@ bool AppStream::Component::insertCustomValue(const QString &key, const QString &
 
 QList<AppStream::ContentRating> AppStream::Component::contentRatings() const
 {
-    QList<ContentRating> res;
-
-    auto ratings = as_component_get_content_ratings(d->cpt);
-    res.reserve(ratings->len);
-    for (uint i = 0; i < ratings->len; i++) {
-        auto rating = AS_CONTENT_RATING(g_ptr_array_index(ratings, i));
-        res.append(ContentRating(rating));
-    }
-    return res;
+    return wrapPtrArray<ContentRating, AsContentRating *>(
+        as_component_get_content_ratings(d->cpt));
 }
 
 AppStream::ContentRating AppStream::Component::contentRating(const QString &kind) const
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2016-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "icon-cache.h"
+#include "icon.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+
+using namespace AppStream;
+
+class AppStream::IconCachePrivate
+{
+public:
+    struct Entry {
+        QUrl url;
+        quint64 generation;
+    };
+
+    explicit IconCachePrivate(uint maxEntries)
+        : generation(0),
+          cache(maxEntries > 0 ? maxEntries : 1)
+    {
+    }
+
+    QMutex mutex;
+    quint64 generation;
+    QCache<QString, Entry> cache;
+};
+
+IconCache::IconCache(uint maxEntries)
+    : d(new IconCachePrivate(maxEntries))
+{
+}
+
+IconCache::~IconCache() { }
+
+QUrl IconCache::iconUrl(const Component &component, const QSize &size)
+{
+    QString key = component.dataId();
+    if (key.isEmpty())
+        key = component.id();
+    key += QLatin1Char('@') + QString::number(size.width()) + QLatin1Char('x')
+           + QString::number(size.height());
+
+    {
+        QMutexLocker locker(&d->mutex);
+        auto *entry = d->cache.object(key);
+        if (entry != nullptr) {
+            if (entry->generation == d->generation)
+                return entry->url;
+            /* stale entry from before the last invalidation */
+            d->cache.remove(key);
+        }
+    }
+
+    /* resolve outside the lock, the icon lookup is the expensive part */
+    const QUrl url = component.icon(size).url();
+
+    {
+        QMutexLocker locker(&d->mutex);
+        d->cache.insert(key, new IconCachePrivate::Entry{ url, d->generation });
+    }
+    return url;
+}
+
+void IconCache::invalidate()
+{
+    QMutexLocker locker(&d->mutex);
+    d->generation++;
+}
+
+void IconCache::clear()
+{
+    QMutexLocker locker(&d->mutex);
+    d->cache.clear();
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2016-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APPSTREAMQT_ICON_CACHE_H
+#define APPSTREAMQT_ICON_CACHE_H
+
+#include "appstreamqt_export.h"
+
+#include <QUrl>
+#include <QSize>
+#include "component.h"
+
+namespace AppStream
+{
+
+/**
+ * Resolves and caches the display icons of components per size.
+ *
+ * Selecting the right icon of a component and constructing its file URL
+ * is cheap once, but item views re-evaluate their delegate bindings on
+ * every relayout, which adds up while scrolling through a large software
+ * store. This cache memoizes the resolved URL per (component, size) with
+ * LRU eviction, and supports O(1) invalidation of all entries for when
+ * the underlying metadata pool is reloaded.
+ *
+ * All functions of this class are thread-safe.
+ */
+class IconCachePrivate;
+class APPSTREAMQT_EXPORT IconCache
+{
+public:
+    explicit IconCache(uint maxEntries = 512);
+    ~IconCache();
+
+    /**
+     * Resolve the icon of \p component matching \p size best, and return
+     * its local file or remote URL. The result is memoized until the
+     * cache is invalidated, so repeated binds are a single hash lookup.
+     * An empty URL is returned (and remembered) for components without a
+     * usable icon.
+     */
+    QUrl iconUrl(const AppStream::Component &component, const QSize &size);
+
+    /**
+     * Mark all cached entries as stale, e.g. after the metadata pool was
+     * reloaded. Stale entries are re-resolved on their next lookup.
+     */
+    void invalidate();
+
+    /** Drop all cached entries immediately. */
+    void clear();
+
+private:
+    Q_DISABLE_COPY(IconCache);
+    QScopedPointer<IconCachePrivate> d;
+};
+}
+
+#endif // APPSTREAMQT_ICON_CACHE_H
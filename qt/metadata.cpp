@@ -23,6 +23,7 @@
 #include "chelpers.h"
 
 #include <QDebug>
+#include <QIODevice>
 
 using namespace AppStream;
 
@@ -227,6 +228,44 @@ QString AppStream::Metadata::componentsToCatalog(AppStream::Metadata::FormatKind
         as_metadata_components_to_catalog(d->m_metadata, (AsFormatKind) format, nullptr));
 }
 
+static gboolean writeChunkToDevice(const gchar *data, gsize data_len, gpointer user_data)
+{
+    auto device = static_cast<QIODevice *>(user_data);
+    qint64 pos = 0;
+
+    while (pos < static_cast<qint64>(data_len)) {
+        const qint64 written = device->write(data + pos, static_cast<qint64>(data_len) - pos);
+        if (written < 0)
+            return FALSE;
+        pos += written;
+    }
+    return TRUE;
+}
+
+AppStream::Metadata::MetadataError
+AppStream::Metadata::componentsToCatalog(QIODevice *device, AppStream::Metadata::FormatKind format)
+{
+    g_autoptr(GError) error = nullptr;
+    as_metadata_components_to_catalog_stream(d->m_metadata,
+                                             (AsFormatKind) format,
+                                             writeChunkToDevice,
+                                             device,
+                                             &error);
+
+    if (error != nullptr) {
+        if (!device->errorString().isEmpty())
+            d->lastError = device->errorString();
+        else
+            d->lastError = QString::fromUtf8(error->message);
+        if (error->domain == AS_METADATA_ERROR)
+            return static_cast<AppStream::Metadata::MetadataError>(error->code);
+        else
+            return AppStream::Metadata::MetadataErrorFailed;
+    }
+
+    return AppStream::Metadata::MetadataErrorNoError;
+}
+
 AppStream::Metadata::MetadataError
 AppStream::Metadata::saveCatalog(const QString &filename, AppStream::Metadata::FormatKind format)
 {
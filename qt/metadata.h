@@ -28,6 +28,7 @@
 
 #include "component-box.h"
 
+class QIODevice;
 struct _AsMetadata;
 namespace AppStream
 {
@@ -115,6 +116,13 @@ public:
 
     QString componentsToCatalog(FormatKind format) const;
 
+    /**
+     * Serialize all components into AppStream catalog metadata and write the
+     * result directly to \a device, without building the complete document
+     * in memory first.
+     */
+    MetadataError componentsToCatalog(QIODevice *device, FormatKind format);
+
     MetadataError saveCatalog(const QString &filename, FormatKind format);
 
     FormatVersion formatVersion() const;
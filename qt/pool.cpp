@@ -25,6 +25,12 @@
 #include <QStringList>
 #include <QUrl>
 #include <QLoggingCategory>
+#include <QThreadPool>
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <QPromise>
+#else
+#include <QFutureInterface>
+#endif
 #include "chelpers.h"
 
 Q_DECLARE_LOGGING_CATEGORY(APPSTREAMQT_POOL)
@@ -200,6 +206,68 @@ ComponentBox Pool::search(const QString &term) const
     return absorbResultToCBox(as_pool_search(d->pool, qPrintable(term)));
 }
 
+template<typename Worker>
+static QFuture<ComponentBox> runPoolQueryAsync(AsPool *cpool, Worker worker)
+{
+    // keep the C pool alive for the duration of the query, even if the
+    // Qt wrapper is destroyed in the meantime
+    g_object_ref(cpool);
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    QPromise<ComponentBox> promise;
+    QFuture<ComponentBox> future = promise.future();
+    QThreadPool::globalInstance()->start(
+        [promise = std::move(promise), cpool, worker = std::move(worker)]() mutable {
+            promise.start();
+            promise.addResult(worker(cpool));
+            promise.finish();
+            g_object_unref(cpool);
+        });
+    return future;
+#else
+    QFutureInterface<ComponentBox> iface;
+    iface.reportStarted();
+    QThreadPool::globalInstance()->start([iface, cpool, worker]() mutable {
+        iface.reportResult(worker(cpool));
+        iface.reportFinished();
+        g_object_unref(cpool);
+    });
+    return iface.future();
+#endif
+}
+
+QFuture<ComponentBox> Pool::searchAsync(const QString &term) const
+{
+    const QByteArray termUtf8 = term.toUtf8();
+    return runPoolQueryAsync(d->pool, [termUtf8](AsPool *cpool) {
+        return absorbResultToCBox(as_pool_search(cpool, termUtf8.constData()));
+    });
+}
+
+QFuture<ComponentBox> Pool::componentsByKindAsync(Component::Kind kind) const
+{
+    return runPoolQueryAsync(d->pool, [kind](AsPool *cpool) {
+        return absorbResultToCBox(
+            as_pool_get_components_by_kind(cpool, static_cast<AsComponentKind>(kind)));
+    });
+}
+
+QFuture<ComponentBox> Pool::componentsByCategoriesAsync(const QStringList &categories) const
+{
+    QVector<QByteArray> utf8Categories;
+    utf8Categories.reserve(categories.size());
+    for (const QString &category : categories)
+        utf8Categories += category.toUtf8();
+
+    return runPoolQueryAsync(d->pool, [utf8Categories](AsPool *cpool) {
+        g_autofree gchar **cats_strv = g_new0(gchar *, utf8Categories.size() + 1);
+        for (int i = 0; i < utf8Categories.size(); ++i)
+            cats_strv[i] = (gchar *) utf8Categories[i].constData();
+
+        return absorbResultToCBox(as_pool_get_components_by_categories(cpool, cats_strv));
+    });
+}
+
 void Pool::setLocale(const QString &locale)
 {
     as_pool_set_locale(d->pool, qPrintable(locale));
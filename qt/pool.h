@@ -25,6 +25,7 @@
 #include <QString>
 #include <QList>
 #include <QStringList>
+#include <QFuture>
 #include "component-box.h"
 #include "metadata.h"
 
@@ -127,6 +128,25 @@ public:
 
     ComponentBox search(const QString &term) const;
 
+    /**
+     * Search the pool asynchronously on a worker thread, so the GUI
+     * thread is never blocked by the query.
+     * \returns a future delivering the resulting ComponentBox.
+     */
+    QFuture<ComponentBox> searchAsync(const QString &term) const;
+
+    /**
+     * Fetch components of the given kind asynchronously on a worker thread.
+     * \returns a future delivering the resulting ComponentBox.
+     */
+    QFuture<ComponentBox> componentsByKindAsync(Component::Kind kind) const;
+
+    /**
+     * Fetch components in the given categories asynchronously on a worker thread.
+     * \returns a future delivering the resulting ComponentBox.
+     */
+    QFuture<ComponentBox> componentsByCategoriesAsync(const QStringList &categories) const;
+
     void setLocale(const QString &locale);
 
     Pool::Flags flags() const;
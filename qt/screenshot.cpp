@@ -122,26 +122,14 @@ void Screenshot::setEnvironment(const QString &guiEnvId)
     as_screenshot_set_environment(d->m_scr, qPrintable(guiEnvId));
 }
 
-static QList<Image> imagesPtrArrayToList(GPtrArray *images)
-{
-    QList<Image> res;
-
-    res.reserve(images->len);
-    for (uint i = 0; i < images->len; i++) {
-        auto img = AS_IMAGE(g_ptr_array_index(images, i));
-        res.append(Image(img));
-    }
-    return res;
-}
-
 QList<Image> Screenshot::images() const
 {
-    return imagesPtrArrayToList(as_screenshot_get_images(d->m_scr));
+    return wrapPtrArray<Image, AsImage *>(as_screenshot_get_images(d->m_scr));
 }
 
 QList<Image> Screenshot::imagesAll() const
 {
-    return imagesPtrArrayToList(as_screenshot_get_images_all(d->m_scr));
+    return wrapPtrArray<Image, AsImage *>(as_screenshot_get_images_all(d->m_scr));
 }
 
 std::optional<Image> Screenshot::image(uint width, uint height, uint scale) const
@@ -154,26 +142,14 @@ std::optional<Image> Screenshot::image(uint width, uint height, uint scale) cons
     return res;
 }
 
-static QList<Video> videosPtrArrayToList(GPtrArray *videos)
-{
-    QList<Video> res;
-
-    res.reserve(videos->len);
-    for (uint i = 0; i < videos->len; i++) {
-        auto vid = AS_VIDEO(g_ptr_array_index(videos, i));
-        res.append(Video(vid));
-    }
-    return res;
-}
-
 QList<Video> Screenshot::videos() const
 {
-    return videosPtrArrayToList(as_screenshot_get_videos(d->m_scr));
+    return wrapPtrArray<Video, AsVideo *>(as_screenshot_get_videos(d->m_scr));
 }
 
 QList<Video> Screenshot::videosAll() const
 {
-    return videosPtrArrayToList(as_screenshot_get_videos_all(d->m_scr));
+    return wrapPtrArray<Video, AsVideo *>(as_screenshot_get_videos_all(d->m_scr));
 }
 
 QDebug operator<<(QDebug s, const AppStream::Screenshot &screenshot)
@@ -22,6 +22,8 @@
 #include <QObject>
 #include <QTemporaryFile>
 #include "pool.h"
+#include "icon.h"
+#include "icon-cache.h"
 #include "testpaths.h"
 
 class PoolReadTest : public QObject
@@ -30,6 +32,7 @@ class PoolReadTest : public QObject
 private Q_SLOTS:
     void testRead01();
     void testLoadAsync();
+    void testIconCache();
 };
 
 using namespace AppStream;
@@ -114,6 +117,38 @@ void PoolReadTest::testLoadAsync()
     QCOMPARE(cpt.name(), QLatin1String("Neverball"));
 }
 
+void PoolReadTest::testIconCache()
+{
+    Component cpt;
+    cpt.setId(QLatin1String("org.example.IconCacheTest"));
+
+    Icon icon;
+    icon.setKind(Icon::KindCached);
+    icon.setWidth(64);
+    icon.setHeight(64);
+    icon.setUrl(QUrl::fromLocalFile(QLatin1String("/usr/share/app-info/icons/test_64.png")));
+    cpt.addIcon(icon);
+
+    IconCache cache;
+    const QUrl url = cache.iconUrl(cpt, QSize(64, 64));
+    QVERIFY(url.isLocalFile());
+
+    // repeated lookups must be served from the cache and stay consistent
+    QCOMPARE(cache.iconUrl(cpt, QSize(64, 64)), url);
+
+    // stale entries must be resolved again after invalidation
+    cache.invalidate();
+    QCOMPARE(cache.iconUrl(cpt, QSize(64, 64)), url);
+
+    // a component without icons yields an empty (but still cached) URL
+    Component emptyCpt;
+    emptyCpt.setId(QLatin1String("org.example.NoIcon"));
+    QVERIFY(cache.iconUrl(emptyCpt, QSize(64, 64)).isEmpty());
+
+    cache.clear();
+    QCOMPARE(cache.iconUrl(cpt, QSize(64, 64)), url);
+}
+
 QTEST_MAIN(PoolReadTest)
 
 #include "asqt-pool-test.moc"
@@ -31,6 +31,7 @@
 #include <as-provided.h>
 #include <as-metadata.h>
 #include <as-pool.h>
+#include <as-pool-snapshot.h>
 #include <as-category.h>
 #include <as-developer.h>
 #include <as-icon.h>
@@ -259,7 +259,7 @@ as_agreement_section_load_from_xml (AsAgreementSection *agreement_section,
 	}
 
 	for (iter = node->children; iter != NULL; iter = iter->next) {
-		g_autofree gchar *lang = NULL;
+		const gchar *lang = NULL;
 		if (iter->type != XML_ELEMENT_NODE)
 			continue;
 
@@ -148,7 +148,7 @@ as_artifact_init (AsArtifact *artifact)
 {
 	AsArtifactPrivate *priv = GET_PRIVATE (artifact);
 
-	priv->locations = g_ptr_array_new_with_free_func (g_free);
+	priv->locations = g_ptr_array_new_with_free_func ((GDestroyNotify) as_ref_string_release);
 	priv->checksums = g_ptr_array_new_with_free_func (g_object_unref);
 	priv->bundle_kind = AS_BUNDLE_KIND_UNKNOWN;
 
@@ -211,7 +211,10 @@ void
 as_artifact_add_location (AsArtifact *artifact, const gchar *location)
 {
 	AsArtifactPrivate *priv = GET_PRIVATE (artifact);
-	g_ptr_array_add (priv->locations, g_strdup (location));
+
+	/* intern the location URL, the same artifact data is frequently
+	 * loaded many times from different catalogs */
+	g_ptr_array_add (priv->locations, g_ref_string_new_intern (location));
 }
 
 /**
@@ -416,22 +419,24 @@ as_artifact_load_from_xml (AsArtifact *artifact, AsContext *ctx, xmlNode *node,
 
 	for (xmlNode *iter = node->children; iter != NULL; iter = iter->next) {
 		g_autofree gchar *content = NULL;
+		AsTag tag_id;
 		if (iter->type != XML_ELEMENT_NODE)
 			continue;
+		tag_id = as_xml_tag_from_string ((const gchar *) iter->name);
 
-		if (g_strcmp0 ((gchar *) iter->name, "location") == 0) {
+		if (tag_id == AS_TAG_LOCATION) {
 			content = as_xml_get_node_value (iter);
 			as_artifact_add_location (artifact, content);
-		} else if (g_strcmp0 ((gchar *) iter->name, "filename") == 0) {
+		} else if (tag_id == AS_TAG_FILENAME) {
 			g_free (priv->filename);
 			priv->filename = as_xml_get_node_value (iter);
-		} else if (g_strcmp0 ((gchar *) iter->name, "checksum") == 0) {
+		} else if (tag_id == AS_TAG_CHECKSUM) {
 			g_autoptr(AsChecksum) cs = NULL;
 
 			cs = as_checksum_new ();
 			if (as_checksum_load_from_xml (cs, ctx, iter, NULL))
 				as_artifact_add_checksum (artifact, cs);
-		} else if (g_strcmp0 ((gchar *) iter->name, "size") == 0) {
+		} else if (tag_id == AS_TAG_SIZE) {
 			AsSizeKind s_kind;
 			gchar *prop = as_xml_get_prop_value (iter, "type");
 
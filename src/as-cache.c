@@ -34,13 +34,23 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <string.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+#endif
 #include <glib/gstdio.h>
 #include <glib/gi18n-lib.h>
 #include <xmlb.h>
 
 #include "as-utils-private.h"
 #include "as-context-private.h"
+#include "as-profile.h"
 #include "as-component-private.h"
 #include "as-component-box-private.h"
 #include "as-launchable.h"
@@ -52,12 +62,30 @@ typedef struct {
 	gboolean default_paths_changed;
 
 	AsContext *context;
+	AsProfile *profile;
 	GPtrArray *sections;
 	GHashTable *masked;
 
 	AsCacheDataRefineFn cpt_refine_func;
 	gboolean prefer_os_metainfo;
 	gboolean auto_resolve_addons;
+	gboolean throttled;
+	gboolean cluster_hot_fields;
+
+	AsPoolProgressFn progress_func;
+	gpointer progress_func_udata;
+	GCancellable *cancellable;
+
+	gboolean query_stats_enabled;
+	GHashTable *query_stats; /* utf8 -> AsCacheQueryStat */
+	GMutex query_stats_mutex;
+
+	GHashTable *hot_cpts; /* utf8 -> AsCacheHotEntry */
+	guint hot_generation;
+	GMutex hot_cpts_mutex;
+
+	GKeyFile *generation_kf; /* lazily loaded generation manifest, or NULL */
+	GMutex generation_mutex;
 
 	GRWLock rw_lock;
 } AsCachePrivate;
@@ -68,6 +96,68 @@ G_DEFINE_TYPE_WITH_PRIVATE (AsCache, as_cache, G_TYPE_OBJECT)
 /* location of the system-wide cache */
 static const gchar *AS_APPSTREAM_SYS_CACHE_DIR = "/var/cache/swcatalog/cache";
 
+/* process-wide usage counters, always-on and updated with atomic adds so
+ * they can be read cheaply (e.g. by `appstreamcli status`) to spot issues
+ * like pathological cache reload loops without attaching a profiler */
+static gsize as_cache_ctr_queries_served = 0;
+static gsize as_cache_ctr_sections_loaded = 0;
+static gsize as_cache_ctr_cpts_materialized = 0;
+static gsize as_cache_ctr_bytes_mapped = 0;
+
+#define as_cache_counter_add(counter, value) \
+	g_atomic_pointer_add (&(counter), (gssize) (value))
+
+/**
+ * as_cache_get_usage_counters:
+ * @counters: an #AsCacheUsageCounters to fill with the current values.
+ *
+ * Retrieve a snapshot of the process-wide cache usage counters.
+ */
+void
+as_cache_get_usage_counters (AsCacheUsageCounters *counters)
+{
+	g_return_if_fail (counters != NULL);
+
+	counters->queries_served = (guint64) g_atomic_pointer_get (&as_cache_ctr_queries_served);
+	counters->sections_loaded = (guint64) g_atomic_pointer_get (&as_cache_ctr_sections_loaded);
+	counters->components_materialized = (guint64) g_atomic_pointer_get (
+	    &as_cache_ctr_cpts_materialized);
+	counters->bytes_mapped = (guint64) g_atomic_pointer_get (&as_cache_ctr_bytes_mapped);
+}
+
+/**
+ * AsCacheQueryShape:
+ *
+ * Typed identifiers for the fixed query shapes used by the high-level
+ * lookup functions. Each shape maps to one canonical XPath expression
+ * with value bindings and is compiled at most once per cache section,
+ * so running a typed query involves no string construction, parsing
+ * or hashing on the hot path.
+ */
+typedef enum {
+	AS_CACHE_QUERY_SHAPE_ALL,
+	AS_CACHE_QUERY_SHAPE_BY_ID,
+	AS_CACHE_QUERY_SHAPE_BY_PROVIDED_ID,
+	AS_CACHE_QUERY_SHAPE_BY_KIND,
+	AS_CACHE_QUERY_SHAPE_BY_PKGNAME,
+	AS_CACHE_QUERY_SHAPE_BY_PKGNAME_PREFIX,
+	AS_CACHE_QUERY_SHAPE_COLD_BY_IDX,
+	/*< private >*/
+	AS_CACHE_QUERY_SHAPE_LAST
+} AsCacheQueryShape;
+
+static const gchar *as_cache_query_shape_xpaths[AS_CACHE_QUERY_SHAPE_LAST] = {
+	[AS_CACHE_QUERY_SHAPE_ALL]	      = "components/component",
+	[AS_CACHE_QUERY_SHAPE_BY_ID]	      = "components/component/id[lower-case(text())=?]/..",
+	[AS_CACHE_QUERY_SHAPE_BY_PROVIDED_ID] =
+	    "components/component/provides/id[lower-case(text())=?]/../..",
+	[AS_CACHE_QUERY_SHAPE_BY_KIND]	  = "components/component[@type=?]",
+	[AS_CACHE_QUERY_SHAPE_BY_PKGNAME] = "components/component/pkgname[text()=?]/..",
+	[AS_CACHE_QUERY_SHAPE_BY_PKGNAME_PREFIX] =
+	    "components/component/pkgname[starts-with(text(),?)]/..",
+	[AS_CACHE_QUERY_SHAPE_COLD_BY_IDX] = "components/_asi_cold/c[@i=?]",
+};
+
 typedef struct {
 	gboolean is_os_data;
 	gboolean is_mask;
@@ -77,6 +167,28 @@ typedef struct {
 	XbSilo *silo;
 	gchar *fname;
 
+	GHashTable *query_cache; /* utf8->XbQuery */
+	GMutex query_cache_mutex;
+	XbQuery *shape_queries[AS_CACHE_QUERY_SHAPE_LAST]; /* compiled typed queries */
+
+	guint8 *bloom; /* token bloom filter bits, or NULL */
+	gsize bloom_nbits;
+
+	guint8 *id_bloom; /* component/provided ID bloom filter bits, or NULL */
+	gsize id_bloom_nbits;
+
+	guint8 *catmap; /* per-component category bitmap rows, or NULL */
+	guint catmap_row_len;
+	guint catmap_n_rows;
+	GHashTable *catmap_index; /* category name -> bit index + 1 */
+
+	gboolean rev_indexes_built;
+	GHashTable *extends_index;  /* extended ID -> GPtrArray of XbNode */
+	GHashTable *suggests_index; /* suggested ID -> GPtrArray of XbNode */
+
+	gboolean provided_index_built;
+	GHashTable *provided_index; /* provided kind+item -> GPtrArray of XbNode */
+
 	gpointer refine_func_udata;
 } AsCacheSection;
 
@@ -87,19 +199,348 @@ as_cache_section_new (const gchar *key)
 	csec = g_new0 (AsCacheSection, 1);
 	csec->format_style = AS_FORMAT_STYLE_CATALOG;
 	csec->key = g_strdup (key);
+	csec->query_cache = g_hash_table_new_full (g_str_hash,
+						   g_str_equal,
+						   g_free,
+						   g_object_unref);
+	g_mutex_init (&csec->query_cache_mutex);
 	return csec;
 }
 
+/* name suffix and header magic of cache section readahead hint files */
+#define AS_CACHE_RAH_SUFFIX ".rahint"
+#define AS_CACHE_RAH_MAGIC  "ASRAH1"
+
+/**
+ * as_cache_section_save_readahead_hints:
+ *
+ * Record which regions of this section's silo file are currently resident
+ * in the page cache, which approximates the pages that were actually
+ * touched while the section was in use. The regions are written to a hint
+ * file next to the silo, so the next cache load can page them in up front
+ * instead of faulting them in one random read at a time.
+ */
+static void
+as_cache_section_save_readahead_hints (AsCacheSection *csec)
+{
+#ifdef __linux__
+	g_autofree gchar *hint_fname = NULL;
+	g_autofree gchar *dirname = NULL;
+	g_autofree guchar *vec = NULL;
+	g_autoptr(GString) hints = NULL;
+	GStatBuf sbuf;
+	gpointer map;
+	gsize n_pages;
+	gsize page_size;
+	gssize region_start = -1;
+	gint fd;
+
+	if (csec->fname == NULL)
+		return;
+
+	/* don't attempt to record hints for locations we can not write to anyway */
+	dirname = g_path_get_dirname (csec->fname);
+	if (!as_utils_is_writable (dirname))
+		return;
+
+	fd = g_open (csec->fname, O_RDONLY, 0);
+	if (fd < 0)
+		return;
+	if (fstat (fd, &sbuf) != 0 || sbuf.st_size <= 0) {
+		close (fd);
+		return;
+	}
+
+	map = mmap (NULL, (gsize) sbuf.st_size, PROT_NONE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		close (fd);
+		return;
+	}
+
+	page_size = (gsize) sysconf (_SC_PAGESIZE);
+	n_pages = ((gsize) sbuf.st_size + page_size - 1) / page_size;
+	vec = g_malloc0 (n_pages);
+	if (mincore (map, (gsize) sbuf.st_size, vec) != 0) {
+		munmap (map, (gsize) sbuf.st_size);
+		close (fd);
+		return;
+	}
+	munmap (map, (gsize) sbuf.st_size);
+	close (fd);
+
+	hints = g_string_new (AS_CACHE_RAH_MAGIC);
+	g_string_append_printf (hints, " %" G_GINT64_FORMAT "\n", (gint64) sbuf.st_mtime);
+
+	/* write out runs of consecutive resident pages as offset/length pairs */
+	for (gsize i = 0; i <= n_pages; i++) {
+		gboolean resident = (i < n_pages) && (vec[i] & 0x01) != 0;
+
+		if (resident && region_start < 0) {
+			region_start = (gssize) i;
+		} else if (!resident && region_start >= 0) {
+			g_string_append_printf (hints,
+						"%" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT "\n",
+						(guint64) region_start * page_size,
+						(guint64) (i - (gsize) region_start) * page_size);
+			region_start = -1;
+		}
+	}
+
+	hint_fname = g_strconcat (csec->fname, AS_CACHE_RAH_SUFFIX, NULL);
+	if (!g_file_set_contents (hint_fname, hints->str, (gssize) hints->len, NULL))
+		g_debug ("Unable to write cache readahead hints to %s", hint_fname);
+#endif
+}
+
+/**
+ * as_cache_section_apply_readahead_hints:
+ *
+ * Ask the kernel to read the silo regions recorded during a previous run
+ * ahead of time. Cold cache loads are otherwise dominated by random
+ * page-in of the memory-mapped silo, so starting one batched read for the
+ * known-needed regions up front hides most of the I/O latency.
+ */
+static void
+as_cache_section_apply_readahead_hints (const gchar *fname)
+{
+#ifdef __linux__
+	g_autofree gchar *hint_fname = NULL;
+	g_autofree gchar *hint_data = NULL;
+	g_auto(GStrv) lines = NULL;
+	GStatBuf sbuf;
+	gint64 hint_mtime;
+	gint fd;
+
+	hint_fname = g_strconcat (fname, AS_CACHE_RAH_SUFFIX, NULL);
+	if (!g_file_get_contents (hint_fname, &hint_data, NULL, NULL))
+		return;
+
+	lines = g_strsplit (hint_data, "\n", -1);
+	if (lines[0] == NULL || !g_str_has_prefix (lines[0], AS_CACHE_RAH_MAGIC " "))
+		return;
+
+	/* ignore the hints if the silo was rebuilt since they were recorded */
+	if (g_stat (fname, &sbuf) != 0)
+		return;
+	hint_mtime = g_ascii_strtoll (lines[0] + strlen (AS_CACHE_RAH_MAGIC) + 1, NULL, 10);
+	if (hint_mtime != (gint64) sbuf.st_mtime)
+		return;
+
+	fd = g_open (fname, O_RDONLY, 0);
+	if (fd < 0)
+		return;
+	for (guint i = 1; lines[i] != NULL; i++) {
+		guint64 offset;
+		guint64 length;
+		gchar *end = NULL;
+
+		if (lines[i][0] == '\0')
+			continue;
+		offset = g_ascii_strtoull (lines[i], &end, 10);
+		if (end == NULL || *end != ' ')
+			continue;
+		length = g_ascii_strtoull (end + 1, NULL, 10);
+		if (length == 0)
+			continue;
+		posix_fadvise (fd, (off_t) offset, (off_t) length, POSIX_FADV_WILLNEED);
+	}
+	close (fd);
+#endif
+}
+
 static void
 as_cache_section_free (AsCacheSection *csec)
 {
+	/* remember which silo regions were in use, to speed up the next load */
+	if (!csec->is_mask)
+		as_cache_section_save_readahead_hints (csec);
+
 	g_free (csec->key);
 	g_free (csec->fname);
+	g_hash_table_unref (csec->query_cache);
+	for (guint i = 0; i < AS_CACHE_QUERY_SHAPE_LAST; i++)
+		g_clear_object (&csec->shape_queries[i]);
+	g_mutex_clear (&csec->query_cache_mutex);
+	g_free (csec->bloom);
+	g_free (csec->id_bloom);
+	g_free (csec->catmap);
+	if (csec->catmap_index != NULL)
+		g_hash_table_unref (csec->catmap_index);
+	if (csec->extends_index != NULL)
+		g_hash_table_unref (csec->extends_index);
+	if (csec->suggests_index != NULL)
+		g_hash_table_unref (csec->suggests_index);
+	if (csec->provided_index != NULL)
+		g_hash_table_unref (csec->provided_index);
 	if (csec->silo != NULL)
 		g_object_unref (csec->silo);
 	g_free (csec);
 }
 
+/* maximum number of memoized hot-component lookup results */
+#define AS_CACHE_HOT_CPTS_MAX 64
+
+typedef struct {
+	GPtrArray *cpts; /* of AsComponent, fully materialized */
+	guint generation;
+	gint64 last_used;
+} AsCacheHotEntry;
+
+static void
+as_cache_hot_entry_free (AsCacheHotEntry *entry)
+{
+	g_ptr_array_unref (entry->cpts);
+	g_free (entry);
+}
+
+/**
+ * as_cache_hot_cpts_invalidate:
+ *
+ * Bump the cache generation and drop all memoized hot components.
+ * This must be called whenever cache sections are added, replaced or
+ * removed, or when component masks change, as any previously
+ * materialized result may be stale afterwards.
+ */
+static void
+as_cache_hot_cpts_invalidate (AsCache *cache)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->hot_cpts_mutex);
+
+	priv->hot_generation++;
+	g_hash_table_remove_all (priv->hot_cpts);
+}
+
+/**
+ * as_cache_hot_cpts_lookup:
+ *
+ * Check whether components for the given lowercased ID have already been
+ * materialized with the current cache contents, and if so return them
+ * without touching any silo.
+ *
+ * Returns: (transfer full) (nullable): The memoized result, or %NULL on a cache miss.
+ */
+static AsComponentBox *
+as_cache_hot_cpts_lookup (AsCache *cache, const gchar *id_lower)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	AsCacheHotEntry *entry;
+	g_autoptr(AsComponentBox) result = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->hot_cpts_mutex);
+
+	entry = g_hash_table_lookup (priv->hot_cpts, id_lower);
+	if (entry == NULL)
+		return NULL;
+	if (entry->generation != priv->hot_generation) {
+		/* stale leftover from before the last invalidation */
+		g_hash_table_remove (priv->hot_cpts, id_lower);
+		return NULL;
+	}
+
+	entry->last_used = g_get_monotonic_time ();
+	result = as_component_box_new_simple ();
+	for (guint i = 0; i < entry->cpts->len; i++)
+		as_component_box_add (result, g_ptr_array_index (entry->cpts, i), NULL);
+
+	return g_steal_pointer (&result);
+}
+
+/**
+ * as_cache_hot_cpts_insert:
+ *
+ * Memoize a fully materialized lookup result, evicting the least
+ * recently used entry if the hot-component cache is full.
+ */
+static void
+as_cache_hot_cpts_insert (AsCache *cache, const gchar *id_lower, AsComponentBox *result)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	AsCacheHotEntry *entry;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->hot_cpts_mutex);
+
+	if (g_hash_table_size (priv->hot_cpts) >= AS_CACHE_HOT_CPTS_MAX) {
+		GHashTableIter ht_iter;
+		gpointer ht_key, ht_value;
+		const gchar *lru_key = NULL;
+		gint64 lru_used = G_MAXINT64;
+
+		g_hash_table_iter_init (&ht_iter, priv->hot_cpts);
+		while (g_hash_table_iter_next (&ht_iter, &ht_key, &ht_value)) {
+			AsCacheHotEntry *e = ht_value;
+			if (e->last_used < lru_used) {
+				lru_used = e->last_used;
+				lru_key = ht_key;
+			}
+		}
+		if (lru_key != NULL)
+			g_hash_table_remove (priv->hot_cpts, lru_key);
+	}
+
+	entry = g_new0 (AsCacheHotEntry, 1);
+	entry->generation = priv->hot_generation;
+	entry->last_used = g_get_monotonic_time ();
+	entry->cpts = g_ptr_array_new_full (as_component_box_len (result), g_object_unref);
+	for (guint i = 0; i < as_component_box_len (result); i++)
+		g_ptr_array_add (entry->cpts,
+				 g_object_ref (as_component_box_index (result, i)));
+
+	g_hash_table_insert (priv->hot_cpts, g_strdup (id_lower), entry);
+}
+
+/**
+ * as_cache_section_get_query:
+ *
+ * Fetch a compiled #XbQuery for the given XPath expression from the
+ * section's prepared-query cache, compiling and memoizing it on first use.
+ * Compiled queries are immutable (values are bound per-call through an
+ * #XbQueryContext), so a single instance can be shared between lookups
+ * and threads.
+ *
+ * Returns: (transfer full): The compiled query, or %NULL on error.
+ */
+static XbQuery *
+as_cache_section_get_query (AsCacheSection *csec, const gchar *xpath, GError **error)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&csec->query_cache_mutex);
+	XbQuery *query;
+
+	query = g_hash_table_lookup (csec->query_cache, xpath);
+	if (query != NULL)
+		return g_object_ref (query);
+
+	query = xb_query_new (csec->silo, xpath, error);
+	if (query == NULL)
+		return NULL;
+	g_hash_table_insert (csec->query_cache, g_strdup (xpath), g_object_ref (query));
+
+	return query;
+}
+
+/**
+ * as_cache_section_get_shape_query:
+ *
+ * Fetch the compiled #XbQuery for a fixed query shape, compiling it on
+ * first use. Unlike as_cache_section_get_query(), the prepared query is
+ * found by a plain array index, without hashing any query string.
+ *
+ * Returns: (transfer full): The compiled query, or %NULL on error.
+ */
+static XbQuery *
+as_cache_section_get_shape_query (AsCacheSection *csec, AsCacheQueryShape shape, GError **error)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&csec->query_cache_mutex);
+
+	if (csec->shape_queries[shape] == NULL) {
+		csec->shape_queries[shape] = xb_query_new (csec->silo,
+							   as_cache_query_shape_xpaths[shape],
+							   error);
+		if (csec->shape_queries[shape] == NULL)
+			return NULL;
+	}
+
+	return g_object_ref (csec->shape_queries[shape]);
+}
+
 static gint
 as_cache_section_cmp (gconstpointer a, gconstpointer b)
 {
@@ -157,6 +598,18 @@ as_cache_init (AsCache *cache)
 	priv->sections = g_ptr_array_new_with_free_func ((GDestroyNotify) as_cache_section_free);
 	priv->masked = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 
+	priv->query_stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	g_mutex_init (&priv->query_stats_mutex);
+
+	priv->hot_cpts = g_hash_table_new_full (g_str_hash,
+						g_str_equal,
+						g_free,
+						(GDestroyNotify) as_cache_hot_entry_free);
+	g_mutex_init (&priv->hot_cpts_mutex);
+	g_mutex_init (&priv->generation_mutex);
+
+	priv->profile = as_profile_new ();
+
 	priv->context = as_context_new ();
 	as_context_set_style (priv->context, AS_FORMAT_STYLE_CATALOG);
 	/* we need to write some special tags only used in the cache */
@@ -197,8 +650,16 @@ as_cache_finalize (GObject *object)
 	g_free (priv->system_cache_dir);
 	as_ref_string_release (priv->locale);
 	g_object_unref (priv->context);
+	g_object_unref (priv->profile);
 	g_ptr_array_unref (priv->sections);
 	g_hash_table_unref (priv->masked);
+	g_clear_object (&priv->cancellable);
+	g_hash_table_unref (priv->query_stats);
+	g_mutex_clear (&priv->query_stats_mutex);
+	g_hash_table_unref (priv->hot_cpts);
+	g_mutex_clear (&priv->hot_cpts_mutex);
+	g_clear_pointer (&priv->generation_kf, g_key_file_unref);
+	g_mutex_clear (&priv->generation_mutex);
 
 	g_rw_lock_writer_unlock (&priv->rw_lock);
 	g_rw_lock_clear (&priv->rw_lock);
@@ -264,6 +725,22 @@ as_cache_set_locale (AsCache *cache, const gchar *locale)
 	as_context_set_locale (priv->context, priv->locale);
 }
 
+/**
+ * as_cache_set_locale_strict:
+ * @cache: an #AsCache instance.
+ * @strict: %TRUE to only read the active locale.
+ *
+ * If set to %TRUE, components read back from the cache will only carry
+ * the active locale and the untranslated fallback, ignoring other
+ * compatible locale variants stored in the cache sections.
+ */
+void
+as_cache_set_locale_strict (AsCache *cache, gboolean strict)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	as_context_set_locale_strict (priv->context, strict);
+}
+
 /**
  * as_cache_set_locations:
  * @cache: an #AsCache instance.
@@ -291,6 +768,239 @@ as_cache_set_locations (AsCache *cache, const gchar *system_cache_dir, const gch
 	g_free (priv->system_cache_dir);
 	priv->system_cache_dir = g_strdup (system_cache_dir);
 	priv->default_paths_changed = TRUE;
+
+	/* the generation manifest lives in the cache directory as well */
+	g_clear_pointer (&priv->generation_kf, g_key_file_unref);
+}
+
+/* name of the manifest file summarizing the state of all metadata source
+ * locations the cache contents were generated from */
+#define AS_CACHE_GENERATION_MANIFEST_FNAME "generation.manifest"
+
+/**
+ * as_cache_generation_get_keyfile:
+ *
+ * Get the lazily-loaded generation manifest keyfile of this cache.
+ * The caller must hold the generation mutex.
+ */
+static GKeyFile *
+as_cache_generation_get_keyfile (AsCache *cache)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+
+	if (priv->generation_kf == NULL) {
+		g_autofree gchar *fname = NULL;
+
+		priv->generation_kf = g_key_file_new ();
+		fname = g_build_filename (priv->cache_root_dir,
+					  AS_CACHE_GENERATION_MANIFEST_FNAME,
+					  NULL);
+		/* a missing or broken manifest just means we have no fast path */
+		g_key_file_load_from_file (priv->generation_kf, fname, G_KEY_FILE_NONE, NULL);
+	}
+
+	return priv->generation_kf;
+}
+
+/**
+ * as_cache_generation_stat_location:
+ *
+ * Build the "mtime:ctime:size:path" state entry for a single
+ * source location.
+ */
+static gchar *
+as_cache_generation_stat_location (const gchar *location)
+{
+	GStatBuf sbuf;
+
+	if (g_stat (location, &sbuf) != 0)
+		return g_strdup_printf ("-1:-1:-1:%s", location);
+	return g_strdup_printf ("%" G_GINT64_FORMAT ":%" G_GINT64_FORMAT ":%" G_GINT64_FORMAT
+				":%s",
+				(gint64) sbuf.st_mtime,
+				(gint64) sbuf.st_ctime,
+				(gint64) sbuf.st_size,
+				location);
+}
+
+/**
+ * as_cache_generation_check_sources:
+ * @cache: an #AsCache instance.
+ * @scope: Component scope of the cache section.
+ * @cache_key: Cache key of the section the sources belong to.
+ * @locations: (array zero-terminated=1): The current metadata source locations.
+ *
+ * Check whether the given source locations are unchanged compared to the
+ * state recorded in the cache generation manifest, using only one stat()
+ * call per location instead of enumerating every file in them.
+ * This relies on directory timestamps, which change whenever entries are
+ * added, removed or replaced - the way package managers ship metadata.
+ * Truly in-place file modifications are only caught by the slow path, so
+ * callers must fall back to it whenever this function returns %NULL and
+ * when a forced refresh was requested.
+ *
+ * Returns: (transfer full) (nullable): The recorded source fingerprint if
+ * no location changed, or %NULL if the state must be determined the slow way.
+ */
+gchar *
+as_cache_generation_check_sources (AsCache *cache,
+				   AsComponentScope scope,
+				   const gchar *cache_key,
+				   const gchar *const *locations)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->generation_mutex);
+	GKeyFile *kf = as_cache_generation_get_keyfile (cache);
+	g_autofree gchar *group = NULL;
+	guint n_locations;
+	gint n_sources;
+
+	group = g_strconcat (as_component_scope_to_string (scope), ":", cache_key, NULL);
+
+	n_locations = g_strv_length ((gchar **) locations);
+	n_sources = g_key_file_get_integer (kf, group, "n_sources", NULL);
+	if (n_sources <= 0 || (guint) n_sources != n_locations)
+		return NULL;
+
+	for (guint i = 0; i < n_locations; i++) {
+		g_autofree gchar *key = g_strdup_printf ("source_%u", i);
+		g_autofree gchar *recorded = NULL;
+		g_autofree gchar *current = NULL;
+
+		recorded = g_key_file_get_string (kf, group, key, NULL);
+		if (recorded == NULL)
+			return NULL;
+		current = as_cache_generation_stat_location (locations[i]);
+		if (g_strcmp0 (recorded, current) != 0)
+			return NULL;
+	}
+
+	return g_key_file_get_string (kf, group, "fingerprint", NULL);
+}
+
+/**
+ * as_cache_generation_update_sources:
+ * @cache: an #AsCache instance.
+ * @scope: Component scope of the cache section.
+ * @cache_key: Cache key of the section the sources belong to.
+ * @locations: (array zero-terminated=1): The current metadata source locations.
+ * @fingerprint: The source fingerprint computed for the current data.
+ *
+ * Record the current state of the given source locations and their computed
+ * fingerprint in the cache generation manifest, so subsequent cache validity
+ * checks can take the fast path via %as_cache_generation_check_sources.
+ */
+void
+as_cache_generation_update_sources (AsCache *cache,
+				    AsComponentScope scope,
+				    const gchar *cache_key,
+				    const gchar *const *locations,
+				    const gchar *fingerprint)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->generation_mutex);
+	GKeyFile *kf = as_cache_generation_get_keyfile (cache);
+	g_autofree gchar *group = NULL;
+	g_autofree gchar *fname = NULL;
+	guint n_locations;
+
+	group = g_strconcat (as_component_scope_to_string (scope), ":", cache_key, NULL);
+	g_key_file_remove_group (kf, group, NULL);
+
+	g_key_file_set_string (kf, group, "fingerprint", fingerprint);
+	n_locations = g_strv_length ((gchar **) locations);
+	g_key_file_set_integer (kf, group, "n_sources", (gint) n_locations);
+	for (guint i = 0; i < n_locations; i++) {
+		g_autofree gchar *key = g_strdup_printf ("source_%u", i);
+		g_autofree gchar *entry = as_cache_generation_stat_location (locations[i]);
+		g_key_file_set_string (kf, group, key, entry);
+	}
+
+	g_mkdir_with_parents (priv->cache_root_dir, 0755);
+	fname = g_build_filename (priv->cache_root_dir,
+				  AS_CACHE_GENERATION_MANIFEST_FNAME,
+				  NULL);
+	if (!g_key_file_save_to_file (kf, fname, NULL))
+		g_debug ("Unable to save cache generation manifest: %s", fname);
+}
+
+/* manifest group memoizing checksums of metadata files, keyed by filename */
+#define AS_CACHE_GENERATION_GROUP_FILE_CHECKSUMS "file_checksums"
+
+/**
+ * as_cache_generation_get_file_checksum:
+ * @cache: an #AsCache instance.
+ * @fname: Path of the metadata file.
+ *
+ * Look up a previously recorded checksum of @fname in the cache generation
+ * manifest. The checksum is only returned if the file's current mtime,
+ * ctime and size still match the recorded state, so a file that changed in
+ * any way is always re-hashed by the caller.
+ *
+ * Returns: (transfer full) (nullable): The recorded checksum, or %NULL if
+ * the file changed or no checksum was recorded for it.
+ */
+gchar *
+as_cache_generation_get_file_checksum (AsCache *cache, const gchar *fname)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->generation_mutex);
+	GKeyFile *kf = as_cache_generation_get_keyfile (cache);
+	g_autofree gchar *recorded = NULL;
+	g_autofree gchar *current = NULL;
+	gchar *sep;
+
+	recorded = g_key_file_get_string (kf,
+					  AS_CACHE_GENERATION_GROUP_FILE_CHECKSUMS,
+					  fname,
+					  NULL);
+	if (recorded == NULL)
+		return NULL;
+
+	/* entries have the form "<checksum> <mtime:ctime:size:path>" */
+	sep = strchr (recorded, ' ');
+	if (sep == NULL)
+		return NULL;
+	*sep = '\0';
+
+	current = as_cache_generation_stat_location (fname);
+	if (g_strcmp0 (sep + 1, current) != 0)
+		return NULL;
+	return g_steal_pointer (&recorded);
+}
+
+/**
+ * as_cache_generation_update_file_checksum:
+ * @cache: an #AsCache instance.
+ * @fname: Path of the metadata file.
+ * @checksum: The checksum computed for the file's current contents.
+ *
+ * Record the checksum of @fname together with the file's current state in
+ * the cache generation manifest, so subsequent loads of the unchanged file
+ * can skip hashing it again via %as_cache_generation_get_file_checksum.
+ */
+void
+as_cache_generation_update_file_checksum (AsCache *cache,
+					  const gchar *fname,
+					  const gchar *checksum)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->generation_mutex);
+	GKeyFile *kf = as_cache_generation_get_keyfile (cache);
+	g_autofree gchar *state = NULL;
+	g_autofree gchar *entry = NULL;
+	g_autofree gchar *manifest_fname = NULL;
+
+	state = as_cache_generation_stat_location (fname);
+	entry = g_strconcat (checksum, " ", state, NULL);
+	g_key_file_set_string (kf, AS_CACHE_GENERATION_GROUP_FILE_CHECKSUMS, fname, entry);
+
+	g_mkdir_with_parents (priv->cache_root_dir, 0755);
+	manifest_fname = g_build_filename (priv->cache_root_dir,
+					   AS_CACHE_GENERATION_MANIFEST_FNAME,
+					   NULL);
+	if (!g_key_file_save_to_file (kf, manifest_fname, NULL))
+		g_debug ("Unable to save cache generation manifest: %s", manifest_fname);
 }
 
 /**
@@ -335,32 +1045,109 @@ as_cache_set_resolve_addons (AsCache *cache, gboolean resolve_addons)
 }
 
 /**
- * as_cache_delete_file_if_old:
+ * as_cache_set_throttled:
+ * @cache: an #AsCache instance.
+ * @throttled: Whether cache (re)builds should be throttled.
+ *
+ * Set whether expensive cache rebuild work should run at reduced scheduling
+ * priority and yield the CPU regularly, trading refresh latency for
+ * foreground responsiveness on weak hardware.
  */
-static void
-as_delete_cache_file_if_old (AsCache *cache, const gchar *fname, time_t min_atime)
+void
+as_cache_set_throttled (AsCache *cache, gboolean throttled)
 {
-	struct stat sbuf;
-
-	/* safeguard so we will only delete cache files */
-	if (!g_str_has_suffix (fname, ".xb") && !g_str_has_suffix (fname, ".cache"))
-		return;
-
-	if (stat (fname, &sbuf) < 0)
-		return;
-
-	if (sbuf.st_atime < min_atime) {
-		g_autofree gchar *basename = g_path_get_basename (fname);
-		g_debug ("Deleting old cache file: %s", basename);
-		g_unlink (fname);
-	}
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	priv->throttled = throttled;
 }
 
 /**
- * as_cache_remove_old_data_from_dir:
+ * as_cache_set_cluster_hot_fields:
+ * @cache: an #AsCache instance.
+ * @cluster: Whether hot component fields should be clustered.
+ *
+ * If enabled, newly compiled cache sections store the payload that listing
+ * views never read (long descriptions, releases, screenshots) in a separate
+ * region at the tail of the silo, keeping the component nodes themselves
+ * compact and contiguous. Browse-style queries then touch far fewer pages
+ * of the memory-mapped cache; the cold payload is fetched transparently on
+ * first access through the component's lazy-loading machinery.
+ * Only affects sections compiled after the flag was set.
  */
-static void
-as_cache_remove_old_data_from_dir (AsCache *cache, const gchar *cache_dir)
+void
+as_cache_set_cluster_hot_fields (AsCache *cache, gboolean cluster)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	priv->cluster_hot_fields = cluster;
+}
+
+/**
+ * as_cache_throttle_thread_begin:
+ *
+ * Lower the scheduling priority of the calling thread for a throttled
+ * cache rebuild. Returns the previous nice value, to be passed to
+ * as_cache_throttle_thread_end() once the expensive work is done.
+ */
+static int
+as_cache_throttle_thread_begin (void)
+{
+#ifdef __linux__
+	/* on Linux, setpriority() acts on a single thread when given a TID */
+	int prev_nice;
+
+	errno = 0;
+	prev_nice = getpriority (PRIO_PROCESS, (id_t) syscall (SYS_gettid));
+	if (prev_nice == -1 && errno != 0)
+		return 0;
+	if (setpriority (PRIO_PROCESS, (id_t) syscall (SYS_gettid), 10) != 0)
+		g_debug ("Unable to lower cache compile thread priority: %s",
+			 g_strerror (errno));
+	return prev_nice;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * as_cache_throttle_thread_end:
+ */
+static void
+as_cache_throttle_thread_end (int prev_nice)
+{
+#ifdef __linux__
+	if (setpriority (PRIO_PROCESS, (id_t) syscall (SYS_gettid), prev_nice) != 0)
+		g_debug ("Unable to restore cache compile thread priority: %s",
+			 g_strerror (errno));
+#endif
+}
+
+/**
+ * as_cache_delete_file_if_old:
+ */
+static void
+as_delete_cache_file_if_old (AsCache *cache, const gchar *fname, time_t min_atime)
+{
+	struct stat sbuf;
+
+	/* safeguard so we will only delete cache files */
+	if (!g_str_has_suffix (fname, ".xb") && !g_str_has_suffix (fname, ".cache") &&
+	    !g_str_has_suffix (fname, AS_CACHE_RAH_SUFFIX))
+		return;
+
+	if (stat (fname, &sbuf) < 0)
+		return;
+
+	if (sbuf.st_atime < min_atime) {
+		g_autofree gchar *basename = g_path_get_basename (fname);
+		g_debug ("Deleting old cache file: %s", basename);
+		g_unlink (fname);
+	}
+}
+
+/**
+ * as_cache_remove_old_data_from_dir:
+ */
+static void
+as_cache_remove_old_data_from_dir (AsCache *cache, const gchar *cache_dir)
 {
 	g_autoptr(GFileEnumerator) direnum = NULL;
 	g_autoptr(GFile) cdir = NULL;
@@ -459,6 +1246,190 @@ as_cache_prune_data (AsCache *cache)
 		as_cache_remove_old_data_from_dir (cache, priv->system_cache_dir);
 }
 
+/* default size budget for the per-user cache directory, in bytes */
+#define AS_CACHE_DEFAULT_SIZE_BUDGET (256L * 1024L * 1024L)
+
+typedef struct {
+	gchar *fname;
+	gint64 mtime;
+	guint64 size;
+} AsCacheVacuumEntry;
+
+static void
+as_cache_vacuum_entry_free (AsCacheVacuumEntry *entry)
+{
+	g_free (entry->fname);
+	g_free (entry);
+}
+
+static gint
+as_cache_vacuum_entry_mtime_cmp (gconstpointer a, gconstpointer b)
+{
+	const AsCacheVacuumEntry *e1 = *((AsCacheVacuumEntry *const *) a);
+	const AsCacheVacuumEntry *e2 = *((AsCacheVacuumEntry *const *) b);
+
+	if (e1->mtime < e2->mtime)
+		return -1;
+	if (e1->mtime > e2->mtime)
+		return 1;
+	return 0;
+}
+
+/**
+ * as_cache_silo_read_fingerprint:
+ *
+ * Read the source-data fingerprint embedded in a section silo,
+ * or %NULL if the silo can not be loaded or has no fingerprint.
+ */
+static gchar *
+as_cache_silo_read_fingerprint (const gchar *fname)
+{
+	g_autoptr(XbSilo) silo = xb_silo_new ();
+	g_autoptr(XbNode) root_node = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path (fname);
+
+	if (!xb_silo_load_from_file (silo, file, XB_SILO_LOAD_FLAG_NONE, NULL, NULL))
+		return NULL;
+	root_node = xb_silo_get_root (silo);
+	if (root_node == NULL)
+		return NULL;
+	return g_strdup (xb_node_get_attr (root_node, "fingerprint"));
+}
+
+/**
+ * as_cache_fname_is_loaded_section:
+ *
+ * Check whether a cache file backs a section that is currently loaded.
+ */
+static gboolean
+as_cache_fname_is_loaded_section (AsCache *cache, const gchar *fname)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+
+	for (guint i = 0; i < priv->sections->len; i++) {
+		AsCacheSection *csec = g_ptr_array_index (priv->sections, i);
+		if (g_strcmp0 (csec->fname, fname) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/**
+ * as_cache_vacuum:
+ * @cache: an #AsCache instance.
+ * @size_budget: Maximum size of the user cache directory in bytes, or 0 for the default budget.
+ * @bytes_freed: (out) (optional): Amount of disk space that was reclaimed, in bytes.
+ * @error: a #GError or %NULL.
+ *
+ * Clean up the per-user cache directory. Section silos belonging to a
+ * superseded cache generation (their embedded source fingerprint no longer
+ * matches any fingerprint recorded in the generation manifest) are always
+ * removed, and if the remaining cache data still exceeds @size_budget,
+ * the least-recently modified cache files are evicted until it fits.
+ *
+ * Files backing currently loaded cache sections are never removed.
+ * This function only ever touches known cache data in the user cache
+ * directory, the shared system cache is not modified.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+as_cache_vacuum (AsCache *cache, guint64 size_budget, guint64 *bytes_freed, GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(GPtrArray) files = NULL;
+	g_autoptr(GPtrArray) entries = NULL;
+	g_autoptr(GHashTable) current_fps = NULL;
+	guint64 total_size = 0;
+	guint64 freed = 0;
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+
+	if (bytes_freed != NULL)
+		*bytes_freed = 0;
+	if (size_budget == 0)
+		size_budget = AS_CACHE_DEFAULT_SIZE_BUDGET;
+
+	/* nothing to do if no user cache exists yet */
+	if (!g_file_test (priv->cache_root_dir, G_FILE_TEST_IS_DIR))
+		return TRUE;
+
+	files = as_utils_find_files_matching (priv->cache_root_dir, "*", TRUE, error);
+	if (files == NULL)
+		return FALSE;
+
+	/* collect the fingerprints of all cache generations that are still current */
+	current_fps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	{
+		g_autoptr(GMutexLocker) gen_locker = g_mutex_locker_new (
+		    &priv->generation_mutex);
+		GKeyFile *kf = as_cache_generation_get_keyfile (cache);
+		g_auto(GStrv) groups = g_key_file_get_groups (kf, NULL);
+
+		for (guint i = 0; groups[i] != NULL; i++) {
+			gchar *fp = g_key_file_get_string (kf, groups[i], "fingerprint", NULL);
+			if (fp != NULL)
+				g_hash_table_add (current_fps, fp);
+		}
+	}
+
+	entries = g_ptr_array_new_with_free_func ((GDestroyNotify) as_cache_vacuum_entry_free);
+	for (guint i = 0; i < files->len; i++) {
+		const gchar *fname = g_ptr_array_index (files, i);
+		AsCacheVacuumEntry *entry;
+		GStatBuf sbuf;
+
+		/* safeguard so we will only ever delete cache files */
+		if (!g_str_has_suffix (fname, ".xb") && !g_str_has_suffix (fname, ".cache") &&
+		    !g_str_has_suffix (fname, AS_CACHE_RAH_SUFFIX))
+			continue;
+		if (g_stat (fname, &sbuf) != 0)
+			continue;
+		if (as_cache_fname_is_loaded_section (cache, fname))
+			continue;
+
+		/* evict section silos of superseded generations right away - a newer
+		 * silo for their data exists, so they will never be read again */
+		if (g_str_has_suffix (fname, ".xb") && g_hash_table_size (current_fps) > 0) {
+			g_autofree gchar *silo_fp = as_cache_silo_read_fingerprint (fname);
+			if (silo_fp != NULL && !g_hash_table_contains (current_fps, silo_fp)) {
+				g_autofree gchar *fname_rah = g_strconcat (fname,
+									   AS_CACHE_RAH_SUFFIX,
+									   NULL);
+				g_debug ("Evicting stale cache generation: %s", fname);
+				if (g_unlink (fname) == 0)
+					freed += (guint64) sbuf.st_size;
+				g_unlink (fname_rah);
+				continue;
+			}
+		}
+
+		entry = g_new0 (AsCacheVacuumEntry, 1);
+		entry->fname = g_strdup (fname);
+		entry->mtime = (gint64) sbuf.st_mtime;
+		entry->size = (guint64) sbuf.st_size;
+		total_size += entry->size;
+		g_ptr_array_add (entries, entry);
+	}
+
+	/* delete the least-recently modified files first, until we fit the budget */
+	g_ptr_array_sort (entries, as_cache_vacuum_entry_mtime_cmp);
+	for (guint i = 0; i < entries->len; i++) {
+		AsCacheVacuumEntry *entry = g_ptr_array_index (entries, i);
+
+		if (total_size <= size_budget)
+			break;
+		g_debug ("Evicting cache file to meet size budget: %s", entry->fname);
+		if (g_unlink (entry->fname) != 0)
+			continue;
+		total_size -= entry->size;
+		freed += entry->size;
+	}
+
+	if (bytes_freed != NULL)
+		*bytes_freed = freed;
+	return TRUE;
+}
+
 /**
  * as_cache_clear:
  * @cache: an #AsCache instance.
@@ -476,6 +1447,8 @@ as_cache_clear (AsCache *cache)
 
 	g_hash_table_unref (priv->masked);
 	priv->masked = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	as_cache_hot_cpts_invalidate (cache);
 }
 
 /**
@@ -607,901 +1580,2977 @@ as_cache_builder_add_manifold_tokens (XbBuilderNode *root, AsComponent *cpt)
 }
 
 /**
- * as_cache_components_to_internal_xml:
- *
- * Convert a list of components into internal binary XML that we will store
- * on disk for fast querying.
+ * as_cache_builder_add_token_index:
  *
- * Returns: Valid catalog XML metadata for internal cache use.
+ * Serialize the complete stemmed token cache of the component, including the
+ * match values, so search can run on the prebuilt index after a cache load
+ * instead of re-tokenizing every component.
  */
-static XbSilo *
-as_cache_components_to_internal_xb (AsCache *cache,
-				    GPtrArray *cpts,
-				    gboolean refine,
-				    gpointer refine_func_udata,
-				    GError **error)
+static void
+as_cache_builder_add_token_index (XbBuilderNode *root, AsComponent *cpt)
 {
-	AsCachePrivate *priv = GET_PRIVATE (cache);
-	g_autoptr(XbBuilder) builder = NULL;
-	g_autoptr(XbBuilderNode) bnode_root = NULL;
-	g_autoptr(GError) tmp_error = NULL;
-	g_autoptr(XbSilo) silo = NULL;
+	g_autoptr(XbBuilderNode) tindex_node = NULL;
+	GHashTableIter iter;
+	gpointer key, value;
 
-	/* NOTE: This function is already write-lock protected by its callers */
+	tindex_node = xb_builder_node_new ("_asi_tindex");
+	g_hash_table_iter_init (&iter, as_component_get_token_cache_table (cpt));
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		g_autoptr(XbBuilderNode) child = xb_builder_node_new ("t");
+		g_autofree gchar *match_str = NULL;
+		AsTokenType *match_pval = value;
 
-	bnode_root = xb_builder_node_new ("components");
-	for (guint i = 0; i < cpts->len; i++) {
-		xmlNode *cnode;
-		g_autoptr(XbBuilderNode) xbnode = NULL;
-		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (cpts, i));
+		match_str = g_strdup_printf ("%u", (guint) *match_pval);
+		xb_builder_node_set_text (child, (const gchar *) key, -1);
+		xb_builder_node_set_attr (child, "m", match_str);
+		xb_builder_node_add_child (tindex_node, child);
+	}
 
-		/* refine component data */
-		if (refine && priv->cpt_refine_func != NULL)
-			(*priv->cpt_refine_func) (cpt, TRUE, refine_func_udata);
+	xb_builder_node_add_child (root, tindex_node);
+}
 
-		/* serialize to node */
-		cnode = as_component_to_xml_node (cpt, priv->context, NULL);
-		if (cnode == NULL)
-			continue;
+/**
+ * as_cache_load_token_index_for_component:
+ *
+ * Restore the token cache of a component from the serialized token index
+ * in its cache silo node, if one is present.
+ */
+static void
+as_cache_load_token_index_for_component (XbNode *node, AsComponent *cpt)
+{
+	g_autoptr(GPtrArray) token_nodes = NULL;
 
-		/* convert component node to builder node */
-		xbnode = xb_builder_node_new ("component");
-		as_transmogrify_xmlnode_to_xbuildernode (cnode, xbnode);
-		xmlFreeNode (cnode);
+	token_nodes = xb_node_query (node, "_asi_tindex/t", 0, NULL);
+	if (token_nodes == NULL)
+		return;
 
-		/* add tokens */
-		as_cache_builder_add_simple_tokens (xbnode,
-						    cpt,
-						    "summary",
-						    AS_SEARCH_TOKEN_MATCH_SUMMARY);
-		as_cache_builder_add_simple_tokens (xbnode,
-						    cpt,
-						    "_asi_origin",
-						    AS_SEARCH_TOKEN_MATCH_ORIGIN);
-		as_cache_builder_add_simple_tokens (xbnode,
-						    cpt,
-						    "pkgname",
-						    AS_SEARCH_TOKEN_MATCH_PKGNAME);
-		as_cache_builder_add_manifold_tokens (xbnode, cpt);
+	for (guint i = 0; i < token_nodes->len; i++) {
+		XbNode *tn = XB_NODE (g_ptr_array_index (token_nodes, i));
+		const gchar *token = xb_node_get_text (tn);
+		guint64 match_val = xb_node_get_attr_as_uint (tn, "m");
 
-		/* add component to tree */
-		xb_builder_node_add_child (bnode_root, xbnode);
+		if (token == NULL || match_val == G_MAXUINT64)
+			continue;
+		as_component_insert_token_cache_entry (cpt, token, (AsTokenType) match_val);
 	}
 
-	builder = xb_builder_new ();
-	/* add our version to the correctness hash */
-	xb_builder_append_guid (builder, PACKAGE_VERSION);
-	xb_builder_import_node (builder, bnode_root);
-
-	silo = xb_builder_compile (builder, XB_BUILDER_COMPILE_FLAG_NONE, NULL, &tmp_error);
-	if (silo == NULL) {
-		g_propagate_prefixed_error (error,
-					    tmp_error,
-					    "Unable to compile binary XML for caching:");
-		return NULL;
-	} else {
-		return g_steal_pointer (&silo);
-	}
+	/* mark the restored index as complete, so search will not tokenize again */
+	as_component_set_token_cache_valid (cpt);
 }
 
+/* number of hash probes used for the per-section search bloom filter */
+#define AS_CACHE_BLOOM_HASH_N 4
+
 /**
- * as_cache_register_addons_for_component:
+ * as_cache_bloom_hash:
  *
- * Associate available addons with this component.
+ * Compute two independent string hashes (djb2 and sdbm) over @data, from
+ * which all bloom filter probes are derived (Kirsch-Mitzenmacher scheme).
  */
-static gboolean
-as_cache_register_addons_for_component (AsCache *cache, AsComponent *cpt, GError **error)
+static void
+as_cache_bloom_hash (const gchar *data, gssize len, gsize *h1, gsize *h2)
 {
-	g_autoptr(AsComponentBox) addons = NULL;
-
-	addons = as_cache_get_components_by_extends (cache, as_component_get_id (cpt), error);
-	if (addons == NULL)
-		return FALSE;
-
-	for (guint i = 0; i < as_component_box_len (addons); i++)
-		as_component_add_addon (cpt, as_component_box_index (addons, i));
+	gsize hash1 = 5381;
+	gsize hash2 = 0;
+
+	if (len < 0)
+		len = strlen (data);
+	for (gssize i = 0; i < len; i++) {
+		hash1 = hash1 * 33 + (guchar) data[i];
+		hash2 = (guchar) data[i] + (hash2 << 6) + (hash2 << 16) - hash2;
+	}
 
-	return TRUE;
+	*h1 = hash1;
+	*h2 = hash2;
 }
 
 /**
- * as_transmogrify_xbnode_to_xmlnode:
+ * as_cache_bloom_set:
  */
-static gboolean
-as_transmogrify_xbnode_to_xmlnode (XbNode *xbn, xmlNode *lxn)
+static void
+as_cache_bloom_set (guint8 *bloom, gsize nbits, const gchar *data, gssize len)
 {
-	XbNodeAttrIter attr_iter;
-	const gchar *attr_name;
-	const gchar *attr_value;
-	const gchar *tail;
-	XbNodeChildIter child_iter;
-	XbNode *child = NULL;
-	g_return_val_if_fail (XB_IS_NODE (xbn), FALSE);
-
-	xmlNodeSetName (lxn, (xmlChar *) xb_node_get_element (xbn));
-	xmlNodeAddContent (lxn, (xmlChar *) xb_node_get_text (xbn));
+	gsize h1, h2;
 
-	tail = xb_node_get_tail (xbn);
-	if (tail != NULL) {
-		xmlNode *tn = xmlNewText ((xmlChar *) tail);
-		xmlAddNextSibling (lxn, tn);
+	as_cache_bloom_hash (data, len, &h1, &h2);
+	for (guint i = 0; i < AS_CACHE_BLOOM_HASH_N; i++) {
+		gsize bit = (h1 + i * h2) % nbits;
+		bloom[bit / 8] |= 1 << (bit % 8);
 	}
+}
 
-	/* attributes */
-	xb_node_attr_iter_init (&attr_iter, xbn);
-	while (xb_node_attr_iter_next (&attr_iter, &attr_name, &attr_value))
-		as_xml_add_text_prop (lxn, attr_name, attr_value);
+/**
+ * as_cache_bloom_test:
+ */
+static gboolean
+as_cache_bloom_test (const guint8 *bloom, gsize nbits, const gchar *data, gssize len)
+{
+	gsize h1, h2;
 
-	/* children */
-	xb_node_child_iter_init (&child_iter, xbn);
-	while (xb_node_child_iter_loop (&child_iter, &child)) {
-		xmlNode *lc = xmlNewChild (lxn, NULL, (xmlChar *) "", NULL);
-		if (!as_transmogrify_xbnode_to_xmlnode (child, lc)) {
-			g_clear_pointer (&child, g_object_unref);
+	as_cache_bloom_hash (data, len, &h1, &h2);
+	for (guint i = 0; i < AS_CACHE_BLOOM_HASH_N; i++) {
+		gsize bit = (h1 + i * h2) % nbits;
+		if ((bloom[bit / 8] & (1 << (bit % 8))) == 0)
 			return FALSE;
-		}
 	}
 
 	return TRUE;
 }
 
 /**
- * as_cache_component_from_node:
+ * as_cache_bloom_collect_trigrams:
  *
- * Get component from an xmlb node.
+ * Add all case-folded byte trigrams of @value to the bloom entry set, so
+ * substring and word-prefix queries on the raw text can be pre-filtered
+ * as well: if a term is contained in @value, all of its trigrams are too.
  */
-static AsComponent *
-as_cache_component_from_node (AsCache *cache, AsCacheSection *csec, XbNode *node, GError **error)
+static void
+as_cache_bloom_collect_trigrams (GHashTable *entries, const gchar *value)
 {
-	AsCachePrivate *priv = GET_PRIVATE (cache);
-	g_autoptr(AsComponent) cpt = NULL;
-	xmlNode *root;
-
-	root = xmlNewNode (NULL, (xmlChar *) "");
-	as_transmogrify_xbnode_to_xmlnode (node, root);
+	g_autofree gchar *folded = NULL;
+	gsize len;
 
-	cpt = as_component_new ();
-	if (!as_component_load_from_xml (cpt, priv->context, root, error)) {
-		xmlFreeNode (root);
-		return NULL;
+	if (value == NULL)
+		return;
+	folded = g_utf8_strdown (value, -1);
+	len = strlen (folded);
+	for (gsize i = 0; i + 3 <= len; i++)
+		g_hash_table_add (entries, g_strndup (folded + i, 3));
+}
+
+/**
+ * as_cache_bloom_collect_component:
+ *
+ * Collect all strings of @cpt that need to be represented in the section
+ * bloom filter for search pre-filtering to stay lossless.
+ */
+static void
+as_cache_bloom_collect_component (GHashTable *entries, AsComponent *cpt)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+	AsProvided *prov;
+	gchar **pkgnames;
+
+	/* the stemmed tokens, which the token queries match exactly */
+	g_hash_table_iter_init (&iter, as_component_get_token_cache_table (cpt));
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		g_hash_table_add (entries, g_strdup ((const gchar *) key));
+		/* terms may also match as word-prefix of an individual token */
+		as_cache_bloom_collect_trigrams (entries, (const gchar *) key);
 	}
-	xmlFreeNode (root);
 
-	/* find addons (if there are any) - ensure addons don't have addons themselves */
-	if (priv->auto_resolve_addons && (as_component_get_kind (cpt) != AS_COMPONENT_KIND_ADDON) &&
-	    !as_cache_register_addons_for_component (cache, cpt, error)) {
-		return NULL;
+	/* raw values that the substring and word-prefix queries run on */
+	as_cache_bloom_collect_trigrams (entries, as_component_get_id (cpt));
+	g_hash_table_iter_init (&iter, as_component_get_name_table (cpt));
+	while (g_hash_table_iter_next (&iter, NULL, &value))
+		as_cache_bloom_collect_trigrams (entries, (const gchar *) value);
+
+	pkgnames = as_component_get_pkgnames (cpt);
+	for (guint i = 0; pkgnames != NULL && pkgnames[i] != NULL; i++)
+		as_cache_bloom_collect_trigrams (entries, pkgnames[i]);
+
+	prov = as_component_get_provided_for_kind (cpt, AS_PROVIDED_KIND_MEDIATYPE);
+	if (prov != NULL) {
+		GPtrArray *items = as_provided_get_items (prov);
+		for (guint i = 0; i < items->len; i++)
+			as_cache_bloom_collect_trigrams (entries,
+							 g_ptr_array_index (items, i));
 	}
+}
 
-	/* refine for deserialization */
-	if (priv->cpt_refine_func != NULL && !csec->is_mask)
-		(*priv->cpt_refine_func) (cpt, FALSE, csec->refine_func_udata);
+/**
+ * as_cache_bloom_collect_component_ids:
+ *
+ * Collect the lowercased identifiers that an ID lookup on @cpt could match,
+ * which are its component ID as well as any IDs it provides.
+ */
+static void
+as_cache_bloom_collect_component_ids (GHashTable *entries, AsComponent *cpt)
+{
+	AsProvided *prov;
 
-	return g_steal_pointer (&cpt);
+	g_hash_table_add (entries, g_utf8_strdown (as_component_get_id (cpt), -1));
+
+	prov = as_component_get_provided_for_kind (cpt, AS_PROVIDED_KIND_ID);
+	if (prov != NULL) {
+		GPtrArray *items = as_provided_get_items (prov);
+		for (guint i = 0; i < items->len; i++)
+			g_hash_table_add (
+			    entries,
+			    g_utf8_strdown (g_ptr_array_index (items, i), -1));
+	}
 }
 
 /**
- * as_cache_remove_section_file:
+ * as_cache_builder_add_bloom_filter:
  *
- * Safely remove a cache section file from disk.
+ * Build a bloom filter over the given strings and embed it into the silo
+ * as element @name, so queries can reject whole sections with a few hash
+ * probes before running any per-component queries.
+ * Embedding the filter in the silo (instead of a sibling file) keeps it
+ * atomically consistent with the data it describes.
  */
 static void
-as_cache_remove_section_file (AsCache *cache, AsCacheSection *csec)
+as_cache_builder_add_bloom_filter (XbBuilderNode *root, const gchar *name, GHashTable *entries)
 {
-	g_autofree gchar *rnd_suffix = NULL;
-	g_autofree gchar *fname_old = NULL;
-
-	/* do nothing if file is already gone */
-	if (!g_file_test (csec->fname, G_FILE_TEST_EXISTS))
+	g_autoptr(XbBuilderNode) bloom_node = NULL;
+	g_autofree guint8 *bloom = NULL;
+	g_autofree gchar *b64 = NULL;
+	g_autofree gchar *probes_str = NULL;
+	GHashTableIter iter;
+	gpointer key;
+	gsize nbits;
+
+	if (g_hash_table_size (entries) == 0)
 		return;
 
-	/* random temporary name, in case multiple processes try to delete this at the same time */
-	rnd_suffix = as_random_alnum_string (6);
-	fname_old = g_strconcat (csec->fname, rnd_suffix, ".old", NULL);
+	/* aim for ~10 bit per entry, which keeps the false-positive rate low */
+	nbits = 1024;
+	while (nbits < (gsize) g_hash_table_size (entries) * 10)
+		nbits <<= 1;
+
+	bloom = g_malloc0 (nbits / 8);
+	g_hash_table_iter_init (&iter, entries);
+	while (g_hash_table_iter_next (&iter, &key, NULL))
+		as_cache_bloom_set (bloom, nbits, (const gchar *) key, -1);
+
+	b64 = g_base64_encode (bloom, nbits / 8);
+	probes_str = g_strdup_printf ("%u", (guint) AS_CACHE_BLOOM_HASH_N);
+	bloom_node = xb_builder_node_new (name);
+	xb_builder_node_set_attr (bloom_node, "k", probes_str);
+	xb_builder_node_set_text (bloom_node, b64, -1);
+	xb_builder_node_add_child (root, bloom_node);
+}
 
-	/* just in case the file exists by any chance, we drop it */
-	g_unlink (fname_old);
+/**
+ * as_cache_builder_collect_categories:
+ *
+ * Record the categories of @cpt as a list of bit indices, assigning a new
+ * bit to every category name the section has not seen before.
+ */
+static void
+as_cache_builder_collect_categories (GHashTable *cat_index, GPtrArray *cat_rows, AsComponent *cpt)
+{
+	GPtrArray *categories = as_component_get_categories (cpt);
+	g_autoptr(GArray) row = g_array_new (FALSE, FALSE, sizeof (guint));
+
+	for (guint i = 0; i < categories->len; i++) {
+		const gchar *category = (const gchar *) g_ptr_array_index (categories, i);
+		guint bit = GPOINTER_TO_UINT (g_hash_table_lookup (cat_index, category));
+
+		if (bit == 0) {
+			bit = g_hash_table_size (cat_index) + 1;
+			g_hash_table_insert (cat_index,
+					     g_strdup (category),
+					     GUINT_TO_POINTER (bit));
+		}
+		bit -= 1;
+		g_array_append_val (row, bit);
+	}
 
-	if (g_rename (csec->fname, fname_old) == -1) {
-		/* some other process may have done this already */
-		g_debug ("Unable to rename stale cache file '%s': %s",
-			 csec->fname,
-			 g_strerror (errno));
-		g_unlink (csec->fname);
+	g_ptr_array_add (cat_rows, g_steal_pointer (&row));
+}
+
+/**
+ * as_cache_builder_add_category_map:
+ *
+ * Build a packed per-component category bitmap and embed it into the silo,
+ * so category queries can be answered with a bitwise AND over all components
+ * instead of nested per-category string comparisons.
+ * The bit assignment is recorded in the node as well, making the map
+ * self-describing and independent of the category registry version.
+ */
+static void
+as_cache_builder_add_category_map (XbBuilderNode *root, GHashTable *cat_index, GPtrArray *cat_rows)
+{
+	g_autoptr(XbBuilderNode) catmap_node = NULL;
+	g_autofree gchar **names = NULL;
+	g_autofree guint8 *data = NULL;
+	g_autofree gchar *names_str = NULL;
+	g_autofree gchar *b64 = NULL;
+	GHashTableIter iter;
+	gpointer key, value;
+	guint n_cats;
+	guint row_len;
+
+	n_cats = g_hash_table_size (cat_index);
+	if (n_cats == 0)
 		return;
+
+	/* list the category names in bit order */
+	names = g_new0 (gchar *, n_cats + 1);
+	g_hash_table_iter_init (&iter, cat_index);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+		names[GPOINTER_TO_UINT (value) - 1] = (gchar *) key;
+	names_str = g_strjoinv (";", (gchar **) names);
+
+	/* pack one fixed-width bitmap row per component */
+	row_len = (n_cats + 7) / 8;
+	data = g_malloc0 ((gsize) row_len * cat_rows->len);
+	for (guint i = 0; i < cat_rows->len; i++) {
+		GArray *row = (GArray *) g_ptr_array_index (cat_rows, i);
+		guint8 *row_data = data + (gsize) i * row_len;
+
+		for (guint j = 0; j < row->len; j++) {
+			guint bit = g_array_index (row, guint, j);
+			row_data[bit / 8] |= 1 << (bit % 8);
+		}
 	}
 
-	/* we should be able to remove the file at this point */
-	if (g_unlink (fname_old) == -1)
-		g_warning ("Unable to unlink old cache file '%s': %s",
-			   fname_old,
-			   g_strerror (errno));
+	b64 = g_base64_encode (data, (gsize) row_len * cat_rows->len);
+	catmap_node = xb_builder_node_new ("_asi_catmap");
+	xb_builder_node_set_attr (catmap_node, "cats", names_str);
+	xb_builder_node_set_text (catmap_node, b64, -1);
+	xb_builder_node_add_child (root, catmap_node);
 }
 
 /**
- * as_cache_build_section_key:
+ * as_cache_section_load_catmap:
  *
- * Generate a cache key that we can use in filenames from an
- * arbitrary string that the user may have control over.
- * This will also prepend any locale information.
+ * Restore the section's category bitmap from its silo, if one was embedded
+ * at build time. Sections without bitmap data (e.g. caches written by older
+ * versions) fall back to plain XPath category queries.
  */
-static gchar *
-as_cache_build_section_key (AsCache *cache, const gchar *str)
+static void
+as_cache_section_load_catmap (AsCacheSection *csec)
 {
-	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(XbNode) catmap_node = NULL;
+	g_auto(GStrv) names = NULL;
+	const gchar *b64;
+	const gchar *names_str;
+	gsize data_size;
+	guint n_cats;
+
+	g_clear_pointer (&csec->catmap, g_free);
+	g_clear_pointer (&csec->catmap_index, g_hash_table_unref);
+	csec->catmap_row_len = 0;
+	csec->catmap_n_rows = 0;
+
+	catmap_node = xb_silo_query_first (csec->silo, "components/_asi_catmap", NULL);
+	if (catmap_node == NULL)
+		return;
+	b64 = xb_node_get_text (catmap_node);
+	names_str = xb_node_get_attr (catmap_node, "cats");
+	if (b64 == NULL || names_str == NULL)
+		return;
 
-	if (g_strstr_len (str, -1, "/") == NULL) {
-		/* the string is fine as-is, we just need to add the locale prefix to it */
-		return g_strconcat (priv->locale, "-", str, NULL);
-	} else {
-		/* we need to create a unique key from the filename-ish string */
-		g_autoptr(GChecksum) cs = g_checksum_new (G_CHECKSUM_MD5);
-		g_checksum_update (cs, (const guchar *) str, -1);
+	names = g_strsplit (names_str, ";", -1);
+	n_cats = g_strv_length (names);
+	if (n_cats == 0)
+		return;
 
-		return g_strconcat (priv->locale, "-", g_checksum_get_string (cs), NULL);
+	csec->catmap = g_base64_decode (b64, &data_size);
+	csec->catmap_row_len = (n_cats + 7) / 8;
+	if (data_size == 0 || data_size % csec->catmap_row_len != 0) {
+		g_clear_pointer (&csec->catmap, g_free);
+		csec->catmap_row_len = 0;
+		return;
 	}
+	csec->catmap_n_rows = data_size / csec->catmap_row_len;
+
+	csec->catmap_index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	for (guint i = 0; names[i] != NULL; i++)
+		g_hash_table_insert (csec->catmap_index,
+				     g_strdup (names[i]),
+				     GUINT_TO_POINTER (i + 1));
 }
 
 /**
- * as_cache_get_section_fname_for:
+ * as_cache_section_load_bloom_data:
+ *
+ * Fetch and decode one embedded bloom filter from the section's silo.
+ *
+ * Returns: (transfer full): The filter bits, or %NULL if none was embedded.
  */
-static gchar *
-as_cache_get_section_fname_for (AsCache *cache,
-				AsCacheScope cache_scope,
-				AsComponentScope scope,
-				const gchar *section_key)
+static guint8 *
+as_cache_section_load_bloom_data (XbSilo *silo, const gchar *xpath, gsize *nbits)
 {
-	g_autofree gchar *cache_full_dir = NULL;
-	g_autofree gchar *cache_basename = NULL;
+	g_autoptr(XbNode) bloom_node = NULL;
+	g_autofree guint8 *bloom = NULL;
+	const gchar *b64;
+	gsize bloom_size;
+
+	*nbits = 0;
+	bloom_node = xb_silo_query_first (silo, xpath, NULL);
+	if (bloom_node == NULL)
+		return NULL;
+	b64 = xb_node_get_text (bloom_node);
+	if (b64 == NULL)
+		return NULL;
+	/* ignore filters built with different parameters */
+	if (xb_node_get_attr_as_uint (bloom_node, "k") != AS_CACHE_BLOOM_HASH_N)
+		return NULL;
 
-	cache_full_dir = as_cache_get_root_dir_with_scope (cache, cache_scope, scope);
-	cache_basename = g_strconcat (section_key, ".xb", NULL);
+	bloom = g_base64_decode (b64, &bloom_size);
+	if (bloom_size == 0)
+		return NULL;
 
-	return g_build_filename (cache_full_dir, cache_basename, NULL);
+	*nbits = bloom_size * 8;
+	return g_steal_pointer (&bloom);
 }
 
 /**
- * as_cache_set_contents_internal:
+ * as_cache_section_load_bloom:
+ *
+ * Restore the section's search and ID bloom filters from its silo, if they
+ * were embedded at build time. Sections without filter data (e.g. caches
+ * written by older versions) are simply never pre-filtered.
  */
-static gboolean
-as_cache_set_contents_internal (AsCache *cache,
-				AsComponentScope scope,
-				AsFormatStyle source_format_style,
-				gboolean is_os_data,
-				GPtrArray *cpts,
-				const gchar *cache_key,
-				gpointer refine_user_data,
-				GError **error)
+static void
+as_cache_section_load_bloom (AsCacheSection *csec)
 {
-	AsCachePrivate *priv = GET_PRIVATE (cache);
-	g_autofree gchar *internal_section_key = NULL;
-	g_autofree gchar *section_key = NULL;
-	g_autofree gchar *cache_full_dir = NULL;
-	g_autoptr(AsCacheSection) csec = NULL;
-	g_autoptr(GFile) file = NULL;
-	g_autoptr(GError) tmp_error = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
-	gboolean ret = TRUE;
+	g_clear_pointer (&csec->bloom, g_free);
+	csec->bloom = as_cache_section_load_bloom_data (csec->silo,
+							"components/_asi_bloom",
+							&csec->bloom_nbits);
+
+	g_clear_pointer (&csec->id_bloom, g_free);
+	csec->id_bloom = as_cache_section_load_bloom_data (csec->silo,
+							   "components/_asi_idbloom",
+							   &csec->id_bloom_nbits);
+}
 
-	section_key = as_cache_build_section_key (cache, cache_key);
-	internal_section_key = g_strconcat (as_component_scope_to_string (scope),
-					    ":",
-					    section_key,
-					    NULL);
+/**
+ * as_cache_section_possibly_matches:
+ *
+ * Check the section's bloom filter to determine whether any component in it
+ * could possibly match all of the given search terms. A term passes if it is
+ * a known stemmed token, or if all of its trigrams are present (so substring
+ * and word-prefix matches on raw text are never rejected).
+ *
+ * Returns: %FALSE only if the section can definitely not match.
+ */
+static gboolean
+as_cache_section_possibly_matches (AsCacheSection *csec, const gchar *const *terms)
+{
+	if (csec->bloom == NULL)
+		return TRUE;
 
-	locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
-	g_debug ("Storing cache data for section: %s", internal_section_key);
+	for (guint i = 0; terms[i] != NULL; i++) {
+		g_autofree gchar *folded = NULL;
+		gboolean found = TRUE;
+		gsize len;
 
-	/* ensure we can write to the cache location */
-	cache_full_dir = as_cache_get_root_dir_with_scope (
-	    cache,
-	    AS_CACHE_SCOPE_WRITABLE, /* only the "user" scope is ever writable */
-	    scope);
-	if (!as_utils_is_writable (cache_full_dir)) {
-		g_set_error (error,
-			     AS_CACHE_ERROR,
-			     AS_CACHE_ERROR_PERMISSIONS,
-			     _("Cache location '%s' is not writable."), cache_full_dir);
-		return FALSE;
-	}
+		/* exact stemmed-token hit? */
+		if (as_cache_bloom_test (csec->bloom, csec->bloom_nbits, terms[i], -1))
+			continue;
 
-	/* replace old section, in case one with the same key exists */
-	for (guint i = 0; i < priv->sections->len; i++) {
-		AsCacheSection *csec_entry = g_ptr_array_index (priv->sections, i);
-		if (g_strcmp0 (csec_entry->key, internal_section_key) == 0) {
-			as_cache_remove_section_file (cache, csec_entry);
-			g_ptr_array_remove_index_fast (priv->sections, i);
-			break;
+		folded = g_utf8_strdown (terms[i], -1);
+		len = strlen (folded);
+		if (len < 3)
+			continue; /* too short for a trigram check */
+		for (gsize j = 0; j + 3 <= len; j++) {
+			if (!as_cache_bloom_test (csec->bloom,
+						  csec->bloom_nbits,
+						  folded + j,
+						  3)) {
+				found = FALSE;
+				break;
+			}
 		}
+
+		/* all terms must match a component, so one impossible term
+		 * rules out the complete section */
+		if (!found)
+			return FALSE;
 	}
 
-	/* create new section */
-	csec = as_cache_section_new (internal_section_key);
-	csec->is_os_data = is_os_data && scope == AS_COMPONENT_SCOPE_SYSTEM;
-	csec->scope = scope;
-	csec->format_style = source_format_style;
-	csec->fname = as_cache_get_section_fname_for (cache,
-						      AS_CACHE_SCOPE_WRITABLE,
-						      scope,
-						      section_key);
-	csec->refine_func_udata = refine_user_data;
+	return TRUE;
+}
 
-	csec->silo = as_cache_components_to_internal_xb (cache,
-							 cpts,
-							 TRUE, /* refine */
-							 csec->refine_func_udata,
-							 error);
-	if (csec->silo == NULL)
-		return FALSE;
+/**
+ * as_cache_section_possibly_has_id:
+ *
+ * Check the section's ID bloom filter to determine whether any component in
+ * it could be found under the given lowercased component ID, either directly
+ * or as a provided ID.
+ *
+ * Returns: %FALSE only if no component can definitely match the ID.
+ */
+static gboolean
+as_cache_section_possibly_has_id (AsCacheSection *csec, const gchar *id_lower)
+{
+	if (csec->id_bloom == NULL)
+		return TRUE;
+	return as_cache_bloom_test (csec->id_bloom, csec->id_bloom_nbits, id_lower, -1);
+}
 
-	/* write data to cache directory - XbSilo will do an atomic write, so this is safe */
-	g_debug ("Writing cache file: %s", csec->fname);
-	file = g_file_new_for_path (csec->fname);
-	if (!xb_silo_save_to_file (csec->silo, file, NULL, &tmp_error)) {
-		g_propagate_prefixed_error (error, tmp_error, "Unable to write cache file:");
-		ret = FALSE;
-	}
+/**
+ * as_cache_report_progress:
+ *
+ * Forward a progress update to a registered progress callback, if any.
+ */
+static void
+as_cache_report_progress (AsCache *cache,
+			  AsPoolProgressKind kind,
+			  const gchar *section_key,
+			  guint64 processed,
+			  guint64 total)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
 
-	/* register the new section */
-	g_ptr_array_add (priv->sections, g_steal_pointer (&csec));
+	if (priv->progress_func == NULL)
+		return;
+	(*priv->progress_func) (kind, section_key, processed, total, priv->progress_func_udata);
+}
 
-	/* fix up section ordering */
-	g_ptr_array_sort (priv->sections, as_cache_section_cmp);
+/**
+ * as_cache_checksum_for_node:
+ *
+ * Compute an MD5 checksum over the serialized form of a component node.
+ * The checksum identifies the cached content of a component, so two pools
+ * can be diffed by comparing checksums instead of comparing every field.
+ */
+static gchar *
+as_cache_checksum_for_node (xmlNode *node)
+{
+	g_autoptr(GChecksum) cs = NULL;
+	xmlOutputBufferPtr obuf;
 
-	return ret;
+	obuf = xmlAllocOutputBuffer (NULL);
+	g_assert (obuf != NULL);
+
+	xmlNodeDumpOutput (obuf, node->doc, node, 0, 0, "utf-8");
+	xmlOutputBufferFlush (obuf);
+
+	cs = g_checksum_new (G_CHECKSUM_MD5);
+	g_checksum_update (cs,
+			   (const guchar *) xmlOutputBufferGetContent (obuf),
+			   xmlOutputBufferGetSize (obuf));
+	xmlOutputBufferClose (obuf);
+
+	return g_strdup (g_checksum_get_string (cs));
 }
 
 /**
- * as_cache_set_contents_for_section:
- * @cache: an #AsCache instance.
+ * as_cache_element_is_cold:
  *
- * Set cache contents for components belonging to the operating system,
- * or other well-defined modules that AppStream can add automatically
- * and that it knows a sensible sectoon key for.
- * All previous contents of the cache section will be removed.
+ * Check whether a component child element only matters when the full
+ * details of a component are shown, and is never read by browse or
+ * search views. Must match the set of subtrees the component
+ * lazy-loading machinery can defer.
  */
-gboolean
-as_cache_set_contents_for_section (AsCache *cache,
-				   AsComponentScope scope,
-				   AsFormatStyle source_format_style,
-				   gboolean is_os_data,
-				   GPtrArray *cpts,
-				   const gchar *cache_key,
-				   gpointer refinefn_user_data,
-				   GError **error)
+static gboolean
+as_cache_element_is_cold (const gchar *element)
 {
-	return as_cache_set_contents_internal (cache,
-					       scope,
-					       source_format_style,
-					       is_os_data,
-					       cpts,
-					       cache_key,
-					       refinefn_user_data,
-					       error);
+	return g_strcmp0 (element, "description") == 0 || g_strcmp0 (element, "releases") == 0 ||
+	       g_strcmp0 (element, "screenshots") == 0;
 }
 
 /**
- * as_cache_set_contents_for_path:
- * @cache: an #AsCache instance.
+ * as_cache_components_to_internal_xml:
  *
- * Set cache contents for components added by the API user, which may be in
- * completely arbitrary paths.
- * All previous contents of the cache section will be removed.
+ * Convert a list of components into internal binary XML that we will store
+ * on disk for fast querying.
+ *
+ * Returns: Valid catalog XML metadata for internal cache use.
+ */
+static XbSilo *
+as_cache_components_to_internal_xb (AsCache *cache,
+				    GPtrArray *cpts,
+				    gboolean refine,
+				    gboolean cluster_cold,
+				    const gchar *cache_key,
+				    const gchar *fingerprint,
+				    gpointer refine_func_udata,
+				    GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(XbBuilder) builder = NULL;
+	g_autoptr(XbBuilderNode) bnode_root = NULL;
+	g_autoptr(GHashTable) bloom_entries = NULL;
+	g_autoptr(GHashTable) id_bloom_entries = NULL;
+	g_autoptr(GHashTable) cat_index = NULL;
+	g_autoptr(GPtrArray) cat_rows = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(XbSilo) silo = NULL;
+	g_autoptr(XbBuilderNode) cold_root = NULL;
+	xmlDoc *ser_doc = NULL;
+
+	/* NOTE: This function may run on multiple worker threads at the same time
+	 * (one per section), so it must not touch any shared mutable cache state. */
+
+	bloom_entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	id_bloom_entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	cat_index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	cat_rows = g_ptr_array_new_with_free_func ((GDestroyNotify) g_array_unref);
+
+	bnode_root = xb_builder_node_new ("components");
+
+	/* record the input-data fingerprint, so we can later check whether the
+	 * source files of this section have actually changed */
+	if (fingerprint != NULL)
+		xb_builder_node_set_attr (bnode_root, "fingerprint", fingerprint);
+
+	/* share one string dictionary for constant names across the whole section */
+	ser_doc = as_xml_serialization_doc_new ();
+
+	for (guint i = 0; i < cpts->len; i++) {
+		xmlNode *cnode;
+		g_autoptr(XbBuilderNode) xbnode = NULL;
+		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (cpts, i));
+
+		/* periodically check for cancellation and emit progress, so callers
+		 * can abort quickly and display a meaningful progress bar even for
+		 * very large sections */
+		if (i % 100 == 0) {
+			if (g_cancellable_set_error_if_cancelled (priv->cancellable, error)) {
+				xmlFreeDoc (ser_doc);
+				return NULL;
+			}
+			as_cache_report_progress (cache,
+						  AS_POOL_PROGRESS_KIND_SERIALIZING,
+						  cache_key,
+						  i,
+						  cpts->len);
+
+			/* in throttled mode, briefly give up the CPU between batches so
+			 * foreground work on weak hardware is not starved by the rebuild */
+			if (priv->throttled && i != 0)
+				g_usleep (2000);
+		}
+
+		/* refine component data */
+		if (refine && priv->cpt_refine_func != NULL)
+			(*priv->cpt_refine_func) (cpt, TRUE, refine_func_udata);
+
+		/* serialize to node */
+		cnode = as_component_to_xml_node (cpt, priv->context, ser_doc, NULL);
+		if (cnode == NULL)
+			continue;
+
+		xbnode = xb_builder_node_new ("component");
+
+		/* record a checksum of the serialized content, so pool diffs can
+		 * detect unchanged components without comparing all their fields
+		 * (computed before any cold subtrees are split away, so it always
+		 * covers the complete component content) */
+		{
+			g_autofree gchar *chk = as_cache_checksum_for_node (cnode);
+			xb_builder_node_set_attr (xbnode, "_asi_chk", chk);
+		}
+
+		/* move cold payload out of the hot region of the silo, so the
+		 * component nodes that listing queries walk stay contiguous */
+		if (cluster_cold) {
+			g_autoptr(XbBuilderNode) cold_entry = NULL;
+			xmlNode *lnext;
+
+			for (xmlNode *liter = cnode->children; liter != NULL; liter = lnext) {
+				g_autoptr(XbBuilderNode) bc = NULL;
+
+				lnext = liter->next;
+				if (liter->type != XML_ELEMENT_NODE ||
+				    !as_cache_element_is_cold ((const gchar *) liter->name))
+					continue;
+
+				if (cold_entry == NULL) {
+					g_autofree gchar *idx_str = g_strdup_printf ("%u", i);
+					cold_entry = xb_builder_node_new ("c");
+					xb_builder_node_set_attr (cold_entry, "i", idx_str);
+					xb_builder_node_set_attr (xbnode, "_asi_cidx", idx_str);
+				}
+
+				bc = xb_builder_node_new ((const gchar *) liter->name);
+				xb_builder_node_add_flag (bc, XB_BUILDER_NODE_FLAG_LITERAL_TEXT);
+				as_transmogrify_xmlnode_to_xbuildernode (liter, bc);
+				xb_builder_node_add_child (cold_entry, bc);
+
+				xmlUnlinkNode (liter);
+				xmlFreeNode (liter);
+			}
+
+			if (cold_entry != NULL) {
+				if (cold_root == NULL)
+					cold_root = xb_builder_node_new ("_asi_cold");
+				xb_builder_node_add_child (cold_root, cold_entry);
+			}
+		}
+
+		/* convert component node to builder node */
+		as_transmogrify_xmlnode_to_xbuildernode (cnode, xbnode);
+		xmlFreeNode (cnode);
+
+		/* add tokens */
+		as_cache_builder_add_simple_tokens (xbnode,
+						    cpt,
+						    "summary",
+						    AS_SEARCH_TOKEN_MATCH_SUMMARY);
+		as_cache_builder_add_simple_tokens (xbnode,
+						    cpt,
+						    "_asi_origin",
+						    AS_SEARCH_TOKEN_MATCH_ORIGIN);
+		as_cache_builder_add_simple_tokens (xbnode,
+						    cpt,
+						    "pkgname",
+						    AS_SEARCH_TOKEN_MATCH_PKGNAME);
+		as_cache_builder_add_manifold_tokens (xbnode, cpt);
+		as_cache_builder_add_token_index (xbnode, cpt);
+		as_cache_bloom_collect_component (bloom_entries, cpt);
+		as_cache_bloom_collect_component_ids (id_bloom_entries, cpt);
+		as_cache_builder_collect_categories (cat_index, cat_rows, cpt);
+
+		/* add component to tree */
+		xb_builder_node_add_child (bnode_root, xbnode);
+	}
+
+	/* all component nodes have been transmogrified and freed at this point */
+	xmlFreeDoc (g_steal_pointer (&ser_doc));
+
+	/* add section-wide search and ID-lookup pre-filters */
+	as_cache_builder_add_bloom_filter (bnode_root, "_asi_bloom", bloom_entries);
+	as_cache_builder_add_bloom_filter (bnode_root, "_asi_idbloom", id_bloom_entries);
+
+	/* add packed category bitmap for fast category queries */
+	as_cache_builder_add_category_map (bnode_root, cat_index, cat_rows);
+
+	/* append the cold payload region last, so it ends up at the tail of the
+	 * silo and is never paged in by queries over the component nodes */
+	if (cold_root != NULL)
+		xb_builder_node_add_child (bnode_root, cold_root);
+
+	as_cache_report_progress (cache,
+				  AS_POOL_PROGRESS_KIND_SERIALIZING,
+				  cache_key,
+				  cpts->len,
+				  cpts->len);
+	if (g_cancellable_set_error_if_cancelled (priv->cancellable, error))
+		return NULL;
+
+	builder = xb_builder_new ();
+	/* add our version to the correctness hash */
+	xb_builder_append_guid (builder, PACKAGE_VERSION);
+	xb_builder_import_node (builder, bnode_root);
+
+	as_cache_report_progress (cache, AS_POOL_PROGRESS_KIND_COMPILING, cache_key, 0, 0);
+	silo = xb_builder_compile (builder, XB_BUILDER_COMPILE_FLAG_NONE, NULL, &tmp_error);
+	if (silo == NULL) {
+		g_propagate_prefixed_error (error,
+					    tmp_error,
+					    "Unable to compile binary XML for caching:");
+		return NULL;
+	} else {
+		return g_steal_pointer (&silo);
+	}
+}
+
+/**
+ * as_cache_register_addons_for_component:
+ *
+ * Associate available addons with this component.
+ */
+static gboolean
+as_cache_register_addons_for_component (AsCache *cache, AsComponent *cpt, GError **error)
+{
+	g_autoptr(AsComponentBox) addons = NULL;
+
+	addons = as_cache_get_components_by_extends (cache, as_component_get_id (cpt), error);
+	if (addons == NULL)
+		return FALSE;
+
+	for (guint i = 0; i < as_component_box_len (addons); i++)
+		as_component_add_addon (cpt, as_component_box_index (addons, i));
+
+	return TRUE;
+}
+
+/**
+ * as_transmogrify_xbnode_to_xmlnode:
+ */
+static gboolean
+as_transmogrify_xbnode_to_xmlnode (XbNode *xbn, xmlNode *lxn)
+{
+	XbNodeAttrIter attr_iter;
+	const gchar *attr_name;
+	const gchar *attr_value;
+	const gchar *tail;
+	XbNodeChildIter child_iter;
+	XbNode *child = NULL;
+	g_return_val_if_fail (XB_IS_NODE (xbn), FALSE);
+
+	xmlNodeSetName (lxn, (xmlChar *) xb_node_get_element (xbn));
+	xmlNodeAddContent (lxn, (xmlChar *) xb_node_get_text (xbn));
+
+	tail = xb_node_get_tail (xbn);
+	if (tail != NULL) {
+		xmlNode *tn = xmlNewText ((xmlChar *) tail);
+		xmlAddNextSibling (lxn, tn);
+	}
+
+	/* attributes */
+	xb_node_attr_iter_init (&attr_iter, xbn);
+	while (xb_node_attr_iter_next (&attr_iter, &attr_name, &attr_value))
+		as_xml_add_text_prop (lxn, attr_name, attr_value);
+
+	/* children */
+	xb_node_child_iter_init (&child_iter, xbn);
+	while (xb_node_child_iter_loop (&child_iter, &child)) {
+		xmlNode *lc = xmlNewChild (lxn, NULL, (xmlChar *) "", NULL);
+		if (!as_transmogrify_xbnode_to_xmlnode (child, lc)) {
+			g_clear_pointer (&child, g_object_unref);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * as_transmogrify_xbnode_to_xbuildernode:
+ *
+ * Deep-copy a subtree of a compiled silo into a builder node, so unchanged
+ * data can be carried over into a new silo without being materialized as
+ * an #AsComponent and serialized again.
+ */
+static void
+as_transmogrify_xbnode_to_xbuildernode (XbNode *xbn, XbBuilderNode *bn)
+{
+	XbNodeAttrIter attr_iter;
+	const gchar *attr_name;
+	const gchar *attr_value;
+	const gchar *text;
+	const gchar *tail;
+	XbNodeChildIter child_iter;
+	XbNode *child = NULL;
+
+	text = xb_node_get_text (xbn);
+	if (text != NULL)
+		xb_builder_node_set_text (bn, text, -1);
+	tail = xb_node_get_tail (xbn);
+	if (tail != NULL)
+		xb_builder_node_set_tail (bn, tail, -1);
+
+	/* attributes */
+	xb_node_attr_iter_init (&attr_iter, xbn);
+	while (xb_node_attr_iter_next (&attr_iter, &attr_name, &attr_value))
+		xb_builder_node_set_attr (bn, attr_name, attr_value);
+
+	/* children */
+	xb_node_child_iter_init (&child_iter, xbn);
+	while (xb_node_child_iter_loop (&child_iter, &child)) {
+		g_autoptr(XbBuilderNode) bc = xb_builder_node_new (xb_node_get_element (child));
+		xb_builder_node_add_flag (bc, XB_BUILDER_NODE_FLAG_LITERAL_TEXT);
+		as_transmogrify_xbnode_to_xbuildernode (child, bc);
+		xb_builder_node_add_child (bn, bc);
+	}
+}
+
+typedef struct {
+	XbSilo *silo;
+	XbQuery *query; /* compiled AS_CACHE_QUERY_SHAPE_COLD_BY_IDX query */
+	gchar *idx;
+} AsCacheColdFetchData;
+
+static void
+as_cache_cold_fetch_data_free (AsCacheColdFetchData *cfd)
+{
+	g_object_unref (cfd->silo);
+	g_object_unref (cfd->query);
+	g_free (cfd->idx);
+	g_free (cfd);
+}
+
+/**
+ * as_cache_cold_fetch_cb:
+ *
+ * #AsComponentLazyFetchFn retrieving the cold payload of a component from
+ * the separate silo region it was moved to by a hot-field-clustering cache
+ * compilation. Holding a reference on the silo keeps the mapped data valid
+ * even if the cache section has been replaced in the meantime.
+ */
+static xmlNode *
+as_cache_cold_fetch_cb (AsComponent *cpt, gpointer user_data)
+{
+	AsCacheColdFetchData *cfd = user_data;
+	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
+	g_autoptr(GPtrArray) results = NULL;
+	xmlNode *root;
+
+	xb_value_bindings_bind_str (xb_query_context_get_bindings (&context), 0, cfd->idx, NULL);
+	results = xb_silo_query_with_context (cfd->silo, cfd->query, &context, NULL);
+	if (results == NULL || results->len == 0)
+		return NULL;
+
+	root = xmlNewNode (NULL, (xmlChar *) "");
+	if (!as_transmogrify_xbnode_to_xmlnode (g_ptr_array_index (results, 0), root)) {
+		xmlFreeNode (root);
+		return NULL;
+	}
+
+	return root;
+}
+
+/**
+ * as_cache_component_from_node:
+ *
+ * Get component from an xmlb node.
+ */
+static AsComponent *
+as_cache_component_from_node (AsCache *cache, AsCacheSection *csec, XbNode *node, GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(AsComponent) cpt = NULL;
+	xmlNode *root;
+
+	root = xmlNewNode (NULL, (xmlChar *) "");
+	as_transmogrify_xbnode_to_xmlnode (node, root);
+
+	cpt = as_component_new ();
+	/* defer deserialization of heavy data (descriptions, releases, screenshots)
+	 * until it is actually accessed - most cache results are only ever listed,
+	 * and skip property change notifications while we populate the component */
+	as_component_set_lazy_load (cpt, TRUE);
+	as_component_set_bulk_load (cpt, TRUE);
+	if (!as_component_load_from_xml (cpt, priv->context, root, error)) {
+		xmlFreeNode (root);
+		return NULL;
+	}
+	xmlFreeNode (root);
+
+	/* restore the prebuilt search token index, if we have one */
+	as_cache_load_token_index_for_component (node, cpt);
+
+	/* if the cold payload of this component was clustered into a separate
+	 * silo region, arrange for it to be fetched on first access */
+	{
+		const gchar *cold_idx = xb_node_get_attr (node, "_asi_cidx");
+		if (cold_idx != NULL) {
+			g_autoptr(XbQuery) cold_query = NULL;
+
+			cold_query = as_cache_section_get_shape_query (
+			    csec,
+			    AS_CACHE_QUERY_SHAPE_COLD_BY_IDX,
+			    NULL);
+			if (cold_query != NULL) {
+				AsCacheColdFetchData *cfd = g_new0 (AsCacheColdFetchData, 1);
+				cfd->silo = g_object_ref (csec->silo);
+				cfd->query = g_steal_pointer (&cold_query);
+				cfd->idx = g_strdup (cold_idx);
+				as_component_set_lazy_fetch (
+				    cpt,
+				    priv->context,
+				    as_cache_cold_fetch_cb,
+				    cfd,
+				    (GDestroyNotify) as_cache_cold_fetch_data_free);
+			}
+		}
+	}
+
+	/* remember the content checksum, so this component can be diffed
+	 * against other cache snapshots without materializing its data */
+	as_component_set_cache_checksum (cpt, xb_node_get_attr (node, "_asi_chk"));
+
+	/* find addons (if there are any) - ensure addons don't have addons themselves */
+	if (priv->auto_resolve_addons && (as_component_get_kind (cpt) != AS_COMPONENT_KIND_ADDON) &&
+	    !as_cache_register_addons_for_component (cache, cpt, error)) {
+		return NULL;
+	}
+
+	/* refine for deserialization */
+	if (priv->cpt_refine_func != NULL && !csec->is_mask)
+		(*priv->cpt_refine_func) (cpt, FALSE, csec->refine_func_udata);
+
+	/* re-enable property notifications before the component is handed out */
+	as_component_set_bulk_load (cpt, FALSE);
+
+	as_cache_counter_add (as_cache_ctr_cpts_materialized, 1);
+	return g_steal_pointer (&cpt);
+}
+
+/**
+ * as_cache_remove_section_file:
+ *
+ * Safely remove a cache section file from disk.
+ */
+static void
+as_cache_remove_section_file (AsCache *cache, AsCacheSection *csec)
+{
+	g_autofree gchar *rnd_suffix = NULL;
+	g_autofree gchar *fname_old = NULL;
+	g_autofree gchar *fname_rah = NULL;
+
+	/* drop any readahead hints recorded for this section */
+	fname_rah = g_strconcat (csec->fname, AS_CACHE_RAH_SUFFIX, NULL);
+	g_unlink (fname_rah);
+
+	/* do nothing if file is already gone */
+	if (!g_file_test (csec->fname, G_FILE_TEST_EXISTS))
+		return;
+
+	/* random temporary name, in case multiple processes try to delete this at the same time */
+	rnd_suffix = as_random_alnum_string (6);
+	fname_old = g_strconcat (csec->fname, rnd_suffix, ".old", NULL);
+
+	/* just in case the file exists by any chance, we drop it */
+	g_unlink (fname_old);
+
+	if (g_rename (csec->fname, fname_old) == -1) {
+		/* some other process may have done this already */
+		g_debug ("Unable to rename stale cache file '%s': %s",
+			 csec->fname,
+			 g_strerror (errno));
+		g_unlink (csec->fname);
+		return;
+	}
+
+	/* we should be able to remove the file at this point */
+	if (g_unlink (fname_old) == -1)
+		g_warning ("Unable to unlink old cache file '%s': %s",
+			   fname_old,
+			   g_strerror (errno));
+}
+
+/**
+ * as_cache_build_section_key:
+ *
+ * Generate a cache key that we can use in filenames from an
+ * arbitrary string that the user may have control over.
+ * This will also prepend any locale information.
+ */
+static gchar *
+as_cache_build_section_key (AsCache *cache, const gchar *str)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+
+	if (g_strstr_len (str, -1, "/") == NULL) {
+		/* the string is fine as-is, we just need to add the locale prefix to it */
+		return g_strconcat (priv->locale, "-", str, NULL);
+	} else {
+		/* we need to create a unique key from the filename-ish string */
+		g_autoptr(GChecksum) cs = g_checksum_new (G_CHECKSUM_MD5);
+		g_checksum_update (cs, (const guchar *) str, -1);
+
+		return g_strconcat (priv->locale, "-", g_checksum_get_string (cs), NULL);
+	}
+}
+
+/**
+ * as_cache_get_section_fname_for:
+ */
+static gchar *
+as_cache_get_section_fname_for (AsCache *cache,
+				AsCacheScope cache_scope,
+				AsComponentScope scope,
+				const gchar *section_key)
+{
+	g_autofree gchar *cache_full_dir = NULL;
+	g_autofree gchar *cache_basename = NULL;
+
+	cache_full_dir = as_cache_get_root_dir_with_scope (cache, cache_scope, scope);
+	cache_basename = g_strconcat (section_key, ".xb", NULL);
+
+	return g_build_filename (cache_full_dir, cache_basename, NULL);
+}
+
+/**
+ * as_cache_set_contents_internal:
+ */
+static gboolean
+as_cache_set_contents_internal (AsCache *cache,
+				AsComponentScope scope,
+				AsFormatStyle source_format_style,
+				gboolean is_os_data,
+				GPtrArray *cpts,
+				const gchar *cache_key,
+				const gchar *fingerprint,
+				gpointer refine_user_data,
+				GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autofree gchar *internal_section_key = NULL;
+	g_autofree gchar *section_key = NULL;
+	g_autofree gchar *cache_full_dir = NULL;
+	g_autoptr(AsCacheSection) csec = NULL;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	gboolean ret = TRUE;
+	int prev_nice = 0;
+
+	ptask = as_profile_start (priv->profile, "AsCache:compile-section:%s", cache_key);
+
+	section_key = as_cache_build_section_key (cache, cache_key);
+	internal_section_key = g_strconcat (as_component_scope_to_string (scope),
+					    ":",
+					    section_key,
+					    NULL);
+
+	g_debug ("Storing cache data for section: %s", internal_section_key);
+
+	/* bail out early if the operation was already cancelled */
+	if (g_cancellable_set_error_if_cancelled (priv->cancellable, error))
+		return FALSE;
+
+	/* ensure we can write to the cache location */
+	cache_full_dir = as_cache_get_root_dir_with_scope (
+	    cache,
+	    AS_CACHE_SCOPE_WRITABLE, /* only the "user" scope is ever writable */
+	    scope);
+	if (!as_utils_is_writable (cache_full_dir)) {
+		g_set_error (error,
+			     AS_CACHE_ERROR,
+			     AS_CACHE_ERROR_PERMISSIONS,
+			     _("Cache location '%s' is not writable."), cache_full_dir);
+		return FALSE;
+	}
+
+	/* create new section */
+	csec = as_cache_section_new (internal_section_key);
+	csec->is_os_data = is_os_data && scope == AS_COMPONENT_SCOPE_SYSTEM;
+	csec->scope = scope;
+	csec->format_style = source_format_style;
+	csec->fname = as_cache_get_section_fname_for (cache,
+						      AS_CACHE_SCOPE_WRITABLE,
+						      scope,
+						      section_key);
+	csec->refine_func_udata = refine_user_data;
+
+	/* Compile the silo before taking the writer lock: sections are compiled
+	 * on multiple worker threads during a pool refresh, and the compile is by
+	 * far the most expensive step, so serializing it would make the refresh
+	 * take the sum instead of the maximum of the per-section compile times. */
+
+	/* in throttled mode, run the CPU-heavy serialization & compile work at
+	 * reduced scheduling priority so an interactive session stays responsive */
+	if (priv->throttled)
+		prev_nice = as_cache_throttle_thread_begin ();
+	csec->silo = as_cache_components_to_internal_xb (cache,
+							 cpts,
+							 TRUE, /* refine */
+							 priv->cluster_hot_fields,
+							 cache_key,
+							 fingerprint,
+							 csec->refine_func_udata,
+							 error);
+	if (priv->throttled)
+		as_cache_throttle_thread_end (prev_nice);
+	if (csec->silo == NULL)
+		return FALSE;
+	as_cache_section_load_bloom (csec);
+	as_cache_section_load_catmap (csec);
+
+	/* last chance to abort before we touch the on-disk cache */
+	if (g_cancellable_set_error_if_cancelled (priv->cancellable, error))
+		return FALSE;
+
+	/* write data to cache directory - XbSilo will do an atomic write, so this is safe */
+	g_debug ("Writing cache file: %s", csec->fname);
+	file = g_file_new_for_path (csec->fname);
+	if (!xb_silo_save_to_file (csec->silo, file, NULL, &tmp_error)) {
+		g_propagate_prefixed_error (error, tmp_error, "Unable to write cache file:");
+		ret = FALSE;
+	}
+
+	if (ret && priv->progress_func != NULL) {
+		g_autoptr(GBytes) silo_bytes = xb_silo_get_bytes (csec->silo);
+		as_cache_report_progress (cache,
+					  AS_POOL_PROGRESS_KIND_WRITING,
+					  cache_key,
+					  g_bytes_get_size (silo_bytes),
+					  g_bytes_get_size (silo_bytes));
+	}
+
+	/* Replace the heap-backed silo that we just compiled with a read-only mapping
+	 * of the written cache file: the mapped pages are backed by the page cache and
+	 * shared with every other process that has this cache section loaded, while
+	 * the in-memory silo data would stay private to this process forever. */
+	if (ret) {
+		g_autoptr(XbSilo) mapped_silo = xb_silo_new ();
+		g_autoptr(GError) load_error = NULL;
+
+		if (xb_silo_load_from_file (mapped_silo,
+					    file,
+					    XB_SILO_LOAD_FLAG_NONE,
+					    NULL,
+					    &load_error)) {
+			g_set_object (&csec->silo, mapped_silo);
+			g_hash_table_remove_all (csec->query_cache);
+			for (guint i = 0; i < AS_CACHE_QUERY_SHAPE_LAST; i++)
+				g_clear_object (&csec->shape_queries[i]);
+			as_cache_section_load_bloom (csec);
+			as_cache_section_load_catmap (csec);
+		} else {
+			g_debug ("Unable to map written cache section '%s', "
+				 "keeping in-memory data: %s",
+				 internal_section_key,
+				 load_error->message);
+		}
+	}
+
+	/* the shared section registry is only touched under the writer lock */
+	locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+
+	/* replace old section, in case one with the same key exists */
+	for (guint i = 0; i < priv->sections->len; i++) {
+		AsCacheSection *csec_entry = g_ptr_array_index (priv->sections, i);
+		if (g_strcmp0 (csec_entry->key, internal_section_key) == 0) {
+			/* only delete the old section file if it is not the one
+			 * we just (atomically) replaced with the new data */
+			if (g_strcmp0 (csec_entry->fname, csec->fname) != 0)
+				as_cache_remove_section_file (cache, csec_entry);
+			g_ptr_array_remove_index_fast (priv->sections, i);
+			break;
+		}
+	}
+
+	/* register the new section */
+	g_ptr_array_add (priv->sections, g_steal_pointer (&csec));
+
+	/* fix up section ordering */
+	g_ptr_array_sort (priv->sections, as_cache_section_cmp);
+
+	/* any previously memoized components may be outdated now */
+	as_cache_hot_cpts_invalidate (cache);
+
+	return ret;
+}
+
+/**
+ * as_cache_set_contents_for_section:
+ * @cache: an #AsCache instance.
+ *
+ * Set cache contents for components belonging to the operating system,
+ * or other well-defined modules that AppStream can add automatically
+ * and that it knows a sensible sectoon key for.
+ * All previous contents of the cache section will be removed.
+ */
+gboolean
+as_cache_set_contents_for_section (AsCache *cache,
+				   AsComponentScope scope,
+				   AsFormatStyle source_format_style,
+				   gboolean is_os_data,
+				   GPtrArray *cpts,
+				   const gchar *cache_key,
+				   const gchar *fingerprint,
+				   gpointer refinefn_user_data,
+				   GError **error)
+{
+	return as_cache_set_contents_internal (cache,
+					       scope,
+					       source_format_style,
+					       is_os_data,
+					       cpts,
+					       cache_key,
+					       fingerprint,
+					       refinefn_user_data,
+					       error);
+}
+
+/**
+ * as_cache_set_contents_for_path:
+ * @cache: an #AsCache instance.
+ *
+ * Set cache contents for components added by the API user, which may be in
+ * completely arbitrary paths.
+ * All previous contents of the cache section will be removed.
+ */
+gboolean
+as_cache_set_contents_for_path (AsCache *cache,
+				GPtrArray *cpts,
+				const gchar *filename,
+				gpointer refinefn_user_data,
+				GError **error)
+{
+	if (g_strcmp0 (filename, "os-catalog") == 0 || g_strcmp0 (filename, "flatpak") == 0 ||
+	    g_strcmp0 (filename, "metainfo") == 0) {
+		g_set_error (error,
+			     AS_CACHE_ERROR,
+			     AS_CACHE_ERROR_BAD_VALUE,
+			     "Can not add extra repository data with reserved cache key name '%s'.",
+			     filename);
+		return FALSE;
+	}
+
+	return as_cache_set_contents_internal (cache,
+					       as_utils_guess_scope_from_path (filename),
+					       AS_FORMAT_STYLE_CATALOG,
+					       FALSE, /* no OS data */
+					       cpts,
+					       filename,
+					       NULL, /* no fingerprint */
+					       refinefn_user_data,
+					       error);
+}
+
+/**
+ * as_cache_get_ctime_with_section_key:
+ * @cache: An instance of #AsCache.
+ * @scope: Component scope
+ * @section_key: An internal cache section key.
+ * @cache_scope: Returns which scope the cache that was most recent is in.
+ *
+ * Returns: ctime of the cache section.
+ */
+static time_t
+as_cache_get_ctime_with_section_key (AsCache *cache,
+				     AsComponentScope scope,
+				     const gchar *section_key,
+				     AsCacheScope *cache_scope)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	struct stat cache_sbuf;
+	g_autofree gchar *xb_fname_user = NULL;
+	g_autofree gchar *xb_fname_sys = NULL;
+	time_t t_sys, t_user;
+
+	xb_fname_user = as_cache_get_section_fname_for (cache,
+							AS_CACHE_SCOPE_WRITABLE,
+							scope,
+							section_key);
+	if (g_strcmp0 (priv->cache_root_dir, priv->system_cache_dir) != 0) {
+		xb_fname_sys = as_cache_get_section_fname_for (cache,
+							       AS_CACHE_SCOPE_SYSTEM,
+							       scope,
+							       section_key);
+	}
+
+	if (cache_scope != NULL)
+		*cache_scope = AS_CACHE_SCOPE_WRITABLE;
+
+	t_user = 0;
+	t_sys = 0;
+	if (stat (xb_fname_user, &cache_sbuf) == 0)
+		t_user = cache_sbuf.st_ctime;
+	if (xb_fname_sys == NULL) {
+		return t_user;
+	} else {
+		if (stat (xb_fname_sys, &cache_sbuf) == 0)
+			t_sys = cache_sbuf.st_ctime;
+		if (t_sys > t_user) {
+			if (cache_scope != NULL)
+				*cache_scope = AS_CACHE_SCOPE_SYSTEM;
+			return t_sys;
+		}
+		return t_user;
+	}
+}
+
+/**
+ * as_cache_get_ctime:
+ * @cache: An instance of #AsCache.
+ * @scope: Component scope
+ * @cache_key: A user-provided cache key.
+ * @cache_scope: returns which scope the cache that was most recent is in.
+ *
+ * Returns: ctime of the cache section.
+ */
+time_t
+as_cache_get_ctime (AsCache *cache,
+		    AsComponentScope scope,
+		    const gchar *cache_key,
+		    AsCacheScope *cache_scope)
+{
+	g_autofree gchar *section_key = NULL;
+
+	if (scope == AS_COMPONENT_SCOPE_UNKNOWN) {
+		scope = AS_COMPONENT_SCOPE_SYSTEM;
+		if (g_str_has_prefix (cache_key, "/home") ||
+		    g_str_has_prefix (cache_key, g_get_home_dir ()))
+			scope = AS_COMPONENT_SCOPE_USER;
+	}
+
+	section_key = as_cache_build_section_key (cache, cache_key);
+	return as_cache_get_ctime_with_section_key (cache, scope, section_key, cache_scope);
+}
+
+/**
+ * as_cache_check_section_outdated:
+ *
+ * Returns: %TRUE if ctime of @origin_path is newer than the ctime on the cache section.
+ */
+static gboolean
+as_cache_check_section_outdated (AsCache *cache,
+				 AsComponentScope scope,
+				 const gchar *cache_key,
+				 const gchar *origin_path)
+{
+	struct stat sb;
+	time_t cache_ctime;
+
+	if (stat (origin_path, &sb) < 0)
+		return TRUE;
+
+	cache_ctime = as_cache_get_ctime (cache, scope, cache_key, NULL);
+	if (sb.st_ctime > cache_ctime)
+		return TRUE;
+
+	return FALSE;
+}
+
+/**
+ * as_cache_load_section_internal:
+ *
+ * Load cache section.
+ */
+static void
+as_cache_load_section_internal (AsCache *cache,
+				AsComponentScope scope,
+				const gchar *cache_key,
+				AsFormatStyle source_format_style,
+				gboolean is_os_data,
+				const gchar *fingerprint,
+				gboolean *is_outdated,
+				gpointer refine_user_data)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	AsCacheScope cache_scope;
+	GStatBuf sbuf;
+	g_autofree gchar *section_key = NULL;
+	g_autofree gchar *internal_section_key = NULL;
+	g_autofree gchar *xb_fname = NULL;
+	g_autoptr(AsCacheSection) csec = NULL;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+
+	ptask = as_profile_start (priv->profile, "AsCache:load-section:%s", cache_key);
+
+	section_key = as_cache_build_section_key (cache, cache_key);
+	internal_section_key = g_strconcat (as_component_scope_to_string (scope),
+					    ":",
+					    section_key,
+					    NULL);
+
+	/* check which available cache is the most recent one */
+	as_cache_get_ctime_with_section_key (cache, scope, section_key, &cache_scope);
+
+	xb_fname = as_cache_get_section_fname_for (cache, cache_scope, scope, section_key);
+
+	if (!g_file_test (xb_fname, G_FILE_TEST_EXISTS)) {
+		/* nothing to do if no cache file exists that we can load */
+		if (is_outdated != NULL)
+			*is_outdated = TRUE;
+		return;
+	}
+
+	/* start fetching the silo regions a previous run needed, before we touch the file */
+	as_cache_section_apply_readahead_hints (xb_fname);
+
+	csec = as_cache_section_new (internal_section_key);
+	csec->is_os_data = is_os_data && scope == AS_COMPONENT_SCOPE_SYSTEM;
+	csec->scope = scope;
+	csec->format_style = source_format_style;
+	csec->fname = g_strdup (xb_fname);
+	csec->refine_func_udata = refine_user_data;
+
+	/* the cache file is mapped read-only here, so all processes which have
+	 * this section loaded share the physical pages of its data */
+	csec->silo = xb_silo_new ();
+	file = g_file_new_for_path (csec->fname);
+	if (!xb_silo_load_from_file (csec->silo, file, XB_SILO_LOAD_FLAG_NONE, NULL, &tmp_error)) {
+		g_debug ("Failed to load AppStream cache section '%s' - marking cache as outdated. "
+			 "Issue: %s",
+			 internal_section_key,
+			 tmp_error->message);
+		if (is_outdated != NULL)
+			*is_outdated = TRUE;
+		return;
+	}
+
+	/* verify that the cache was built from the same input data, in case the
+	 * caller knows the current fingerprint of the source files */
+	if (fingerprint != NULL) {
+		g_autoptr(XbNode) root_node = xb_silo_get_root (csec->silo);
+		const gchar *cached_fp = NULL;
+
+		if (root_node != NULL)
+			cached_fp = xb_node_get_attr (root_node, "fingerprint");
+		if (g_strcmp0 (cached_fp, fingerprint) != 0) {
+			g_debug ("Input fingerprint of cache section '%s' changed "
+				 "(had: %s, expected: %s) - marking cache as outdated.",
+				 internal_section_key,
+				 cached_fp ? cached_fp : "(none)",
+				 fingerprint);
+			if (is_outdated != NULL)
+				*is_outdated = TRUE;
+			return;
+		}
+	}
+
+	as_cache_section_load_bloom (csec);
+	as_cache_section_load_catmap (csec);
+
+	as_cache_counter_add (as_cache_ctr_sections_loaded, 1);
+	if (g_stat (csec->fname, &sbuf) == 0)
+		as_cache_counter_add (as_cache_ctr_bytes_mapped, sbuf.st_size);
+
+	/* register the new section, replacing any old data */
+	for (guint i = 0; i < priv->sections->len; i++) {
+		AsCacheSection *csec_entry = g_ptr_array_index (priv->sections, i);
+		if (g_strcmp0 (csec_entry->key, internal_section_key) == 0) {
+			g_ptr_array_remove_index_fast (priv->sections, i);
+			break;
+		}
+	}
+	g_ptr_array_add (priv->sections, g_steal_pointer (&csec));
+	g_debug ("Using cache file: %s", xb_fname);
+
+	/* fix up section ordering */
+	g_ptr_array_sort (priv->sections, as_cache_section_cmp);
+
+	/* any previously memoized components may be outdated now */
+	as_cache_hot_cpts_invalidate (cache);
+}
+
+/**
+ * as_cache_load_section_for_key:
+ * @cache: an #AsCache instance.
+ *
+ * Load cache section that was created using a custom, special key.
+ */
+void
+as_cache_load_section_for_key (AsCache *cache,
+			       AsComponentScope scope,
+			       AsFormatStyle source_format_style,
+			       gboolean is_os_data,
+			       const gchar *cache_key,
+			       const gchar *fingerprint,
+			       gboolean *is_outdated,
+			       gpointer refinefn_user_data)
+{
+	as_cache_load_section_internal (cache,
+					scope,
+					cache_key,
+					source_format_style,
+					is_os_data,
+					fingerprint,
+					is_outdated,
+					refinefn_user_data);
+}
+
+/**
+ * as_cache_load_section_for_path:
+ * @cache: an #AsCache instance.
+ *
+ * Try to load possibly cached data for a generic, custom path.
+ */
+void
+as_cache_load_section_for_path (AsCache *cache,
+				const gchar *filename,
+				gboolean *is_outdated,
+				gpointer refinefn_user_data)
+{
+	AsComponentScope scope;
+
+	scope = as_utils_guess_scope_from_path (filename);
+	if (is_outdated != NULL)
+		*is_outdated = as_cache_check_section_outdated (cache, scope, filename, filename);
+
+	as_cache_load_section_internal (cache,
+					scope,
+					filename,
+					AS_FORMAT_STYLE_CATALOG,
+					FALSE,
+					NULL, /* no fingerprint */
+					is_outdated,
+					refinefn_user_data);
+}
+
+/**
+ * as_cache_mask_by_data_id:
+ * @cache: an #AsCache instance.
+ * @cdid: Data-ID of an #AsComponent
+ *
+ * Mark a component as "deleted" from the cache.
+ * The component will no longer show up in search results or be returned
+ * by other queries.
+ */
+void
+as_cache_mask_by_data_id (AsCache *cache, const gchar *cdid)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+	g_hash_table_insert (priv->masked, g_strdup (cdid), GINT_TO_POINTER (TRUE));
+	as_cache_hot_cpts_invalidate (cache);
+}
+
+/**
+ * as_cache_data_id_for_node:
+ *
+ * Build the data-ID of a cached component directly from its silo node,
+ * without materializing an #AsComponent.
+ * This mirrors as_utils_build_data_id_for_cpt() on the serialized data.
+ */
+static gchar *
+as_cache_data_id_for_node (AsCacheSection *csec, XbNode *node)
+{
+	g_autoptr(XbNode) bundle_node = NULL;
+	AsComponentScope scope = csec->scope;
+	AsBundleKind bundle_kind = AS_BUNDLE_KIND_UNKNOWN;
+	const gchar *scope_str;
+	const gchar *cpt_kind_str;
+
+	scope_str = xb_node_query_text (node, "_asi_scope", NULL);
+	if (scope_str != NULL)
+		scope = as_component_scope_from_string (scope_str);
+
+	/* determine bundle, the same way as_utils_get_component_bundle_kind() does */
+	cpt_kind_str = xb_node_get_attr (node, "type");
+	if (xb_node_query_text (node, "pkgname", NULL) != NULL ||
+	    as_component_kind_from_string (cpt_kind_str) == AS_COMPONENT_KIND_OPERATING_SYSTEM)
+		bundle_kind = AS_BUNDLE_KIND_PACKAGE;
+	bundle_node = xb_node_query_first (node, "bundle", NULL);
+	if (bundle_node != NULL)
+		bundle_kind = as_bundle_kind_from_string (xb_node_get_attr (bundle_node, "type"));
+
+	/* assume "package" for system-wide components from metainfo files */
+	if (bundle_kind == AS_BUNDLE_KIND_UNKNOWN && scope == AS_COMPONENT_SCOPE_SYSTEM &&
+	    csec->format_style == AS_FORMAT_STYLE_METAINFO)
+		bundle_kind = AS_BUNDLE_KIND_PACKAGE;
+
+	return as_utils_build_data_id (scope,
+				       bundle_kind,
+				       xb_node_query_text (node, "_asi_origin", NULL),
+				       xb_node_query_text (node, "id", NULL),
+				       xb_node_query_text (node, "_asi_branch", NULL));
+}
+
+/**
+ * as_cache_builder_readd_tokens:
+ *
+ * Re-attach binary search tokens of the given match kind to one element of
+ * a copied component subtree, restoring them from the serialized token index.
+ */
+static void
+as_cache_builder_readd_tokens (XbBuilderNode *bn,
+			       const gchar *element,
+			       GPtrArray *tindex_nodes,
+			       AsSearchTokenMatch token_kind)
+{
+	g_autoptr(XbBuilderNode) token_node = NULL;
+	guint added = 0;
+
+	token_node = xb_builder_node_get_child (bn, element, NULL);
+	if (token_node == NULL)
+		return;
+
+	for (guint i = 0; i < tindex_nodes->len; i++) {
+		XbNode *tn = XB_NODE (g_ptr_array_index (tindex_nodes, i));
+		const gchar *token = xb_node_get_text (tn);
+
+		if (token == NULL)
+			continue;
+		if ((xb_node_get_attr_as_uint (tn, "m") & token_kind) == 0)
+			continue;
+		xb_builder_node_add_token (token_node, token);
+
+		/* see as_cache_builder_add_simple_tokens for the rationale of this clamp */
+		if (++added >= 32)
+			break;
+	}
+}
+
+/**
+ * as_cache_retokenize_copied_component:
+ *
+ * Binary search tokens are not preserved when copying a compiled subtree
+ * through the node API, so restore them on the copied builder node from
+ * the component's serialized token index.
+ */
+static void
+as_cache_retokenize_copied_component (XbNode *node, XbBuilderNode *bn)
+{
+	g_autoptr(GPtrArray) tindex_nodes = NULL;
+
+	tindex_nodes = xb_node_query (node, "_asi_tindex/t", 0, NULL);
+	if (tindex_nodes == NULL)
+		return;
+
+	as_cache_builder_readd_tokens (bn, "summary", tindex_nodes, AS_SEARCH_TOKEN_MATCH_SUMMARY);
+	as_cache_builder_readd_tokens (bn,
+				       "_asi_origin",
+				       tindex_nodes,
+				       AS_SEARCH_TOKEN_MATCH_ORIGIN);
+	as_cache_builder_readd_tokens (bn, "pkgname", tindex_nodes, AS_SEARCH_TOKEN_MATCH_PKGNAME);
+}
+
+/**
+ * as_cache_masking_silo_merge:
+ *
+ * Build a new mask silo by copying the still-valid component subtrees of
+ * the previous mask silo node-by-node, and serializing only the newly
+ * added components. The unchanged components never take the costly round
+ * trip through #AsComponent deserialization and re-serialization.
+ *
+ * Returns: (transfer full): The new silo, or %NULL on error.
+ */
+static XbSilo *
+as_cache_masking_silo_merge (AsCache *cache,
+			     AsCacheSection *old_mcsec,
+			     GPtrArray *new_cpts,
+			     GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(XbBuilder) builder = NULL;
+	g_autoptr(XbBuilderNode) bnode_root = NULL;
+	g_autoptr(GPtrArray) old_nodes = NULL;
+	g_autoptr(GHashTable) new_ids = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(XbSilo) silo = NULL;
+	xmlDoc *ser_doc = NULL;
+
+	/* NOTE: This function is already write-lock protected by its callers */
+
+	bnode_root = xb_builder_node_new ("components");
+
+	/* data-IDs that the new components occupy - their old nodes are superseded */
+	new_ids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	for (guint i = 0; i < new_cpts->len; i++) {
+		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (new_cpts, i));
+		g_hash_table_add (new_ids, g_strdup (as_component_get_data_id (cpt)));
+	}
+
+	/* carry over all components that are still part of the mask */
+	old_nodes = xb_silo_query (old_mcsec->silo, "components/component", 0, NULL);
+	for (guint i = 0; old_nodes != NULL && i < old_nodes->len; i++) {
+		XbNode *node = g_ptr_array_index (old_nodes, i);
+		g_autoptr(XbBuilderNode) bn = NULL;
+		g_autofree gchar *data_id = NULL;
+		gpointer iptr;
+
+		data_id = as_cache_data_id_for_node (old_mcsec, node);
+
+		/* just delete masked components */
+		iptr = g_hash_table_lookup (priv->masked, data_id);
+		if (iptr != NULL && GPOINTER_TO_INT (iptr) == TRUE)
+			continue;
+
+		/* drop components that are replaced by new data */
+		if (g_hash_table_contains (new_ids, data_id))
+			continue;
+
+		bn = xb_builder_node_new ("component");
+		xb_builder_node_add_flag (bn, XB_BUILDER_NODE_FLAG_LITERAL_TEXT);
+		as_transmogrify_xbnode_to_xbuildernode (node, bn);
+		as_cache_retokenize_copied_component (node, bn);
+		xb_builder_node_add_child (bnode_root, bn);
+
+		g_hash_table_insert (priv->masked, g_steal_pointer (&data_id), GINT_TO_POINTER (FALSE));
+	}
+
+	/* serialize only the newly added components */
+	ser_doc = as_xml_serialization_doc_new ();
+	for (guint i = 0; i < new_cpts->len; i++) {
+		xmlNode *cnode;
+		g_autoptr(XbBuilderNode) xbnode = NULL;
+		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (new_cpts, i));
+
+		cnode = as_component_to_xml_node (cpt, priv->context, ser_doc, NULL);
+		if (cnode == NULL)
+			continue;
+		xbnode = xb_builder_node_new ("component");
+		as_transmogrify_xmlnode_to_xbuildernode (cnode, xbnode);
+		xmlFreeNode (cnode);
+
+		as_cache_builder_add_simple_tokens (xbnode,
+						    cpt,
+						    "summary",
+						    AS_SEARCH_TOKEN_MATCH_SUMMARY);
+		as_cache_builder_add_simple_tokens (xbnode,
+						    cpt,
+						    "_asi_origin",
+						    AS_SEARCH_TOKEN_MATCH_ORIGIN);
+		as_cache_builder_add_simple_tokens (xbnode,
+						    cpt,
+						    "pkgname",
+						    AS_SEARCH_TOKEN_MATCH_PKGNAME);
+		as_cache_builder_add_manifold_tokens (xbnode, cpt);
+		as_cache_builder_add_token_index (xbnode, cpt);
+
+		xb_builder_node_add_child (bnode_root, xbnode);
+	}
+	xmlFreeDoc (ser_doc);
+
+	/* no section-wide pre-filter data is rebuilt here: the volatile mask
+	 * section is tiny and its pre-filters are never loaded anyway */
+
+	builder = xb_builder_new ();
+	/* add our version to the correctness hash */
+	xb_builder_append_guid (builder, PACKAGE_VERSION);
+	xb_builder_import_node (builder, bnode_root);
+
+	silo = xb_builder_compile (builder, XB_BUILDER_COMPILE_FLAG_NONE, NULL, &tmp_error);
+	if (silo == NULL) {
+		g_propagate_prefixed_error (error,
+					    g_steal_pointer (&tmp_error),
+					    "Unable to compile binary XML for caching:");
+		return NULL;
+	}
+
+	return g_steal_pointer (&silo);
+}
+
+/**
+ * as_cache_add_masking_component:
+ * @cache: an #AsCache instance.
+ * @cpts: An array of #AsComponent to add as override
+ *
+ * Add a masking component to the cache that is returned in place of
+ * existing components in the cache.
  */
 gboolean
-as_cache_set_contents_for_path (AsCache *cache,
-				GPtrArray *cpts,
-				const gchar *filename,
-				gpointer refinefn_user_data,
-				GError **error)
+as_cache_add_masking_components (AsCache *cache, GPtrArray *cpts, GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(AsCacheSection) old_mcsec = NULL;
+	g_autoptr(AsCacheSection) mcsec = NULL;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autofree gchar *volatile_fname = NULL;
+	gint fd;
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+
+	/* find old masking section */
+	for (guint i = 0; i < priv->sections->len; i++) {
+		AsCacheSection *csec_entry = g_ptr_array_index (priv->sections, i);
+		if (csec_entry->is_mask) {
+			old_mcsec = g_ptr_array_steal_index_fast (priv->sections, i);
+			break;
+		}
+	}
+
+	/* generate filename for the volatile section in memory */
+	volatile_fname = g_build_filename (g_get_user_runtime_dir (),
+					   "appstream-extra-XXXXXX.mdb",
+					   NULL);
+	fd = g_mkstemp (volatile_fname);
+	if (fd > 0)
+		close (fd);
+
+	/* create new section */
+	mcsec = as_cache_section_new ("memory:volatile_mask");
+	mcsec->scope = AS_COMPONENT_SCOPE_USER;
+	mcsec->format_style = AS_FORMAT_STYLE_CATALOG;
+	mcsec->fname = g_steal_pointer (&volatile_fname);
+	mcsec->is_mask = TRUE;
+
+	if (old_mcsec != NULL) {
+		/* merge the old silo at node level: components that are kept do not
+		 * need to be deserialized and serialized again, only the newly
+		 * added components are */
+		mcsec->silo = as_cache_masking_silo_merge (cache, old_mcsec, cpts, &tmp_error);
+
+		/* drop the old data */
+		as_cache_remove_section_file (cache, old_mcsec);
+	} else {
+		/* the tiny mask section is merged node-wise on update, which would
+		 * not carry a cold region along - never cluster it */
+		mcsec->silo = as_cache_components_to_internal_xb (cache,
+								  cpts,
+								  FALSE, /* do not refine */
+								  FALSE, /* do not cluster */
+								  mcsec->key,
+								  NULL, /* no fingerprint */
+								  NULL,
+								  &tmp_error);
+	}
+
+	/* register the new masking components */
+	for (guint i = 0; i < cpts->len; i++) {
+		AsComponent *cpt = g_ptr_array_index (cpts, i);
+		g_hash_table_insert (priv->masked,
+				     g_strdup (as_component_get_data_id (cpt)),
+				     GINT_TO_POINTER (FALSE));
+	}
+
+	if (mcsec->silo == NULL) {
+		g_propagate_prefixed_error (
+		    error,
+		    g_steal_pointer (&tmp_error),
+		    "Unable to add masking components to cache: Silo build failed. ");
+		return FALSE;
+	}
+
+	/* write data */
+	file = g_file_new_for_path (mcsec->fname);
+	if (!xb_silo_save_to_file (mcsec->silo, file, NULL, &tmp_error)) {
+		g_propagate_prefixed_error (
+		    error,
+		    g_steal_pointer (&tmp_error),
+		    "Unable to add masking components to cache: Failed to store silo. ");
+		return FALSE;
+	}
+
+	/* register the new section */
+	g_ptr_array_add (priv->sections, g_steal_pointer (&mcsec));
+
+	/* fix up section ordering */
+	g_ptr_array_sort (priv->sections, as_cache_section_cmp);
+
+	/* memoized components may now be overridden by a masking component */
+	as_cache_hot_cpts_invalidate (cache);
+
+	return TRUE;
+}
+
+/**
+ * as_cache_set_refine_func:
+ * @cache: An instance of #AsCache.
+ *
+ * Set function to be called on a component after it was deserialized.
+ */
+void
+as_cache_set_refine_func (AsCache *cache, AsCacheDataRefineFn func)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	priv->cpt_refine_func = func;
+}
+
+/**
+ * as_cache_set_progress_func:
+ * @cache: An instance of #AsCache.
+ *
+ * Set function to be called with progress updates while cache
+ * sections are compiled and written.
+ */
+void
+as_cache_set_progress_func (AsCache *cache, AsPoolProgressFn func, gpointer user_data)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	priv->progress_func = func;
+	priv->progress_func_udata = user_data;
+}
+
+/**
+ * as_cache_set_cancellable:
+ * @cache: An instance of #AsCache.
+ * @cancellable: (nullable): a #GCancellable, or %NULL to unset.
+ *
+ * Set a cancellable that is checked at the cooperative cancellation
+ * points while cache sections are compiled, allowing expensive cache
+ * rebuilds to be aborted quickly.
+ */
+void
+as_cache_set_cancellable (AsCache *cache, GCancellable *cancellable)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_set_object (&priv->cancellable, cancellable);
+}
+
+typedef struct {
+	guint n_queries;
+	gint64 time_total_usec;
+	gint64 time_max_usec;
+	guint64 results_total;
+	guint64 sections_queried;
+	guint64 sections_with_hits;
+} AsCacheQueryStat;
+
+/**
+ * as_cache_record_query_stat:
+ *
+ * Fold one completed query into the per-query-shape statistics table.
+ * Only ever called if query instrumentation was explicitly enabled.
+ */
+static void
+as_cache_record_query_stat (AsCache *cache,
+			    const gchar *label,
+			    gint64 duration_usec,
+			    guint n_results,
+			    guint sections_queried,
+			    guint sections_with_hits)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	AsCacheQueryStat *qstat;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->query_stats_mutex);
+
+	qstat = g_hash_table_lookup (priv->query_stats, label);
+	if (qstat == NULL) {
+		qstat = g_new0 (AsCacheQueryStat, 1);
+		g_hash_table_insert (priv->query_stats, g_strdup (label), qstat);
+	}
+
+	qstat->n_queries++;
+	qstat->time_total_usec += duration_usec;
+	if (duration_usec > qstat->time_max_usec)
+		qstat->time_max_usec = duration_usec;
+	qstat->results_total += n_results;
+	qstat->sections_queried += sections_queried;
+	qstat->sections_with_hits += sections_with_hits;
+}
+
+/**
+ * as_cache_set_query_stats_enabled:
+ * @cache: An instance of #AsCache.
+ * @enabled: %TRUE to record query statistics.
+ *
+ * Enable or disable collection of per-query statistics.
+ * Collecting statistics adds a small overhead to every query, so this
+ * should only be enabled for debugging and performance analysis.
+ */
+void
+as_cache_set_query_stats_enabled (AsCache *cache, gboolean enabled)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	priv->query_stats_enabled = enabled;
+}
+
+static gint
+as_cache_query_stat_entry_cmp (gconstpointer a, gconstpointer b)
+{
+	const AsCacheQueryStat *qa = (*(gpointer **) a)[1];
+	const AsCacheQueryStat *qb = (*(gpointer **) b)[1];
+
+	/* most expensive query shapes first */
+	if (qa->time_total_usec > qb->time_total_usec)
+		return -1;
+	if (qa->time_total_usec < qb->time_total_usec)
+		return 1;
+	return 0;
+}
+
+/**
+ * as_cache_get_query_stats_report:
+ * @cache: An instance of #AsCache.
+ *
+ * Render all query statistics recorded so far into a human-readable
+ * report, with the most expensive query shapes listed first.
+ *
+ * Returns: (transfer full) (nullable): the report text, or %NULL if nothing was recorded.
+ */
+gchar *
+as_cache_get_query_stats_report (AsCache *cache)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	GHashTableIter ht_iter;
+	gpointer ht_key, ht_value;
+	g_autoptr(GPtrArray) entries = NULL;
+	GString *report;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->query_stats_mutex);
+
+	if (g_hash_table_size (priv->query_stats) == 0)
+		return NULL;
+
+	entries = g_ptr_array_new ();
+	g_hash_table_iter_init (&ht_iter, priv->query_stats);
+	while (g_hash_table_iter_next (&ht_iter, &ht_key, &ht_value)) {
+		gpointer *entry = g_new0 (gpointer, 2);
+		entry[0] = ht_key;
+		entry[1] = ht_value;
+		g_ptr_array_add (entries, entry);
+	}
+	g_ptr_array_sort (entries, as_cache_query_stat_entry_cmp);
+
+	report = g_string_new (
+	    "Query                                                Calls  Results  Sections  Hits  "
+	    "Total ms  Mean µs  Max µs\n");
+
+	for (guint i = 0; i < entries->len; i++) {
+		gpointer *entry = g_ptr_array_index (entries, i);
+		const gchar *label = entry[0];
+		AsCacheQueryStat *qstat = entry[1];
+
+		g_string_append_printf (
+		    report,
+		    "%-50s %7u %8" G_GUINT64_FORMAT " %9" G_GUINT64_FORMAT " %5" G_GUINT64_FORMAT
+		    " %9.2f %8" G_GINT64_FORMAT " %7" G_GINT64_FORMAT "\n",
+		    label,
+		    qstat->n_queries,
+		    qstat->results_total,
+		    qstat->sections_queried,
+		    qstat->sections_with_hits,
+		    qstat->time_total_usec / 1000.0,
+		    qstat->time_total_usec / qstat->n_queries,
+		    qstat->time_max_usec);
+		g_free (entry);
+	}
+
+	return g_string_free (report, FALSE);
+}
+
+typedef struct {
+	GHashTable *results_map;
+	GHashTable *known_os_cids;
+} AsQueryContext;
+
+static AsQueryContext *
+as_query_context_new (void)
+{
+	AsQueryContext *ctx;
+	ctx = g_new0 (AsQueryContext, 1);
+	ctx->results_map = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+	ctx->known_os_cids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	return ctx;
+}
+
+static void
+as_query_context_free (AsQueryContext *ctx)
+{
+	g_hash_table_unref (ctx->results_map);
+	g_hash_table_unref (ctx->known_os_cids);
+	g_free (ctx);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (AsQueryContext, as_query_context_free)
+
+static gboolean
+as_query_context_add_component_from_node (AsQueryContext *ctx,
+					  AsCache *cache,
+					  AsCacheSection *csec,
+					  XbNode *cpt_node,
+					  AsTokenType match_value,
+					  GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(AsComponent) cpt = NULL;
+	const gchar *data_id;
+
+	if (csec->is_os_data && csec->format_style == AS_FORMAT_STYLE_METAINFO) {
+		const gchar *cid = xb_node_query_text (cpt_node, "id", NULL);
+		if (g_hash_table_contains (ctx->known_os_cids, cid) && !priv->prefer_os_metainfo)
+			return TRUE;
+	}
+
+	cpt = as_cache_component_from_node (cache, csec, cpt_node, error);
+	if (cpt == NULL)
+		return FALSE;
+	if (csec->format_style == AS_FORMAT_STYLE_METAINFO)
+		as_component_set_origin_kind (cpt, AS_ORIGIN_KIND_METAINFO);
+
+	/* don't display masked components */
+	if (!csec->is_mask && g_hash_table_contains (priv->masked, as_component_get_data_id (cpt)))
+		return TRUE;
+
+	/* add match score (in case we are full-text searching) */
+	if (match_value != 0)
+		as_component_set_sort_score (cpt, match_value);
+
+	/* register */
+	if (csec->is_os_data)
+		g_hash_table_add (ctx->known_os_cids, g_strdup (as_component_get_id (cpt)));
+
+	data_id = as_component_get_data_id (cpt);
+	g_hash_table_insert (ctx->results_map, g_strdup (data_id), g_steal_pointer (&cpt));
+
+	return TRUE;
+}
+
+static gboolean
+as_query_context_add_component_from_nodes (AsQueryContext *ctx,
+					   AsCache *cache,
+					   AsCacheSection *csec,
+					   GPtrArray *nodes,
+					   GError **error)
 {
-	if (g_strcmp0 (filename, "os-catalog") == 0 || g_strcmp0 (filename, "flatpak") == 0 ||
-	    g_strcmp0 (filename, "metainfo") == 0) {
-		g_set_error (error,
-			     AS_CACHE_ERROR,
-			     AS_CACHE_ERROR_BAD_VALUE,
-			     "Can not add extra repository data with reserved cache key name '%s'.",
-			     filename);
+	for (guint i = 0; i < nodes->len; i++) {
+		XbNode *qnode = XB_NODE (g_ptr_array_index (nodes, i));
+		if (!as_query_context_add_component_from_node (ctx, cache, csec, qnode, 0, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static AsComponentBox *
+as_query_context_retrieve_components (AsQueryContext *ctx)
+{
+	GHashTableIter ht_iter;
+	gpointer ht_value;
+	AsComponentBox *results = as_component_box_new_simple ();
+
+	g_hash_table_iter_init (&ht_iter, ctx->results_map);
+	while (g_hash_table_iter_next (&ht_iter, NULL, &ht_value))
+		as_component_box_add (results, ht_value, NULL);
+
+	as_cache_counter_add (as_cache_ctr_queries_served, 1);
+	return results;
+}
+
+/**
+ * as_cache_section_run_query_into_context:
+ *
+ * Run a compiled query on a single cache section and register all resulting
+ * components in the query context.
+ */
+static gboolean
+as_cache_section_run_query_into_context (AsCache *cache,
+					 AsCacheSection *csec,
+					 AsQueryContext *qctx,
+					 XbQuery *query,
+					 XbQueryContext *context,
+					 GError **error)
+{
+	g_autoptr(GPtrArray) array = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+
+	array = xb_silo_query_with_context (csec->silo, query, context, &tmp_error);
+	if (array == NULL) {
+		if (g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+			return TRUE;
+		if (g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
+			return TRUE;
+		g_propagate_prefixed_error (error,
+					    g_steal_pointer (&tmp_error),
+					    "Unable to run query: ");
 		return FALSE;
 	}
 
-	return as_cache_set_contents_internal (cache,
-					       as_utils_guess_scope_from_path (filename),
-					       AS_FORMAT_STYLE_CATALOG,
-					       FALSE, /* no OS data */
-					       cpts,
-					       filename,
-					       refinefn_user_data,
-					       error);
+	return as_query_context_add_component_from_nodes (qctx, cache, csec, array, error);
 }
 
 /**
- * as_cache_get_ctime_with_section_key:
- * @cache: An instance of #AsCache.
- * @scope: Component scope
- * @section_key: An internal cache section key.
- * @cache_scope: Returns which scope the cache that was most recent is in.
+ * as_cache_section_query_into_context:
  *
- * Returns: ctime of the cache section.
+ * Run an XPath query on a single cache section and register all resulting
+ * components in the query context.
  */
-static time_t
-as_cache_get_ctime_with_section_key (AsCache *cache,
-				     AsComponentScope scope,
-				     const gchar *section_key,
-				     AsCacheScope *cache_scope)
+static gboolean
+as_cache_section_query_into_context (AsCache *cache,
+				     AsCacheSection *csec,
+				     AsQueryContext *qctx,
+				     const gchar *xpath,
+				     XbQueryContext *context,
+				     GError **error)
 {
-	AsCachePrivate *priv = GET_PRIVATE (cache);
-	struct stat cache_sbuf;
-	g_autofree gchar *xb_fname_user = NULL;
-	g_autofree gchar *xb_fname_sys = NULL;
-	time_t t_sys, t_user;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(XbQuery) query = NULL;
 
-	xb_fname_user = as_cache_get_section_fname_for (cache,
-							AS_CACHE_SCOPE_WRITABLE,
-							scope,
-							section_key);
-	if (g_strcmp0 (priv->cache_root_dir, priv->system_cache_dir) != 0) {
-		xb_fname_sys = as_cache_get_section_fname_for (cache,
-							       AS_CACHE_SCOPE_SYSTEM,
-							       scope,
-							       section_key);
+	g_debug ("Querying `%s` in %s", xpath, csec->key);
+	query = as_cache_section_get_query (csec, xpath, &tmp_error);
+	if (query == NULL) {
+		g_propagate_prefixed_error (error,
+					    g_steal_pointer (&tmp_error),
+					    "Unable to construct query: ");
+		return FALSE;
 	}
 
-	if (cache_scope != NULL)
-		*cache_scope = AS_CACHE_SCOPE_WRITABLE;
+	return as_cache_section_run_query_into_context (cache, csec, qctx, query, context, error);
+}
 
-	t_user = 0;
-	t_sys = 0;
-	if (stat (xb_fname_user, &cache_sbuf) == 0)
-		t_user = cache_sbuf.st_ctime;
-	if (xb_fname_sys == NULL) {
-		return t_user;
-	} else {
-		if (stat (xb_fname_sys, &cache_sbuf) == 0)
-			t_sys = cache_sbuf.st_ctime;
-		if (t_sys > t_user) {
-			if (cache_scope != NULL)
-				*cache_scope = AS_CACHE_SCOPE_SYSTEM;
-			return t_sys;
-		}
-		return t_user;
+/**
+ * as_cache_section_query_shape_into_context:
+ *
+ * Run a typed, prepared query on a single cache section and register all
+ * resulting components in the query context.
+ */
+static gboolean
+as_cache_section_query_shape_into_context (AsCache *cache,
+					   AsCacheSection *csec,
+					   AsQueryContext *qctx,
+					   AsCacheQueryShape shape,
+					   XbQueryContext *context,
+					   GError **error)
+{
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(XbQuery) query = NULL;
+
+	query = as_cache_section_get_shape_query (csec, shape, &tmp_error);
+	if (query == NULL) {
+		g_propagate_prefixed_error (error,
+					    g_steal_pointer (&tmp_error),
+					    "Unable to construct query: ");
+		return FALSE;
 	}
+
+	return as_cache_section_run_query_into_context (cache, csec, qctx, query, context, error);
 }
 
 /**
- * as_cache_get_ctime:
- * @cache: An instance of #AsCache.
- * @scope: Component scope
- * @cache_key: A user-provided cache key.
- * @cache_scope: returns which scope the cache that was most recent is in.
+ * as_cache_query_components_internal:
+ */
+static AsComponentBox *
+as_cache_query_components (AsCache *cache,
+			   const gchar *xpath,
+			   XbQueryContext *context,
+			   guint limit,
+			   gboolean is_fts,
+			   GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(AsQueryContext) qctx = NULL;
+	gint64 start_time = 0;
+	guint sections_with_hits = 0;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	if (G_UNLIKELY (priv->query_stats_enabled))
+		start_time = g_get_monotonic_time ();
+
+	qctx = as_query_context_new ();
+	for (guint i = 0; i < priv->sections->len; i++) {
+		guint results_prev = g_hash_table_size (qctx->results_map);
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+
+		if (!as_cache_section_query_into_context (cache, csec, qctx, xpath, context, error))
+			return NULL;
+		if (g_hash_table_size (qctx->results_map) > results_prev)
+			sections_with_hits++;
+	}
+
+	if (G_UNLIKELY (priv->query_stats_enabled))
+		as_cache_record_query_stat (cache,
+					    xpath,
+					    g_get_monotonic_time () - start_time,
+					    g_hash_table_size (qctx->results_map),
+					    priv->sections->len,
+					    sections_with_hits);
+
+	return as_query_context_retrieve_components (qctx);
+}
+
+/**
+ * as_cache_query_components_shaped:
  *
- * Returns: ctime of the cache section.
+ * Like as_cache_query_components(), but for one of the fixed, typed query
+ * shapes, executing the per-section prepared queries directly.
  */
-time_t
-as_cache_get_ctime (AsCache *cache,
-		    AsComponentScope scope,
-		    const gchar *cache_key,
-		    AsCacheScope *cache_scope)
+static AsComponentBox *
+as_cache_query_components_shaped (AsCache *cache,
+				  AsCacheQueryShape shape,
+				  XbQueryContext *context,
+				  GError **error)
 {
-	g_autofree gchar *section_key = NULL;
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(AsQueryContext) qctx = NULL;
+	gint64 start_time = 0;
+	guint sections_with_hits = 0;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
 
-	if (scope == AS_COMPONENT_SCOPE_UNKNOWN) {
-		scope = AS_COMPONENT_SCOPE_SYSTEM;
-		if (g_str_has_prefix (cache_key, "/home") ||
-		    g_str_has_prefix (cache_key, g_get_home_dir ()))
-			scope = AS_COMPONENT_SCOPE_USER;
+	if (G_UNLIKELY (priv->query_stats_enabled))
+		start_time = g_get_monotonic_time ();
+
+	qctx = as_query_context_new ();
+	for (guint i = 0; i < priv->sections->len; i++) {
+		guint results_prev = g_hash_table_size (qctx->results_map);
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+
+		if (!as_cache_section_query_shape_into_context (cache,
+								csec,
+								qctx,
+								shape,
+								context,
+								error))
+			return NULL;
+		if (g_hash_table_size (qctx->results_map) > results_prev)
+			sections_with_hits++;
 	}
 
-	section_key = as_cache_build_section_key (cache, cache_key);
-	return as_cache_get_ctime_with_section_key (cache, scope, section_key, cache_scope);
+	if (G_UNLIKELY (priv->query_stats_enabled))
+		as_cache_record_query_stat (cache,
+					    as_cache_query_shape_xpaths[shape],
+					    g_get_monotonic_time () - start_time,
+					    g_hash_table_size (qctx->results_map),
+					    priv->sections->len,
+					    sections_with_hits);
+
+	return as_query_context_retrieve_components (qctx);
 }
 
 /**
- * as_cache_check_section_outdated:
+ * as_cache_is_empty:
+ * @cache: An instance of #AsCache.
  *
- * Returns: %TRUE if ctime of @origin_path is newer than the ctime on the cache section.
+ * Test if the cache is empty.
+ *
+ * Returns: %TRUE if the cache is empty, %FALSE otherwise.
  */
-static gboolean
-as_cache_check_section_outdated (AsCache *cache,
-				 AsComponentScope scope,
-				 const gchar *cache_key,
-				 const gchar *origin_path)
+gboolean
+as_cache_is_empty (AsCache *cache)
 {
-	struct stat sb;
-	time_t cache_ctime;
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
 
-	if (stat (origin_path, &sb) < 0)
-		return TRUE;
+	for (guint i = 0; i < priv->sections->len; i++) {
+		g_autoptr(XbNode) node = NULL;
+		g_autoptr(XbNode) child = NULL;
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
 
-	cache_ctime = as_cache_get_ctime (cache, scope, cache_key, NULL);
-	if (sb.st_ctime > cache_ctime)
-		return TRUE;
+		node = xb_silo_get_root (csec->silo);
+		child = xb_node_get_child (node);
+		if (child != NULL)
+			return FALSE;
+	}
 
-	return FALSE;
+	return TRUE;
 }
 
 /**
- * as_cache_load_section_internal:
+ * as_cache_get_component_count:
+ * @cache: An instance of #AsCache.
  *
- * Load cache section.
+ * Get the number of components present in this cache.
+ *
+ * Returns: The number of components present in the cache.
  */
-static void
-as_cache_load_section_internal (AsCache *cache,
-				AsComponentScope scope,
-				const gchar *cache_key,
-				AsFormatStyle source_format_style,
-				gboolean is_os_data,
-				gboolean *is_outdated,
-				gpointer refine_user_data)
+guint
+as_cache_get_component_count (AsCache *cache)
 {
 	AsCachePrivate *priv = GET_PRIVATE (cache);
-	AsCacheScope cache_scope;
-	g_autofree gchar *section_key = NULL;
-	g_autofree gchar *internal_section_key = NULL;
-	g_autofree gchar *xb_fname = NULL;
-	g_autoptr(AsCacheSection) csec = NULL;
-	g_autoptr(GFile) file = NULL;
-	g_autoptr(GError) tmp_error = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+	guint cpt_node_count = 0;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
 
-	section_key = as_cache_build_section_key (cache, cache_key);
-	internal_section_key = g_strconcat (as_component_scope_to_string (scope),
-					    ":",
-					    section_key,
-					    NULL);
+	for (guint i = 0; i < priv->sections->len; i++) {
+		g_autoptr(XbNode) n = NULL;
+		g_autoptr(XbNode) node = NULL;
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+
+		node = xb_silo_get_root (csec->silo);
+		n = xb_node_get_child (node);
+		while (n != NULL) {
+			cpt_node_count++;
+			g_object_unref (n);
+			n = xb_node_get_next (n);
+		}
+	}
+
+	return cpt_node_count;
+}
+
+/* default number of components a cursor materializes ahead of consumption */
+#define AS_CACHE_CURSOR_DEFAULT_PREFETCH 32
 
-	/* check which available cache is the most recent one */
-	as_cache_get_ctime_with_section_key (cache, scope, section_key, &cache_scope);
+/**
+ * AsCacheCursor:
+ *
+ * A streaming cursor over all components in the cache.
+ * Instead of materializing the complete result set up front, only a small,
+ * bounded batch of components is deserialized ahead of consumption, keeping
+ * memory usage flat even when walking very large caches.
+ */
+struct _AsCacheCursor {
+	AsCache *cache;
+	GPtrArray *sections;	  /* lightweight section views, keeping the silos alive */
+	GHashTable *seen_ids;	  /* data-IDs already yielded, for cross-section dedup */
+	GHashTable *known_os_cids;
+	guint prefetch_n;
 
-	xb_fname = as_cache_get_section_fname_for (cache, cache_scope, scope, section_key);
+	guint section_idx;
+	gboolean section_started;
+	gboolean section_had_hit;
+	XbNode *pos;		  /* next node to visit in the current section */
+	GQueue prefetched;	  /* of AsComponent, materialized ahead of consumption */
 
-	if (!g_file_test (xb_fname, G_FILE_TEST_EXISTS)) {
-		/* nothing to do if no cache file exists that we can load */
-		if (is_outdated != NULL)
-			*is_outdated = TRUE;
-		return;
-	}
+	/* query instrumentation */
+	gint64 start_time;
+	guint n_yielded;
+	guint sections_with_hits;
+	gboolean stats_recorded;
+};
 
-	csec = as_cache_section_new (internal_section_key);
-	csec->is_os_data = is_os_data && scope == AS_COMPONENT_SCOPE_SYSTEM;
-	csec->scope = scope;
-	csec->format_style = source_format_style;
-	csec->fname = g_strdup (xb_fname);
-	csec->refine_func_udata = refine_user_data;
+/**
+ * as_cache_open_cursor_all:
+ * @cache: An instance of #AsCache.
+ * @prefetch_count: Number of components to materialize ahead of consumption, or 0 for the default.
+ *
+ * Open a streaming cursor over all components in the cache.
+ * The cursor observes the cache contents and masks as they were when it was
+ * opened: it keeps references on the section silos, so the data stays valid
+ * even if the cache is cleared or reloaded while iterating.
+ *
+ * Returns: (transfer full): A new #AsCacheCursor.
+ */
+AsCacheCursor *
+as_cache_open_cursor_all (AsCache *cache, guint prefetch_count)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	AsCacheCursor *cursor;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
 
-	csec->silo = xb_silo_new ();
-	file = g_file_new_for_path (csec->fname);
-	if (!xb_silo_load_from_file (csec->silo, file, XB_SILO_LOAD_FLAG_NONE, NULL, &tmp_error)) {
-		g_debug ("Failed to load AppStream cache section '%s' - marking cache as outdated. "
-			 "Issue: %s",
-			 internal_section_key,
-			 tmp_error->message);
-		if (is_outdated != NULL)
-			*is_outdated = TRUE;
-		return;
-	}
+	cursor = g_new0 (AsCacheCursor, 1);
+	cursor->cache = g_object_ref (cache);
+	cursor->prefetch_n = prefetch_count == 0 ? AS_CACHE_CURSOR_DEFAULT_PREFETCH
+						 : prefetch_count;
+	cursor->sections = g_ptr_array_new_with_free_func ((GDestroyNotify) as_cache_section_free);
+	cursor->seen_ids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	cursor->known_os_cids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	g_queue_init (&cursor->prefetched);
 
-	/* register the new section, replacing any old data */
+	if (G_UNLIKELY (priv->query_stats_enabled))
+		cursor->start_time = g_get_monotonic_time ();
+
+	/* snapshot the current cache sections - only the bits needed to
+	 * materialize components are copied, everything else stays unset */
 	for (guint i = 0; i < priv->sections->len; i++) {
-		AsCacheSection *csec_entry = g_ptr_array_index (priv->sections, i);
-		if (g_strcmp0 (csec_entry->key, internal_section_key) == 0) {
-			g_ptr_array_remove_index_fast (priv->sections, i);
-			break;
-		}
+		AsCacheSection *csec = g_ptr_array_index (priv->sections, i);
+		AsCacheSection *view = as_cache_section_new (csec->key);
+
+		view->silo = g_object_ref (csec->silo);
+		view->scope = csec->scope;
+		view->format_style = csec->format_style;
+		view->is_os_data = csec->is_os_data;
+		view->is_mask = csec->is_mask;
+		view->refine_func_udata = csec->refine_func_udata;
+		g_ptr_array_add (cursor->sections, view);
 	}
-	g_ptr_array_add (priv->sections, g_steal_pointer (&csec));
-	g_debug ("Using cache file: %s", xb_fname);
 
-	/* fix up section ordering */
-	g_ptr_array_sort (priv->sections, as_cache_section_cmp);
+	as_cache_counter_add (as_cache_ctr_queries_served, 1);
+	return cursor;
 }
 
 /**
- * as_cache_load_section_for_key:
- * @cache: an #AsCache instance.
+ * as_cache_cursor_refill:
  *
- * Load cache section that was created using a custom, special key.
+ * Materialize the next batch of components into the cursor's prefetch queue.
+ * Applies the same masking, deduplication and OS-data selection rules as
+ * as_query_context_add_component_from_node() does for array-based queries.
+ *
+ * Returns: %FALSE on error.
  */
-void
-as_cache_load_section_for_key (AsCache *cache,
-			       AsComponentScope scope,
-			       AsFormatStyle source_format_style,
-			       gboolean is_os_data,
-			       const gchar *cache_key,
-			       gboolean *is_outdated,
-			       gpointer refinefn_user_data)
+static gboolean
+as_cache_cursor_refill (AsCacheCursor *cursor, GError **error)
 {
-	as_cache_load_section_internal (cache,
-					scope,
-					cache_key,
-					source_format_style,
-					is_os_data,
-					is_outdated,
-					refinefn_user_data);
+	AsCachePrivate *priv = GET_PRIVATE (cursor->cache);
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	while (g_queue_get_length (&cursor->prefetched) < cursor->prefetch_n) {
+		AsCacheSection *csec;
+		g_autoptr(XbNode) node = NULL;
+		g_autoptr(AsComponent) cpt = NULL;
+
+		/* find the next node, stepping over exhausted sections */
+		while (cursor->pos == NULL) {
+			g_autoptr(XbNode) root = NULL;
+
+			if (cursor->section_started) {
+				if (cursor->section_had_hit)
+					cursor->sections_with_hits++;
+				cursor->section_idx++;
+				cursor->section_started = FALSE;
+				cursor->section_had_hit = FALSE;
+				continue;
+			}
+			if (cursor->section_idx >= cursor->sections->len) {
+				/* the end was reached, record statistics once if requested */
+				if (G_UNLIKELY (priv->query_stats_enabled) &&
+				    !cursor->stats_recorded) {
+					as_cache_record_query_stat (
+					    cursor->cache,
+					    "components/component (streamed)",
+					    g_get_monotonic_time () - cursor->start_time,
+					    cursor->n_yielded,
+					    cursor->sections->len,
+					    cursor->sections_with_hits);
+					cursor->stats_recorded = TRUE;
+				}
+				return TRUE;
+			}
+
+			csec = g_ptr_array_index (cursor->sections, cursor->section_idx);
+			root = xb_silo_get_root (csec->silo);
+			if (root != NULL)
+				cursor->pos = xb_node_get_child (root);
+			cursor->section_started = TRUE;
+		}
+
+		node = g_steal_pointer (&cursor->pos);
+		cursor->pos = xb_node_get_next (node);
+		csec = g_ptr_array_index (cursor->sections, cursor->section_idx);
+
+		/* skip cache-internal helper elements */
+		if (g_str_has_prefix (xb_node_get_element (node), "_asi_"))
+			continue;
+
+		if (csec->is_os_data && csec->format_style == AS_FORMAT_STYLE_METAINFO) {
+			const gchar *cid = xb_node_query_text (node, "id", NULL);
+			if (g_hash_table_contains (cursor->known_os_cids, cid) &&
+			    !priv->prefer_os_metainfo)
+				continue;
+		}
+
+		cpt = as_cache_component_from_node (cursor->cache, csec, node, error);
+		if (cpt == NULL)
+			return FALSE;
+		if (csec->format_style == AS_FORMAT_STYLE_METAINFO)
+			as_component_set_origin_kind (cpt, AS_ORIGIN_KIND_METAINFO);
+
+		/* don't yield masked components */
+		if (!csec->is_mask &&
+		    g_hash_table_contains (priv->masked, as_component_get_data_id (cpt)))
+			continue;
+
+		if (csec->is_os_data)
+			g_hash_table_add (cursor->known_os_cids,
+					  g_strdup (as_component_get_id (cpt)));
+
+		/* each data-ID is only ever yielded once */
+		if (!g_hash_table_add (cursor->seen_ids,
+				       g_strdup (as_component_get_data_id (cpt))))
+			continue;
+
+		cursor->section_had_hit = TRUE;
+		cursor->n_yielded++;
+		g_queue_push_tail (&cursor->prefetched, g_steal_pointer (&cpt));
+	}
+
+	return TRUE;
 }
 
 /**
- * as_cache_load_section_for_path:
- * @cache: an #AsCache instance.
+ * as_cache_cursor_next:
+ * @cursor: An #AsCacheCursor.
+ * @error: A #GError or %NULL.
  *
- * Try to load possibly cached data for a generic, custom path.
+ * Yield the next component from the cursor, materializing a new batch of
+ * components if the prefetch queue has run dry.
+ *
+ * Returns: (transfer full) (nullable): The next component, or %NULL if the
+ * end was reached or an error occurred.
  */
-void
-as_cache_load_section_for_path (AsCache *cache,
-				const gchar *filename,
-				gboolean *is_outdated,
-				gpointer refinefn_user_data)
+AsComponent *
+as_cache_cursor_next (AsCacheCursor *cursor, GError **error)
 {
-	AsComponentScope scope;
-
-	scope = as_utils_guess_scope_from_path (filename);
-	if (is_outdated != NULL)
-		*is_outdated = as_cache_check_section_outdated (cache, scope, filename, filename);
-
-	as_cache_load_section_internal (cache,
-					scope,
-					filename,
-					AS_FORMAT_STYLE_CATALOG,
-					FALSE,
-					is_outdated,
-					refinefn_user_data);
+	if (g_queue_is_empty (&cursor->prefetched)) {
+		if (!as_cache_cursor_refill (cursor, error))
+			return NULL;
+	}
+	return g_queue_pop_head (&cursor->prefetched);
 }
 
 /**
- * as_cache_mask_by_data_id:
- * @cache: an #AsCache instance.
- * @cdid: Data-ID of an #AsComponent
+ * as_cache_cursor_free:
+ * @cursor: An #AsCacheCursor.
  *
- * Mark a component as "deleted" from the cache.
- * The component will no longer show up in search results or be returned
- * by other queries.
+ * Close the cursor and release all references it holds.
  */
 void
-as_cache_mask_by_data_id (AsCache *cache, const gchar *cdid)
+as_cache_cursor_free (AsCacheCursor *cursor)
 {
-	AsCachePrivate *priv = GET_PRIVATE (cache);
-	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
-	g_hash_table_insert (priv->masked, g_strdup (cdid), GINT_TO_POINTER (TRUE));
+	if (cursor == NULL)
+		return;
+	g_queue_clear_full (&cursor->prefetched, g_object_unref);
+	if (cursor->pos != NULL)
+		g_object_unref (cursor->pos);
+	g_ptr_array_unref (cursor->sections);
+	g_hash_table_unref (cursor->seen_ids);
+	g_hash_table_unref (cursor->known_os_cids);
+	g_object_unref (cursor->cache);
+	g_free (cursor);
 }
 
 /**
- * as_cache_add_masking_component:
- * @cache: an #AsCache instance.
- * @cpts: An array of #AsComponent to add as override
+ * as_cache_get_components_all:
+ * @cache: An instance of #AsCache.
+ * @error: A #GError or %NULL.
  *
- * Add a masking component to the cache that is returned in place of
- * existing components in the cache.
+ * Retrieve all components this cache contains.
+ *
+ * Returns: (transfer full): An #AsComponentBox
  */
-gboolean
-as_cache_add_masking_components (AsCache *cache, GPtrArray *cpts, GError **error)
+AsComponentBox *
+as_cache_get_components_all (AsCache *cache, GError **error)
 {
-	AsCachePrivate *priv = GET_PRIVATE (cache);
-	g_autoptr(AsCacheSection) old_mcsec = NULL;
-	g_autoptr(AsCacheSection) mcsec = NULL;
-	g_autoptr(GPtrArray) cpts_final = NULL;
-	g_autoptr(GFile) file = NULL;
+	g_autoptr(AsCacheCursor) cursor = NULL;
+	g_autoptr(AsComponentBox) results = as_component_box_new_simple ();
 	g_autoptr(GError) tmp_error = NULL;
-	g_autofree gchar *volatile_fname = NULL;
-	gint fd;
-	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
 
-	/* find old masking section */
-	for (guint i = 0; i < priv->sections->len; i++) {
-		AsCacheSection *csec_entry = g_ptr_array_index (priv->sections, i);
-		if (csec_entry->is_mask) {
-			old_mcsec = g_ptr_array_steal_index_fast (priv->sections, i);
+	/* stream the components in batches instead of materializing
+	 * the whole result set behind one long lock hold */
+	cursor = as_cache_open_cursor_all (cache, 0);
+	while (TRUE) {
+		g_autoptr(AsComponent) cpt = as_cache_cursor_next (cursor, &tmp_error);
+		if (cpt == NULL) {
+			if (tmp_error != NULL) {
+				g_propagate_error (error, g_steal_pointer (&tmp_error));
+				return NULL;
+			}
 			break;
 		}
+		as_component_box_add (results, cpt, NULL);
 	}
 
-	cpts_final = g_ptr_array_new_with_free_func (g_object_unref);
-	if (old_mcsec != NULL) {
-		g_autoptr(GPtrArray) array = NULL;
-
-		/* retrieve the old data */
-		array = xb_silo_query (old_mcsec->silo, "components/component", 0, NULL);
-		if (array != NULL) {
-			for (guint j = 0; j < array->len; j++) {
-				g_autoptr (AsComponent) cpt = NULL;
-				gpointer iptr;
-				XbNode *node = g_ptr_array_index (array, j);
+	return g_steal_pointer (&results);
+}
 
-				cpt = as_cache_component_from_node (cache, old_mcsec, node, NULL);
-				if (cpt == NULL)
-					continue;
+/**
+ * as_cache_export_node_raw_xml:
+ *
+ * Serialize a cached component node back into XML markup straight from
+ * the silo, without constructing an intermediate DOM or #AsComponent,
+ * dropping the cache-internal helper elements in the process.
+ */
+static gboolean
+as_cache_export_node_raw_xml (XbNode *node, GString *out, GError **error)
+{
+	XbNodeAttrIter attr_iter;
+	const gchar *attr_name;
+	const gchar *attr_value;
+	XbNodeChildIter child_iter;
+	XbNode *child = NULL;
 
-				/* just delete masked components */
-				iptr = g_hash_table_lookup (priv->masked,
-							    as_component_get_data_id (cpt));
-				if (iptr != NULL && GPOINTER_TO_INT (iptr) == TRUE)
-					continue;
+	g_string_append_printf (out, "<%s", xb_node_get_element (node));
+	xb_node_attr_iter_init (&attr_iter, node);
+	while (xb_node_attr_iter_next (&attr_iter, &attr_name, &attr_value)) {
+		g_autofree gchar *value_esc = NULL;
 
-				g_ptr_array_add (cpts_final, g_steal_pointer (&cpt));
-				g_hash_table_insert (priv->masked,
-						     g_strdup (as_component_get_data_id (cpt)),
-						     GINT_TO_POINTER (FALSE));
-			}
-		}
+		/* skip cache-internal attributes as well */
+		if (g_str_has_prefix (attr_name, "_asi_"))
+			continue;
 
-		/* drop the old data */
-		as_cache_remove_section_file (cache, old_mcsec);
+		value_esc = g_markup_escape_text (attr_value, -1);
+		g_string_append_printf (out, " %s=\"%s\"", attr_name, value_esc);
 	}
+	g_string_append (out, ">\n");
 
-	/* generate filename for the volatile section in memory */
-	volatile_fname = g_build_filename (g_get_user_runtime_dir (),
-					   "appstream-extra-XXXXXX.mdb",
-					   NULL);
-	fd = g_mkstemp (volatile_fname);
-	if (fd > 0)
-		close (fd);
+	xb_node_child_iter_init (&child_iter, node);
+	while (xb_node_child_iter_loop (&child_iter, &child)) {
+		g_autofree gchar *frag = NULL;
 
-	/* create new section */
-	mcsec = as_cache_section_new ("memory:volatile_mask");
-	mcsec->scope = AS_COMPONENT_SCOPE_USER;
-	mcsec->format_style = AS_FORMAT_STYLE_CATALOG;
-	mcsec->fname = g_steal_pointer (&volatile_fname);
-	mcsec->is_mask = TRUE;
+		/* skip cache-internal elements, they are not part of the component data */
+		if (g_str_has_prefix (xb_node_get_element (child), "_asi_"))
+			continue;
 
-	/* create final component set */
-	for (guint i = 0; i < cpts->len; i++) {
-		AsComponent *cpt = g_ptr_array_index (cpts, i);
-		g_ptr_array_add (cpts_final, g_object_ref (cpt));
-		g_hash_table_insert (priv->masked,
-				     g_strdup (as_component_get_data_id (cpt)),
-				     GINT_TO_POINTER (FALSE));
+		frag = xb_node_export (child,
+				       XB_NODE_EXPORT_FLAG_FORMAT_MULTILINE |
+					   XB_NODE_EXPORT_FLAG_FORMAT_INDENT,
+				       error);
+		if (frag == NULL) {
+			g_clear_pointer (&child, g_object_unref);
+			return FALSE;
+		}
+		g_string_append (out, frag);
 	}
+	g_string_append_printf (out, "</%s>", xb_node_get_element (node));
 
-	mcsec->silo = as_cache_components_to_internal_xb (cache,
-							  cpts_final,
-							  FALSE, /* do not refine */
-							  NULL,
-							  &tmp_error);
-	if (mcsec->silo == NULL) {
-		g_propagate_prefixed_error (
-		    error,
-		    g_steal_pointer (&tmp_error),
-		    "Unable to add masking components to cache: Silo build failed. ");
-		return FALSE;
-	}
+	return TRUE;
+}
 
-	/* write data */
-	file = g_file_new_for_path (mcsec->fname);
-	if (!xb_silo_save_to_file (mcsec->silo, file, NULL, &tmp_error)) {
-		g_propagate_prefixed_error (
-		    error,
-		    g_steal_pointer (&tmp_error),
-		    "Unable to add masking components to cache: Failed to store silo. ");
-		return FALSE;
+/**
+ * as_cache_get_components_xml_by_id:
+ * @cache: An instance of #AsCache.
+ * @id: The component ID to search for, or %NULL to export all components.
+ * @error: A #GError or %NULL.
+ *
+ * Export the raw catalog XML fragments of all matching components directly
+ * from the cache, without deserializing them into #AsComponent objects and
+ * re-serializing them again. This is considerably faster than a full
+ * metadata round trip and intended for bulk exports of cached data, where
+ * throughput matters more than refinement.
+ *
+ * The fragments reflect the cached catalog data as-is: in-memory masks and
+ * overrides are not applied, and no refinement is performed.
+ *
+ * Returns: (transfer full) (element-type utf8): The XML fragments, or %NULL on error.
+ */
+GPtrArray *
+as_cache_get_components_xml_by_id (AsCache *cache, const gchar *id, GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	gchar id_buf[256];
+	g_autofree gchar *id_heap = NULL;
+	const gchar *id_lower = NULL;
+	g_autoptr(GPtrArray) results = NULL;
+	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	results = g_ptr_array_new_with_free_func (g_free);
+
+	if (id != NULL) {
+		id_lower = as_utils_strdown_buf (id, id_buf, sizeof (id_buf), &id_heap);
+		xb_value_bindings_bind_str (xb_query_context_get_bindings (&context),
+					    0,
+					    id_lower,
+					    NULL);
 	}
 
-	/* register the new section */
-	g_ptr_array_add (priv->sections, g_steal_pointer (&mcsec));
+	for (guint i = 0; i < priv->sections->len; i++) {
+		g_autoptr(GPtrArray) array = NULL;
+		g_autoptr(XbQuery) query = NULL;
+		g_autoptr(GError) tmp_error = NULL;
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+
+		/* the volatile mask section holds no catalog data */
+		if (csec->is_mask)
+			continue;
+
+		if (id_lower != NULL && !as_cache_section_possibly_has_id (csec, id_lower))
+			continue;
+
+		query = as_cache_section_get_shape_query (csec,
+							  id == NULL
+							      ? AS_CACHE_QUERY_SHAPE_ALL
+							      : AS_CACHE_QUERY_SHAPE_BY_ID,
+							  &tmp_error);
+		if (query == NULL) {
+			g_propagate_prefixed_error (error,
+						    g_steal_pointer (&tmp_error),
+						    "Unable to construct query: ");
+			return NULL;
+		}
+
+		array = xb_silo_query_with_context (csec->silo,
+						    query,
+						    id == NULL ? NULL : &context,
+						    &tmp_error);
+		if (array == NULL) {
+			if (g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
+			    g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
+				continue;
+			g_propagate_prefixed_error (error,
+						    g_steal_pointer (&tmp_error),
+						    "Unable to run query: ");
+			return NULL;
+		}
 
-	/* fix up section ordering */
-	g_ptr_array_sort (priv->sections, as_cache_section_cmp);
+		for (guint j = 0; j < array->len; j++) {
+			XbNode *node = g_ptr_array_index (array, j);
+			GString *xml = g_string_new (NULL);
 
-	return TRUE;
+			if (!as_cache_export_node_raw_xml (node, xml, error)) {
+				g_string_free (xml, TRUE);
+				return NULL;
+			}
+			g_ptr_array_add (results, g_string_free (xml, FALSE));
+		}
+	}
+
+	return g_steal_pointer (&results);
 }
 
 /**
- * as_cache_set_refine_func:
+ * as_cache_get_components_for_key:
  * @cache: An instance of #AsCache.
+ * @cache_key: Key of the cache section to read.
+ * @error: A #GError or %NULL.
  *
- * Set function to be called on a component after it was deserialized.
+ * Retrieve all components of the cache sections registered for
+ * the given cache key, ignoring any data from other sections.
+ *
+ * Returns: (transfer full): An #AsComponentBox, or %NULL if no matching section was found.
  */
-void
-as_cache_set_refine_func (AsCache *cache, AsCacheDataRefineFn func)
+AsComponentBox *
+as_cache_get_components_for_key (AsCache *cache, const gchar *cache_key, GError **error)
 {
 	AsCachePrivate *priv = GET_PRIVATE (cache);
-	priv->cpt_refine_func = func;
-}
+	g_autoptr(AsQueryContext) qctx = NULL;
+	gboolean section_found = FALSE;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
 
-typedef struct {
-	GHashTable *results_map;
-	GHashTable *known_os_cids;
-} AsQueryContext;
+	qctx = as_query_context_new ();
+	for (guint i = 0; i < priv->sections->len; i++) {
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
 
-static AsQueryContext *
-as_query_context_new (void)
-{
-	AsQueryContext *ctx;
-	ctx = g_new0 (AsQueryContext, 1);
-	ctx->results_map = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
-	ctx->known_os_cids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
-	return ctx;
-}
+		if (g_strcmp0 (csec->key, cache_key) != 0)
+			continue;
+		section_found = TRUE;
+		if (!as_cache_section_query_into_context (cache,
+							  csec,
+							  qctx,
+							  "components/component",
+							  NULL,
+							  error))
+			return NULL;
+	}
 
-static void
-as_query_context_free (AsQueryContext *ctx)
-{
-	g_hash_table_unref (ctx->results_map);
-	g_hash_table_unref (ctx->known_os_cids);
-	g_free (ctx);
-}
+	if (!section_found) {
+		g_set_error (error,
+			     AS_CACHE_ERROR,
+			     AS_CACHE_ERROR_FAILED,
+			     "No cache section is registered for key '%s'.",
+			     cache_key);
+		return NULL;
+	}
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC (AsQueryContext, as_query_context_free)
+	return as_query_context_retrieve_components (qctx);
+}
 
-static gboolean
-as_query_context_add_component_from_node (AsQueryContext *ctx,
-					  AsCache *cache,
-					  AsCacheSection *csec,
-					  XbNode *cpt_node,
-					  AsTokenType match_value,
-					  GError **error)
+/**
+ * as_cache_get_components_by_id:
+ * @cache: An instance of #AsCache.
+ * @id: The component ID to search for.
+ * @error: A #GError or %NULL.
+ *
+ * Retrieve components with the selected ID.
+ *
+ * Repeated lookups of the same ID are served from an in-memory cache of
+ * materialized components and return the same shared (but fully loaded)
+ * #AsComponent instances, as long as the cache contents did not change
+ * in between.
+ *
+ * Returns: (transfer full): An #AsComponentBox
+ */
+AsComponentBox *
+as_cache_get_components_by_id (AsCache *cache, const gchar *id, GError **error)
 {
 	AsCachePrivate *priv = GET_PRIVATE (cache);
-	g_autoptr(AsComponent) cpt = NULL;
-	const gchar *data_id;
-
-	if (csec->is_os_data && csec->format_style == AS_FORMAT_STYLE_METAINFO) {
-		const gchar *cid = xb_node_query_text (cpt_node, "id", NULL);
-		if (g_hash_table_contains (ctx->known_os_cids, cid) && !priv->prefer_os_metainfo)
-			return TRUE;
-	}
+	AsComponentBox *results = NULL;
+	gchar id_buf[256];
+	g_autofree gchar *id_heap = NULL;
+	const gchar *id_lower = NULL;
+	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
 
-	cpt = as_cache_component_from_node (cache, csec, cpt_node, error);
-	if (cpt == NULL)
-		return FALSE;
-	if (csec->format_style == AS_FORMAT_STYLE_METAINFO)
-		as_component_set_origin_kind (cpt, AS_ORIGIN_KIND_METAINFO);
+	id_lower = as_utils_strdown_buf (id, id_buf, sizeof (id_buf), &id_heap);
 
-	/* don't display masked components */
-	if (!csec->is_mask && g_hash_table_contains (priv->masked, as_component_get_data_id (cpt)))
-		return TRUE;
+	/* frequently requested components may already be materialized */
+	results = as_cache_hot_cpts_lookup (cache, id_lower);
+	if (results != NULL)
+		return results;
 
-	/* add match score (in case we are full-text searching) */
-	if (match_value != 0)
-		as_component_set_sort_score (cpt, match_value);
+	/* consult the per-section ID bloom filters first, so the frequent probes
+	 * for IDs that do not exist anywhere return without touching any silo */
+	{
+		g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (
+		    &priv->rw_lock);
+		gboolean maybe_found = FALSE;
+
+		for (guint i = 0; i < priv->sections->len; i++) {
+			AsCacheSection *csec = (AsCacheSection *)
+			    g_ptr_array_index (priv->sections, i);
+			if (as_cache_section_possibly_has_id (csec, id_lower)) {
+				maybe_found = TRUE;
+				break;
+			}
+		}
 
-	/* register */
-	if (csec->is_os_data)
-		g_hash_table_add (ctx->known_os_cids, g_strdup (as_component_get_id (cpt)));
+		if (!maybe_found) {
+			if (G_UNLIKELY (priv->query_stats_enabled))
+				as_cache_record_query_stat (
+				    cache,
+				    "components/component/id[lower-case(text())=?]/..",
+				    0,
+				    0, /* no results */
+				    0, /* no sections were actually queried */
+				    0);
+			return as_component_box_new_simple ();
+		}
+	}
 
-	data_id = as_component_get_data_id (cpt);
-	g_hash_table_insert (ctx->results_map, g_strdup (data_id), g_steal_pointer (&cpt));
+	xb_value_bindings_bind_str (xb_query_context_get_bindings (&context), 0, id_lower, NULL);
+	results = as_cache_query_components_shaped (cache,
+						    AS_CACHE_QUERY_SHAPE_BY_ID,
+						    &context,
+						    error);
 
-	return TRUE;
-}
+	/* don't continue if we have an error */
+	if (results == NULL)
+		return results;
 
-static gboolean
-as_query_context_add_component_from_nodes (AsQueryContext *ctx,
-					   AsCache *cache,
-					   AsCacheSection *csec,
-					   GPtrArray *nodes,
-					   GError **error)
-{
-	for (guint i = 0; i < nodes->len; i++) {
-		XbNode *qnode = XB_NODE (g_ptr_array_index (nodes, i));
-		if (!as_query_context_add_component_from_node (ctx, cache, csec, qnode, 0, error))
-			return FALSE;
+	if (as_component_box_is_empty (results)) {
+		/* we found no exact matches, try components providing this ID */
+		g_object_unref (results);
+		results = as_cache_query_components_shaped (cache,
+							    AS_CACHE_QUERY_SHAPE_BY_PROVIDED_ID,
+							    &context,
+							    error);
+		if (results == NULL)
+			return results;
 	}
-	return TRUE;
-}
-
-static AsComponentBox *
-as_query_context_retrieve_components (AsQueryContext *ctx)
-{
-	GHashTableIter ht_iter;
-	gpointer ht_value;
-	AsComponentBox *results = as_component_box_new_simple ();
 
-	g_hash_table_iter_init (&ht_iter, ctx->results_map);
-	while (g_hash_table_iter_next (&ht_iter, NULL, &ht_value))
-		as_component_box_add (results, ht_value, NULL);
+	/* memoize the result, so repeat lookups of hot components can skip the
+	 * node traversal entirely - the components are loaded completely first,
+	 * as shared instances must not materialize lazy data concurrently */
+	for (guint i = 0; i < as_component_box_len (results); i++)
+		as_component_lazy_materialize (as_component_box_index (results, i));
+	as_cache_hot_cpts_insert (cache, id_lower, results);
 
 	return results;
 }
 
 /**
- * as_cache_query_components_internal:
+ * as_cache_get_components_by_ids:
+ * @cache: An instance of #AsCache.
+ * @ids: (array zero-terminated=1): The component IDs to search for.
+ * @error: A #GError or %NULL.
+ *
+ * Retrieve components matching any of the selected IDs.
+ * This iterates the cache sections only once for the whole batch and reuses
+ * the compiled query for all IDs, which is much cheaper than running
+ * individual lookups when many components need to be resolved at once.
+ *
+ * Returns: (transfer full): An #AsComponentBox
  */
-static AsComponentBox *
-as_cache_query_components (AsCache *cache,
-			   const gchar *xpath,
-			   XbQueryContext *context,
-			   guint limit,
-			   gboolean is_fts,
-			   GError **error)
+AsComponentBox *
+as_cache_get_components_by_ids (AsCache *cache, const gchar *const *ids, GError **error)
 {
 	AsCachePrivate *priv = GET_PRIVATE (cache);
 	g_autoptr(AsQueryContext) qctx = NULL;
@@ -1509,13 +4558,13 @@ as_cache_query_components (AsCache *cache,
 
 	qctx = as_query_context_new ();
 	for (guint i = 0; i < priv->sections->len; i++) {
-		g_autoptr(GPtrArray) array = NULL;
 		g_autoptr(GError) tmp_error = NULL;
 		g_autoptr(XbQuery) query = NULL;
 		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
 
-		g_debug ("Querying `%s` in %s", xpath, csec->key);
-		query = xb_query_new (csec->silo, xpath, &tmp_error);
+		query = as_cache_section_get_shape_query (csec,
+							  AS_CACHE_QUERY_SHAPE_BY_ID,
+							  &tmp_error);
 		if (query == NULL) {
 			g_propagate_prefixed_error (error,
 						    g_steal_pointer (&tmp_error),
@@ -1523,166 +4572,331 @@ as_cache_query_components (AsCache *cache,
 			return NULL;
 		}
 
-		array = xb_silo_query_with_context (csec->silo, query, context, &tmp_error);
-		if (array == NULL) {
-			if (g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-				continue;
-			if (g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
+		for (guint j = 0; ids[j] != NULL; j++) {
+			g_autoptr(GPtrArray) array = NULL;
+			gchar id_buf[256];
+			g_autofree gchar *id_heap = NULL;
+			const gchar *id_lower = NULL;
+			g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
+
+			id_lower = as_utils_strdown_buf (ids[j], id_buf, sizeof (id_buf), &id_heap);
+
+			/* don't run the query for IDs which can not be in this section */
+			if (!as_cache_section_possibly_has_id (csec, id_lower))
 				continue;
-			g_propagate_prefixed_error (error,
-						    g_steal_pointer (&tmp_error),
-						    "Unable to run query: ");
-			return NULL;
-		}
 
-		if (!as_query_context_add_component_from_nodes (qctx, cache, csec, array, error))
-			return NULL;
+			xb_value_bindings_bind_str (xb_query_context_get_bindings (&context),
+						    0,
+						    id_lower,
+						    NULL);
+
+			array = xb_silo_query_with_context (csec->silo,
+							    query,
+							    &context,
+							    &tmp_error);
+			if (array == NULL) {
+				if (g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
+				    g_error_matches (tmp_error,
+						     G_IO_ERROR,
+						     G_IO_ERROR_INVALID_ARGUMENT)) {
+					g_clear_error (&tmp_error);
+					continue;
+				}
+				g_propagate_prefixed_error (error,
+							    g_steal_pointer (&tmp_error),
+							    "Unable to run query: ");
+				return NULL;
+			}
+
+			if (!as_query_context_add_component_from_nodes (qctx,
+									cache,
+									csec,
+									array,
+									error))
+				return NULL;
+		}
 	}
 
 	return as_query_context_retrieve_components (qctx);
 }
 
 /**
- * as_cache_is_empty:
- * @cache: An instance of #AsCache.
+ * as_cache_rev_index_add:
  *
- * Test if the cache is empty.
+ * Register a component node in an inverted cross-reference index
+ * under the given key.
+ */
+static void
+as_cache_rev_index_add (GHashTable *index, const gchar *key, XbNode *cpt_node)
+{
+	GPtrArray *nodes;
+
+	nodes = g_hash_table_lookup (index, key);
+	if (nodes == NULL) {
+		nodes = g_ptr_array_new_with_free_func (g_object_unref);
+		g_hash_table_insert (index, g_strdup (key), nodes);
+	}
+	g_ptr_array_add (nodes, g_object_ref (cpt_node));
+}
+
+/**
+ * as_cache_section_ensure_rev_indexes:
  *
- * Returns: %TRUE if the cache is empty, %FALSE otherwise.
+ * Build the inverted extends/suggests cross-reference indexes of a cache
+ * section on first use. The silo is scanned exactly once per section, so
+ * all subsequent addon or suggestion lookups are single hash probes
+ * instead of silo queries.
  */
-gboolean
-as_cache_is_empty (AsCache *cache)
+static gboolean
+as_cache_section_ensure_rev_indexes (AsCacheSection *csec, GError **error)
 {
-	AsCachePrivate *priv = GET_PRIVATE (cache);
-	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+	g_autoptr(GPtrArray) extends_nodes = NULL;
+	g_autoptr(GPtrArray) suggested_nodes = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&csec->query_cache_mutex);
 
-	for (guint i = 0; i < priv->sections->len; i++) {
-		g_autoptr(XbNode) node = NULL;
-		g_autoptr(XbNode) child = NULL;
-		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+	if (csec->rev_indexes_built)
+		return TRUE;
 
-		node = xb_silo_get_root (csec->silo);
-		child = xb_node_get_child (node);
-		if (child != NULL)
+	extends_nodes = xb_silo_query (csec->silo, "components/component/extends", 0, &tmp_error);
+	if (extends_nodes == NULL) {
+		if (!g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
+		    !g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
+			g_propagate_prefixed_error (error,
+						    g_steal_pointer (&tmp_error),
+						    "Unable to build extends index: ");
 			return FALSE;
+		}
+		g_clear_error (&tmp_error);
+	}
+
+	suggested_nodes = xb_silo_query (csec->silo,
+					 "components/component/suggests/id",
+					 0,
+					 &tmp_error);
+	if (suggested_nodes == NULL) {
+		if (!g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
+		    !g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
+			g_propagate_prefixed_error (error,
+						    g_steal_pointer (&tmp_error),
+						    "Unable to build suggests index: ");
+			return FALSE;
+		}
+		g_clear_error (&tmp_error);
+	}
+
+	csec->extends_index = g_hash_table_new_full (g_str_hash,
+						     g_str_equal,
+						     g_free,
+						     (GDestroyNotify) g_ptr_array_unref);
+	csec->suggests_index = g_hash_table_new_full (g_str_hash,
+						      g_str_equal,
+						      g_free,
+						      (GDestroyNotify) g_ptr_array_unref);
+
+	if (extends_nodes != NULL) {
+		for (guint i = 0; i < extends_nodes->len; i++) {
+			XbNode *node = g_ptr_array_index (extends_nodes, i);
+			g_autoptr(XbNode) cpt_node = xb_node_get_parent (node);
+			const gchar *extended_id = xb_node_get_text (node);
+
+			if (extended_id == NULL || cpt_node == NULL)
+				continue;
+			as_cache_rev_index_add (csec->extends_index, extended_id, cpt_node);
+		}
+	}
+
+	if (suggested_nodes != NULL) {
+		for (guint i = 0; i < suggested_nodes->len; i++) {
+			XbNode *node = g_ptr_array_index (suggested_nodes, i);
+			g_autoptr(XbNode) suggests_node = xb_node_get_parent (node);
+			g_autoptr(XbNode) cpt_node = NULL;
+			const gchar *suggested_id = xb_node_get_text (node);
+
+			if (suggested_id == NULL || suggests_node == NULL)
+				continue;
+			cpt_node = xb_node_get_parent (suggests_node);
+			if (cpt_node == NULL)
+				continue;
+			as_cache_rev_index_add (csec->suggests_index, suggested_id, cpt_node);
+		}
 	}
 
+	csec->rev_indexes_built = TRUE;
 	return TRUE;
 }
 
 /**
- * as_cache_get_component_count:
- * @cache: An instance of #AsCache.
+ * as_cache_provided_index_key:
  *
- * Get the number of components present in this cache.
+ * Build the lookup key for the provided-items index of a cache section.
+ */
+static gchar *
+as_cache_provided_index_key (AsProvidedKind kind, const gchar *item)
+{
+	return g_strconcat (as_provided_kind_to_string (kind), "\x1f", item, NULL);
+}
+
+/**
+ * as_cache_section_ensure_provided_index:
  *
- * Returns: The number of components present in the cache.
+ * Build the provided-items index of a cache section on first use.
+ * The silo is scanned exactly once per section, making any subsequent
+ * provided-item resolution (e.g. the mediatype lookups issued for
+ * file-open dialogs) a single hash probe instead of a silo XPath scan.
  */
-guint
-as_cache_get_component_count (AsCache *cache)
+static gboolean
+as_cache_section_ensure_provided_index (AsCacheSection *csec, GError **error)
 {
-	AsCachePrivate *priv = GET_PRIVATE (cache);
-	guint cpt_node_count = 0;
-	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+	g_autoptr(GPtrArray) provides_nodes = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&csec->query_cache_mutex);
 
-	for (guint i = 0; i < priv->sections->len; i++) {
-		g_autoptr(XbNode) n = NULL;
-		g_autoptr(XbNode) node = NULL;
-		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+	if (csec->provided_index_built)
+		return TRUE;
+
+	provides_nodes = xb_silo_query (csec->silo,
+					"components/component/provides",
+					0,
+					&tmp_error);
+	if (provides_nodes == NULL) {
+		if (!g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
+		    !g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
+			g_propagate_prefixed_error (error,
+						    g_steal_pointer (&tmp_error),
+						    "Unable to build provided-items index: ");
+			return FALSE;
+		}
+		g_clear_error (&tmp_error);
+	}
+
+	csec->provided_index = g_hash_table_new_full (g_str_hash,
+						      g_str_equal,
+						      g_free,
+						      (GDestroyNotify) g_ptr_array_unref);
+
+	if (provides_nodes != NULL) {
+		for (guint i = 0; i < provides_nodes->len; i++) {
+			XbNode *prov_node = g_ptr_array_index (provides_nodes, i);
+			g_autoptr(XbNode) cpt_node = xb_node_get_parent (prov_node);
+			XbNode *item_node;
+
+			if (cpt_node == NULL)
+				continue;
 
-		node = xb_silo_get_root (csec->silo);
-		n = xb_node_get_child (node);
-		while (n != NULL) {
-			cpt_node_count++;
-			g_object_unref (n);
-			n = xb_node_get_next (n);
+			item_node = xb_node_get_child (prov_node);
+			while (item_node != NULL) {
+				const gchar *element = xb_node_get_element (item_node);
+				const gchar *item = xb_node_get_text (item_node);
+				AsProvidedKind kind = AS_PROVIDED_KIND_UNKNOWN;
+
+				/* the item element names mostly match the kind strings, with
+				 * a few exceptions for historical reasons */
+				if (g_strcmp0 (element, "library") == 0) {
+					kind = AS_PROVIDED_KIND_LIBRARY;
+				} else if (g_strcmp0 (element, "binary") == 0) {
+					kind = AS_PROVIDED_KIND_BINARY;
+				} else if (g_strcmp0 (element, "dbus") == 0) {
+					const gchar *dtype = xb_node_get_attr (item_node, "type");
+					if (g_strcmp0 (dtype, "system") == 0)
+						kind = AS_PROVIDED_KIND_DBUS_SYSTEM;
+					else if (g_strcmp0 (dtype, "user") == 0)
+						kind = AS_PROVIDED_KIND_DBUS_USER;
+				} else if (g_strcmp0 (element, "firmware") == 0) {
+					const gchar *ftype = xb_node_get_attr (item_node, "type");
+					if (g_strcmp0 (ftype, "runtime") == 0)
+						kind = AS_PROVIDED_KIND_FIRMWARE_RUNTIME;
+					else if (g_strcmp0 (ftype, "flashed") == 0)
+						kind = AS_PROVIDED_KIND_FIRMWARE_FLASHED;
+				} else if (element != NULL) {
+					kind = as_provided_kind_from_string (element);
+				}
+
+				if (kind != AS_PROVIDED_KIND_UNKNOWN && item != NULL) {
+					g_autofree gchar *key = as_cache_provided_index_key (kind,
+											     item);
+					as_cache_rev_index_add (csec->provided_index,
+								key,
+								cpt_node);
+				}
+
+				g_object_unref (item_node);
+				item_node = xb_node_get_next (item_node);
+			}
 		}
 	}
 
-	return cpt_node_count;
+	csec->provided_index_built = TRUE;
+	return TRUE;
 }
 
 /**
- * as_cache_get_components_all:
- * @cache: An instance of #AsCache.
- * @error: A #GError or %NULL.
- *
- * Retrieve all components this cache contains.
+ * as_cache_query_components_rev_index:
  *
- * Returns: (transfer full): An #AsComponentBox
+ * Retrieve components from the per-section inverted cross-reference
+ * indexes, building them on first use.
  */
-AsComponentBox *
-as_cache_get_components_all (AsCache *cache, GError **error)
+static AsComponentBox *
+as_cache_query_components_rev_index (AsCache *cache,
+				     gboolean use_suggests_index,
+				     const gchar *id,
+				     GError **error)
 {
-	return as_cache_query_components (cache, "components/component", NULL, 0, FALSE, error);
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(AsQueryContext) qctx = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	qctx = as_query_context_new ();
+	for (guint i = 0; i < priv->sections->len; i++) {
+		GPtrArray *nodes;
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+
+		if (!as_cache_section_ensure_rev_indexes (csec, error))
+			return NULL;
+
+		nodes = g_hash_table_lookup (use_suggests_index ? csec->suggests_index
+								: csec->extends_index,
+					     id);
+		if (nodes == NULL)
+			continue;
+
+		if (!as_query_context_add_component_from_nodes (qctx, cache, csec, nodes, error))
+			return NULL;
+	}
+
+	return as_query_context_retrieve_components (qctx);
 }
 
 /**
- * as_cache_get_components_by_id:
+ * as_cache_get_components_by_extends:
  * @cache: An instance of #AsCache.
- * @id: The component ID to search for.
+ * @extends_id: The component ID to find extensions for.
  * @error: A #GError or %NULL.
  *
- * Retrieve components with the selected ID.
+ * Retrieve components extending a component with the selected ID.
  *
  * Returns: (transfer full): An #AsComponentBox
  */
 AsComponentBox *
-as_cache_get_components_by_id (AsCache *cache, const gchar *id, GError **error)
+as_cache_get_components_by_extends (AsCache *cache, const gchar *extends_id, GError **error)
 {
-	AsComponentBox *results = NULL;
-	g_autofree gchar *id_lower = NULL;
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
-
-	id_lower = g_utf8_strdown (id, -1);
-	xb_value_bindings_bind_str (xb_query_context_get_bindings (&context), 0, id_lower, NULL);
-	results = as_cache_query_components (cache,
-					     "components/component/id[lower-case(text())=?]/..",
-					     &context,
-					     0,
-					     FALSE,
-					     error);
-
-	/* don't continue if we have an error */
-	if (results == NULL)
-		return results;
-
-	if (as_component_box_is_empty (results)) {
-		/* we found no exact matches, try components providing this ID */
-		g_object_unref (results);
-		results = as_cache_query_components (
-		    cache,
-		    "components/component/provides/id[lower-case(text())=?]/../..",
-		    &context,
-		    0,
-		    FALSE,
-		    error);
-	}
-
-	return results;
+	return as_cache_query_components_rev_index (cache, FALSE, extends_id, error);
 }
 
 /**
- * as_cache_get_components_by_extends:
+ * as_cache_get_components_by_suggested:
  * @cache: An instance of #AsCache.
- * @extends_id: The component ID to find extensions for.
+ * @suggested_id: The component ID to find suggesting components for.
  * @error: A #GError or %NULL.
  *
- * Retrieve components extending a component with the selected ID.
+ * Retrieve components that suggest the component with the selected ID.
  *
  * Returns: (transfer full): An #AsComponentBox
  */
 AsComponentBox *
-as_cache_get_components_by_extends (AsCache *cache, const gchar *extends_id, GError **error)
+as_cache_get_components_by_suggested (AsCache *cache, const gchar *suggested_id, GError **error)
 {
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
-	xb_value_bindings_bind_str (xb_query_context_get_bindings (&context), 0, extends_id, NULL);
-	return as_cache_query_components (cache,
-					  "components/component/extends[text()=?]/..",
-					  &context,
-					  0,
-					  FALSE,
-					  error);
+	return as_cache_query_components_rev_index (cache, TRUE, suggested_id, error);
 }
 
 /**
@@ -1703,12 +4917,10 @@ as_cache_get_components_by_kind (AsCache *cache, AsComponentKind kind, GError **
 				    0,
 				    as_component_kind_to_string (kind),
 				    NULL);
-	return as_cache_query_components (cache,
-					  "components/component[@type=?]",
-					  &context,
-					  0,
-					  FALSE,
-					  error);
+	return as_cache_query_components_shaped (cache,
+						 AS_CACHE_QUERY_SHAPE_BY_KIND,
+						 &context,
+						 error);
 }
 
 /**
@@ -1728,35 +4940,106 @@ as_cache_get_components_by_provided_item (AsCache *cache,
 					  const gchar *item,
 					  GError **error)
 {
-	const gchar *kind_node_name = NULL;
-	const gchar *xpath_query_tmpl = NULL;
-	const gchar *xpath_query_type_tmpl = NULL;
-	g_autofree gchar *xpath_query = NULL;
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
-	XbValueBindings *vbindings = xb_query_context_get_bindings (&context);
-
-	xpath_query_tmpl = "components/component/provides/%s[text()=?]/../..";
-	xpath_query_type_tmpl = "components/component/provides/%s[@type='%s'][text()=?]/../..";
-
-	if (kind == AS_PROVIDED_KIND_LIBRARY)
-		kind_node_name = "library";
-	else if (kind == AS_PROVIDED_KIND_BINARY)
-		kind_node_name = "binary";
-	else if (kind == AS_PROVIDED_KIND_DBUS_SYSTEM)
-		xpath_query = g_strdup_printf (xpath_query_type_tmpl, "dbus", "system");
-	else if (kind == AS_PROVIDED_KIND_DBUS_USER)
-		xpath_query = g_strdup_printf (xpath_query_type_tmpl, "dbus", "user");
-	else if (kind == AS_PROVIDED_KIND_FIRMWARE_RUNTIME)
-		xpath_query = g_strdup_printf (xpath_query_type_tmpl, "firmware", "runtime");
-	else if (kind == AS_PROVIDED_KIND_FIRMWARE_FLASHED)
-		xpath_query = g_strdup_printf (xpath_query_type_tmpl, "firmware", "flashed");
-	else
-		kind_node_name = as_provided_kind_to_string (kind);
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autofree gchar *key = NULL;
+	g_autoptr(AsQueryContext) qctx = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	if (kind >= AS_PROVIDED_KIND_LAST)
+		kind = AS_PROVIDED_KIND_UNKNOWN;
+	key = as_cache_provided_index_key (kind, item);
+
+	qctx = as_query_context_new ();
+	for (guint i = 0; i < priv->sections->len; i++) {
+		GPtrArray *nodes;
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+
+		if (!as_cache_section_ensure_provided_index (csec, error))
+			return NULL;
+
+		nodes = g_hash_table_lookup (csec->provided_index, key);
+		if (nodes == NULL)
+			continue;
+
+		if (!as_query_context_add_component_from_nodes (qctx, cache, csec, nodes, error))
+			return NULL;
+	}
+
+	return as_query_context_retrieve_components (qctx);
+}
+
+/**
+ * as_cache_section_query_catmap:
+ *
+ * Answer a category query for a single section using its precomputed
+ * category bitmap: the requested categories are folded into one bitmask,
+ * and a component matches if its bitmap row contains all bits of the mask.
+ */
+static gboolean
+as_cache_section_query_catmap (AsCache *cache,
+			       AsCacheSection *csec,
+			       AsQueryContext *qctx,
+			       gchar **categories,
+			       GError **error)
+{
+	g_autofree guint8 *mask = NULL;
+	g_autoptr(GPtrArray) nodes = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(XbQuery) query = NULL;
+
+	mask = g_malloc0 (csec->catmap_row_len);
+	for (guint i = 0; categories[i] != NULL; i++) {
+		guint bit = GPOINTER_TO_UINT (
+		    g_hash_table_lookup (csec->catmap_index, categories[i]));
+
+		/* a category that no component of this section has can never match */
+		if (bit == 0)
+			return TRUE;
+		bit -= 1;
+		mask[bit / 8] |= 1 << (bit % 8);
+	}
+
+	query = as_cache_section_get_query (csec, "components/component", &tmp_error);
+	if (query == NULL) {
+		g_propagate_prefixed_error (error,
+					    g_steal_pointer (&tmp_error),
+					    "Unable to construct query: ");
+		return FALSE;
+	}
+	nodes = xb_silo_query_with_context (csec->silo, query, NULL, &tmp_error);
+	if (nodes == NULL) {
+		if (g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+			return TRUE;
+		g_propagate_prefixed_error (error,
+					    g_steal_pointer (&tmp_error),
+					    "Unable to run query: ");
+		return FALSE;
+	}
+
+	for (guint i = 0; i < nodes->len && i < csec->catmap_n_rows; i++) {
+		const guint8 *row = csec->catmap + (gsize) i * csec->catmap_row_len;
+		gboolean matched = TRUE;
+
+		for (guint j = 0; j < csec->catmap_row_len; j++) {
+			if ((row[j] & mask[j]) != mask[j]) {
+				matched = FALSE;
+				break;
+			}
+		}
+		if (!matched)
+			continue;
+
+		if (!as_query_context_add_component_from_node (qctx,
+							       cache,
+							       csec,
+							       XB_NODE (
+								   g_ptr_array_index (nodes, i)),
+							       0,
+							       error))
+			return FALSE;
+	}
 
-	if (xpath_query == NULL)
-		xpath_query = g_strdup_printf (xpath_query_tmpl, kind_node_name);
-	xb_value_bindings_bind_str (vbindings, 0, item, NULL);
-	return as_cache_query_components (cache, xpath_query, &context, 0, FALSE, error);
+	return TRUE;
 }
 
 /**
@@ -1772,30 +5055,78 @@ as_cache_get_components_by_provided_item (AsCache *cache,
 AsComponentBox *
 as_cache_get_components_by_categories (AsCache *cache, gchar **categories, GError **error)
 {
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(AsQueryContext) qctx = NULL;
 	g_autoptr(GString) xpath = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
-	XbValueBindings *vbindings = xb_query_context_get_bindings (&context);
+	gint64 start_time = 0;
+	guint sections_with_hits = 0;
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
 
 	if (categories == NULL || categories[0] == NULL)
 		return as_component_box_new_simple ();
 
-	xpath = g_string_new ("components/component/categories");
-	for (guint i = 0; categories[i] != NULL; i++) {
-		if (i >= 4) {
-			g_set_error_literal (error,
-					     AS_CACHE_ERROR,
-					     AS_CACHE_ERROR_PERMISSIONS,
-					     "Due to limitations in libxmlb, we currently can not "
-					     "search for software "
-					     "in more than 4 categories.");
-			return NULL;
+	if (G_UNLIKELY (priv->query_stats_enabled))
+		start_time = g_get_monotonic_time ();
+
+	locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+	qctx = as_query_context_new ();
+
+	for (guint i = 0; i < priv->sections->len; i++) {
+		guint results_prev = g_hash_table_size (qctx->results_map);
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+
+		/* answer from the category bitmap, if this section has one */
+		if (csec->catmap != NULL) {
+			if (!as_cache_section_query_catmap (cache, csec, qctx, categories, error))
+				return NULL;
+			if (g_hash_table_size (qctx->results_map) > results_prev)
+				sections_with_hits++;
+			continue;
 		}
-		g_string_append (xpath, "/category[text()=?]/..");
-		xb_value_bindings_bind_str (vbindings, i, categories[i], NULL);
+
+		/* no bitmap (cache written by an older version), fall back to an XPath query */
+		if (xpath == NULL) {
+			XbValueBindings *vbindings = xb_query_context_get_bindings (&context);
+
+			xpath = g_string_new ("components/component/categories");
+			for (guint j = 0; categories[j] != NULL; j++) {
+				if (j >= 4) {
+					g_set_error_literal (
+					    error,
+					    AS_CACHE_ERROR,
+					    AS_CACHE_ERROR_PERMISSIONS,
+					    "Due to limitations in libxmlb, we currently can not "
+					    "search for software "
+					    "in more than 4 categories.");
+					return NULL;
+				}
+				g_string_append (xpath, "/category[text()=?]/..");
+				xb_value_bindings_bind_str (vbindings, j, categories[j], NULL);
+			}
+			g_string_append (xpath, "/..");
+		}
+
+		if (!as_cache_section_query_into_context (cache,
+							  csec,
+							  qctx,
+							  xpath->str,
+							  &context,
+							  error))
+			return NULL;
+		if (g_hash_table_size (qctx->results_map) > results_prev)
+			sections_with_hits++;
 	}
-	g_string_append (xpath, "/..");
 
-	return as_cache_query_components (cache, xpath->str, &context, 0, FALSE, error);
+	if (G_UNLIKELY (priv->query_stats_enabled))
+		as_cache_record_query_stat (cache,
+					    "categories",
+					    g_get_monotonic_time () - start_time,
+					    g_hash_table_size (qctx->results_map),
+					    priv->sections->len,
+					    sections_with_hits);
+
+	return as_query_context_retrieve_components (qctx);
 }
 
 /**
@@ -1815,12 +5146,23 @@ as_cache_get_components_by_launchable (AsCache *cache,
 				       const gchar *id,
 				       GError **error)
 {
+	static gchar **xpath_queries = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
-	g_autofree gchar *xpath = NULL;
+
+	/* build the canonical query string for every launchable kind only once */
+	if (g_once_init_enter (&xpath_queries)) {
+		gchar **tmp = g_new0 (gchar *, AS_LAUNCHABLE_KIND_LAST);
+		for (guint i = 0; i < AS_LAUNCHABLE_KIND_LAST; i++)
+			tmp[i] = g_strdup_printf (
+			    "components/component/launchable[@type='%s'][text()=?]/..",
+			    as_launchable_kind_to_string (i));
+		g_once_init_leave (&xpath_queries, tmp);
+	}
+	if (kind >= AS_LAUNCHABLE_KIND_LAST)
+		kind = AS_LAUNCHABLE_KIND_UNKNOWN;
+
 	xb_value_bindings_bind_str (xb_query_context_get_bindings (&context), 0, id, NULL);
-	xpath = g_strdup_printf ("components/component/launchable[@type='%s'][text()=?]/..",
-				 as_launchable_kind_to_string (kind));
-	return as_cache_query_components (cache, xpath, &context, 0, FALSE, error);
+	return as_cache_query_components (cache, xpath_queries[kind], &context, 0, FALSE, error);
 }
 
 /**
@@ -1842,23 +5184,100 @@ as_cache_get_components_by_bundle_id (AsCache *cache,
 				      gboolean match_prefix,
 				      GError **error)
 {
+	static gchar **xpath_queries = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT ();
-	g_autofree gchar *xpath = NULL;
 
-	if (kind == AS_BUNDLE_KIND_PACKAGE) {
-		xpath = g_strdup (match_prefix
-				      ? "components/component/pkgname[starts-with(text(),?)]/.."
-				      : "components/component/pkgname[text()=?]/..");
-	} else {
-		const gchar *match =
-		    match_prefix
-			? "components/component/bundle[@type='%s'][starts-with(text(),?)]/.."
-			: "components/component/bundle[@type='%s'][text()=?]/..";
-		xpath = g_strdup_printf (match, as_bundle_kind_to_string (kind));
+	xb_value_bindings_bind_str (xb_query_context_get_bindings (&context), 0, id, NULL);
+
+	/* package-name lookups have their own typed query shapes */
+	if (kind == AS_BUNDLE_KIND_PACKAGE)
+		return as_cache_query_components_shaped (
+		    cache,
+		    match_prefix ? AS_CACHE_QUERY_SHAPE_BY_PKGNAME_PREFIX
+				 : AS_CACHE_QUERY_SHAPE_BY_PKGNAME,
+		    &context,
+		    error);
+
+	/* build the canonical query strings for every bundle kind only once,
+	 * with the prefix-matching variants stored in the upper half */
+	if (g_once_init_enter (&xpath_queries)) {
+		gchar **tmp = g_new0 (gchar *, AS_BUNDLE_KIND_LAST * 2);
+		for (guint i = 0; i < AS_BUNDLE_KIND_LAST; i++) {
+			tmp[i] = g_strdup_printf (
+			    "components/component/bundle[@type='%s'][text()=?]/..",
+			    as_bundle_kind_to_string (i));
+			tmp[AS_BUNDLE_KIND_LAST + i] = g_strdup_printf (
+			    "components/component/bundle[@type='%s'][starts-with(text(),?)]/..",
+			    as_bundle_kind_to_string (i));
+		}
+		g_once_init_leave (&xpath_queries, tmp);
 	}
+	if (kind >= AS_BUNDLE_KIND_LAST)
+		kind = AS_BUNDLE_KIND_UNKNOWN;
 
-	xb_value_bindings_bind_str (xb_query_context_get_bindings (&context), 0, id, NULL);
-	return as_cache_query_components (cache, xpath, &context, 0, FALSE, error);
+	return as_cache_query_components (
+	    cache,
+	    xpath_queries[match_prefix ? AS_BUNDLE_KIND_LAST + kind : kind],
+	    &context,
+	    0,
+	    FALSE,
+	    error);
+}
+
+/**
+ * as_cache_get_language_stats:
+ * @cache: An instance of #AsCache.
+ * @error: A #GError or %NULL.
+ *
+ * Count how many components claim support for each language across the
+ * whole cache. The histogram is aggregated directly from the silos,
+ * without deserializing any component.
+ *
+ * Returns: (transfer full) (element-type utf8 guint): locale → component count
+ */
+GHashTable *
+as_cache_get_language_stats (AsCache *cache, GError **error)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(GHashTable) stats = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	for (guint i = 0; i < priv->sections->len; i++) {
+		g_autoptr(GPtrArray) lang_nodes = NULL;
+		g_autoptr(GError) tmp_error = NULL;
+		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+
+		lang_nodes = xb_silo_query (csec->silo,
+					    "components/component/languages/lang",
+					    0,
+					    &tmp_error);
+		if (lang_nodes == NULL) {
+			if (g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+				continue;
+			if (g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
+				continue;
+			g_propagate_prefixed_error (error,
+						    g_steal_pointer (&tmp_error),
+						    "Unable to aggregate language statistics: ");
+			return NULL;
+		}
+
+		for (guint k = 0; k < lang_nodes->len; k++) {
+			XbNode *lnode = XB_NODE (g_ptr_array_index (lang_nodes, k));
+			const gchar *locale = xb_node_get_text (lnode);
+			guint count;
+
+			if (locale == NULL)
+				continue;
+			count = GPOINTER_TO_UINT (g_hash_table_lookup (stats, locale));
+			g_hash_table_insert (stats,
+					     g_strdup (locale),
+					     GUINT_TO_POINTER (count + 1));
+		}
+	}
+
+	return g_steal_pointer (&stats);
 }
 
 typedef struct {
@@ -1873,6 +5292,69 @@ as_ftsearch_helper_free (AsFTSearchHelper *helper)
 	g_free (helper);
 }
 
+/* weighted full-text search queries, run per component node */
+/* clang-format off */
+static const struct {
+	AsSearchTokenMatch	match_value;
+	const gchar		*xpath;
+} as_cache_fts_queries[] = {
+	{ AS_SEARCH_TOKEN_MATCH_MEDIATYPE,	"provides/mediatype[text()~=?]" },
+	{ AS_SEARCH_TOKEN_MATCH_PKGNAME,	"pkgname[text()~=?]" },
+	{ AS_SEARCH_TOKEN_MATCH_PKGNAME / 2,	"pkgname[contains(text(),?)]" },
+	{ AS_SEARCH_TOKEN_MATCH_SUMMARY,	"summary[text()~=?]" },
+	{ AS_SEARCH_TOKEN_MATCH_NAME,		"name[text()~=?]" },
+	{ AS_SEARCH_TOKEN_MATCH_NAME / 2,	"name[contains(text(),?)]" },
+	{ AS_SEARCH_TOKEN_MATCH_DESCRIPTION,	"_asi_tokens/t[text()~=?]" },
+	{ AS_SEARCH_TOKEN_MATCH_ID,		"id[text()~=?]" },
+	{ AS_SEARCH_TOKEN_MATCH_ORIGIN,		"_asi_origin[text()~=?]" },
+	{ AS_SEARCH_TOKEN_MATCH_NONE,		NULL }
+};
+/* clang-format on */
+
+/**
+ * as_cache_section_build_fts_helpers:
+ *
+ * Compile (or fetch from the section's query cache) the weighted full-text
+ * search queries for a cache section.
+ *
+ * Returns: (transfer container): array of #AsFTSearchHelper.
+ */
+static GPtrArray *
+as_cache_section_build_fts_helpers (AsCacheSection *csec)
+{
+	GPtrArray *array = g_ptr_array_new_with_free_func ((GDestroyNotify) as_ftsearch_helper_free);
+
+	for (guint j = 0; as_cache_fts_queries[j].xpath != NULL; j++) {
+		g_autoptr(GError) error_query = NULL;
+		g_autoptr(XbQuery) query = as_cache_section_get_query (csec,
+								       as_cache_fts_queries[j].xpath,
+								       &error_query);
+		if (query != NULL) {
+			AsFTSearchHelper *helper = g_new0 (AsFTSearchHelper, 1);
+			helper->match_value = as_cache_fts_queries[j].match_value;
+			helper->query = g_steal_pointer (&query);
+			g_ptr_array_add (array, helper);
+		} else {
+			g_debug ("Unable to create query (ignoring it): %s", error_query->message);
+		}
+	}
+
+	return array;
+}
+
+typedef struct {
+	XbNode	       *node;
+	AsCacheSection *csec;
+	AsTokenType	score;
+} AsSearchCandidate;
+
+static void
+as_search_candidate_free (AsSearchCandidate *scand)
+{
+	g_object_unref (scand->node);
+	g_free (scand);
+}
+
 static AsTokenType
 as_cache_search_component_node_term (GPtrArray *array, XbNode *cpt_node, const gchar *term)
 {
@@ -1916,70 +5398,75 @@ as_cache_search_component_node_terms (GPtrArray *array, XbNode *cpt_node, const
  * @cache: An instance of #AsCache.
  * @terms: List of search terms
  * @sort: %TRUE if results should be sorted by score.
+ * @limit: Maximum amount of results to return, or 0 for no limit.
  * @error: A #GError or %NULL.
  *
  * Perform a search for the given pre-stemmed terms.
  *
+ * If a limit is set, only the highest-scoring matches are turned into
+ * components, which is a lot cheaper than materializing every candidate
+ * if a broad query matches large parts of the cache.
+ *
  * Returns: (transfer container): An array of #AsComponent
  */
 AsComponentBox *
-as_cache_search (AsCache *cache, const gchar *const *terms, gboolean sort, GError **error)
+as_cache_search (AsCache *cache,
+		 const gchar *const *terms,
+		 gboolean sort,
+		 guint limit,
+		 GError **error)
 {
 	AsCachePrivate *priv = GET_PRIVATE (cache);
 	g_autoptr(AsComponentBox) results = NULL;
 	g_autoptr(AsQueryContext) qctx = NULL;
+	g_autoptr(GPtrArray) candidates = NULL;
 	g_autoptr(GRWLockReaderLocker) locker = NULL;
-
-	/* clang-format off */
-	const struct {
-		AsSearchTokenMatch	match_value;
-		const gchar		*xpath;
-	} queries[] = {
-		{ AS_SEARCH_TOKEN_MATCH_MEDIATYPE,	"provides/mediatype[text()~=?]" },
-		{ AS_SEARCH_TOKEN_MATCH_PKGNAME,	"pkgname[text()~=?]" },
-		{ AS_SEARCH_TOKEN_MATCH_PKGNAME / 2,	"pkgname[contains(text(),?)]" },
-		{ AS_SEARCH_TOKEN_MATCH_SUMMARY,	"summary[text()~=?]" },
-		{ AS_SEARCH_TOKEN_MATCH_NAME,		"name[text()~=?]" },
-		{ AS_SEARCH_TOKEN_MATCH_NAME / 2,	"name[contains(text(),?)]" },
-		{ AS_SEARCH_TOKEN_MATCH_DESCRIPTION,	"_asi_tokens/t[text()~=?]" },
-		{ AS_SEARCH_TOKEN_MATCH_ID,		"id[text()~=?]" },
-		{ AS_SEARCH_TOKEN_MATCH_ORIGIN,		"_asi_origin[text()~=?]" },
-		{ AS_SEARCH_TOKEN_MATCH_NONE,		NULL }
-	};
-	/* clang-format on */
+	g_autoptr(AsProfileTask) ptask = NULL;
+	AsTokenType best_score = 0;
+	guint n_best = 0;
+	gboolean scan_done = FALSE;
+	gint64 start_time = 0;
+	guint sections_scanned = 0;
+	guint sections_with_hits = 0;
 
 	if (terms == NULL || terms[0] == NULL)
 		return as_component_box_new_simple ();
 
+	/* the best score any candidate can achieve, used to stop scanning early */
+	for (guint j = 0; as_cache_fts_queries[j].xpath != NULL; j++)
+		best_score |= as_cache_fts_queries[j].match_value;
+
+	ptask = as_profile_start_literal (priv->profile, "AsCache:search");
+
+	if (G_UNLIKELY (priv->query_stats_enabled))
+		start_time = g_get_monotonic_time ();
+
 	/* lock for reading */
 	locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
 
 	qctx = as_query_context_new ();
-	for (guint i = 0; i < priv->sections->len; i++) {
+	if (limit > 0)
+		candidates = g_ptr_array_new_with_free_func (
+		    (GDestroyNotify) as_search_candidate_free);
+	for (guint i = 0; i < priv->sections->len && !scan_done; i++) {
 		g_autoptr(GPtrArray) array = NULL;
 		g_autoptr(GPtrArray) cpt_nodes = NULL;
 		g_autoptr(GError) tmp_error = NULL;
+		gboolean section_hit = FALSE;
 		AsCacheSection *csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
 
+		/* reject the section early if no component in it can match all terms */
+		if (!as_cache_section_possibly_matches (csec, terms)) {
+			g_debug ("Skipped full text search in %s: terms can not match",
+				 csec->key);
+			continue;
+		}
+
 		g_debug ("Full text search in %s", csec->key);
+		sections_scanned++;
 
 		/* add weighted queries */
-		array = g_ptr_array_new_with_free_func ((GDestroyNotify) as_ftsearch_helper_free);
-		for (guint j = 0; queries[j].xpath != NULL; j++) {
-			g_autoptr(GError) error_query = NULL;
-			g_autoptr(XbQuery) query = xb_query_new (csec->silo,
-								  queries[j].xpath,
-								  &error_query);
-			if (query != NULL) {
-				AsFTSearchHelper *helper = g_new0 (AsFTSearchHelper, 1);
-				helper->match_value = queries[j].match_value;
-				helper->query = g_steal_pointer (&query);
-				g_ptr_array_add (array, helper);
-			} else {
-				g_debug ("Unable to create query (ignoring it): %s",
-					 error_query->message);
-			}
-		}
+		array = as_cache_section_build_fts_helpers (csec);
 
 		/* get nodes for all components */
 		cpt_nodes = xb_silo_query (csec->silo, "components/component", 0, &tmp_error);
@@ -1999,7 +5486,11 @@ as_cache_search (AsCache *cache, const gchar *const *terms, gboolean sort, GErro
 			AsTokenType match_value = as_cache_search_component_node_terms (array,
 											cpt_node,
 											terms);
-			if (match_value != 0) {
+			if (match_value == 0)
+				continue;
+			section_hit = TRUE;
+
+			if (candidates == NULL) {
 				if (!as_query_context_add_component_from_node (qctx,
 									       cache,
 									       csec,
@@ -2007,8 +5498,68 @@ as_cache_search (AsCache *cache, const gchar *const *terms, gboolean sort, GErro
 									       match_value,
 									       error))
 					return NULL;
+				continue;
+			}
+
+			/* just remember the match for now - most candidates will never
+			 * make it into the result set and are not worth deserializing */
+			{
+				AsSearchCandidate *scand = g_new0 (AsSearchCandidate, 1);
+				scand->node = g_object_ref (cpt_node);
+				scand->csec = csec;
+				scand->score = match_value;
+				g_ptr_array_add (candidates, scand);
+			}
+
+			/* once enough candidates hit the maximum possible score,
+			 * no later match can displace them anymore */
+			if (match_value == best_score && ++n_best >= limit) {
+				scan_done = TRUE;
+				break;
+			}
+		}
+
+		if (section_hit)
+			sections_with_hits++;
+	}
+
+	/* materialize only the best-scoring candidates, in scan order */
+	if (candidates != NULL) {
+		g_autofree guint *score_hist = g_new0 (guint, (gsize) best_score + 1);
+		AsTokenType threshold = 0;
+		guint n_taken = 0;
+
+		for (guint i = 0; i < candidates->len; i++) {
+			AsSearchCandidate *scand = g_ptr_array_index (candidates, i);
+			score_hist[scand->score]++;
+		}
+		for (guint score = best_score;; score--) {
+			n_taken += score_hist[score];
+			if (n_taken >= limit || score == 0) {
+				threshold = score;
+				break;
 			}
 		}
+
+		n_taken -= score_hist[threshold];
+		for (guint i = 0; i < candidates->len; i++) {
+			AsSearchCandidate *scand = g_ptr_array_index (candidates, i);
+			if (scand->score < threshold)
+				continue;
+			if (scand->score == threshold) {
+				/* take ties at the cutoff score only until the limit is hit */
+				if (n_taken >= limit)
+					continue;
+				n_taken++;
+			}
+			if (!as_query_context_add_component_from_node (qctx,
+								       cache,
+								       scand->csec,
+								       scand->node,
+								       scand->score,
+								       error))
+				return NULL;
+		}
 	}
 
 	results = as_query_context_retrieve_components (qctx);
@@ -2017,5 +5568,68 @@ as_cache_search (AsCache *cache, const gchar *const *terms, gboolean sort, GErro
 	if (sort)
 		as_component_box_sort_by_score (results);
 
+	if (G_UNLIKELY (priv->query_stats_enabled))
+		as_cache_record_query_stat (cache,
+					    "fts:search",
+					    g_get_monotonic_time () - start_time,
+					    as_component_box_len (results),
+					    sections_scanned,
+					    sections_with_hits);
+
 	return g_steal_pointer (&results);
 }
+
+/**
+ * as_cache_warm_search_index:
+ * @cache: An instance of #AsCache.
+ * @cancellable: (nullable): a #GCancellable to stop the warmup early.
+ *
+ * Prepare the data structures used by as_cache_search() ahead of the first
+ * real query: compile the weighted search queries into each section's query
+ * cache and run them once over every component node, which pre-faults the
+ * memory-mapped silo pages and builds libxmlb's internal lookup structures.
+ *
+ * The reader lock is released between sections, so a concurrent cache
+ * update is never stalled behind this idle-time work.
+ */
+void
+as_cache_warm_search_index (AsCache *cache, GCancellable *cancellable)
+{
+	AsCachePrivate *priv = GET_PRIVATE (cache);
+	g_autoptr(AsProfileTask) ptask = NULL;
+	/* an improbable, pre-stemmed term - we only care about the work done to look it up */
+	const gchar *probe_terms[] = { "aswarmupprobe", NULL };
+
+	ptask = as_profile_start_literal (priv->profile, "AsCache:warm-search-index");
+
+	for (guint i = 0;; i++) {
+		g_autoptr(GRWLockReaderLocker) locker = NULL;
+		g_autoptr(GPtrArray) array = NULL;
+		g_autoptr(GPtrArray) cpt_nodes = NULL;
+		AsCacheSection *csec;
+
+		if (g_cancellable_is_cancelled (cancellable))
+			return;
+
+		locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+		if (i >= priv->sections->len)
+			return;
+		csec = (AsCacheSection *) g_ptr_array_index (priv->sections, i);
+
+		array = as_cache_section_build_fts_helpers (csec);
+		cpt_nodes = xb_silo_query (csec->silo, "components/component", 0, NULL);
+		if (cpt_nodes == NULL)
+			continue;
+
+		for (guint k = 0; k < cpt_nodes->len; k++) {
+			XbNode *cpt_node = g_ptr_array_index (cpt_nodes, k);
+
+			/* a real query arriving cancels us - check often enough
+			 * to get out of its way quickly */
+			if ((k & 0x3f) == 0 && g_cancellable_is_cancelled (cancellable))
+				return;
+			as_cache_search_component_node_terms (array, cpt_node, probe_terms);
+		}
+		g_debug ("Warmed search index of cache section %s", csec->key);
+	}
+}
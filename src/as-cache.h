@@ -27,6 +27,7 @@
 
 #include <glib-object.h>
 #include "as-component-box.h"
+#include "as-pool.h"
 
 G_BEGIN_DECLS
 
@@ -95,6 +96,7 @@ AsCache	       *as_cache_new (void);
 
 const gchar    *as_cache_get_locale (AsCache *cache);
 void		as_cache_set_locale (AsCache *cache, const gchar *locale);
+void		as_cache_set_locale_strict (AsCache *cache, gboolean strict);
 
 void		as_cache_set_locations (AsCache	    *cache,
 					const gchar *system_cache_dir,
@@ -104,8 +106,14 @@ gboolean	as_cache_get_prefer_os_metainfo (AsCache *cache);
 void		as_cache_set_prefer_os_metainfo (AsCache *cache, gboolean prefer_os_metainfo);
 
 void		as_cache_set_resolve_addons (AsCache *cache, gboolean resolve_addons);
+void		as_cache_set_throttled (AsCache *cache, gboolean throttled);
+void		as_cache_set_cluster_hot_fields (AsCache *cache, gboolean cluster);
 
 void		as_cache_prune_data (AsCache *cache);
+gboolean	as_cache_vacuum (AsCache *cache,
+				 guint64  size_budget,
+				 guint64 *bytes_freed,
+				 GError **error);
 
 void		as_cache_clear (AsCache *cache);
 
@@ -115,6 +123,7 @@ gboolean	as_cache_set_contents_for_section (AsCache	   *cache,
 						   gboolean	    is_os_data,
 						   GPtrArray	   *cpts,
 						   const gchar	   *cache_key,
+						   const gchar	   *fingerprint,
 						   gpointer	    refinefn_user_data,
 						   GError	  **error);
 gboolean	as_cache_set_contents_for_path (AsCache	    *cache,
@@ -133,6 +142,7 @@ void		as_cache_load_section_for_key (AsCache	       *cache,
 					       AsFormatStyle	source_format_style,
 					       gboolean		is_os_data,
 					       const gchar     *cache_key,
+					       const gchar     *fingerprint,
 					       gboolean	       *is_outdated,
 					       gpointer		refinefn_user_data);
 void		as_cache_load_section_for_path (AsCache	    *cache,
@@ -140,21 +150,81 @@ void		as_cache_load_section_for_path (AsCache	    *cache,
 						gboolean    *is_outdated,
 						gpointer     refinefn_user_data);
 
+gchar	       *as_cache_generation_check_sources (AsCache	       *cache,
+						   AsComponentScope	scope,
+						   const gchar	       *cache_key,
+						   const gchar *const  *locations);
+void		as_cache_generation_update_sources (AsCache		*cache,
+						    AsComponentScope	 scope,
+						    const gchar		*cache_key,
+						    const gchar *const	*locations,
+						    const gchar		*fingerprint);
+gchar	       *as_cache_generation_get_file_checksum (AsCache *cache, const gchar *fname);
+void		as_cache_generation_update_file_checksum (AsCache     *cache,
+							  const gchar *fname,
+							  const gchar *checksum);
+
 void		as_cache_mask_by_data_id (AsCache *cache, const gchar *cdid);
 gboolean	as_cache_add_masking_components (AsCache *cache, GPtrArray *cpts, GError **error);
 
 void		as_cache_set_refine_func (AsCache *cache, AsCacheDataRefineFn func);
 
+void		as_cache_set_progress_func (AsCache	    *cache,
+					    AsPoolProgressFn func,
+					    gpointer	     user_data);
+void		as_cache_set_cancellable (AsCache *cache, GCancellable *cancellable);
+
+void		as_cache_set_query_stats_enabled (AsCache *cache, gboolean enabled);
+gchar	       *as_cache_get_query_stats_report (AsCache *cache);
+
+/**
+ * AsCacheUsageCounters:
+ * @queries_served:		Amount of cache queries answered.
+ * @sections_loaded:		Amount of cache sections (re)loaded.
+ * @components_materialized:	Amount of components deserialized from cache data.
+ * @bytes_mapped:		Amount of cache data mapped into memory.
+ *
+ * Snapshot of the process-wide, always-on cache usage counters.
+ **/
+typedef struct {
+	guint64 queries_served;
+	guint64 sections_loaded;
+	guint64 components_materialized;
+	guint64 bytes_mapped;
+} AsCacheUsageCounters;
+
+void		as_cache_get_usage_counters (AsCacheUsageCounters *counters);
+
 gboolean	as_cache_is_empty (AsCache *cache);
 guint		as_cache_get_component_count (AsCache *cache);
 
 AsComponentBox *as_cache_get_components_all (AsCache *cache, GError **error);
 
+typedef struct _AsCacheCursor AsCacheCursor;
+
+AsCacheCursor  *as_cache_open_cursor_all (AsCache *cache, guint prefetch_count);
+AsComponent    *as_cache_cursor_next (AsCacheCursor *cursor, GError **error);
+void		as_cache_cursor_free (AsCacheCursor *cursor);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (AsCacheCursor, as_cache_cursor_free)
+
+AsComponentBox *as_cache_get_components_for_key (AsCache     *cache,
+						 const gchar *cache_key,
+						 GError	    **error);
+
 AsComponentBox *as_cache_get_components_by_id (AsCache *cache, const gchar *id, GError **error);
+GPtrArray      *as_cache_get_components_xml_by_id (AsCache	*cache,
+						   const gchar	*id,
+						   GError      **error);
+AsComponentBox *as_cache_get_components_by_ids (AsCache		  *cache,
+						const gchar *const *ids,
+						GError		 **error);
 
 AsComponentBox *as_cache_get_components_by_extends (AsCache	*cache,
 						    const gchar *extends_id,
 						    GError     **error);
+AsComponentBox *as_cache_get_components_by_suggested (AsCache	  *cache,
+						      const gchar *suggested_id,
+						      GError	 **error);
 
 AsComponentBox *as_cache_get_components_by_kind (AsCache	*cache,
 						 AsComponentKind kind,
@@ -180,11 +250,16 @@ AsComponentBox *as_cache_get_components_by_bundle_id (AsCache	  *cache,
 						      gboolean	   match_prefix,
 						      GError	 **error);
 
+GHashTable *as_cache_get_language_stats (AsCache *cache, GError **error);
+
 AsComponentBox *as_cache_search (AsCache	    *cache,
 				 const gchar *const *terms,
 				 gboolean	     sort,
+				 guint		     limit,
 				 GError		   **error);
 
+void		as_cache_warm_search_index (AsCache *cache, GCancellable *cancellable);
+
 G_END_DECLS
 
 #endif /* __AS_CACHE_H */
@@ -0,0 +1,35 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2012-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __AS_CATEGORY_PRIVATE_H
+#define __AS_CATEGORY_PRIVATE_H
+
+#include "as-category.h"
+
+G_BEGIN_DECLS
+#pragma GCC visibility push(hidden)
+
+const gchar *const *as_category_get_desktop_group_parts (const gchar *desktop_group);
+GPtrArray	   *as_category_get_root_desktop_groups (const gchar *root_id);
+
+#pragma GCC visibility pop
+G_END_DECLS
+
+#endif /* __AS_CATEGORY_PRIVATE_H */
@@ -21,6 +21,7 @@
 
 #include "as-category.h"
 #include "as-category-gi.h"
+#include "as-category-private.h"
 
 #include "config.h"
 #include <glib/gi18n-lib.h>
@@ -337,6 +338,113 @@ static const AsCategoryData msdata[] = {
 
 /* clang-format on */
 
+/**
+ * AsCategoryTaxonomy:
+ *
+ * Process-global, immutable index over the static category tables above.
+ * It is built exactly once and never freed, so lookups can hand out
+ * pointers into it without any locking or copying.
+ */
+typedef struct {
+	GHashTable *group_parts; /* of utf8 → GStrv, desktop-group selector to its pre-split parts */
+	GHashTable *root_groups; /* of utf8 → GPtrArray of utf8, main category ID to its XDG group names */
+} AsCategoryTaxonomy;
+
+/**
+ * as_category_get_taxonomy:
+ *
+ * Obtain the shared category taxonomy index, building it on first use.
+ */
+static AsCategoryTaxonomy *
+as_category_get_taxonomy (void)
+{
+	static AsCategoryTaxonomy *taxonomy = NULL;
+	static gsize initialized = 0;
+
+	if (g_once_init_enter (&initialized)) {
+		taxonomy = g_new0 (AsCategoryTaxonomy, 1);
+		taxonomy->group_parts = g_hash_table_new_full (g_str_hash,
+							       g_str_equal,
+							       NULL,
+							       (GDestroyNotify) g_strfreev);
+		taxonomy->root_groups = g_hash_table_new_full (g_str_hash,
+							       g_str_equal,
+							       NULL,
+							       (GDestroyNotify) g_ptr_array_unref);
+
+		for (guint i = 0; msdata[i].id != NULL; i++) {
+			GPtrArray *root_grps = g_ptr_array_new ();
+			g_hash_table_insert (taxonomy->root_groups,
+					     (gchar *) msdata[i].id,
+					     root_grps);
+
+			for (guint j = 0; msdata[i].mapping[j].id != NULL; j++) {
+				const AsCategoryMap *map = &msdata[i].mapping[j];
+
+				for (guint k = 0; map->fdo_cats[k] != NULL; k++) {
+					gchar **parts;
+
+					parts = g_hash_table_lookup (taxonomy->group_parts,
+								     map->fdo_cats[k]);
+					if (parts == NULL) {
+						parts = g_strsplit (map->fdo_cats[k], "::", -1);
+						g_hash_table_insert (taxonomy->group_parts,
+								     (gchar *) map->fdo_cats[k],
+								     parts);
+					}
+
+					/* the root category transitively covers the first part of
+					 * each of its subcategories' group selectors */
+					if (!g_ptr_array_find_with_equal_func (root_grps,
+									       parts[0],
+									       g_str_equal,
+									       NULL))
+						g_ptr_array_add (root_grps, parts[0]);
+				}
+			}
+		}
+
+		g_once_init_leave (&initialized, 1);
+	}
+
+	return taxonomy;
+}
+
+/**
+ * as_category_get_desktop_group_parts:
+ * @desktop_group: a desktop-group selector, e.g. "Game::ActionGame"
+ *
+ * Look up the pre-split parts of a desktop-group selector known to
+ * the default category taxonomy.
+ *
+ * Returns: (nullable): %NULL-terminated parts array owned by the taxonomy,
+ *          or %NULL if the selector is not part of the default taxonomy.
+ */
+const gchar *const *
+as_category_get_desktop_group_parts (const gchar *desktop_group)
+{
+	AsCategoryTaxonomy *taxonomy = as_category_get_taxonomy ();
+	return g_hash_table_lookup (taxonomy->group_parts, desktop_group);
+}
+
+/**
+ * as_category_get_root_desktop_groups:
+ * @root_id: ID of a default main category, e.g. "games"
+ *
+ * Get the precomputed set of XDG group names covered by a default
+ * main category, i.e. the union of the first parts of all group
+ * selectors of its subcategories.
+ *
+ * Returns: (nullable) (element-type utf8): group names owned by the taxonomy,
+ *          or %NULL if the ID is no known main category.
+ */
+GPtrArray *
+as_category_get_root_desktop_groups (const gchar *root_id)
+{
+	AsCategoryTaxonomy *taxonomy = as_category_get_taxonomy ();
+	return g_hash_table_lookup (taxonomy->root_groups, root_id);
+}
+
 typedef struct {
 	gchar *id;
 	gchar *name;
@@ -796,9 +904,7 @@ as_get_default_categories (gboolean with_special)
 	for (i = 0; msdata[i].id != NULL; i++) {
 		guint j;
 		AsCategory *category;
-		GHashTableIter iter;
-		gpointer key;
-		g_autoptr(GHashTable) root_fdocats = NULL;
+		GPtrArray *root_fdocats;
 
 		if ((!with_special) && (g_strcmp0 (msdata[i].id, "addons") == 0))
 			continue;
@@ -812,8 +918,6 @@ as_get_default_categories (gboolean with_special)
 		g_ptr_array_add (main_cats, category);
 		g_snprintf (msgctxt, sizeof (msgctxt), "Subcategory of %s", msdata[i].name);
 
-		root_fdocats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
-
 		/* add subcategories */
 		for (j = 0; msdata[i].mapping[j].id != NULL; j++) {
 			guint k;
@@ -828,21 +932,17 @@ as_get_default_categories (gboolean with_special)
 			sub = as_category_new ();
 			as_category_set_id (sub, map->id);
 
-			for (k = 0; map->fdo_cats[k] != NULL; k++) {
-				g_auto(GStrv) split = g_strsplit (map->fdo_cats[k], "::", -1);
+			for (k = 0; map->fdo_cats[k] != NULL; k++)
 				as_category_add_desktop_group (sub, map->fdo_cats[k]);
-
-				g_hash_table_add (root_fdocats, g_strdup (split[0]));
-			}
 			as_category_set_name (sub,
 					      g_dpgettext2 (GETTEXT_PACKAGE, msgctxt, map->name));
 			as_category_add_child (category, sub);
 		}
 
 		/* ensure the root category has the right XDG group names set, which match the subcategories */
-		g_hash_table_iter_init (&iter, root_fdocats);
-		while (g_hash_table_iter_next (&iter, &key, NULL)) {
-			const gchar *desktop_group = (const gchar *) key;
+		root_fdocats = as_category_get_root_desktop_groups (msdata[i].id);
+		for (j = 0; j < root_fdocats->len; j++) {
+			const gchar *desktop_group = g_ptr_array_index (root_fdocats, j);
 			as_category_add_desktop_group (category, desktop_group);
 		}
 	}
@@ -38,12 +38,23 @@
 
 #include "as-macros.h"
 #include "as-utils-private.h"
+#include "as-component-private.h"
 
 typedef struct {
 	AsComponentBoxFlags flags;
 	GHashTable *cpt_map;
+	AsComponentBox *source_box;
 } AsComponentBoxPrivate;
 
+typedef struct {
+	AsComponentBox *cbox;
+	guint		pos;
+	gpointer	dummy3;
+	gpointer	dummy4;
+} AsComponentBoxRealIter;
+
+G_STATIC_ASSERT (sizeof (AsComponentBoxIter) >= sizeof (AsComponentBoxRealIter));
+
 enum {
 	PROP_0,
 	PROP_FLAGS,
@@ -87,6 +98,8 @@ as_component_box_finalize (GObject *object)
 	g_ptr_array_unref (cbox->cpts);
 	if (priv->cpt_map != NULL)
 		g_hash_table_unref (priv->cpt_map);
+	if (priv->source_box != NULL)
+		g_object_unref (priv->source_box);
 
 	G_OBJECT_CLASS (as_component_box_parent_class)->finalize (object);
 }
@@ -182,6 +195,50 @@ as_component_box_new_simple (void)
 	return as_component_box_new (AS_COMPONENT_BOX_FLAG_NO_CHECKS);
 }
 
+/**
+ * as_component_box_new_view:
+ * @source: the #AsComponentBox to create a view on.
+ * @offset: index of the first component the view should contain.
+ * @length: maximum amount of components in the view, or 0 for all remaining.
+ *
+ * Creates a read-only view on a range of components of another component box.
+ * The view takes a reference on the source box, but only borrows the component
+ * pointers instead of referencing every component individually, which makes it
+ * cheap to create even for large result sets, e.g. when paginating through
+ * query results.
+ *
+ * A view can not be modified, and must not be used anymore after its
+ * source box was modified.
+ *
+ * Returns: (transfer full): an #AsComponentBox view
+ *
+ * Since: 1.0.5
+ **/
+AsComponentBox *
+as_component_box_new_view (AsComponentBox *source, guint offset, guint length)
+{
+	AsComponentBox *cbox;
+	AsComponentBoxPrivate *priv;
+
+	g_return_val_if_fail (source != NULL, NULL);
+
+	cbox = as_component_box_new (AS_COMPONENT_BOX_FLAG_VIEW | AS_COMPONENT_BOX_FLAG_NO_CHECKS);
+	priv = GET_PRIVATE (cbox);
+	priv->source_box = g_object_ref (source);
+
+	/* borrow the component pointers from the source box, the reference
+	 * on the box itself keeps them alive */
+	g_ptr_array_unref (cbox->cpts);
+	cbox->cpts = g_ptr_array_new ();
+	for (guint i = offset; i < source->cpts->len; i++) {
+		if (length != 0 && cbox->cpts->len >= length)
+			break;
+		g_ptr_array_add (cbox->cpts, g_ptr_array_index (source->cpts, i));
+	}
+
+	return cbox;
+}
+
 /**
  * as_component_box_index:
  * @cbox: a #AsComponentBox
@@ -281,6 +338,32 @@ as_component_box_index_safe (AsComponentBox *cbox, guint index)
 	return as_component_box_index (cbox, index);
 }
 
+/**
+ * as_component_box_sorted_insert_index:
+ *
+ * Find the position a component with the given ID should be inserted
+ * at to keep the box sorted, which is also the position of the first
+ * component with that ID if it is already present.
+ */
+static guint
+as_component_box_sorted_insert_index (AsComponentBox *cbox, const gchar *id)
+{
+	guint lo = 0;
+	guint hi = cbox->cpts->len;
+
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		AsComponent *mid_cpt = as_component_box_index (cbox, mid);
+
+		if (g_strcmp0 (as_component_get_id (mid_cpt), id) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
 /**
  * as_component_box_add:
  * @cbox: An instance of #AsComponentBox.
@@ -295,6 +378,8 @@ as_component_box_add (AsComponentBox *cbox, AsComponent *cpt, GError **error)
 {
 	AsComponentBoxPrivate *priv = GET_PRIVATE (cbox);
 
+	g_return_val_if_fail (!as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_VIEW), FALSE);
+
 	if (!as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_NO_CHECKS)) {
 		const gchar *data_id = as_component_get_data_id (cpt);
 
@@ -310,7 +395,13 @@ as_component_box_add (AsComponentBox *cbox, AsComponent *cpt, GError **error)
 		g_hash_table_insert (priv->cpt_map, (gchar *) data_id, cpt);
 	}
 
-	g_ptr_array_add (cbox->cpts, g_object_ref (cpt));
+	if (as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_SORTED)) {
+		guint pos = as_component_box_sorted_insert_index (cbox,
+								  as_component_get_id (cpt));
+		g_ptr_array_insert (cbox->cpts, (gint) pos, g_object_ref (cpt));
+	} else {
+		g_ptr_array_add (cbox->cpts, g_object_ref (cpt));
+	}
 	return TRUE;
 }
 
@@ -325,6 +416,8 @@ as_component_box_clear (AsComponentBox *cbox)
 {
 	AsComponentBoxPrivate *priv = GET_PRIVATE (cbox);
 
+	g_return_if_fail (!as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_VIEW));
+
 	g_ptr_array_set_size (cbox->cpts, 0);
 	if (priv->cpt_map != NULL)
 		g_hash_table_remove_all (priv->cpt_map);
@@ -345,6 +438,7 @@ as_component_box_remove_at (AsComponentBox *cbox, guint index)
 	AsComponentBoxPrivate *priv = GET_PRIVATE (cbox);
 	AsComponent *cpt;
 
+	g_return_if_fail (!as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_VIEW));
 	g_return_if_fail (index < cbox->cpts->len);
 
 	cpt = AS_COMPONENT (g_ptr_array_index (cbox->cpts, index));
@@ -371,6 +465,368 @@ as_component_box_remove_at (AsComponentBox *cbox, guint index)
 	g_ptr_array_remove_index (cbox->cpts, index);
 }
 
+/**
+ * as_component_box_index_of:
+ * @cbox: An instance of #AsComponentBox.
+ * @id: The component ID to look for.
+ *
+ * Find the index of the first component with the given component ID.
+ * On boxes created with %AS_COMPONENT_BOX_FLAG_SORTED this is a binary
+ * search, otherwise the components are scanned linearly.
+ *
+ * Returns: The index of the component, or -1 if it was not found.
+ *
+ * Since: 1.0.5
+ */
+gssize
+as_component_box_index_of (AsComponentBox *cbox, const gchar *id)
+{
+	AsComponentBoxPrivate *priv = GET_PRIVATE (cbox);
+
+	g_return_val_if_fail (id != NULL, -1);
+
+	if (as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_SORTED)) {
+		guint pos = as_component_box_sorted_insert_index (cbox, id);
+
+		if (pos < cbox->cpts->len &&
+		    g_strcmp0 (as_component_get_id (as_component_box_index (cbox, pos)), id) == 0)
+			return (gssize) pos;
+		return -1;
+	}
+
+	for (guint i = 0; i < cbox->cpts->len; i++) {
+		if (g_strcmp0 (as_component_get_id (as_component_box_index (cbox, i)), id) == 0)
+			return (gssize) i;
+	}
+
+	return -1;
+}
+
+/**
+ * as_component_box_merge:
+ * @cbox: An instance of #AsComponentBox.
+ * @other: the #AsComponentBox to merge into @cbox.
+ * @error: A #GError or %NULL.
+ *
+ * Add all components of @other to @cbox. If both boxes were created
+ * with %AS_COMPONENT_BOX_FLAG_SORTED, the boxes are combined in a
+ * single linear merge pass instead of per-component sorted insertion.
+ *
+ * If @cbox performs duplicate checks, components of @other which
+ * already exist in @cbox are skipped.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.0.5
+ */
+gboolean
+as_component_box_merge (AsComponentBox *cbox, AsComponentBox *other, GError **error)
+{
+	AsComponentBoxPrivate *priv = GET_PRIVATE (cbox);
+	AsComponentBoxPrivate *other_priv = GET_PRIVATE (other);
+	gboolean checks = !as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_NO_CHECKS);
+
+	g_return_val_if_fail (!as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_VIEW), FALSE);
+
+	if (as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_SORTED) &&
+	    as_flags_contains (other_priv->flags, AS_COMPONENT_BOX_FLAG_SORTED)) {
+		g_autoptr(GPtrArray) merged = NULL;
+		guint i = 0;
+		guint j = 0;
+
+		merged = g_ptr_array_new_full (cbox->cpts->len + other->cpts->len,
+					       g_object_unref);
+		while (i < cbox->cpts->len || j < other->cpts->len) {
+			AsComponent *cpt;
+
+			if (j >= other->cpts->len) {
+				cpt = as_component_box_index (cbox, i++);
+			} else if (i >= cbox->cpts->len) {
+				cpt = NULL;
+			} else {
+				AsComponent *own_cpt = as_component_box_index (cbox, i);
+				AsComponent *other_cpt = as_component_box_index (other, j);
+
+				if (g_strcmp0 (as_component_get_id (own_cpt),
+					       as_component_get_id (other_cpt)) <= 0)
+					cpt = as_component_box_index (cbox, i++);
+				else
+					cpt = NULL;
+			}
+
+			if (cpt == NULL) {
+				/* take the next component from the other box */
+				cpt = as_component_box_index (other, j++);
+				if (checks) {
+					const gchar *data_id = as_component_get_data_id (cpt);
+
+					if (g_hash_table_lookup (priv->cpt_map, data_id) != NULL)
+						continue;
+					g_hash_table_insert (priv->cpt_map,
+							     (gchar *) data_id,
+							     cpt);
+				}
+			}
+
+			g_ptr_array_add (merged, g_object_ref (cpt));
+		}
+
+		g_ptr_array_unref (cbox->cpts);
+		cbox->cpts = g_steal_pointer (&merged);
+		return TRUE;
+	}
+
+	for (guint i = 0; i < other->cpts->len; i++) {
+		AsComponent *cpt = as_component_box_index (other, i);
+
+		if (checks &&
+		    g_hash_table_lookup (priv->cpt_map, as_component_get_data_id (cpt)) != NULL)
+			continue;
+		if (!as_component_box_add (cbox, cpt, error))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * as_cpt_diff_strv_equal:
+ *
+ * Check whether two possibly-%NULL string vectors have equal contents.
+ */
+static gboolean
+as_cpt_diff_strv_equal (gchar **a, gchar **b)
+{
+	if (a == b)
+		return TRUE;
+	if (a == NULL || b == NULL)
+		return FALSE;
+	for (guint i = 0; a[i] != NULL || b[i] != NULL; i++) {
+		if (g_strcmp0 (a[i], b[i]) != 0)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * as_cpt_diff_strarray_equal:
+ *
+ * Check whether two string arrays have equal contents.
+ */
+static gboolean
+as_cpt_diff_strarray_equal (GPtrArray *a, GPtrArray *b)
+{
+	if (a->len != b->len)
+		return FALSE;
+	for (guint i = 0; i < a->len; i++) {
+		if (g_strcmp0 (g_ptr_array_index (a, i), g_ptr_array_index (b, i)) != 0)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * as_cpt_diff_changed_fields:
+ *
+ * Compare two versions of a component field-by-field and return a mask
+ * of #AsComponentDiffFlags for all fields that differ.
+ */
+static guint
+as_cpt_diff_changed_fields (AsComponent *cpt_old, AsComponent *cpt_new)
+{
+	guint mask = AS_COMPONENT_DIFF_FLAG_NONE;
+	GPtrArray *icons_old;
+	GPtrArray *icons_new;
+	AsReleaseList *rels_old;
+	AsReleaseList *rels_new;
+
+	if (g_strcmp0 (as_component_get_name (cpt_old), as_component_get_name (cpt_new)) != 0)
+		mask |= AS_COMPONENT_DIFF_FLAG_NAME;
+	if (g_strcmp0 (as_component_get_summary (cpt_old), as_component_get_summary (cpt_new)) != 0)
+		mask |= AS_COMPONENT_DIFF_FLAG_SUMMARY;
+	if (g_strcmp0 (as_component_get_description (cpt_old),
+		       as_component_get_description (cpt_new)) != 0)
+		mask |= AS_COMPONENT_DIFF_FLAG_DESCRIPTION;
+	if (!as_cpt_diff_strv_equal (as_component_get_pkgnames (cpt_old),
+				     as_component_get_pkgnames (cpt_new)))
+		mask |= AS_COMPONENT_DIFF_FLAG_PKGNAMES;
+	if (g_strcmp0 (as_component_get_project_license (cpt_old),
+		       as_component_get_project_license (cpt_new)) != 0)
+		mask |= AS_COMPONENT_DIFF_FLAG_PROJECT_LICENSE;
+	if (!as_cpt_diff_strarray_equal (as_component_get_categories (cpt_old),
+					 as_component_get_categories (cpt_new)))
+		mask |= AS_COMPONENT_DIFF_FLAG_CATEGORIES;
+
+	for (guint i = AS_URL_KIND_UNKNOWN + 1; i < AS_URL_KIND_LAST; i++) {
+		if (g_strcmp0 (as_component_get_url (cpt_old, (AsUrlKind) i),
+			       as_component_get_url (cpt_new, (AsUrlKind) i)) != 0) {
+			mask |= AS_COMPONENT_DIFF_FLAG_URLS;
+			break;
+		}
+	}
+
+	icons_old = as_component_get_icons (cpt_old);
+	icons_new = as_component_get_icons (cpt_new);
+	if (icons_old->len != icons_new->len) {
+		mask |= AS_COMPONENT_DIFF_FLAG_ICONS;
+	} else {
+		for (guint i = 0; i < icons_old->len; i++) {
+			AsIcon *icon_old = AS_ICON (g_ptr_array_index (icons_old, i));
+			AsIcon *icon_new = AS_ICON (g_ptr_array_index (icons_new, i));
+
+			if (as_icon_get_kind (icon_old) != as_icon_get_kind (icon_new) ||
+			    as_icon_get_width (icon_old) != as_icon_get_width (icon_new) ||
+			    as_icon_get_height (icon_old) != as_icon_get_height (icon_new) ||
+			    g_strcmp0 (as_icon_get_name (icon_old), as_icon_get_name (icon_new)) !=
+				0) {
+				mask |= AS_COMPONENT_DIFF_FLAG_ICONS;
+				break;
+			}
+		}
+	}
+
+	rels_old = as_component_get_releases_plain (cpt_old);
+	rels_new = as_component_get_releases_plain (cpt_new);
+	if (as_release_list_len (rels_old) != as_release_list_len (rels_new)) {
+		mask |= AS_COMPONENT_DIFF_FLAG_RELEASES;
+	} else {
+		for (guint i = 0; i < as_release_list_len (rels_old); i++) {
+			AsRelease *rel_old = as_release_list_index (rels_old, i);
+			AsRelease *rel_new = as_release_list_index (rels_new, i);
+
+			if (as_release_get_timestamp (rel_old) !=
+				as_release_get_timestamp (rel_new) ||
+			    g_strcmp0 (as_release_get_version (rel_old),
+				       as_release_get_version (rel_new)) != 0) {
+				mask |= AS_COMPONENT_DIFF_FLAG_RELEASES;
+				break;
+			}
+		}
+	}
+
+	return mask;
+}
+
+/**
+ * as_component_box_diff:
+ * @cbox_old: the old set of components.
+ * @cbox_new: the new set of components.
+ * @added: (out) (optional) (transfer full): components only present in @cbox_new.
+ * @removed: (out) (optional) (transfer full): components only present in @cbox_old.
+ * @changed: (out) (optional) (transfer full): components present in both boxes whose data differs,
+ *  in their new version.
+ * @changed_fields: (out) (optional) (transfer full) (element-type utf8 guint): map of data-ID to
+ *  an #AsComponentDiffFlags mask for every changed component.
+ *
+ * Compare two sets of components and determine which components were added,
+ * removed or changed between them. Components are matched by their data-ID.
+ *
+ * Components loaded from a cache carry a checksum of their cached content,
+ * which allows unchanged components to be skipped without comparing (or even
+ * deserializing) any of their data. Only components whose checksums differ,
+ * or which carry no checksum at all, are compared field-by-field to determine
+ * the changed-field mask. A component whose checksums differ without any of
+ * the individually tracked fields changing is reported with the
+ * %AS_COMPONENT_DIFF_FLAG_OTHER flag set.
+ *
+ * Returns: %TRUE if any difference was found.
+ *
+ * Since: 1.0.5
+ */
+gboolean
+as_component_box_diff (AsComponentBox *cbox_old,
+		       AsComponentBox *cbox_new,
+		       AsComponentBox **added,
+		       AsComponentBox **removed,
+		       AsComponentBox **changed,
+		       GHashTable **changed_fields)
+{
+	g_autoptr(GHashTable) old_by_id = NULL;
+	g_autoptr(GHashTable) new_by_id = NULL;
+	g_autoptr(AsComponentBox) added_box = NULL;
+	g_autoptr(AsComponentBox) removed_box = NULL;
+	g_autoptr(AsComponentBox) changed_box = NULL;
+	g_autoptr(GHashTable) changed_map = NULL;
+	gboolean any_change = FALSE;
+
+	g_return_val_if_fail (cbox_old != NULL, FALSE);
+	g_return_val_if_fail (cbox_new != NULL, FALSE);
+
+	added_box = as_component_box_new_simple ();
+	removed_box = as_component_box_new_simple ();
+	changed_box = as_component_box_new_simple ();
+	changed_map = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	/* index both boxes by data-ID, borrowing the ID strings from the components */
+	old_by_id = g_hash_table_new (g_str_hash, g_str_equal);
+	for (guint i = 0; i < cbox_old->cpts->len; i++) {
+		AsComponent *cpt = as_component_box_index (cbox_old, i);
+		g_hash_table_insert (old_by_id, (gchar *) as_component_get_data_id (cpt), cpt);
+	}
+	new_by_id = g_hash_table_new (g_str_hash, g_str_equal);
+	for (guint i = 0; i < cbox_new->cpts->len; i++) {
+		AsComponent *cpt = as_component_box_index (cbox_new, i);
+		g_hash_table_insert (new_by_id, (gchar *) as_component_get_data_id (cpt), cpt);
+	}
+
+	for (guint i = 0; i < cbox_new->cpts->len; i++) {
+		AsComponent *cpt_new = as_component_box_index (cbox_new, i);
+		const gchar *data_id = as_component_get_data_id (cpt_new);
+		AsComponent *cpt_old = g_hash_table_lookup (old_by_id, data_id);
+		const gchar *chk_old;
+		const gchar *chk_new;
+		guint mask;
+
+		if (cpt_old == NULL) {
+			as_component_box_add (added_box, cpt_new, NULL);
+			any_change = TRUE;
+			continue;
+		}
+
+		/* equal content checksums mean the cached data is identical,
+		 * so we can skip the component without even materializing its
+		 * lazily-loaded data */
+		chk_old = as_component_get_cache_checksum (cpt_old);
+		chk_new = as_component_get_cache_checksum (cpt_new);
+		if (chk_old != NULL && chk_new != NULL && g_strcmp0 (chk_old, chk_new) == 0)
+			continue;
+
+		mask = as_cpt_diff_changed_fields (cpt_old, cpt_new);
+		if (mask == AS_COMPONENT_DIFF_FLAG_NONE) {
+			/* the checksums differ, but no tracked field did - something
+			 * else (e.g. screenshots or relations) must have changed */
+			if (chk_old != NULL && chk_new != NULL)
+				mask = AS_COMPONENT_DIFF_FLAG_OTHER;
+			else
+				continue;
+		}
+
+		as_component_box_add (changed_box, cpt_new, NULL);
+		g_hash_table_insert (changed_map, g_strdup (data_id), GUINT_TO_POINTER (mask));
+		any_change = TRUE;
+	}
+
+	for (guint i = 0; i < cbox_old->cpts->len; i++) {
+		AsComponent *cpt_old = as_component_box_index (cbox_old, i);
+
+		if (g_hash_table_contains (new_by_id, as_component_get_data_id (cpt_old)))
+			continue;
+		as_component_box_add (removed_box, cpt_old, NULL);
+		any_change = TRUE;
+	}
+
+	if (added != NULL)
+		*added = g_steal_pointer (&added_box);
+	if (removed != NULL)
+		*removed = g_steal_pointer (&removed_box);
+	if (changed != NULL)
+		*changed = g_steal_pointer (&changed_box);
+	if (changed_fields != NULL)
+		*changed_fields = g_steal_pointer (&changed_map);
+
+	return any_change;
+}
+
 /**
  * as_sort_components_cb:
  *
@@ -406,5 +862,89 @@ as_component_box_sort (AsComponentBox *cbox)
 void
 as_component_box_sort_by_score (AsComponentBox *cbox)
 {
+	AsComponentBoxPrivate *priv = GET_PRIVATE (cbox);
+
+	/* sorting by score would break the ID-sorted invariant */
+	g_return_if_fail (!as_flags_contains (priv->flags, AS_COMPONENT_BOX_FLAG_SORTED));
+
 	as_sort_components_by_score (cbox->cpts);
 }
+
+/**
+ * as_component_box_precompute_descriptions:
+ * @cbox: An instance of #AsComponentBox.
+ * @markup_kind: the markup kind to convert the descriptions to.
+ * @offset: index of the first component to process.
+ * @length: amount of components to process, or %G_MAXUINT for all remaining.
+ *
+ * Convert and memoize the description markup of a range of components via
+ * as_component_get_description_converted(). A list view can call this for
+ * the components that are about to become visible, so scrolling never has
+ * to run the markup conversion on the UI path.
+ *
+ * Since: 1.0.5
+ */
+void
+as_component_box_precompute_descriptions (AsComponentBox *cbox,
+					  AsMarkupKind markup_kind,
+					  guint offset,
+					  guint length)
+{
+	guint end;
+
+	g_return_if_fail (markup_kind < AS_MARKUP_KIND_LAST);
+
+	if (offset >= as_component_box_len (cbox))
+		return;
+	end = (length > as_component_box_len (cbox) - offset) ? as_component_box_len (cbox)
+							      : offset + length;
+	for (guint i = offset; i < end; i++)
+		as_component_get_description_converted (as_component_box_index (cbox, i),
+							markup_kind);
+}
+
+/**
+ * as_component_box_iter_init:
+ * @iter: an uninitialized #AsComponentBoxIter
+ * @cbox: An instance of #AsComponentBox.
+ *
+ * Initialize a component box iterator and associate it with @cbox.
+ * The iterator itself does not take any references, so the component
+ * box must stay valid and unmodified while it is iterated.
+ *
+ * Since: 1.0.5
+ */
+void
+as_component_box_iter_init (AsComponentBoxIter *iter, AsComponentBox *cbox)
+{
+	AsComponentBoxRealIter *ri = (AsComponentBoxRealIter *) iter;
+
+	g_return_if_fail (iter != NULL);
+	g_return_if_fail (cbox != NULL);
+
+	ri->cbox = cbox;
+	ri->pos = 0;
+}
+
+/**
+ * as_component_box_iter_next:
+ * @iter: an initialized #AsComponentBoxIter
+ *
+ * Retrieve the component the iterator currently points at and advance
+ * the iterator by one step.
+ *
+ * Returns: (transfer none) (nullable): the next #AsComponent, or %NULL if the end was reached.
+ *
+ * Since: 1.0.5
+ */
+AsComponent *
+as_component_box_iter_next (AsComponentBoxIter *iter)
+{
+	AsComponentBoxRealIter *ri = (AsComponentBoxRealIter *) iter;
+
+	g_return_val_if_fail (iter != NULL, NULL);
+
+	if (ri->pos >= ri->cbox->cpts->len)
+		return NULL;
+	return as_component_box_index (ri->cbox, ri->pos++);
+}
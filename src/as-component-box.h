@@ -27,6 +27,7 @@
 #include <glib-object.h>
 
 #include "as-component.h"
+#include "as-utils.h"
 
 G_BEGIN_DECLS
 
@@ -60,16 +61,69 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC (AsComponentBox, g_object_unref)
  * AsComponentBoxFlags:
  * @AS_COMPONENT_BOX_FLAG_NONE:		No flags.
  * @AS_COMPONENT_BOX_FLAG_NO_CHECKS:	Only perform the most basic verification.
+ * @AS_COMPONENT_BOX_FLAG_VIEW:		This box is a read-only view on another box.
+ * @AS_COMPONENT_BOX_FLAG_SORTED:	Keep components sorted by their ID, enabling binary-search lookups.
  *
  * Flags controlling the component box behavior.
  **/
 typedef enum {
 	AS_COMPONENT_BOX_FLAG_NONE	= 0,
 	AS_COMPONENT_BOX_FLAG_NO_CHECKS = 1 << 0,
+	AS_COMPONENT_BOX_FLAG_VIEW	= 1 << 1,
+	AS_COMPONENT_BOX_FLAG_SORTED	= 1 << 2,
 } AsComponentBoxFlags;
 
+/**
+ * AsComponentDiffFlags:
+ * @AS_COMPONENT_DIFF_FLAG_NONE:		No difference.
+ * @AS_COMPONENT_DIFF_FLAG_NAME:		The component name changed.
+ * @AS_COMPONENT_DIFF_FLAG_SUMMARY:		The summary changed.
+ * @AS_COMPONENT_DIFF_FLAG_DESCRIPTION:		The long description changed.
+ * @AS_COMPONENT_DIFF_FLAG_PKGNAMES:		The package names changed.
+ * @AS_COMPONENT_DIFF_FLAG_PROJECT_LICENSE:	The project license changed.
+ * @AS_COMPONENT_DIFF_FLAG_CATEGORIES:		The categories changed.
+ * @AS_COMPONENT_DIFF_FLAG_URLS:		The web URLs changed.
+ * @AS_COMPONENT_DIFF_FLAG_ICONS:		The icons changed.
+ * @AS_COMPONENT_DIFF_FLAG_RELEASES:		The release list changed.
+ * @AS_COMPONENT_DIFF_FLAG_OTHER:		Some other component data changed.
+ *
+ * Mask of fields that differ between two versions of a component,
+ * as determined by as_component_box_diff().
+ *
+ * Since: 1.0.5
+ **/
+typedef enum {
+	AS_COMPONENT_DIFF_FLAG_NONE	       = 0,
+	AS_COMPONENT_DIFF_FLAG_NAME	       = 1 << 0,
+	AS_COMPONENT_DIFF_FLAG_SUMMARY	       = 1 << 1,
+	AS_COMPONENT_DIFF_FLAG_DESCRIPTION     = 1 << 2,
+	AS_COMPONENT_DIFF_FLAG_PKGNAMES	       = 1 << 3,
+	AS_COMPONENT_DIFF_FLAG_PROJECT_LICENSE = 1 << 4,
+	AS_COMPONENT_DIFF_FLAG_CATEGORIES      = 1 << 5,
+	AS_COMPONENT_DIFF_FLAG_URLS	       = 1 << 6,
+	AS_COMPONENT_DIFF_FLAG_ICONS	       = 1 << 7,
+	AS_COMPONENT_DIFF_FLAG_RELEASES	       = 1 << 8,
+	AS_COMPONENT_DIFF_FLAG_OTHER	       = 1 << 15,
+} AsComponentDiffFlags;
+
+/**
+ * AsComponentBoxIter:
+ *
+ * A lazy iterator over the contents of an #AsComponentBox.
+ * It can usually be allocated on the stack and does not take
+ * references on the components it walks over.
+ */
+typedef struct {
+	/*< private >*/
+	gpointer dummy1;
+	guint	 dummy2;
+	gpointer dummy3;
+	gpointer dummy4;
+} AsComponentBoxIter;
+
 AsComponentBox *as_component_box_new (AsComponentBoxFlags flags);
 AsComponentBox *as_component_box_new_simple (void);
+AsComponentBox *as_component_box_new_view (AsComponentBox *source, guint offset, guint length);
 
 #define as_component_box_index(cbox, index_) \
 	AS_COMPONENT (g_ptr_array_index ((cbox)->cpts, (index_)))
@@ -86,7 +140,27 @@ gboolean	    as_component_box_add (AsComponentBox *cbox, AsComponent *cpt, GErro
 void		    as_component_box_clear (AsComponentBox *cbox);
 void		    as_component_box_remove_at (AsComponentBox *cbox, guint index);
 
+gssize		    as_component_box_index_of (AsComponentBox *cbox, const gchar *id);
+gboolean	    as_component_box_merge (AsComponentBox *cbox,
+					    AsComponentBox *other,
+					    GError	  **error);
+
+gboolean	    as_component_box_diff (AsComponentBox  *cbox_old,
+					   AsComponentBox  *cbox_new,
+					   AsComponentBox **added,
+					   AsComponentBox **removed,
+					   AsComponentBox **changed,
+					   GHashTable	  **changed_fields);
+
 void		    as_component_box_sort (AsComponentBox *cbox);
 void		    as_component_box_sort_by_score (AsComponentBox *cbox);
 
+void		    as_component_box_precompute_descriptions (AsComponentBox *cbox,
+							      AsMarkupKind     markup_kind,
+							      guint	       offset,
+							      guint	       length);
+
+void		    as_component_box_iter_init (AsComponentBoxIter *iter, AsComponentBox *cbox);
+AsComponent	   *as_component_box_iter_next (AsComponentBoxIter *iter);
+
 G_END_DECLS
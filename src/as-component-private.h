@@ -78,7 +78,25 @@ typedef enum /*< skip >*/ __attribute__((__packed__)) {
 
 typedef guint16 AsTokenType; /* big enough for both bitshifts */
 
-void		as_component_complete (AsComponent *cpt, GPtrArray *icon_paths);
+/**
+ * AsIconDirIndex:
+ *
+ * Shared index of cached-icon directory contents, so icon names can be
+ * resolved for many components without issuing stat() calls per candidate.
+ */
+typedef struct _AsIconDirIndex AsIconDirIndex;
+
+AsIconDirIndex *as_icon_dir_index_new (void);
+void		as_icon_dir_index_free (AsIconDirIndex *idx);
+void		as_icon_dir_index_invalidate (AsIconDirIndex *idx);
+gboolean	as_icon_dir_index_has_file (AsIconDirIndex *idx,
+					    const gchar	   *dir_path,
+					    const gchar	   *fname);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (AsIconDirIndex, as_icon_dir_index_free)
+
+void		as_component_complete (AsComponent    *cpt,
+				       GPtrArray      *icon_paths,
+				       AsIconDirIndex *icon_index);
 
 AS_INTERNAL_VISIBLE
 GHashTable  *as_component_get_languages_table (AsComponent *cpt);
@@ -92,6 +110,36 @@ const gchar *as_component_get_architecture (AsComponent *cpt);
 void	     as_component_set_architecture (AsComponent *cpt, const gchar *arch);
 
 GPtrArray   *as_component_generate_tokens_for (AsComponent *cpt, AsSearchTokenMatch token_kind);
+GHashTable  *as_component_get_token_cache_table (AsComponent *cpt);
+void	     as_component_insert_token_cache_entry (AsComponent *cpt,
+						    const gchar *token,
+						    AsTokenType	 match_val);
+void	     as_component_set_token_cache_valid (AsComponent *cpt);
+
+const gchar *as_component_get_cache_checksum (AsComponent *cpt);
+void	     as_component_set_cache_checksum (AsComponent *cpt, const gchar *checksum);
+
+/**
+ * AsComponentLazyFetchFn:
+ * @cpt: the component the deferred data belongs to.
+ * @user_data: user data registered with the callback.
+ *
+ * Callback fetching heavy XML subtrees that are stored out of band.
+ * The element children of the returned node are parsed as if they had been
+ * deferred from the component's own XML node; the node is freed by the caller.
+ *
+ * Returns: (transfer full) (nullable): A node holding the deferred subtrees.
+ */
+typedef xmlNode *(*AsComponentLazyFetchFn) (AsComponent *cpt, gpointer user_data);
+
+void	     as_component_set_lazy_load (AsComponent *cpt, gboolean lazy);
+void	     as_component_set_lazy_fetch (AsComponent	       *cpt,
+					  AsContext	       *ctx,
+					  AsComponentLazyFetchFn fetch_fn,
+					  gpointer		user_data,
+					  GDestroyNotify	destroy_fn);
+void	     as_component_lazy_materialize (AsComponent *cpt);
+void	     as_component_set_bulk_load (AsComponent *cpt, gboolean bulk);
 
 void	     as_component_set_ignored (AsComponent *cpt, gboolean ignore);
 
@@ -105,7 +153,7 @@ gboolean as_component_load_from_xml (AsComponent *cpt,
 				     AsContext	 *ctx,
 				     xmlNode	 *node,
 				     GError	**error);
-xmlNode *as_component_to_xml_node (AsComponent *cpt, AsContext *ctx, xmlNode *root);
+xmlNode *as_component_to_xml_node (AsComponent *cpt, AsContext *ctx, xmlDoc *doc, xmlNode *root);
 
 gboolean as_component_load_from_yaml (AsComponent *cpt,
 				      AsContext	  *ctx,
@@ -113,6 +161,8 @@ gboolean as_component_load_from_yaml (AsComponent *cpt,
 				      GError	 **error);
 void	 as_component_emit_yaml (AsComponent *cpt, AsContext *ctx, yaml_emitter_t *emitter);
 
+void	 as_component_make_implicit_relations_explicit (AsComponent *cpt);
+
 AS_END_PRIVATE_DECLS
 
 #endif /* __AS_COMPONENT_PRIVATE_H */
@@ -23,12 +23,14 @@
 
 #include <glib.h>
 #include <glib-object.h>
+#include <glib/gstdio.h>
 
 #include "as-utils.h"
 #include "as-utils-private.h"
 #include "as-stemmer.h"
 #include "as-spdx.h"
 
+#include "as-category-private.h"
 #include "as-context-private.h"
 #include "as-icon-private.h"
 #include "as-screenshot-private.h"
@@ -74,6 +76,7 @@ typedef struct {
 
 	gchar *id;
 	gchar *data_id;
+	gchar *cache_checksum; /* content checksum recorded when caching, for fast diffing */
 	gchar **pkgnames;
 	gchar *source_pkgname;
 	GRefString *origin;
@@ -82,8 +85,14 @@ typedef struct {
 	GHashTable *name;	 /* localized entry */
 	GHashTable *summary;	 /* localized entry */
 	GHashTable *description; /* localized entry */
+	guint l10n_shared;	 /* tables shared with another component (copy-on-write) */
+	guint arrays_shared;	 /* object arrays shared with another component (copy-on-write) */
 	GHashTable *keywords;	 /* localized entry, value:strv */
 
+	/* memoized conversions of the active description markup */
+	gchar *desc_conv_src;			 /* copy of the markup the cached conversions were made of */
+	gchar *desc_conv[AS_MARKUP_KIND_LAST];	 /* cached conversion per target markup kind */
+
 	GRefString *metadata_license;
 	GRefString *project_license;
 	GRefString *project_group;
@@ -123,6 +132,21 @@ typedef struct {
 	gsize token_cache_valid;
 	GHashTable *token_cache; /* of RefString:AsTokenType* */
 
+	/* packed, sorted token index derived from token_cache for fast search scoring */
+	gsize token_idx_valid;
+	gchar *token_idx_blob;	    /* all tokens, NUL-separated, in sorted order */
+	guint32 *token_idx_offsets; /* per-token start offset into the blob */
+	AsTokenType *token_idx_vals;
+	guint token_idx_len;
+
+	gboolean lazy_load;    /* defer deserialization of heavy XML subtrees */
+	GPtrArray *lazy_nodes; /* of xmlNode, deferred subtrees */
+	AsContext *lazy_ctx;   /* the context the deferred subtrees belong to */
+	AsComponentLazyFetchFn lazy_fetch_fn; /* fetches deferred subtrees stored elsewhere */
+	gpointer lazy_fetch_udata;
+	GDestroyNotify lazy_fetch_udata_free;
+	gboolean bulk_load;    /* suppress property notifications during bulk deserialization */
+
 	gboolean ignored; /* whether we should ignore this component */
 
 	GPtrArray *tags;
@@ -148,9 +172,33 @@ enum {
 	AS_COMPONENT_CATEGORIES,
 	AS_COMPONENT_PROJECT_LICENSE,
 	AS_COMPONENT_PROJECT_GROUP,
-	AS_COMPONENT_SCREENSHOTS
+	AS_COMPONENT_SCREENSHOTS,
+	AS_COMPONENT_N_PROPERTIES
+};
+
+static GParamSpec *obj_properties[AS_COMPONENT_N_PROPERTIES] = {
+	NULL,
 };
 
+/**
+ * as_component_notify:
+ *
+ * Emit a property change notification by its ID, bypassing the
+ * name-based pspec lookup. Notifications are suppressed entirely while
+ * the component is bulk-loaded from a cache: deserialization never has
+ * property listeners, and even no-op emissions add up over a
+ * many-thousand-component load.
+ */
+static void
+as_component_notify (AsComponent *cpt, guint property_id)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+
+	if (priv->bulk_load)
+		return;
+	g_object_notify_by_pspec (G_OBJECT (cpt), obj_properties[property_id]);
+}
+
 /**
  * as_component_kind_to_string:
  * @kind: the #AsComponentKind.
@@ -423,8 +471,10 @@ as_component_init (AsComponent *cpt)
 	/* lists */
 	priv->releases = as_release_list_new ();
 	priv->launchables = g_ptr_array_new_with_free_func (g_object_unref);
-	priv->categories = g_ptr_array_new_with_free_func (g_free);
-	priv->compulsory_for_desktops = g_ptr_array_new_with_free_func (g_free);
+	priv->categories = g_ptr_array_new_with_free_func (
+	    (GDestroyNotify) as_ref_string_release);
+	priv->compulsory_for_desktops = g_ptr_array_new_with_free_func (
+	    (GDestroyNotify) as_ref_string_release);
 	priv->screenshots = g_ptr_array_new_with_free_func (g_object_unref);
 	priv->provided = g_ptr_array_new_with_free_func (g_object_unref);
 	priv->bundles = g_ptr_array_new_with_free_func (g_object_unref);
@@ -468,6 +518,7 @@ as_component_finalize (GObject *object)
 
 	g_free (priv->id);
 	g_free (priv->data_id);
+	g_free (priv->cache_checksum);
 	g_free (priv->date_eol);
 	g_free (priv->source_pkgname);
 	g_strfreev (priv->pkgnames);
@@ -522,7 +573,21 @@ as_component_finalize (GObject *object)
 	if (priv->name_variant_suffix != NULL)
 		g_hash_table_unref (priv->name_variant_suffix);
 
+	for (guint i = 0; i < AS_MARKUP_KIND_LAST; i++)
+		g_free (priv->desc_conv[i]);
+	g_free (priv->desc_conv_src);
+
 	g_hash_table_unref (priv->token_cache);
+	g_free (priv->token_idx_blob);
+	g_free (priv->token_idx_offsets);
+	g_free (priv->token_idx_vals);
+
+	if (priv->lazy_nodes != NULL)
+		g_ptr_array_unref (priv->lazy_nodes);
+	if (priv->lazy_ctx != NULL)
+		g_object_unref (priv->lazy_ctx);
+	if (priv->lazy_fetch_udata_free != NULL)
+		priv->lazy_fetch_udata_free (priv->lazy_fetch_udata);
 
 	if (priv->context != NULL)
 		g_object_unref (priv->context);
@@ -623,6 +688,7 @@ as_component_add_screenshot (AsComponent *cpt, AsScreenshot *sshot)
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 	g_return_if_fail (sshot != NULL);
 
+	as_component_lazy_materialize (cpt);
 	g_ptr_array_add (priv->screenshots, g_object_ref (sshot));
 }
 
@@ -639,6 +705,7 @@ AsReleaseList *
 as_component_get_releases_plain (AsComponent *cpt)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	as_component_lazy_materialize (cpt);
 	return priv->releases;
 }
 
@@ -656,6 +723,7 @@ as_component_load_releases (AsComponent *cpt, gboolean allow_net, GError **error
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 
+	as_component_lazy_materialize (cpt);
 	if (!as_release_list_load (priv->releases, cpt, FALSE, allow_net, error))
 		return NULL;
 	return priv->releases;
@@ -673,6 +741,7 @@ void
 as_component_set_releases (AsComponent *cpt, AsReleaseList *releases)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	as_component_lazy_materialize (cpt);
 	g_object_unref (priv->releases);
 	priv->releases = g_object_ref (releases);
 }
@@ -688,6 +757,7 @@ void
 as_component_add_release (AsComponent *cpt, AsRelease *release)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	as_component_lazy_materialize (cpt);
 	as_release_list_add (priv->releases, release);
 }
 
@@ -959,7 +1029,7 @@ as_component_set_kind (AsComponent *cpt, AsComponentKind value)
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 
 	priv->kind = value;
-	g_object_notify ((GObject *) cpt, "kind");
+	as_component_notify (cpt, AS_COMPONENT_KIND);
 }
 
 /**
@@ -1098,7 +1168,7 @@ as_component_set_pkgnames (AsComponent *cpt, gchar **packages)
 
 	g_strfreev (priv->pkgnames);
 	priv->pkgnames = g_strdupv (packages);
-	g_object_notify ((GObject *) cpt, "pkgnames");
+	as_component_notify (cpt, AS_COMPONENT_PKGNAMES);
 }
 
 /**
@@ -1117,7 +1187,7 @@ as_component_set_pkgname (AsComponent *cpt, const gchar *pkgname)
 	g_strfreev (priv->pkgnames);
 	priv->pkgnames = g_new0 (gchar *, 2);
 	priv->pkgnames[0] = g_strdup (pkgname);
-	g_object_notify ((GObject *) cpt, "pkgnames");
+	as_component_notify (cpt, AS_COMPONENT_PKGNAMES);
 }
 
 /**
@@ -1178,7 +1248,7 @@ as_component_set_id (AsComponent *cpt, const gchar *value)
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 
 	as_assign_string_safe (priv->id, value);
-	g_object_notify ((GObject *) cpt, "id");
+	as_component_notify (cpt, AS_COMPONENT_ID);
 	as_component_invalidate_data_id (cpt);
 }
 
@@ -1325,6 +1395,10 @@ as_component_set_architecture (AsComponent *cpt, const gchar *arch)
  * entities that use the same context as well!
  * This function is just a convenience method, and does not replace
  * proper #AsContext management.
+ *
+ * If the associated context was sealed for concurrent sharing, the
+ * component receives its own mutable copy of it instead, leaving the
+ * other users of the sealed context untouched.
  */
 void
 as_component_set_context_locale (AsComponent *cpt, const gchar *locale)
@@ -1334,6 +1408,12 @@ as_component_set_context_locale (AsComponent *cpt, const gchar *locale)
 	if (priv->context == NULL) {
 		priv->context = as_context_new ();
 		as_context_set_origin (priv->context, priv->origin);
+	} else if (as_context_is_sealed (priv->context)) {
+		/* never modify a sealed context - it may be shared with other
+		 * threads without locking, so swap in a private copy instead */
+		AsContext *fresh = as_context_clone_unsealed (priv->context);
+		g_object_unref (priv->context);
+		priv->context = fresh;
 	}
 	as_context_set_locale (priv->context, locale);
 }
@@ -1366,6 +1446,195 @@ as_component_get_active_locale (AsComponent *cpt)
 		return locale;
 }
 
+/* localized string tables that may be shared with another component after a merge */
+typedef enum {
+	AS_COMPONENT_L10N_SHARED_NAME	     = 1 << 0,
+	AS_COMPONENT_L10N_SHARED_SUMMARY     = 1 << 1,
+	AS_COMPONENT_L10N_SHARED_DESCRIPTION = 1 << 2,
+} AsComponentL10nShared;
+
+/**
+ * as_component_l10n_table_ptr:
+ *
+ * Resolve the location of the localized string table selected by @flag.
+ */
+static GHashTable **
+as_component_l10n_table_ptr (AsComponentPrivate *priv, AsComponentL10nShared flag)
+{
+	if (flag == AS_COMPONENT_L10N_SHARED_NAME)
+		return &priv->name;
+	if (flag == AS_COMPONENT_L10N_SHARED_SUMMARY)
+		return &priv->summary;
+	return &priv->description;
+}
+
+/**
+ * as_component_l10n_table_writable:
+ *
+ * Get the localized string table selected by @flag in a state that is safe
+ * to modify. After a merge, these tables may be shared with another
+ * component (copy-on-write), in which case we swap in a private deep copy
+ * before the write happens.
+ *
+ * Returns: (transfer none): The writable table.
+ */
+static GHashTable *
+as_component_l10n_table_writable (AsComponent *cpt, AsComponentL10nShared flag)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	GHashTable **table = as_component_l10n_table_ptr (priv, flag);
+	GHashTable *copy;
+	GHashTableIter iter;
+	gpointer key, value;
+
+	if ((priv->l10n_shared & flag) == 0)
+		return *table;
+
+	copy = g_hash_table_new_full (g_str_hash,
+				      g_str_equal,
+				      (GDestroyNotify) as_ref_string_release,
+				      g_free);
+	g_hash_table_iter_init (&iter, *table);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+		g_hash_table_insert (copy, g_ref_string_acquire (key), g_strdup (value));
+
+	g_hash_table_unref (*table);
+	*table = copy;
+	priv->l10n_shared &= ~flag;
+	return *table;
+}
+
+/**
+ * as_component_l10n_table_clear:
+ *
+ * Remove all entries from the localized string table selected by @flag.
+ * A shared table is simply dropped and replaced with a fresh one, without
+ * copying any data first.
+ */
+static void
+as_component_l10n_table_clear (AsComponent *cpt, AsComponentL10nShared flag)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	GHashTable **table = as_component_l10n_table_ptr (priv, flag);
+
+	if ((priv->l10n_shared & flag) == 0) {
+		g_hash_table_remove_all (*table);
+		return;
+	}
+
+	g_hash_table_unref (*table);
+	*table = g_hash_table_new_full (g_str_hash,
+					g_str_equal,
+					(GDestroyNotify) as_ref_string_release,
+					g_free);
+	priv->l10n_shared &= ~flag;
+}
+
+/**
+ * as_component_l10n_table_share:
+ *
+ * Let @dest_cpt use the localized string table of @src_cpt directly instead
+ * of deep-copying it, marking the table as shared in both components so
+ * either side makes a private copy before modifying it (copy-on-write).
+ * Tables with no entries are not shared, keeping the destination data.
+ */
+static void
+as_component_l10n_table_share (AsComponent *dest_cpt,
+			       AsComponent *src_cpt,
+			       AsComponentL10nShared flag)
+{
+	AsComponentPrivate *dest_priv = GET_PRIVATE (dest_cpt);
+	AsComponentPrivate *src_priv = GET_PRIVATE (src_cpt);
+	GHashTable **dest_table = as_component_l10n_table_ptr (dest_priv, flag);
+	GHashTable **src_table = as_component_l10n_table_ptr (src_priv, flag);
+
+	/* don't share if there is nothing to share */
+	if (g_hash_table_size (*src_table) <= 0)
+		return;
+
+	g_hash_table_unref (*dest_table);
+	*dest_table = g_hash_table_ref (*src_table);
+	dest_priv->l10n_shared |= flag;
+	src_priv->l10n_shared |= flag;
+}
+
+/* object arrays that may be shared with another component after a merge */
+typedef enum {
+	AS_COMPONENT_ARRAY_SHARED_ICONS	   = 1 << 0,
+	AS_COMPONENT_ARRAY_SHARED_PROVIDED = 1 << 1,
+} AsComponentArrayShared;
+
+/**
+ * as_component_array_ptr:
+ *
+ * Resolve the location of the object array selected by @flag.
+ */
+static GPtrArray **
+as_component_array_ptr (AsComponentPrivate *priv, AsComponentArrayShared flag)
+{
+	if (flag == AS_COMPONENT_ARRAY_SHARED_ICONS)
+		return &priv->icons;
+	return &priv->provided;
+}
+
+/**
+ * as_component_array_writable:
+ *
+ * Get the object array selected by @flag in a state that is safe to modify.
+ * After a merge, these arrays may be shared with another component
+ * (copy-on-write), in which case we swap in a private copy of the object
+ * references before the write happens.
+ *
+ * Returns: (transfer none): The writable array.
+ */
+static GPtrArray *
+as_component_array_writable (AsComponent *cpt, AsComponentArrayShared flag)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	GPtrArray **array = as_component_array_ptr (priv, flag);
+	GPtrArray *copy;
+
+	if ((priv->arrays_shared & flag) == 0)
+		return *array;
+
+	copy = g_ptr_array_new_full ((*array)->len, g_object_unref);
+	for (guint i = 0; i < (*array)->len; i++)
+		g_ptr_array_add (copy, g_object_ref (g_ptr_array_index (*array, i)));
+
+	g_ptr_array_unref (*array);
+	*array = copy;
+	priv->arrays_shared &= ~flag;
+	return *array;
+}
+
+/**
+ * as_component_array_share:
+ *
+ * Let @dest_cpt use the object array of @src_cpt directly instead of
+ * copying all its entries, marking the array as shared in both components
+ * so either side makes a private copy before modifying it (copy-on-write).
+ * Arrays with no entries are not shared, keeping the destination data.
+ */
+static void
+as_component_array_share (AsComponent *dest_cpt,
+			  AsComponent *src_cpt,
+			  AsComponentArrayShared flag)
+{
+	AsComponentPrivate *dest_priv = GET_PRIVATE (dest_cpt);
+	AsComponentPrivate *src_priv = GET_PRIVATE (src_cpt);
+	GPtrArray **dest_array = as_component_array_ptr (dest_priv, flag);
+	GPtrArray **src_array = as_component_array_ptr (src_priv, flag);
+
+	/* don't share if there is nothing to share */
+	if ((*src_array)->len <= 0)
+		return;
+
+	g_ptr_array_unref (*dest_array);
+	*dest_array = g_ptr_array_ref (*src_array);
+	dest_priv->arrays_shared |= flag;
+	src_priv->arrays_shared |= flag;
+}
+
 /**
  * as_component_get_name:
  * @cpt: a #AsComponent instance.
@@ -1394,8 +1663,12 @@ as_component_set_name (AsComponent *cpt, const gchar *value, const gchar *locale
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 
-	as_context_localized_ht_set (priv->context, priv->name, value, locale);
-	g_object_notify ((GObject *) cpt, "name");
+	as_context_localized_ht_set (
+	    priv->context,
+	    as_component_l10n_table_writable (cpt, AS_COMPONENT_L10N_SHARED_NAME),
+	    value,
+	    locale);
+	as_component_notify (cpt, AS_COMPONENT_NAME);
 }
 
 /**
@@ -1428,8 +1701,12 @@ as_component_set_summary (AsComponent *cpt, const gchar *value, const gchar *loc
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 
-	as_context_localized_ht_set (priv->context, priv->summary, value, locale);
-	g_object_notify ((GObject *) cpt, "summary");
+	as_context_localized_ht_set (
+	    priv->context,
+	    as_component_l10n_table_writable (cpt, AS_COMPONENT_L10N_SHARED_SUMMARY),
+	    value,
+	    locale);
+	as_component_notify (cpt, AS_COMPONENT_SUMMARY);
 }
 
 /**
@@ -1444,11 +1721,93 @@ const gchar *
 as_component_get_description (AsComponent *cpt)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	as_component_lazy_materialize (cpt);
 	return as_context_localized_ht_get (priv->context,
 					    priv->description,
 					    NULL /* locale override */);
 }
 
+/**
+ * as_component_get_description_bytes:
+ * @cpt: a #AsComponent instance.
+ *
+ * Get the localized long description of this component as a #GBytes view
+ * of the internal storage, without copying the string data.
+ * This is useful when large amounts of description data need to be hashed
+ * or serialized, e.g. when indexing a whole metadata catalog.
+ *
+ * The returned #GBytes holds a reference on the component, but the view
+ * becomes invalid as soon as the description is modified or the component
+ * is reloaded, e.g. because its metadata pool has refreshed its contents.
+ * Borrow the data only for immediate consumption and do not retain it
+ * across pool generations.
+ *
+ * Returns: (transfer full) (nullable): the description data, or %NULL if no description exists.
+ *
+ * Since: 1.0.5
+ */
+GBytes *
+as_component_get_description_bytes (AsComponent *cpt)
+{
+	const gchar *value = as_component_get_description (cpt);
+	if (value == NULL)
+		return NULL;
+	return g_bytes_new_with_free_func (value,
+					   strlen (value),
+					   g_object_unref,
+					   g_object_ref (cpt));
+}
+
+/**
+ * as_component_get_description_converted:
+ * @cpt: a #AsComponent instance.
+ * @markup_kind: the markup kind to convert the description to, e.g. %AS_MARKUP_KIND_TEXT.
+ *
+ * Get the localized long description of this component, converted to the
+ * selected markup kind via as_markup_convert().
+ * The converted form is computed lazily and memoized on the component, so
+ * repeated calls - e.g. from a list view rendering the same components on
+ * every scroll - do not re-run the markup conversion.
+ *
+ * Returns: (nullable): the converted description, owned by the component,
+ *   or %NULL if no description exists or the conversion failed.
+ *
+ * Since: 1.0.5
+ */
+const gchar *
+as_component_get_description_converted (AsComponent *cpt, AsMarkupKind markup_kind)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	const gchar *desc;
+
+	g_return_val_if_fail (markup_kind < AS_MARKUP_KIND_LAST, NULL);
+
+	desc = as_component_get_description (cpt);
+	if (desc == NULL || markup_kind == AS_MARKUP_KIND_XML)
+		return desc;
+
+	/* drop stale conversions if the active description markup has changed,
+	 * e.g. because the description was updated or the locale switched - we
+	 * compare a retained copy of the source text, as a pointer comparison
+	 * could be fooled by the allocator reusing the old string's address */
+	if (g_strcmp0 (priv->desc_conv_src, desc) != 0) {
+		for (guint i = 0; i < AS_MARKUP_KIND_LAST; i++)
+			g_clear_pointer (&priv->desc_conv[i], g_free);
+		as_assign_string_safe (priv->desc_conv_src, desc);
+	}
+
+	if (priv->desc_conv[markup_kind] == NULL) {
+		priv->desc_conv[markup_kind] = as_markup_convert (desc, markup_kind, NULL);
+		/* memoize the failure as well, so broken markup is not reconverted */
+		if (priv->desc_conv[markup_kind] == NULL)
+			priv->desc_conv[markup_kind] = g_strdup ("");
+	}
+
+	if (priv->desc_conv[markup_kind][0] == '\0')
+		return NULL;
+	return priv->desc_conv[markup_kind];
+}
+
 /**
  * as_component_set_description:
  * @cpt: A valid #AsComponent
@@ -1462,8 +1821,13 @@ as_component_set_description (AsComponent *cpt, const gchar *value, const gchar
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 
-	as_context_localized_ht_set (priv->context, priv->description, value, locale);
-	g_object_notify ((GObject *) cpt, "description");
+	as_component_lazy_materialize (cpt);
+	as_context_localized_ht_set (
+	    priv->context,
+	    as_component_l10n_table_writable (cpt, AS_COMPONENT_L10N_SHARED_DESCRIPTION),
+	    value,
+	    locale);
+	as_component_notify (cpt, AS_COMPONENT_DESCRIPTION);
 }
 
 /**
@@ -1547,7 +1911,7 @@ as_component_set_keywords (AsComponent *cpt,
 	g_hash_table_insert (priv->keywords,
 			     g_ref_string_new_intern (locale),
 			     g_steal_pointer (&keywords));
-	g_object_notify ((GObject *) cpt, "keywords");
+	as_component_notify (cpt, AS_COMPONENT_KEYWORDS);
 }
 
 /**
@@ -1598,7 +1962,7 @@ as_component_clear_keywords (AsComponent *cpt, const gchar *locale)
 		locale = as_component_get_active_locale (cpt);
 
 	g_hash_table_remove (priv->keywords, locale);
-	g_object_notify ((GObject *) cpt, "keywords");
+	as_component_notify (cpt, AS_COMPONENT_KEYWORDS);
 }
 
 /**
@@ -1610,8 +1974,9 @@ as_component_clear_keywords (AsComponent *cpt, const gchar *locale)
 GPtrArray *
 as_component_get_icons (AsComponent *cpt)
 {
-	AsComponentPrivate *priv = GET_PRIVATE (cpt);
-	return priv->icons;
+	/* the array may be shared with another component after a merge, and
+	 * callers are allowed to modify it through this pointer - so unshare it */
+	return as_component_array_writable (cpt, AS_COMPONENT_ARRAY_SHARED_ICONS);
 }
 
 /**
@@ -1684,8 +2049,8 @@ as_component_get_icon_stock (AsComponent *cpt)
 void
 as_component_add_icon (AsComponent *cpt, AsIcon *icon)
 {
-	AsComponentPrivate *priv = GET_PRIVATE (cpt);
-	g_ptr_array_add (priv->icons, g_object_ref (icon));
+	g_ptr_array_add (as_component_array_writable (cpt, AS_COMPONENT_ARRAY_SHARED_ICONS),
+			 g_object_ref (icon));
 }
 
 /**
@@ -1718,7 +2083,8 @@ as_component_add_category (AsComponent *cpt, const gchar *category)
 		if (as_ptr_array_find_string (priv->categories, category) != NULL)
 			return;
 	}
-	g_ptr_array_add (priv->categories, g_strdup (category));
+	/* category names repeat across most components, so intern them */
+	g_ptr_array_add (priv->categories, g_ref_string_new_intern (category));
 }
 
 /**
@@ -1793,7 +2159,7 @@ as_component_set_project_license (AsComponent *cpt, const gchar *value)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 	as_ref_string_assign_safe (&priv->project_license, value);
-	g_object_notify ((GObject *) cpt, "project-license");
+	as_component_notify (cpt, AS_COMPONENT_PROJECT_LICENSE);
 }
 
 /**
@@ -2094,6 +2460,7 @@ GPtrArray *
 as_component_get_screenshots_all (AsComponent *cpt)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	as_component_lazy_materialize (cpt);
 	return priv->screenshots;
 }
 
@@ -2164,6 +2531,7 @@ as_component_sort_screenshots (AsComponent *cpt,
 	g_autofree gchar *env_id = NULL;
 	AsScreenshotSortHelper helper;
 
+	as_component_lazy_materialize (cpt);
 	if (priv->screenshots == 0)
 		return;
 
@@ -2232,7 +2600,7 @@ as_component_set_compulsory_for_desktop (AsComponent *cpt, const gchar *desktop)
 		if (as_ptr_array_find_string (priv->compulsory_for_desktops, desktop) != NULL)
 			return;
 	}
-	g_ptr_array_add (priv->compulsory_for_desktops, g_strdup (desktop));
+	g_ptr_array_add (priv->compulsory_for_desktops, g_ref_string_new_intern (desktop));
 }
 
 /**
@@ -2286,8 +2654,9 @@ as_component_get_provided_for_kind (AsComponent *cpt, AsProvidedKind kind)
 GPtrArray *
 as_component_get_provided (AsComponent *cpt)
 {
-	AsComponentPrivate *priv = GET_PRIVATE (cpt);
-	return priv->provided;
+	/* the array may be shared with another component after a merge, and
+	 * callers are allowed to modify it through this pointer - so unshare it */
+	return as_component_array_writable (cpt, AS_COMPONENT_ARRAY_SHARED_PROVIDED);
 }
 
 /**
@@ -2302,23 +2671,24 @@ as_component_get_provided (AsComponent *cpt)
 void
 as_component_add_provided (AsComponent *cpt, AsProvided *prov)
 {
-	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	GPtrArray *provided;
 	g_return_if_fail (prov != NULL);
 
+	provided = as_component_array_writable (cpt, AS_COMPONENT_ARRAY_SHARED_PROVIDED);
 	if (as_component_check_value_flags (cpt, AS_VALUE_FLAG_DUPLICATE_CHECK)) {
 		guint i;
-		for (i = 0; i < priv->provided->len; i++) {
-			AsProvided *eprov = AS_PROVIDED (g_ptr_array_index (priv->provided, i));
+		for (i = 0; i < provided->len; i++) {
+			AsProvided *eprov = AS_PROVIDED (g_ptr_array_index (provided, i));
 			if (as_provided_get_kind (prov) == as_provided_get_kind (eprov)) {
 				/* replace existing entry */
-				g_ptr_array_remove_index (priv->provided, i);
-				g_ptr_array_add (priv->provided, g_object_ref (prov));
+				g_ptr_array_remove_index (provided, i);
+				g_ptr_array_add (provided, g_object_ref (prov));
 				return;
 			}
 		}
 	}
 
-	g_ptr_array_add (priv->provided, g_object_ref (prov));
+	g_ptr_array_add (provided, g_object_ref (prov));
 }
 
 /**
@@ -2334,7 +2704,6 @@ void
 as_component_add_provided_item (AsComponent *cpt, AsProvidedKind kind, const gchar *item)
 {
 	AsProvided *prov;
-	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 
 	/* we just skip empty items */
 	if (as_is_empty (item))
@@ -2344,7 +2713,9 @@ as_component_add_provided_item (AsComponent *cpt, AsProvidedKind kind, const gch
 	if (prov == NULL) {
 		prov = as_provided_new ();
 		as_provided_set_kind (prov, kind);
-		g_ptr_array_add (priv->provided, prov);
+		g_ptr_array_add (as_component_array_writable (cpt,
+							      AS_COMPONENT_ARRAY_SHARED_PROVIDED),
+				 prov);
 	}
 
 	as_provided_add_item (prov, item);
@@ -2715,6 +3086,177 @@ as_component_set_origin_kind (AsComponent *cpt, AsOriginKind okind)
 	priv->origin_kind = okind;
 }
 
+typedef struct {
+	GHashTable *files; /* set of filenames found in the directory, NULL if it did not exist */
+	gint64 mtime;	   /* modification time of the directory when it was last scanned */
+	guint generation;  /* index generation this entry was last validated for */
+} AsIconDirEntry;
+
+/**
+ * AsIconDirIndex:
+ *
+ * Caches the contents of cached-icon directories, so resolving icon names
+ * for many components needs only one directory enumeration per directory
+ * instead of a series of stat() calls per icon candidate.
+ */
+struct _AsIconDirIndex {
+	GMutex mutex;
+	GHashTable *dirs; /* dir path → AsIconDirEntry */
+	guint generation;
+};
+
+static void
+as_icon_dir_entry_free (AsIconDirEntry *entry)
+{
+	if (entry->files != NULL)
+		g_hash_table_unref (entry->files);
+	g_free (entry);
+}
+
+/**
+ * as_icon_dir_index_new:
+ *
+ * Create a new, empty icon directory index.
+ *
+ * INTERNAL
+ */
+AsIconDirIndex *
+as_icon_dir_index_new (void)
+{
+	AsIconDirIndex *idx;
+	idx = g_new0 (AsIconDirIndex, 1);
+
+	g_mutex_init (&idx->mutex);
+	idx->dirs = g_hash_table_new_full (g_str_hash,
+					   g_str_equal,
+					   g_free,
+					   (GDestroyNotify) as_icon_dir_entry_free);
+	idx->generation = 1;
+
+	return idx;
+}
+
+/**
+ * as_icon_dir_index_free:
+ *
+ * INTERNAL
+ */
+void
+as_icon_dir_index_free (AsIconDirIndex *idx)
+{
+	g_hash_table_unref (idx->dirs);
+	g_mutex_clear (&idx->mutex);
+	g_free (idx);
+}
+
+/**
+ * as_icon_dir_index_invalidate:
+ *
+ * Mark all cached directory listings as stale. They will be revalidated
+ * against the on-disk modification time on next access, and only rescanned
+ * if the directory has actually changed.
+ *
+ * INTERNAL
+ */
+void
+as_icon_dir_index_invalidate (AsIconDirIndex *idx)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&idx->mutex);
+	idx->generation++;
+}
+
+/**
+ * as_icon_dir_index_ensure_dir:
+ *
+ * Fetch the (possibly cached) listing of the given directory, scanning or
+ * rescanning it if necessary. Must be called with the index mutex held.
+ */
+static AsIconDirEntry *
+as_icon_dir_index_ensure_dir (AsIconDirIndex *idx, const gchar *dir_path)
+{
+	AsIconDirEntry *entry;
+	GStatBuf sbuf;
+	gint64 mtime = -1;
+
+	entry = g_hash_table_lookup (idx->dirs, dir_path);
+	if (entry != NULL && entry->generation == idx->generation)
+		return entry;
+
+	/* only revalidate the cached listing if the directory was actually modified */
+	if (g_stat (dir_path, &sbuf) == 0)
+		mtime = (gint64) sbuf.st_mtime;
+
+	if (entry != NULL && entry->mtime == mtime) {
+		entry->generation = idx->generation;
+		return entry;
+	}
+
+	if (entry == NULL) {
+		entry = g_new0 (AsIconDirEntry, 1);
+		g_hash_table_insert (idx->dirs, g_strdup (dir_path), entry);
+	}
+
+	g_clear_pointer (&entry->files, g_hash_table_unref);
+	entry->mtime = mtime;
+	entry->generation = idx->generation;
+
+	if (mtime >= 0) {
+		GDir *dir;
+		const gchar *fname;
+
+		dir = g_dir_open (dir_path, 0, NULL);
+		if (dir != NULL) {
+			entry->files = g_hash_table_new_full (g_str_hash,
+							      g_str_equal,
+							      g_free,
+							      NULL);
+			while ((fname = g_dir_read_name (dir)) != NULL)
+				g_hash_table_add (entry->files, g_strdup (fname));
+			g_dir_close (dir);
+		}
+	}
+
+	return entry;
+}
+
+/**
+ * as_icon_dir_index_has_file:
+ *
+ * Check whether the given directory contains a file of the given name,
+ * using the cached directory listing.
+ *
+ * INTERNAL
+ */
+gboolean
+as_icon_dir_index_has_file (AsIconDirIndex *idx, const gchar *dir_path, const gchar *fname)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&idx->mutex);
+	AsIconDirEntry *entry;
+
+	entry = as_icon_dir_index_ensure_dir (idx, dir_path);
+	return entry->files != NULL && g_hash_table_contains (entry->files, fname);
+}
+
+/**
+ * as_component_icon_file_exists:
+ *
+ * Check for the existence of an icon file, using the directory index if
+ * one was provided and testing the filesystem directly otherwise.
+ */
+static gboolean
+as_component_icon_file_exists (AsIconDirIndex *icon_index,
+			       const gchar *dir_path,
+			       const gchar *fname)
+{
+	g_autofree gchar *full_path = NULL;
+
+	if (icon_index != NULL)
+		return as_icon_dir_index_has_file (icon_index, dir_path, fname);
+
+	full_path = g_strconcat (dir_path, "/", fname, NULL);
+	return g_file_test (full_path, G_FILE_TEST_EXISTS);
+}
+
 /**
  * as_component_add_icon_full:
  *
@@ -2754,7 +3296,7 @@ as_component_add_icon_full (AsComponent *cpt,
  * a component are properly set, by finding the icons in default directories.
  */
 static void
-as_component_refine_icons (AsComponent *cpt, GPtrArray *icon_paths)
+as_component_refine_icons (AsComponent *cpt, GPtrArray *icon_paths, AsIconDirIndex *icon_index)
 {
 	const gchar *extensions[] = { "png", "svg", "svgz", "gif", "ico", "xcf", NULL };
 	const gchar *sizes[] = { "", "64x64", "128x128", NULL };
@@ -2770,6 +3312,7 @@ as_component_refine_icons (AsComponent *cpt, GPtrArray *icon_paths)
 	/* take control of the old icon list and rewrite it */
 	icons = priv->icons;
 	priv->icons = g_ptr_array_new_with_free_func (g_object_unref);
+	priv->arrays_shared &= ~AS_COMPONENT_ARRAY_SHARED_ICONS;
 
 	origin = as_component_get_origin (cpt);
 
@@ -2818,31 +3361,36 @@ as_component_refine_icons (AsComponent *cpt, GPtrArray *icon_paths)
 		/* skip the full cache search if we already have size information */
 		if ((ikind == AS_ICON_KIND_CACHED) && (as_icon_get_width (icon) > 0)) {
 			for (l = 0; l < icon_paths->len; l++) {
-				g_autofree gchar *tmp_icon_path_wh = NULL;
+				g_autofree gchar *icon_dir_wh = NULL;
 				const gchar *icon_path = (const gchar *) g_ptr_array_index (
 				    icon_paths,
 				    l);
 
 				if (as_icon_get_scale (icon) <= 1) {
-					tmp_icon_path_wh = g_strdup_printf (
-					    "%s/%s/%ix%i/%s",
+					icon_dir_wh = g_strdup_printf (
+					    "%s/%s/%ix%i",
 					    icon_path,
 					    origin,
 					    as_icon_get_width (icon),
-					    as_icon_get_height (icon),
-					    icon_fname);
+					    as_icon_get_height (icon));
 				} else {
-					tmp_icon_path_wh = g_strdup_printf (
-					    "%s/%s/%ix%i@%i/%s",
+					icon_dir_wh = g_strdup_printf (
+					    "%s/%s/%ix%i@%i",
 					    icon_path,
 					    origin,
 					    as_icon_get_width (icon),
 					    as_icon_get_height (icon),
-					    as_icon_get_scale (icon),
-					    icon_fname);
+					    as_icon_get_scale (icon));
 				}
 
-				if (g_file_test (tmp_icon_path_wh, G_FILE_TEST_EXISTS)) {
+				if (as_component_icon_file_exists (icon_index,
+								   icon_dir_wh,
+								   icon_fname)) {
+					g_autofree gchar *tmp_icon_path_wh = g_strconcat (
+					    icon_dir_wh,
+					    "/",
+					    icon_fname,
+					    NULL);
 					as_icon_set_filename (icon, tmp_icon_path_wh);
 					as_component_add_icon (cpt, icon);
 					break;
@@ -2860,15 +3408,20 @@ as_component_refine_icons (AsComponent *cpt, GPtrArray *icon_paths)
 			const gchar *icon_path = (const gchar *) g_ptr_array_index (icon_paths, l);
 
 			for (j = 0; sizes[j] != NULL; j++) {
-				g_autofree gchar *tmp_icon_path = NULL;
-				/* sometimes, the file already has an extension */
-				tmp_icon_path = g_strdup_printf ("%s/%s/%s/%s",
-								 icon_path,
-								 origin,
-								 sizes[j],
-								 icon_fname);
+				g_autofree gchar *icon_dir = NULL;
+				icon_dir = g_strdup_printf ("%s/%s/%s",
+							    icon_path,
+							    origin,
+							    sizes[j]);
 
-				if (g_file_test (tmp_icon_path, G_FILE_TEST_EXISTS)) {
+				/* sometimes, the file already has an extension */
+				if (as_component_icon_file_exists (icon_index,
+								   icon_dir,
+								   icon_fname)) {
+					g_autofree gchar *tmp_icon_path = g_strconcat (icon_dir,
+										       "/",
+										       icon_fname,
+										       NULL);
 					/* we have an icon! */
 					if (g_strcmp0 (sizes[j], "") == 0) {
 						/* old icon directory, so assume 64x64 */
@@ -2887,15 +3440,19 @@ as_component_refine_icons (AsComponent *cpt, GPtrArray *icon_paths)
 
 				/* file not found, try extensions (we will not do this forever, better fix AppStream data!) */
 				for (k = 0; extensions[k] != NULL; k++) {
-					g_autofree gchar *tmp_icon_path_ext = NULL;
-					tmp_icon_path_ext = g_strdup_printf ("%s/%s/%s/%s.%s",
-									     icon_path,
-									     origin,
-									     sizes[j],
-									     icon_fname,
-									     extensions[k]);
-
-					if (g_file_test (tmp_icon_path_ext, G_FILE_TEST_EXISTS)) {
+					g_autofree gchar *icon_fname_ext = NULL;
+					icon_fname_ext = g_strdup_printf ("%s.%s",
+									  icon_fname,
+									  extensions[k]);
+
+					if (as_component_icon_file_exists (icon_index,
+									   icon_dir,
+									   icon_fname_ext)) {
+						g_autofree gchar *tmp_icon_path_ext = g_strconcat (
+						    icon_dir,
+						    "/",
+						    icon_fname_ext,
+						    NULL);
 						/* we have an icon! */
 						if (g_strcmp0 (sizes[j], "") == 0) {
 							/* old icon directory, so assume 64x64 */
@@ -2922,6 +3479,7 @@ as_component_refine_icons (AsComponent *cpt, GPtrArray *icon_paths)
  * as_component_complete:
  * @cpt: a #AsComponent instance.
  * @icon_paths: String array of possible (cached) icon locations
+ * @icon_index: Shared #AsIconDirIndex to look up icon files in, or %NULL
  *
  * Private function to complete a AsComponent with
  * additional data found on the system.
@@ -2929,13 +3487,13 @@ as_component_refine_icons (AsComponent *cpt, GPtrArray *icon_paths)
  * INTERNAL
  */
 void
-as_component_complete (AsComponent *cpt, GPtrArray *icon_paths)
+as_component_complete (AsComponent *cpt, GPtrArray *icon_paths, AsIconDirIndex *icon_index)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 
 	/* improve icon paths */
 	if (icon_paths != NULL)
-		as_component_refine_icons (cpt, icon_paths);
+		as_component_refine_icons (cpt, icon_paths, icon_index);
 
 	/* "fake" a launchable entry for desktop-apps that failed to include one. This is used for legacy compatibility */
 	if ((priv->kind == AS_COMPONENT_KIND_DESKTOP_APP) && (priv->launchables->len <= 0)) {
@@ -3030,6 +3588,81 @@ as_component_add_token (AsComponent *cpt,
 	as_component_add_token_helper (cpt, value, match_flag, stemmer, tokens_out);
 }
 
+/**
+ * as_component_str_is_plain_ascii:
+ *
+ * Check whether a string consists only of ASCII characters.
+ * This scans word-sized chunks at a time, so the common all-ASCII case
+ * is decided with only a few masked comparisons per 8 bytes.
+ */
+static gboolean
+as_component_str_is_plain_ascii (const gchar *str)
+{
+	const gchar *c = str;
+	const gchar *end = str + strlen (str);
+
+	/* process unaligned leading bytes */
+	while (c < end && ((guintptr) c & (sizeof (guintptr) - 1)) != 0) {
+		if ((guchar) *c > 0x7F)
+			return FALSE;
+		c++;
+	}
+
+	/* scan word-sized chunks for high bits, staying within the known string
+	 * length so we never load bytes past the terminator */
+	while (c + sizeof (guintptr) <= end) {
+		guintptr chunk = *((const guintptr *) c);
+		const guintptr himask = (guintptr) 0x8080808080808080ULL;
+
+		if ((chunk & himask) != 0)
+			return FALSE;
+		c += sizeof (guintptr);
+	}
+
+	/* verify the trailing bytes individually */
+	for (; c < end; c++) {
+		if ((guchar) *c > 0x7F)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * as_component_tokenize_ascii:
+ *
+ * Fast tokenizer for plain-ASCII values: split on non-alphanumeric characters
+ * and lowercase the tokens, without going through the full Unicode folding
+ * machinery of g_str_tokenize_and_fold().
+ *
+ * Returns: (nullable): a %NULL-terminated token array, or %NULL if no tokens were found.
+ */
+static gchar **
+as_component_tokenize_ascii (const gchar *value)
+{
+	g_autoptr(GPtrArray) tokens = g_ptr_array_new_with_free_func (g_free);
+	const gchar *start = NULL;
+
+	for (const gchar *c = value;; c++) {
+		if (g_ascii_isalnum (*c)) {
+			if (start == NULL)
+				start = c;
+			continue;
+		}
+		if (start != NULL) {
+			gchar *token = g_ascii_strdown (start, c - start);
+			g_ptr_array_add (tokens, token);
+			start = NULL;
+		}
+		if (*c == '\0')
+			break;
+	}
+
+	if (tokens->len == 0)
+		return NULL;
+	g_ptr_array_add (tokens, NULL);
+	return (gchar **) g_ptr_array_free (g_steal_pointer (&tokens), FALSE);
+}
+
 /**
  * as_component_value_tokenize:
  *
@@ -3043,15 +3676,27 @@ as_component_value_tokenize (AsComponent *cpt,
 {
 	/* tokenize with UTF-8 fallbacks */
 	if (g_strstr_len (value, -1, "+") == NULL && g_strstr_len (value, -1, "-") == NULL) {
-		(*tokens_utf8) = g_str_tokenize_and_fold (value,
-							  as_component_get_active_locale (cpt),
-							  tokens_ascii);
+		if (as_component_str_is_plain_ascii (value)) {
+			/* fast path: plain-ASCII values need no Unicode folding and
+			 * produce no ASCII alternates */
+			(*tokens_utf8) = as_component_tokenize_ascii (value);
+			if (tokens_ascii != NULL)
+				(*tokens_ascii) = NULL;
+		} else {
+			(*tokens_utf8) = g_str_tokenize_and_fold (
+			    value,
+			    as_component_get_active_locale (cpt),
+			    tokens_ascii);
+		}
 	}
 
 	/* we might still be able to extract tokens if g_str_tokenize_and_fold() can't do it or +/- were found */
 	if ((*tokens_utf8) == NULL) {
 		g_autofree gchar *delim = NULL;
-		delim = g_utf8_strdown (value, -1);
+		if (as_component_str_is_plain_ascii (value))
+			delim = as_utils_strdown_inplace (g_strdup (value));
+		else
+			delim = g_utf8_strdown (value, -1);
 		g_strdelimit (delim, "/,.;:", ' ');
 		(*tokens_utf8) = g_strsplit (delim, " ", -1);
 	}
@@ -3223,45 +3868,175 @@ as_component_generate_tokens_for (AsComponent *cpt, AsSearchTokenMatch token_kin
 }
 
 /**
- * as_component_search_matches:
+ * as_component_get_token_cache_table:
  * @cpt: a #AsComponent instance.
- * @term: the search term.
  *
- * Searches component data for a specific keyword.
+ * Get the internal token cache of this component, building it if necessary.
+ * Used to serialize the token index into the cache silo.
  *
- * Returns: a match scrore, where 0 is no match and 100 is the best match.
+ * Internal API.
  *
- * Since: 0.9.7
- **/
-guint
-as_component_search_matches (AsComponent *cpt, const gchar *term)
+ * Returns: (transfer none): the token cache table of RefString:AsTokenType*
+ */
+GHashTable *
+as_component_get_token_cache_table (AsComponent *cpt)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
-	AsTokenType *match_pval;
-	GList *l;
+
+	as_component_create_token_cache (cpt);
+	return priv->token_cache;
+}
+
+/**
+ * as_component_insert_token_cache_entry:
+ * @cpt: a #AsComponent instance.
+ * @token: the stemmed search token.
+ * @match_val: the #AsTokenType match value of the token.
+ *
+ * Insert a previously serialized token into the token cache of
+ * this component, without re-tokenizing any component data.
+ *
+ * Internal API.
+ */
+void
+as_component_insert_token_cache_entry (AsComponent *cpt, const gchar *token, AsTokenType match_val)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	AsTokenType *match_pval;
+
+	match_pval = g_new0 (AsTokenType, 1);
+	*match_pval = match_val;
+	g_hash_table_insert (priv->token_cache, g_ref_string_new_intern (token), match_pval);
+}
+
+/**
+ * as_component_set_token_cache_valid:
+ * @cpt: a #AsComponent instance.
+ *
+ * Mark the token cache of this component as valid, so search will not
+ * re-tokenize the component data. Only to be used after the complete
+ * token index was loaded via as_component_insert_token_cache_entry().
+ *
+ * Internal API.
+ */
+void
+as_component_set_token_cache_valid (AsComponent *cpt)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+
+	if (g_once_init_enter (&priv->token_cache_valid))
+		g_once_init_leave (&priv->token_cache_valid, TRUE);
+}
+
+static gint
+as_component_strptr_cmp (gconstpointer a, gconstpointer b)
+{
+	return strcmp (*((const gchar **) a), *((const gchar **) b));
+}
+
+/**
+ * as_component_create_token_index:
+ * @cpt: a #AsComponent instance.
+ *
+ * Build the packed, sorted token index from the token cache.
+ * Search scoring runs this index instead of probing the hash table:
+ * the tokens live NUL-separated in one contiguous blob in sorted order,
+ * so an exact term is found with a binary search, and all tokens
+ * sharing the term as prefix form a contiguous run that can be scanned
+ * without touching scattered heap allocations.
+ */
+static void
+as_component_create_token_index (AsComponent *cpt)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	g_autoptr(GPtrArray) tokens = NULL;
+	GHashTableIter iter;
+	gpointer key;
+	gsize blob_size = 0;
+	gsize blob_pos = 0;
+
+	if (!g_once_init_enter (&priv->token_idx_valid))
+		return;
+
+	/* ensure the token cache we derive the index from is complete */
+	as_component_create_token_cache (cpt);
+
+	tokens = g_ptr_array_sized_new (g_hash_table_size (priv->token_cache));
+	g_hash_table_iter_init (&iter, priv->token_cache);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		g_ptr_array_add (tokens, key);
+		blob_size += strlen ((const gchar *) key) + 1;
+	}
+	g_ptr_array_sort (tokens, as_component_strptr_cmp);
+
+	priv->token_idx_len = tokens->len;
+	if (tokens->len > 0) {
+		priv->token_idx_blob = g_malloc (blob_size);
+		priv->token_idx_offsets = g_new (guint32, tokens->len);
+		priv->token_idx_vals = g_new (AsTokenType, tokens->len);
+		for (guint i = 0; i < tokens->len; i++) {
+			const gchar *token = g_ptr_array_index (tokens, i);
+			AsTokenType *match_pval = g_hash_table_lookup (priv->token_cache, token);
+			gsize token_size = strlen (token) + 1;
+
+			memcpy (priv->token_idx_blob + blob_pos, token, token_size);
+			priv->token_idx_offsets[i] = (guint32) blob_pos;
+			priv->token_idx_vals[i] = *match_pval;
+			blob_pos += token_size;
+		}
+	}
+
+	g_once_init_leave (&priv->token_idx_valid, TRUE);
+}
+
+/**
+ * as_component_search_matches:
+ * @cpt: a #AsComponent instance.
+ * @term: the search term.
+ *
+ * Searches component data for a specific keyword.
+ *
+ * Returns: a match scrore, where 0 is no match and 100 is the best match.
+ *
+ * Since: 0.9.7
+ **/
+guint
+as_component_search_matches (AsComponent *cpt, const gchar *term)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	gsize term_len;
+	guint lo = 0;
+	guint hi;
 	guint result = 0;
-	g_autoptr(GList) keys = NULL;
 
 	/* nothing to do */
 	if (term == NULL)
 		return 0;
 
-	/* ensure the token cache is created */
-	as_component_create_token_cache (cpt);
+	/* ensure the sorted token index exists */
+	as_component_create_token_index (cpt);
 
-	/* find the exact match (which is more awesome than a partial match) */
-	match_pval = g_hash_table_lookup (priv->token_cache, term);
-	if (match_pval != NULL)
-		return *match_pval << 2;
+	/* lower-bound binary search for the first token that is not smaller than the term */
+	hi = priv->token_idx_len;
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		const gchar *token = priv->token_idx_blob + priv->token_idx_offsets[mid];
+		if (strcmp (token, term) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
 
-	/* need to do partial match */
-	keys = g_hash_table_get_keys (priv->token_cache);
-	for (l = keys; l != NULL; l = l->next) {
-		const gchar *key = l->data;
-		if (g_str_has_prefix (key, term)) {
-			match_pval = g_hash_table_lookup (priv->token_cache, key);
-			result |= *match_pval;
-		}
+	/* all tokens with the term as prefix follow contiguously from here */
+	term_len = strlen (term);
+	for (guint i = lo; i < priv->token_idx_len; i++) {
+		const gchar *token = priv->token_idx_blob + priv->token_idx_offsets[i];
+		if (strncmp (token, term, term_len) != 0)
+			break;
+		/* an exact match is more awesome than any partial match */
+		if (token[term_len] == '\0')
+			return priv->token_idx_vals[i] << 2;
+		result |= priv->token_idx_vals[i];
 	}
 
 	return result;
@@ -3349,9 +4124,19 @@ static gboolean
 as_component_has_desktop_group (AsComponent *cpt, const gchar *desktop_group)
 {
 	guint i;
-	g_auto(GStrv) split = g_strsplit (desktop_group, "::", -1);
-	for (i = 0; split[i] != NULL; i++) {
-		if (!as_component_has_category (cpt, split[i]))
+	const gchar *const *parts;
+	g_auto(GStrv) split = NULL;
+
+	/* group selectors from the default taxonomy come pre-split,
+	 * so the common case needs no allocations at all */
+	parts = as_category_get_desktop_group_parts (desktop_group);
+	if (parts == NULL) {
+		split = g_strsplit (desktop_group, "::", -1);
+		parts = (const gchar *const *) split;
+	}
+
+	for (i = 0; parts[i] != NULL; i++) {
+		if (!as_component_has_category (cpt, parts[i]))
 			return FALSE;
 	}
 	return TRUE;
@@ -3703,7 +4488,7 @@ as_component_add_relation (AsComponent *cpt, AsRelation *relation)
  *
  * This function makes such assumptions explicit from being implicit before.
  */
-static void
+void
 as_component_make_implicit_relations_explicit (AsComponent *cpt)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
@@ -4067,61 +4852,6 @@ as_component_set_context (AsComponent *cpt, AsContext *context)
 	g_free (g_steal_pointer (&priv->arch));
 }
 
-/**
- * as_copy_l10n_hashtable_hfunc:
- */
-static void
-as_copy_l10n_hashtable_hfunc (gpointer key, gpointer value, gpointer user_data)
-{
-	GHashTable *dest = (GHashTable *) user_data;
-	g_hash_table_insert (dest, g_ref_string_acquire (key), g_strdup (value));
-}
-
-/**
- * as_copy_l10n_hashtable:
- *
- * Helper for as_component_merge_with_mode()
- */
-static void
-as_copy_l10n_hashtable (GHashTable *src, GHashTable *dest)
-{
-	/* don't copy if there is nothing to copy */
-	if (g_hash_table_size (src) <= 0)
-		return;
-
-	/* clear our destination table */
-	g_hash_table_remove_all (dest);
-
-	/* copy */
-	g_hash_table_foreach (src, &as_copy_l10n_hashtable_hfunc, dest);
-}
-
-/**
- * as_copy_gobject_array:
- *
- * Helper for as_component_merge_with_mode()
- *
- * NOTE: Only the object references are copied.
- */
-static void
-as_copy_gobject_array (GPtrArray *src, GPtrArray *dest)
-{
-	guint i;
-
-	/* don't copy if there is nothing to copy */
-	if (src->len <= 0)
-		return;
-
-	/* clear our destination table */
-	g_ptr_array_remove_range (dest, 0, dest->len);
-
-	/* copy */
-	for (i = 0; i < src->len; i++) {
-		GObject *obj = G_OBJECT (g_ptr_array_index (src, i));
-		g_ptr_array_add (dest, g_object_ref (obj));
-	}
-}
-
 /**
  * as_component_merge_with_mode:
  * @cpt: An #AsComponent.
@@ -4140,6 +4870,10 @@ as_component_merge_with_mode (AsComponent *cpt, AsComponent *source, AsMergeKind
 	AsComponentPrivate *dest_priv = GET_PRIVATE (dest_cpt);
 	AsComponentPrivate *src_priv = GET_PRIVATE (src_cpt);
 
+	/* merging accesses deferred data of both components directly */
+	as_component_lazy_materialize (dest_cpt);
+	as_component_lazy_materialize (src_cpt);
+
 	if (merge_kind == AS_MERGE_KIND_REMOVE_COMPONENT) {
 		/* we can't remove ourselves from the pool, so this merge action is handled separately */
 		return;
@@ -4157,6 +4891,8 @@ as_component_merge_with_mode (AsComponent *cpt, AsComponent *source, AsMergeKind
 		if (cats->len > 0) {
 			g_autoptr(GHashTable) cat_table = NULL;
 			GPtrArray *dest_categories;
+			GHashTableIter cat_iter;
+			gpointer cat_key;
 
 			cat_table = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 			for (i = 0; i < cats->len; i++) {
@@ -4175,7 +4911,11 @@ as_component_merge_with_mode (AsComponent *cpt, AsComponent *source, AsMergeKind
 			}
 
 			g_ptr_array_set_size (dest_categories, 0);
-			as_hash_table_string_keys_to_array (cat_table, dest_categories);
+			g_hash_table_iter_init (&cat_iter, cat_table);
+			while (g_hash_table_iter_next (&cat_iter, &cat_key, NULL))
+				g_ptr_array_add (dest_categories,
+						 g_ref_string_new_intern (
+						     (const gchar *) cat_key));
 		}
 
 		/* merge suggestions */
@@ -4198,27 +4938,37 @@ as_component_merge_with_mode (AsComponent *cpt, AsComponent *source, AsMergeKind
 
 		/* names */
 		if (g_hash_table_size (dest_priv->name) <= 0)
-			as_copy_l10n_hashtable (src_priv->name, dest_priv->name);
+			as_component_l10n_table_share (dest_cpt,
+						       src_cpt,
+						       AS_COMPONENT_L10N_SHARED_NAME);
 
 		/* summary */
 		if (g_hash_table_size (dest_priv->summary) <= 0)
-			as_copy_l10n_hashtable (src_priv->summary, dest_priv->summary);
+			as_component_l10n_table_share (dest_cpt,
+						       src_cpt,
+						       AS_COMPONENT_L10N_SHARED_SUMMARY);
 
 		/* description */
 		if (g_hash_table_size (dest_priv->description) <= 0)
-			as_copy_l10n_hashtable (src_priv->description, dest_priv->description);
+			as_component_l10n_table_share (dest_cpt,
+						       src_cpt,
+						       AS_COMPONENT_L10N_SHARED_DESCRIPTION);
 	}
 
 	/* merge stuff in replace mode */
 	if (merge_kind == AS_MERGE_KIND_REPLACE) {
 		/* names */
-		as_copy_l10n_hashtable (src_priv->name, dest_priv->name);
+		as_component_l10n_table_share (dest_cpt, src_cpt, AS_COMPONENT_L10N_SHARED_NAME);
 
 		/* summary */
-		as_copy_l10n_hashtable (src_priv->summary, dest_priv->summary);
+		as_component_l10n_table_share (dest_cpt,
+					       src_cpt,
+					       AS_COMPONENT_L10N_SHARED_SUMMARY);
 
 		/* description */
-		as_copy_l10n_hashtable (src_priv->description, dest_priv->description);
+		as_component_l10n_table_share (dest_cpt,
+					       src_cpt,
+					       AS_COMPONENT_L10N_SHARED_DESCRIPTION);
 
 		/* merge package names */
 		if ((src_priv->pkgnames != NULL) && (src_priv->pkgnames[0] != NULL))
@@ -4230,10 +4980,10 @@ as_component_merge_with_mode (AsComponent *cpt, AsComponent *source, AsMergeKind
 							as_component_get_bundles (src_cpt));
 
 		/* merge icons */
-		as_copy_gobject_array (src_priv->icons, dest_priv->icons);
+		as_component_array_share (dest_cpt, src_cpt, AS_COMPONENT_ARRAY_SHARED_ICONS);
 
 		/* merge provided items */
-		as_copy_gobject_array (src_priv->provided, dest_priv->provided);
+		as_component_array_share (dest_cpt, src_cpt, AS_COMPONENT_ARRAY_SHARED_PROVIDED);
 	}
 
 	g_debug ("Merged data for '[%i] %s' <<- '[%i] %s'",
@@ -4283,6 +5033,37 @@ as_component_set_kind_from_node (AsComponent *cpt, xmlNode *node)
 	}
 }
 
+/**
+ * as_component_add_provided_item_sized:
+ *
+ * Like as_component_add_provided_item(), but presizes the #AsProvided
+ * item storage with @size_hint entries if it has to be created.
+ */
+static void
+as_component_add_provided_item_sized (AsComponent *cpt,
+				      AsProvidedKind kind,
+				      const gchar *item,
+				      guint size_hint)
+{
+	AsProvided *prov;
+
+	/* we just skip empty items */
+	if (as_is_empty (item))
+		return;
+
+	prov = as_component_get_provided_for_kind (cpt, kind);
+	if (prov == NULL) {
+		prov = as_provided_new ();
+		as_provided_set_kind (prov, kind);
+		as_provided_reserve_items (prov, size_hint);
+		g_ptr_array_add (as_component_array_writable (cpt,
+							      AS_COMPONENT_ARRAY_SHARED_PROVIDED),
+				 prov);
+	}
+
+	as_provided_add_item (prov, item);
+}
+
 /**
  * as_component_load_provides_from_xml:
  */
@@ -4291,6 +5072,12 @@ as_component_load_provides_from_xml (AsComponent *cpt, xmlNode *node)
 {
 	xmlNode *iter;
 	gchar *node_name;
+	guint n_children;
+
+	/* large provides blocks (e.g. hundreds of modaliases or mediatypes) are
+	 * almost always items of a single kind, so the child count of the provides
+	 * node is a good capacity guess for the item lists we have to create */
+	n_children = as_xml_get_children_count (node);
 
 	for (iter = node->children; iter != NULL; iter = iter->next) {
 		g_autofree gchar *content = NULL;
@@ -4305,42 +5092,69 @@ as_component_load_provides_from_xml (AsComponent *cpt, xmlNode *node)
 			continue;
 
 		if (g_strcmp0 (node_name, "id") == 0) {
-			as_component_add_provided_item (cpt, AS_PROVIDED_KIND_ID, content);
+			as_component_add_provided_item_sized (cpt,
+							      AS_PROVIDED_KIND_ID,
+							      content,
+							      n_children);
 		} else if (g_strcmp0 (node_name, "mediatype") == 0) {
-			as_component_add_provided_item (cpt, AS_PROVIDED_KIND_MEDIATYPE, content);
+			as_component_add_provided_item_sized (cpt,
+							      AS_PROVIDED_KIND_MEDIATYPE,
+							      content,
+							      n_children);
 		} else if (g_strcmp0 (node_name, "library") == 0) {
-			as_component_add_provided_item (cpt, AS_PROVIDED_KIND_LIBRARY, content);
+			as_component_add_provided_item_sized (cpt,
+							      AS_PROVIDED_KIND_LIBRARY,
+							      content,
+							      n_children);
 		} else if (g_strcmp0 (node_name, "binary") == 0) {
-			as_component_add_provided_item (cpt, AS_PROVIDED_KIND_BINARY, content);
+			as_component_add_provided_item_sized (cpt,
+							      AS_PROVIDED_KIND_BINARY,
+							      content,
+							      n_children);
 		} else if (g_strcmp0 (node_name, "font") == 0) {
-			as_component_add_provided_item (cpt, AS_PROVIDED_KIND_FONT, content);
+			as_component_add_provided_item_sized (cpt,
+							      AS_PROVIDED_KIND_FONT,
+							      content,
+							      n_children);
 		} else if (g_strcmp0 (node_name, "modalias") == 0) {
-			as_component_add_provided_item (cpt, AS_PROVIDED_KIND_MODALIAS, content);
+			as_component_add_provided_item_sized (cpt,
+							      AS_PROVIDED_KIND_MODALIAS,
+							      content,
+							      n_children);
 		} else if (g_strcmp0 (node_name, "firmware") == 0) {
 			g_autofree gchar *fw_type = NULL;
 			fw_type = as_xml_get_prop_value (iter, "type");
 			if (g_strcmp0 (fw_type, "runtime") == 0)
-				as_component_add_provided_item (cpt,
-								AS_PROVIDED_KIND_FIRMWARE_RUNTIME,
-								content);
+				as_component_add_provided_item_sized (
+				    cpt,
+				    AS_PROVIDED_KIND_FIRMWARE_RUNTIME,
+				    content,
+				    n_children);
 			else if (g_strcmp0 (fw_type, "flashed") == 0)
-				as_component_add_provided_item (cpt,
-								AS_PROVIDED_KIND_FIRMWARE_FLASHED,
-								content);
+				as_component_add_provided_item_sized (
+				    cpt,
+				    AS_PROVIDED_KIND_FIRMWARE_FLASHED,
+				    content,
+				    n_children);
 		} else if (g_strcmp0 (node_name, "python3") == 0) {
-			as_component_add_provided_item (cpt, AS_PROVIDED_KIND_PYTHON, content);
+			as_component_add_provided_item_sized (cpt,
+							      AS_PROVIDED_KIND_PYTHON,
+							      content,
+							      n_children);
 		} else if (g_strcmp0 (node_name, "dbus") == 0) {
 			g_autofree gchar *dbus_type = as_xml_get_prop_value (iter, "type");
 
 			if (g_strcmp0 (dbus_type, "system") == 0)
-				as_component_add_provided_item (cpt,
-								AS_PROVIDED_KIND_DBUS_SYSTEM,
-								content);
+				as_component_add_provided_item_sized (cpt,
+								      AS_PROVIDED_KIND_DBUS_SYSTEM,
+								      content,
+								      n_children);
 			else if ((g_strcmp0 (dbus_type, "user") == 0) ||
 				 (g_strcmp0 (dbus_type, "session") == 0))
-				as_component_add_provided_item (cpt,
-								AS_PROVIDED_KIND_DBUS_USER,
-								content);
+				as_component_add_provided_item_sized (cpt,
+								      AS_PROVIDED_KIND_DBUS_USER,
+								      content,
+								      n_children);
 		}
 	}
 }
@@ -4358,7 +5172,7 @@ as_component_xml_parse_languages_node (AsComponent *cpt, xmlNode *node)
 		if (iter->type != XML_ELEMENT_NODE)
 			continue;
 
-		if (g_strcmp0 ((gchar *) iter->name, "lang") == 0) {
+		if (as_xml_tag_from_string ((const gchar *) iter->name) == AS_TAG_LANG) {
 			guint64 percentage = 0;
 			g_autofree gchar *locale = NULL;
 			g_autofree gchar *prop = NULL;
@@ -4437,7 +5251,7 @@ as_component_load_keywords_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *
 {
 	if (as_context_get_style (ctx) == AS_FORMAT_STYLE_METAINFO) {
 		for (xmlNode *iter = node->children; iter != NULL; iter = iter->next) {
-			g_autofree gchar *lang = NULL;
+			const gchar *lang = NULL;
 			g_autofree gchar *keyword = NULL;
 
 			if (iter->type != XML_ELEMENT_NODE)
@@ -4450,7 +5264,7 @@ as_component_load_keywords_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *
 			as_component_add_keyword (cpt, keyword, lang);
 		}
 	} else {
-		g_autofree gchar *lang = as_xml_get_node_locale_match (ctx, node);
+		const gchar *lang = as_xml_get_node_locale_match (ctx, node);
 		if (lang != NULL) {
 			g_autoptr(GPtrArray) keywords = NULL;
 			keywords = as_xml_get_children_as_string_list (node, "keyword");
@@ -4459,6 +5273,238 @@ as_component_load_keywords_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *
 	}
 }
 
+/**
+ * as_component_get_cache_checksum:
+ * @cpt: An #AsComponent.
+ *
+ * Get the content checksum that was recorded for this component when it
+ * was serialized to the cache, or %NULL if the component was not loaded
+ * from a cache. Components with equal checksums have identical cached
+ * data, which allows as_component_box_diff() to skip the expensive
+ * field-by-field comparison for unchanged components.
+ *
+ * Internal API.
+ */
+const gchar *
+as_component_get_cache_checksum (AsComponent *cpt)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	return priv->cache_checksum;
+}
+
+/**
+ * as_component_set_cache_checksum:
+ * @cpt: An #AsComponent.
+ * @checksum: the content checksum, or %NULL to unset it.
+ *
+ * Internal API.
+ */
+void
+as_component_set_cache_checksum (AsComponent *cpt, const gchar *checksum)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	as_assign_string_safe (priv->cache_checksum, checksum);
+}
+
+/**
+ * as_component_set_lazy_load:
+ * @cpt: An #AsComponent.
+ * @lazy: %TRUE to defer deserialization of expensive data.
+ *
+ * If set, a subsequent as_component_load_from_xml() will not deserialize
+ * long descriptions, releases and screenshots immediately, but keep their
+ * XML subtrees around and materialize them on first access.
+ * This speeds up listing views considerably, which only ever read the
+ * IDs, names and summaries of most components.
+ *
+ * Internal API.
+ */
+void
+as_component_set_lazy_load (AsComponent *cpt, gboolean lazy)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	priv->lazy_load = lazy;
+}
+
+/**
+ * as_component_set_bulk_load:
+ * @cpt: An #AsComponent.
+ * @bulk: %TRUE to suppress property change notifications.
+ *
+ * While enabled, setters will not emit GObject property notifications.
+ * Bulk deserialization from a cache never has property listeners, so
+ * skipping the emissions shaves a constant cost off every materialized
+ * component. Must be disabled again before the component is handed out.
+ *
+ * Internal API.
+ */
+void
+as_component_set_bulk_load (AsComponent *cpt, gboolean bulk)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	priv->bulk_load = bulk;
+}
+
+/**
+ * as_component_lazy_defer_node:
+ *
+ * Stash a copy of an XML subtree for deferred deserialization.
+ */
+static void
+as_component_lazy_defer_node (AsComponent *cpt, AsContext *ctx, xmlNode *node)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+
+	if (priv->lazy_nodes == NULL)
+		priv->lazy_nodes = g_ptr_array_new_with_free_func ((GDestroyNotify) xmlFreeNode);
+	g_ptr_array_add (priv->lazy_nodes, xmlCopyNode (node, 1));
+	if (priv->lazy_ctx == NULL)
+		priv->lazy_ctx = g_object_ref (ctx);
+}
+
+/**
+ * as_component_set_lazy_fetch:
+ * @cpt: An #AsComponent.
+ * @ctx: the document context the deferred data belongs to.
+ * @fetch_fn: callback returning an XML node whose children are the deferred subtrees.
+ * @user_data: data passed to @fetch_fn.
+ * @destroy_fn: (nullable): destructor for @user_data.
+ *
+ * Register a callback providing heavy XML subtrees (descriptions, releases,
+ * screenshots) that were not part of the node this component was loaded from,
+ * but are stored elsewhere, e.g. in a separate region of a cache silo.
+ * The callback is invoked at most once, on the first access to the affected
+ * data, and the returned node is freed after its children have been parsed.
+ *
+ * Internal API.
+ */
+void
+as_component_set_lazy_fetch (AsComponent *cpt,
+			     AsContext *ctx,
+			     AsComponentLazyFetchFn fetch_fn,
+			     gpointer user_data,
+			     GDestroyNotify destroy_fn)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+
+	if (priv->lazy_fetch_udata_free != NULL)
+		priv->lazy_fetch_udata_free (priv->lazy_fetch_udata);
+	priv->lazy_fetch_fn = fetch_fn;
+	priv->lazy_fetch_udata = user_data;
+	priv->lazy_fetch_udata_free = destroy_fn;
+	if (priv->lazy_ctx == NULL)
+		priv->lazy_ctx = g_object_ref (ctx);
+}
+
+/**
+ * as_component_lazy_parse_node:
+ *
+ * Deserialize one deferred XML subtree.
+ */
+static void
+as_component_lazy_parse_node (AsComponent *cpt, AsContext *ctx, xmlNode *node)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	AsTag tag_id = as_xml_tag_from_string ((const gchar *) node->name);
+
+	switch (tag_id) {
+	case AS_TAG_DESCRIPTION: {
+		if (as_context_get_style (ctx) == AS_FORMAT_STYLE_CATALOG) {
+			const gchar *lang = as_xml_get_node_locale_match (ctx, node);
+			if (lang != NULL) {
+				g_autofree gchar *desc = as_xml_dump_node_children (node);
+				as_context_localized_ht_set (
+				    priv->context,
+				    as_component_l10n_table_writable (
+					cpt,
+					AS_COMPONENT_L10N_SHARED_DESCRIPTION),
+				    desc,
+				    lang);
+			}
+		} else {
+			as_xml_parse_metainfo_description_node (
+			    ctx,
+			    node,
+			    as_component_l10n_table_writable (cpt,
+							      AS_COMPONENT_L10N_SHARED_DESCRIPTION));
+		}
+		break;
+	}
+	case AS_TAG_SCREENSHOTS: {
+		for (xmlNode *iter = node->children; iter != NULL; iter = iter->next) {
+			if (iter->type != XML_ELEMENT_NODE)
+				continue;
+			if (g_strcmp0 ((const gchar *) iter->name, "screenshot") == 0) {
+				g_autoptr(AsScreenshot) screenshot = as_screenshot_new ();
+				/* keep the screenshot substructure unparsed until it is accessed */
+				as_screenshot_set_lazy_load (screenshot, TRUE);
+				if (as_screenshot_load_from_xml (screenshot, ctx, iter, NULL))
+					g_ptr_array_add (priv->screenshots,
+							 g_steal_pointer (&screenshot));
+			}
+		}
+		break;
+	}
+	case AS_TAG_RELEASES: {
+		as_release_list_load_from_xml (priv->releases, ctx, node, NULL);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+/**
+ * as_component_lazy_materialize:
+ *
+ * Deserialize any XML subtrees whose parsing was deferred by a lazy
+ * as_component_load_from_xml(), and fetch subtrees that are stored out
+ * of band if a fetch callback was registered. Called by all accessors
+ * that read or modify the affected data, and by the cache before a
+ * component may be shared between multiple users.
+ */
+void
+as_component_lazy_materialize (AsComponent *cpt)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	g_autoptr(GPtrArray) nodes = NULL;
+	g_autoptr(AsContext) ctx = NULL;
+	AsComponentLazyFetchFn fetch_fn;
+
+	if (G_LIKELY (priv->lazy_nodes == NULL && priv->lazy_fetch_fn == NULL))
+		return;
+
+	/* claim the deferred data first, so reentrant accessor calls are safe */
+	nodes = g_steal_pointer (&priv->lazy_nodes);
+	ctx = g_steal_pointer (&priv->lazy_ctx);
+	fetch_fn = priv->lazy_fetch_fn;
+	priv->lazy_fetch_fn = NULL;
+
+	if (nodes != NULL) {
+		for (guint i = 0; i < nodes->len; i++)
+			as_component_lazy_parse_node (cpt,
+						      ctx,
+						      (xmlNode *) g_ptr_array_index (nodes, i));
+	}
+
+	if (fetch_fn != NULL) {
+		xmlNode *fetched = fetch_fn (cpt, priv->lazy_fetch_udata);
+		if (fetched != NULL) {
+			for (xmlNode *iter = fetched->children; iter != NULL; iter = iter->next) {
+				if (iter->type != XML_ELEMENT_NODE)
+					continue;
+				as_component_lazy_parse_node (cpt, ctx, iter);
+			}
+			xmlFreeNode (fetched);
+		}
+
+		if (priv->lazy_fetch_udata_free != NULL)
+			priv->lazy_fetch_udata_free (priv->lazy_fetch_udata);
+		priv->lazy_fetch_udata = NULL;
+		priv->lazy_fetch_udata_free = NULL;
+	}
+}
+
 /**
  * as_component_load_from_xml:
  * @cpt: An #AsComponent.
@@ -4519,7 +5565,16 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 	as_component_set_context (cpt, ctx);
 
 	/* clear any existing descriptions */
-	g_hash_table_remove_all (priv->description);
+	as_component_l10n_table_clear (cpt, AS_COMPONENT_L10N_SHARED_DESCRIPTION);
+
+	/* drop stale deferred data, in case we are reloaded */
+	g_clear_pointer (&priv->lazy_nodes, g_ptr_array_unref);
+	g_clear_object (&priv->lazy_ctx);
+	priv->lazy_fetch_fn = NULL;
+	if (priv->lazy_fetch_udata_free != NULL)
+		priv->lazy_fetch_udata_free (priv->lazy_fetch_udata);
+	priv->lazy_fetch_udata = NULL;
+	priv->lazy_fetch_udata_free = NULL;
 
 	for (xmlNode *iter = node->children; iter != NULL; iter = iter->next) {
 		AsTag tag_id;
@@ -4531,7 +5586,8 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 		node_name = (const gchar *) iter->name;
 		tag_id = as_xml_tag_from_string (node_name);
 
-		if (tag_id == AS_TAG_ID) {
+		switch (tag_id) {
+		case AS_TAG_ID: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			as_component_set_id (cpt, content);
 			if ((as_context_get_style (ctx) == AS_FORMAT_STYLE_METAINFO) &&
@@ -4539,29 +5595,41 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 				/* parse legacy component type information */
 				as_component_set_kind_from_node (cpt, iter);
 			}
-		} else if (tag_id == AS_TAG_PKGNAME) {
+			break;
+		}
+		case AS_TAG_PKGNAME: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			if (content != NULL)
 				g_ptr_array_add (pkgnames, g_strdup (content));
-		} else if (tag_id == AS_TAG_SOURCE_PKGNAME) {
+			break;
+		}
+		case AS_TAG_SOURCE_PKGNAME: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			as_component_set_source_pkgname (cpt, content);
-		} else if (tag_id == AS_TAG_NAME) {
-			g_autofree gchar *lang = NULL;
+			break;
+		}
+		case AS_TAG_NAME: {
+			const gchar *lang = NULL;
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			lang = as_xml_get_node_locale_match (ctx, iter);
 
 			if (lang != NULL)
 				as_component_set_name (cpt, content, lang);
-		} else if (tag_id == AS_TAG_SUMMARY) {
-			g_autofree gchar *lang = NULL;
+			break;
+		}
+		case AS_TAG_SUMMARY: {
+			const gchar *lang = NULL;
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			lang = as_xml_get_node_locale_match (ctx, iter);
 			if (lang != NULL)
 				as_component_set_summary (cpt, content, lang);
-		} else if (tag_id == AS_TAG_DESCRIPTION) {
-			if (as_context_get_style (ctx) == AS_FORMAT_STYLE_CATALOG) {
-				g_autofree gchar *lang = as_xml_get_node_locale_match (ctx, iter);
+			break;
+		}
+		case AS_TAG_DESCRIPTION: {
+			if (priv->lazy_load) {
+				as_component_lazy_defer_node (cpt, ctx, iter);
+			} else if (as_context_get_style (ctx) == AS_FORMAT_STYLE_CATALOG) {
+				const gchar *lang = as_xml_get_node_locale_match (ctx, iter);
 				/* for catalog XML, the "description" tag has a language property, so parsing it is simple */
 				if (lang != NULL) {
 					gchar *desc;
@@ -4570,11 +5638,16 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 					g_free (desc);
 				}
 			} else {
-				as_xml_parse_metainfo_description_node (ctx,
-									iter,
-									priv->description);
+				as_xml_parse_metainfo_description_node (
+				    ctx,
+				    iter,
+				    as_component_l10n_table_writable (
+					cpt,
+					AS_COMPONENT_L10N_SHARED_DESCRIPTION));
 			}
-		} else if (tag_id == AS_TAG_ICON) {
+			break;
+		}
+		case AS_TAG_ICON: {
 			g_autoptr(AsIcon) icon = NULL;
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			if (content == NULL)
@@ -4582,7 +5655,9 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 			icon = as_icon_new ();
 			if (as_icon_load_from_xml (icon, ctx, iter, NULL))
 				as_component_add_icon (cpt, icon);
-		} else if (tag_id == AS_TAG_URL) {
+			break;
+		}
+		case AS_TAG_URL: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			if (content != NULL) {
 				g_autofree gchar *urltype_str = NULL;
@@ -4592,11 +5667,19 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 				if (url_kind != AS_URL_KIND_UNKNOWN)
 					as_component_add_url (cpt, url_kind, content);
 			}
-		} else if (tag_id == AS_TAG_CATEGORIES) {
-			as_xml_add_children_values_to_array (iter, "category", priv->categories);
-		} else if (tag_id == AS_TAG_KEYWORDS) {
+			break;
+		}
+		case AS_TAG_CATEGORIES: {
+			as_xml_add_children_values_to_refstr_array (iter,
+								    "category",
+								    priv->categories);
+			break;
+		}
+		case AS_TAG_KEYWORDS: {
 			as_component_load_keywords_from_xml (cpt, ctx, iter);
-		} else if (tag_id == AS_TAG_MIMETYPES) {
+			break;
+		}
+		case AS_TAG_MIMETYPES: {
 			g_autoptr(GPtrArray) mime_list = NULL;
 			guint i;
 
@@ -4610,11 +5693,20 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 				    AS_PROVIDED_KIND_MEDIATYPE,
 				    (const gchar *) g_ptr_array_index (mime_list, i));
 			}
-		} else if (tag_id == AS_TAG_PROVIDES) {
+			break;
+		}
+		case AS_TAG_PROVIDES: {
 			as_component_load_provides_from_xml (cpt, iter);
-		} else if (tag_id == AS_TAG_SCREENSHOTS) {
+			break;
+		}
+		case AS_TAG_SCREENSHOTS: {
 			xmlNode *iter2;
 
+			if (priv->lazy_load) {
+				as_component_lazy_defer_node (cpt, ctx, iter);
+				continue;
+			}
+
 			for (iter2 = iter->children; iter2 != NULL; iter2 = iter2->next) {
 				if (iter2->type != XML_ELEMENT_NODE)
 					continue;
@@ -4627,25 +5719,35 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 						as_component_add_screenshot (cpt, screenshot);
 				}
 			}
-		} else if (tag_id == AS_TAG_METADATA_LICENSE) {
+			break;
+		}
+		case AS_TAG_METADATA_LICENSE: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			as_component_set_metadata_license (cpt, content);
-		} else if (tag_id == AS_TAG_PROJECT_LICENSE) {
+			break;
+		}
+		case AS_TAG_PROJECT_LICENSE: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			as_component_set_project_license (cpt, content);
-		} else if (tag_id == AS_TAG_PROJECT_GROUP) {
+			break;
+		}
+		case AS_TAG_PROJECT_GROUP: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			as_component_set_project_group (cpt, content);
-		} else if (tag_id == AS_TAG_DEVELOPER) {
+			break;
+		}
+		case AS_TAG_DEVELOPER: {
 			g_autoptr(AsDeveloper) developer = as_developer_new ();
 			if (as_developer_load_from_xml (developer, ctx, iter, NULL)) {
 				if (priv->developer != NULL)
 					g_object_unref (priv->developer);
 				priv->developer = g_steal_pointer (&developer);
 			}
-		} else if (tag_id == AS_TAG_DEVELOPER_NAME) {
+			break;
+		}
+		case AS_TAG_DEVELOPER_NAME: {
 			/* DEPRECATED */
-			g_autofree gchar *lang = NULL;
+			const gchar *lang = NULL;
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			lang = as_xml_get_node_locale_match (ctx, iter);
 			if (lang != NULL) {
@@ -4653,66 +5755,99 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 					priv->developer = as_developer_new_with_context (ctx);
 				as_developer_set_name (priv->developer, content, lang);
 			}
-		} else if (tag_id == AS_TAG_COMPULSORY_FOR_DESKTOP) {
+			break;
+		}
+		case AS_TAG_COMPULSORY_FOR_DESKTOP: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			if (content != NULL)
 				as_component_set_compulsory_for_desktop (cpt, content);
-		} else if (tag_id == AS_TAG_RELEASES) {
-			as_release_list_load_from_xml (priv->releases, ctx, iter, NULL);
-
-		} else if (tag_id == AS_TAG_EXTENDS) {
+			break;
+		}
+		case AS_TAG_RELEASES: {
+			if (priv->lazy_load)
+				as_component_lazy_defer_node (cpt, ctx, iter);
+			else
+				as_release_list_load_from_xml (priv->releases, ctx, iter, NULL);
+			break;
+		}
+		case AS_TAG_EXTENDS: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			as_component_add_extends (cpt, content);
-
-		} else if (tag_id == AS_TAG_LANGUAGES) {
+			break;
+		}
+		case AS_TAG_LANGUAGES: {
 			as_component_xml_parse_languages_node (cpt, iter);
-		} else if (tag_id == AS_TAG_LAUNCHABLE) {
+			break;
+		}
+		case AS_TAG_LAUNCHABLE: {
 			as_component_load_launchable_from_xml (cpt, iter);
-		} else if (tag_id == AS_TAG_BUNDLE) {
+			break;
+		}
+		case AS_TAG_BUNDLE: {
 			g_autoptr(AsBundle) bundle = as_bundle_new ();
 			if (as_bundle_load_from_xml (bundle, ctx, iter, NULL))
 				as_component_add_bundle (cpt, bundle);
-		} else if (tag_id == AS_TAG_TRANSLATION) {
+			break;
+		}
+		case AS_TAG_TRANSLATION: {
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			if (content != NULL) {
 				g_autoptr(AsTranslation) tr = as_translation_new ();
 				if (as_translation_load_from_xml (tr, ctx, iter, NULL))
 					as_component_add_translation (cpt, tr);
 			}
-		} else if (tag_id == AS_TAG_SUGGESTS) {
+			break;
+		}
+		case AS_TAG_SUGGESTS: {
 			g_autoptr(AsSuggested) suggested = as_suggested_new ();
 			if (as_suggested_load_from_xml (suggested, ctx, iter, NULL))
 				as_component_add_suggested (cpt, suggested);
-		} else if (tag_id == AS_TAG_CUSTOM) {
+			break;
+		}
+		case AS_TAG_CUSTOM: {
 			as_xml_parse_custom_node (iter, as_component_get_custom (cpt));
-		} else if (tag_id == AS_TAG_CONTENT_RATING) {
+			break;
+		}
+		case AS_TAG_CONTENT_RATING: {
 			g_autoptr(AsContentRating) ctrating = as_content_rating_new ();
 			if (as_content_rating_load_from_xml (ctrating, ctx, iter, NULL))
 				as_component_add_content_rating (cpt, ctrating);
-		} else if (tag_id == AS_TAG_REPLACES) {
+			break;
+		}
+		case AS_TAG_REPLACES: {
 			if (priv->replaces != NULL)
 				g_ptr_array_unref (priv->replaces);
 			priv->replaces = as_xml_get_children_as_string_list (iter, "id");
-		} else if (tag_id == AS_TAG_REQUIRES) {
+			break;
+		}
+		case AS_TAG_REQUIRES: {
 			as_component_load_relations_from_xml (cpt,
 							      ctx,
 							      iter,
 							      AS_RELATION_KIND_REQUIRES);
-		} else if (tag_id == AS_TAG_RECOMMENDS) {
+			break;
+		}
+		case AS_TAG_RECOMMENDS: {
 			as_component_load_relations_from_xml (cpt,
 							      ctx,
 							      iter,
 							      AS_RELATION_KIND_RECOMMENDS);
-		} else if (tag_id == AS_TAG_SUPPORTS) {
+			break;
+		}
+		case AS_TAG_SUPPORTS: {
 			as_component_load_relations_from_xml (cpt,
 							      ctx,
 							      iter,
 							      AS_RELATION_KIND_SUPPORTS);
-		} else if (tag_id == AS_TAG_AGREEMENT) {
+			break;
+		}
+		case AS_TAG_AGREEMENT: {
 			g_autoptr(AsAgreement) agreement = as_agreement_new ();
 			if (as_agreement_load_from_xml (agreement, ctx, iter, NULL))
 				as_component_add_agreement (cpt, agreement);
-		} else if (tag_id == AS_TAG_REVIEWS) {
+			break;
+		}
+		case AS_TAG_REVIEWS: {
 			for (xmlNode *sn = iter->children; sn != NULL; sn = sn->next) {
 				if (sn->type != XML_ELEMENT_NODE)
 					continue;
@@ -4722,11 +5857,15 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 						as_component_add_review (cpt, review);
 				}
 			}
-		} else if (tag_id == AS_TAG_BRANDING) {
+			break;
+		}
+		case AS_TAG_BRANDING: {
 			g_autoptr(AsBranding) branding = as_branding_new ();
 			if (as_branding_load_from_xml (branding, ctx, iter, NULL))
 				as_component_set_branding (cpt, branding);
-		} else if (tag_id == AS_TAG_TAGS) {
+			break;
+		}
+		case AS_TAG_TAGS: {
 			for (xmlNode *sn = iter->children; sn != NULL; sn = sn->next) {
 				g_autofree gchar *ns = NULL;
 				g_autofree gchar *value = NULL;
@@ -4736,8 +5875,9 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 				value = as_xml_get_node_value (sn);
 				as_component_add_tag (cpt, ns, value);
 			}
-
-		} else if (tag_id == AS_TAG_REFERENCES) {
+			break;
+		}
+		case AS_TAG_REFERENCES: {
 			xmlNode *iter2;
 
 			for (iter2 = iter->children; iter2 != NULL; iter2 = iter2->next) {
@@ -4748,24 +5888,69 @@ as_component_load_from_xml (AsComponent *cpt, AsContext *ctx, xmlNode *node, GEr
 				if (as_reference_load_from_xml (reference, ctx, iter2, NULL))
 					as_component_add_reference (cpt, reference);
 			}
-
-		} else if (as_context_get_internal_mode (ctx)) {
-			g_autofree gchar *content = as_xml_get_node_value (iter);
+			break;
+		}
+		case AS_TAG_INTERNAL_SCOPE: {
 			/* internal information */
-
-			if (tag_id == AS_TAG_INTERNAL_SCOPE) {
+			if (as_context_get_internal_mode (ctx)) {
+				g_autofree gchar *content = as_xml_get_node_value (iter);
 				priv->scope = as_component_scope_from_string (content);
-			} else if (tag_id == AS_TAG_INTERNAL_ORIGIN) {
+			}
+			break;
+		}
+		case AS_TAG_INTERNAL_ORIGIN: {
+			if (as_context_get_internal_mode (ctx)) {
+				g_autofree gchar *content = as_xml_get_node_value (iter);
 				as_component_set_origin (cpt, content);
-			} else if (tag_id == AS_TAG_INTERNAL_BRANCH) {
+			}
+			break;
+		}
+		case AS_TAG_INTERNAL_BRANCH: {
+			if (as_context_get_internal_mode (ctx)) {
+				g_autofree gchar *content = as_xml_get_node_value (iter);
 				as_component_set_branch (cpt, content);
 			}
-		} else if (tag_id == AS_TAG_NAME_VARIANT_SUFFIX) {
-			g_autofree gchar *lang = NULL;
+			break;
+		}
+		case AS_TAG_INTERNAL_TOKENS: {
+			g_autofree gchar *tokens_locale = as_xml_get_prop_value (iter, "locale");
+			guint tokens_n = 0;
+
+			/* only adopt the prebuilt token index if it was stemmed
+			 * for a locale compatible with the one we search in */
+			if (!as_utils_locale_is_compatible (tokens_locale,
+							    as_context_get_locale (ctx)))
+				break;
+			for (xmlNode *sn = iter->children; sn != NULL; sn = sn->next) {
+				g_autofree gchar *token = NULL;
+				g_autofree gchar *match_str = NULL;
+
+				if (sn->type != XML_ELEMENT_NODE)
+					continue;
+				token = as_xml_get_node_value (sn);
+				match_str = as_xml_get_prop_value (sn, "m");
+				if (as_is_empty (token) || match_str == NULL)
+					continue;
+				as_component_insert_token_cache_entry (
+				    cpt,
+				    token,
+				    (AsTokenType) g_ascii_strtoull (match_str, NULL, 10));
+				tokens_n++;
+			}
+			if (tokens_n > 0)
+				as_component_set_token_cache_valid (cpt);
+			break;
+		}
+		case AS_TAG_NAME_VARIANT_SUFFIX: {
+			const gchar *lang = NULL;
 			g_autofree gchar *content = as_xml_get_node_value (iter);
 			lang = as_xml_get_node_locale_match (ctx, iter);
 			if (lang != NULL)
 				as_component_set_name_variant_suffix (cpt, content, lang);
+			break;
+		}
+		default:
+			break;
 		}
 	}
 
@@ -4959,22 +6144,29 @@ as_component_xml_serialize_languages (AsComponent *cpt, xmlNode *cptnode)
  * as_component_to_xml_node:
  * @cpt: an #AsComponent.
  * @ctx: the AppStream document context.
+ * @doc: (nullable): serialization document to create the node in, e.g. from
+ *   as_xml_serialization_doc_new(). Sharing one document across many
+ *   components lets libxml2 intern the constant tag and attribute names
+ *   instead of duplicating them for every node.
  * @root: XML node to attach the new nodes to.
  *
  * Serializes the data to an XML node.
  **/
 xmlNode *
-as_component_to_xml_node (AsComponent *cpt, AsContext *ctx, xmlNode *root)
+as_component_to_xml_node (AsComponent *cpt, AsContext *ctx, xmlDoc *doc, xmlNode *root)
 {
 	AsComponentPrivate *priv = GET_PRIVATE (cpt);
 	AsFormatStyle format_style;
 	xmlNode *cnode;
 
+	/* serialization reads the deferred data directly */
+	as_component_lazy_materialize (cpt);
+
 	format_style = as_context_get_style (ctx);
 
 	/* define component root node properties */
 	if (root == NULL)
-		cnode = xmlNewNode (NULL, (xmlChar *) "component");
+		cnode = xmlNewDocNode (doc, NULL, (xmlChar *) "component", NULL);
 	else
 		cnode = as_xml_add_node (root, "component");
 
@@ -5233,6 +6425,41 @@ as_component_to_xml_node (AsComponent *cpt, AsContext *ctx, xmlNode *root)
 			as_xml_add_text_node (cnode, "_asi_branch", priv->branch);
 	}
 
+	/* prebuilt search token index */
+	if (as_context_get_write_search_tokens (ctx) && priv->merge_kind == AS_MERGE_KIND_NONE) {
+		GHashTable *token_cache = as_component_get_token_cache_table (cpt);
+
+		if (g_hash_table_size (token_cache) > 0) {
+			xmlNode *tokens_node = as_xml_add_node (cnode, "_asi_tokens");
+			g_autoptr(GPtrArray) tokens = NULL;
+			GHashTableIter ht_iter;
+			gpointer ht_key;
+
+			as_xml_add_text_prop (tokens_node,
+					      "locale",
+					      as_component_get_active_locale (cpt));
+
+			/* sort the tokens to keep the serialization reproducible */
+			tokens = g_ptr_array_sized_new (g_hash_table_size (token_cache));
+			g_hash_table_iter_init (&ht_iter, token_cache);
+			while (g_hash_table_iter_next (&ht_iter, &ht_key, NULL))
+				g_ptr_array_add (tokens, ht_key);
+			g_ptr_array_sort (tokens, as_component_strptr_cmp);
+
+			for (guint i = 0; i < tokens->len; i++) {
+				const gchar *token = g_ptr_array_index (tokens, i);
+				AsTokenType *match_pval = g_hash_table_lookup (token_cache,
+									       token);
+				g_autofree gchar *match_str = NULL;
+				xmlNode *tn;
+
+				match_str = g_strdup_printf ("%u", (guint) *match_pval);
+				tn = as_xml_add_text_node (tokens_node, "t", token);
+				as_xml_add_text_prop (tn, "m", match_str);
+			}
+		}
+	}
+
 	return cnode;
 }
 
@@ -5628,18 +6855,31 @@ as_component_load_from_yaml (AsComponent *cpt, AsContext *ctx, GNode *root, GErr
 			priv->pkgnames = g_new0 (gchar *, 1 + 1);
 			priv->pkgnames[0] = g_strdup (value);
 			priv->pkgnames[1] = NULL;
-			g_object_notify ((GObject *) cpt, "pkgnames");
+			as_component_notify (cpt, AS_COMPONENT_PKGNAMES);
 		} else if (field_id == AS_TAG_SOURCE_PKGNAME) {
 			as_component_set_source_pkgname (cpt, value);
 		} else if (field_id == AS_TAG_NAME) {
-			as_yaml_set_localized_table (ctx, node, priv->name);
-			g_object_notify ((GObject *) cpt, "name");
+			as_yaml_set_localized_table (
+			    ctx,
+			    node,
+			    as_component_l10n_table_writable (cpt,
+							      AS_COMPONENT_L10N_SHARED_NAME));
+			as_component_notify (cpt, AS_COMPONENT_NAME);
 		} else if (field_id == AS_TAG_SUMMARY) {
-			as_yaml_set_localized_table (ctx, node, priv->summary);
-			g_object_notify ((GObject *) cpt, "summary");
+			as_yaml_set_localized_table (
+			    ctx,
+			    node,
+			    as_component_l10n_table_writable (cpt,
+							      AS_COMPONENT_L10N_SHARED_SUMMARY));
+			as_component_notify (cpt, AS_COMPONENT_SUMMARY);
 		} else if (field_id == AS_TAG_DESCRIPTION) {
-			as_yaml_set_localized_table (ctx, node, priv->description);
-			g_object_notify ((GObject *) cpt, "description");
+			as_yaml_set_localized_table (
+			    ctx,
+			    node,
+			    as_component_l10n_table_writable (
+				cpt,
+				AS_COMPONENT_L10N_SHARED_DESCRIPTION));
+			as_component_notify (cpt, AS_COMPONENT_DESCRIPTION);
 		} else if (field_id == AS_TAG_DEVELOPER) {
 			g_autoptr(AsDeveloper) developer = as_developer_new ();
 			if (as_developer_load_from_yaml (developer, ctx, node, NULL)) {
@@ -5660,9 +6900,9 @@ as_component_load_from_yaml (AsComponent *cpt, AsContext *ctx, GNode *root, GErr
 		} else if (field_id == AS_TAG_PROJECT_GROUP) {
 			as_component_set_project_group (cpt, value);
 		} else if (field_id == AS_TAG_CATEGORIES) {
-			as_yaml_list_to_str_array (node, priv->categories);
+			as_yaml_list_to_refstr_array (node, priv->categories);
 		} else if (field_id == AS_TAG_COMPULSORY_FOR_DESKTOP) {
-			as_yaml_list_to_str_array (node, priv->compulsory_for_desktops);
+			as_yaml_list_to_refstr_array (node, priv->compulsory_for_desktops);
 		} else if (field_id == AS_TAG_EXTENDS) {
 			as_yaml_list_to_str_array (node, priv->extends);
 		} else if (field_id == AS_TAG_KEYWORDS) {
@@ -6143,6 +7383,9 @@ as_component_emit_yaml (AsComponent *cpt, AsContext *ctx, yaml_emitter_t *emitte
 	gint res;
 	yaml_event_t event;
 
+	/* serialization reads the deferred data directly */
+	as_component_lazy_materialize (cpt);
+
 	/* new document for this component */
 	yaml_document_start_event_initialize (&event, NULL, NULL, NULL, FALSE);
 	res = yaml_emitter_emit (emitter, &event);
@@ -6571,10 +7814,966 @@ as_component_to_xml_data (AsComponent *cpt, AsContext *context, GError **error)
 	xmlNode *node;
 	g_return_val_if_fail (context != NULL, NULL);
 
-	node = as_component_to_xml_node (cpt, context, NULL);
+	node = as_component_to_xml_node (cpt, context, NULL, NULL);
 	return as_xml_node_free_to_str (node, error);
 }
 
+/* magic bytes and format revision of the compact binary component serialization */
+#define AS_COMPONENT_BYTES_MAGIC	  "AsCb"
+#define AS_COMPONENT_BYTES_FORMAT_VERSION 1
+
+/**
+ * AsComponentBytesField:
+ *
+ * Field identifiers of the binary component serialization.
+ * The values are part of the wire format and must never be changed,
+ * only extended. Unknown fields are skipped on deserialization.
+ */
+typedef enum {
+	AS_BFIELD_XML_FALLBACK	      = 0x01,
+	AS_BFIELD_KIND		      = 0x02,
+	AS_BFIELD_SCOPE		      = 0x03,
+	AS_BFIELD_MERGE_KIND	      = 0x04,
+	AS_BFIELD_PRIORITY	      = 0x05,
+	AS_BFIELD_ID		      = 0x06,
+	AS_BFIELD_ORIGIN	      = 0x07,
+	AS_BFIELD_BRANCH	      = 0x08,
+	AS_BFIELD_DATE_EOL	      = 0x09,
+	AS_BFIELD_SOURCE_PKGNAME      = 0x0a,
+	AS_BFIELD_METADATA_LICENSE    = 0x0b,
+	AS_BFIELD_PROJECT_LICENSE     = 0x0c,
+	AS_BFIELD_PROJECT_GROUP	      = 0x0d,
+	AS_BFIELD_ARCHITECTURE	      = 0x0e,
+	AS_BFIELD_PKGNAMES	      = 0x0f,
+	AS_BFIELD_NAME		      = 0x10,
+	AS_BFIELD_SUMMARY	      = 0x11,
+	AS_BFIELD_DESCRIPTION	      = 0x12,
+	AS_BFIELD_NAME_VARIANT_SUFFIX = 0x13,
+	AS_BFIELD_KEYWORDS	      = 0x14,
+	AS_BFIELD_URLS		      = 0x15,
+	AS_BFIELD_LANGUAGES	      = 0x16,
+	AS_BFIELD_CUSTOM	      = 0x17,
+	AS_BFIELD_CATEGORIES	      = 0x18,
+	AS_BFIELD_COMPULSORY	      = 0x19,
+	AS_BFIELD_EXTENDS	      = 0x1a,
+	AS_BFIELD_REPLACES	      = 0x1b,
+	AS_BFIELD_TAGS		      = 0x1c,
+	AS_BFIELD_PROVIDED	      = 0x1d,
+	AS_BFIELD_ICONS		      = 0x1e,
+	AS_BFIELD_LAUNCHABLES	      = 0x1f,
+	AS_BFIELD_BUNDLES	      = 0x20,
+} AsComponentBytesField;
+
+static void
+as_bin_buf_put_u8 (GByteArray *buf, guint8 value)
+{
+	g_byte_array_append (buf, &value, 1);
+}
+
+static void
+as_bin_buf_put_u32 (GByteArray *buf, guint32 value)
+{
+	guint32 le = GUINT32_TO_LE (value);
+	g_byte_array_append (buf, (const guint8 *) &le, sizeof (le));
+}
+
+/**
+ * as_bin_buf_put_string:
+ *
+ * Append a length-prefixed string, including its NUL terminator, so
+ * deserialization can hand out views into the buffer without copying.
+ * A zero length denotes %NULL.
+ */
+static void
+as_bin_buf_put_string (GByteArray *buf, const gchar *str)
+{
+	guint32 len;
+
+	if (str == NULL) {
+		as_bin_buf_put_u32 (buf, 0);
+		return;
+	}
+	len = (guint32) strlen (str) + 1;
+	as_bin_buf_put_u32 (buf, len);
+	g_byte_array_append (buf, (const guint8 *) str, len);
+}
+
+/**
+ * as_bin_buf_field_begin:
+ *
+ * Open a new field frame, consisting of the field identifier and a
+ * size placeholder that is patched once the payload length is known.
+ * Returns the payload start offset to pass to as_bin_buf_field_end().
+ */
+static guint
+as_bin_buf_field_begin (GByteArray *buf, guint8 field_id)
+{
+	as_bin_buf_put_u8 (buf, field_id);
+	as_bin_buf_put_u32 (buf, 0);
+	return buf->len;
+}
+
+static void
+as_bin_buf_field_end (GByteArray *buf, guint payload_start)
+{
+	guint32 size_le = GUINT32_TO_LE ((guint32) (buf->len - payload_start));
+	memcpy (buf->data + payload_start - sizeof (guint32), &size_le, sizeof (guint32));
+}
+
+static void
+as_bin_buf_put_string_field (GByteArray *buf, guint8 field_id, const gchar *str)
+{
+	guint pstart;
+
+	if (as_is_empty (str))
+		return;
+	pstart = as_bin_buf_field_begin (buf, field_id);
+	as_bin_buf_put_string (buf, str);
+	as_bin_buf_field_end (buf, pstart);
+}
+
+static void
+as_bin_buf_put_u8_field (GByteArray *buf, guint8 field_id, guint8 value)
+{
+	guint pstart = as_bin_buf_field_begin (buf, field_id);
+	as_bin_buf_put_u8 (buf, value);
+	as_bin_buf_field_end (buf, pstart);
+}
+
+static void
+as_bin_buf_put_strtable_field (GByteArray *buf, guint8 field_id, GHashTable *table)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+	guint pstart;
+
+	if (table == NULL || g_hash_table_size (table) == 0)
+		return;
+	pstart = as_bin_buf_field_begin (buf, field_id);
+	as_bin_buf_put_u32 (buf, g_hash_table_size (table));
+	g_hash_table_iter_init (&iter, table);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		as_bin_buf_put_string (buf, key);
+		as_bin_buf_put_string (buf, value);
+	}
+	as_bin_buf_field_end (buf, pstart);
+}
+
+static void
+as_bin_buf_put_strarray_field (GByteArray *buf, guint8 field_id, GPtrArray *array)
+{
+	guint pstart;
+
+	if (array == NULL || array->len == 0)
+		return;
+	pstart = as_bin_buf_field_begin (buf, field_id);
+	as_bin_buf_put_u32 (buf, array->len);
+	for (guint i = 0; i < array->len; i++)
+		as_bin_buf_put_string (buf, g_ptr_array_index (array, i));
+	as_bin_buf_field_end (buf, pstart);
+}
+
+/**
+ * as_component_bytes_needs_xml_fallback:
+ *
+ * Check whether the component carries data which the binary format does
+ * not encode natively and which therefore rides in an embedded XML
+ * fragment. These are the structurally deep, comparatively rare
+ * elements, so the common catalog component stays fully binary.
+ */
+static gboolean
+as_component_bytes_needs_xml_fallback (AsComponent *cpt)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+
+	if (priv->developer != NULL || priv->branding != NULL)
+		return TRUE;
+	if (!as_release_list_is_empty (priv->releases))
+		return TRUE;
+	if (priv->requires->len > 0 || priv->recommends->len > 0 || priv->supports->len > 0)
+		return TRUE;
+	if (priv->screenshots->len > 0 || priv->suggestions->len > 0)
+		return TRUE;
+	if (priv->content_ratings->len > 0 || priv->agreements->len > 0)
+		return TRUE;
+	if (priv->reviews->len > 0 || priv->references->len > 0)
+		return TRUE;
+	if (priv->translations != NULL && priv->translations->len > 0)
+		return TRUE;
+	return FALSE;
+}
+
+/**
+ * as_component_bytes_xml_fallback_to_str:
+ *
+ * Serialize the complex child elements into a single component XML
+ * fragment, reusing the canonical XML serializers of the child objects.
+ */
+static gchar *
+as_component_bytes_xml_fallback_to_str (AsComponent *cpt, AsContext *ctx, GError **error)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	xmlNode *bnode;
+
+	bnode = xmlNewDocNode (NULL, NULL, (xmlChar *) "component", NULL);
+
+	if (priv->developer != NULL)
+		as_developer_to_xml_node (priv->developer, ctx, bnode);
+
+	if (priv->requires->len > 0) {
+		xmlNode *rqnode = as_xml_add_node (bnode, "requires");
+		for (guint i = 0; i < priv->requires->len; i++)
+			as_relation_to_xml_node (AS_RELATION (g_ptr_array_index (priv->requires, i)),
+						 ctx,
+						 rqnode);
+	}
+	if (priv->recommends->len > 0) {
+		xmlNode *rcnode = as_xml_add_node (bnode, "recommends");
+		for (guint i = 0; i < priv->recommends->len; i++)
+			as_relation_to_xml_node (
+			    AS_RELATION (g_ptr_array_index (priv->recommends, i)),
+			    ctx,
+			    rcnode);
+	}
+	if (priv->supports->len > 0) {
+		xmlNode *spnode = as_xml_add_node (bnode, "supports");
+		for (guint i = 0; i < priv->supports->len; i++)
+			as_relation_to_xml_node (AS_RELATION (g_ptr_array_index (priv->supports, i)),
+						 ctx,
+						 spnode);
+	}
+
+	for (guint i = 0; i < priv->suggestions->len; i++)
+		as_suggested_to_xml_node (AS_SUGGESTED (g_ptr_array_index (priv->suggestions, i)),
+					  ctx,
+					  bnode);
+
+	if (priv->translations != NULL) {
+		for (guint i = 0; i < priv->translations->len; i++)
+			as_translation_to_xml_node (
+			    AS_TRANSLATION (g_ptr_array_index (priv->translations, i)),
+			    ctx,
+			    bnode);
+	}
+
+	if (priv->screenshots->len > 0) {
+		xmlNode *scrnode = as_xml_add_node (bnode, "screenshots");
+
+		/* restore default screenshot order */
+		as_component_sort_screenshots (cpt, NULL, NULL, FALSE);
+		for (guint i = 0; i < priv->screenshots->len; i++)
+			as_screenshot_to_xml_node (
+			    AS_SCREENSHOT (g_ptr_array_index (priv->screenshots, i)),
+			    ctx,
+			    scrnode);
+	}
+
+	as_release_list_to_xml_node (priv->releases, ctx, bnode);
+
+	for (guint i = 0; i < priv->content_ratings->len; i++)
+		as_content_rating_to_xml_node (
+		    AS_CONTENT_RATING (g_ptr_array_index (priv->content_ratings, i)),
+		    ctx,
+		    bnode);
+
+	for (guint i = 0; i < priv->agreements->len; i++)
+		as_agreement_to_xml_node (AS_AGREEMENT (g_ptr_array_index (priv->agreements, i)),
+					  ctx,
+					  bnode);
+
+	if (priv->branding != NULL)
+		as_branding_to_xml_node (priv->branding, ctx, bnode);
+
+	if (priv->references->len > 0) {
+		xmlNode *refs_node = as_xml_add_node (bnode, "references");
+		for (guint i = 0; i < priv->references->len; i++)
+			as_reference_to_xml_node (
+			    AS_REFERENCE (g_ptr_array_index (priv->references, i)),
+			    ctx,
+			    refs_node);
+	}
+
+	if (priv->reviews->len > 0) {
+		xmlNode *rnode = as_xml_add_node (bnode, "reviews");
+		for (guint i = 0; i < priv->reviews->len; i++)
+			as_review_to_xml_node (AS_REVIEW (g_ptr_array_index (priv->reviews, i)),
+					       ctx,
+					       rnode);
+	}
+
+	return as_xml_node_free_to_str (bnode, error);
+}
+
+/**
+ * as_component_to_bytes:
+ * @cpt: an #AsComponent instance.
+ * @context: an #AsContext instance.
+ * @error: a #GError.
+ *
+ * Serialize this component into a compact, versioned binary format,
+ * suitable for cheaply shipping components between processes.
+ * The format is a private serialization of this library: it is
+ * guaranteed to be readable by as_component_from_bytes() of the same
+ * library version, but makes no cross-version stability promises and
+ * must never be stored on disk or exchanged with other machines.
+ *
+ * It is significantly cheaper to write and read than the XML round
+ * trip of #AsMetadata: the common component data is encoded as raw
+ * length-prefixed fields, and only structurally deep elements like
+ * screenshots or releases are carried in an embedded XML fragment.
+ *
+ * Returns: (transfer full): the serialized data, or %NULL on error.
+ *
+ * Since: 1.0.5
+ */
+GBytes *
+as_component_to_bytes (AsComponent *cpt, AsContext *context, GError **error)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	g_autoptr(GByteArray) buf = NULL;
+	guint pstart;
+
+	g_return_val_if_fail (context != NULL, NULL);
+
+	/* serialization reads the deferred data directly */
+	as_component_lazy_materialize (cpt);
+
+	buf = g_byte_array_sized_new (1024);
+	g_byte_array_append (buf, (const guint8 *) AS_COMPONENT_BYTES_MAGIC, 4);
+	as_bin_buf_put_u32 (buf, AS_COMPONENT_BYTES_FORMAT_VERSION);
+
+	/* The XML fragment must be the first field: deserializing it resets
+	 * state like the component kind and description tables, which the
+	 * binary fields following it set authoritatively. */
+	if (as_component_bytes_needs_xml_fallback (cpt)) {
+		g_autofree gchar *xml_data = NULL;
+
+		xml_data = as_component_bytes_xml_fallback_to_str (cpt, context, error);
+		if (xml_data == NULL)
+			return NULL;
+		as_bin_buf_put_string_field (buf, AS_BFIELD_XML_FALLBACK, xml_data);
+	}
+
+	if (priv->kind != AS_COMPONENT_KIND_UNKNOWN)
+		as_bin_buf_put_u8_field (buf, AS_BFIELD_KIND, priv->kind);
+	if (priv->scope != AS_COMPONENT_SCOPE_UNKNOWN)
+		as_bin_buf_put_u8_field (buf, AS_BFIELD_SCOPE, priv->scope);
+	if (priv->merge_kind != AS_MERGE_KIND_NONE)
+		as_bin_buf_put_u8_field (buf, AS_BFIELD_MERGE_KIND, priv->merge_kind);
+	if (priv->priority != 0) {
+		pstart = as_bin_buf_field_begin (buf, AS_BFIELD_PRIORITY);
+		as_bin_buf_put_u32 (buf, (guint32) priv->priority);
+		as_bin_buf_field_end (buf, pstart);
+	}
+
+	as_bin_buf_put_string_field (buf, AS_BFIELD_ID, priv->id);
+	as_bin_buf_put_string_field (buf, AS_BFIELD_ORIGIN, priv->origin);
+	as_bin_buf_put_string_field (buf, AS_BFIELD_BRANCH, priv->branch);
+	as_bin_buf_put_string_field (buf, AS_BFIELD_DATE_EOL, priv->date_eol);
+	as_bin_buf_put_string_field (buf, AS_BFIELD_SOURCE_PKGNAME, priv->source_pkgname);
+	as_bin_buf_put_string_field (buf, AS_BFIELD_METADATA_LICENSE, priv->metadata_license);
+	as_bin_buf_put_string_field (buf, AS_BFIELD_PROJECT_LICENSE, priv->project_license);
+	as_bin_buf_put_string_field (buf, AS_BFIELD_PROJECT_GROUP, priv->project_group);
+	as_bin_buf_put_string_field (buf, AS_BFIELD_ARCHITECTURE, priv->arch);
+
+	if (priv->pkgnames != NULL && priv->pkgnames[0] != NULL) {
+		guint n = g_strv_length (priv->pkgnames);
+		pstart = as_bin_buf_field_begin (buf, AS_BFIELD_PKGNAMES);
+		as_bin_buf_put_u32 (buf, n);
+		for (guint i = 0; i < n; i++)
+			as_bin_buf_put_string (buf, priv->pkgnames[i]);
+		as_bin_buf_field_end (buf, pstart);
+	}
+
+	as_bin_buf_put_strtable_field (buf, AS_BFIELD_NAME, priv->name);
+	as_bin_buf_put_strtable_field (buf, AS_BFIELD_SUMMARY, priv->summary);
+	as_bin_buf_put_strtable_field (buf, AS_BFIELD_DESCRIPTION, priv->description);
+	as_bin_buf_put_strtable_field (buf,
+				       AS_BFIELD_NAME_VARIANT_SUFFIX,
+				       priv->name_variant_suffix);
+	as_bin_buf_put_strtable_field (buf, AS_BFIELD_CUSTOM, priv->custom);
+
+	if (g_hash_table_size (priv->keywords) > 0) {
+		GHashTableIter iter;
+		gpointer key, value;
+
+		pstart = as_bin_buf_field_begin (buf, AS_BFIELD_KEYWORDS);
+		as_bin_buf_put_u32 (buf, g_hash_table_size (priv->keywords));
+		g_hash_table_iter_init (&iter, priv->keywords);
+		while (g_hash_table_iter_next (&iter, &key, &value)) {
+			GPtrArray *kws = value;
+
+			as_bin_buf_put_string (buf, key);
+			as_bin_buf_put_u32 (buf, kws->len);
+			for (guint i = 0; i < kws->len; i++)
+				as_bin_buf_put_string (buf, g_ptr_array_index (kws, i));
+		}
+		as_bin_buf_field_end (buf, pstart);
+	}
+
+	if (g_hash_table_size (priv->urls) > 0) {
+		pstart = as_bin_buf_field_begin (buf, AS_BFIELD_URLS);
+		as_bin_buf_put_u32 (buf, g_hash_table_size (priv->urls));
+		for (guint i = AS_URL_KIND_UNKNOWN; i < AS_URL_KIND_LAST; i++) {
+			const gchar *value = as_component_get_url (cpt, i);
+			if (value == NULL)
+				continue;
+			as_bin_buf_put_u8 (buf, (guint8) i);
+			as_bin_buf_put_string (buf, value);
+		}
+		as_bin_buf_field_end (buf, pstart);
+	}
+
+	if (g_hash_table_size (priv->languages) > 0) {
+		GHashTableIter iter;
+		gpointer key, value;
+
+		pstart = as_bin_buf_field_begin (buf, AS_BFIELD_LANGUAGES);
+		as_bin_buf_put_u32 (buf, g_hash_table_size (priv->languages));
+		g_hash_table_iter_init (&iter, priv->languages);
+		while (g_hash_table_iter_next (&iter, &key, &value)) {
+			as_bin_buf_put_string (buf, key);
+			as_bin_buf_put_u32 (buf, (guint32) GPOINTER_TO_INT (value));
+		}
+		as_bin_buf_field_end (buf, pstart);
+	}
+
+	as_bin_buf_put_strarray_field (buf, AS_BFIELD_CATEGORIES, priv->categories);
+	as_bin_buf_put_strarray_field (buf, AS_BFIELD_COMPULSORY, priv->compulsory_for_desktops);
+	as_bin_buf_put_strarray_field (buf, AS_BFIELD_EXTENDS, priv->extends);
+	as_bin_buf_put_strarray_field (buf, AS_BFIELD_REPLACES, priv->replaces);
+	as_bin_buf_put_strarray_field (buf, AS_BFIELD_TAGS, priv->tags);
+
+	if (priv->provided->len > 0) {
+		pstart = as_bin_buf_field_begin (buf, AS_BFIELD_PROVIDED);
+		as_bin_buf_put_u32 (buf, priv->provided->len);
+		for (guint i = 0; i < priv->provided->len; i++) {
+			AsProvided *prov = AS_PROVIDED (g_ptr_array_index (priv->provided, i));
+			GPtrArray *items = as_provided_get_items (prov);
+
+			as_bin_buf_put_u8 (buf, (guint8) as_provided_get_kind (prov));
+			as_bin_buf_put_u32 (buf, items->len);
+			for (guint j = 0; j < items->len; j++)
+				as_bin_buf_put_string (buf, g_ptr_array_index (items, j));
+		}
+		as_bin_buf_field_end (buf, pstart);
+	}
+
+	if (priv->icons->len > 0) {
+		pstart = as_bin_buf_field_begin (buf, AS_BFIELD_ICONS);
+		as_bin_buf_put_u32 (buf, priv->icons->len);
+		for (guint i = 0; i < priv->icons->len; i++) {
+			AsIcon *icon = AS_ICON (g_ptr_array_index (priv->icons, i));
+
+			as_bin_buf_put_u8 (buf, (guint8) as_icon_get_kind (icon));
+			as_bin_buf_put_u32 (buf, as_icon_get_width (icon));
+			as_bin_buf_put_u32 (buf, as_icon_get_height (icon));
+			as_bin_buf_put_u32 (buf, as_icon_get_scale (icon));
+			as_bin_buf_put_string (buf, as_icon_get_name (icon));
+			as_bin_buf_put_string (buf, as_icon_get_filename (icon));
+			as_bin_buf_put_string (buf, as_icon_get_url (icon));
+		}
+		as_bin_buf_field_end (buf, pstart);
+	}
+
+	if (priv->launchables->len > 0) {
+		pstart = as_bin_buf_field_begin (buf, AS_BFIELD_LAUNCHABLES);
+		as_bin_buf_put_u32 (buf, priv->launchables->len);
+		for (guint i = 0; i < priv->launchables->len; i++) {
+			AsLaunchable *launch = AS_LAUNCHABLE (
+			    g_ptr_array_index (priv->launchables, i));
+			GPtrArray *entries = as_launchable_get_entries (launch);
+
+			as_bin_buf_put_u8 (buf, (guint8) as_launchable_get_kind (launch));
+			as_bin_buf_put_u32 (buf, entries->len);
+			for (guint j = 0; j < entries->len; j++)
+				as_bin_buf_put_string (buf, g_ptr_array_index (entries, j));
+		}
+		as_bin_buf_field_end (buf, pstart);
+	}
+
+	if (priv->bundles->len > 0) {
+		pstart = as_bin_buf_field_begin (buf, AS_BFIELD_BUNDLES);
+		as_bin_buf_put_u32 (buf, priv->bundles->len);
+		for (guint i = 0; i < priv->bundles->len; i++) {
+			AsBundle *bundle = AS_BUNDLE (g_ptr_array_index (priv->bundles, i));
+
+			as_bin_buf_put_u8 (buf, (guint8) as_bundle_get_kind (bundle));
+			as_bin_buf_put_string (buf, as_bundle_get_id (bundle));
+		}
+		as_bin_buf_field_end (buf, pstart);
+	}
+
+	return g_byte_array_free_to_bytes (g_steal_pointer (&buf));
+}
+
+typedef struct {
+	const guint8 *data;
+	gsize len;
+	gsize pos;
+} AsBinReader;
+
+static gboolean
+as_bin_reader_get_u8 (AsBinReader *br, guint8 *value, GError **error)
+{
+	if (br->len - br->pos < 1) {
+		g_set_error_literal (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "Premature end of binary component data.");
+		return FALSE;
+	}
+	*value = br->data[br->pos++];
+	return TRUE;
+}
+
+static gboolean
+as_bin_reader_get_u32 (AsBinReader *br, guint32 *value, GError **error)
+{
+	guint32 le;
+
+	if (br->len - br->pos < sizeof (le)) {
+		g_set_error_literal (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "Premature end of binary component data.");
+		return FALSE;
+	}
+	memcpy (&le, br->data + br->pos, sizeof (le));
+	br->pos += sizeof (le);
+	*value = GUINT32_FROM_LE (le);
+	return TRUE;
+}
+
+/**
+ * as_bin_reader_get_string:
+ *
+ * Read a length-prefixed string as a view into the serialized buffer,
+ * without copying it. The view is only valid while the buffer is alive;
+ * the component setters it is passed to copy or intern the value.
+ */
+static gboolean
+as_bin_reader_get_string (AsBinReader *br, const gchar **str, GError **error)
+{
+	guint32 len;
+
+	if (!as_bin_reader_get_u32 (br, &len, error))
+		return FALSE;
+	if (len == 0) {
+		*str = NULL;
+		return TRUE;
+	}
+	if (len > br->len - br->pos || br->data[br->pos + len - 1] != '\0') {
+		g_set_error_literal (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "Malformed string in binary component data.");
+		return FALSE;
+	}
+	*str = (const gchar *) (br->data + br->pos);
+	br->pos += len;
+	return TRUE;
+}
+
+/**
+ * as_component_from_bytes_field:
+ *
+ * Deserialize one field frame of the binary component format.
+ * @br is limited to the payload of the field.
+ */
+static gboolean
+as_component_from_bytes_field (AsComponent *cpt,
+			       AsContext *ctx,
+			       guint8 field_id,
+			       AsBinReader *br,
+			       GError **error)
+{
+	AsComponentPrivate *priv = GET_PRIVATE (cpt);
+	const gchar *str = NULL;
+	guint8 u8v = 0;
+	guint32 u32v = 0;
+	guint32 count = 0;
+
+	switch (field_id) {
+	case AS_BFIELD_XML_FALLBACK: {
+		xmlDoc *doc;
+		gboolean ret;
+
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		if (str == NULL)
+			return TRUE;
+		doc = as_xml_parse_document (str, -1, FALSE, error);
+		if (doc == NULL)
+			return FALSE;
+		ret = as_component_load_from_xml (cpt, ctx, xmlDocGetRootElement (doc), error);
+		xmlFreeDoc (doc);
+		return ret;
+	}
+	case AS_BFIELD_KIND:
+		if (!as_bin_reader_get_u8 (br, &u8v, error))
+			return FALSE;
+		if (u8v < AS_COMPONENT_KIND_LAST)
+			priv->kind = u8v;
+		return TRUE;
+	case AS_BFIELD_SCOPE:
+		if (!as_bin_reader_get_u8 (br, &u8v, error))
+			return FALSE;
+		if (u8v < AS_COMPONENT_SCOPE_LAST)
+			priv->scope = u8v;
+		return TRUE;
+	case AS_BFIELD_MERGE_KIND:
+		if (!as_bin_reader_get_u8 (br, &u8v, error))
+			return FALSE;
+		if (u8v < AS_MERGE_KIND_LAST)
+			priv->merge_kind = u8v;
+		return TRUE;
+	case AS_BFIELD_PRIORITY:
+		if (!as_bin_reader_get_u32 (br, &u32v, error))
+			return FALSE;
+		priv->priority = (gint) (gint32) u32v;
+		return TRUE;
+	case AS_BFIELD_ID:
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		as_component_set_id (cpt, str);
+		return TRUE;
+	case AS_BFIELD_ORIGIN:
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		as_component_set_origin (cpt, str);
+		return TRUE;
+	case AS_BFIELD_BRANCH:
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		as_component_set_branch (cpt, str);
+		return TRUE;
+	case AS_BFIELD_DATE_EOL:
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		as_component_set_date_eol (cpt, str);
+		return TRUE;
+	case AS_BFIELD_SOURCE_PKGNAME:
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		as_component_set_source_pkgname (cpt, str);
+		return TRUE;
+	case AS_BFIELD_METADATA_LICENSE:
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		as_component_set_metadata_license (cpt, str);
+		return TRUE;
+	case AS_BFIELD_PROJECT_LICENSE:
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		as_component_set_project_license (cpt, str);
+		return TRUE;
+	case AS_BFIELD_PROJECT_GROUP:
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		as_component_set_project_group (cpt, str);
+		return TRUE;
+	case AS_BFIELD_ARCHITECTURE:
+		if (!as_bin_reader_get_string (br, &str, error))
+			return FALSE;
+		as_component_set_architecture (cpt, str);
+		return TRUE;
+	case AS_BFIELD_PKGNAMES: {
+		g_autoptr(GPtrArray) strv = NULL;
+
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		/* never preallocate from the wire-supplied count - a malformed
+		 * message must fail with a parse error, not a huge allocation */
+		strv = g_ptr_array_new ();
+		for (guint32 i = 0; i < count; i++) {
+			if (!as_bin_reader_get_string (br, &str, error))
+				return FALSE;
+			g_ptr_array_add (strv, (gchar *) str);
+		}
+		g_ptr_array_add (strv, NULL);
+		as_component_set_pkgnames (cpt, (gchar **) strv->pdata);
+		return TRUE;
+	}
+	case AS_BFIELD_NAME:
+	case AS_BFIELD_SUMMARY:
+	case AS_BFIELD_DESCRIPTION:
+	case AS_BFIELD_NAME_VARIANT_SUFFIX:
+	case AS_BFIELD_CUSTOM: {
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		for (guint32 i = 0; i < count; i++) {
+			const gchar *key = NULL;
+			const gchar *value = NULL;
+
+			if (!as_bin_reader_get_string (br, &key, error) ||
+			    !as_bin_reader_get_string (br, &value, error))
+				return FALSE;
+			if (key == NULL || value == NULL)
+				continue;
+			if (field_id == AS_BFIELD_NAME)
+				as_component_set_name (cpt, value, key);
+			else if (field_id == AS_BFIELD_SUMMARY)
+				as_component_set_summary (cpt, value, key);
+			else if (field_id == AS_BFIELD_DESCRIPTION)
+				as_component_set_description (cpt, value, key);
+			else if (field_id == AS_BFIELD_NAME_VARIANT_SUFFIX)
+				as_component_set_name_variant_suffix (cpt, value, key);
+			else
+				as_component_insert_custom_value (cpt, key, value);
+		}
+		return TRUE;
+	}
+	case AS_BFIELD_KEYWORDS: {
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		for (guint32 i = 0; i < count; i++) {
+			const gchar *locale = NULL;
+			guint32 n_kws = 0;
+
+			if (!as_bin_reader_get_string (br, &locale, error) ||
+			    !as_bin_reader_get_u32 (br, &n_kws, error))
+				return FALSE;
+			for (guint32 j = 0; j < n_kws; j++) {
+				if (!as_bin_reader_get_string (br, &str, error))
+					return FALSE;
+				as_component_add_keyword (cpt, str, locale);
+			}
+		}
+		return TRUE;
+	}
+	case AS_BFIELD_URLS: {
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		for (guint32 i = 0; i < count; i++) {
+			if (!as_bin_reader_get_u8 (br, &u8v, error) ||
+			    !as_bin_reader_get_string (br, &str, error))
+				return FALSE;
+			if (u8v < AS_URL_KIND_LAST)
+				as_component_add_url (cpt, u8v, str);
+		}
+		return TRUE;
+	}
+	case AS_BFIELD_LANGUAGES: {
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		for (guint32 i = 0; i < count; i++) {
+			if (!as_bin_reader_get_string (br, &str, error) ||
+			    !as_bin_reader_get_u32 (br, &u32v, error))
+				return FALSE;
+			as_component_add_language (cpt, str, (gint) u32v);
+		}
+		return TRUE;
+	}
+	case AS_BFIELD_CATEGORIES:
+	case AS_BFIELD_COMPULSORY:
+	case AS_BFIELD_EXTENDS:
+	case AS_BFIELD_REPLACES:
+	case AS_BFIELD_TAGS: {
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		for (guint32 i = 0; i < count; i++) {
+			if (!as_bin_reader_get_string (br, &str, error))
+				return FALSE;
+			if (str == NULL)
+				continue;
+			if (field_id == AS_BFIELD_CATEGORIES) {
+				as_component_add_category (cpt, str);
+			} else if (field_id == AS_BFIELD_COMPULSORY) {
+				as_component_set_compulsory_for_desktop (cpt, str);
+			} else if (field_id == AS_BFIELD_EXTENDS) {
+				as_component_add_extends (cpt, str);
+			} else if (field_id == AS_BFIELD_REPLACES) {
+				as_component_add_replaces (cpt, str);
+			} else {
+				g_auto(GStrv) parts = g_strsplit (str, "::", 2);
+				if (parts[0] != NULL && parts[1] != NULL)
+					as_component_add_tag (cpt, parts[0], parts[1]);
+			}
+		}
+		return TRUE;
+	}
+	case AS_BFIELD_PROVIDED: {
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		for (guint32 i = 0; i < count; i++) {
+			guint32 n_items = 0;
+
+			if (!as_bin_reader_get_u8 (br, &u8v, error) ||
+			    !as_bin_reader_get_u32 (br, &n_items, error))
+				return FALSE;
+			for (guint32 j = 0; j < n_items; j++) {
+				if (!as_bin_reader_get_string (br, &str, error))
+					return FALSE;
+				if (u8v < AS_PROVIDED_KIND_LAST)
+					as_component_add_provided_item (cpt, u8v, str);
+			}
+		}
+		return TRUE;
+	}
+	case AS_BFIELD_ICONS: {
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		for (guint32 i = 0; i < count; i++) {
+			g_autoptr(AsIcon) icon = as_icon_new ();
+			guint32 width = 0, height = 0, scale = 0;
+			const gchar *name = NULL;
+			const gchar *fname = NULL;
+			const gchar *url = NULL;
+
+			if (!as_bin_reader_get_u8 (br, &u8v, error) ||
+			    !as_bin_reader_get_u32 (br, &width, error) ||
+			    !as_bin_reader_get_u32 (br, &height, error) ||
+			    !as_bin_reader_get_u32 (br, &scale, error) ||
+			    !as_bin_reader_get_string (br, &name, error) ||
+			    !as_bin_reader_get_string (br, &fname, error) ||
+			    !as_bin_reader_get_string (br, &url, error))
+				return FALSE;
+			as_icon_set_kind (icon, u8v < AS_ICON_KIND_LAST ? u8v
+									: AS_ICON_KIND_UNKNOWN);
+			as_icon_set_width (icon, width);
+			as_icon_set_height (icon, height);
+			as_icon_set_scale (icon, scale);
+			if (name != NULL)
+				as_icon_set_name (icon, name);
+			if (fname != NULL)
+				as_icon_set_filename (icon, fname);
+			if (url != NULL)
+				as_icon_set_url (icon, url);
+			as_component_add_icon (cpt, icon);
+		}
+		return TRUE;
+	}
+	case AS_BFIELD_LAUNCHABLES: {
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		for (guint32 i = 0; i < count; i++) {
+			g_autoptr(AsLaunchable) launch = as_launchable_new ();
+			guint32 n_entries = 0;
+
+			if (!as_bin_reader_get_u8 (br, &u8v, error) ||
+			    !as_bin_reader_get_u32 (br, &n_entries, error))
+				return FALSE;
+			as_launchable_set_kind (launch,
+						u8v < AS_LAUNCHABLE_KIND_LAST
+						    ? u8v
+						    : AS_LAUNCHABLE_KIND_UNKNOWN);
+			for (guint32 j = 0; j < n_entries; j++) {
+				if (!as_bin_reader_get_string (br, &str, error))
+					return FALSE;
+				as_launchable_add_entry (launch, str);
+			}
+			as_component_add_launchable (cpt, launch);
+		}
+		return TRUE;
+	}
+	case AS_BFIELD_BUNDLES: {
+		if (!as_bin_reader_get_u32 (br, &count, error))
+			return FALSE;
+		for (guint32 i = 0; i < count; i++) {
+			g_autoptr(AsBundle) bundle = as_bundle_new ();
+
+			if (!as_bin_reader_get_u8 (br, &u8v, error) ||
+			    !as_bin_reader_get_string (br, &str, error))
+				return FALSE;
+			as_bundle_set_kind (bundle,
+					    u8v < AS_BUNDLE_KIND_LAST ? u8v
+								      : AS_BUNDLE_KIND_UNKNOWN);
+			as_bundle_set_id (bundle, str);
+			as_component_add_bundle (cpt, bundle);
+		}
+		return TRUE;
+	}
+	default:
+		/* unknown fields from a newer format revision are skipped */
+		return TRUE;
+	}
+}
+
+/**
+ * as_component_from_bytes:
+ * @cpt: an #AsComponent instance.
+ * @context: an #AsContext instance.
+ * @bytes: the data to load, created by as_component_to_bytes().
+ * @error: a #GError.
+ *
+ * Load this component from its compact binary serialization.
+ * String data is read as zero-copy views into @bytes and only copied
+ * or interned when it is stored in the component, making this path
+ * much cheaper than an XML round trip via #AsMetadata.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.0.5
+ */
+gboolean
+as_component_from_bytes (AsComponent *cpt, AsContext *context, GBytes *bytes, GError **error)
+{
+	AsBinReader br = { NULL, 0, 0 };
+	guint32 version = 0;
+
+	g_return_val_if_fail (context != NULL, FALSE);
+	g_return_val_if_fail (bytes != NULL, FALSE);
+
+	br.data = g_bytes_get_data (bytes, &br.len);
+	if (br.len < 4 + sizeof (guint32) ||
+	    memcmp (br.data, AS_COMPONENT_BYTES_MAGIC, 4) != 0) {
+		g_set_error_literal (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "Data is no binary component serialization.");
+		return FALSE;
+	}
+	br.pos = 4;
+	if (!as_bin_reader_get_u32 (&br, &version, error))
+		return FALSE;
+	if (version != AS_COMPONENT_BYTES_FORMAT_VERSION) {
+		g_set_error (error,
+			     AS_METADATA_ERROR,
+			     AS_METADATA_ERROR_PARSE,
+			     "Unsupported binary component format revision %u.",
+			     version);
+		return FALSE;
+	}
+
+	as_component_set_context (cpt, context);
+
+	/* deserialization never has property listeners */
+	as_component_set_bulk_load (cpt, TRUE);
+	while (br.pos < br.len) {
+		AsBinReader field_br = { NULL, 0, 0 };
+		guint8 field_id = 0;
+		guint32 field_size = 0;
+
+		if (!as_bin_reader_get_u8 (&br, &field_id, error) ||
+		    !as_bin_reader_get_u32 (&br, &field_size, error)) {
+			as_component_set_bulk_load (cpt, FALSE);
+			return FALSE;
+		}
+		if (field_size > br.len - br.pos) {
+			as_component_set_bulk_load (cpt, FALSE);
+			g_set_error_literal (error,
+					     AS_METADATA_ERROR,
+					     AS_METADATA_ERROR_PARSE,
+					     "Truncated field in binary component data.");
+			return FALSE;
+		}
+
+		/* limit the reader to this field, so a malformed payload can
+		 * never make us misinterpret the following fields */
+		field_br.data = br.data + br.pos;
+		field_br.len = field_size;
+		if (!as_component_from_bytes_field (cpt, context, field_id, &field_br, error)) {
+			as_component_set_bulk_load (cpt, FALSE);
+			return FALSE;
+		}
+		br.pos += field_size;
+	}
+	as_component_set_bulk_load (cpt, FALSE);
+
+	return TRUE;
+}
+
 /**
  * as_component_get_property:
  */
@@ -6693,184 +8892,158 @@ as_component_class_init (AsComponentClass *klass)
 	 *
 	 * the #AsComponentKind of this component
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_KIND,
-	    g_param_spec_enum ("kind",
-			       "kind",
-			       "kind",
-			       AS_TYPE_COMPONENT_KIND,
-			       0,
-			       G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				   G_PARAM_READABLE | G_PARAM_WRITABLE));
+	obj_properties[AS_COMPONENT_KIND] = g_param_spec_enum (
+	    "kind",
+	    "kind",
+	    "kind",
+	    AS_TYPE_COMPONENT_KIND,
+	    0,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
+		G_PARAM_READABLE | G_PARAM_WRITABLE);
 	/**
 	 * AsComponent:pkgnames:
 	 *
 	 * string array of packages name
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_PKGNAMES,
-	    g_param_spec_boxed ("pkgnames",
-				"pkgnames",
-				"pkgnames",
-				G_TYPE_STRV,
-				G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				    G_PARAM_READABLE | G_PARAM_WRITABLE));
+	obj_properties[AS_COMPONENT_PKGNAMES] = g_param_spec_boxed (
+	    "pkgnames",
+	    "pkgnames",
+	    "pkgnames",
+	    G_TYPE_STRV,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
+		G_PARAM_READABLE | G_PARAM_WRITABLE);
 	/**
 	 * AsComponent:id:
 	 *
 	 * the unique identifier
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_ID,
-	    g_param_spec_string ("id",
-				 "id",
-				 "id",
-				 NULL,
-				 G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				     G_PARAM_READABLE | G_PARAM_WRITABLE));
+	obj_properties[AS_COMPONENT_ID] = g_param_spec_string (
+	    "id",
+	    "id",
+	    "id",
+	    NULL,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
+		G_PARAM_READABLE | G_PARAM_WRITABLE);
 	/**
 	 * AsComponent:name:
 	 *
 	 * the name
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_NAME,
-	    g_param_spec_string ("name",
-				 "name",
-				 "name",
-				 NULL,
-				 G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				     G_PARAM_READABLE | G_PARAM_WRITABLE));
+	obj_properties[AS_COMPONENT_NAME] = g_param_spec_string (
+	    "name",
+	    "name",
+	    "name",
+	    NULL,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
+		G_PARAM_READABLE | G_PARAM_WRITABLE);
 	/**
 	 * AsComponent:summary:
 	 *
 	 * the summary
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_SUMMARY,
-	    g_param_spec_string ("summary",
-				 "summary",
-				 "summary",
-				 NULL,
-				 G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				     G_PARAM_READABLE | G_PARAM_WRITABLE));
+	obj_properties[AS_COMPONENT_SUMMARY] = g_param_spec_string (
+	    "summary",
+	    "summary",
+	    "summary",
+	    NULL,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
+		G_PARAM_READABLE | G_PARAM_WRITABLE);
 	/**
 	 * AsComponent:description:
 	 *
 	 * the description
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_DESCRIPTION,
-	    g_param_spec_string ("description",
-				 "description",
-				 "description",
-				 NULL,
-				 G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				     G_PARAM_READABLE | G_PARAM_WRITABLE));
+	obj_properties[AS_COMPONENT_DESCRIPTION] = g_param_spec_string (
+	    "description",
+	    "description",
+	    "description",
+	    NULL,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
+		G_PARAM_READABLE | G_PARAM_WRITABLE);
 	/**
 	 * AsComponent:keywords:
 	 *
 	 * string array of keywords
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_KEYWORDS,
-	    g_param_spec_boxed ("keywords",
-				"keywords",
-				"keywords",
-				G_TYPE_STRV,
-				G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				    G_PARAM_READABLE | G_PARAM_WRITABLE));
+	obj_properties[AS_COMPONENT_KEYWORDS] = g_param_spec_boxed (
+	    "keywords",
+	    "keywords",
+	    "keywords",
+	    G_TYPE_STRV,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
+		G_PARAM_READABLE | G_PARAM_WRITABLE);
 	/**
 	 * AsComponent:icons: (type GList(AsIcon))
 	 *
 	 * hash map of icon urls and sizes
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_ICONS,
-	    g_param_spec_pointer ("icons",
-				  "icons",
-				  "icons",
-				  G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				      G_PARAM_READABLE));
+	obj_properties[AS_COMPONENT_ICONS] = g_param_spec_pointer (
+	    "icons",
+	    "icons",
+	    "icons",
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB | G_PARAM_READABLE);
 	/**
 	 * AsComponent:urls: (type GHashTable(AsUrlKind,utf8))
 	 *
 	 * the urls associated with this component
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_URLS,
-	    g_param_spec_boxed ("urls",
-				"urls",
-				"urls",
-				G_TYPE_HASH_TABLE,
-				G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				    G_PARAM_READABLE));
+	obj_properties[AS_COMPONENT_URLS] = g_param_spec_boxed (
+	    "urls",
+	    "urls",
+	    "urls",
+	    G_TYPE_HASH_TABLE,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB | G_PARAM_READABLE);
 	/**
 	 * AsComponent:categories:
 	 *
 	 * string array of categories
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_CATEGORIES,
-	    g_param_spec_boxed ("categories",
-				"categories",
-				"categories",
-				G_TYPE_PTR_ARRAY,
-				G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				    G_PARAM_READABLE));
+	obj_properties[AS_COMPONENT_CATEGORIES] = g_param_spec_boxed (
+	    "categories",
+	    "categories",
+	    "categories",
+	    G_TYPE_PTR_ARRAY,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB | G_PARAM_READABLE);
 	/**
 	 * AsComponent:project-license:
 	 *
 	 * the project license
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_PROJECT_LICENSE,
-	    g_param_spec_string ("project-license",
-				 "project-license",
-				 "project-license",
-				 NULL,
-				 G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				     G_PARAM_READABLE | G_PARAM_WRITABLE));
+	obj_properties[AS_COMPONENT_PROJECT_LICENSE] = g_param_spec_string (
+	    "project-license",
+	    "project-license",
+	    "project-license",
+	    NULL,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
+		G_PARAM_READABLE | G_PARAM_WRITABLE);
 	/**
 	 * AsComponent:project-group:
 	 *
 	 * the project group
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_PROJECT_GROUP,
-	    g_param_spec_string ("project-group",
-				 "project-group",
-				 "project-group",
-				 NULL,
-				 G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				     G_PARAM_READABLE | G_PARAM_WRITABLE));
+	obj_properties[AS_COMPONENT_PROJECT_GROUP] = g_param_spec_string (
+	    "project-group",
+	    "project-group",
+	    "project-group",
+	    NULL,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
+		G_PARAM_READABLE | G_PARAM_WRITABLE);
 
 	/**
 	 * AsComponent:screenshots: (type GPtrArray(AsScreenshot)):
 	 *
 	 * An array of #AsScreenshot instances
 	 */
-	g_object_class_install_property (
-	    object_class,
-	    AS_COMPONENT_SCREENSHOTS,
-	    g_param_spec_boxed ("screenshots",
-				"screenshots",
-				"screenshots",
-				G_TYPE_PTR_ARRAY,
-				G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB |
-				    G_PARAM_READABLE));
+	obj_properties[AS_COMPONENT_SCREENSHOTS] = g_param_spec_boxed (
+	    "screenshots",
+	    "screenshots",
+	    "screenshots",
+	    G_TYPE_PTR_ARRAY,
+	    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK | G_PARAM_STATIC_BLURB | G_PARAM_READABLE);
+
+	/* registering all pspecs in one call lets GObject size its tables once,
+	 * and gives us the pspec pointers for fast by-pspec notifications */
+	g_object_class_install_properties (object_class, AS_COMPONENT_N_PROPERTIES, obj_properties);
 }
 
 /**
@@ -229,6 +229,7 @@ const gchar	*as_component_get_summary (AsComponent *cpt);
 void	     as_component_set_summary (AsComponent *cpt, const gchar *value, const gchar *locale);
 
 const gchar *as_component_get_description (AsComponent *cpt);
+GBytes	    *as_component_get_description_bytes (AsComponent *cpt);
 void	   as_component_set_description (AsComponent *cpt, const gchar *value, const gchar *locale);
 
 GPtrArray *as_component_get_launchables (AsComponent *cpt);
@@ -389,6 +390,12 @@ gboolean     as_component_load_from_bytes (AsComponent *cpt,
 					   GError     **error);
 gchar	    *as_component_to_xml_data (AsComponent *cpt, AsContext *context, GError **error);
 
+GBytes	    *as_component_to_bytes (AsComponent *cpt, AsContext *context, GError **error);
+gboolean     as_component_from_bytes (AsComponent *cpt,
+				      AsContext	  *context,
+				      GBytes	  *bytes,
+				      GError	 **error);
+
 G_END_DECLS
 
 #endif /* __AS_COMPONENT_H */
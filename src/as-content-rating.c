@@ -1193,14 +1193,16 @@ as_content_rating_attribute_get_description (const gchar *id, AsContentRatingVal
  * #AsContentRating values. */
 G_STATIC_ASSERT (AS_CONTENT_RATING_VALUE_LAST == AS_CONTENT_RATING_VALUE_INTENSE + 1);
 
-static const struct {
+typedef struct {
 	const gchar *id;
 	AsOarsVersion oars_version; /* when the key was first added */
 	guint csm_age_none;	    /* for %AS_CONTENT_RATING_VALUE_NONE */
 	guint csm_age_mild;	    /* for %AS_CONTENT_RATING_VALUE_MILD */
 	guint csm_age_moderate;	    /* for %AS_CONTENT_RATING_VALUE_MODERATE */
 	guint csm_age_intense;	    /* for %AS_CONTENT_RATING_VALUE_INTENSE */
-} oars_to_csm_mappings[] = {
+} AsOarsCsmMapping;
+
+static const AsOarsCsmMapping oars_to_csm_mappings[] = {
 	/* Each @id must only appear once. The set of @csm_age_* values for a
 	 * given @id must be complete and non-decreasing. */
 	/* v1.0 */
@@ -1235,6 +1237,52 @@ static const struct {
 	{ "violence-slavery",	      AS_OARS_VERSION_1_1, 0, 13, 15, 18},
 };
 
+/**
+ * as_oars_csm_mapping_lookup:
+ *
+ * Find the CSM age mapping entry for an OARS attribute ID, using binary
+ * search over a lazily built sorted index instead of scanning the whole
+ * mapping table for every attribute query.
+ *
+ * Returns: (nullable): The mapping entry, or %NULL if the ID is not known.
+ */
+static const AsOarsCsmMapping *
+as_oars_csm_mapping_lookup (const gchar *id)
+{
+	static const AsOarsCsmMapping *sorted_index[G_N_ELEMENTS (oars_to_csm_mappings)];
+	static gsize index_built = 0;
+	gsize lo, hi;
+
+	if (g_once_init_enter (&index_built)) {
+		/* insertion sort is plenty for a table of this size */
+		for (gsize i = 0; i < G_N_ELEMENTS (oars_to_csm_mappings); i++) {
+			const AsOarsCsmMapping *entry = &oars_to_csm_mappings[i];
+			gsize j = i;
+			while (j > 0 && g_strcmp0 (sorted_index[j - 1]->id, entry->id) > 0) {
+				sorted_index[j] = sorted_index[j - 1];
+				j--;
+			}
+			sorted_index[j] = entry;
+		}
+		g_once_init_leave (&index_built, 1);
+	}
+
+	lo = 0;
+	hi = G_N_ELEMENTS (sorted_index);
+	while (lo < hi) {
+		gsize mid = lo + (hi - lo) / 2;
+		gint cmp = g_strcmp0 (id, sorted_index[mid]->id);
+		if (cmp == 0)
+			return sorted_index[mid];
+		if (cmp < 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return NULL;
+}
+
 /**
  * as_is_oars_key:
  * @id: the subsection ID e.g. `violence-cartoon`
@@ -1247,11 +1295,11 @@ static const struct {
 gboolean
 as_is_oars_key (const gchar *id, AsOarsVersion version)
 {
-	for (gsize i = 0; i < G_N_ELEMENTS (oars_to_csm_mappings); i++) {
-		if (g_str_equal (id, oars_to_csm_mappings[i].id))
-			return (oars_to_csm_mappings[i].oars_version <= version);
-	}
-	return FALSE;
+	const AsOarsCsmMapping *mapping = as_oars_csm_mapping_lookup (id);
+
+	if (mapping == NULL)
+		return FALSE;
+	return mapping->oars_version <= version;
 }
 
 /**
@@ -1268,30 +1316,29 @@ as_is_oars_key (const gchar *id, AsOarsVersion version)
 guint
 as_content_rating_attribute_to_csm_age (const gchar *id, AsContentRatingValue value)
 {
+	const AsOarsCsmMapping *mapping;
+
 	if (value == AS_CONTENT_RATING_VALUE_UNKNOWN || value == AS_CONTENT_RATING_VALUE_LAST)
 		return 0;
 
-	for (gsize i = 0; i < G_N_ELEMENTS (oars_to_csm_mappings); i++) {
-		if (g_str_equal (id, oars_to_csm_mappings[i].id)) {
-			switch (value) {
-			case AS_CONTENT_RATING_VALUE_NONE:
-				return oars_to_csm_mappings[i].csm_age_none;
-			case AS_CONTENT_RATING_VALUE_MILD:
-				return oars_to_csm_mappings[i].csm_age_mild;
-			case AS_CONTENT_RATING_VALUE_MODERATE:
-				return oars_to_csm_mappings[i].csm_age_moderate;
-			case AS_CONTENT_RATING_VALUE_INTENSE:
-				return oars_to_csm_mappings[i].csm_age_intense;
-			default:
-				/* Handled above. */
-				g_assert_not_reached ();
-				return 0;
-			}
-		}
-	}
+	mapping = as_oars_csm_mapping_lookup (id);
+	if (mapping == NULL)
+		return 0;
 
-	/* @id not found. */
-	return 0;
+	switch (value) {
+	case AS_CONTENT_RATING_VALUE_NONE:
+		return mapping->csm_age_none;
+	case AS_CONTENT_RATING_VALUE_MILD:
+		return mapping->csm_age_mild;
+	case AS_CONTENT_RATING_VALUE_MODERATE:
+		return mapping->csm_age_moderate;
+	case AS_CONTENT_RATING_VALUE_INTENSE:
+		return mapping->csm_age_intense;
+	default:
+		/* Handled above. */
+		g_assert_not_reached ();
+		return 0;
+	}
 }
 
 /**
@@ -1318,22 +1365,21 @@ as_content_rating_attribute_to_csm_age (const gchar *id, AsContentRatingValue va
 AsContentRatingValue
 as_content_rating_attribute_from_csm_age (const gchar *id, guint age)
 {
-	for (gsize i = 0; G_N_ELEMENTS (oars_to_csm_mappings); i++) {
-		if (g_strcmp0 (id, oars_to_csm_mappings[i].id) == 0) {
-			if (age >= oars_to_csm_mappings[i].csm_age_intense)
-				return AS_CONTENT_RATING_VALUE_INTENSE;
-			else if (age >= oars_to_csm_mappings[i].csm_age_moderate)
-				return AS_CONTENT_RATING_VALUE_MODERATE;
-			else if (age >= oars_to_csm_mappings[i].csm_age_mild)
-				return AS_CONTENT_RATING_VALUE_MILD;
-			else if (age >= oars_to_csm_mappings[i].csm_age_none)
-				return AS_CONTENT_RATING_VALUE_NONE;
-			else
-				return AS_CONTENT_RATING_VALUE_UNKNOWN;
-		}
-	}
+	const AsOarsCsmMapping *mapping = as_oars_csm_mapping_lookup (id);
 
-	return AS_CONTENT_RATING_VALUE_UNKNOWN;
+	if (mapping == NULL)
+		return AS_CONTENT_RATING_VALUE_UNKNOWN;
+
+	if (age >= mapping->csm_age_intense)
+		return AS_CONTENT_RATING_VALUE_INTENSE;
+	else if (age >= mapping->csm_age_moderate)
+		return AS_CONTENT_RATING_VALUE_MODERATE;
+	else if (age >= mapping->csm_age_mild)
+		return AS_CONTENT_RATING_VALUE_MILD;
+	else if (age >= mapping->csm_age_none)
+		return AS_CONTENT_RATING_VALUE_NONE;
+	else
+		return AS_CONTENT_RATING_VALUE_UNKNOWN;
 }
 
 /**
@@ -1360,6 +1406,62 @@ as_content_rating_get_all_rating_ids (void)
 	return g_steal_pointer (&ids);
 }
 
+/**
+ * as_content_rating_get_all_values:
+ * @content_rating: a #AsContentRating
+ * @length_out: (out) (optional): return location for the number of returned values
+ *
+ * Gets the values of all OARS content rating attributes in one call.
+ * The values are returned in the same order as the IDs from
+ * as_content_rating_get_all_rating_ids(), and each value is what
+ * as_content_rating_get_value() would return for the respective ID.
+ *
+ * This is a lot more efficient than querying each attribute individually
+ * if all (or most) attribute values are needed.
+ *
+ * Returns: (array length=length_out) (transfer full): the attribute values,
+ *    to be freed with g_free()
+ * Since: 1.0.5
+ */
+AsContentRatingValue *
+as_content_rating_get_all_values (AsContentRating *content_rating, gsize *length_out)
+{
+	AsContentRatingPrivate *priv = GET_PRIVATE (content_rating);
+	g_autofree AsContentRatingValue *values = NULL;
+	gboolean is_oars_10;
+	gboolean is_oars_11;
+
+	g_return_val_if_fail (AS_IS_CONTENT_RATING (content_rating), NULL);
+
+	if (length_out != NULL)
+		*length_out = G_N_ELEMENTS (oars_to_csm_mappings);
+
+	/* attributes that are covered by the declared rating kind but were not
+	 * explicitly set default to "none", everything else is unknown */
+	is_oars_10 = g_strcmp0 (priv->kind, "oars-1.0") == 0;
+	is_oars_11 = g_strcmp0 (priv->kind, "oars-1.1") == 0;
+	values = g_new0 (AsContentRatingValue, G_N_ELEMENTS (oars_to_csm_mappings));
+	for (gsize i = 0; i < G_N_ELEMENTS (oars_to_csm_mappings); i++) {
+		if (is_oars_11 ||
+		    (is_oars_10 && oars_to_csm_mappings[i].oars_version <= AS_OARS_VERSION_1_0))
+			values[i] = AS_CONTENT_RATING_VALUE_NONE;
+		else
+			values[i] = AS_CONTENT_RATING_VALUE_UNKNOWN;
+	}
+
+	/* apply the explicitly set attributes in a single pass */
+	for (guint i = 0; i < priv->keys->len; i++) {
+		AsContentRatingKey *key = g_ptr_array_index (priv->keys, i);
+		const AsOarsCsmMapping *mapping = as_oars_csm_mapping_lookup (key->id);
+
+		if (mapping == NULL)
+			continue;
+		values[mapping - oars_to_csm_mappings] = key->value;
+	}
+
+	return g_steal_pointer (&values);
+}
+
 /**
  * as_content_rating_get_minimum_age:
  * @content_rating: a #AsContentRating
@@ -142,6 +142,8 @@ void		     as_content_rating_set_value (AsContentRating     *content_rating,
 						  AsContentRatingValue value);
 
 const gchar	   **as_content_rating_get_rating_ids (AsContentRating *content_rating);
+AsContentRatingValue *as_content_rating_get_all_values (AsContentRating *content_rating,
+							gsize		*length_out);
 
 void		     as_content_rating_add_attribute (AsContentRating	  *content_rating,
 						      const gchar	  *id,
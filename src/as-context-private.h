@@ -33,6 +33,13 @@ void		       as_context_set_architecture (AsContext *ctx, const gchar *value);
 gboolean	       as_context_get_internal_mode (AsContext *ctx);
 void		       as_context_set_internal_mode (AsContext *ctx, gboolean enabled);
 
+gboolean	       as_context_get_write_search_tokens (AsContext *ctx);
+void		       as_context_set_write_search_tokens (AsContext *ctx, gboolean enabled);
+
+AsContext	      *as_context_clone_unsealed (AsContext *ctx);
+
+const gchar	      *as_context_scratch_intern (AsContext *ctx, const gchar *value);
+
 const gchar	      *as_context_localized_ht_get (AsContext	*ctx,
 						    GHashTable	*lht,
 						    const gchar *locale_override);
@@ -40,6 +47,10 @@ void		       as_context_localized_ht_set (AsContext	*ctx,
 						    GHashTable	*lht,
 						    const gchar *value,
 						    const gchar *locale);
+void		       as_context_localized_ht_set_intern (AsContext   *ctx,
+							   GHashTable  *lht,
+							   const gchar *value,
+							   const gchar *locale);
 
 AsCurl		      *as_context_get_curl (AsContext *ctx, GError **error);
 
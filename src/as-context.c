@@ -44,6 +44,7 @@ typedef struct {
 	AsFormatStyle style;
 	AsValueFlags value_flags;
 	GRefString *locale;
+	GRefString *locale_lang; /* precomputed language part of @locale, for fallback lookups */
 	GRefString *origin;
 	GRefString *media_baseurl;
 	GRefString *arch;
@@ -51,9 +52,13 @@ typedef struct {
 	gint priority;
 
 	gboolean internal_mode;
+	gboolean write_search_tokens;
 	gboolean all_locale;
+	gboolean strict_locale;
+	gint sealed; /* atomic, context is immutable once set */
 
 	gchar **free_origin_globs;
+	GStringChunk *scratch_strings;
 	AsCurl *curl;
 	GMutex mutex;
 } AsContextPrivate;
@@ -146,6 +151,7 @@ as_context_finalize (GObject *object)
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
 
 	as_ref_string_release (priv->locale);
+	as_ref_string_release (priv->locale_lang);
 	as_ref_string_release (priv->origin);
 	as_ref_string_release (priv->media_baseurl);
 	as_ref_string_release (priv->arch);
@@ -154,6 +160,7 @@ as_context_finalize (GObject *object)
 
 	if (priv->free_origin_globs != NULL)
 		g_strfreev (priv->free_origin_globs);
+	g_string_chunk_free (priv->scratch_strings);
 	if (priv->curl != NULL)
 		g_object_unref (priv->curl);
 
@@ -166,10 +173,12 @@ as_context_init (AsContext *ctx)
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
 
 	g_mutex_init (&priv->mutex);
+	priv->scratch_strings = g_string_chunk_new (2048);
 	priv->format_version = AS_FORMAT_VERSION_LATEST;
 	priv->style = AS_FORMAT_STYLE_UNKNOWN;
 	priv->priority = 0;
 	priv->internal_mode = FALSE;
+	priv->write_search_tokens = FALSE;
 }
 
 static void
@@ -179,6 +188,24 @@ as_context_class_init (AsContextClass *klass)
 	object_class->finalize = as_context_finalize;
 }
 
+/**
+ * as_context_ensure_unsealed:
+ *
+ * Verify that this context may still be modified, emitting a critical
+ * warning if it was already sealed. Setters must not touch a sealed
+ * context, since it may be shared between threads without any locking.
+ */
+static gboolean
+as_context_ensure_unsealed (AsContext *ctx)
+{
+	AsContextPrivate *priv = GET_PRIVATE (ctx);
+
+	if (G_LIKELY (g_atomic_int_get (&priv->sealed) == 0))
+		return TRUE;
+	g_critical ("Tried to modify an AsContext that was sealed for concurrent use.");
+	return FALSE;
+}
+
 /**
  * as_context_get_format_version:
  * @ctx: a #AsContext instance.
@@ -203,6 +230,8 @@ void
 as_context_set_format_version (AsContext *ctx, AsFormatVersion ver)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
 	g_atomic_int_set (&priv->format_version, ver);
 }
 
@@ -230,6 +259,8 @@ void
 as_context_set_style (AsContext *ctx, AsFormatStyle style)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
 	g_atomic_int_set (&priv->style, style);
 }
 
@@ -257,6 +288,8 @@ void
 as_context_set_priority (AsContext *ctx, gint priority)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
 	g_atomic_int_set (&priv->priority, priority);
 }
 
@@ -284,6 +317,8 @@ void
 as_context_set_origin (AsContext *ctx, const gchar *value)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
 	as_ref_string_assign_safe (&priv->origin, value);
 }
 
@@ -314,6 +349,9 @@ as_context_set_locale (AsContext *ctx, const gchar *locale)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
 
+	if (!as_context_ensure_unsealed (ctx))
+		return;
+
 	g_atomic_int_set (&priv->all_locale, FALSE);
 	if (g_strcmp0 (locale, "ALL") == 0) {
 		g_autofree gchar *tmp = as_get_current_locale_bcp47 ();
@@ -323,6 +361,13 @@ as_context_set_locale (AsContext *ctx, const gchar *locale)
 		g_autofree gchar *bcp47 = as_utils_posix_locale_to_bcp47 (locale);
 		as_ref_string_assign_safe (&priv->locale, bcp47);
 	}
+
+	/* precompute the language-only fallback, so localized value lookups
+	 * do not need to build any candidate strings */
+	{
+		g_autofree gchar *lang = as_utils_locale_to_language (priv->locale);
+		as_ref_string_assign_safe (&priv->locale_lang, lang);
+	}
 }
 
 /**
@@ -338,6 +383,46 @@ as_context_get_locale_use_all (AsContext *ctx)
 	return g_atomic_int_get (&priv->all_locale);
 }
 
+/**
+ * as_context_get_locale_strict:
+ * @ctx: a #AsContext instance.
+ *
+ * Returns: %TRUE if only the active locale and its untranslated fallback
+ * should be read, ignoring other compatible locale variants.
+ *
+ * Since: 1.0.5
+ **/
+gboolean
+as_context_get_locale_strict (AsContext *ctx)
+{
+	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	return g_atomic_int_get (&priv->strict_locale);
+}
+
+/**
+ * as_context_set_locale_strict:
+ * @ctx: a #AsContext instance.
+ * @strict: %TRUE to only read the active locale.
+ *
+ * If set to %TRUE, only localized entries which exactly match the active
+ * locale or its plain language code are read, in addition to the
+ * untranslated "C" fallback. Other locale variants that would merely be
+ * compatible with the active locale are ignored, which reduces the memory
+ * needed for localized data to a single translation per entry.
+ *
+ * This has no effect if the magic "ALL" locale is used.
+ *
+ * Since: 1.0.5
+ **/
+void
+as_context_set_locale_strict (AsContext *ctx, gboolean strict)
+{
+	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
+	g_atomic_int_set (&priv->strict_locale, strict);
+}
+
 /**
  * as_context_has_media_baseurl:
  * @ctx: a #AsContext instance.
@@ -375,6 +460,8 @@ void
 as_context_set_media_baseurl (AsContext *ctx, const gchar *value)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
 	as_ref_string_assign_safe (&priv->media_baseurl, value);
 }
 
@@ -402,6 +489,8 @@ void
 as_context_set_architecture (AsContext *ctx, const gchar *value)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
 	as_ref_string_assign_safe (&priv->arch, value);
 }
 
@@ -429,6 +518,8 @@ void
 as_context_set_filename (AsContext *ctx, const gchar *fname)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
 	as_ref_string_assign_safe (&priv->fname, fname);
 }
 
@@ -442,7 +533,9 @@ void
 as_context_set_value_flags (AsContext *ctx, AsValueFlags flags)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
-	priv->value_flags = flags;
+	if (!as_context_ensure_unsealed (ctx))
+		return;
+	g_atomic_int_set (&priv->value_flags, flags);
 }
 
 /**
@@ -456,7 +549,80 @@ AsValueFlags
 as_context_get_value_flags (AsContext *ctx)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
-	return priv->value_flags;
+	return g_atomic_int_get (&priv->value_flags);
+}
+
+/**
+ * as_context_seal:
+ * @ctx: a #AsContext instance.
+ *
+ * Seal this context, making it permanently immutable.
+ *
+ * A sealed context can be shared freely between threads without any
+ * locking, since all its properties are fixed: every parser worker can
+ * reference the same context instead of carrying its own copy of the
+ * locale and configuration data. Attempts to modify a sealed context
+ * are ignored with a critical warning.
+ *
+ * Sealing can not be undone.
+ *
+ * Since: 1.0.5
+ **/
+void
+as_context_seal (AsContext *ctx)
+{
+	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	g_atomic_int_set (&priv->sealed, 1);
+}
+
+/**
+ * as_context_is_sealed:
+ * @ctx: a #AsContext instance.
+ *
+ * Returns: %TRUE if this context was sealed and can no longer be modified.
+ *
+ * Since: 1.0.5
+ **/
+gboolean
+as_context_is_sealed (AsContext *ctx)
+{
+	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	return g_atomic_int_get (&priv->sealed) != 0;
+}
+
+/**
+ * as_context_clone_unsealed:
+ * @ctx: a #AsContext instance.
+ *
+ * Create an unsealed copy of this context with identical settings.
+ * This is used to give an entity its own mutable context again if its
+ * current one was sealed for concurrent sharing.
+ *
+ * Returns: (transfer full): a new #AsContext
+ **/
+AsContext *
+as_context_clone_unsealed (AsContext *ctx)
+{
+	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	AsContext *copy = as_context_new ();
+	AsContextPrivate *cpriv = GET_PRIVATE (copy);
+
+	cpriv->format_version = priv->format_version;
+	cpriv->style = priv->style;
+	cpriv->value_flags = priv->value_flags;
+	cpriv->priority = priv->priority;
+	cpriv->internal_mode = priv->internal_mode;
+	cpriv->write_search_tokens = priv->write_search_tokens;
+	cpriv->all_locale = priv->all_locale;
+	cpriv->strict_locale = priv->strict_locale;
+	as_ref_string_assign_safe (&cpriv->locale, priv->locale);
+	as_ref_string_assign_safe (&cpriv->locale_lang, priv->locale_lang);
+	as_ref_string_assign_safe (&cpriv->origin, priv->origin);
+	as_ref_string_assign_safe (&cpriv->media_baseurl, priv->media_baseurl);
+	as_ref_string_assign_safe (&cpriv->arch, priv->arch);
+	as_ref_string_assign_safe (&cpriv->fname, priv->fname);
+
+	return copy;
 }
 
 /**
@@ -485,9 +651,64 @@ void
 as_context_set_internal_mode (AsContext *ctx, gboolean enabled)
 {
 	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
 	g_atomic_int_set (&priv->internal_mode, enabled);
 }
 
+/**
+ * as_context_get_write_search_tokens:
+ * @ctx: a #AsContext instance.
+ *
+ * Returns: %TRUE if pre-tokenized search terms are serialized.
+ **/
+gboolean
+as_context_get_write_search_tokens (AsContext *ctx)
+{
+	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	return g_atomic_int_get (&priv->write_search_tokens);
+}
+
+/**
+ * as_context_set_write_search_tokens:
+ * @ctx: a #AsContext instance.
+ * @enabled: %TRUE if enabled.
+ *
+ * If enabled, the XML serializer will emit the stemmed search-token
+ * index of each component into the catalog data, so clients can run
+ * searches without tokenizing the component data again.
+ **/
+void
+as_context_set_write_search_tokens (AsContext *ctx, gboolean enabled)
+{
+	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	if (!as_context_ensure_unsealed (ctx))
+		return;
+	g_atomic_int_set (&priv->write_search_tokens, enabled);
+}
+
+/**
+ * as_context_scratch_intern:
+ * @ctx: a #AsContext instance.
+ * @value: the string to intern.
+ *
+ * Intern a short, frequently recurring string (such as a locale name) into
+ * the scratch string arena of this context. The returned string is owned by
+ * the context and stays valid for its entire lifetime, so parser code can
+ * pass it around without making any further copies.
+ * The whole arena is released at once when the context is destroyed, which
+ * is much cheaper than the per-string malloc/free churn it replaces.
+ *
+ * Returns: the interned string.
+ **/
+const gchar *
+as_context_scratch_intern (AsContext *ctx, const gchar *value)
+{
+	AsContextPrivate *priv = GET_PRIVATE (ctx);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->mutex);
+	return g_string_chunk_insert_const (priv->scratch_strings, value);
+}
+
 /**
  * as_context_localized_ht_get:
  * @ctx: a #AsContext instance, or %NULL
@@ -514,14 +735,28 @@ as_context_localized_ht_get (AsContext *ctx, GHashTable *lht, const gchar *local
 		value_flags = priv->value_flags;
 	}
 
-	/* retrieve context locale, if the locale isn't explicitly overridden */
+	/* fast path: use the precomputed locale chain of the context, so the
+	 * lookups need no candidate string construction at all */
 	if (priv != NULL && locale_override == NULL) {
-		locale = priv->locale;
-	} else {
-		locale = locale_override;
+		msg = g_hash_table_lookup (lht, priv->locale != NULL ? priv->locale : "C");
+		if (msg != NULL ||
+		    as_flags_contains (value_flags, AS_VALUE_FLAG_NO_TRANSLATION_FALLBACK))
+			return msg;
+
+		/* fall back to language string - the interned strings allow a
+		 * cheap pointer comparison to skip a duplicate lookup here */
+		if (priv->locale_lang != NULL && priv->locale_lang != priv->locale) {
+			msg = g_hash_table_lookup (lht, priv->locale_lang);
+			if (msg != NULL)
+				return msg;
+		}
+
+		/* fall back to untranslated / default */
+		return g_hash_table_lookup (lht, "C");
 	}
 
 	/* NULL is not an acceptable value here and means "C" */
+	locale = locale_override;
 	if (locale == NULL)
 		locale = "C";
 
@@ -576,6 +811,44 @@ as_context_localized_ht_set (AsContext *ctx,
 	g_hash_table_insert (lht, g_ref_string_new_intern (locale_noenc), g_strdup (value));
 }
 
+/**
+ * as_context_localized_ht_set_intern:
+ * @ctx: a #AsContext instance, or %NULL
+ * @lht: (element-type utf8 utf8): the #GHashTable to which the value will be added.
+ * @value: the value to add.
+ * @locale: (nullable): the BCP47 locale, or %NULL. e.g. "en-GB".
+ *
+ * Like %as_context_localized_ht_set, but stores the value as an interned
+ * #GRefString, so identical values loaded repeatedly share one allocation
+ * process-wide. The table must release its values with %as_ref_string_release.
+ */
+void
+as_context_localized_ht_set_intern (AsContext *ctx,
+				    GHashTable *lht,
+				    const gchar *value,
+				    const gchar *locale)
+{
+	const gchar *selected_locale;
+	g_autofree gchar *locale_noenc = NULL;
+
+	/* if no locale was specified, we assume the default locale
+	 * NOTE: %NULL does NOT necessarily mean lang=C here! */
+	if ((ctx != NULL) && (locale == NULL)) {
+		AsContextPrivate *priv = GET_PRIVATE (ctx);
+		selected_locale = priv->locale;
+	} else {
+		selected_locale = locale;
+	}
+	/* if we still have no locale, assume "C" as best option */
+	if (selected_locale == NULL)
+		selected_locale = "C";
+
+	locale_noenc = as_locale_strip_encoding (selected_locale);
+	g_hash_table_insert (lht,
+			     g_ref_string_new_intern (locale_noenc),
+			     g_ref_string_new_intern (value));
+}
+
 /**
  * as_context_get_curl:
  * @ctx: a #AsContext instance, or %NULL
@@ -140,12 +140,18 @@ void		as_context_set_media_baseurl (AsContext *ctx, const gchar *value);
 
 gboolean	as_context_get_locale_use_all (AsContext *ctx);
 
+gboolean	as_context_get_locale_strict (AsContext *ctx);
+void		as_context_set_locale_strict (AsContext *ctx, gboolean strict);
+
 const gchar    *as_context_get_filename (AsContext *ctx);
 void		as_context_set_filename (AsContext *ctx, const gchar *fname);
 
 AsValueFlags	as_context_get_value_flags (AsContext *ctx);
 void		as_context_set_value_flags (AsContext *ctx, AsValueFlags flags);
 
+void		as_context_seal (AsContext *ctx);
+gboolean	as_context_is_sealed (AsContext *ctx);
+
 G_END_DECLS
 
 #endif /* __AS_CONTEXT_H */
@@ -52,6 +52,55 @@ G_DEFINE_QUARK (AsCurlError, as_curl_error)
 
 static const long AS_HTTP_TIMEOUT_SECS = 60;
 
+/* locks guarding the process-wide shared cURL data, indexed by curl_lock_data */
+static GMutex as_curl_share_locks[CURL_LOCK_DATA_LAST];
+
+static void
+as_curl_share_lock_cb (CURL *handle, curl_lock_data data, curl_lock_access laccess, void *userptr)
+{
+	g_mutex_lock (&as_curl_share_locks[data]);
+}
+
+static void
+as_curl_share_unlock_cb (CURL *handle, curl_lock_data data, void *userptr)
+{
+	g_mutex_unlock (&as_curl_share_locks[data]);
+}
+
+/**
+ * as_curl_get_share:
+ *
+ * Get the process-wide cURL share object. Most downloads we perform
+ * fetch many files from only a handful of hosts, so sharing the DNS
+ * cache, TLS sessions and the connection cache between all #AsCurl
+ * instances avoids repeating host resolution and TLS handshakes for
+ * every single transfer.
+ *
+ * The share lives for the entire process, it is never freed.
+ */
+static CURLSH *
+as_curl_get_share (void)
+{
+	static CURLSH *share = NULL;
+	static gsize initialized = 0;
+
+	if (g_once_init_enter (&initialized)) {
+		share = curl_share_init ();
+		if (share != NULL) {
+			curl_share_setopt (share, CURLSHOPT_LOCKFUNC, as_curl_share_lock_cb);
+			curl_share_setopt (share, CURLSHOPT_UNLOCKFUNC, as_curl_share_unlock_cb);
+			curl_share_setopt (share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+			curl_share_setopt (share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if CURL_AT_LEAST_VERSION(7, 57, 0)
+			curl_share_setopt (share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+		}
+		g_once_init_leave (&initialized, 1);
+	}
+
+	return share;
+}
+
 /**
  * as_curl_is_url:
  *
@@ -115,29 +164,9 @@ as_curl_download_write_bytearray_cb (char *ptr, size_t size, size_t nmemb, void
 }
 
 static gboolean
-as_curl_perform_download_once (AsCurl *acurl,
-			       gboolean abort_is_error,
-			       CURLcode *curl_status,
-			       glong *response_code,
-			       GError **error)
+as_curl_set_download_error (CURLcode res, glong status_code, const gchar *errbuf, GError **error)
 {
-	AsCurlPrivate *priv = GET_PRIVATE (acurl);
-	CURLcode res;
-	gchar errbuf[CURL_ERROR_SIZE] = { '\0' };
-	glong status_code = 0;
-
-	curl_easy_setopt (priv->curl, CURLOPT_ERRORBUFFER, errbuf);
-
-	res = curl_easy_perform (priv->curl);
-	curl_easy_getinfo (priv->curl, CURLINFO_RESPONSE_CODE, &status_code);
-
-	if (curl_status != NULL)
-		*curl_status = res;
 	if (res != CURLE_OK) {
-		/* check if this issue was an intentional abort */
-		if (!abort_is_error && res == CURLE_ABORTED_BY_CALLBACK)
-			goto verify_and_return;
-
 		g_debug ("cURL status-code was %ld", status_code);
 		if (status_code == 429) {
 			g_set_error (
@@ -162,10 +191,6 @@ as_curl_perform_download_once (AsCurl *acurl,
 		return FALSE;
 	}
 
-verify_and_return:
-	if (response_code != NULL)
-		*response_code = status_code;
-
 	if (status_code == 404) {
 		g_set_error (
 		    error,
@@ -187,6 +212,36 @@ verify_and_return:
 	return TRUE;
 }
 
+static gboolean
+as_curl_perform_download_once (AsCurl *acurl,
+			       gboolean abort_is_error,
+			       CURLcode *curl_status,
+			       glong *response_code,
+			       GError **error)
+{
+	AsCurlPrivate *priv = GET_PRIVATE (acurl);
+	CURLcode res;
+	gchar errbuf[CURL_ERROR_SIZE] = { '\0' };
+	glong status_code = 0;
+
+	curl_easy_setopt (priv->curl, CURLOPT_ERRORBUFFER, errbuf);
+
+	res = curl_easy_perform (priv->curl);
+	curl_easy_getinfo (priv->curl, CURLINFO_RESPONSE_CODE, &status_code);
+
+	if (curl_status != NULL)
+		*curl_status = res;
+
+	/* check if this issue was an intentional abort */
+	if (!abort_is_error && res == CURLE_ABORTED_BY_CALLBACK)
+		res = CURLE_OK;
+
+	if (res == CURLE_OK && response_code != NULL)
+		*response_code = status_code;
+
+	return as_curl_set_download_error (res, status_code, errbuf, error);
+}
+
 static gboolean
 as_curl_perform_download (AsCurl *acurl, gboolean abort_is_error, const gchar *url, GError **error)
 {
@@ -361,6 +416,319 @@ as_curl_download_to_filename (AsCurl *acurl, const gchar *url, const gchar *fnam
 	return TRUE;
 }
 
+/**
+ * as_curl_request_new:
+ * @url: URL to download.
+ * @fname: target filename, or %NULL to download into memory.
+ *
+ * Create a new download request for as_curl_download_multi().
+ **/
+AsCurlRequest *
+as_curl_request_new (const gchar *url, const gchar *fname)
+{
+	AsCurlRequest *request;
+
+	g_return_val_if_fail (url != NULL, NULL);
+
+	request = g_new0 (AsCurlRequest, 1);
+	request->url = g_strdup (url);
+	request->fname = g_strdup (fname);
+
+	return request;
+}
+
+/**
+ * as_curl_request_free:
+ * @request: an #AsCurlRequest.
+ *
+ * Free a download request and its result data.
+ **/
+void
+as_curl_request_free (AsCurlRequest *request)
+{
+	if (request == NULL)
+		return;
+	g_free (request->url);
+	g_free (request->fname);
+	if (request->bytes != NULL)
+		g_bytes_unref (request->bytes);
+	if (request->error != NULL)
+		g_error_free (request->error);
+	g_free (request);
+}
+
+typedef struct {
+	AsCurlRequest *request;
+	CURL *ehandle;
+	GByteArray *buf;
+	GOutputStream *ostream;
+	guint n_retries_remaining;
+	gchar errbuf[CURL_ERROR_SIZE];
+} AsCurlTransfer;
+
+static void
+as_curl_transfer_free (AsCurlTransfer *xfer)
+{
+	if (xfer->ehandle != NULL)
+		curl_easy_cleanup (xfer->ehandle);
+	if (xfer->buf != NULL)
+		g_byte_array_unref (xfer->buf);
+	g_clear_object (&xfer->ostream);
+	g_free (xfer);
+}
+
+/**
+ * as_curl_transfer_prepare_target:
+ *
+ * Set up the write target of a concurrent transfer, truncating any
+ * data from a previous (failed) attempt.
+ */
+static gboolean
+as_curl_transfer_prepare_target (AsCurlTransfer *xfer)
+{
+	AsCurlRequest *request = xfer->request;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GFileOutputStream) fos = NULL;
+	GError *tmp_error = NULL;
+
+	if (request->fname == NULL) {
+		if (xfer->buf == NULL)
+			xfer->buf = g_byte_array_new ();
+		else
+			g_byte_array_set_size (xfer->buf, 0);
+		curl_easy_setopt (xfer->ehandle,
+				  CURLOPT_WRITEFUNCTION,
+				  as_curl_download_write_bytearray_cb);
+		curl_easy_setopt (xfer->ehandle, CURLOPT_WRITEDATA, xfer->buf);
+		return TRUE;
+	}
+
+	g_clear_object (&xfer->ostream);
+	file = g_file_new_for_path (request->fname);
+	if (g_file_query_exists (file, NULL))
+		fos = g_file_replace (file,
+				      NULL,
+				      FALSE,
+				      G_FILE_CREATE_REPLACE_DESTINATION,
+				      NULL,
+				      &tmp_error);
+	else
+		fos = g_file_create (file, G_FILE_CREATE_REPLACE_DESTINATION, NULL, &tmp_error);
+
+	if (tmp_error != NULL) {
+		g_propagate_error (&request->error, tmp_error);
+		return FALSE;
+	}
+
+	xfer->ostream = G_OUTPUT_STREAM (g_data_output_stream_new (G_OUTPUT_STREAM (fos)));
+	curl_easy_setopt (xfer->ehandle,
+			  CURLOPT_WRITEFUNCTION,
+			  as_curl_download_write_data_stream_cb);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_WRITEDATA, xfer->ostream);
+
+	return TRUE;
+}
+
+static AsCurlTransfer *
+as_curl_transfer_new (AsCurl *acurl, AsCurlRequest *request)
+{
+	AsCurlPrivate *priv = GET_PRIVATE (acurl);
+	AsCurlTransfer *xfer = g_new0 (AsCurlTransfer, 1);
+
+	xfer->request = request;
+	xfer->n_retries_remaining = priv->n_retries;
+
+	/* inherit all settings (user agent, timeouts, proxy, CA info, ...) from the shared handle */
+	xfer->ehandle = curl_easy_duphandle (priv->curl);
+	if (xfer->ehandle == NULL) {
+		g_set_error_literal (&request->error,
+				     AS_CURL_ERROR,
+				     AS_CURL_ERROR_FAILED,
+				     "Failed to duplicate cURL handle.");
+		return xfer;
+	}
+
+	curl_easy_setopt (xfer->ehandle, CURLOPT_URL, request->url);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_PRIVATE, xfer);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_ERRORBUFFER, xfer->errbuf);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_XFERINFOFUNCTION, as_curl_progress_dummy_cb);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_XFERINFODATA, acurl);
+
+	/* negotiate HTTP/2 where available, so many transfers to the same server
+	 * can be multiplexed over a single connection */
+	curl_easy_setopt (xfer->ehandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_PIPEWAIT, 1L);
+
+	as_curl_transfer_prepare_target (xfer);
+	return xfer;
+}
+
+static gboolean
+as_curl_transfer_should_retry (CURLcode res, glong status_code)
+{
+	/* same conditions as for serial downloads */
+	return res == CURLE_OPERATION_TIMEDOUT || res == CURLE_COULDNT_RESOLVE_HOST ||
+	       res == CURLE_COULDNT_RESOLVE_PROXY || res == CURLE_COULDNT_CONNECT ||
+	       status_code >= 405;
+}
+
+static void
+as_curl_transfer_finish (AsCurlTransfer *xfer, CURLcode res, glong status_code)
+{
+	AsCurlRequest *request = xfer->request;
+
+	if (request->error == NULL)
+		as_curl_set_download_error (res, status_code, xfer->errbuf, &request->error);
+	if (request->error != NULL)
+		return;
+
+	if (xfer->ostream != NULL)
+		g_output_stream_close (xfer->ostream, NULL, NULL);
+	else if (xfer->buf != NULL)
+		request->bytes = g_byte_array_free_to_bytes (g_steal_pointer (&xfer->buf));
+}
+
+/**
+ * as_curl_download_multi:
+ * @acurl: an #AsCurl instance.
+ * @requests: (element-type AsCurlRequest): the downloads to perform.
+ * @error: a #GError.
+ *
+ * Perform many downloads concurrently over a single connection pool,
+ * multiplexing transfers via HTTP/2 where the server supports it.
+ * Each entry of @requests is updated in-place with either the result
+ * data or a per-request error, so individual failures do not abort
+ * the remaining transfers.
+ *
+ * Returns: %TRUE if all downloads succeeded. If any of them failed,
+ * @error is set from the first failed request.
+ **/
+gboolean
+as_curl_download_multi (AsCurl *acurl, GPtrArray *requests, GError **error)
+{
+	CURLM *multi = NULL;
+	CURLMcode mc;
+	g_autoptr(GPtrArray) transfers = NULL;
+	guint n_failed = 0;
+
+	g_return_val_if_fail (requests != NULL, FALSE);
+	if (requests->len == 0)
+		return TRUE;
+
+	multi = curl_multi_init ();
+	if (multi == NULL) {
+		g_set_error_literal (error,
+				     AS_CURL_ERROR,
+				     AS_CURL_ERROR_FAILED,
+				     "Failed to initialize cURL multi handle.");
+		return FALSE;
+	}
+
+	/* multiplex many transfers over few connections, but don't hammer a single host */
+	curl_multi_setopt (multi, CURLMOPT_PIPELINING, CURLMPIPE_MULTIPLEX);
+	curl_multi_setopt (multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, 16L);
+	curl_multi_setopt (multi, CURLMOPT_MAX_HOST_CONNECTIONS, 4L);
+
+	transfers = g_ptr_array_new_with_free_func ((GDestroyNotify) as_curl_transfer_free);
+	for (guint i = 0; i < requests->len; i++) {
+		AsCurlRequest *request = g_ptr_array_index (requests, i);
+		AsCurlTransfer *xfer;
+
+		g_clear_pointer (&request->bytes, g_bytes_unref);
+		g_clear_error (&request->error);
+
+		xfer = as_curl_transfer_new (acurl, request);
+		g_ptr_array_add (transfers, xfer);
+		if (request->error == NULL)
+			curl_multi_add_handle (multi, xfer->ehandle);
+	}
+
+	while (TRUE) {
+		gboolean retried = FALSE;
+		CURLMsg *msg;
+		int still_running = 0;
+		int msgs_left = 0;
+
+		mc = curl_multi_perform (multi, &still_running);
+		if (mc != CURLM_OK) {
+			g_set_error (error,
+				     AS_CURL_ERROR,
+				     AS_CURL_ERROR_FAILED,
+				     "Failed to perform downloads: %s",
+				     curl_multi_strerror (mc));
+			curl_multi_cleanup (multi);
+			return FALSE;
+		}
+
+		/* process all transfers which completed (or failed) in this iteration */
+		while ((msg = curl_multi_info_read (multi, &msgs_left)) != NULL) {
+			AsCurlTransfer *xfer = NULL;
+			glong status_code = 0;
+
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+			curl_easy_getinfo (msg->easy_handle, CURLINFO_PRIVATE, (char **) &xfer);
+			curl_easy_getinfo (msg->easy_handle,
+					   CURLINFO_RESPONSE_CODE,
+					   &status_code);
+
+			if (xfer->n_retries_remaining > 0 &&
+			    as_curl_transfer_should_retry (msg->data.result, status_code)) {
+				xfer->n_retries_remaining--;
+				g_debug ("Retrying failed download of %s", xfer->request->url);
+				curl_multi_remove_handle (multi, msg->easy_handle);
+				if (as_curl_transfer_prepare_target (xfer)) {
+					curl_multi_add_handle (multi, msg->easy_handle);
+					retried = TRUE;
+					continue;
+				}
+			}
+
+			curl_multi_remove_handle (multi, msg->easy_handle);
+			as_curl_transfer_finish (xfer, msg->data.result, status_code);
+		}
+
+		if (still_running == 0 && !retried)
+			break;
+		if (still_running > 0)
+			curl_multi_wait (multi, NULL, 0, 1000, NULL);
+	}
+	curl_multi_cleanup (multi);
+
+	/* report the first per-request failure via the GError, for convenience */
+	for (guint i = 0; i < requests->len; i++) {
+		AsCurlRequest *request = g_ptr_array_index (requests, i);
+		if (request->error == NULL)
+			continue;
+		n_failed++;
+		if (error != NULL && *error == NULL)
+			g_set_error (error,
+				     AS_CURL_ERROR,
+				     AS_CURL_ERROR_DOWNLOAD,
+				     "Failed to download %s: %s",
+				     request->url,
+				     request->error->message);
+	}
+
+	return n_failed == 0;
+}
+
+static size_t
+as_curl_header_collect_etag_cb (char *buffer, size_t size, size_t nitems, void *udata)
+{
+	gchar **etag_ptr = (gchar **) udata;
+	gsize realsize = size * nitems;
+	g_autofree gchar *line = NULL;
+
+	line = g_strndup (buffer, realsize);
+	if (g_ascii_strncasecmp (line, "etag:", 5) == 0) {
+		g_free (*etag_ptr);
+		*etag_ptr = g_strstrip (g_strdup (line + 5));
+	}
+
+	return realsize;
+}
+
 static int
 as_curl_progress_check_url_cb (void *clientp,
 			       curl_off_t dltotal,
@@ -386,28 +754,43 @@ as_curl_progress_check_url_cb (void *clientp,
 }
 
 /**
- * as_curl_check_url_exists:
+ * as_curl_check_url_exists_full:
  * @acurl: an #AsCurl instance.
  * @url: URL to download
- * @error: a #GError.
+ * @etag: (out) (optional) (nullable): return location for the resource ETag, or %NULL
  *
  * Test if an URL exists by downloading the first few bytes of data,
  * then aborting if no issue was received.
  * If the resource could not be accessed, and error is returned.
+ * If @etag is provided, the ETag header value sent by the server is
+ * returned as well, so callers can revalidate the resource cheaply later.
  **/
 gboolean
-as_curl_check_url_exists (AsCurl *acurl, const gchar *url, GError **error)
+as_curl_check_url_exists_full (AsCurl *acurl, const gchar *url, gchar **etag, GError **error)
 {
 	AsCurlPrivate *priv = GET_PRIVATE (acurl);
 	g_autoptr(GByteArray) buf = g_byte_array_new ();
+	gboolean ret;
 
 	curl_easy_setopt (priv->curl, CURLOPT_WRITEFUNCTION, as_curl_download_write_bytearray_cb);
 	curl_easy_setopt (priv->curl, CURLOPT_WRITEDATA, buf);
 	curl_easy_setopt (priv->curl, CURLOPT_XFERINFOFUNCTION, as_curl_progress_check_url_cb);
 	curl_easy_setopt (priv->curl, CURLOPT_XFERINFODATA, acurl);
+	if (etag != NULL) {
+		*etag = NULL;
+		curl_easy_setopt (priv->curl,
+				  CURLOPT_HEADERFUNCTION,
+				  as_curl_header_collect_etag_cb);
+		curl_easy_setopt (priv->curl, CURLOPT_HEADERDATA, etag);
+	}
 
 	priv->bytes_downloaded = 0;
-	if (!as_curl_perform_download (acurl, FALSE, url, error))
+	ret = as_curl_perform_download (acurl, FALSE, url, error);
+	if (etag != NULL) {
+		curl_easy_setopt (priv->curl, CURLOPT_HEADERFUNCTION, NULL);
+		curl_easy_setopt (priv->curl, CURLOPT_HEADERDATA, NULL);
+	}
+	if (!ret)
 		return FALSE;
 
 	/* check if it's a zero sized file */
@@ -424,6 +807,364 @@ as_curl_check_url_exists (AsCurl *acurl, const gchar *url, GError **error)
 	return TRUE;
 }
 
+/**
+ * as_curl_check_url_exists:
+ * @acurl: an #AsCurl instance.
+ * @url: URL to download
+ * @error: a #GError.
+ *
+ * Test if an URL exists by downloading the first few bytes of data,
+ * then aborting if no issue was received.
+ * If the resource could not be accessed, and error is returned.
+ **/
+gboolean
+as_curl_check_url_exists (AsCurl *acurl, const gchar *url, GError **error)
+{
+	return as_curl_check_url_exists_full (acurl, url, NULL, error);
+}
+
+/**
+ * as_curl_query_etag:
+ * @acurl: an #AsCurl instance.
+ * @url: URL to query
+ * @error: a #GError.
+ *
+ * Perform a HEAD request on @url and return the value of its ETag
+ * header, so callers can cheaply check whether a remote resource has
+ * changed since it was last downloaded.
+ *
+ * Returns: (transfer full): The ETag value, or %NULL if the request
+ * failed or the server did not send an ETag header (in which case
+ * @error stays unset).
+ **/
+gchar *
+as_curl_query_etag (AsCurl *acurl, const gchar *url, GError **error)
+{
+	AsCurlPrivate *priv = GET_PRIVATE (acurl);
+	g_autofree gchar *etag = NULL;
+	gboolean ret;
+
+	curl_easy_setopt (priv->curl, CURLOPT_NOBODY, 1L);
+	curl_easy_setopt (priv->curl, CURLOPT_HEADERFUNCTION, as_curl_header_collect_etag_cb);
+	curl_easy_setopt (priv->curl, CURLOPT_HEADERDATA, &etag);
+	curl_easy_setopt (priv->curl, CURLOPT_XFERINFOFUNCTION, as_curl_progress_dummy_cb);
+	curl_easy_setopt (priv->curl, CURLOPT_XFERINFODATA, acurl);
+
+	ret = as_curl_perform_download (acurl, TRUE, url, error);
+
+	/* reset the handle for subsequent body downloads */
+	curl_easy_setopt (priv->curl, CURLOPT_NOBODY, 0L);
+	curl_easy_setopt (priv->curl, CURLOPT_HEADERFUNCTION, NULL);
+	curl_easy_setopt (priv->curl, CURLOPT_HEADERDATA, NULL);
+
+	if (!ret)
+		return NULL;
+	return g_steal_pointer (&etag);
+}
+
+/**
+ * as_curl_url_check_new:
+ * @url: URL to check.
+ *
+ * Create a new URL existence check for as_curl_check_urls_exist().
+ **/
+AsCurlUrlCheck *
+as_curl_url_check_new (const gchar *url)
+{
+	AsCurlUrlCheck *check;
+
+	g_return_val_if_fail (url != NULL, NULL);
+
+	check = g_new0 (AsCurlUrlCheck, 1);
+	check->url = g_strdup (url);
+
+	return check;
+}
+
+/**
+ * as_curl_url_check_free:
+ * @check: an #AsCurlUrlCheck.
+ *
+ * Free an URL existence check and its result data.
+ **/
+void
+as_curl_url_check_free (AsCurlUrlCheck *check)
+{
+	if (check == NULL)
+		return;
+	g_free (check->url);
+	g_free (check->etag);
+	if (check->error != NULL)
+		g_error_free (check->error);
+	g_free (check);
+}
+
+typedef struct {
+	AsCurlUrlCheck *check;
+	CURL *ehandle;
+	guint n_retries_remaining;
+	gboolean ranged_get; /* whether we fell back from HEAD to a small ranged GET */
+	curl_off_t bytes_received;
+	gchar errbuf[CURL_ERROR_SIZE];
+} AsCurlCheckTransfer;
+
+static void
+as_curl_check_transfer_free (AsCurlCheckTransfer *xfer)
+{
+	if (xfer->ehandle != NULL)
+		curl_easy_cleanup (xfer->ehandle);
+	g_free (xfer);
+}
+
+static size_t
+as_curl_check_count_bytes_cb (char *ptr, size_t size, size_t nmemb, void *udata)
+{
+	curl_off_t *counter = (curl_off_t *) udata;
+	gsize realsize = size * nmemb;
+
+	/* we only care whether the server actually serves data, not about its contents */
+	*counter += (curl_off_t) realsize;
+	return realsize;
+}
+
+static AsCurlCheckTransfer *
+as_curl_check_transfer_new (AsCurl *acurl, AsCurlUrlCheck *check)
+{
+	AsCurlPrivate *priv = GET_PRIVATE (acurl);
+	AsCurlCheckTransfer *xfer = g_new0 (AsCurlCheckTransfer, 1);
+
+	xfer->check = check;
+	xfer->n_retries_remaining = priv->n_retries;
+
+	/* inherit all settings (user agent, timeouts, proxy, CA info, ...) from the shared handle */
+	xfer->ehandle = curl_easy_duphandle (priv->curl);
+	if (xfer->ehandle == NULL) {
+		g_set_error_literal (&check->error,
+				     AS_CURL_ERROR,
+				     AS_CURL_ERROR_FAILED,
+				     "Failed to duplicate cURL handle.");
+		return xfer;
+	}
+
+	curl_easy_setopt (xfer->ehandle, CURLOPT_URL, check->url);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_PRIVATE, xfer);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_ERRORBUFFER, xfer->errbuf);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_XFERINFOFUNCTION, as_curl_progress_dummy_cb);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_XFERINFODATA, acurl);
+
+	/* a plain HEAD request is all we need for most servers */
+	curl_easy_setopt (xfer->ehandle, CURLOPT_NOBODY, 1L);
+
+	/* collect the ETag, so callers can revalidate the resource cheaply later */
+	curl_easy_setopt (xfer->ehandle, CURLOPT_HEADERFUNCTION, as_curl_header_collect_etag_cb);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_HEADERDATA, &check->etag);
+
+	/* negotiate HTTP/2 where available, so many checks against the same server
+	 * can be multiplexed over a single connection */
+	curl_easy_setopt (xfer->ehandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_PIPEWAIT, 1L);
+
+	return xfer;
+}
+
+/**
+ * as_curl_check_transfer_use_ranged_get:
+ *
+ * Re-issue a check as a small ranged GET request, for servers which
+ * reject HEAD requests or do not announce a usable content length.
+ */
+static void
+as_curl_check_transfer_use_ranged_get (AsCurlCheckTransfer *xfer)
+{
+	xfer->ranged_get = TRUE;
+	xfer->bytes_received = 0;
+	curl_easy_setopt (xfer->ehandle, CURLOPT_NOBODY, 0L);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_RANGE, "0-1023");
+	curl_easy_setopt (xfer->ehandle, CURLOPT_WRITEFUNCTION, as_curl_check_count_bytes_cb);
+	curl_easy_setopt (xfer->ehandle, CURLOPT_WRITEDATA, &xfer->bytes_received);
+}
+
+static void
+as_curl_check_transfer_finish (AsCurlCheckTransfer *xfer, CURLcode res, glong status_code)
+{
+	AsCurlUrlCheck *check = xfer->check;
+
+	if (check->error != NULL)
+		return;
+
+	if (res == CURLE_OK && status_code >= 200 && status_code < 300) {
+		/* the ranged-GET fallback is only taken when the HEAD reply suggested
+		 * an empty file, so receiving no data here confirms that suspicion */
+		if (xfer->ranged_get && xfer->bytes_received == 0)
+			g_set_error (
+			    &check->error,
+			    AS_CURL_ERROR,
+			    AS_CURL_ERROR_SIZE,
+			    /* TRANSLATORS: We tried to download from an URL, but the retrieved data was empty */
+			    _("Retrieved file size was zero."));
+		return;
+	}
+
+	as_curl_set_download_error (res, status_code, xfer->errbuf, &check->error);
+}
+
+/**
+ * as_curl_check_urls_exist:
+ * @acurl: an #AsCurl instance.
+ * @checks: (element-type AsCurlUrlCheck): the URL checks to perform.
+ * @max_parallel_per_host: maximum simultaneous requests per host, or 0 for the default.
+ * @error: a #GError.
+ *
+ * Test many URLs for existence concurrently, using HEAD requests
+ * multiplexed over a small, reused per-host connection pool.
+ * Servers which reject HEAD requests, or whose reply suggests an empty
+ * file, are transparently probed again with a small ranged GET request.
+ *
+ * The per-host parallelism bound keeps bulk checks from hammering a
+ * single server with requests, which can be slow and get clients banned.
+ *
+ * Each entry of @checks is updated in-place with the result, so
+ * individual failures do not abort the remaining checks: a %NULL
+ * error on an entry means the URL exists.
+ *
+ * Returns: %TRUE if all URLs exist. If any check failed, @error is set
+ * from the first failed entry.
+ **/
+gboolean
+as_curl_check_urls_exist (AsCurl *acurl,
+			  GPtrArray *checks,
+			  guint max_parallel_per_host,
+			  GError **error)
+{
+	CURLM *multi = NULL;
+	CURLMcode mc;
+	g_autoptr(GPtrArray) transfers = NULL;
+	guint n_failed = 0;
+
+	g_return_val_if_fail (checks != NULL, FALSE);
+	if (checks->len == 0)
+		return TRUE;
+	if (max_parallel_per_host == 0)
+		max_parallel_per_host = 4;
+
+	multi = curl_multi_init ();
+	if (multi == NULL) {
+		g_set_error_literal (error,
+				     AS_CURL_ERROR,
+				     AS_CURL_ERROR_FAILED,
+				     "Failed to initialize cURL multi handle.");
+		return FALSE;
+	}
+
+	/* multiplex many requests over few connections, within the per-host bound */
+	curl_multi_setopt (multi, CURLMOPT_PIPELINING, CURLMPIPE_MULTIPLEX);
+	curl_multi_setopt (multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, 16L);
+	curl_multi_setopt (multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long) max_parallel_per_host);
+#if CURL_AT_LEAST_VERSION(7, 67, 0)
+	/* with HTTP/2, a single connection could carry far more concurrent streams
+	 * than the connection limit suggests - bound those to the same value */
+	curl_multi_setopt (multi, CURLMOPT_MAX_CONCURRENT_STREAMS, (long) max_parallel_per_host);
+#endif
+
+	transfers = g_ptr_array_new_with_free_func ((GDestroyNotify) as_curl_check_transfer_free);
+	for (guint i = 0; i < checks->len; i++) {
+		AsCurlUrlCheck *check = g_ptr_array_index (checks, i);
+		AsCurlCheckTransfer *xfer;
+
+		g_clear_pointer (&check->etag, g_free);
+		g_clear_error (&check->error);
+
+		xfer = as_curl_check_transfer_new (acurl, check);
+		g_ptr_array_add (transfers, xfer);
+		if (check->error == NULL)
+			curl_multi_add_handle (multi, xfer->ehandle);
+	}
+
+	while (TRUE) {
+		gboolean requeued = FALSE;
+		CURLMsg *msg;
+		int still_running = 0;
+		int msgs_left = 0;
+
+		mc = curl_multi_perform (multi, &still_running);
+		if (mc != CURLM_OK) {
+			g_set_error (error,
+				     AS_CURL_ERROR,
+				     AS_CURL_ERROR_FAILED,
+				     "Failed to perform URL checks: %s",
+				     curl_multi_strerror (mc));
+			curl_multi_cleanup (multi);
+			return FALSE;
+		}
+
+		/* process all checks which completed (or failed) in this iteration */
+		while ((msg = curl_multi_info_read (multi, &msgs_left)) != NULL) {
+			AsCurlCheckTransfer *xfer = NULL;
+			glong status_code = 0;
+
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+			curl_easy_getinfo (msg->easy_handle, CURLINFO_PRIVATE, (char **) &xfer);
+			curl_easy_getinfo (msg->easy_handle,
+					   CURLINFO_RESPONSE_CODE,
+					   &status_code);
+
+			/* fall back to a ranged GET if HEAD was rejected, or if the server
+			 * claims the file is empty (which HEAD alone can not verify) */
+			if (!xfer->ranged_get && msg->data.result == CURLE_OK) {
+				curl_off_t clen = -1;
+				curl_easy_getinfo (msg->easy_handle,
+						   CURLINFO_CONTENT_LENGTH_DOWNLOAD_T,
+						   &clen);
+				if (status_code == 405 || status_code == 501 ||
+				    (status_code >= 200 && status_code < 300 && clen <= 0)) {
+					curl_multi_remove_handle (multi, msg->easy_handle);
+					as_curl_check_transfer_use_ranged_get (xfer);
+					curl_multi_add_handle (multi, msg->easy_handle);
+					requeued = TRUE;
+					continue;
+				}
+			}
+
+			if (xfer->n_retries_remaining > 0 &&
+			    as_curl_transfer_should_retry (msg->data.result, status_code)) {
+				xfer->n_retries_remaining--;
+				g_debug ("Retrying failed URL check of %s", xfer->check->url);
+				curl_multi_remove_handle (multi, msg->easy_handle);
+				curl_multi_add_handle (multi, msg->easy_handle);
+				requeued = TRUE;
+				continue;
+			}
+
+			curl_multi_remove_handle (multi, msg->easy_handle);
+			as_curl_check_transfer_finish (xfer, msg->data.result, status_code);
+		}
+
+		if (still_running == 0 && !requeued)
+			break;
+		if (still_running > 0)
+			curl_multi_wait (multi, NULL, 0, 1000, NULL);
+	}
+	curl_multi_cleanup (multi);
+
+	/* report the first per-check failure via the GError, for convenience */
+	for (guint i = 0; i < checks->len; i++) {
+		AsCurlUrlCheck *check = g_ptr_array_index (checks, i);
+		if (check->error == NULL)
+			continue;
+		n_failed++;
+		if (error != NULL && *error == NULL)
+			g_set_error (error,
+				     AS_CURL_ERROR,
+				     AS_CURL_ERROR_DOWNLOAD,
+				     "URL check for %s failed: %s",
+				     check->url,
+				     check->error->message);
+	}
+
+	return n_failed == 0;
+}
+
 /**
  * as_curl_new:
  *
@@ -460,6 +1201,11 @@ as_curl_new (GError **error)
 	curl_easy_setopt (priv->curl, CURLOPT_XFERINFOFUNCTION, as_curl_progress_dummy_cb);
 	curl_easy_setopt (priv->curl, CURLOPT_NOPROGRESS, 0L);
 
+	/* reuse DNS lookups, TLS sessions and connections across all AsCurl instances
+	 * (duplicated handles for concurrent transfers inherit the share as well) */
+	if (as_curl_get_share () != NULL)
+		curl_easy_setopt (priv->curl, CURLOPT_SHARE, as_curl_get_share ());
+
 	/* Abort the connection if connecting to the server takes too long. This
 	 * timeout has no effect after a connection is established. */
 	curl_easy_setopt (priv->curl, CURLOPT_CONNECTTIMEOUT, AS_HTTP_TIMEOUT_SECS);
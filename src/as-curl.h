@@ -52,6 +52,25 @@ typedef enum {
 #define AS_CURL_ERROR as_curl_error_quark ()
 GQuark	 as_curl_error_quark (void);
 
+/**
+ * AsCurlRequest:
+ * @url:	The URL to download.
+ * @fname:	Target filename, or %NULL to download into memory.
+ * @bytes:	The downloaded data, if @fname was %NULL and the download succeeded.
+ * @error:	Set if this particular download failed.
+ *
+ * A single download request for as_curl_download_multi().
+ **/
+typedef struct {
+	gchar  *url;
+	gchar  *fname;
+	GBytes *bytes;
+	GError *error;
+} AsCurlRequest;
+
+AsCurlRequest *as_curl_request_new (const gchar *url, const gchar *fname);
+void	       as_curl_request_free (AsCurlRequest *request);
+
 AsCurl	*as_curl_new (GError **error);
 
 void	 as_curl_set_cainfo (AsCurl *acurl, const gchar *cainfo);
@@ -65,7 +84,37 @@ gboolean as_curl_download_to_filename (AsCurl	   *acurl,
 				       const gchar *fname,
 				       GError	  **error);
 
+gboolean as_curl_download_multi (AsCurl *acurl, GPtrArray *requests, GError **error);
+
+/**
+ * AsCurlUrlCheck:
+ * @url:	The URL to check.
+ * @etag:	The ETag header value the server sent, if any.
+ * @error:	Set if the URL does not exist or could not be reached.
+ *
+ * A single URL existence check for as_curl_check_urls_exist().
+ **/
+typedef struct {
+	gchar  *url;
+	gchar  *etag;
+	GError *error;
+} AsCurlUrlCheck;
+
+AsCurlUrlCheck *as_curl_url_check_new (const gchar *url);
+void		as_curl_url_check_free (AsCurlUrlCheck *check);
+
+gboolean as_curl_check_urls_exist (AsCurl    *acurl,
+				   GPtrArray *checks,
+				   guint      max_parallel_per_host,
+				   GError   **error);
+
 gboolean as_curl_check_url_exists (AsCurl *acurl, const gchar *url, GError **error);
+gboolean as_curl_check_url_exists_full (AsCurl	    *acurl,
+					const gchar *url,
+					gchar	   **etag,
+					GError	   **error);
+
+gchar	*as_curl_query_etag (AsCurl *acurl, const gchar *url, GError **error);
 
 gboolean as_curl_is_url (const gchar *url);
 
@@ -38,22 +38,6 @@
 
 #define DESKTOP_GROUP G_KEY_FILE_DESKTOP_GROUP
 
-/**
- * as_strequal_casefold:
- */
-static gboolean
-as_strequal_casefold (const gchar *a, const gchar *b)
-{
-	g_autofree gchar *str1 = NULL;
-	g_autofree gchar *str2 = NULL;
-
-	if (a != NULL)
-		str1 = g_utf8_casefold (a, -1);
-	if (b != NULL)
-		str2 = g_utf8_casefold (b, -1);
-	return g_strcmp0 (str1, str2) == 0;
-}
-
 /**
  * as_desktop_entry_add_issue:
  */
@@ -198,6 +182,172 @@ as_get_desktop_entry_value (GKeyFile *df, GPtrArray *issues, const gchar *key)
 	return g_string_free (sane_str, FALSE);
 }
 
+typedef struct {
+	gchar *key;
+	gchar *value;
+} AsDesktopEntryField;
+
+static void
+as_desktop_entry_field_free (AsDesktopEntryField *field)
+{
+	g_free (field->key);
+	g_free (field->value);
+	g_free (field);
+}
+
+/**
+ * as_desktop_entry_fields_get:
+ *
+ * Get the value for the given key from a scanned field list,
+ * or %NULL if the key was not present.
+ */
+static const gchar *
+as_desktop_entry_fields_get (GPtrArray *fields, const gchar *key)
+{
+	for (guint i = 0; i < fields->len; i++) {
+		AsDesktopEntryField *field = g_ptr_array_index (fields, i);
+		if (g_strcmp0 (field->key, key) == 0)
+			return field->value;
+	}
+	return NULL;
+}
+
+/**
+ * as_desktop_entry_unescape_value:
+ *
+ * Resolve the escape sequences that are permitted in desktop-entry values
+ * and replace any non-printable characters, the same way
+ * as_get_desktop_entry_value() does for values read via #GKeyFile.
+ */
+static gchar *
+as_desktop_entry_unescape_value (const gchar *value, gsize len)
+{
+	GString *res = g_string_sized_new (len);
+
+	for (gsize i = 0; i < len;) {
+		gunichar c;
+
+		if (value[i] == '\\' && i + 1 < len) {
+			switch (value[i + 1]) {
+			case 's':
+				g_string_append_c (res, ' ');
+				break;
+			case 'n':
+				g_string_append_c (res, '\n');
+				break;
+			case 't':
+				g_string_append_c (res, '\t');
+				break;
+			case 'r':
+				g_string_append_c (res, '\r');
+				break;
+			case '\\':
+				g_string_append_c (res, '\\');
+				break;
+			default:
+				/* pass invalid escape sequences through verbatim */
+				g_string_append_c (res, value[i]);
+				g_string_append_c (res, value[i + 1]);
+				break;
+			}
+			i += 2;
+			continue;
+		}
+
+		c = g_utf8_get_char (value + i);
+		if (as_unichar_accepted (c))
+			g_string_append_unichar (res, c);
+		else
+			g_string_append (res, "�");
+		i = g_utf8_next_char (value + i) - value;
+	}
+
+	return g_string_free (res, FALSE);
+}
+
+/**
+ * as_desktop_entry_scan_data:
+ *
+ * Single-pass line scanner extracting all key/value pairs of the
+ * Desktop Entry group, without going through the generic #GKeyFile
+ * machinery. Lines belonging to other groups (e.g. desktop actions
+ * and their translations) are skipped without allocating anything.
+ *
+ * Returns: %TRUE if a Desktop Entry group was found.
+ */
+static gboolean
+as_desktop_entry_scan_data (const gchar *data, gssize data_len, GPtrArray *fields)
+{
+	const gchar *pos;
+	const gchar *end;
+	gboolean in_de_group = FALSE;
+	gboolean found_de_group = FALSE;
+
+	if (data_len < 0)
+		data_len = strlen (data);
+	end = data + data_len;
+
+	for (pos = data; pos < end;) {
+		const gchar *line = pos;
+		const gchar *line_end = memchr (pos, '\n', end - pos);
+		gsize line_len = ((line_end == NULL) ? end : line_end) - pos;
+		const gchar *eq;
+		const gchar *key_end;
+		const gchar *value;
+		gsize value_len;
+		g_autofree gchar *key = NULL;
+		AsDesktopEntryField *field;
+
+		pos = (line_end == NULL) ? end : line_end + 1;
+
+		/* strip trailing carriage return */
+		if (line_len > 0 && line[line_len - 1] == '\r')
+			line_len--;
+
+		/* skip empty lines and comments */
+		if (line_len == 0 || line[0] == '#')
+			continue;
+
+		/* group header */
+		if (line[0] == '[') {
+			in_de_group = line_len == strlen ("[" DESKTOP_GROUP "]") &&
+				      strncmp (line, "[" DESKTOP_GROUP "]", line_len) == 0;
+			if (in_de_group)
+				found_de_group = TRUE;
+			continue;
+		}
+		if (!in_de_group)
+			continue;
+
+		eq = memchr (line, '=', line_len);
+		if (eq == NULL)
+			continue;
+
+		/* strip whitespace around the delimiter */
+		key_end = eq;
+		while (key_end > line && (key_end[-1] == ' ' || key_end[-1] == '\t'))
+			key_end--;
+		if (key_end == line)
+			continue;
+		value = eq + 1;
+		while (value < line + line_len && (*value == ' ' || *value == '\t'))
+			value++;
+		value_len = line + line_len - value;
+
+		/* the first occurrence of a key wins */
+		key = g_strndup (line, key_end - line);
+		if (as_desktop_entry_fields_get (fields, key) != NULL)
+			continue;
+
+		field = g_new0 (AsDesktopEntryField, 1);
+		field->key = g_steal_pointer (&key);
+		field->value = as_desktop_entry_unescape_value (value, value_len);
+		g_ptr_array_add (fields, field);
+	}
+
+	return found_de_group;
+}
+
 /**
  * as_check_desktop_string:
  */
@@ -243,6 +393,167 @@ as_get_external_desktop_translations (GKeyFile *kf,
 	return l10n;
 }
 
+/**
+ * as_desktop_entry_get_value_raw:
+ *
+ * Fetch a value from whichever representation of the desktop-entry
+ * data we are working with.
+ */
+static gchar *
+as_desktop_entry_get_value_raw (GKeyFile *df, GPtrArray *fields, const gchar *key)
+{
+	if (df != NULL)
+		return g_key_file_get_string (df, DESKTOP_GROUP, key, NULL);
+	return g_strdup (as_desktop_entry_fields_get (fields, key));
+}
+
+/**
+ * as_desktop_entry_process_field:
+ *
+ * Apply a single key/value pair from the Desktop Entry group to the
+ * component we are synthesizing from this desktop-entry file.
+ */
+static void
+as_desktop_entry_process_field (AsComponent *cpt,
+				GKeyFile *df,
+				GPtrArray *issues,
+				const gchar *key,
+				const gchar *locale,
+				const gchar *val,
+				gboolean had_name,
+				gboolean had_summary,
+				gboolean had_categories,
+				gboolean had_mimetypes,
+				AsTranslateDesktopTextFn de_l10n_fn,
+				gpointer user_data)
+{
+	if (g_str_has_prefix (key, "Name")) {
+		g_autoptr(GPtrArray) l10n_data = NULL;
+		if (had_name)
+			return;
+
+		as_component_set_name (cpt, val, locale);
+		as_check_desktop_string (issues, key, val);
+		l10n_data = as_get_external_desktop_translations (df,
+								  val,
+								  locale,
+								  de_l10n_fn,
+								  user_data);
+		if (l10n_data != NULL) {
+			for (guint j = 0; j < l10n_data->len; j += 2)
+				as_component_set_name (cpt,
+						       g_ptr_array_index (l10n_data, j),
+						       g_ptr_array_index (l10n_data, j + 1));
+		}
+	} else if (g_str_has_prefix (key, "Comment")) {
+		g_autoptr(GPtrArray) l10n_data = NULL;
+		if (had_summary)
+			return;
+
+		as_component_set_summary (cpt, val, locale);
+		as_check_desktop_string (issues, key, val);
+		l10n_data = as_get_external_desktop_translations (df,
+								  val,
+								  locale,
+								  de_l10n_fn,
+								  user_data);
+		if (l10n_data != NULL) {
+			for (guint j = 0; j < l10n_data->len; j += 2)
+				as_component_set_name (cpt,
+						       g_ptr_array_index (l10n_data, j),
+						       g_ptr_array_index (l10n_data, j + 1));
+		}
+	} else if (g_strcmp0 (key, "Categories") == 0) {
+		g_auto(GStrv) cats = NULL;
+		if (had_categories)
+			return;
+
+		cats = g_strsplit (val, ";", -1);
+		as_add_filtered_categories (cats, cpt, issues);
+	} else if (g_str_has_prefix (key, "Keywords")) {
+		g_auto(GStrv) kws = NULL;
+		g_autoptr(GPtrArray) kws_list = NULL;
+		g_autoptr(GPtrArray) l10n_data = NULL;
+
+		/* skip adding keywords if the metainfo file or previous component has
+		 * already had some for this locale */
+		if (g_hash_table_contains (as_component_get_keywords_table (cpt), locale))
+			return;
+
+		kws = g_strsplit (val, ";", -1);
+		kws_list = as_strv_to_ptr_array (kws, TRUE, TRUE);
+		as_component_set_keywords (cpt, kws_list, locale, FALSE);
+
+		l10n_data = as_get_external_desktop_translations (df,
+								  val,
+								  locale,
+								  de_l10n_fn,
+								  user_data);
+		if (l10n_data != NULL) {
+			for (guint j = 0; j < l10n_data->len; j += 2) {
+				g_auto(GStrv) tmp_strv = NULL;
+				g_autoptr(GPtrArray) e_kws = NULL;
+
+				const gchar *e_locale = g_ptr_array_index (l10n_data, j);
+				gchar *e_value = g_ptr_array_index (l10n_data, j + 1);
+
+				tmp_strv = g_strsplit (e_value, ";", -1);
+				e_kws = as_strv_to_ptr_array (tmp_strv, TRUE, TRUE);
+				as_component_set_keywords (cpt, e_kws, e_locale, FALSE);
+			}
+		}
+	} else if (g_strcmp0 (key, "MimeType") == 0) {
+		g_auto(GStrv) mts = NULL;
+		g_autoptr(AsProvided) prov = NULL;
+		if (had_mimetypes)
+			return;
+
+		mts = g_strsplit (val, ";", -1);
+		if (mts == NULL)
+			return;
+
+		prov = as_component_get_provided_for_kind (cpt, AS_PROVIDED_KIND_MEDIATYPE);
+		if (prov == NULL) {
+			prov = as_provided_new ();
+			as_provided_set_kind (prov, AS_PROVIDED_KIND_MEDIATYPE);
+		} else {
+			g_object_ref (prov);
+		}
+
+		for (guint j = 0; mts[j] != NULL; j++) {
+			if (g_strcmp0 (mts[j], "") == 0)
+				continue;
+			as_provided_add_item (prov, mts[j]);
+		}
+
+		as_component_add_provided (cpt, prov);
+	} else if (g_strcmp0 (key, "Icon") == 0) {
+		g_autoptr(AsIcon) icon = NULL;
+		g_autofree gchar *icon_name = g_strdup (val);
+
+		icon = as_icon_new ();
+		if (g_str_has_prefix (icon_name, "/")) {
+			as_icon_set_kind (icon, AS_ICON_KIND_LOCAL);
+			as_icon_set_filename (icon, icon_name);
+		} else {
+			gchar *dot;
+			as_icon_set_kind (icon, AS_ICON_KIND_STOCK);
+
+			/* work around stock icons being suffixed */
+			dot = g_strstr_len (icon_name, -1, ".");
+			if (dot != NULL &&
+			    (g_strcmp0 (dot, ".png") == 0 || g_strcmp0 (dot, ".xpm") == 0 ||
+			     g_strcmp0 (dot, ".svg") == 0 || g_strcmp0 (dot, ".svgz") == 0)) {
+				*dot = '\0';
+			}
+
+			as_icon_set_name (icon, icon_name);
+		}
+
+		as_component_add_icon (cpt, icon);
+	}
+}
+
 /**
  * as_desktop_entry_parse_data:
  */
@@ -258,6 +569,7 @@ as_desktop_entry_parse_data (AsComponent *cpt,
 			     GError **error)
 {
 	g_autoptr(GKeyFile) df = NULL;
+	g_autoptr(GPtrArray) fields = NULL;
 	g_auto(GStrv) keys = NULL;
 	gboolean ignore_cpt = FALSE;
 	GError *tmp_error = NULL;
@@ -274,26 +586,45 @@ as_desktop_entry_parse_data (AsComponent *cpt,
 		return FALSE;
 	}
 
-	df = g_key_file_new ();
-	g_key_file_load_from_data (df, data, data_len, G_KEY_FILE_KEEP_TRANSLATIONS, &tmp_error);
-	if (tmp_error != NULL) {
-		g_propagate_error (error, tmp_error);
-		return FALSE;
-	}
+	if (issues == NULL && de_l10n_fn == NULL) {
+		/* fast path: nobody wants per-key issue reports or external translations,
+		 * so we can bypass GKeyFile entirely and scan only the Desktop Entry group */
+		fields = g_ptr_array_new_with_free_func (
+		    (GDestroyNotify) as_desktop_entry_field_free);
+		if (!as_desktop_entry_scan_data (data, data_len, fields)) {
+			g_set_error (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "Data in '%s' does not contain a valid Desktop Entry.",
+				     as_component_get_id (cpt));
+			return FALSE;
+		}
+	} else {
+		df = g_key_file_new ();
+		g_key_file_load_from_data (df,
+					   data,
+					   data_len,
+					   G_KEY_FILE_KEEP_TRANSLATIONS,
+					   &tmp_error);
+		if (tmp_error != NULL) {
+			g_propagate_error (error, tmp_error);
+			return FALSE;
+		}
 
-	/* check this is a valid desktop file */
-	if (!g_key_file_has_group (df, DESKTOP_GROUP)) {
-		g_set_error (error,
-			     AS_METADATA_ERROR,
-			     AS_METADATA_ERROR_PARSE,
-			     "Data in '%s' does not contain a valid Desktop Entry.",
-			     as_component_get_id (cpt));
-		return FALSE;
+		/* check this is a valid desktop file */
+		if (!g_key_file_has_group (df, DESKTOP_GROUP)) {
+			g_set_error (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "Data in '%s' does not contain a valid Desktop Entry.",
+				     as_component_get_id (cpt));
+			return FALSE;
+		}
 	}
 
 	/* Type */
-	tmp = g_key_file_get_string (df, DESKTOP_GROUP, "Type", NULL);
-	if (!as_strequal_casefold (tmp, "application")) {
+	tmp = as_desktop_entry_get_value_raw (df, fields, "Type");
+	if (!as_utils_str_equal_fold (tmp, "application")) {
 		g_free (tmp);
 		/* not an application, so we can't proceed, but also no error */
 		return FALSE;
@@ -301,8 +632,8 @@ as_desktop_entry_parse_data (AsComponent *cpt,
 	g_free (tmp);
 
 	/* NoDisplay */
-	tmp = g_key_file_get_string (df, DESKTOP_GROUP, "NoDisplay", NULL);
-	if (as_strequal_casefold (tmp, "true")) {
+	tmp = as_desktop_entry_get_value_raw (df, fields, "NoDisplay");
+	if (as_utils_str_equal_fold (tmp, "true")) {
 		/* we may read the application data, but it will be ignored in its current form */
 		ignore_cpt = TRUE;
 		if (!ignore_nodisplay) {
@@ -313,8 +644,8 @@ as_desktop_entry_parse_data (AsComponent *cpt,
 	g_free (tmp);
 
 	/* X-AppStream-Ignore */
-	tmp = g_key_file_get_string (df, DESKTOP_GROUP, "X-AppStream-Ignore", NULL);
-	if (as_strequal_casefold (tmp, "true")) {
+	tmp = as_desktop_entry_get_value_raw (df, fields, "X-AppStream-Ignore");
+	if (as_utils_str_equal_fold (tmp, "true")) {
 		g_free (tmp);
 		/* this file should be ignored, we can't return a component (but this is also no error) */
 		return FALSE;
@@ -322,8 +653,8 @@ as_desktop_entry_parse_data (AsComponent *cpt,
 	g_free (tmp);
 
 	/* Hidden */
-	tmp = g_key_file_get_string (df, DESKTOP_GROUP, "Hidden", NULL);
-	if (as_strequal_casefold (tmp, "true")) {
+	tmp = as_desktop_entry_get_value_raw (df, fields, "Hidden");
+	if (as_utils_str_equal_fold (tmp, "true")) {
 		ignore_cpt = TRUE;
 		as_desktop_entry_add_issue (issues, "desktop-entry-hidden-set", NULL);
 		if (!ignore_nodisplay) {
@@ -334,7 +665,7 @@ as_desktop_entry_parse_data (AsComponent *cpt,
 	g_free (tmp);
 
 	/* OnlyShowIn */
-	tmp = g_key_file_get_string (df, DESKTOP_GROUP, "OnlyShowIn", NULL);
+	tmp = as_desktop_entry_get_value_raw (df, fields, "OnlyShowIn");
 	if (tmp != NULL) {
 		if (as_is_empty (tmp))
 			as_desktop_entry_add_issue (issues, "desktop-entry-empty-onlyshowin", NULL);
@@ -380,153 +711,72 @@ as_desktop_entry_parse_data (AsComponent *cpt,
 	had_mimetypes = as_component_get_provided_for_kind (cpt, AS_PROVIDED_KIND_MEDIATYPE) !=
 			NULL;
 
-	keys = g_key_file_get_keys (df, DESKTOP_GROUP, NULL, NULL);
-	for (guint i = 0; keys[i] != NULL; i++) {
-		g_autofree gchar *locale_posix = NULL;
-		g_autofree gchar *locale = NULL;
-		g_autofree gchar *val = NULL;
-		gchar *key = keys[i];
-
-		if (g_strcmp0 (key, "Type") == 0)
-			continue;
-
-		g_strstrip (key);
-		locale_posix = as_get_locale_from_key (key);
+	if (fields != NULL) {
+		for (guint i = 0; i < fields->len; i++) {
+			AsDesktopEntryField *field = g_ptr_array_index (fields, i);
+			g_autofree gchar *locale_posix = NULL;
+			g_autofree gchar *locale = NULL;
+			gchar *key = field->key;
 
-		/* skip invalid stuff */
-		if (locale_posix == NULL)
-			continue;
-		locale = as_utils_posix_locale_to_bcp47 (locale_posix);
-
-		val = as_get_desktop_entry_value (df, issues, key);
-		if (val == NULL)
-			continue;
-		if (g_str_has_prefix (key, "Name")) {
-			g_autoptr(GPtrArray) l10n_data = NULL;
-			if (had_name)
+			if (g_strcmp0 (key, "Type") == 0)
 				continue;
 
-			as_component_set_name (cpt, val, locale);
-			as_check_desktop_string (issues, key, val);
-			l10n_data = as_get_external_desktop_translations (df,
-									  val,
-									  locale,
-									  de_l10n_fn,
-									  user_data);
-			if (l10n_data != NULL) {
-				for (guint j = 0; j < l10n_data->len; j += 2)
-					as_component_set_name (
-					    cpt,
-					    g_ptr_array_index (l10n_data, j),
-					    g_ptr_array_index (l10n_data, j + 1));
-			}
-		} else if (g_str_has_prefix (key, "Comment")) {
-			g_autoptr(GPtrArray) l10n_data = NULL;
-			if (had_summary)
-				continue;
+			g_strstrip (key);
+			locale_posix = as_get_locale_from_key (key);
 
-			as_component_set_summary (cpt, val, locale);
-			as_check_desktop_string (issues, key, val);
-			l10n_data = as_get_external_desktop_translations (df,
-									  val,
-									  locale,
-									  de_l10n_fn,
-									  user_data);
-			if (l10n_data != NULL) {
-				for (guint j = 0; j < l10n_data->len; j += 2)
-					as_component_set_name (
-					    cpt,
-					    g_ptr_array_index (l10n_data, j),
-					    g_ptr_array_index (l10n_data, j + 1));
-			}
-		} else if (g_strcmp0 (key, "Categories") == 0) {
-			g_auto(GStrv) cats = NULL;
-			if (had_categories)
+			/* skip invalid stuff */
+			if (locale_posix == NULL)
 				continue;
-
-			cats = g_strsplit (val, ";", -1);
-			as_add_filtered_categories (cats, cpt, issues);
-		} else if (g_str_has_prefix (key, "Keywords")) {
-			g_auto(GStrv) kws = NULL;
-			g_autoptr(GPtrArray) kws_list = NULL;
-			g_autoptr(GPtrArray) l10n_data = NULL;
-
-			/* skip adding keywords if the metainfo file or previous component has
-			 * already had some for this locale */
-			if (g_hash_table_contains (as_component_get_keywords_table (cpt), locale))
+			locale = as_utils_posix_locale_to_bcp47 (locale_posix);
+
+			as_desktop_entry_process_field (cpt,
+							NULL,
+							NULL,
+							key,
+							locale,
+							field->value,
+							had_name,
+							had_summary,
+							had_categories,
+							had_mimetypes,
+							NULL,
+							NULL);
+		}
+	} else {
+		keys = g_key_file_get_keys (df, DESKTOP_GROUP, NULL, NULL);
+		for (guint i = 0; keys[i] != NULL; i++) {
+			g_autofree gchar *locale_posix = NULL;
+			g_autofree gchar *locale = NULL;
+			g_autofree gchar *val = NULL;
+			gchar *key = keys[i];
+
+			if (g_strcmp0 (key, "Type") == 0)
 				continue;
 
-			kws = g_strsplit (val, ";", -1);
-			kws_list = as_strv_to_ptr_array (kws, TRUE, TRUE);
-			as_component_set_keywords (cpt, kws_list, locale, FALSE);
-
-			l10n_data = as_get_external_desktop_translations (df,
-									  val,
-									  locale,
-									  de_l10n_fn,
-									  user_data);
-			if (l10n_data != NULL) {
-				for (guint j = 0; j < l10n_data->len; j += 2) {
-					g_auto(GStrv) tmp_strv = NULL;
-					g_autoptr(GPtrArray) e_kws = NULL;
-
-					const gchar *e_locale = g_ptr_array_index (l10n_data, j);
-					gchar *e_value = g_ptr_array_index (l10n_data, j + 1);
-
-					tmp_strv = g_strsplit (e_value, ";", -1);
-					e_kws = as_strv_to_ptr_array (tmp_strv, TRUE, TRUE);
-					as_component_set_keywords (cpt, e_kws, e_locale, FALSE);
-				}
-			}
-		} else if (g_strcmp0 (key, "MimeType") == 0) {
-			g_auto(GStrv) mts = NULL;
-			g_autoptr(AsProvided) prov = NULL;
-			if (had_mimetypes)
-				continue;
+			g_strstrip (key);
+			locale_posix = as_get_locale_from_key (key);
 
-			mts = g_strsplit (val, ";", -1);
-			if (mts == NULL)
+			/* skip invalid stuff */
+			if (locale_posix == NULL)
 				continue;
+			locale = as_utils_posix_locale_to_bcp47 (locale_posix);
 
-			prov = as_component_get_provided_for_kind (cpt, AS_PROVIDED_KIND_MEDIATYPE);
-			if (prov == NULL) {
-				prov = as_provided_new ();
-				as_provided_set_kind (prov, AS_PROVIDED_KIND_MEDIATYPE);
-			} else {
-				g_object_ref (prov);
-			}
-
-			for (guint j = 0; mts[j] != NULL; j++) {
-				if (g_strcmp0 (mts[j], "") == 0)
-					continue;
-				as_provided_add_item (prov, mts[j]);
-			}
-
-			as_component_add_provided (cpt, prov);
-		} else if (g_strcmp0 (key, "Icon") == 0) {
-			g_autoptr(AsIcon) icon = NULL;
-
-			icon = as_icon_new ();
-			if (g_str_has_prefix (val, "/")) {
-				as_icon_set_kind (icon, AS_ICON_KIND_LOCAL);
-				as_icon_set_filename (icon, val);
-			} else {
-				gchar *dot;
-				as_icon_set_kind (icon, AS_ICON_KIND_STOCK);
-
-				/* work around stock icons being suffixed */
-				dot = g_strstr_len (val, -1, ".");
-				if (dot != NULL &&
-				    (g_strcmp0 (dot, ".png") == 0 || g_strcmp0 (dot, ".xpm") == 0 ||
-				     g_strcmp0 (dot, ".svg") == 0 ||
-				     g_strcmp0 (dot, ".svgz") == 0)) {
-					*dot = '\0';
-				}
-
-				as_icon_set_name (icon, val);
-			}
+			val = as_get_desktop_entry_value (df, issues, key);
+			if (val == NULL)
+				continue;
 
-			as_component_add_icon (cpt, icon);
+			as_desktop_entry_process_field (cpt,
+							df,
+							issues,
+							key,
+							locale,
+							val,
+							had_name,
+							had_summary,
+							had_categories,
+							had_mimetypes,
+							de_l10n_fn,
+							user_data);
 		}
 	}
 
@@ -10,6 +10,8 @@
 /*
  * Desktop environment names from: data/desktop-environments.txt
  * Environment/Style names from:   data/desktop-style-ids.txt
+ *
+ * The tables are sorted by ID in byte order, as lookups binary-search them.
  */
 
 #include <glib/gi18n-lib.h>
@@ -61,10 +63,10 @@ AsDesktopEnvData as_desktop_env_data[] = {
 	{ "Pantheon", N_("Pantheon") },
 	/* TRANSLATORS: Name of the "Plasma" desktop environment. */
 	{ "Plasma", N_("KDE Plasma") },
-	/* TRANSLATORS: Name of the "Razor" desktop environment. */
-	{ "Razor", N_("Razor") },
 	/* TRANSLATORS: Name of the "ROX" desktop environment. */
 	{ "ROX", N_("ROX") },
+	/* TRANSLATORS: Name of the "Razor" desktop environment. */
+	{ "Razor", N_("Razor") },
 	/* TRANSLATORS: Name of the "Unity" desktop environment. */
 	{ "Unity", N_("Unity") },
 	/* TRANSLATORS: Name of the "XFCE" desktop environment. */
@@ -248,7 +248,7 @@ as_developer_load_from_xml (AsDeveloper *devp, AsContext *ctx, xmlNode *node, GE
 			continue;
 
 		if (as_str_equal0 (iter->name, "name")) {
-			g_autofree gchar *lang = NULL;
+			const gchar *lang = NULL;
 			lang = as_xml_get_node_locale_match (ctx, iter);
 			if (lang != NULL) {
 				g_autofree gchar *content = as_xml_get_node_value (iter);
@@ -37,16 +37,31 @@ typedef struct {
 	GPtrArray *files;	  /* of gchar* */
 	GPtrArray *queue_add;	  /* of gchar* */
 	GPtrArray *queue_changed; /* of gchar* */
+	GPtrArray *queue_removed; /* of gchar* */
 	GPtrArray *queue_temp;	  /* of gchar* */
 	guint pending_id;
+
+	guint debounce_ms;
+	guint burst_events;
+	gint64 last_event_time;
 } AsFileMonitorPrivate;
 
+/* debounce window for the first event after a quiet period */
+#define AS_FILE_MONITOR_DEBOUNCE_MIN_MS 800
+
+/* maximum debounce window reached during sustained event bursts */
+#define AS_FILE_MONITOR_DEBOUNCE_MAX_MS 8000
+
+/* two events closer together than this are considered part of one burst */
+#define AS_FILE_MONITOR_BURST_GAP_USEC (2 * G_USEC_PER_SEC)
+
 G_DEFINE_TYPE_WITH_PRIVATE (AsFileMonitor, as_file_monitor, G_TYPE_OBJECT)
 
 enum {
 	SIGNAL_ADDED,
 	SIGNAL_REMOVED,
 	SIGNAL_CHANGED,
+	SIGNAL_CHANGES_FINISHED,
 	SIGNAL_LAST
 };
 
@@ -81,6 +96,7 @@ as_file_monitor_finalize (GObject *object)
 	g_ptr_array_unref (priv->files);
 	g_ptr_array_unref (priv->queue_add);
 	g_ptr_array_unref (priv->queue_changed);
+	g_ptr_array_unref (priv->queue_removed);
 	g_ptr_array_unref (priv->queue_temp);
 
 	G_OBJECT_CLASS (as_file_monitor_parent_class)->finalize (object);
@@ -94,7 +110,9 @@ as_file_monitor_init (AsFileMonitor *monitor)
 	priv->files = g_ptr_array_new_with_free_func (g_free);
 	priv->queue_add = g_ptr_array_new_with_free_func (g_free);
 	priv->queue_changed = g_ptr_array_new_with_free_func (g_free);
+	priv->queue_removed = g_ptr_array_new_with_free_func (g_free);
 	priv->queue_temp = g_ptr_array_new_with_free_func (g_free);
+	priv->debounce_ms = AS_FILE_MONITOR_DEBOUNCE_MIN_MS;
 }
 
 static void
@@ -162,6 +180,29 @@ as_file_monitor_class_init (AsFileMonitorClass *klass)
 						1,
 						G_TYPE_STRING);
 
+	/**
+	 * AsFileMonitor::changes-finished:
+	 * @monitor: the #AsFileMonitor instance that emitted the signal
+	 * @n_changes: the amount of per-file notifications in the batch
+	 *
+	 * The ::changes-finished signal is emitted once after a batch of
+	 * aggregated per-file notifications was delivered, so listeners can
+	 * react once per batch instead of once per file.
+	 *
+	 * Since: 1.0.5
+	 **/
+	signals[SIGNAL_CHANGES_FINISHED] = g_signal_new (
+	    "changes-finished",
+	    G_TYPE_FROM_CLASS (object_class),
+	    G_SIGNAL_RUN_LAST,
+	    G_STRUCT_OFFSET (AsFileMonitorClass, changes_finished),
+	    NULL,
+	    NULL,
+	    g_cclosure_marshal_VOID__UINT,
+	    G_TYPE_NONE,
+	    1,
+	    G_TYPE_UINT);
+
 	object_class->finalize = as_file_monitor_finalize;
 }
 
@@ -260,6 +301,7 @@ as_file_monitor_process_pending (AsFileMonitor *monitor)
 {
 	AsFileMonitorPrivate *priv = GET_PRIVATE (monitor);
 	guint i;
+	guint n_changes = 0;
 	const gchar *tmp;
 
 	/* stop the timer */
@@ -268,10 +310,23 @@ as_file_monitor_process_pending (AsFileMonitor *monitor)
 		priv->pending_id = 0;
 	}
 
+	/* emit all the pending removed signals */
+	for (i = 0; i < priv->queue_removed->len; i++) {
+		tmp = g_ptr_array_index (priv->queue_removed, i);
+		/* a file that was deleted and re-added within the aggregation window
+		 * was just replaced, the add queue will emit ::changed for it */
+		if (_g_ptr_array_str_find (priv->queue_add, tmp) != NULL)
+			continue;
+		as_file_monitor_emit_removed (monitor, tmp);
+		n_changes++;
+	}
+	g_ptr_array_set_size (priv->queue_removed, 0);
+
 	/* emit all the pending changed signals */
 	for (i = 0; i < priv->queue_changed->len; i++) {
 		tmp = g_ptr_array_index (priv->queue_changed, i);
 		as_file_monitor_emit_changed (monitor, tmp);
+		n_changes++;
 	}
 	g_ptr_array_set_size (priv->queue_changed, 0);
 
@@ -285,8 +340,19 @@ as_file_monitor_process_pending (AsFileMonitor *monitor)
 		} else {
 			as_file_monitor_emit_added (monitor, tmp);
 		}
+		n_changes++;
 	}
 	g_ptr_array_set_size (priv->queue_add, 0);
+
+	/* the burst is over, start with a narrow window again */
+	priv->burst_events = 0;
+	priv->last_event_time = 0;
+	priv->debounce_ms = AS_FILE_MONITOR_DEBOUNCE_MIN_MS;
+
+	if (n_changes > 0) {
+		g_debug ("Emit ::changes-finished(%u)", n_changes);
+		g_signal_emit (monitor, signals[SIGNAL_CHANGES_FINISHED], 0, n_changes);
+	}
 }
 
 static gboolean
@@ -312,6 +378,36 @@ as_file_monitor_process_pending_trigger (AsFileMonitor *monitor, guint timeout_m
 					  monitor);
 }
 
+/**
+ * as_file_monitor_update_debounce:
+ *
+ * Adapt the aggregation window to the current event rate: events arriving
+ * in quick succession (e.g. a package manager replacing thousands of files)
+ * widen the window, so a whole update ends up in one notification batch
+ * instead of causing a storm of per-file signals.
+ *
+ * Returns: the debounce window to use for the event that just arrived.
+ **/
+static guint
+as_file_monitor_update_debounce (AsFileMonitor *monitor)
+{
+	AsFileMonitorPrivate *priv = GET_PRIVATE (monitor);
+	gint64 now = g_get_monotonic_time ();
+
+	if (priv->last_event_time != 0 &&
+	    now - priv->last_event_time < AS_FILE_MONITOR_BURST_GAP_USEC) {
+		priv->burst_events++;
+		priv->debounce_ms = MIN (priv->debounce_ms + priv->debounce_ms / 2,
+					 AS_FILE_MONITOR_DEBOUNCE_MAX_MS);
+	} else {
+		priv->burst_events = 0;
+		priv->debounce_ms = AS_FILE_MONITOR_DEBOUNCE_MIN_MS;
+	}
+	priv->last_event_time = now;
+
+	return priv->debounce_ms;
+}
+
 /**
  * as_file_monitor_file_changed_cb:
  *
@@ -331,6 +427,7 @@ as_file_monitor_file_changed_cb (GFileMonitor *mon,
 	AsFileMonitorPrivate *priv = GET_PRIVATE (monitor);
 	const gchar *tmp;
 	gboolean is_temp;
+	guint debounce_ms;
 	g_autofree gchar *basename = NULL;
 	g_autofree gchar *filename = NULL;
 	g_autofree gchar *filename_other = NULL;
@@ -355,7 +452,12 @@ as_file_monitor_file_changed_cb (GFileMonitor *mon,
 
 	switch (event_type) {
 	case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
-		as_file_monitor_process_pending_trigger (monitor, 50);
+		debounce_ms = as_file_monitor_update_debounce (monitor);
+		/* flush quickly after a lone change, but keep aggregating
+		 * while we are within an event burst */
+		as_file_monitor_process_pending_trigger (monitor,
+							 priv->burst_events > 0 ? debounce_ms
+										: 50);
 		break;
 	case G_FILE_MONITOR_EVENT_CREATED:
 	case G_FILE_MONITOR_EVENT_MOVED_IN:
@@ -365,13 +467,23 @@ as_file_monitor_file_changed_cb (GFileMonitor *mon,
 			_g_ptr_array_str_add (priv->queue_temp, filename);
 		}
 		/* file monitors do not send CHANGES_DONE_HINT */
-		as_file_monitor_process_pending_trigger (monitor, 800);
+		as_file_monitor_process_pending_trigger (
+		    monitor,
+		    as_file_monitor_update_debounce (monitor));
 		break;
 	case G_FILE_MONITOR_EVENT_DELETED:
 	case G_FILE_MONITOR_EVENT_MOVED_OUT:
+		/* the file is gone, any pending notifications for it are void */
+		_g_ptr_array_str_remove (priv->queue_add, filename);
+		_g_ptr_array_str_remove (priv->queue_changed, filename);
+		_g_ptr_array_str_remove (priv->queue_temp, filename);
+
 		/* only emit notifications for files we know about */
 		if (_g_ptr_array_str_find (priv->files, filename)) {
-			as_file_monitor_emit_removed (monitor, filename);
+			_g_ptr_array_str_add (priv->queue_removed, filename);
+			as_file_monitor_process_pending_trigger (
+			    monitor,
+			    as_file_monitor_update_debounce (monitor));
 		} else {
 			g_debug ("ignoring deleted file %s", filename);
 		}
@@ -383,7 +495,9 @@ as_file_monitor_file_changed_cb (GFileMonitor *mon,
 		    _g_ptr_array_str_find (priv->queue_temp, filename) == NULL) {
 			_g_ptr_array_str_add (priv->queue_changed, filename);
 		}
-		as_file_monitor_process_pending_trigger (monitor, 800);
+		as_file_monitor_process_pending_trigger (
+		    monitor,
+		    as_file_monitor_update_debounce (monitor));
 		break;
 	case G_FILE_MONITOR_EVENT_RENAMED:
 		/* a temp file that was just created and atomically
@@ -392,15 +506,16 @@ as_file_monitor_file_changed_cb (GFileMonitor *mon,
 		if (tmp != NULL) {
 			g_debug ("detected atomic save, adding %s", filename_other);
 			g_ptr_array_remove_fast (priv->queue_temp, (gpointer) tmp);
-			if (_g_ptr_array_str_find (priv->files, filename_other) != NULL)
-				as_file_monitor_emit_changed (monitor, filename_other);
-			else
-				as_file_monitor_emit_added (monitor, filename_other);
+			_g_ptr_array_str_add (priv->queue_add, filename_other);
 		} else {
 			g_debug ("detected rename, treating it as remove->add");
-			as_file_monitor_emit_removed (monitor, filename);
-			as_file_monitor_emit_added (monitor, filename_other);
+			if (_g_ptr_array_str_find (priv->files, filename) != NULL)
+				_g_ptr_array_str_add (priv->queue_removed, filename);
+			_g_ptr_array_str_add (priv->queue_add, filename_other);
 		}
+		as_file_monitor_process_pending_trigger (
+		    monitor,
+		    as_file_monitor_update_debounce (monitor));
 		break;
 	default:
 		break;
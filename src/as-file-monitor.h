@@ -38,8 +38,8 @@ struct _AsFileMonitorClass {
 	void (*added) (AsFileMonitor *monitor, const gchar *filename);
 	void (*removed) (AsFileMonitor *monitor, const gchar *filename);
 	void (*changed) (AsFileMonitor *monitor, const gchar *filename);
+	void (*changes_finished) (AsFileMonitor *monitor, guint n_changes);
 	/*< private >*/
-	void (*_as_reserved1) (void);
 	void (*_as_reserved2) (void);
 	void (*_as_reserved3) (void);
 	void (*_as_reserved4) (void);
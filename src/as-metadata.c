@@ -37,6 +37,7 @@
 #include <string.h>
 
 #include "as-metadata.h"
+#include "as-metadata-private.h"
 
 #include "as-utils.h"
 #include "as-utils-private.h"
@@ -62,9 +63,16 @@ typedef struct {
 	gboolean update_existing;
 	gboolean write_header;
 	AsParseFlags parse_flags;
+	guint32 load_kinds; /* bitmask of component kinds to load, 0 means all */
+	gboolean write_search_tokens;
 
 	AsComponentBox *cbox;
-	GPtrArray *releases; /* of AsReleaseList */
+	GPtrArray *releases;	/* of AsReleaseList */
+	GPtrArray *delta_bases; /* of utf8, base checksums that delta catalogs may apply to */
+
+	gboolean compute_checksums;
+	GHashTable *cpt_checksums; /* of utf8:cid → utf8:hexdigest, from the last catalog write */
+	gchar *catalog_checksum;
 } AsMetadataPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (AsMetadata, as_metadata, G_TYPE_OBJECT)
@@ -125,9 +133,13 @@ as_metadata_init (AsMetadata *metad)
 	priv->write_header = TRUE;
 	priv->update_existing = FALSE;
 	priv->parse_flags = AS_PARSE_FLAG_NONE;
+	priv->load_kinds = 0;
+	priv->write_search_tokens = FALSE;
 
 	priv->cbox = as_component_box_new_simple ();
 	priv->releases = g_ptr_array_new_with_free_func (g_object_unref);
+	priv->delta_bases = g_ptr_array_new_with_free_func (g_free);
+	priv->cpt_checksums = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 }
 
 /**
@@ -146,6 +158,9 @@ as_metadata_finalize (GObject *object)
 
 	g_object_unref (priv->cbox);
 	g_ptr_array_unref (priv->releases);
+	g_ptr_array_unref (priv->delta_bases);
+	g_hash_table_unref (priv->cpt_checksums);
+	g_free (priv->catalog_checksum);
 
 	G_OBJECT_CLASS (as_metadata_parent_class)->finalize (object);
 }
@@ -161,6 +176,9 @@ as_metadata_new_context (AsMetadata *metad, AsFormatStyle style, const gchar *fn
 
 	as_context_set_format_version (context, priv->format_version);
 	as_context_set_locale (context, priv->locale);
+	as_context_set_locale_strict (
+	    context,
+	    as_flags_contains (priv->parse_flags, AS_PARSE_FLAG_STRICT_LOCALE));
 	as_context_set_origin (context, priv->origin);
 	as_context_set_architecture (context, priv->arch);
 	as_context_set_priority (context, priv->default_priority);
@@ -170,6 +188,7 @@ as_metadata_new_context (AsMetadata *metad, AsFormatStyle style, const gchar *fn
 
 	as_context_set_style (context, style);
 	as_context_set_filename (context, fname);
+	as_context_set_write_search_tokens (context, priv->write_search_tokens);
 
 	return context;
 }
@@ -187,6 +206,97 @@ as_metadata_clear_components (AsMetadata *metad)
 	as_component_box_clear (priv->cbox);
 }
 
+/**
+ * as_metadata_remove_components_by_id:
+ *
+ * Drop all previously parsed components matching the given
+ * component-ID from the results set.
+ */
+static void
+as_metadata_remove_components_by_id (AsMetadata *metad, const gchar *cid)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+
+	for (guint i = as_component_box_len (priv->cbox); i > 0; i--) {
+		AsComponent *cpt = as_component_box_index (priv->cbox, i - 1);
+		if (g_strcmp0 (as_component_get_id (cpt), cid) == 0)
+			as_component_box_remove_at (priv->cbox, i - 1);
+	}
+}
+
+/**
+ * as_metadata_component_kind_is_loaded:
+ *
+ * Check whether components of the given kind pass the load-kind filter.
+ * Components of unknown kind are always kept, so data which can not be
+ * classified cheaply is still handed to the full parser.
+ */
+static inline gboolean
+as_metadata_component_kind_is_loaded (guint32 load_kinds, AsComponentKind kind)
+{
+	if (load_kinds == 0)
+		return TRUE;
+	if (kind == AS_COMPONENT_KIND_UNKNOWN)
+		return TRUE;
+	return (load_kinds & (1U << kind)) != 0;
+}
+
+/**
+ * as_metadata_xml_cpt_node_is_loaded:
+ *
+ * Check whether a catalog component node passes the load-kind filter,
+ * by only looking at its type property.
+ */
+static gboolean
+as_metadata_xml_cpt_node_is_loaded (guint32 load_kinds, xmlNode *node)
+{
+	g_autofree gchar *kind_str = NULL;
+
+	if (load_kinds == 0)
+		return TRUE;
+	kind_str = as_xml_get_prop_value (node, "type");
+	return as_metadata_component_kind_is_loaded (load_kinds,
+						     as_component_kind_from_string (kind_str));
+}
+
+typedef struct {
+	GPtrArray *nodes;      /* borrowed component-node list */
+	AsComponent **results; /* parsed component per node index, or NULL */
+	GError **errors;       /* hard parse failure per node index, or NULL */
+	AsContext *context;    /* borrowed, shared between workers */
+	gint next_index;       /* atomic */
+} AsMetadataXmlParseHelper;
+
+/**
+ * as_metadata_xml_parse_cpt_nodes_worker:
+ *
+ * Worker thread turning catalog component nodes into #AsComponent
+ * instances. The libxml2 document is only ever read here, and the
+ * shared #AsContext is only read as well, which makes building
+ * components from distinct subtrees concurrently safe.
+ */
+static gpointer
+as_metadata_xml_parse_cpt_nodes_worker (gpointer data)
+{
+	AsMetadataXmlParseHelper *helper = data;
+	gint idx;
+
+	while ((idx = g_atomic_int_add (&helper->next_index, 1)) < (gint) helper->nodes->len) {
+		xmlNode *cnode = g_ptr_array_index (helper->nodes, idx);
+		g_autoptr(AsComponent) cpt = as_component_new ();
+		g_autoptr(GError) tmp_error = NULL;
+
+		if (as_component_load_from_xml (cpt, helper->context, cnode, &tmp_error)) {
+			as_component_set_origin_kind (cpt, AS_ORIGIN_KIND_CATALOG);
+			helper->results[idx] = g_steal_pointer (&cpt);
+		} else if (tmp_error != NULL) {
+			helper->errors[idx] = g_steal_pointer (&tmp_error);
+		}
+	}
+
+	return NULL;
+}
+
 /**
  * as_metadata_xml_parse_components_node:
  */
@@ -201,6 +311,45 @@ as_metadata_xml_parse_components_node (AsMetadata *metad,
 	GError *tmp_error = NULL;
 	gchar *priority_str;
 	gchar *tmp;
+	gboolean is_delta = FALSE;
+	g_autoptr(GPtrArray) cpt_nodes = NULL;
+	g_autofree AsComponent **results = NULL;
+	g_autofree GError **errors = NULL;
+	AsMetadataXmlParseHelper helper;
+	guint n_threads;
+	gboolean failed = FALSE;
+
+	/* check if we have a delta catalog which patches previously parsed data */
+	tmp = as_xml_get_prop_value (node, "type");
+	is_delta = g_strcmp0 (tmp, "delta") == 0;
+	g_free (tmp);
+
+	if (is_delta) {
+		g_autofree gchar *base_checksum = NULL;
+
+		base_checksum = as_xml_get_prop_value (node, "base_checksum");
+		if (base_checksum == NULL) {
+			g_set_error_literal (error,
+					     AS_METADATA_ERROR,
+					     AS_METADATA_ERROR_VALUE_MISSING,
+					     "Delta catalog has no base_checksum property, unable to "
+					     "determine the catalog it applies to.");
+			return;
+		}
+
+		/* refuse to patch if the delta was made for a base catalog that we do not have
+		 * (we apply any delta if no base checksums were registered at all) */
+		if (priv->delta_bases->len > 0 &&
+		    !as_ptr_array_find_string (priv->delta_bases, base_checksum)) {
+			g_set_error (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_FAILED,
+				     "Delta catalog does not apply to any of the loaded base "
+				     "catalogs (made for base %s).",
+				     base_checksum);
+			return;
+		}
+	}
 
 	/* set origin of this metadata */
 	tmp = as_xml_get_prop_value (node, "origin");
@@ -231,26 +380,264 @@ as_metadata_xml_parse_components_node (AsMetadata *metad,
 	}
 	g_free (priority_str);
 
-	for (iter = node->children; iter != NULL; iter = iter->next) {
-		g_autoptr(AsComponent) cpt = NULL;
+	/* delta catalogs interleave removal markers with replacement components, so their
+	 * entries must be applied strictly in document order and stay on one thread */
+	if (is_delta) {
+		for (iter = node->children; iter != NULL; iter = iter->next) {
+			g_autoptr(AsComponent) cpt = NULL;
+
+			/* discard spaces */
+			if (iter->type != XML_ELEMENT_NODE)
+				continue;
+
+			/* delta catalogs may list components which vanished from the base catalog */
+			if (g_strcmp0 ((gchar *) iter->name, "removed") == 0) {
+				g_autofree gchar *cid = as_xml_get_prop_value (iter, "id");
+				if (cid != NULL)
+					as_metadata_remove_components_by_id (metad, cid);
+				continue;
+			}
+
+			/* drop entries of filtered kinds without building their components */
+			if (!as_metadata_xml_cpt_node_is_loaded (priv->load_kinds, iter))
+				continue;
+
+			cpt = as_component_new ();
+			if (as_component_load_from_xml (cpt, context, iter, &tmp_error)) {
+				as_component_set_origin_kind (cpt, AS_ORIGIN_KIND_CATALOG);
+
+				/* changed components in a delta replace their base catalog version */
+				as_metadata_remove_components_by_id (metad,
+								     as_component_get_id (cpt));
+				as_component_box_add (priv->cbox, cpt, NULL);
+			} else {
+				if (tmp_error != NULL) {
+					g_propagate_error (error, tmp_error);
+					return;
+				}
+			}
+		}
 
+		return;
+	}
+
+	/* collect the component nodes first, so the expensive AsComponent
+	 * construction can be distributed across worker threads */
+	cpt_nodes = g_ptr_array_sized_new (as_xml_get_children_count (node));
+	for (iter = node->children; iter != NULL; iter = iter->next) {
 		/* discard spaces */
 		if (iter->type != XML_ELEMENT_NODE)
 			continue;
+		/* drop entries of filtered kinds without building their components */
+		if (!as_metadata_xml_cpt_node_is_loaded (priv->load_kinds, iter))
+			continue;
+		g_ptr_array_add (cpt_nodes, iter);
+	}
+	if (cpt_nodes->len == 0)
+		return;
+
+	results = g_new0 (AsComponent *, cpt_nodes->len);
+	errors = g_new0 (GError *, cpt_nodes->len);
+
+	helper.nodes = cpt_nodes;
+	helper.results = results;
+	helper.errors = errors;
+	helper.context = context;
+	helper.next_index = 0;
+
+	/* there is no point in spawning threads for small documents */
+	n_threads = MIN (g_get_num_processors (), cpt_nodes->len / 64);
+	if (n_threads <= 1) {
+		as_metadata_xml_parse_cpt_nodes_worker (&helper);
+	} else {
+		g_autofree GThread **threads = g_new0 (GThread *, n_threads);
+
+		/* all document-level settings have been applied at this point, so
+		 * the workers can share the now-immutable context without locking */
+		as_context_seal (context);
+		for (guint i = 0; i < n_threads; i++)
+			threads[i] = g_thread_new ("mdata-parse",
+						   as_metadata_xml_parse_cpt_nodes_worker,
+						   &helper);
+		for (guint i = 0; i < n_threads; i++)
+			g_thread_join (threads[i]);
+	}
 
-		cpt = as_component_new ();
-		if (as_component_load_from_xml (cpt, context, iter, &tmp_error)) {
-			as_component_set_origin_kind (cpt, AS_ORIGIN_KIND_CATALOG);
+	/* merge the results in document order, stopping at the first hard
+	 * parse error just like a sequential parse would */
+	for (guint i = 0; i < cpt_nodes->len; i++) {
+		g_autoptr(AsComponent) cpt = g_steal_pointer (&results[i]);
+
+		if (failed) {
+			g_clear_error (&errors[i]);
+			continue;
+		}
+		if (errors[i] != NULL) {
+			g_propagate_error (error, g_steal_pointer (&errors[i]));
+			failed = TRUE;
+			continue;
+		}
+
+		if (cpt != NULL)
 			as_component_box_add (priv->cbox, cpt, NULL);
-		} else {
-			if (tmp_error != NULL) {
-				g_propagate_error (error, tmp_error);
-				return;
+	}
+}
+
+typedef struct {
+	const gchar *data;     /* borrowed raw YAML data */
+	gsize data_len;
+	GArray *offsets;       /* borrowed document start offsets */
+	AsComponent **results; /* parsed component per document index, or NULL */
+	GError **errors;       /* hard parse failure per document index, or NULL */
+	AsContext *context;    /* borrowed, shared between workers */
+	guint32 load_kinds;    /* load-kind filter bitmask */
+	gint next_index;       /* atomic */
+	gint load_failed;      /* atomic */
+} AsMetadataYamlParseHelper;
+
+/**
+ * as_metadata_yaml_find_doc_boundaries:
+ *
+ * Quickly scan YAML catalog data for document start offsets, without
+ * involving the YAML parser. A new document starts at the beginning of
+ * the data and after every `---` separator at the start of a line, which
+ * can never occur inside scalar content in block context.
+ */
+static GArray *
+as_metadata_yaml_find_doc_boundaries (const gchar *data, gsize data_len)
+{
+	GArray *offsets = g_array_new (FALSE, FALSE, sizeof (gsize));
+	gsize pos = 0;
+
+	g_array_append_val (offsets, pos);
+	while (pos < data_len) {
+		const gchar *nl = memchr (data + pos, '\n', data_len - pos);
+		if (nl == NULL)
+			break;
+		pos = (gsize) (nl - data) + 1;
+		if (pos + 3 <= data_len && memcmp (data + pos, "---", 3) == 0 &&
+		    (pos + 3 == data_len || data[pos + 3] == '\n' || data[pos + 3] == '\r' ||
+		     data[pos + 3] == ' '))
+			g_array_append_val (offsets, pos);
+	}
+
+	return offsets;
+}
+
+/**
+ * as_metadata_yaml_doc_component_kind:
+ *
+ * Peek at the type of the component described by an already parsed
+ * DEP-11 document, without constructing the component itself.
+ */
+static AsComponentKind
+as_metadata_yaml_doc_component_kind (GNode *root)
+{
+	for (GNode *n = root->children; n != NULL; n = n->next) {
+		if (g_strcmp0 (as_yaml_node_get_key (n), "Type") == 0)
+			return as_component_kind_from_string (as_yaml_node_get_value (n));
+	}
+	return AS_COMPONENT_KIND_UNKNOWN;
+}
+
+/**
+ * as_metadata_yaml_parse_docs_worker:
+ *
+ * Worker thread parsing individual `---` separated YAML documents into
+ * #AsComponent instances. Every worker runs its own YAML parser over a
+ * private byte range of the input data, and the shared #AsContext is
+ * only read, which makes processing distinct documents concurrently safe.
+ */
+static gpointer
+as_metadata_yaml_parse_docs_worker (gpointer data)
+{
+	AsMetadataYamlParseHelper *helper = data;
+	gint idx;
+
+	while ((idx = g_atomic_int_add (&helper->next_index, 1)) <
+	       (gint) (helper->offsets->len - 1)) {
+		yaml_parser_t parser;
+		yaml_event_t event;
+		gboolean parse = TRUE;
+		gsize start, end;
+
+		if (g_atomic_int_get (&helper->load_failed))
+			break;
+
+		start = g_array_index (helper->offsets, gsize, (guint) idx + 1);
+		end = ((guint) idx + 2 < helper->offsets->len)
+			  ? g_array_index (helper->offsets, gsize, (guint) idx + 2)
+			  : helper->data_len;
+
+		yaml_parser_initialize (&parser);
+		yaml_parser_set_input_string (&parser,
+					      (unsigned char *) helper->data + start,
+					      end - start);
+		while (parse) {
+			if (!yaml_parser_parse (&parser, &event)) {
+				g_set_error (&helper->errors[idx],
+					     AS_METADATA_ERROR,
+					     AS_METADATA_ERROR_PARSE,
+					     "Invalid DEP-11 file found. Could not parse YAML: %s",
+					     parser.problem);
+				break;
+			}
+
+			if (event.type == YAML_DOCUMENT_START_EVENT) {
+				GError *tmp_error = NULL;
+				g_autoptr(GNode) root = NULL;
+				g_autoptr(GStringChunk) strchunk = NULL;
+
+				strchunk = g_string_chunk_new (16 * 1024);
+				root = g_node_new (g_string_chunk_insert (strchunk, ""));
+				as_yaml_parse_layer (&parser, root, strchunk, &tmp_error);
+				if (tmp_error != NULL) {
+					helper->errors[idx] = tmp_error;
+					yaml_event_delete (&event);
+					break;
+				}
+
+				/* ignore empty documents, e.g. a trailing separator line,
+				 * and drop documents of filtered kinds without building
+				 * their components */
+				if (root->children != NULL &&
+				    as_metadata_component_kind_is_loaded (
+					helper->load_kinds,
+					as_metadata_yaml_doc_component_kind (root))) {
+					g_autoptr(AsComponent) cpt = as_component_new ();
+					if (as_component_load_from_yaml (cpt,
+									 helper->context,
+									 root,
+									 NULL)) {
+						helper->results[idx] = g_steal_pointer (&cpt);
+					} else {
+						g_warning ("Parsing of YAML metadata failed: Could "
+							   "not read data for component.");
+						g_atomic_int_set (&helper->load_failed, TRUE);
+						yaml_event_delete (&event);
+						break;
+					}
+				}
 			}
+
+			if (event.type == YAML_STREAM_END_EVENT)
+				parse = FALSE;
+			yaml_event_delete (&event);
 		}
+		yaml_parser_delete (&parser);
 	}
+
+	return NULL;
 }
 
+static GPtrArray *as_metadata_yaml_parse_catalog_parallel (AsMetadata *metad,
+							   AsContext *context,
+							   const gchar *data,
+							   gsize data_len,
+							   GArray *offsets,
+							   guint n_threads,
+							   GError **error);
+
 /**
  * as_metadata_yaml_parse_catalog_doc:
  * @metad: an instance of #AsMetadata.
@@ -276,6 +663,8 @@ as_metadata_yaml_parse_catalog_doc (AsMetadata *metad,
 	gboolean header = TRUE;
 	gboolean parse = TRUE;
 	gboolean ret = TRUE;
+	guint n_threads;
+	g_autoptr(GArray) doc_offsets = NULL;
 	g_autoptr(GPtrArray) cpts = NULL;
 
 	/* we ignore empty data - usually happens if the file is broken, e.g. by disk corruption
@@ -285,6 +674,19 @@ as_metadata_yaml_parse_catalog_doc (AsMetadata *metad,
 	if (data_len < 0)
 		data_len = strlen (data);
 
+	/* large catalog files are split at their document boundaries, so the individual
+	 * component documents can be parsed on multiple threads */
+	doc_offsets = as_metadata_yaml_find_doc_boundaries (data, (gsize) data_len);
+	n_threads = MIN (g_get_num_processors (), (doc_offsets->len - 1) / 64);
+	if (n_threads > 1)
+		return as_metadata_yaml_parse_catalog_parallel (metad,
+								context,
+								data,
+								(gsize) data_len,
+								doc_offsets,
+								n_threads,
+								error);
+
 	/* create container for the components we find */
 	cpts = g_ptr_array_new_with_free_func (g_object_unref);
 
@@ -308,13 +710,16 @@ as_metadata_yaml_parse_catalog_doc (AsMetadata *metad,
 			gboolean header_found = FALSE;
 			GError *tmp_error = NULL;
 			g_autoptr(GNode) root = NULL;
+			g_autoptr(GStringChunk) strchunk = NULL;
 
-			root = g_node_new (g_strdup (""));
-			as_yaml_parse_layer (&parser, root, &tmp_error);
+			/* all scalar data of this document lives in a string chunk,
+			 * so we can release it in one step when we are done */
+			strchunk = g_string_chunk_new (16 * 1024);
+			root = g_node_new (g_string_chunk_insert (strchunk, ""));
+			as_yaml_parse_layer (&parser, root, strchunk, &tmp_error);
 			if (tmp_error != NULL) {
 				/* stop immediately, since we found an error when parsing the document */
 				g_propagate_error (error, tmp_error);
-				g_free (root->data);
 				yaml_event_delete (&event);
 				ret = FALSE;
 				parse = FALSE;
@@ -399,6 +804,15 @@ as_metadata_yaml_parse_catalog_doc (AsMetadata *metad,
 			}
 			header = FALSE;
 
+			/* drop documents of filtered kinds without building their components */
+			if (!header_found &&
+			    !as_metadata_component_kind_is_loaded (
+				priv->load_kinds,
+				as_metadata_yaml_doc_component_kind (root))) {
+				yaml_event_delete (&event);
+				continue;
+			}
+
 			if (!header_found) {
 				AsComponent *cpt = as_component_new ();
 				if (as_component_load_from_yaml (cpt, context, root, NULL)) {
@@ -412,13 +826,6 @@ as_metadata_yaml_parse_catalog_doc (AsMetadata *metad,
 					g_object_unref (cpt);
 				}
 			}
-
-			g_node_traverse (root,
-					 G_IN_ORDER,
-					 G_TRAVERSE_ALL,
-					 -1,
-					 as_yaml_free_node,
-					 NULL);
 		}
 
 		/* stop if end of stream is reached */
@@ -437,6 +844,166 @@ as_metadata_yaml_parse_catalog_doc (AsMetadata *metad,
 		return NULL;
 }
 
+/**
+ * as_metadata_yaml_parse_catalog_parallel:
+ *
+ * Parse a `---` separated DEP-11 catalog by handing its documents to
+ * worker threads and merging the resulting components in document order.
+ * The first document is parsed sequentially, so the DEP-11 header fields
+ * are applied to the shared #AsContext before any component is built.
+ */
+static GPtrArray *
+as_metadata_yaml_parse_catalog_parallel (AsMetadata *metad,
+					 AsContext *context,
+					 const gchar *data,
+					 gsize data_len,
+					 GArray *offsets,
+					 guint n_threads,
+					 GError **error)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_autoptr(GPtrArray) cpts = NULL;
+	g_autofree AsComponent **results = NULL;
+	g_autofree GError **errors = NULL;
+	g_autofree GThread **threads = NULL;
+	AsMetadataYamlParseHelper helper;
+	guint n_docs;
+	gboolean failed = FALSE;
+
+	/* parse the first document on this thread - it is usually the DEP-11 header */
+	cpts = as_metadata_yaml_parse_catalog_doc (metad,
+						   context,
+						   data,
+						   (gssize) g_array_index (offsets, gsize, 1),
+						   error);
+	if (cpts == NULL)
+		return NULL;
+
+	n_docs = offsets->len - 1;
+	results = g_new0 (AsComponent *, n_docs);
+	errors = g_new0 (GError *, n_docs);
+
+	helper.data = data;
+	helper.data_len = data_len;
+	helper.offsets = offsets;
+	helper.results = results;
+	helper.errors = errors;
+	helper.context = context;
+	helper.load_kinds = priv->load_kinds;
+	helper.next_index = 0;
+	helper.load_failed = FALSE;
+
+	/* the DEP-11 header has been applied to the context at this point, so
+	 * the workers can share the now-immutable context without locking */
+	as_context_seal (context);
+
+	threads = g_new0 (GThread *, n_threads);
+	for (guint i = 0; i < n_threads; i++)
+		threads[i] = g_thread_new ("yaml-parse",
+					   as_metadata_yaml_parse_docs_worker,
+					   &helper);
+	for (guint i = 0; i < n_threads; i++)
+		g_thread_join (threads[i]);
+
+	/* merge the results in document order, stopping at the first hard
+	 * parse error just like a sequential parse would */
+	for (guint i = 0; i < n_docs; i++) {
+		g_autoptr(AsComponent) cpt = g_steal_pointer (&results[i]);
+
+		if (failed) {
+			g_clear_error (&errors[i]);
+			continue;
+		}
+		if (errors[i] != NULL) {
+			g_propagate_error (error, g_steal_pointer (&errors[i]));
+			failed = TRUE;
+			continue;
+		}
+
+		if (cpt != NULL)
+			g_ptr_array_add (cpts, g_steal_pointer (&cpt));
+	}
+
+	if (failed || g_atomic_int_get (&helper.load_failed))
+		return NULL;
+
+	return g_steal_pointer (&cpts);
+}
+
+/**
+ * as_metadata_process_xml_document:
+ *
+ * Load AppStream metadata from an already parsed XML document.
+ * This takes ownership of @doc and frees it in the process.
+ **/
+static gboolean
+as_metadata_process_xml_document (AsMetadata *metad,
+				  xmlDoc *doc,
+				  const gchar *filename,
+				  GError **error)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	xmlNode *root = xmlDocGetRootElement (doc);
+
+	if (priv->mode == AS_FORMAT_STYLE_CATALOG) {
+		/* prepare context */
+		g_autoptr(AsContext) context = NULL;
+		context = as_metadata_new_context (metad, AS_FORMAT_STYLE_CATALOG, filename);
+
+		if (g_strcmp0 ((gchar *) root->name, "components") == 0) {
+			as_metadata_xml_parse_components_node (metad, context, root, error);
+		} else if (g_strcmp0 ((gchar *) root->name, "component") == 0) {
+			g_autoptr(AsComponent) cpt = as_component_new ();
+			/* we explicitly allow parsing single component entries in distro-XML mode, since this is a scenario
+			* which might very well happen, e.g. in AppStream metadata generators */
+			if (as_component_load_from_xml (cpt, context, root, error) &&
+			    as_metadata_component_kind_is_loaded (priv->load_kinds,
+								  as_component_get_kind (cpt)))
+				as_component_box_add (priv->cbox, cpt, NULL);
+		} else {
+			g_set_error_literal (error,
+					     AS_METADATA_ERROR,
+					     AS_METADATA_ERROR_FAILED,
+					     "XML file does not contain valid AppStream data!");
+			xmlFreeDoc (doc);
+			return FALSE;
+		}
+	} else {
+		g_autoptr(AsContext) context = NULL;
+		g_autoptr(AsComponent) cpt = NULL;
+
+		context = as_metadata_new_context (metad, AS_FORMAT_STYLE_METAINFO, filename);
+		if (priv->update_existing) {
+			/* we should update the existing component with new metadata */
+			cpt = as_metadata_get_component (metad);
+			if (cpt == NULL) {
+				g_set_error_literal (error,
+						     AS_METADATA_ERROR,
+						     AS_METADATA_ERROR_NO_COMPONENT,
+						     "No component found that could be updated.");
+				xmlFreeDoc (doc);
+				return FALSE;
+			} else {
+				cpt = g_object_ref (cpt);
+				as_component_load_from_xml (cpt, context, root, error);
+			}
+		} else {
+			cpt = as_component_new ();
+			if (as_component_load_from_xml (cpt, context, root, error) &&
+			    as_metadata_component_kind_is_loaded (priv->load_kinds,
+								  as_component_get_kind (cpt)))
+				as_component_box_add (priv->cbox, cpt, NULL);
+		}
+
+		if (cpt != NULL)
+			as_component_set_origin_kind (cpt, AS_ORIGIN_KIND_METAINFO);
+	}
+
+	/* free the XML document */
+	xmlFreeDoc (doc);
+	return TRUE;
+}
+
 /**
  * as_metadata_parse_raw:
  *
@@ -456,7 +1023,6 @@ as_metadata_parse_raw (AsMetadata *metad,
 
 	if (format == AS_FORMAT_KIND_XML) {
 		xmlDoc *doc;
-		xmlNode *root;
 
 		doc = as_xml_parse_document (data,
 					     data_len,
@@ -464,66 +1030,8 @@ as_metadata_parse_raw (AsMetadata *metad,
 					     error);
 		if (doc == NULL)
 			return FALSE;
-		root = xmlDocGetRootElement (doc);
-
-		if (priv->mode == AS_FORMAT_STYLE_CATALOG) {
-			/* prepare context */
-			g_autoptr(AsContext) context = NULL;
-			context = as_metadata_new_context (metad,
-							   AS_FORMAT_STYLE_CATALOG,
-							   filename);
-
-			if (g_strcmp0 ((gchar *) root->name, "components") == 0) {
-				as_metadata_xml_parse_components_node (metad, context, root, error);
-			} else if (g_strcmp0 ((gchar *) root->name, "component") == 0) {
-				g_autoptr(AsComponent) cpt = as_component_new ();
-				/* we explicitly allow parsing single component entries in distro-XML mode, since this is a scenario
-				* which might very well happen, e.g. in AppStream metadata generators */
-				if (as_component_load_from_xml (cpt, context, root, error))
-					as_component_box_add (priv->cbox, cpt, NULL);
-			} else {
-				g_set_error_literal (
-				    error,
-				    AS_METADATA_ERROR,
-				    AS_METADATA_ERROR_FAILED,
-				    "XML file does not contain valid AppStream data!");
-				return FALSE;
-			}
-		} else {
-			g_autoptr(AsContext) context = NULL;
-			g_autoptr(AsComponent) cpt = NULL;
-
-			context = as_metadata_new_context (metad,
-							   AS_FORMAT_STYLE_METAINFO,
-							   filename);
-			if (priv->update_existing) {
-				/* we should update the existing component with new metadata */
-				cpt = as_metadata_get_component (metad);
-				if (cpt == NULL) {
-					g_set_error_literal (
-					    error,
-					    AS_METADATA_ERROR,
-					    AS_METADATA_ERROR_NO_COMPONENT,
-					    "No component found that could be updated.");
-					xmlFreeDoc (doc);
-					return FALSE;
-				} else {
-					cpt = g_object_ref (cpt);
-					as_component_load_from_xml (cpt, context, root, error);
-				}
-			} else {
-				cpt = as_component_new ();
-				if (as_component_load_from_xml (cpt, context, root, error))
-					as_component_box_add (priv->cbox, cpt, NULL);
-			}
-
-			if (cpt != NULL)
-				as_component_set_origin_kind (cpt, AS_ORIGIN_KIND_METAINFO);
-		}
 
-		/* free the XML document */
-		xmlFreeDoc (doc);
-		return TRUE;
+		return as_metadata_process_xml_document (metad, doc, filename, error);
 	}
 
 	if (format == AS_FORMAT_KIND_YAML) {
@@ -674,6 +1182,11 @@ as_metadata_parse_desktop_data (AsMetadata *metad,
 		return ret;
 	}
 
+	/* desktop-entry files always yield desktop-applications, which may be excluded */
+	if (!as_metadata_component_kind_is_loaded (priv->load_kinds,
+						   as_component_get_kind (cpt)))
+		return TRUE;
+
 	/* ensure the right locale is set on the component's context */
 	as_component_set_context_locale (cpt, priv->locale);
 
@@ -745,6 +1258,36 @@ as_metadata_parse_file (AsMetadata *metad, GFile *file, AsFormatKind format, GEr
 			format = AS_FORMAT_KIND_DESKTOP_ENTRY;
 	}
 
+	/* Fast path: Uncompressed local files are memory-mapped and handed to the
+	 * parsers directly, so we do not copy the whole file into a heap buffer first.
+	 * This matters when parsing tens of thousands of metainfo files in one go. */
+	if (filename != NULL && !as_str_equal0 (content_type, "application/zstd") &&
+	    !as_str_equal0 (content_type, "application/gzip") &&
+	    !as_str_equal0 (content_type, "application/x-gzip")) {
+		g_autoptr(GMappedFile) mfile = g_mapped_file_new (filename, FALSE, NULL);
+		/* if mapping fails (e.g. an empty or special file), we fall back to streaming */
+		if (mfile != NULL && g_mapped_file_get_length (mfile) > 0) {
+			if (format == AS_FORMAT_KIND_DESKTOP_ENTRY)
+				as_metadata_parse_desktop_data (metad,
+								file_basename,
+								g_mapped_file_get_contents (mfile),
+								g_mapped_file_get_length (mfile),
+								&tmp_error);
+			else
+				as_metadata_parse_raw (metad,
+						       g_mapped_file_get_contents (mfile),
+						       g_mapped_file_get_length (mfile),
+						       format,
+						       filename,
+						       &tmp_error);
+			if (tmp_error != NULL) {
+				g_propagate_error (error, tmp_error);
+				return FALSE;
+			}
+			return TRUE;
+		}
+	}
+
 	file_stream = G_INPUT_STREAM (g_file_read (file, NULL, &tmp_error));
 	if (file_stream == NULL) {
 		g_propagate_error (error, tmp_error);
@@ -765,6 +1308,27 @@ as_metadata_parse_file (AsMetadata *metad, GFile *file, AsFormatKind format, GEr
 		stream_data = g_object_ref (file_stream);
 	}
 
+	/* XML data can be parsed incrementally with a push parser, so decompressed
+	 * chunks are handed to libxml2 as they arrive and we never assemble the
+	 * (potentially huge) decompressed catalog in an intermediate buffer. */
+	if (format == AS_FORMAT_KIND_XML) {
+		xmlDoc *doc;
+
+		doc = as_xml_parse_document_from_stream (stream_data,
+							 FALSE, /* pedantic */
+							 &tmp_error);
+		if (doc == NULL) {
+			g_propagate_error (error, tmp_error);
+			return FALSE;
+		}
+
+		if (!as_metadata_process_xml_document (metad, doc, filename, &tmp_error)) {
+			g_propagate_error (error, tmp_error);
+			return FALSE;
+		}
+		return TRUE;
+	}
+
 	/* Now read the whole file into memory to parse it.
 	 * On memory-contrained systems we could adjust the code later to allow parsing
 	 * a stream of data instead.
@@ -1165,64 +1729,396 @@ as_metadata_component_to_metainfo (AsMetadata *metad, AsFormatKind format, GErro
 	if (cpt == NULL)
 		return NULL;
 
-	node = as_component_to_xml_node (cpt, context, NULL);
+	node = as_component_to_xml_node (cpt, context, NULL, NULL);
 	xmlstr = as_xml_node_free_to_str (node, error);
 
 	return xmlstr;
 }
 
 /**
- * as_metadata_xml_serialize_to_catalog_with_rootnode:
+ * as_metadata_xml_append_escaped_attr:
  *
- * Returns: Valid catalog XML metadata.
+ * Append an XML attribute with a properly escaped value to the
+ * string of a hand-written element tag.
  */
-static gchar *
-as_metadata_xml_serialize_to_catalog_with_rootnode (AsMetadata *metad,
-						    AsContext *context,
-						    GPtrArray *cpts)
+static void
+as_metadata_xml_append_escaped_attr (GString *out, const gchar *name, const gchar *value)
 {
-	AsMetadataPrivate *priv = GET_PRIVATE (metad);
-	xmlNode *root;
-
-	root = as_xml_node_new ("components");
-	as_xml_add_text_prop (root, "version", as_format_version_to_string (priv->format_version));
-	if (priv->origin != NULL)
-		as_xml_add_text_prop (root, "origin", priv->origin);
-	if (priv->arch != NULL)
-		as_xml_add_text_prop (root, "architecture", priv->arch);
-	if (as_context_has_media_baseurl (context))
-		as_xml_add_text_prop (root,
-				      "media_baseurl",
-				      as_context_get_media_baseurl (context));
-
-	for (guint i = 0; i < cpts->len; i++) {
-		xmlNode *node;
-		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (cpts, i));
-
-		node = as_component_to_xml_node (cpt, context, NULL);
-		if (node == NULL)
-			continue;
-		xmlAddChild (root, node);
+	g_string_append_printf (out, " %s=\"", name);
+	for (const gchar *c = value; *c != '\0'; c++) {
+		switch (*c) {
+		case '&':
+			g_string_append (out, "&amp;");
+			break;
+		case '<':
+			g_string_append (out, "&lt;");
+			break;
+		case '>':
+			g_string_append (out, "&gt;");
+			break;
+		case '"':
+			g_string_append (out, "&quot;");
+			break;
+		default:
+			g_string_append_c (out, *c);
+		}
 	}
-
-	return as_xml_node_free_to_str (root, NULL);
+	g_string_append_c (out, '"');
 }
 
 /**
- * as_metadata_xml_serialize_to_catalog_without_rootnode:
+ * as_metadata_xml_append_node_indented:
  *
- * Returns: Catalog XML metadata slices without rootnode.
+ * Serialize a single component node and append it to the output string,
+ * indented by one level below the root element. The node is consumed.
+ */
+static void
+as_metadata_xml_append_node_indented (GString *out_data, xmlNode *node)
+{
+	xmlDoc *doc;
+	xmlNode *root;
+	xmlBufferPtr buf;
+	xmlSaveCtxtPtr sctx;
+	const gchar *content;
+	const gchar *inner_start;
+	const gchar *inner_end;
+
+	/* serialize under a throwaway root element, so libxml2 itself indents
+	 * the component at depth 1 - splicing indentation into the serialized
+	 * data ourselves would also inject spaces after newlines inside
+	 * multi-line text node content */
+	doc = xmlNewDoc ((xmlChar *) NULL);
+	as_xml_doc_inherit_dict (doc, node);
+	root = xmlNewDocNode (doc, NULL, (xmlChar *) "components", NULL);
+	xmlDocSetRootElement (doc, root);
+	xmlAddChild (root, node);
+
+	buf = xmlBufferCreate ();
+	sctx = xmlSaveToBuffer (buf, "utf-8", XML_SAVE_FORMAT | XML_SAVE_NO_DECL);
+	xmlSaveDoc (sctx, doc);
+	xmlSaveClose (sctx);
+
+	/* strip the wrapper element lines, keeping only the indented component;
+	 * a literal "</components>" can not occur in the body, as the serializer
+	 * escapes all angle brackets in text and attribute content */
+	content = (const gchar *) xmlBufferContent (buf);
+	inner_start = strstr (content, "\n");
+	inner_end = g_strrstr (content, "</components>");
+	if (inner_start != NULL && inner_end != NULL && inner_start < inner_end)
+		g_string_append_len (out_data, inner_start + 1, inner_end - (inner_start + 1));
+
+	xmlBufferFree (buf);
+	xmlFreeDoc (doc);
+}
+
+/**
+ * as_metadata_write_gstring_cb:
+ *
+ * #AsDataWriteFn appending all chunks to a #GString, to build the
+ * string-returning serialization functions on top of the streaming ones.
+ */
+static gboolean
+as_metadata_write_gstring_cb (const gchar *data, gsize data_len, gpointer user_data)
+{
+	g_string_append_len ((GString *) user_data, data, data_len);
+	return TRUE;
+}
+
+/**
+ * as_metadata_checksum_update_canonical:
+ *
+ * Feed serialized XML data into @cksum in canonical form: any run of
+ * whitespace is collapsed into a single space, so the resulting digest does
+ * not depend on indentation or line breaks introduced by pretty-printing.
+ * Attribute order is already stable, since our serializer always emits
+ * attributes in a fixed order.
+ */
+static void
+as_metadata_checksum_update_canonical (GChecksum *cksum, const gchar *data, gsize data_len)
+{
+	const gchar *end = data + data_len;
+	const gchar *start = data;
+	const gchar *p = data;
+
+	while (p < end) {
+		if (g_ascii_isspace (*p)) {
+			if (p > start)
+				g_checksum_update (cksum, (const guchar *) start, p - start);
+			g_checksum_update (cksum, (const guchar *) " ", 1);
+			do {
+				p++;
+			} while (p < end && g_ascii_isspace (*p));
+			start = p;
+		} else {
+			p++;
+		}
+	}
+	if (p > start)
+		g_checksum_update (cksum, (const guchar *) start, p - start);
+}
+
+/**
+ * as_metadata_checksum_add_component:
+ *
+ * Record the canonical digest of one serialized component and fold the same
+ * data into the catalog-wide checksum, if one is being computed.
+ */
+static void
+as_metadata_checksum_add_component (AsMetadata *metad,
+				    GChecksum *catalog_cksum,
+				    AsComponent *cpt,
+				    const gchar *data,
+				    gsize data_len)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_autoptr(GChecksum) cpt_cksum = NULL;
+
+	cpt_cksum = g_checksum_new (G_CHECKSUM_SHA256);
+	as_metadata_checksum_update_canonical (cpt_cksum, data, data_len);
+	g_hash_table_insert (priv->cpt_checksums,
+			     g_strdup (as_component_get_id (cpt)),
+			     g_strdup (g_checksum_get_string (cpt_cksum)));
+
+	if (catalog_cksum != NULL)
+		as_metadata_checksum_update_canonical (catalog_cksum, data, data_len);
+}
+
+/**
+ * as_metadata_xml_build_catalog_header:
+ *
+ * Build the hand-written catalog XML document header, consisting of the
+ * XML declaration and the opening `components` root element with all
+ * its attributes, into @chunk.
+ */
+static void
+as_metadata_xml_build_catalog_header (AsMetadata *metad, AsContext *context, GString *chunk)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+
+	g_string_append (chunk, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n");
+	g_string_append (chunk, "<components");
+	as_metadata_xml_append_escaped_attr (chunk,
+					     "version",
+					     as_format_version_to_string (priv->format_version));
+	if (priv->origin != NULL)
+		as_metadata_xml_append_escaped_attr (chunk, "origin", priv->origin);
+	if (priv->arch != NULL)
+		as_metadata_xml_append_escaped_attr (chunk, "architecture", priv->arch);
+	if (as_context_has_media_baseurl (context))
+		as_metadata_xml_append_escaped_attr (chunk,
+						     "media_baseurl",
+						     as_context_get_media_baseurl (context));
+	g_string_append (chunk, ">\n");
+}
+
+/**
+ * as_metadata_xml_stream_catalog_cpts:
+ *
+ * Serialize @cpts as indented catalog-XML component chunks, handing each
+ * chunk to @write_fn individually. This emits only the component elements,
+ * without any document framing.
+ *
+ * Returns: %FALSE if @write_fn aborted the serialization.
+ */
+static gboolean
+as_metadata_xml_stream_catalog_cpts (AsMetadata *metad,
+				     AsContext *context,
+				     GPtrArray *cpts,
+				     GChecksum *catalog_cksum,
+				     AsDataWriteFn write_fn,
+				     gpointer user_data)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_autoptr(GString) chunk = g_string_new (NULL);
+	xmlDoc *ser_doc;
+	gboolean ret = TRUE;
+
+	/* share one string dictionary for constant names across the whole catalog write */
+	ser_doc = as_xml_serialization_doc_new ();
+	for (guint i = 0; i < cpts->len; i++) {
+		xmlNode *node;
+		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (cpts, i));
+
+		node = as_component_to_xml_node (cpt, context, ser_doc, NULL);
+		if (node == NULL)
+			continue;
+		g_string_truncate (chunk, 0);
+		as_metadata_xml_append_node_indented (chunk, node);
+		if (priv->compute_checksums)
+			as_metadata_checksum_add_component (metad,
+							    catalog_cksum,
+							    cpt,
+							    chunk->str,
+							    chunk->len);
+		if (!write_fn (chunk->str, chunk->len, user_data)) {
+			ret = FALSE;
+			break;
+		}
+	}
+	xmlFreeDoc (ser_doc);
+
+	return ret;
+}
+
+/**
+ * as_metadata_xml_stream_to_catalog_with_rootnode:
+ *
+ * Emit catalog XML as a stream: The root element is written by hand and each
+ * component is serialized, handed to @write_fn and released individually, so
+ * we never hold more than roughly one serialized component in memory.
+ *
+ * Returns: %FALSE if @write_fn aborted the serialization.
+ */
+static gboolean
+as_metadata_xml_stream_to_catalog_with_rootnode (AsMetadata *metad,
+						 AsContext *context,
+						 GPtrArray *cpts,
+						 AsDataWriteFn write_fn,
+						 gpointer user_data)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_autoptr(GString) chunk = g_string_new (NULL);
+	g_autoptr(GChecksum) catalog_cksum = NULL;
+
+	if (priv->compute_checksums) {
+		g_hash_table_remove_all (priv->cpt_checksums);
+		catalog_cksum = g_checksum_new (G_CHECKSUM_SHA256);
+	}
+
+	as_metadata_xml_build_catalog_header (metad, context, chunk);
+	if (catalog_cksum != NULL)
+		as_metadata_checksum_update_canonical (catalog_cksum, chunk->str, chunk->len);
+	if (!write_fn (chunk->str, chunk->len, user_data))
+		return FALSE;
+
+	if (!as_metadata_xml_stream_catalog_cpts (metad,
+						  context,
+						  cpts,
+						  catalog_cksum,
+						  write_fn,
+						  user_data))
+		return FALSE;
+
+	if (catalog_cksum != NULL) {
+		as_metadata_checksum_update_canonical (catalog_cksum,
+						       "</components>\n",
+						       strlen ("</components>\n"));
+		g_free (priv->catalog_checksum);
+		priv->catalog_checksum = g_strdup (g_checksum_get_string (catalog_cksum));
+	}
+
+	return write_fn ("</components>\n", strlen ("</components>\n"), user_data);
+}
+
+/**
+ * as_metadata_xml_serialize_to_catalog_with_rootnode:
+ *
+ * Returns: Valid catalog XML metadata.
  */
 static gchar *
-as_metadata_xml_serialize_to_catalog_without_rootnode (AsMetadata *metad,
-						       AsContext *context,
-						       GPtrArray *cpts)
+as_metadata_xml_serialize_to_catalog_with_rootnode (AsMetadata *metad,
+						    AsContext *context,
+						    GPtrArray *cpts)
 {
-	guint i;
+	GString *out_data = g_string_new ("");
+	as_metadata_xml_stream_to_catalog_with_rootnode (metad,
+							 context,
+							 cpts,
+							 as_metadata_write_gstring_cb,
+							 out_data);
+	return g_string_free (out_data, FALSE);
+}
+
+/**
+ * as_metadata_xml_serialize_to_catalog_delta:
+ *
+ * Emit a delta catalog XML document, containing only the changed components
+ * as well as removal markers, to be applied on top of a base catalog.
+ *
+ * Returns: Valid delta catalog XML metadata.
+ */
+static gchar *
+as_metadata_xml_serialize_to_catalog_delta (AsMetadata *metad,
+					    AsContext *context,
+					    GPtrArray *cpts,
+					    const gchar *base_checksum,
+					    GPtrArray *removed_ids)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
 	GString *out_data;
+	xmlDoc *ser_doc;
+
+	out_data = g_string_new ("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n");
+	g_string_append (out_data, "<components");
+	as_metadata_xml_append_escaped_attr (out_data, "type", "delta");
+	as_metadata_xml_append_escaped_attr (out_data,
+					     "version",
+					     as_format_version_to_string (priv->format_version));
+	as_metadata_xml_append_escaped_attr (out_data, "base_checksum", base_checksum);
+	if (priv->origin != NULL)
+		as_metadata_xml_append_escaped_attr (out_data, "origin", priv->origin);
+	if (priv->arch != NULL)
+		as_metadata_xml_append_escaped_attr (out_data, "architecture", priv->arch);
+	if (as_context_has_media_baseurl (context))
+		as_metadata_xml_append_escaped_attr (out_data,
+						     "media_baseurl",
+						     as_context_get_media_baseurl (context));
+	g_string_append (out_data, ">\n");
+
+	/* share one string dictionary for constant names across the whole catalog write */
+	ser_doc = as_xml_serialization_doc_new ();
+	for (guint i = 0; i < cpts->len; i++) {
+		xmlNode *node;
+		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (cpts, i));
+
+		node = as_component_to_xml_node (cpt, context, ser_doc, NULL);
+		if (node == NULL)
+			continue;
+		as_metadata_xml_append_node_indented (out_data, node);
+	}
+	xmlFreeDoc (ser_doc);
+
+	if (removed_ids != NULL) {
+		for (guint i = 0; i < removed_ids->len; i++) {
+			const gchar *cid = (const gchar *) g_ptr_array_index (removed_ids, i);
+			g_string_append (out_data, "  <removed");
+			as_metadata_xml_append_escaped_attr (out_data, "id", cid);
+			g_string_append (out_data, "/>\n");
+		}
+	}
+
+	g_string_append (out_data, "</components>\n");
+	return g_string_free (out_data, FALSE);
+}
+
+/**
+ * as_metadata_xml_stream_to_catalog_without_rootnode:
+ *
+ * Emit catalog XML metadata slices without rootnode, handing each
+ * serialized component to @write_fn individually.
+ *
+ * Returns: %FALSE if @write_fn aborted the serialization.
+ */
+static gboolean
+as_metadata_xml_stream_to_catalog_without_rootnode (AsMetadata *metad,
+						    AsContext *context,
+						    GPtrArray *cpts,
+						    AsDataWriteFn write_fn,
+						    gpointer user_data)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_autoptr(GChecksum) catalog_cksum = NULL;
+	guint i;
+	xmlDoc *ser_doc;
+	gboolean ret = TRUE;
 
-	out_data = g_string_new ("");
+	if (priv->compute_checksums) {
+		g_hash_table_remove_all (priv->cpt_checksums);
+		catalog_cksum = g_checksum_new (G_CHECKSUM_SHA256);
+	}
 
+	/* share one string dictionary for constant names across the whole catalog write */
+	ser_doc = as_xml_serialization_doc_new ();
 	for (i = 0; i < cpts->len; i++) {
 		AsComponent *cpt;
 		xmlDoc *doc;
@@ -1231,11 +2127,12 @@ as_metadata_xml_serialize_to_catalog_without_rootnode (AsMetadata *metad,
 		xmlSaveCtxtPtr sctx;
 		cpt = AS_COMPONENT (g_ptr_array_index (cpts, i));
 
-		node = as_component_to_xml_node (cpt, context, NULL);
+		node = as_component_to_xml_node (cpt, context, ser_doc, NULL);
 		if (node == NULL)
 			continue;
 
 		doc = xmlNewDoc ((xmlChar *) NULL);
+		as_xml_doc_inherit_dict (doc, node);
 		xmlDocSetRootElement (doc, node);
 
 		buf = xmlBufferCreate ();
@@ -1243,11 +2140,46 @@ as_metadata_xml_serialize_to_catalog_without_rootnode (AsMetadata *metad,
 		xmlSaveDoc (sctx, doc);
 		xmlSaveClose (sctx);
 
-		g_string_append (out_data, (const gchar *) xmlBufferContent (buf));
+		if (priv->compute_checksums)
+			as_metadata_checksum_add_component (metad,
+							    catalog_cksum,
+							    cpt,
+							    (const gchar *) xmlBufferContent (buf),
+							    xmlBufferLength (buf));
+		ret = write_fn ((const gchar *) xmlBufferContent (buf),
+				xmlBufferLength (buf),
+				user_data);
 		xmlBufferFree (buf);
 		xmlFreeDoc (doc);
+		if (!ret)
+			break;
+	}
+	xmlFreeDoc (ser_doc);
+
+	if (ret && catalog_cksum != NULL) {
+		g_free (priv->catalog_checksum);
+		priv->catalog_checksum = g_strdup (g_checksum_get_string (catalog_cksum));
 	}
 
+	return ret;
+}
+
+/**
+ * as_metadata_xml_serialize_to_catalog_without_rootnode:
+ *
+ * Returns: Catalog XML metadata slices without rootnode.
+ */
+static gchar *
+as_metadata_xml_serialize_to_catalog_without_rootnode (AsMetadata *metad,
+						       AsContext *context,
+						       GPtrArray *cpts)
+{
+	GString *out_data = g_string_new ("");
+	as_metadata_xml_stream_to_catalog_without_rootnode (metad,
+							    context,
+							    cpts,
+							    as_metadata_write_gstring_cb,
+							    out_data);
 	return g_string_free (out_data, FALSE);
 }
 
@@ -1292,48 +2224,62 @@ as_yamldata_write_header (AsContext *context, yaml_emitter_t *emitter)
 }
 
 /**
- * as_yamldata_write_handler:
+ * AsYamlStreamHelper:
  *
- * Helper function to store the emitted YAML document.
+ * Bridges the libyaml emitter output to an #AsDataWriteFn.
+ */
+typedef struct {
+	AsDataWriteFn write_fn;
+	gpointer user_data;
+	gboolean write_failed;
+} AsYamlStreamHelper;
+
+/**
+ * as_yamldata_write_fn_handler:
+ *
+ * Helper function to forward emitted YAML data to a write callback.
  */
 static int
-as_yamldata_write_handler (void *ptr, unsigned char *buffer, size_t size)
+as_yamldata_write_fn_handler (void *ptr, unsigned char *buffer, size_t size)
 {
-	GString *str;
-	str = (GString *) ptr;
-	g_string_append_len (str, (const gchar *) buffer, size);
+	AsYamlStreamHelper *helper = (AsYamlStreamHelper *) ptr;
 
+	if (!helper->write_fn ((const gchar *) buffer, size, helper->user_data)) {
+		helper->write_failed = TRUE;
+		return 0;
+	}
 	return 1;
 }
 
 /**
- * as_metadata_yaml_serialize_to_catalog:
+ * as_metadata_yaml_stream_to_catalog:
+ *
+ * Emit catalog YAML, handing the output to @write_fn in chunks as the
+ * emitter produces it instead of accumulating the complete document.
  */
-static gchar *
-as_metadata_yaml_serialize_to_catalog (AsMetadata *metad,
-				       AsContext *context,
-				       GPtrArray *cpts,
-				       gboolean write_header,
-				       gboolean add_timestamp,
-				       GError **error)
+static gboolean
+as_metadata_yaml_stream_to_catalog (AsMetadata *metad,
+				    AsContext *context,
+				    GPtrArray *cpts,
+				    gboolean write_header,
+				    AsDataWriteFn write_fn,
+				    gpointer user_data,
+				    GError **error)
 {
 	yaml_emitter_t emitter;
 	yaml_event_t event;
-	GString *out_data;
+	AsYamlStreamHelper helper = { write_fn, user_data, FALSE };
 	gboolean res = FALSE;
 	guint i;
 
 	if (cpts->len == 0)
-		return NULL;
+		return TRUE;
 
 	yaml_emitter_initialize (&emitter);
 	yaml_emitter_set_indent (&emitter, 2);
 	yaml_emitter_set_unicode (&emitter, TRUE);
 	yaml_emitter_set_width (&emitter, 120);
-
-	/* create a GString to receive the output the emitter generates */
-	out_data = g_string_new ("");
-	yaml_emitter_set_output (&emitter, as_yamldata_write_handler, out_data);
+	yaml_emitter_set_output (&emitter, as_yamldata_write_fn_handler, &helper);
 
 	/* emit start event */
 	yaml_stream_start_event_initialize (&event, YAML_UTF8_ENCODING);
@@ -1352,29 +2298,65 @@ as_metadata_yaml_serialize_to_catalog (AsMetadata *metad,
 
 	/* emit end event */
 	yaml_stream_end_event_initialize (&event);
-	res = yaml_emitter_emit (&emitter, &event);
-	g_assert (res);
+	if (!yaml_emitter_emit (&emitter, &event))
+		goto error;
 
 	res = TRUE;
 	goto out;
 
 error:
-	g_set_error_literal (error,
-			     AS_METADATA_ERROR,
-			     AS_METADATA_ERROR_FAILED,
-			     "Emission of YAML event failed.");
+	if (helper.write_failed)
+		g_set_error_literal (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_FAILED,
+				     "Failed to write serialized YAML data.");
+	else
+		g_set_error_literal (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_FAILED,
+				     "Emission of YAML event failed.");
 
 out:
 	yaml_emitter_flush (&emitter);
 	/* destroy the Emitter object */
 	yaml_emitter_delete (&emitter);
 
-	if (res) {
-		return g_string_free (out_data, FALSE);
-	} else {
+	return res;
+}
+
+/**
+ * as_metadata_yaml_serialize_to_catalog:
+ */
+static gchar *
+as_metadata_yaml_serialize_to_catalog (AsMetadata *metad,
+				       AsContext *context,
+				       GPtrArray *cpts,
+				       gboolean write_header,
+				       gboolean add_timestamp,
+				       GError **error)
+{
+	GString *out_data;
+
+	if (cpts->len == 0)
+		return NULL;
+
+	/* create a GString to receive the output the emitter generates.
+	 * A serialized catalog component is a few KiB, so size the buffer for
+	 * the whole catalog upfront instead of repeatedly growing (and thereby
+	 * copying) a multi-megabyte result on large exports. */
+	out_data = g_string_sized_new (cpts->len * 2048);
+	if (!as_metadata_yaml_stream_to_catalog (metad,
+						 context,
+						 cpts,
+						 write_header,
+						 as_metadata_write_gstring_cb,
+						 out_data,
+						 error)) {
 		g_string_free (out_data, TRUE);
 		return NULL;
 	}
+
+	return g_string_free (out_data, FALSE);
 }
 
 /**
@@ -1431,6 +2413,409 @@ as_metadata_components_to_catalog (AsMetadata *metad, AsFormatKind format, GErro
 	}
 }
 
+/**
+ * as_metadata_components_to_catalog_stream:
+ * @metad: An instance of #AsMetadata.
+ * @format: The format to serialize the data to (XML or YAML).
+ * @write_fn: (scope call): callback receiving the serialized data in chunks.
+ * @user_data: (closure): data to pass to @write_fn.
+ * @error: A #GError
+ *
+ * Serialize all #AsComponent instances into AppStream catalog metadata,
+ * handing the result to @write_fn in chunks of roughly one component each.
+ * Unlike as_metadata_components_to_catalog(), this never builds the complete
+ * document in memory, so it is suitable for writing very large catalogs
+ * directly to a file or socket.
+ *
+ * Returns: %TRUE if the data was serialized and written completely.
+ *
+ * Since: 1.0.5
+ */
+gboolean
+as_metadata_components_to_catalog_stream (AsMetadata *metad,
+					  AsFormatKind format,
+					  AsDataWriteFn write_fn,
+					  gpointer user_data,
+					  GError **error)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_autoptr(AsContext) context = NULL;
+	gboolean ret;
+
+	g_return_val_if_fail (format > AS_FORMAT_KIND_UNKNOWN && format < AS_FORMAT_KIND_LAST,
+			      FALSE);
+	g_return_val_if_fail (write_fn != NULL, FALSE);
+
+	if (as_component_box_is_empty (priv->cbox))
+		return TRUE;
+
+	context = as_metadata_new_context (metad, AS_FORMAT_STYLE_CATALOG, NULL);
+
+	if (format == AS_FORMAT_KIND_XML) {
+		if (priv->write_header)
+			ret = as_metadata_xml_stream_to_catalog_with_rootnode (
+			    metad,
+			    context,
+			    as_component_box_as_array (priv->cbox),
+			    write_fn,
+			    user_data);
+		else
+			ret = as_metadata_xml_stream_to_catalog_without_rootnode (
+			    metad,
+			    context,
+			    as_component_box_as_array (priv->cbox),
+			    write_fn,
+			    user_data);
+		if (!ret)
+			g_set_error_literal (error,
+					     AS_METADATA_ERROR,
+					     AS_METADATA_ERROR_FAILED,
+					     "Failed to write serialized XML data.");
+		return ret;
+	} else if (format == AS_FORMAT_KIND_YAML) {
+		return as_metadata_yaml_stream_to_catalog (metad,
+							   context,
+							   as_component_box_as_array (priv->cbox),
+							   priv->write_header,
+							   write_fn,
+							   user_data,
+							   error);
+	} else {
+		g_set_error (error,
+			     AS_METADATA_ERROR,
+			     AS_METADATA_ERROR_FAILED,
+			     "Unknown metadata format (%i).",
+			     format);
+		return FALSE;
+	}
+}
+
+/**
+ * as_metadata_xml_write_catalog_header:
+ *
+ * Emit only the catalog XML document header - the XML declaration and the
+ * opening `components` root element - to @write_fn. Combined with
+ * as_metadata_xml_write_catalog_components() and
+ * as_metadata_xml_write_catalog_footer(), this allows assembling a catalog
+ * document from pre-serialized component fragments.
+ *
+ * Returns: %FALSE if @write_fn aborted the write.
+ */
+gboolean
+as_metadata_xml_write_catalog_header (AsMetadata *metad, AsDataWriteFn write_fn, gpointer user_data)
+{
+	g_autoptr(AsContext) context = NULL;
+	g_autoptr(GString) chunk = g_string_new (NULL);
+
+	context = as_metadata_new_context (metad, AS_FORMAT_STYLE_CATALOG, NULL);
+	as_metadata_xml_build_catalog_header (metad, context, chunk);
+	return write_fn (chunk->str, chunk->len, user_data);
+}
+
+/**
+ * as_metadata_xml_write_catalog_components:
+ *
+ * Serialize all parsed components as indented catalog XML component
+ * fragments without any document framing, handing each serialized
+ * component to @write_fn individually.
+ *
+ * Returns: %FALSE if @write_fn aborted the serialization.
+ */
+gboolean
+as_metadata_xml_write_catalog_components (AsMetadata *metad,
+					  AsDataWriteFn write_fn,
+					  gpointer user_data)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_autoptr(AsContext) context = NULL;
+
+	if (as_component_box_is_empty (priv->cbox))
+		return TRUE;
+
+	context = as_metadata_new_context (metad, AS_FORMAT_STYLE_CATALOG, NULL);
+	return as_metadata_xml_stream_catalog_cpts (metad,
+						    context,
+						    as_component_box_as_array (priv->cbox),
+						    NULL,
+						    write_fn,
+						    user_data);
+}
+
+/**
+ * as_metadata_xml_write_catalog_footer:
+ *
+ * Emit the closing root element of a catalog XML document to @write_fn.
+ *
+ * Returns: %FALSE if @write_fn aborted the write.
+ */
+gboolean
+as_metadata_xml_write_catalog_footer (AsMetadata *metad, AsDataWriteFn write_fn, gpointer user_data)
+{
+	return write_fn ("</components>\n", strlen ("</components>\n"), user_data);
+}
+
+/**
+ * as_metadata_save_catalog_sharded:
+ * @metad: An instance of #AsMetadata.
+ * @manifest_fname: The filename of the shard index manifest, must end with `.shards.xml`.
+ * @format: The format to save the shard data in (XML or YAML).
+ * @n_shards: Amount of shards to split the catalog into.
+ * @error: A #GError
+ *
+ * Serialize all #AsComponent instances into multiple catalog metadata
+ * shards, splitting components between shards by a hash of their ID,
+ * and write an index manifest referencing all shard files.
+ * Since a component always lands in the same shard as long as the shard
+ * count is unchanged, clients which mirror the catalog only need to
+ * re-fetch the shards that actually changed, instead of one monolithic
+ * catalog file on every change.
+ *
+ * The shard files are written next to the manifest, as gzip-compressed
+ * catalog files which can also be parsed individually, and #AsPool will
+ * load all shards referenced by a manifest it encounters.
+ *
+ * Returns: %TRUE if the manifest and all shards were written without error.
+ *
+ * Since: 1.0.5
+ */
+gboolean
+as_metadata_save_catalog_sharded (AsMetadata *metad,
+				  const gchar *manifest_fname,
+				  AsFormatKind format,
+				  guint n_shards,
+				  GError **error)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_autoptr(AsContext) context = NULL;
+	g_autofree gchar *base_fname = NULL;
+	g_autofree gchar *manifest_data = NULL;
+	g_autofree GPtrArray **shards = NULL;
+	xmlNode *mroot;
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail (manifest_fname != NULL, FALSE);
+	g_return_val_if_fail (n_shards > 0, FALSE);
+	g_return_val_if_fail (format == AS_FORMAT_KIND_XML || format == AS_FORMAT_KIND_YAML,
+			      FALSE);
+
+	if (!g_str_has_suffix (manifest_fname, ".shards.xml")) {
+		g_set_error (error,
+			     AS_METADATA_ERROR,
+			     AS_METADATA_ERROR_FAILED,
+			     "Shard manifest filename '%s' does not end with '.shards.xml'.",
+			     manifest_fname);
+		return FALSE;
+	}
+	base_fname = g_strndup (manifest_fname,
+				strlen (manifest_fname) - strlen (".shards.xml"));
+
+	/* partition components between the shards by their ID hash, so a component
+	 * stays in "its" shard across regenerations of the catalog */
+	shards = g_new0 (GPtrArray *, n_shards);
+	for (guint i = 0; i < n_shards; i++)
+		shards[i] = g_ptr_array_new ();
+	for (guint i = 0; i < as_component_box_len (priv->cbox); i++) {
+		AsComponent *cpt = as_component_box_index (priv->cbox, i);
+		const gchar *cid = as_component_get_id (cpt);
+		guint shard_idx = g_str_hash (cid ? cid : "") % n_shards;
+		g_ptr_array_add (shards[shard_idx], cpt);
+	}
+
+	context = as_metadata_new_context (metad, AS_FORMAT_STYLE_CATALOG, NULL);
+
+	mroot = as_xml_node_new ("shards");
+	as_xml_add_text_prop (mroot, "version", "1.0");
+	if (priv->origin != NULL)
+		as_xml_add_text_prop (mroot, "origin", priv->origin);
+
+	for (guint i = 0; i < n_shards; i++) {
+		g_autofree gchar *shard_fname = NULL;
+		g_autofree gchar *shard_base = NULL;
+		g_autofree gchar *data = NULL;
+		xmlNode *snode;
+
+		/* empty shards are neither written nor listed in the manifest */
+		if (shards[i]->len == 0)
+			continue;
+
+		shard_fname = g_strdup_printf ("%s-shard%02u.%s.gz",
+					       base_fname,
+					       i,
+					       format == AS_FORMAT_KIND_YAML ? "yml" : "xml");
+
+		if (format == AS_FORMAT_KIND_XML)
+			data = as_metadata_xml_serialize_to_catalog_with_rootnode (metad,
+										   context,
+										   shards[i]);
+		else
+			data = as_metadata_yaml_serialize_to_catalog (metad,
+								      context,
+								      shards[i],
+								      TRUE, /* write header */
+								      TRUE, /* add timestamp */
+								      error);
+		if (data == NULL || !as_metadata_save_data (metad, shard_fname, data, error)) {
+			ret = FALSE;
+			break;
+		}
+
+		shard_base = g_path_get_basename (shard_fname);
+		snode = as_xml_add_text_node (mroot, "shard", shard_base);
+		as_xml_add_uint_prop (snode, "components", shards[i]->len);
+	}
+
+	for (guint i = 0; i < n_shards; i++)
+		g_ptr_array_unref (shards[i]);
+	if (!ret) {
+		xmlFreeNode (mroot);
+		return FALSE;
+	}
+
+	manifest_data = as_xml_node_free_to_str (mroot, error);
+	if (manifest_data == NULL)
+		return FALSE;
+	return as_metadata_save_data (metad, manifest_fname, manifest_data, error);
+}
+
+/**
+ * as_metadata_components_to_catalog_delta:
+ * @metad: An instance of #AsMetadata.
+ * @base_checksum: SHA-256 checksum of the base catalog file the delta applies to.
+ * @removed_ids: (nullable) (element-type utf8): Component-IDs removed since the base catalog, or %NULL.
+ *
+ * Serialize all #AsComponent instances into a delta catalog document,
+ * which only contains the components that changed since a base catalog
+ * was published, as well as removal markers for components that vanished.
+ * Delta catalogs can be applied on top of their base catalog and are much
+ * smaller to transfer when only few components changed.
+ *
+ * This data is only available in the XML format.
+ *
+ * Returns: (transfer full): A string containing the delta XML data. Free with g_free()
+ *
+ * Since: 1.0.5
+ */
+gchar *
+as_metadata_components_to_catalog_delta (AsMetadata *metad,
+					 const gchar *base_checksum,
+					 GPtrArray *removed_ids)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_autoptr(AsContext) context = NULL;
+	g_return_val_if_fail (base_checksum != NULL, NULL);
+
+	context = as_metadata_new_context (metad, AS_FORMAT_STYLE_CATALOG, NULL);
+	return as_metadata_xml_serialize_to_catalog_delta (metad,
+							   context,
+							   as_component_box_as_array (priv->cbox),
+							   base_checksum,
+							   removed_ids);
+}
+
+/**
+ * as_metadata_add_delta_base_checksum:
+ * @metad: An instance of #AsMetadata.
+ * @checksum: SHA-256 checksum of a loaded base catalog file.
+ *
+ * Register the checksum of a base catalog file that was (or will be) parsed
+ * by this #AsMetadata instance. Once at least one base checksum is registered,
+ * delta catalog documents are only applied if they were created for one of
+ * the registered base catalogs, and parsing them fails otherwise.
+ *
+ * Since: 1.0.5
+ */
+void
+as_metadata_add_delta_base_checksum (AsMetadata *metad, const gchar *checksum)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_return_if_fail (checksum != NULL);
+
+	if (as_ptr_array_find_string (priv->delta_bases, checksum) != NULL)
+		return;
+	g_ptr_array_add (priv->delta_bases, g_strdup (checksum));
+}
+
+/**
+ * as_metadata_set_compute_checksums:
+ * @metad: An instance of #AsMetadata.
+ * @compute: %TRUE to compute canonical checksums.
+ *
+ * If set to %TRUE, catalog XML serialization will additionally compute a
+ * SHA-256 checksum over the canonical form of the emitted data, for the
+ * document as a whole as well as for each individual component.
+ * The canonical form has all whitespace runs collapsed and a stable
+ * attribute order, so the digests only change when actual content changes,
+ * not when the pretty-printing does. The checksums are computed on the fly
+ * while the data is being written out, so no second serialization or parse
+ * pass is needed to compare two catalogs.
+ *
+ * Since: 1.0.5
+ */
+void
+as_metadata_set_compute_checksums (AsMetadata *metad, gboolean compute)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	priv->compute_checksums = compute;
+}
+
+/**
+ * as_metadata_get_compute_checksums:
+ * @metad: An instance of #AsMetadata.
+ *
+ * Returns: %TRUE if canonical checksums are computed during serialization.
+ *
+ * Since: 1.0.5
+ */
+gboolean
+as_metadata_get_compute_checksums (AsMetadata *metad)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	return priv->compute_checksums;
+}
+
+/**
+ * as_metadata_get_catalog_checksum:
+ * @metad: An instance of #AsMetadata.
+ *
+ * Get the canonical SHA-256 checksum of the catalog XML document that was
+ * last serialized by this #AsMetadata instance. Checksum computation must
+ * have been enabled via as_metadata_set_compute_checksums() before the
+ * serialization happened.
+ *
+ * Returns: (nullable): Hex digest of the last written catalog, or %NULL.
+ *
+ * Since: 1.0.5
+ */
+const gchar *
+as_metadata_get_catalog_checksum (AsMetadata *metad)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	return priv->catalog_checksum;
+}
+
+/**
+ * as_metadata_get_component_checksum:
+ * @metad: An instance of #AsMetadata.
+ * @cid: AppStream ID of a serialized component.
+ *
+ * Get the canonical SHA-256 checksum of the serialized form of one
+ * component from the catalog XML document that was last written by this
+ * #AsMetadata instance. The per-component digests are independent of the
+ * surrounding document, so they can be compared across catalog writes to
+ * find the components that actually changed.
+ *
+ * Returns: (nullable): Hex digest for the component, or %NULL if unknown.
+ *
+ * Since: 1.0.5
+ */
+const gchar *
+as_metadata_get_component_checksum (AsMetadata *metad, const gchar *cid)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_return_val_if_fail (cid != NULL, NULL);
+	return g_hash_table_lookup (priv->cpt_checksums, cid);
+}
+
 /**
  * as_metadata_add_component:
  *
@@ -1745,6 +3130,79 @@ as_metadata_set_parse_flags (AsMetadata *metad, AsParseFlags flags)
 	priv->parse_flags = flags;
 }
 
+/**
+ * as_metadata_add_load_kind:
+ * @metad: a #AsMetadata instance.
+ * @kind: the #AsComponentKind to add to the load-kind filter.
+ *
+ * Restrict parsing to components of the selected kinds.
+ * By default all components are loaded, but once one or more kinds
+ * have been added to the load-kind filter, components of any other
+ * kind are discarded while parsing. Catalog data entries of excluded
+ * kinds are skipped before their components are constructed, so
+ * filtered data costs neither time nor memory.
+ *
+ * Since: 1.0.5
+ **/
+void
+as_metadata_add_load_kind (AsMetadata *metad, AsComponentKind kind)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	g_return_if_fail (kind > AS_COMPONENT_KIND_UNKNOWN && kind < AS_COMPONENT_KIND_LAST);
+	priv->load_kinds |= 1U << kind;
+}
+
+/**
+ * as_metadata_reset_load_kinds:
+ * @metad: a #AsMetadata instance.
+ *
+ * Reset the load-kind filter, so components of
+ * all kinds are parsed again.
+ *
+ * Since: 1.0.5
+ **/
+void
+as_metadata_reset_load_kinds (AsMetadata *metad)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	priv->load_kinds = 0;
+}
+
+/**
+ * as_metadata_get_write_search_tokens:
+ * @metad: a #AsMetadata instance.
+ *
+ * Returns: %TRUE if a prebuilt search token index is written with catalog data.
+ *
+ * Since: 1.0.5
+ **/
+gboolean
+as_metadata_get_write_search_tokens (AsMetadata *metad)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	return priv->write_search_tokens;
+}
+
+/**
+ * as_metadata_set_write_search_tokens:
+ * @metad: a #AsMetadata instance.
+ * @write_tokens: %TRUE to write a search token index.
+ *
+ * If set to %TRUE, XML catalog output will contain a prebuilt, stemmed
+ * search token index for each component, so clients reading the data
+ * can answer search queries without tokenizing the component data again.
+ * The index is stemmed for the currently active locale and only picked
+ * up by readers using a compatible locale.
+ *
+ * Since: 1.0.5
+ **/
+void
+as_metadata_set_write_search_tokens (AsMetadata *metad, gboolean write_tokens)
+{
+	AsMetadataPrivate *priv = GET_PRIVATE (metad);
+	priv->write_search_tokens = write_tokens;
+}
+
 /**
  * as_metadata_class_init:
  **/
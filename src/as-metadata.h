@@ -52,12 +52,15 @@ struct _AsMetadataClass {
  * AsParseFlags:
  * @AS_PARSE_FLAG_NONE:				No flags.
  * @AS_PARSE_FLAG_IGNORE_MEDIABASEURL:		Do not process the media_baseurl document property.
+ * @AS_PARSE_FLAG_STRICT_LOCALE:		Only read the active locale and the untranslated fallback,
+ *						ignoring other compatible locale variants.
  *
  * Influence certain aspects of how AppStream metadata is parsed.
  */
 typedef enum {
 	AS_PARSE_FLAG_NONE		  = 0,
-	AS_PARSE_FLAG_IGNORE_MEDIABASEURL = 1 << 0
+	AS_PARSE_FLAG_IGNORE_MEDIABASEURL = 1 << 0,
+	AS_PARSE_FLAG_STRICT_LOCALE	  = 1 << 1
 } AsParseFlags;
 
 /**
@@ -120,6 +123,42 @@ gboolean as_metadata_save_catalog (AsMetadata  *metad,
 				   AsFormatKind format,
 				   GError     **error);
 
+/**
+ * AsDataWriteFn:
+ * @data: the next chunk of serialized data, not %NULL-terminated.
+ * @data_len: length of @data in bytes.
+ * @user_data: user data given to the serialization function.
+ *
+ * Callback receiving consecutive chunks of serialized metadata.
+ *
+ * Returns: %TRUE on success, %FALSE to abort the serialization.
+ *
+ * Since: 1.0.5
+ */
+typedef gboolean (*AsDataWriteFn) (const gchar *data, gsize data_len, gpointer user_data);
+
+gboolean as_metadata_components_to_catalog_stream (AsMetadata   *metad,
+						   AsFormatKind	 format,
+						   AsDataWriteFn write_fn,
+						   gpointer	 user_data,
+						   GError      **error);
+
+gboolean as_metadata_save_catalog_sharded (AsMetadata  *metad,
+					   const gchar *manifest_fname,
+					   AsFormatKind format,
+					   guint	n_shards,
+					   GError     **error);
+
+gchar	*as_metadata_components_to_catalog_delta (AsMetadata  *metad,
+						  const gchar *base_checksum,
+						  GPtrArray   *removed_ids);
+void	 as_metadata_add_delta_base_checksum (AsMetadata *metad, const gchar *checksum);
+
+void	 as_metadata_set_compute_checksums (AsMetadata *metad, gboolean compute);
+gboolean as_metadata_get_compute_checksums (AsMetadata *metad);
+const gchar *as_metadata_get_catalog_checksum (AsMetadata *metad);
+const gchar *as_metadata_get_component_checksum (AsMetadata *metad, const gchar *cid);
+
 AsComponent    *as_metadata_get_component (AsMetadata *metad);
 AsComponentBox *as_metadata_get_components (AsMetadata *metad);
 
@@ -161,6 +200,12 @@ void		as_metadata_set_architecture (AsMetadata *metad, const gchar *arch);
 AsParseFlags	as_metadata_get_parse_flags (AsMetadata *metad);
 void		as_metadata_set_parse_flags (AsMetadata *metad, AsParseFlags flags);
 
+void		as_metadata_add_load_kind (AsMetadata *metad, AsComponentKind kind);
+void		as_metadata_reset_load_kinds (AsMetadata *metad);
+
+gboolean	as_metadata_get_write_search_tokens (AsMetadata *metad);
+void		as_metadata_set_write_search_tokens (AsMetadata *metad, gboolean write_tokens);
+
 G_END_DECLS
 
 #endif /* __AS_METADATA_H */
@@ -170,14 +170,15 @@ as_news_yaml_to_releases (const gchar *yaml_data, gint limit, GError **error)
 			GNode *n;
 			GError *tmp_error = NULL;
 			g_autoptr(GNode) root = NULL;
+			g_autoptr(GStringChunk) strchunk = NULL;
 			g_autoptr(AsRelease) rel = as_release_new ();
 
-			root = g_node_new (g_strdup (""));
-			as_yaml_parse_layer (&parser, root, &tmp_error);
+			strchunk = g_string_chunk_new (4 * 1024);
+			root = g_node_new (g_string_chunk_insert (strchunk, ""));
+			as_yaml_parse_layer (&parser, root, strchunk, &tmp_error);
 			if (tmp_error != NULL) {
 				/* stop immediately, since we found an error when parsing the document */
 				g_propagate_error (error, tmp_error);
-				g_free (root->data);
 				yaml_event_delete (&event);
 				ret = FALSE;
 				parse = FALSE;
@@ -316,13 +317,6 @@ as_news_yaml_to_releases (const gchar *yaml_data, gint limit, GError **error)
 				if (limit > 0 && releases->len >= (guint) limit)
 					parse = FALSE;
 			}
-
-			g_node_traverse (root,
-					 G_IN_ORDER,
-					 G_TRAVERSE_ALL,
-					 -1,
-					 as_yaml_free_node,
-					 NULL);
 		}
 
 		/* stop if end of stream is reached */
@@ -1049,6 +1043,107 @@ as_news_to_releases_from_filename (const gchar *fname,
 	return as_news_to_releases_from_data (data, kind, entry_limit, translatable_limit, error);
 }
 
+typedef struct {
+	const gchar *const *fnames;
+	guint n_fnames;
+	GPtrArray **results; /* release list per filename index */
+	AsNewsFormatKind kind;
+	gint entry_limit;
+	gint translatable_limit;
+	gint next_index; /* atomic */
+} AsNewsConvertHelper;
+
+/**
+ * as_news_convert_worker:
+ *
+ * Worker thread converting news files to release lists, pulling the
+ * next filename index from the shared work list.
+ */
+static gpointer
+as_news_convert_worker (gpointer data)
+{
+	AsNewsConvertHelper *helper = data;
+	gint idx;
+
+	while ((idx = g_atomic_int_add (&helper->next_index, 1)) < (gint) helper->n_fnames) {
+		g_autoptr(GError) error = NULL;
+		const gchar *fname = helper->fnames[idx];
+
+		helper->results[idx] = as_news_to_releases_from_filename (
+		    fname,
+		    helper->kind,
+		    helper->entry_limit,
+		    helper->translatable_limit,
+		    &error);
+		if (helper->results[idx] == NULL) {
+			g_debug ("Unable to convert news file '%s': %s",
+				 fname,
+				 error != NULL ? error->message : "Unknown error");
+			/* an empty release list marks the failed conversion */
+			helper->results[idx] = g_ptr_array_new_with_free_func (g_object_unref);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * as_news_to_releases_from_filenames:
+ *
+ * Convert many NEWS files to lists of AsRelease elements at once,
+ * processing the files with a bounded worker pool. This is a lot faster
+ * than converting one file at a time when changelogs for a whole
+ * archive need to be processed.
+ *
+ * The returned array has exactly one entry per input filename, in input
+ * order: the release list of the respective file, which is empty if its
+ * conversion failed (failures are logged, but do not abort the batch).
+ *
+ * Returns: (transfer full) (element-type GPtrArray): A release list per input file.
+ */
+GPtrArray *
+as_news_to_releases_from_filenames (const gchar *const *fnames,
+				    AsNewsFormatKind kind,
+				    gint entry_limit,
+				    gint translatable_limit)
+{
+	AsNewsConvertHelper helper;
+	g_autofree GPtrArray **results = NULL;
+	g_autofree GThread **threads = NULL;
+	GPtrArray *rels_list;
+	guint n_threads;
+
+	g_return_val_if_fail (fnames != NULL, NULL);
+
+	helper.fnames = fnames;
+	helper.n_fnames = g_strv_length ((gchar **) fnames);
+	helper.kind = kind;
+	helper.entry_limit = entry_limit;
+	helper.translatable_limit = translatable_limit;
+	helper.next_index = 0;
+
+	results = g_new0 (GPtrArray *, helper.n_fnames + 1);
+	helper.results = results;
+
+	/* there is no point in spawning threads for a handful of files */
+	n_threads = MIN (g_get_num_processors (), helper.n_fnames / 8);
+	if (n_threads <= 1) {
+		as_news_convert_worker (&helper);
+	} else {
+		threads = g_new0 (GThread *, n_threads);
+		for (guint i = 0; i < n_threads; i++)
+			threads[i] = g_thread_new ("news-convert", as_news_convert_worker, &helper);
+		for (guint i = 0; i < n_threads; i++)
+			g_thread_join (threads[i]);
+	}
+
+	rels_list = g_ptr_array_new_with_free_func ((GDestroyNotify) g_ptr_array_unref);
+	for (guint i = 0; i < helper.n_fnames; i++)
+		g_ptr_array_add (rels_list, results[i]);
+
+	return rels_list;
+}
+
 /**
  * as_releases_to_news_data:
  *
@@ -61,6 +61,10 @@ GPtrArray	*as_news_to_releases_from_filename (const gchar	    *fname,
 						    gint	     entry_limit,
 						    gint	     translatable_limit,
 						    GError	   **error);
+GPtrArray	*as_news_to_releases_from_filenames (const gchar *const *fnames,
+						     AsNewsFormatKind	 kind,
+						     gint		 entry_limit,
+						     gint		 translatable_limit);
 
 gchar		*as_releases_to_metainfo_xml_chunk (GPtrArray *releases, GError **error);
 
@@ -29,6 +29,8 @@ AS_BEGIN_PRIVATE_DECLS
 
 time_t as_pool_get_os_metadata_cache_age (AsPool *pool);
 
+AsPoolSnapshot *as_pool_snapshot_new (AsPool *pool);
+
 AS_INTERNAL_VISIBLE
 gboolean as_pool_refresh_system_cache (AsPool	*pool,
 				       gboolean	 force,
@@ -43,6 +45,9 @@ gboolean as_pool_print_std_data_locations_info_private (AsPool	*pool,
 							gboolean print_os_data,
 							gboolean print_extra_data);
 
+AS_INTERNAL_VISIBLE
+GPtrArray *as_pool_get_components_xml_by_id (AsPool *pool, const gchar *cid, GError **error);
+
 AS_END_PRIVATE_DECLS
 
 #endif /* __AS_POOL_PRIVATE_H */
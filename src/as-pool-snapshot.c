@@ -0,0 +1,283 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2012-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:as-pool-snapshot
+ * @short_description: An immutable snapshot of the contents of an #AsPool.
+ * @include: appstream.h
+ *
+ * A pool snapshot holds a frozen view of all components that were loaded
+ * into an #AsPool at the time as_pool_freeze() was called.
+ * All data and indices are materialized upon creation and are never modified
+ * afterwards, so any number of threads may query the same snapshot
+ * concurrently without taking locks or serializing their requests.
+ *
+ * Changes made to the originating pool after the snapshot was taken,
+ * e.g. by a cache refresh, are not reflected in the snapshot.
+ *
+ * See also: #AsPool
+ */
+
+#include "config.h"
+#include "as-pool-snapshot.h"
+
+#include <string.h>
+
+#include "as-pool-private.h"
+#include "as-component-private.h"
+#include "as-utils-private.h"
+
+typedef struct {
+	AsPool *pool;	      /* pool we were created from, used for search tokenization */
+	AsComponentBox *cbox; /* all components, materialized & read-only */
+	GHashTable *id_index; /* borrowed cid -> GPtrArray of borrowed AsComponent */
+} AsPoolSnapshotPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (AsPoolSnapshot, as_pool_snapshot, G_TYPE_OBJECT)
+#define GET_PRIVATE(o) (as_pool_snapshot_get_instance_private (o))
+
+static void
+as_pool_snapshot_init (AsPoolSnapshot *snapshot)
+{
+	AsPoolSnapshotPrivate *priv = GET_PRIVATE (snapshot);
+
+	priv->id_index = g_hash_table_new_full (g_str_hash,
+						g_str_equal,
+						NULL,
+						(GDestroyNotify) g_ptr_array_unref);
+}
+
+static void
+as_pool_snapshot_finalize (GObject *object)
+{
+	AsPoolSnapshot *snapshot = AS_POOL_SNAPSHOT (object);
+	AsPoolSnapshotPrivate *priv = GET_PRIVATE (snapshot);
+
+	g_hash_table_unref (priv->id_index);
+	if (priv->cbox != NULL)
+		g_object_unref (priv->cbox);
+	if (priv->pool != NULL)
+		g_object_unref (priv->pool);
+
+	G_OBJECT_CLASS (as_pool_snapshot_parent_class)->finalize (object);
+}
+
+static void
+as_pool_snapshot_class_init (AsPoolSnapshotClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+	object_class->finalize = as_pool_snapshot_finalize;
+}
+
+/**
+ * as_pool_snapshot_new:
+ * @pool: the #AsPool to freeze.
+ *
+ * Materialize a new snapshot from the current contents of @pool.
+ * All components are retrieved, the ID index is built and the
+ * per-component search token caches are pre-warmed here, so that
+ * subsequent queries never have to modify any shared state.
+ *
+ * Internal API, used by as_pool_freeze().
+ */
+AsPoolSnapshot *
+as_pool_snapshot_new (AsPool *pool)
+{
+	AsPoolSnapshot *snapshot;
+	AsPoolSnapshotPrivate *priv;
+
+	snapshot = g_object_new (AS_TYPE_POOL_SNAPSHOT, NULL);
+	priv = GET_PRIVATE (snapshot);
+
+	priv->pool = g_object_ref (pool);
+	priv->cbox = as_pool_get_components (pool);
+
+	for (guint i = 0; i < as_component_box_len (priv->cbox); i++) {
+		AsComponent *cpt = as_component_box_index (priv->cbox, i);
+		const gchar *cid = as_component_get_id (cpt);
+		GPtrArray *cpts;
+
+		if (cid != NULL) {
+			cpts = g_hash_table_lookup (priv->id_index, cid);
+			if (cpts == NULL) {
+				cpts = g_ptr_array_new ();
+				g_hash_table_insert (priv->id_index, (gchar *) cid, cpts);
+			}
+			g_ptr_array_add (cpts, cpt);
+		}
+
+		/* build the token cache now, so searches are pure reads later */
+		as_component_get_token_cache_table (cpt);
+	}
+
+	return snapshot;
+}
+
+/**
+ * as_pool_snapshot_get_components:
+ * @snapshot: An instance of #AsPoolSnapshot.
+ *
+ * Get the list of all components contained in this snapshot.
+ * The returned component box is shared between all callers and
+ * must not be modified.
+ *
+ * Returns: (transfer full): an #AsComponentBox.
+ *
+ * Since: 1.0.5
+ */
+AsComponentBox *
+as_pool_snapshot_get_components (AsPoolSnapshot *snapshot)
+{
+	AsPoolSnapshotPrivate *priv = GET_PRIVATE (snapshot);
+	return g_object_ref (priv->cbox);
+}
+
+/**
+ * as_pool_snapshot_get_components_by_id:
+ * @snapshot: An instance of #AsPoolSnapshot.
+ * @cid: The AppStream-ID to look for.
+ *
+ * Get a specific component by its ID.
+ * This function may return multiple results if the snapshot contains
+ * data describing this component from multiple scopes/origin types.
+ *
+ * Returns: (transfer full): an #AsComponentBox.
+ *
+ * Since: 1.0.5
+ */
+AsComponentBox *
+as_pool_snapshot_get_components_by_id (AsPoolSnapshot *snapshot, const gchar *cid)
+{
+	AsPoolSnapshotPrivate *priv = GET_PRIVATE (snapshot);
+	AsComponentBox *result;
+	GPtrArray *cpts;
+
+	result = as_component_box_new_simple ();
+	if (cid == NULL)
+		return result;
+
+	cpts = g_hash_table_lookup (priv->id_index, cid);
+	if (cpts == NULL)
+		return result;
+
+	for (guint i = 0; i < cpts->len; i++)
+		as_component_box_add (result, AS_COMPONENT (g_ptr_array_index (cpts, i)), NULL);
+
+	return result;
+}
+
+typedef struct {
+	AsComponent *cpt; /* borrowed */
+	guint match_value;
+} AsSnapshotSearchHit;
+
+/**
+ * as_snapshot_search_hit_cmp:
+ *
+ * Sort search hits by their match value, best matches first.
+ */
+static gint
+as_snapshot_search_hit_cmp (gconstpointer a, gconstpointer b)
+{
+	const AsSnapshotSearchHit *hit_a = *((AsSnapshotSearchHit *const *) a);
+	const AsSnapshotSearchHit *hit_b = *((AsSnapshotSearchHit *const *) b);
+
+	if (hit_a->match_value > hit_b->match_value)
+		return -1;
+	if (hit_a->match_value < hit_b->match_value)
+		return 1;
+	return 0;
+}
+
+/**
+ * as_pool_snapshot_search:
+ * @snapshot: An instance of #AsPoolSnapshot.
+ * @search: A search string.
+ *
+ * Search for a list of components matching the search term,
+ * sorted by their match score.
+ * Unlike as_pool_search(), this never takes any locks and only
+ * reads immutable data, so it is safe and efficient to call from
+ * many threads simultaneously.
+ *
+ * Returns: (transfer full): an #AsComponentBox of the found components.
+ *
+ * Since: 1.0.5
+ */
+AsComponentBox *
+as_pool_snapshot_search (AsPoolSnapshot *snapshot, const gchar *search)
+{
+	AsPoolSnapshotPrivate *priv = GET_PRIVATE (snapshot);
+	g_auto(GStrv) tokens = NULL;
+	g_autoptr(GPtrArray) hits = NULL;
+	AsComponentBox *result;
+
+	/* sanitize user's search term */
+	tokens = as_pool_build_search_tokens (priv->pool, search);
+
+	if (tokens == NULL) {
+		/* the query was invalid */
+		g_autofree gchar *tmp = g_strdup (search);
+		as_strstripnl (tmp);
+		if (strlen (tmp) <= 1) {
+			/* we have a one-letter search query - we cheat here and just return everything */
+			g_debug ("Search query too broad. Matching everything.");
+			return as_pool_snapshot_get_components (snapshot);
+		}
+
+		g_debug ("No valid search tokens. Can not find any results.");
+		return as_component_box_new_simple ();
+	}
+
+	hits = g_ptr_array_new_with_free_func (g_free);
+	for (guint i = 0; i < as_component_box_len (priv->cbox); i++) {
+		AsComponent *cpt = as_component_box_index (priv->cbox, i);
+		guint match_value = 0;
+		AsSnapshotSearchHit *hit;
+
+		/* all search keywords must match - we intentionally do not use
+		 * as_component_search_matches_all() here, as that updates the
+		 * component's sort score and would be a write to shared data */
+		for (guint j = 0; tokens[j] != NULL; j++) {
+			guint tmp = as_component_search_matches (cpt, tokens[j]);
+			if (tmp == 0) {
+				match_value = 0;
+				break;
+			}
+			match_value |= tmp;
+		}
+		if (match_value == 0)
+			continue;
+
+		hit = g_new0 (AsSnapshotSearchHit, 1);
+		hit->cpt = cpt;
+		hit->match_value = match_value;
+		g_ptr_array_add (hits, hit);
+	}
+	g_ptr_array_sort (hits, as_snapshot_search_hit_cmp);
+
+	result = as_component_box_new_simple ();
+	for (guint i = 0; i < hits->len; i++) {
+		AsSnapshotSearchHit *hit = g_ptr_array_index (hits, i);
+		as_component_box_add (result, hit->cpt, NULL);
+	}
+
+	return result;
+}
@@ -0,0 +1,55 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2012-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(__APPSTREAM_H) && !defined(AS_COMPILATION)
+#error "Only <appstream.h> can be included directly."
+#endif
+
+#ifndef __AS_POOL_SNAPSHOT_H
+#define __AS_POOL_SNAPSHOT_H
+
+#include <glib-object.h>
+
+#include "as-component.h"
+#include "as-component-box.h"
+
+G_BEGIN_DECLS
+
+#define AS_TYPE_POOL_SNAPSHOT (as_pool_snapshot_get_type ())
+G_DECLARE_DERIVABLE_TYPE (AsPoolSnapshot, as_pool_snapshot, AS, POOL_SNAPSHOT, GObject)
+
+struct _AsPoolSnapshotClass {
+	GObjectClass parent_class;
+	/*< private >*/
+	void (*_as_reserved1) (void);
+	void (*_as_reserved2) (void);
+	void (*_as_reserved3) (void);
+	void (*_as_reserved4) (void);
+	void (*_as_reserved5) (void);
+	void (*_as_reserved6) (void);
+};
+
+AsComponentBox *as_pool_snapshot_get_components (AsPoolSnapshot *snapshot);
+AsComponentBox *as_pool_snapshot_get_components_by_id (AsPoolSnapshot *snapshot, const gchar *cid);
+AsComponentBox *as_pool_snapshot_search (AsPoolSnapshot *snapshot, const gchar *search);
+
+G_END_DECLS
+
+#endif /* __AS_POOL_SNAPSHOT_H */
@@ -47,6 +47,7 @@
 #include <gio/gio.h>
 #include <glib/gi18n-lib.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <errno.h>
@@ -57,12 +58,14 @@
 #include "as-component-box-private.h"
 #include "as-macros-private.h"
 #include "as-distro-extras.h"
+#include "as-system-info.h"
 #include "as-stemmer.h"
 #include "as-cache.h"
 #include "as-file-monitor.h"
 #include "as-profile.h"
 
 #include "as-metadata.h"
+#include "as-xml.h"
 
 typedef struct {
 	gchar *locale_bcp47;
@@ -74,12 +77,40 @@ typedef struct {
 	GHashTable *extra_data_locations;
 
 	AsCache *cache;
-	guint pending_id; /* source ID for pending auto-reload */
+	guint pending_id;	    /* source ID for pending auto-reload */
+	guint reload_delay_ms;	    /* current adaptive reload coalescing delay */
+	gint64 last_reload_trigger; /* monotonic time of the last reload trigger */
+	gint reload_running;	    /* atomic, TRUE while a reload task executes */
+	guint64 reloads_triggered;  /* stats: change batches which requested a reload */
+	guint64 reloads_executed;   /* stats: reloads actually performed */
+	guint64 reloads_shed;	    /* stats: scheduled reloads superseded by newer triggers */
 
 	gchar **term_greylist;
+	GHashTable *search_synonyms; /* utf8 -> GStrv */
 	AsPoolFlags flags;
+	guint32 load_kinds; /* bitmask of component kinds to load, 0 means all */
+
+	GHashTable *search_memo; /* utf8 -> AsPoolSearchMemoEntry */
+	GMutex search_memo_mutex;
+	gint content_generation;
+
+	GHashTable *language_stats; /* utf8 -> guint, memoized language histogram */
+	gint language_stats_generation;
+	GMutex language_stats_mutex;
 
 	GRWLock rw_lock;
+	GMutex reload_mutex; /* serializes background section reloads */
+
+	GThread *warm_thread;	       /* background search-index warmup thread */
+	GCancellable *warm_cancellable; /* cancelled when a real query arrives */
+	GMutex warm_mutex;
+
+	GMappedFile *priors_mfile;    /* mapped popularity prior table, or NULL */
+	const guint8 *priors_entries; /* entry array inside the mapped table */
+	guint priors_n_entries;
+
+	AsPoolRankingFn ranking_fn; /* custom search ranking hook, or NULL */
+	gpointer ranking_fn_udata;
 } AsPoolPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (AsPool, as_pool, G_TYPE_OBJECT)
@@ -93,6 +124,114 @@ static guint signals[SIGNAL_LAST] = { 0 };
 
 #define GET_PRIVATE(o) (as_pool_get_instance_private (o))
 
+/* maximum amount of memoized search results kept per pool */
+#define AS_POOL_SEARCH_MEMO_MAX_ENTRIES 128
+
+/* bounds for the adaptive auto-reload coalescing delay */
+#define AS_POOL_RELOAD_DELAY_MIN_MS 100
+#define AS_POOL_RELOAD_DELAY_MAX_MS 15000
+
+/* a reload trigger this long after the previous one starts a new change burst */
+#define AS_POOL_RELOAD_QUIET_PERIOD_MS 30000
+
+/* file magic, version and entry size of the popularity prior table */
+#define AS_POOL_PRIORS_MAGIC	      "AsPp"
+#define AS_POOL_PRIORS_FORMAT_VERSION 1
+#define AS_POOL_PRIORS_HEADER_SIZE    12
+#define AS_POOL_PRIORS_ENTRY_SIZE     12
+
+typedef struct {
+	gint generation; /* pool content generation this result belongs to */
+	GPtrArray *cpts; /* of AsComponent, in ranked order */
+} AsPoolSearchMemoEntry;
+
+static void
+as_pool_search_memo_entry_free (AsPoolSearchMemoEntry *entry)
+{
+	g_ptr_array_unref (entry->cpts);
+	g_free (entry);
+}
+
+/**
+ * as_pool_invalidate_memoized_searches:
+ *
+ * Mark all memoized search results as stale. Must be called whenever
+ * the contents of the pool change, e.g. on (re)load or when masking
+ * components are added.
+ */
+static void
+as_pool_invalidate_memoized_searches (AsPool *pool)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_atomic_int_inc (&priv->content_generation);
+}
+
+/**
+ * as_pool_load_search_synonyms:
+ *
+ * Load the optional search synonym table. The file consists of lines in
+ * the form `term: synonym1 synonym2 ...`, meaning that a search for
+ * `term` will additionally match components indexed under any of the
+ * synonyms (e.g. `browser: www`). Empty lines and lines starting with
+ * `#` are ignored.
+ *
+ * Distributors and app store vendors can ship the table in
+ * `/etc/appstream/search-synonyms.conf` or in a `appstream/search-synonyms.conf`
+ * file in one of the system data directories. Only the first file found
+ * is read. The parsed table is tiny and lives in a hash map, so query
+ * expansion is a single lookup per token.
+ */
+static void
+as_pool_load_search_synonyms (AsPool *pool)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GPtrArray) locations = NULL;
+	g_autofree gchar *contents = NULL;
+	g_auto(GStrv) lines = NULL;
+	const gchar *const *data_dirs;
+
+	locations = g_ptr_array_new_with_free_func (g_free);
+	g_ptr_array_add (locations,
+			 g_build_filename ("/etc", "appstream", "search-synonyms.conf", NULL));
+	data_dirs = g_get_system_data_dirs ();
+	for (guint i = 0; data_dirs[i] != NULL; i++)
+		g_ptr_array_add (
+		    locations,
+		    g_build_filename (data_dirs[i], "appstream", "search-synonyms.conf", NULL));
+
+	for (guint i = 0; i < locations->len; i++) {
+		const gchar *fname = g_ptr_array_index (locations, i);
+		if (g_file_get_contents (fname, &contents, NULL, NULL)) {
+			g_debug ("Loading search synonyms from %s", fname);
+			break;
+		}
+	}
+	if (contents == NULL)
+		return;
+
+	lines = g_strsplit (contents, "\n", -1);
+	for (guint i = 0; lines[i] != NULL; i++) {
+		g_autofree gchar *folded = NULL;
+		g_auto(GStrv) parts = NULL;
+		gchar **synonyms;
+		g_strstrip (lines[i]);
+		if (lines[i][0] == '\0' || lines[i][0] == '#')
+			continue;
+
+		folded = g_utf8_casefold (lines[i], -1);
+		parts = g_strsplit (folded, ":", 2);
+		if (parts[0] == NULL || parts[1] == NULL)
+			continue;
+		g_strstrip (parts[0]);
+		g_strstrip (parts[1]);
+		if (parts[0][0] == '\0' || parts[1][0] == '\0')
+			continue;
+
+		synonyms = g_strsplit_set (parts[1], " \t", -1);
+		g_hash_table_insert (priv->search_synonyms, g_strdup (parts[0]), synonyms);
+	}
+}
+
 /* TRANSLATORS: List of "grey-listed" words sperated with ";"
    Do not translate this list directly. Instead,
    provide a list of words in your language that people are likely
@@ -133,8 +272,12 @@ typedef struct {
 	gboolean is_os_data;
 	GPtrArray *locations;
 	GPtrArray *icon_dirs;
+	AsIconDirIndex *icon_index;
 	GRefString *cache_key;
 	AsFileMonitor *monitor;
+	GPtrArray *changed_files;     /* files with pending changes for the next reload */
+	gboolean pending_full_reload; /* TRUE if the next reload must process the whole group */
+	GHashTable *file_cpts_map;    /* maps source filenames to the component-IDs they contain */
 } AsLocationGroup;
 
 static AsLocationEntry *
@@ -161,6 +304,12 @@ as_pool_cache_refine_component_cb (AsComponent *cpt, gboolean is_serialization,
 static void as_pool_location_group_monitor_changed_cb (AsFileMonitor *monitor,
 						       const gchar *filename,
 						       AsLocationGroup *lgroup);
+static void as_pool_location_group_monitor_removed_cb (AsFileMonitor *monitor,
+						       const gchar *filename,
+						       AsLocationGroup *lgroup);
+static void as_pool_location_group_monitor_finished_cb (AsFileMonitor *monitor,
+							guint n_changes,
+							AsLocationGroup *lgroup);
 
 static AsLocationGroup *
 as_location_group_new (AsPool *owner,
@@ -180,8 +329,15 @@ as_location_group_new (AsPool *owner,
 	lgroup->locations = g_ptr_array_new_with_free_func (
 	    (GDestroyNotify) as_location_entry_free);
 	lgroup->icon_dirs = g_ptr_array_new_with_free_func ((GDestroyNotify) as_ref_string_release);
+	lgroup->icon_index = as_icon_dir_index_new ();
 	as_ref_string_assign_safe (&lgroup->cache_key, cache_key);
 
+	lgroup->changed_files = g_ptr_array_new_with_free_func (g_free);
+	lgroup->file_cpts_map = g_hash_table_new_full (g_str_hash,
+						       g_str_equal,
+						       g_free,
+						       (GDestroyNotify) g_ptr_array_unref);
+
 	lgroup->monitor = as_file_monitor_new ();
 	g_signal_connect (lgroup->monitor,
 			  "changed",
@@ -193,7 +349,11 @@ as_location_group_new (AsPool *owner,
 			  lgroup);
 	g_signal_connect (lgroup->monitor,
 			  "removed",
-			  G_CALLBACK (as_pool_location_group_monitor_changed_cb),
+			  G_CALLBACK (as_pool_location_group_monitor_removed_cb),
+			  lgroup);
+	g_signal_connect (lgroup->monitor,
+			  "changes-finished",
+			  G_CALLBACK (as_pool_location_group_monitor_finished_cb),
 			  lgroup);
 
 	return lgroup;
@@ -205,6 +365,9 @@ as_location_group_free (AsLocationGroup *lgroup)
 	g_object_unref (lgroup->monitor);
 	g_ptr_array_unref (lgroup->locations);
 	g_ptr_array_unref (lgroup->icon_dirs);
+	as_icon_dir_index_free (lgroup->icon_index);
+	g_ptr_array_unref (lgroup->changed_files);
+	g_hash_table_unref (lgroup->file_cpts_map);
 	as_ref_string_release (lgroup->cache_key);
 
 	g_free (lgroup);
@@ -232,6 +395,20 @@ as_location_group_add_dir (AsLocationGroup *lgroup,
 			g_warning ("Unable to register directory '%s' for monitoring: %s",
 				   dir,
 				   error->message);
+
+		/* also watch the icon location, so cached icon-directory listings can
+		 * be invalidated when icons change, instead of on every pool load */
+		if (icon_dir != NULL) {
+			g_autoptr(GError) icon_error = NULL;
+			if (!as_file_monitor_add_directory (lgroup->monitor,
+							    icon_dir,
+							    NULL,
+							    &icon_error))
+				g_warning ("Unable to register icon directory '%s' for "
+					   "monitoring: %s",
+					   icon_dir,
+					   icon_error->message);
+		}
 	}
 
 	return entry;
@@ -346,6 +523,8 @@ as_pool_init (AsPool *pool)
 	g_autoptr(GError) tmp_error = NULL;
 
 	g_rw_lock_init (&priv->rw_lock);
+	g_mutex_init (&priv->reload_mutex);
+	g_mutex_init (&priv->warm_mutex);
 
 	priv->profile = as_profile_new ();
 
@@ -372,6 +551,22 @@ as_pool_init (AsPool *pool)
 	/* set up our localized search-term greylist */
 	priv->term_greylist = g_strsplit (AS_SEARCH_GREYLIST_STR, ";", -1);
 
+	/* load the optional search synonym table */
+	priv->search_synonyms = g_hash_table_new_full (g_str_hash,
+						       g_str_equal,
+						       g_free,
+						       (GDestroyNotify) g_strfreev);
+	as_pool_load_search_synonyms (pool);
+
+	/* memoized results for frequently repeated search queries */
+	priv->search_memo = g_hash_table_new_full (
+	    g_str_hash,
+	    g_str_equal,
+	    g_free,
+	    (GDestroyNotify) as_pool_search_memo_entry_free);
+	g_mutex_init (&priv->search_memo_mutex);
+	g_mutex_init (&priv->language_stats_mutex);
+
 	/* create caches */
 	priv->cache = as_cache_new ();
 
@@ -381,6 +576,12 @@ as_pool_init (AsPool *pool)
 	/* set default pool flags */
 	priv->flags = AS_POOL_FLAG_LOAD_OS_CATALOG | AS_POOL_FLAG_LOAD_OS_METAINFO |
 		      AS_POOL_FLAG_LOAD_FLATPAK;
+
+	/* load components of all kinds by default */
+	priv->load_kinds = 0;
+
+	/* start with the shortest reload deferral */
+	priv->reload_delay_ms = AS_POOL_RELOAD_DELAY_MIN_MS;
 }
 
 /**
@@ -399,17 +600,34 @@ as_pool_finalize (GObject *object)
 	g_hash_table_unref (priv->std_data_locations);
 	g_hash_table_unref (priv->extra_data_locations);
 
+	g_hash_table_unref (priv->search_memo);
+	g_mutex_clear (&priv->search_memo_mutex);
+
+	g_clear_pointer (&priv->language_stats, g_hash_table_unref);
+	g_mutex_clear (&priv->language_stats_mutex);
+
 	g_object_unref (priv->cache);
 
 	g_free (priv->locale_posix);
 	g_free (priv->locale_bcp47);
 	g_free (priv->current_arch);
 	g_strfreev (priv->term_greylist);
+	g_hash_table_unref (priv->search_synonyms);
+
+	g_clear_pointer (&priv->priors_mfile, g_mapped_file_unref);
 
 	g_object_unref (priv->profile);
 
 	g_rw_lock_writer_unlock (&priv->rw_lock);
 	g_rw_lock_clear (&priv->rw_lock);
+	g_mutex_clear (&priv->reload_mutex);
+
+	/* the warmup thread holds a reference on the pool, so by the time we
+	 * are finalized it has already exited and only needs to be collected */
+	if (priv->warm_thread != NULL)
+		g_thread_join (priv->warm_thread);
+	g_clear_object (&priv->warm_cancellable);
+	g_mutex_clear (&priv->warm_mutex);
 
 	G_OBJECT_CLASS (as_pool_parent_class)->finalize (object);
 }
@@ -981,6 +1199,7 @@ gboolean
 as_pool_add_components (AsPool *pool, AsComponentBox *cbox, GError **error)
 {
 	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	as_pool_invalidate_memoized_searches (pool);
 	return as_cache_add_masking_components (priv->cache,
 						as_component_box_as_array (cbox),
 						error);
@@ -1001,6 +1220,7 @@ as_pool_clear (AsPool *pool)
 
 	as_cache_clear (priv->cache);
 	as_cache_set_locale (priv->cache, priv->locale_bcp47);
+	as_pool_invalidate_memoized_searches (pool);
 }
 
 /**
@@ -1018,6 +1238,280 @@ as_pool_is_empty (AsPool *pool)
 	return as_cache_is_empty (priv->cache);
 }
 
+/**
+ * as_pool_fname_is_delta_catalog:
+ *
+ * Check if the given filename looks like a delta catalog file,
+ * which has to be applied on top of its base catalog.
+ */
+static gboolean
+as_pool_fname_is_delta_catalog (const gchar *fname)
+{
+	return g_strrstr (fname, ".delta.xml") != NULL;
+}
+
+/**
+ * as_pool_register_delta_base_file:
+ *
+ * Register the checksum of a parsed base catalog file with the metadata
+ * parser, so subsequently parsed delta catalogs can verify that the base
+ * they were created for is actually present.
+ * Hashing every base catalog at every load is expensive on large files, so
+ * the checksum is memoized in the cache generation manifest and only
+ * recomputed when the file actually changed.
+ */
+static void
+as_pool_register_delta_base_file (AsPool *pool, AsMetadata *metad, const gchar *fname)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autofree gchar *checksum = NULL;
+
+	checksum = as_cache_generation_get_file_checksum (priv->cache, fname);
+	if (checksum == NULL) {
+		g_autoptr(GMappedFile) mfile = NULL;
+
+		mfile = g_mapped_file_new (fname, FALSE, NULL);
+		if (mfile == NULL)
+			return;
+		checksum = g_compute_checksum_for_data (
+		    G_CHECKSUM_SHA256,
+		    (const guchar *) g_mapped_file_get_contents (mfile),
+		    g_mapped_file_get_length (mfile));
+		as_cache_generation_update_file_checksum (priv->cache, fname, checksum);
+	}
+	as_metadata_add_delta_base_checksum (metad, checksum);
+}
+
+/**
+ * as_pool_fname_is_shard_manifest:
+ *
+ * Check if the given filename looks like the index manifest of a
+ * sharded catalog, as written by %as_metadata_save_catalog_sharded.
+ */
+static gboolean
+as_pool_fname_is_shard_manifest (const gchar *fname)
+{
+	return g_str_has_suffix (fname, ".shards.xml");
+}
+
+/**
+ * as_pool_read_shard_manifest:
+ *
+ * Read a shard index manifest and append the full paths of all
+ * referenced shard files to @shard_fnames.
+ */
+static gboolean
+as_pool_read_shard_manifest (const gchar *fname, GPtrArray *shard_fnames, GError **error)
+{
+	g_autofree gchar *data = NULL;
+	g_autofree gchar *dirname = NULL;
+	xmlDoc *doc;
+	xmlNode *root;
+
+	if (!g_file_get_contents (fname, &data, NULL, error))
+		return FALSE;
+	doc = as_xml_parse_document (data, -1, FALSE, error);
+	if (doc == NULL)
+		return FALSE;
+	root = xmlDocGetRootElement (doc);
+
+	dirname = g_path_get_dirname (fname);
+	for (xmlNode *iter = root->children; iter != NULL; iter = iter->next) {
+		g_autofree gchar *content = NULL;
+		if (iter->type != XML_ELEMENT_NODE)
+			continue;
+		if (g_strcmp0 ((const gchar *) iter->name, "shard") != 0)
+			continue;
+
+		content = as_xml_get_node_value (iter);
+		if (as_is_empty (content))
+			continue;
+		if (g_path_is_absolute (content))
+			g_ptr_array_add (shard_fnames, g_steal_pointer (&content));
+		else
+			g_ptr_array_add (shard_fnames, g_build_filename (dirname, content, NULL));
+	}
+
+	xmlFreeDoc (doc);
+	return TRUE;
+}
+
+/**
+ * as_pool_metadata_apply_load_kinds:
+ *
+ * Transfer the load-kind filter of this pool to a metadata parser.
+ */
+static void
+as_pool_metadata_apply_load_kinds (AsMetadata *metad, guint32 load_kinds)
+{
+	if (load_kinds == 0)
+		return;
+	for (guint kind = 1; kind < AS_COMPONENT_KIND_LAST; kind++) {
+		if (load_kinds & (1U << kind))
+			as_metadata_add_load_kind (metad, (AsComponentKind) kind);
+	}
+}
+
+/**
+ * as_pool_build_section_cache_key:
+ *
+ * Build the cache key actually used for storing and looking up a cache
+ * section. If a load-kind filter is set, sections only contain a subset
+ * of the source data, so they must not be confused with (or validated
+ * against) sections compiled without the filter.
+ */
+static gchar *
+as_pool_build_section_cache_key (AsPool *pool, const gchar *cache_key)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	if (priv->load_kinds == 0)
+		return g_strdup (cache_key);
+	return g_strdup_printf ("%s-kinds%x", cache_key, priv->load_kinds);
+}
+
+typedef struct {
+	GPtrArray *fnames;	   /* borrowed shard filename list */
+	GPtrArray **results;	   /* parsed components per shard index, or NULL */
+	gchar **errmsgs;	   /* parse error message per shard index, or NULL */
+	const gchar *locale_bcp47; /* borrowed */
+	gboolean strict_locale;
+	guint32 load_kinds;
+	gint next_index; /* atomic */
+} AsPoolShardHelper;
+
+/**
+ * as_pool_parse_shards_worker:
+ *
+ * Worker thread parsing catalog shard files into components.
+ * Each worker has its own metadata parser and pulls the next
+ * shard index from the shared work list.
+ */
+static gpointer
+as_pool_parse_shards_worker (gpointer data)
+{
+	AsPoolShardHelper *helper = data;
+	g_autoptr(AsMetadata) metad = NULL;
+	gint idx;
+
+	/* prepare catalog metadata parser */
+	metad = as_metadata_new ();
+	as_metadata_set_format_style (metad, AS_FORMAT_STYLE_CATALOG);
+	as_metadata_set_locale (metad, helper->locale_bcp47);
+	if (helper->strict_locale)
+		as_metadata_set_parse_flags (metad, AS_PARSE_FLAG_STRICT_LOCALE);
+	as_pool_metadata_apply_load_kinds (metad, helper->load_kinds);
+
+	while ((idx = g_atomic_int_add (&helper->next_index, 1)) < (gint) helper->fnames->len) {
+		g_autoptr(GFile) infile = NULL;
+		g_autoptr(GError) error = NULL;
+		AsComponentBox *cbox;
+		GPtrArray *cpts;
+		const gchar *fname = (const gchar *) g_ptr_array_index (helper->fnames, idx);
+
+		g_debug ("Reading shard: %s", fname);
+		infile = g_file_new_for_path (fname);
+		if (!g_file_query_exists (infile, NULL)) {
+			g_warning ("Catalog shard '%s' does not exist.", fname);
+			continue;
+		}
+
+		as_metadata_clear_components (metad);
+		as_metadata_parse_file (metad, infile, AS_FORMAT_KIND_UNKNOWN, &error);
+		if (error != NULL)
+			helper->errmsgs[idx] = g_strdup (error->message);
+
+		/* keep whatever data we could read, even if the shard had errors */
+		cbox = as_metadata_get_components (metad);
+		cpts = g_ptr_array_new_with_free_func (g_object_unref);
+		for (guint i = 0; i < as_component_box_len (cbox); i++)
+			g_ptr_array_add (cpts,
+					 g_object_ref (as_component_box_index (cbox, i)));
+		helper->results[idx] = cpts;
+	}
+
+	return NULL;
+}
+
+/**
+ * as_pool_load_catalog_shards:
+ *
+ * Parse all given catalog shard files with a bounded worker pool and
+ * register the resulting components with @metad. Shard order is
+ * preserved, so the result is identical to a serial parse.
+ */
+static gboolean
+as_pool_load_catalog_shards (AsPool *pool,
+			     AsMetadata *metad,
+			     GPtrArray *shard_files,
+			     GError **error)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	AsPoolShardHelper helper;
+	g_autofree GPtrArray **results = NULL;
+	g_autofree gchar **errmsgs = NULL;
+	g_autofree GThread **threads = NULL;
+	guint n_threads;
+	gboolean ret = TRUE;
+
+	if (shard_files->len == 0)
+		return TRUE;
+
+	results = g_new0 (GPtrArray *, shard_files->len);
+	errmsgs = g_new0 (gchar *, shard_files->len);
+
+	helper.fnames = shard_files;
+	helper.results = results;
+	helper.errmsgs = errmsgs;
+	helper.locale_bcp47 = priv->locale_bcp47;
+	helper.strict_locale = as_flags_contains (priv->flags, AS_POOL_FLAG_STRICT_LOCALE);
+	helper.load_kinds = priv->load_kinds;
+	helper.next_index = 0;
+
+	/* shards are large, so parsing them in parallel pays off quickly */
+	n_threads = MIN (g_get_num_processors (), shard_files->len);
+	if (n_threads <= 1) {
+		as_pool_parse_shards_worker (&helper);
+	} else {
+		threads = g_new0 (GThread *, n_threads);
+		for (guint i = 0; i < n_threads; i++)
+			threads[i] = g_thread_new ("pool-shards",
+						   as_pool_parse_shards_worker,
+						   &helper);
+		for (guint i = 0; i < n_threads; i++)
+			g_thread_join (threads[i]);
+	}
+
+	for (guint i = 0; i < shard_files->len; i++) {
+		const gchar *fname = (const gchar *) g_ptr_array_index (shard_files, i);
+
+		if (errmsgs[i] != NULL) {
+			g_debug ("WARNING: %s", errmsgs[i]);
+			ret = FALSE;
+
+			if (error != NULL) {
+				if (*error == NULL)
+					g_set_error_literal (error,
+							     AS_POOL_ERROR,
+							     AS_POOL_ERROR_FAILED,
+							     fname);
+				else
+					g_prefix_error (error, "%s, ", fname);
+			}
+			g_free (errmsgs[i]);
+		}
+
+		if (results[i] != NULL) {
+			for (guint j = 0; j < results[i]->len; j++)
+				as_metadata_add_component (
+				    metad,
+				    AS_COMPONENT (g_ptr_array_index (results[i], j)));
+			g_ptr_array_unref (results[i]);
+		}
+	}
+
+	return ret;
+}
+
 /**
  * as_pool_load_catalog_data:
  *
@@ -1034,12 +1528,16 @@ as_pool_load_catalog_data (AsPool *pool,
 	AsComponentBox *cbox;
 	g_autoptr(GPtrArray) merge_cpts = NULL;
 	gboolean ret;
+	gboolean delta_bases_pending = TRUE;
 	g_autoptr(AsMetadata) metad = NULL;
 	g_autoptr(GPtrArray) mdata_files = NULL;
+	g_autoptr(GPtrArray) delta_files = NULL;
+	g_autoptr(GPtrArray) shard_files = NULL;
 	g_autoptr(GError) tmp_error = NULL;
 	g_autoptr(AsProfileTask) ptask = NULL;
 
-	/* NOTE: Write-lock is held by the caller. */
+	/* NOTE: Caller holds the pool writer lock, or a reader lock plus the
+	 * reload mutex (background section reloads). */
 
 	/* do nothing if the group has the wrong format */
 	if (lgroup->format_style != AS_FORMAT_STYLE_CATALOG)
@@ -1051,10 +1549,14 @@ as_pool_load_catalog_data (AsPool *pool,
 	metad = as_metadata_new ();
 	as_metadata_set_format_style (metad, AS_FORMAT_STYLE_CATALOG);
 	as_metadata_set_locale (metad, priv->locale_bcp47);
+	if (as_flags_contains (priv->flags, AS_POOL_FLAG_STRICT_LOCALE))
+		as_metadata_set_parse_flags (metad, AS_PARSE_FLAG_STRICT_LOCALE);
+	as_pool_metadata_apply_load_kinds (metad, priv->load_kinds);
 
 	/* find AppStream metadata */
 	ret = TRUE;
 	mdata_files = g_ptr_array_new_with_free_func (g_free);
+	delta_files = g_ptr_array_new_with_free_func (g_free);
 
 	for (guint i = 0; i < lgroup->locations->len; i++) {
 		AsLocationEntry *lentry = g_ptr_array_index (lgroup->locations, i);
@@ -1111,12 +1613,59 @@ as_pool_load_catalog_data (AsPool *pool,
 		}
 	}
 
+	/* delta catalogs can only be applied after all base catalogs were read,
+	 * so we move them to the end of the list */
+	for (guint i = 0; i < mdata_files->len;) {
+		const gchar *fname = (const gchar *) g_ptr_array_index (mdata_files, i);
+		if (as_pool_fname_is_delta_catalog (fname))
+			g_ptr_array_add (delta_files, g_ptr_array_steal_index (mdata_files, i));
+		else
+			i++;
+	}
+
+	/* expand shard index manifests into their shard file lists */
+	shard_files = g_ptr_array_new_with_free_func (g_free);
+	for (guint i = 0; i < mdata_files->len;) {
+		const gchar *fname = (const gchar *) g_ptr_array_index (mdata_files, i);
+		if (as_pool_fname_is_shard_manifest (fname)) {
+			if (!as_pool_read_shard_manifest (fname, shard_files, &tmp_error)) {
+				g_warning ("Unable to read catalog shard manifest '%s': %s",
+					   fname,
+					   tmp_error->message);
+				g_clear_pointer (&tmp_error, g_error_free);
+			}
+			g_ptr_array_remove_index (mdata_files, i);
+		} else {
+			i++;
+		}
+	}
+	if (shard_files->len > 0) {
+		/* the shard files were likely also picked up by the glob above,
+		 * make sure we do not parse them a second time */
+		for (guint i = 0; i < mdata_files->len;) {
+			const gchar *fname = (const gchar *) g_ptr_array_index (mdata_files, i);
+			if (as_ptr_array_find_string (shard_files, fname) != NULL)
+				g_ptr_array_remove_index (mdata_files, i);
+			else
+				i++;
+		}
+
+		/* parse all shards in parallel */
+		if (!as_pool_load_catalog_shards (pool, metad, shard_files, error))
+			ret = FALSE;
+	}
+
 	/* parse the found data */
-	for (guint i = 0; i < mdata_files->len; i++) {
+	for (guint i = 0; i < mdata_files->len + delta_files->len; i++) {
 		g_autoptr(GFile) infile = NULL;
 		const gchar *fname;
+		gboolean is_delta = i >= mdata_files->len;
 
-		fname = (const gchar *) g_ptr_array_index (mdata_files, i);
+		if (is_delta)
+			fname = (const gchar *) g_ptr_array_index (delta_files,
+								   i - mdata_files->len);
+		else
+			fname = (const gchar *) g_ptr_array_index (mdata_files, i);
 		g_debug ("Reading: %s", fname);
 
 		infile = g_file_new_for_path (fname);
@@ -1125,6 +1674,17 @@ as_pool_load_catalog_data (AsPool *pool,
 			continue;
 		}
 
+		/* deltas only apply to base catalogs we have actually seen, so record
+		 * the checksums of all full catalog files before the first delta is parsed */
+		if (is_delta && delta_bases_pending) {
+			for (guint j = 0; j < mdata_files->len; j++)
+				as_pool_register_delta_base_file (
+				    pool,
+				    metad,
+				    (const gchar *) g_ptr_array_index (mdata_files, j));
+			delta_bases_pending = FALSE;
+		}
+
 		as_metadata_parse_file (metad, infile, AS_FORMAT_KIND_UNKNOWN, &tmp_error);
 		if (tmp_error != NULL) {
 			g_debug ("WARNING: %s", tmp_error->message);
@@ -1202,47 +1762,50 @@ as_pool_cache_refine_component_cb (AsComponent *cpt, gboolean is_serialization,
 		 * and needs to be done partially again on deserialization anyway */
 		/* FIXME: We *do* resolve icon paths here, as not doing so currently causes issues for some apps.
 		 * There's a test case for this, so we can address the issue later. */
-		as_component_complete (cpt, lgroup->icon_dirs);
+		as_component_complete (cpt, lgroup->icon_dirs, lgroup->icon_index);
 	} else {
 		/* add additional data to the component, e.g. external screenshots. Also refines
 		 * the component's icon paths */
-		as_component_complete (cpt, lgroup->icon_dirs);
+		as_component_complete (cpt, lgroup->icon_dirs, lgroup->icon_index);
 	}
 }
 
+typedef struct {
+	GPtrArray *fnames;	   /* borrowed filename list */
+	AsComponent **results;	   /* parsed component per filename index, or NULL */
+	const gchar *locale_bcp47; /* borrowed */
+	AsFormatKind format_kind;
+	gboolean strict_locale;
+	guint32 load_kinds;
+	gint next_index; /* atomic */
+} AsPoolParseHelper;
+
 /**
- * as_pool_update_desktop_entries_table:
+ * as_pool_parse_files_worker:
  *
- * Load metadata from desktop-entry files.
+ * Worker thread parsing metadata files into components.
+ * Each worker has its own metadata parser and pulls the next
+ * filename index from the shared work list.
  */
-static void
-as_pool_update_desktop_entries_table (AsPool *pool, GHashTable *de_cpt_table, const gchar *apps_dir)
+static gpointer
+as_pool_parse_files_worker (gpointer data)
 {
-	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	AsPoolParseHelper *helper = data;
 	g_autoptr(AsMetadata) metad = NULL;
-	g_autoptr(GPtrArray) de_files = NULL;
-	g_autoptr(AsProfileTask) ptask = NULL;
-	GError *error = NULL;
-
-	ptask = as_profile_start_literal (priv->profile, "AsPool:get_desktop_entries_table");
+	gint idx;
 
 	/* prepare metadata parser */
 	metad = as_metadata_new ();
-	as_metadata_set_locale (metad, priv->locale_bcp47);
-
-	/* find .desktop files */
-	g_debug ("Searching for data in: %s", apps_dir);
-	de_files = as_utils_find_files_matching (apps_dir, "*.desktop", FALSE, NULL);
-	if (de_files == NULL) {
-		g_debug ("Unable find desktop-entry files in '%s'.", apps_dir);
-		return;
-	}
+	as_metadata_set_locale (metad, helper->locale_bcp47);
+	if (helper->strict_locale)
+		as_metadata_set_parse_flags (metad, AS_PARSE_FLAG_STRICT_LOCALE);
+	as_pool_metadata_apply_load_kinds (metad, helper->load_kinds);
 
-	/* parse the found data */
-	for (guint i = 0; i < de_files->len; i++) {
+	while ((idx = g_atomic_int_add (&helper->next_index, 1)) < (gint) helper->fnames->len) {
 		g_autoptr(GFile) infile = NULL;
+		g_autoptr(GError) error = NULL;
 		AsComponent *cpt;
-		const gchar *fname = (const gchar *) g_ptr_array_index (de_files, i);
+		const gchar *fname = (const gchar *) g_ptr_array_index (helper->fnames, idx);
 
 		g_debug ("Reading: %s", fname);
 		infile = g_file_new_for_path (fname);
@@ -1252,67 +1815,172 @@ as_pool_update_desktop_entries_table (AsPool *pool, GHashTable *de_cpt_table, co
 		}
 
 		as_metadata_clear_components (metad);
-		as_metadata_parse_file (metad, infile, AS_FORMAT_KIND_DESKTOP_ENTRY, &error);
+		as_metadata_parse_file (metad, infile, helper->format_kind, &error);
 		if (error != NULL) {
-			g_debug ("Error reading .desktop file '%s': %s", fname, error->message);
-			g_error_free (error);
-			error = NULL;
-			continue;
+			g_debug ("Errors in '%s': %s", fname, error->message);
+			/* an invalid desktop-entry file is discarded entirely, while we keep
+			 * whatever data we could read from a faulty metainfo file */
+			if (helper->format_kind == AS_FORMAT_KIND_DESKTOP_ENTRY)
+				continue;
 		}
 
 		cpt = as_metadata_get_component (metad);
-		if (cpt != NULL) {
-			/* we only read metainfo files from system directories */
-			as_component_set_scope (cpt, AS_COMPONENT_SCOPE_SYSTEM);
-
-			g_hash_table_insert (de_cpt_table,
-					     g_path_get_basename (fname),
-					     g_object_ref (cpt));
-		}
+		if (cpt != NULL)
+			helper->results[idx] = g_object_ref (cpt);
 	}
+
+	return NULL;
 }
 
 /**
- * as_pool_load_metainfo_data:
+ * as_pool_parse_files_parallel:
  *
- * Load metadata from locally installed metainfo files.
+ * Parse all given metadata files with a bounded worker pool, filling @results
+ * (which must have as many entries as @fnames) with the parsed components.
+ * File order is preserved, so the postprocessing results are identical to a
+ * serial parse.
  */
 static void
-as_pool_load_metainfo_data (AsPool *pool,
-			    AsComponentRegistry *registry,
-			    GHashTable *desktop_entry_cpts,
-			    AsComponentScope scope,
-			    const gchar *metainfo_dir,
-			    const gchar *cache_key)
+as_pool_parse_files_parallel (AsPool *pool,
+			      GPtrArray *fnames,
+			      AsComponent **results,
+			      AsFormatKind format_kind)
 {
 	AsPoolPrivate *priv = GET_PRIVATE (pool);
-	g_autoptr(AsMetadata) metad = NULL;
-	g_autoptr(GPtrArray) mi_files = NULL;
-	g_autoptr(AsProfileTask) ptask = NULL;
-	GError *error = NULL;
-
-	/* NOTE: Write-lock is held by the caller. */
-
-	ptask = as_profile_start (priv->profile, "AsPool:load_metainfo_data:%s", cache_key);
-
-	/* prepare metadata parser */
-	metad = as_metadata_new ();
-	as_metadata_set_locale (metad, priv->locale_bcp47);
-
-	/* find metainfo files */
-	g_debug ("Searching for data in: %s", metainfo_dir);
-	mi_files = as_utils_find_files_matching (metainfo_dir, "*.xml", FALSE, NULL);
-	if (mi_files == NULL) {
-		g_debug ("Unable find metainfo files.");
+	AsPoolParseHelper helper;
+	g_autofree GThread **threads = NULL;
+	guint n_threads;
+
+	helper.fnames = fnames;
+	helper.results = results;
+	helper.locale_bcp47 = priv->locale_bcp47;
+	helper.format_kind = format_kind;
+	helper.strict_locale = as_flags_contains (priv->flags, AS_POOL_FLAG_STRICT_LOCALE);
+	helper.load_kinds = priv->load_kinds;
+	helper.next_index = 0;
+
+	/* there is no point in spawning threads for a handful of files */
+	n_threads = MIN (g_get_num_processors (), fnames->len / 8);
+	if (n_threads <= 1) {
+		as_pool_parse_files_worker (&helper);
 		return;
 	}
 
-	/* parse the found data */
-	for (guint i = 0; i < mi_files->len; i++) {
-		AsComponent *cpt;
-		AsLaunchable *launchable;
-		g_autoptr(GFile) infile = NULL;
-		g_autofree gchar *desktop_id = NULL;
+	threads = g_new0 (GThread *, n_threads);
+	for (guint i = 0; i < n_threads; i++)
+		threads[i] = g_thread_new ("pool-parse", as_pool_parse_files_worker, &helper);
+	for (guint i = 0; i < n_threads; i++)
+		g_thread_join (threads[i]);
+}
+
+/**
+ * as_pool_desktop_entry_index_remove:
+ *
+ * Drop a desktop-entry component from the join index, removing both its
+ * full and suffix-stripped ID keys.
+ */
+static void
+as_pool_desktop_entry_index_remove (GHashTable *de_cpt_table, const gchar *desktop_id)
+{
+	g_hash_table_remove (de_cpt_table, desktop_id);
+	if (g_str_has_suffix (desktop_id, ".desktop")) {
+		g_autofree gchar *alias = g_strndup (desktop_id,
+						     strlen (desktop_id) - strlen (".desktop"));
+		g_hash_table_remove (de_cpt_table, alias);
+	} else {
+		g_autofree gchar *full_id = g_strconcat (desktop_id, ".desktop", NULL);
+		g_hash_table_remove (de_cpt_table, full_id);
+	}
+}
+
+/**
+ * as_pool_update_desktop_entries_table:
+ *
+ * Load metadata from desktop-entry files and register the components in the
+ * desktop-entry join index.
+ */
+static void
+as_pool_update_desktop_entries_table (AsPool *pool, GHashTable *de_cpt_table, const gchar *apps_dir)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GPtrArray) de_files = NULL;
+	g_autofree AsComponent **parsed_cpts = NULL;
+	g_autoptr(AsProfileTask) ptask = NULL;
+
+	ptask = as_profile_start_literal (priv->profile, "AsPool:get_desktop_entries_table");
+
+	/* find .desktop files */
+	g_debug ("Searching for data in: %s", apps_dir);
+	de_files = as_utils_find_files_matching (apps_dir, "*.desktop", FALSE, NULL);
+	if (de_files == NULL) {
+		g_debug ("Unable find desktop-entry files in '%s'.", apps_dir);
+		return;
+	}
+
+	/* parse the found data */
+	parsed_cpts = g_new0 (AsComponent *, de_files->len);
+	as_pool_parse_files_parallel (pool, de_files, parsed_cpts, AS_FORMAT_KIND_DESKTOP_ENTRY);
+
+	for (guint i = 0; i < de_files->len; i++) {
+		AsComponent *cpt = parsed_cpts[i];
+		const gchar *fname = (const gchar *) g_ptr_array_index (de_files, i);
+		gchar *de_id;
+
+		if (cpt == NULL)
+			continue;
+
+		/* we only read metainfo files from system directories */
+		as_component_set_scope (cpt, AS_COMPONENT_SCOPE_SYSTEM);
+
+		de_id = g_path_get_basename (fname);
+		g_hash_table_insert (de_cpt_table, de_id, cpt /* transfer ownership */);
+
+		/* also index the ID with its .desktop suffix stripped, so the
+		 * metainfo components can be joined against this table without
+		 * having to construct any candidate strings per component */
+		g_hash_table_insert (de_cpt_table,
+				     g_strndup (de_id, strlen (de_id) - strlen (".desktop")),
+				     g_object_ref (cpt));
+	}
+}
+
+/**
+ * as_pool_load_metainfo_data:
+ *
+ * Load metadata from locally installed metainfo files.
+ */
+static void
+as_pool_load_metainfo_data (AsPool *pool,
+			    AsComponentRegistry *registry,
+			    GHashTable *desktop_entry_cpts,
+			    AsComponentScope scope,
+			    const gchar *metainfo_dir,
+			    const gchar *cache_key)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GPtrArray) mi_files = NULL;
+	g_autoptr(GPtrArray) load_fnames = NULL;
+	g_autofree AsComponent **parsed_cpts = NULL;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	GError *error = NULL;
+
+	/* NOTE: Caller holds the pool writer lock, or a reader lock plus the
+	 * reload mutex (background section reloads). */
+
+	ptask = as_profile_start (priv->profile, "AsPool:load_metainfo_data:%s", cache_key);
+
+	/* find metainfo files */
+	g_debug ("Searching for data in: %s", metainfo_dir);
+	mi_files = as_utils_find_files_matching (metainfo_dir, "*.xml", FALSE, NULL);
+	if (mi_files == NULL) {
+		g_debug ("Unable find metainfo files.");
+		return;
+	}
+
+	/* filter out files for components that we already know,
+	 * so we do not even need to parse them */
+	load_fnames = g_ptr_array_new_with_free_func (g_free);
+	for (guint i = 0; i < mi_files->len; i++) {
 		const gchar *fname = (const gchar *) g_ptr_array_index (mi_files, i);
 
 		if (!as_flags_contains (priv->flags, AS_POOL_FLAG_PREFER_OS_METAINFO)) {
@@ -1340,25 +2008,30 @@ as_pool_load_metainfo_data (AsPool *pool,
 			}
 		}
 
-		g_debug ("Reading: %s", fname);
-		infile = g_file_new_for_path (fname);
-		if (!g_file_query_exists (infile, NULL)) {
-			g_warning ("Metadata file '%s' does not exist.", fname);
-			continue;
-		}
+		g_ptr_array_add (load_fnames, g_strdup (fname));
+	}
 
-		as_metadata_clear_components (metad);
-		as_metadata_parse_file (metad, infile, AS_FORMAT_KIND_UNKNOWN, &error);
-		if (error != NULL) {
-			g_debug ("Errors in '%s': %s", fname, error->message);
-			g_error_free (error);
-			error = NULL;
-		}
+	/* parse the found data in parallel */
+	parsed_cpts = g_new0 (AsComponent *, load_fnames->len);
+	as_pool_parse_files_parallel (pool, load_fnames, parsed_cpts, AS_FORMAT_KIND_UNKNOWN);
+
+	/* register the parsed components in file order */
+	for (guint i = 0; i < load_fnames->len; i++) {
+		AsLaunchable *launchable;
+		g_autoptr(AsComponent) cpt = parsed_cpts[i];
+		const gchar *desktop_id = NULL;
 
-		cpt = as_metadata_get_component (metad);
 		if (cpt == NULL)
 			continue;
 
+		/* an earlier file of this batch may have registered the same component ID */
+		if (!as_flags_contains (priv->flags, AS_POOL_FLAG_PREFER_OS_METAINFO) &&
+		    as_component_registry_has_cid (registry, as_component_get_id (cpt))) {
+			g_debug ("Skipped: %s (already known)",
+				 (const gchar *) g_ptr_array_index (load_fnames, i));
+			continue;
+		}
+
 		/* set scope of these metainfo files */
 		as_component_set_scope (cpt, scope);
 
@@ -1369,15 +2042,12 @@ as_pool_load_metainfo_data (AsPool *pool,
 		launchable = as_component_get_launchable (cpt, AS_LAUNCHABLE_KIND_DESKTOP_ID);
 		if ((launchable != NULL) && (as_launchable_get_entries (launchable)->len > 0)) {
 			/* find matching .desktop component to merge with via launchable */
-			desktop_id = g_strdup (
-			    g_ptr_array_index (as_launchable_get_entries (launchable), 0));
+			desktop_id = g_ptr_array_index (as_launchable_get_entries (launchable), 0);
 		} else {
-			/* try to guess the matching .desktop ID from the component-id */
-			if (g_str_has_suffix (as_component_get_id (cpt), ".desktop"))
-				desktop_id = g_strdup (as_component_get_id (cpt));
-			else
-				desktop_id = g_strdup_printf ("%s.desktop",
-							      as_component_get_id (cpt));
+			/* guess the matching .desktop ID from the component-id - the join
+			 * index contains the IDs with and without their .desktop suffix,
+			 * so no candidate strings need to be built here */
+			desktop_id = as_component_get_id (cpt);
 		}
 
 		/* merge .desktop data into component if possible */
@@ -1386,7 +2056,8 @@ as_pool_load_metainfo_data (AsPool *pool,
 			de_cpt = g_hash_table_lookup (desktop_entry_cpts, desktop_id);
 			if (de_cpt != NULL) {
 				as_component_merge_with_mode (cpt, de_cpt, AS_MERGE_KIND_APPEND);
-				g_hash_table_remove (desktop_entry_cpts, desktop_id);
+				as_pool_desktop_entry_index_remove (desktop_entry_cpts,
+								    desktop_id);
 			}
 		}
 
@@ -1417,7 +2088,8 @@ as_pool_process_metainfo_desktop_data (AsPool *pool,
 	g_autoptr(GHashTable) de_cpts = NULL;
 	g_autoptr(AsProfileTask) ptask = NULL;
 
-	/* NOTE: Write-lock is held by the caller. */
+	/* NOTE: Caller holds the pool writer lock, or a reader lock plus the
+	 * reload mutex (background section reloads). */
 
 	/* check if we actually need to load anything */
 	if (!as_flags_contains (priv->flags, AS_POOL_FLAG_LOAD_OS_DESKTOP_FILES) &&
@@ -1465,13 +2137,19 @@ as_pool_process_metainfo_desktop_data (AsPool *pool,
 	if (as_flags_contains (priv->flags, AS_POOL_FLAG_LOAD_OS_DESKTOP_FILES)) {
 		GHashTableIter iter;
 		gpointer value;
+		g_autoptr(GHashTable) seen_cpts = NULL;
 		GError *error = NULL;
 
 		g_debug ("Adding components from desktop-entry files to the metadata pool.");
+		seen_cpts = g_hash_table_new (NULL, NULL);
 		g_hash_table_iter_init (&iter, de_cpts);
 		while (g_hash_table_iter_next (&iter, NULL, &value)) {
 			AsComponent *cpt = AS_COMPONENT (value);
 
+			/* the join index registers each component under multiple keys */
+			if (!g_hash_table_add (seen_cpts, cpt))
+				continue;
+
 			as_pool_add_component_internal (pool, registry, cpt, FALSE, &error);
 			if (error != NULL) {
 				g_debug ("Ignored component '%s': %s",
@@ -1485,17 +2163,51 @@ as_pool_process_metainfo_desktop_data (AsPool *pool,
 }
 
 /**
- * as_pool_get_ctime:
+ * as_location_group_compute_fingerprint:
  *
- * Returns: The changed time of a location.
+ * Compute a fingerprint over the names, sizes and modification times of all
+ * source files of this location group. The fingerprint changes if - and only
+ * if - the input data of the location group changed, so we can use it to skip
+ * recompiling cache sections whose inputs are unmodified.
  */
-static time_t
-as_get_location_ctime (const gchar *location)
+static gchar *
+as_location_group_compute_fingerprint (AsLocationGroup *lgroup)
 {
-	struct stat sb;
-	if (stat (location, &sb) < 0)
-		return 0;
-	return sb.st_ctime;
+	g_autoptr(GChecksum) cs = g_checksum_new (G_CHECKSUM_SHA1);
+
+	for (guint i = 0; i < lgroup->locations->len; i++) {
+		AsLocationEntry *lentry = (AsLocationEntry *) g_ptr_array_index (lgroup->locations,
+										 i);
+		g_autoptr(GDir) dir = NULL;
+		const gchar *fname = NULL;
+		struct stat sb;
+
+		g_checksum_update (cs, (const guchar *) lentry->location, -1);
+
+		dir = g_dir_open (lentry->location, 0, NULL);
+		if (dir == NULL) {
+			/* location may also be a plain file, or not exist at all */
+			if (stat (lentry->location, &sb) == 0)
+				g_checksum_update (cs, (const guchar *) &sb.st_mtime, sizeof(sb.st_mtime));
+			continue;
+		}
+
+		while ((fname = g_dir_read_name (dir)) != NULL) {
+			g_autofree gchar *path = g_build_filename (lentry->location, fname, NULL);
+
+			g_checksum_update (cs, (const guchar *) fname, -1);
+			if (stat (path, &sb) == 0) {
+				g_checksum_update (cs,
+						   (const guchar *) &sb.st_mtime,
+						   sizeof(sb.st_mtime));
+				g_checksum_update (cs,
+						   (const guchar *) &sb.st_size,
+						   sizeof(sb.st_size));
+			}
+		}
+	}
+
+	return g_strdup (g_checksum_get_string (cs));
 }
 
 /**
@@ -1514,52 +2226,68 @@ as_pool_loader_process_group (AsPool *pool,
 	AsPoolPrivate *priv = GET_PRIVATE (pool);
 	g_autoptr(AsComponentRegistry) registry = NULL;
 	g_autoptr(GPtrArray) final_results = NULL;
-	time_t cache_time;
+	g_autofree gchar *fingerprint = NULL;
+	g_autofree gchar *section_key = NULL;
+	g_autofree const gchar **locations = NULL;
 	gboolean cache_outdated = FALSE;
 	gboolean ret;
 
-	/* NOTE: Write-lock is held by the caller. */
+	/* NOTE: Caller holds the pool writer lock, or a reader lock plus the
+	 * reload mutex (background section reloads). */
 
 	if (lgroup->locations->len == 0)
 		return TRUE;
 
+	/* sections compiled with a load-kind filter are stored under their own key */
+	section_key = as_pool_build_section_cache_key (pool, lgroup->cache_key);
+
+	/* fingerprint of the current input data of this group, to detect whether the
+	 * existing cache section was built from the exact same data.
+	 * If the generation manifest shows that no source location changed since the
+	 * fingerprint was last computed, we reuse the recorded value and avoid
+	 * enumerating (and stat'ing) every single source file at session start. */
+	locations = g_new0 (const gchar *, lgroup->locations->len + 1);
+	for (guint i = 0; i < lgroup->locations->len; i++) {
+		AsLocationEntry *lentry = (AsLocationEntry *) g_ptr_array_index (lgroup->locations,
+										 i);
+		locations[i] = lentry->location;
+	}
+	fingerprint = as_cache_generation_check_sources (priv->cache,
+							 lgroup->scope,
+							 section_key,
+							 locations);
+	if (fingerprint == NULL) {
+		fingerprint = as_location_group_compute_fingerprint (lgroup);
+		as_cache_generation_update_sources (priv->cache,
+						    lgroup->scope,
+						    section_key,
+						    locations,
+						    fingerprint);
+	}
+
 	/* first check if we can load cache data */
 	if (!force_cache_refresh &&
 	    !as_flags_contains (priv->flags, AS_POOL_FLAG_IGNORE_CACHE_AGE)) {
-		cache_time = as_cache_get_ctime (priv->cache,
-						 lgroup->scope,
-						 lgroup->cache_key,
-						 NULL);
-		for (guint i = 0; i < lgroup->locations->len; i++) {
-			AsLocationEntry *lentry = (AsLocationEntry *) g_ptr_array_index (
-			    lgroup->locations,
-			    i);
-			if (as_get_location_ctime (lentry->location) > cache_time) {
-				cache_outdated = TRUE;
-				break;
-			}
-		}
-
+		/* the cache will verify the fingerprint and refuse to load the section
+		 * if the input data changed since the section was compiled */
+		g_debug ("Using cached metadata (if valid): %s", section_key);
+		as_cache_load_section_for_key (priv->cache,
+					       lgroup->scope,
+					       lgroup->format_style,
+					       lgroup->is_os_data,
+					       section_key,
+					       fingerprint,
+					       &cache_outdated,
+					       lgroup);
 		if (!cache_outdated) {
-			/* cache is not out of data, let's use it! */
-			g_debug ("Using cached metadata: %s", lgroup->cache_key);
-			as_cache_load_section_for_key (priv->cache,
-						       lgroup->scope,
-						       lgroup->format_style,
-						       lgroup->is_os_data,
-						       lgroup->cache_key,
-						       &cache_outdated,
-						       lgroup);
-			if (!cache_outdated) {
-				/* cache was fine and is now loaded, we are done here */
-				return TRUE;
-			}
-			/* if we are here, the cache either went out of date (e.g. by being removed)
-			* or loading failed, in which case we will just regenerate it */
-			g_debug ("Failed to load cache metadata for '%s' or cache suddenly went "
-				 "out of data. Regenerating cache.",
-				 lgroup->cache_key);
+			/* cache was fine and is now loaded, we are done here */
+			return TRUE;
 		}
+		/* if we are here, the cache either went out of date (e.g. by its input
+		 * files changing or by being removed) or loading failed, in which case
+		 * we will just regenerate it */
+		g_debug ("Cache metadata for '%s' missing or out of date. Regenerating cache.",
+			 section_key);
 	}
 
 	/* container for the generated components */
@@ -1578,7 +2306,8 @@ as_pool_loader_process_group (AsPool *pool,
 						 lgroup->format_style,
 						 lgroup->is_os_data,
 						 final_results,
-						 lgroup->cache_key,
+						 section_key,
+						 fingerprint,
 						 lgroup,
 						 error);
 	if (!ret)
@@ -1591,6 +2320,125 @@ as_pool_loader_process_group (AsPool *pool,
 	return TRUE;
 }
 
+typedef struct {
+	AsPool *pool;
+	AsLocationGroup *lgroup;
+	gboolean force_cache_refresh;
+
+	gboolean ret;
+	gboolean caches_updated;
+	GError *error;
+} AsLoadGroupTask;
+
+static void
+as_load_group_task_free (AsLoadGroupTask *ltask)
+{
+	if (ltask->error != NULL)
+		g_error_free (ltask->error);
+	g_free (ltask);
+}
+
+/**
+ * as_pool_loader_process_group_thread:
+ *
+ * Process a single location group on a worker thread.
+ */
+static void
+as_pool_loader_process_group_thread (gpointer task_data, gpointer user_data)
+{
+	AsLoadGroupTask *ltask = task_data;
+
+	ltask->ret = as_pool_loader_process_group (ltask->pool,
+						   ltask->lgroup,
+						   ltask->force_cache_refresh,
+						   &ltask->caches_updated,
+						   &ltask->error);
+}
+
+/**
+ * as_pool_loader_process_groups:
+ *
+ * Process all given location groups, by reading their source files or loading
+ * a suitable cache section for them.
+ * Since the groups are independent of each other, they are loaded in parallel
+ * on a worker pool if we have more than one group to process.
+ */
+static gboolean
+as_pool_loader_process_groups (AsPool *pool,
+			       GPtrArray *lgroups,
+			       gboolean force_cache_refresh,
+			       gboolean *caches_updated,
+			       GError **error)
+{
+	g_autoptr(GPtrArray) tasks = NULL;
+	GThreadPool *tpool;
+	g_autoptr(GError) tpool_error = NULL;
+	gboolean ret = TRUE;
+
+	/* NOTE: Caller holds the pool writer lock, or a reader lock plus the
+	 * reload mutex (background section reloads). */
+
+	if (lgroups->len == 0)
+		return TRUE;
+
+	/* fast path: nothing to parallelize if there is only one group */
+	if (lgroups->len == 1)
+		return as_pool_loader_process_group (pool,
+						     g_ptr_array_index (lgroups, 0),
+						     force_cache_refresh,
+						     caches_updated,
+						     error);
+
+	tpool = g_thread_pool_new (as_pool_loader_process_group_thread,
+				   NULL,
+				   (gint) MIN (g_get_num_processors (), lgroups->len),
+				   FALSE,
+				   &tpool_error);
+	if (tpool == NULL) {
+		/* creating the worker pool should never fail, but if it does we just load serially */
+		g_warning ("Unable to create worker pool for metadata loading: %s",
+			   tpool_error->message);
+		for (guint i = 0; i < lgroups->len; i++) {
+			if (!as_pool_loader_process_group (pool,
+							   g_ptr_array_index (lgroups, i),
+							   force_cache_refresh,
+							   caches_updated,
+							   error))
+				return FALSE;
+		}
+		return TRUE;
+	}
+
+	tasks = g_ptr_array_new_with_free_func ((GDestroyNotify) as_load_group_task_free);
+	for (guint i = 0; i < lgroups->len; i++) {
+		AsLoadGroupTask *ltask = g_new0 (AsLoadGroupTask, 1);
+		ltask->pool = pool;
+		ltask->lgroup = g_ptr_array_index (lgroups, i);
+		ltask->force_cache_refresh = force_cache_refresh;
+		ltask->ret = TRUE;
+
+		g_ptr_array_add (tasks, ltask);
+		g_thread_pool_push (tpool, ltask, NULL);
+	}
+
+	/* wait for all workers to finish */
+	g_thread_pool_free (tpool, FALSE, TRUE);
+
+	/* merge results, the first error wins */
+	for (guint i = 0; i < tasks->len; i++) {
+		AsLoadGroupTask *ltask = g_ptr_array_index (tasks, i);
+
+		if (ltask->caches_updated && caches_updated != NULL)
+			*caches_updated = TRUE;
+		if (!ltask->ret && ret) {
+			ret = FALSE;
+			g_propagate_error (error, g_steal_pointer (&ltask->error));
+		}
+	}
+
+	return ret;
+}
+
 /**
  * as_pool_load_internal:
  *
@@ -1609,6 +2457,10 @@ as_pool_load_internal (AsPool *pool,
 	g_autoptr(AsProfileTask) ptask = NULL;
 	GHashTableIter loc_iter;
 	gpointer loc_value;
+	g_autoptr(GPtrArray) lgroups = NULL;
+	g_autoptr(GPtrArray) os_groups = NULL;
+	g_autoptr(GPtrArray) extra_groups = NULL;
+	gboolean staged;
 	gboolean ret = TRUE;
 	g_autoptr(GRWLockWriterLocker) locker = NULL;
 
@@ -1624,6 +2476,14 @@ as_pool_load_internal (AsPool *pool,
 	as_cache_set_prefer_os_metainfo (
 	    priv->cache,
 	    as_flags_contains (priv->flags, AS_POOL_FLAG_PREFER_OS_METAINFO));
+	as_cache_set_locale_strict (priv->cache,
+				    as_flags_contains (priv->flags, AS_POOL_FLAG_STRICT_LOCALE));
+	as_cache_set_throttled (priv->cache,
+				as_flags_contains (priv->flags, AS_POOL_FLAG_THROTTLE_REFRESH));
+
+	/* allow the cache to cancel section compilation cooperatively, so a cancelled
+	 * load does not have to wait for a potentially expensive cache refresh */
+	as_cache_set_cancellable (priv->cache, cancellable);
 
 	/* prune any ancient data from the cache that has not been used for a long time */
 	as_cache_prune_data (priv->cache);
@@ -1634,31 +2494,93 @@ as_pool_load_internal (AsPool *pool,
 	if (caches_updated != NULL)
 		*caches_updated = FALSE;
 
-	/* process data from all the individual metadata silos in known locations */
+	/* collect all metadata silos in known and user-defined locations */
+	lgroups = g_ptr_array_new ();
 	g_hash_table_iter_init (&loc_iter, priv->std_data_locations);
-	while (g_hash_table_iter_next (&loc_iter, NULL, &loc_value)) {
-		ret = as_pool_loader_process_group (pool,
-						    loc_value,
-						    force_cache_refresh,
-						    caches_updated,
-						    error);
-		/* cache writing errors or other fatal stuff will cause us to stop loading anything */
-		if (!ret)
-			return FALSE;
+	while (g_hash_table_iter_next (&loc_iter, NULL, &loc_value))
+		g_ptr_array_add (lgroups, loc_value);
+	g_hash_table_iter_init (&loc_iter, priv->extra_data_locations);
+	while (g_hash_table_iter_next (&loc_iter, NULL, &loc_value))
+		g_ptr_array_add (lgroups, loc_value);
+
+	/* mark cached icon-directory listings as stale, so they are revalidated
+	 * against the on-disk state once per load */
+	for (guint i = 0; i < lgroups->len; i++) {
+		AsLocationGroup *lgroup = g_ptr_array_index (lgroups, i);
+		as_icon_dir_index_invalidate (lgroup->icon_index);
 	}
 
-	/* process data in user-defined locations */
-	g_hash_table_iter_init (&loc_iter, priv->extra_data_locations);
-	while (g_hash_table_iter_next (&loc_iter, NULL, &loc_value)) {
-		ret = as_pool_loader_process_group (pool,
-						    loc_value,
+	/* in a staged load, the (usually cached and thus fast) OS data is made queryable
+	 * first, and external sections like Flatpak remotes are merged in afterwards */
+	staged = as_flags_contains (priv->flags, AS_POOL_FLAG_STAGED_LOAD);
+	if (staged) {
+		os_groups = g_ptr_array_new ();
+		extra_groups = g_ptr_array_new ();
+		for (guint i = 0; i < lgroups->len; i++) {
+			AsLocationGroup *lgroup = g_ptr_array_index (lgroups, i);
+			if (lgroup->is_os_data)
+				g_ptr_array_add (os_groups, lgroup);
+			else
+				g_ptr_array_add (extra_groups, lgroup);
+		}
+
+		/* staging is pointless if there is nothing to defer */
+		if (os_groups->len == 0 || extra_groups->len == 0)
+			staged = FALSE;
+	}
+
+	if (!staged) {
+		/* process data from all the individual metadata silos in parallel
+		 * (cache writing errors or other fatal stuff will cause us to fail the load) */
+		ret = as_pool_loader_process_groups (pool,
+						     lgroups,
+						     force_cache_refresh,
+						     caches_updated,
+						     error);
+
+		return ret;
+	}
+
+	/* first stage: load the OS data */
+	ret = as_pool_loader_process_groups (pool,
+					     os_groups,
+					     force_cache_refresh,
+					     caches_updated,
+					     error);
+
+	/* unlock the pool and notify listeners, so queries can already be
+	 * answered from the OS data while the remaining sections load */
+	g_clear_pointer (&locker, g_rw_lock_writer_locker_free);
+	g_debug ("Emitting Pool::changed() for staged load, OS data is available");
+	g_signal_emit (pool, signals[SIGNAL_CHANGED], 0);
+
+	/* second stage: merge in the external sections. Like for background section
+	 * reloads, a reader lock is sufficient here: each section is compiled off to
+	 * the side and published by the cache with an atomic registry swap under its
+	 * own lock, so concurrent queries keep working while we merge. */
+	{
+		g_autoptr(GMutexLocker) reload_locker = g_mutex_locker_new (&priv->reload_mutex);
+		g_autoptr(GRWLockReaderLocker) reader_locker = g_rw_lock_reader_locker_new (
+		    &priv->rw_lock);
+		g_autoptr(GError) stage_error = NULL;
+
+		if (!as_pool_loader_process_groups (pool,
+						    extra_groups,
 						    force_cache_refresh,
 						    caches_updated,
-						    error);
-		if (!ret)
-			return FALSE;
+						    &stage_error) &&
+		    ret) {
+			ret = FALSE;
+			g_propagate_error (error, g_steal_pointer (&stage_error));
+		}
+
+		/* drop any memoized search results, they may miss the new sections */
+		as_pool_invalidate_memoized_searches (pool);
 	}
 
+	g_debug ("Emitting Pool::changed() for staged load, all data is available");
+	g_signal_emit (pool, signals[SIGNAL_CHANGED], 0);
+
 	return ret;
 }
 
@@ -1750,80 +2672,368 @@ as_pool_load_finish (AsPool *pool, GAsyncResult *result, GError **error)
 }
 
 /**
- * as_pool_section_reload_thread:
+ * as_pool_loader_update_group_for_files:
+ *
+ * Patch a small set of changed metadata files into the already loaded
+ * data of a location group, instead of reprocessing every file in it.
+ *
+ * Returns: %FALSE if the incremental update could not be performed and
+ * the whole group needs to be processed again.
  */
-static void
-as_pool_section_reload_thread (GTask *task,
-			       gpointer source_object,
-			       gpointer task_data,
-			       GCancellable *cancellable)
+static gboolean
+as_pool_loader_update_group_for_files (AsPool *pool,
+				       AsLocationGroup *lgroup,
+				       GPtrArray *changed_files,
+				       GError **error)
 {
-	AsPool *pool = AS_POOL (source_object);
 	AsPoolPrivate *priv = GET_PRIVATE (pool);
-	AsLocationGroup *lgroup = task_data;
-	g_autoptr(GError) error = NULL;
-	gboolean ret;
-	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
-
-	ret = as_pool_loader_process_group (
-	    pool,
-	    lgroup,
-	    TRUE, /* always refresh cache, don't bother verifying timestamps */
-	    NULL,
-	    &error);
-	if (!ret)
-		g_warning ("Failed to auto-reload cache section %s: %s",
-			   lgroup->cache_key,
-			   error->message);
+	g_autoptr(AsComponentRegistry) registry = NULL;
+	g_autoptr(AsMetadata) metad = NULL;
+	g_autoptr(AsComponentBox) loaded_cpts = NULL;
+	g_autoptr(GHashTable) replaced_cids = NULL;
+	g_autoptr(GPtrArray) new_cpts = NULL;
+	g_autoptr(GPtrArray) final_results = NULL;
+	g_autofree gchar *fingerprint = NULL;
+	g_autofree gchar *section_key = NULL;
+	g_autoptr(GError) tmp_error = NULL;
 
-	g_debug ("Emitting Pool::changed() [%s]", ret ? "success" : "failure");
-	g_signal_emit (pool, signals[SIGNAL_CHANGED], 0);
+	/* NOTE: Caller holds the pool writer lock, or a reader lock plus the
+	 * reload mutex (background section reloads). */
+
+	/* we can only patch individual files into catalog-style data: metainfo files
+	 * need their matching desktop-entry files resolved, which requires a look at
+	 * the whole group */
+	if (lgroup->format_style != AS_FORMAT_STYLE_CATALOG) {
+		g_set_error (error,
+			     AS_POOL_ERROR,
+			     AS_POOL_ERROR_FAILED,
+			     "Group '%s' does not contain catalog data.",
+			     lgroup->cache_key);
+		return FALSE;
+	}
 
-	g_task_return_boolean (task, TRUE);
-}
+	/* grab all components which are currently loaded for this group - if its
+	 * cache section does not exist yet, there is nothing we could patch */
+	section_key = as_pool_build_section_cache_key (pool, lgroup->cache_key);
+	loaded_cpts = as_cache_get_components_for_key (priv->cache, section_key, error);
+	if (loaded_cpts == NULL)
+		return FALSE;
 
-/**
- * as_pool_process_pending_reload_cb:
- *
- * Process a background reload for a specific location group.
- */
-static gboolean
-as_pool_process_pending_reload_cb (gpointer user_data)
-{
-	AsLocationGroup *lgroup = user_data;
-	AsPoolPrivate *priv = GET_PRIVATE (AS_POOL (lgroup->owner));
-	g_autoptr(GTask) task = NULL;
+	/* component-IDs which the changed files used to contain, or contain now - any
+	 * loaded component with one of these IDs is dropped and replaced by fresh data */
+	replaced_cids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 
-	priv->pending_id = 0;
-	g_debug ("Auto-reload of cache for %s due to source data changes.", lgroup->cache_key);
+	/* prepare metadata parser */
+	metad = as_metadata_new ();
+	as_metadata_set_format_style (metad, AS_FORMAT_STYLE_CATALOG);
+	as_metadata_set_locale (metad, priv->locale_bcp47);
+	if (as_flags_contains (priv->flags, AS_POOL_FLAG_STRICT_LOCALE))
+		as_metadata_set_parse_flags (metad, AS_PARSE_FLAG_STRICT_LOCALE);
+	as_pool_metadata_apply_load_kinds (metad, priv->load_kinds);
+
+	/* parse only the files which have actually changed */
+	new_cpts = g_ptr_array_new_with_free_func (g_object_unref);
+	for (guint i = 0; i < changed_files->len; i++) {
+		const gchar *fname = (const gchar *) g_ptr_array_index (changed_files, i);
+		GPtrArray *prev_cids;
+		g_autoptr(GPtrArray) file_cids = NULL;
+		g_autoptr(GFile) infile = NULL;
+		AsComponentBox *cbox;
+
+		/* delta catalogs can not be applied in isolation, as they need their
+		 * base catalog files registered first */
+		if (as_pool_fname_is_delta_catalog (fname)) {
+			g_set_error (error,
+				     AS_POOL_ERROR,
+				     AS_POOL_ERROR_FAILED,
+				     "'%s' is a delta catalog.",
+				     fname);
+			return FALSE;
+		}
 
-	task = g_task_new (lgroup->owner, NULL, NULL, NULL);
-	g_task_set_task_data (task, lgroup, NULL);
-	g_task_run_in_thread (task, as_pool_section_reload_thread);
+		/* drop everything the previous version of this file contained */
+		prev_cids = g_hash_table_lookup (lgroup->file_cpts_map, fname);
+		if (prev_cids != NULL) {
+			for (guint j = 0; j < prev_cids->len; j++)
+				g_hash_table_add (
+				    replaced_cids,
+				    g_strdup ((const gchar *) g_ptr_array_index (prev_cids, j)));
+		}
 
-	return FALSE;
+		if (!g_file_test (fname, G_FILE_TEST_IS_REGULAR)) {
+			/* the file is gone - that is fine if we knew its previous contents,
+			 * otherwise the whole group needs to be read again */
+			if (!g_hash_table_remove (lgroup->file_cpts_map, fname)) {
+				g_set_error (error,
+					     AS_POOL_ERROR,
+					     AS_POOL_ERROR_FAILED,
+					     "Vanished file '%s' has unknown contents.",
+					     fname);
+				return FALSE;
+			}
+			continue;
+		}
+
+		g_debug ("Reading for incremental update: %s", fname);
+		infile = g_file_new_for_path (fname);
+		as_metadata_clear_components (metad);
+		if (!as_metadata_parse_file (metad, infile, AS_FORMAT_KIND_UNKNOWN, error))
+			return FALSE;
+
+		cbox = as_metadata_get_components (metad);
+		file_cids = g_ptr_array_new_with_free_func (g_free);
+		for (guint j = 0; j < as_component_box_len (cbox); j++) {
+			AsComponent *cpt = as_component_box_index (cbox, j);
+
+			/* merge components modify other components with matching IDs, so
+			 * applying them incrementally would merge the same data twice */
+			if (as_component_get_merge_kind (cpt) != AS_MERGE_KIND_NONE) {
+				g_set_error (error,
+					     AS_POOL_ERROR,
+					     AS_POOL_ERROR_FAILED,
+					     "'%s' contains merge components.",
+					     fname);
+				return FALSE;
+			}
+
+			g_hash_table_add (replaced_cids, g_strdup (as_component_get_id (cpt)));
+			g_ptr_array_add (file_cids, g_strdup (as_component_get_id (cpt)));
+			g_ptr_array_add (new_cpts, g_object_ref (cpt));
+		}
+
+		/* remember what this file contains now, so we can drop the right
+		 * components once it changes again or is removed */
+		g_hash_table_insert (lgroup->file_cpts_map,
+				     g_strdup (fname),
+				     g_steal_pointer (&file_cids));
+	}
+
+	/* keep all loaded components which were not affected by the change */
+	registry = as_component_registry_new ();
+	for (guint i = 0; i < as_component_box_len (loaded_cpts); i++) {
+		AsComponent *cpt = as_component_box_index (loaded_cpts, i);
+		if (g_hash_table_contains (replaced_cids, as_component_get_id (cpt)))
+			continue;
+		as_component_registry_add (registry, cpt);
+	}
+
+	/* add the new data to the patched set */
+	for (guint i = 0; i < new_cpts->len; i++) {
+		AsComponent *cpt = AS_COMPONENT (g_ptr_array_index (new_cpts, i));
+
+		as_component_set_scope (cpt, lgroup->scope);
+		as_pool_add_component_internal (pool, registry, cpt, TRUE, &tmp_error);
+		if (tmp_error != NULL) {
+			g_debug ("Metadata ignored on incremental update: %s",
+				 tmp_error->message);
+			g_clear_pointer (&tmp_error, g_error_free);
+		}
+	}
+
+	/* replace the cache section with the patched data */
+	final_results = as_component_registry_get_contents (registry);
+	fingerprint = as_location_group_compute_fingerprint (lgroup);
+	g_debug ("Incrementally updating section %s: %u changed file(s), %u components",
+		 section_key,
+		 changed_files->len,
+		 final_results->len);
+	return as_cache_set_contents_for_section (priv->cache,
+						  lgroup->scope,
+						  lgroup->format_style,
+						  lgroup->is_os_data,
+						  final_results,
+						  section_key,
+						  fingerprint,
+						  lgroup,
+						  error);
+}
+
+typedef struct {
+	AsLocationGroup *lgroup;
+	GPtrArray *changed_files; /* files to patch in, or %NULL for a full reload */
+} AsSectionReloadRequest;
+
+static void
+as_section_reload_request_free (AsSectionReloadRequest *rlreq)
+{
+	if (rlreq->changed_files != NULL)
+		g_ptr_array_unref (rlreq->changed_files);
+	g_free (rlreq);
+}
+
+/**
+ * as_pool_section_reload_thread:
+ */
+static void
+as_pool_section_reload_thread (GTask *task,
+			       gpointer source_object,
+			       gpointer task_data,
+			       GCancellable *cancellable)
+{
+	AsPool *pool = AS_POOL (source_object);
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	AsSectionReloadRequest *rlreq = task_data;
+	AsLocationGroup *lgroup = rlreq->lgroup;
+	g_autoptr(GError) error = NULL;
+	gboolean ret = FALSE;
+	g_autoptr(GMutexLocker) reload_locker = NULL;
+
+	g_atomic_int_set (&priv->reload_running, TRUE);
+	reload_locker = g_mutex_locker_new (&priv->reload_mutex);
+
+	/* Only a pool *reader* lock is held here: the replacement section data is
+	 * compiled fully off to the side and published by the cache with a brief
+	 * atomic registry swap under its own lock, so in-flight queries keep being
+	 * answered from the previous generation while the rebuild runs. The reader
+	 * lock merely keeps a concurrent full pool load or teardown from pulling
+	 * the location group away underneath us, and the reload mutex serializes
+	 * background reloads with each other. */
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	/* try to patch just the changed files into the loaded data first */
+	if (rlreq->changed_files != NULL) {
+		ret = as_pool_loader_update_group_for_files (pool,
+							     lgroup,
+							     rlreq->changed_files,
+							     &error);
+		if (!ret) {
+			g_debug ("Incremental update of cache section %s not possible (%s), "
+				 "reloading the whole group.",
+				 lgroup->cache_key,
+				 (error != NULL) ? error->message : "unknown");
+			g_clear_error (&error);
+		}
+	}
+
+	if (!ret)
+		ret = as_pool_loader_process_group (
+		    pool,
+		    lgroup,
+		    TRUE, /* always refresh cache, don't bother verifying timestamps */
+		    NULL,
+		    &error);
+	if (!ret)
+		g_warning ("Failed to auto-reload cache section %s: %s",
+			   lgroup->cache_key,
+			   error->message);
+
+	/* drop any memoized search results, they may refer to stale data now */
+	as_pool_invalidate_memoized_searches (pool);
+
+	g_debug ("Emitting Pool::changed() [%s]", ret ? "success" : "failure");
+	g_signal_emit (pool, signals[SIGNAL_CHANGED], 0);
+
+	g_atomic_int_set (&priv->reload_running, FALSE);
+	g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * as_pool_process_pending_reload_cb:
+ *
+ * Process a background reload for a specific location group.
+ */
+static gboolean
+as_pool_process_pending_reload_cb (gpointer user_data)
+{
+	AsLocationGroup *lgroup = user_data;
+	AsPoolPrivate *priv = GET_PRIVATE (AS_POOL (lgroup->owner));
+	AsSectionReloadRequest *rlreq;
+	g_autoptr(GTask) task = NULL;
+
+	priv->pending_id = 0;
+
+	/* if a reload is still executing, shed this one and try again later:
+	 * rescheduling is much cheaper than queuing a second full reload
+	 * behind the running one, and the later reload picks up all changes */
+	if (g_atomic_int_get (&priv->reload_running)) {
+		priv->reloads_shed++;
+		priv->reload_delay_ms = MIN (priv->reload_delay_ms * 2,
+					     AS_POOL_RELOAD_DELAY_MAX_MS);
+		priv->pending_id = g_timeout_add (priv->reload_delay_ms,
+						  as_pool_process_pending_reload_cb,
+						  lgroup);
+		return FALSE;
+	}
+
+	priv->reloads_executed++;
+	g_debug ("Auto-reload of cache for %s due to source data changes.", lgroup->cache_key);
+
+	/* take ownership of the set of changed files, unless a full reload is needed */
+	rlreq = g_new0 (AsSectionReloadRequest, 1);
+	rlreq->lgroup = lgroup;
+	if (!lgroup->pending_full_reload && lgroup->changed_files->len > 0) {
+		rlreq->changed_files = g_steal_pointer (&lgroup->changed_files);
+		lgroup->changed_files = g_ptr_array_new_with_free_func (g_free);
+	}
+	g_ptr_array_set_size (lgroup->changed_files, 0);
+	lgroup->pending_full_reload = FALSE;
+
+	task = g_task_new (lgroup->owner, NULL, NULL, NULL);
+	g_task_set_task_data (task, rlreq, (GDestroyNotify) as_section_reload_request_free);
+	g_task_run_in_thread (task, as_pool_section_reload_thread);
+
+	return FALSE;
 }
 
 /**
  * as_pool_trigger_reload_pending:
  *
- * Schedule a cache section reload.
+ * Schedule a cache section reload. Triggers arriving while a reload is
+ * already scheduled shed the older schedule and are coalesced into a
+ * single one, and the deferral time backs off exponentially while the
+ * source data keeps changing. That way e.g. a system upgrade rewriting
+ * metadata for minutes results in a handful of actual reloads instead
+ * of one per change batch.
  */
 static void
-as_pool_trigger_reload_pending (AsPool *pool, AsLocationGroup *lgroup, guint timeout_ms)
+as_pool_trigger_reload_pending (AsPool *pool, AsLocationGroup *lgroup)
 {
 	AsPoolPrivate *priv = GET_PRIVATE (pool);
-	if (priv->pending_id)
+	gint64 now = g_get_monotonic_time ();
+
+	priv->reloads_triggered++;
+
+	if (priv->pending_id) {
+		/* this trigger supersedes the previously scheduled reload: shed the
+		 * old schedule and back off, we are in a burst of changes */
 		g_source_remove (priv->pending_id);
-	else
-		g_debug ("Reload for %s pending in ~%i ms", lgroup->cache_key, timeout_ms);
-	priv->pending_id = g_timeout_add (timeout_ms, as_pool_process_pending_reload_cb, lgroup);
+		priv->reloads_shed++;
+		priv->reload_delay_ms = MIN (priv->reload_delay_ms * 2,
+					     AS_POOL_RELOAD_DELAY_MAX_MS);
+	} else if (now - priv->last_reload_trigger >
+		   (gint64) AS_POOL_RELOAD_QUIET_PERIOD_MS * 1000) {
+		/* the previous change burst is long over, defer only briefly again */
+		priv->reload_delay_ms = AS_POOL_RELOAD_DELAY_MIN_MS;
+	}
+	priv->last_reload_trigger = now;
+
+	g_debug ("Reload for %s pending in ~%u ms", lgroup->cache_key, priv->reload_delay_ms);
+	priv->pending_id = g_timeout_add (priv->reload_delay_ms,
+					  as_pool_process_pending_reload_cb,
+					  lgroup);
+}
+
+/**
+ * as_location_group_file_in_icon_dirs:
+ *
+ * Check whether the given filename lives below one of the icon
+ * directories of this location group.
+ */
+static gboolean
+as_location_group_file_in_icon_dirs (AsLocationGroup *lgroup, const gchar *filename)
+{
+	for (guint i = 0; i < lgroup->icon_dirs->len; i++) {
+		const gchar *icon_dir = g_ptr_array_index (lgroup->icon_dirs, i);
+		if (g_str_has_prefix (filename, icon_dir))
+			return TRUE;
+	}
+	return FALSE;
 }
 
 /**
  * as_pool_location_group_monitor_changed_cb:
  *
- * Called when any interesting file in the watched group is added, removed
+ * Called when any interesting file in the watched group was added
  * or changed.
  */
 static void
@@ -1831,7 +3041,75 @@ as_pool_location_group_monitor_changed_cb (AsFileMonitor *monitor,
 					   const gchar *filename,
 					   AsLocationGroup *lgroup)
 {
-	as_pool_trigger_reload_pending (lgroup->owner, lgroup, 800);
+	/* changes below an icon directory only make the cached directory
+	 * listings stale - no metadata needs to be reloaded for them */
+	if (as_location_group_file_in_icon_dirs (lgroup, filename)) {
+		as_icon_dir_index_invalidate (lgroup->icon_index);
+		return;
+	}
+
+	/* remember the changed file, so we can try to patch just its data into
+	 * the existing set instead of reloading the whole group */
+	if (!lgroup->pending_full_reload) {
+		gboolean known = FALSE;
+		for (guint i = 0; i < lgroup->changed_files->len; i++) {
+			if (g_strcmp0 (g_ptr_array_index (lgroup->changed_files, i), filename) ==
+			    0) {
+				known = TRUE;
+				break;
+			}
+		}
+		if (!known)
+			g_ptr_array_add (lgroup->changed_files, g_strdup (filename));
+	}
+}
+
+/**
+ * as_pool_location_group_monitor_removed_cb:
+ *
+ * Called when a watched file in the group was deleted.
+ */
+static void
+as_pool_location_group_monitor_removed_cb (AsFileMonitor *monitor,
+					   const gchar *filename,
+					   AsLocationGroup *lgroup)
+{
+	/* a removed icon just invalidates the cached directory listings */
+	if (as_location_group_file_in_icon_dirs (lgroup, filename)) {
+		as_icon_dir_index_invalidate (lgroup->icon_index);
+		return;
+	}
+
+	/* if we have patched this file in before, we know exactly which components
+	 * it contained and can drop just those - otherwise we have to process the
+	 * whole group again */
+	if (g_hash_table_contains (lgroup->file_cpts_map, filename)) {
+		as_pool_location_group_monitor_changed_cb (monitor, filename, lgroup);
+		return;
+	}
+
+	lgroup->pending_full_reload = TRUE;
+	g_ptr_array_set_size (lgroup->changed_files, 0);
+}
+
+/**
+ * as_pool_location_group_monitor_finished_cb:
+ *
+ * Called once after the file monitor delivered a batch of aggregated
+ * change notifications, so even a system update touching thousands of
+ * metadata files schedules only a single cache reload.
+ */
+static void
+as_pool_location_group_monitor_finished_cb (AsFileMonitor *monitor,
+					    guint n_changes,
+					    AsLocationGroup *lgroup)
+{
+	/* a batch touching only icon files leaves nothing to reload - the
+	 * invalidated icon-directory index is all that was needed */
+	if (!lgroup->pending_full_reload && lgroup->changed_files->len == 0)
+		return;
+
+	as_pool_trigger_reload_pending (lgroup->owner, lgroup);
 }
 
 /**
@@ -1892,6 +3170,208 @@ as_pool_get_components_by_id (AsPool *pool, const gchar *cid)
 	return result;
 }
 
+/**
+ * as_pool_get_components_xml_by_id:
+ * @pool: An instance of #AsPool.
+ * @cid: The AppStream-ID to look for, or %NULL to export all components.
+ * @error: A #GError or %NULL.
+ *
+ * Export the raw catalog XML fragments of matching components directly from
+ * the cache, without deserializing them into #AsComponent objects first.
+ * This is intended for bulk data exports, where throughput matters more
+ * than the refinement a full metadata round trip performs.
+ *
+ * Returns: (transfer full) (element-type utf8): The XML fragments, or %NULL on error.
+ */
+GPtrArray *
+as_pool_get_components_xml_by_id (AsPool *pool, const gchar *cid, GError **error)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	ptask = as_profile_start_literal (priv->profile, "AsPool:get_components_xml_by_id");
+	return as_cache_get_components_xml_by_id (priv->cache, cid, error);
+}
+
+/**
+ * as_pool_get_components_by_ids:
+ * @pool: An instance of #AsPool.
+ * @cids: (array zero-terminated=1): The AppStream-IDs to look for.
+ *
+ * Get components matching any of the given IDs in one batch.
+ * This is significantly faster than calling as_pool_get_components_by_id()
+ * in a loop, as the metadata cache is only traversed once for the
+ * whole ID set.
+ *
+ * Returns: (transfer full): an #AsComponentBox.
+ *
+ * Since: 1.0.5
+ */
+AsComponentBox *
+as_pool_get_components_by_ids (AsPool *pool, const gchar *const *cids)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	AsComponentBox *result;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	ptask = as_profile_start_literal (priv->profile, "AsPool:get_components_by_ids");
+	result = as_cache_get_components_by_ids (priv->cache, cids, &tmp_error);
+	if (result == NULL) {
+		g_warning ("Error while trying to get components by IDs: %s", tmp_error->message);
+		return as_component_box_new_simple ();
+	}
+	return result;
+}
+
+/**
+ * AsComponentHandle:
+ *
+ * A cheap, stable reference to a component in an #AsPool.
+ * Unlike a strong #AsComponent reference, a handle does not pin the
+ * component data of a previous pool generation in memory: it stores the
+ * component's data-ID and is resolved against the current pool contents
+ * on access.
+ */
+struct _AsComponentHandle {
+	gchar *data_id;
+	gint generation;     /* pool content generation @cached was resolved from */
+	AsComponent *cached; /* last resolved component, or NULL */
+};
+
+G_DEFINE_BOXED_TYPE (AsComponentHandle,
+		     as_component_handle,
+		     as_component_handle_copy,
+		     as_component_handle_free)
+
+/**
+ * as_component_handle_copy:
+ * @handle: An #AsComponentHandle.
+ *
+ * Copy a component handle. The copy starts out unresolved.
+ *
+ * Returns: (transfer full): the copied #AsComponentHandle.
+ *
+ * Since: 1.0.5
+ */
+AsComponentHandle *
+as_component_handle_copy (AsComponentHandle *handle)
+{
+	AsComponentHandle *copy = g_new0 (AsComponentHandle, 1);
+	copy->data_id = g_strdup (handle->data_id);
+	return copy;
+}
+
+/**
+ * as_component_handle_free:
+ * @handle: An #AsComponentHandle.
+ *
+ * Free a component handle.
+ *
+ * Since: 1.0.5
+ */
+void
+as_component_handle_free (AsComponentHandle *handle)
+{
+	g_free (handle->data_id);
+	g_clear_object (&handle->cached);
+	g_free (handle);
+}
+
+/**
+ * as_component_handle_get_data_id:
+ * @handle: An #AsComponentHandle.
+ *
+ * Get the data-ID of the component this handle refers to.
+ *
+ * Returns: The component data-ID.
+ *
+ * Since: 1.0.5
+ */
+const gchar *
+as_component_handle_get_data_id (AsComponentHandle *handle)
+{
+	return handle->data_id;
+}
+
+/**
+ * as_pool_create_component_handle:
+ * @pool: An instance of #AsPool.
+ * @cpt: The #AsComponent to create a handle for.
+ *
+ * Create a stable handle for @cpt, which can be held cheaply over a long
+ * time (e.g. by UI layers) and resolved back into a component via
+ * as_pool_resolve_component_handle() when needed.
+ *
+ * Returns: (transfer full): A new #AsComponentHandle.
+ *
+ * Since: 1.0.5
+ */
+AsComponentHandle *
+as_pool_create_component_handle (AsPool *pool, AsComponent *cpt)
+{
+	AsComponentHandle *handle;
+
+	g_return_val_if_fail (AS_IS_POOL (pool), NULL);
+	g_return_val_if_fail (cpt != NULL, NULL);
+
+	handle = g_new0 (AsComponentHandle, 1);
+	handle->data_id = g_strdup (as_component_get_data_id (cpt));
+	return handle;
+}
+
+/**
+ * as_pool_resolve_component_handle:
+ * @pool: An instance of #AsPool.
+ * @handle: The #AsComponentHandle to resolve.
+ *
+ * Resolve a component handle against the current pool contents.
+ * The result is memoized in the handle together with the pool's content
+ * generation, so repeated resolution is cheap as long as the pool is not
+ * reloaded. After a reload, the stale component is dropped and the handle
+ * is resolved freshly, so old pool generations can actually be released.
+ *
+ * Returns: (transfer full) (nullable): The current #AsComponent for this
+ * handle, or %NULL if it no longer exists in the pool.
+ *
+ * Since: 1.0.5
+ */
+AsComponent *
+as_pool_resolve_component_handle (AsPool *pool, AsComponentHandle *handle)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autofree gchar *cid = NULL;
+	g_autoptr(AsComponentBox) result = NULL;
+	gint generation;
+
+	g_return_val_if_fail (handle != NULL, NULL);
+
+	generation = g_atomic_int_get (&priv->content_generation);
+	if (handle->cached != NULL && handle->generation == generation)
+		return g_object_ref (handle->cached);
+
+	/* drop any stale cached component, so reloads can release old data */
+	g_clear_object (&handle->cached);
+
+	cid = as_utils_data_id_get_cid (handle->data_id);
+	if (cid == NULL)
+		return NULL;
+
+	result = as_pool_get_components_by_id (pool, cid);
+	for (guint i = 0; i < as_component_box_len (result); i++) {
+		AsComponent *cpt = as_component_box_index (result, i);
+		if (as_utils_data_id_equal (as_component_get_data_id (cpt), handle->data_id)) {
+			handle->cached = g_object_ref (cpt);
+			handle->generation = generation;
+			return g_object_ref (cpt);
+		}
+	}
+
+	return NULL;
+}
+
 /**
  * as_pool_get_components_by_provided_item:
  * @pool: An instance of #AsPool.
@@ -2046,6 +3526,37 @@ as_pool_get_components_by_extends (AsPool *pool, const gchar *extended_id)
 	return result;
 }
 
+/**
+ * as_pool_get_components_by_suggested:
+ * @pool: An instance of #AsPool.
+ * @suggested_id: The ID of the component to search suggesting components for.
+ *
+ * Find components that suggest the component with the given ID.
+ * The lookup is performed via an inverted index, so it is cheap to call
+ * this for many components in a row.
+ *
+ * Returns: (transfer full): an #AsComponentBox.
+ *
+ * Since: 1.0.5
+ */
+AsComponentBox *
+as_pool_get_components_by_suggested (AsPool *pool, const gchar *suggested_id)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GError) tmp_error = NULL;
+	AsComponentBox *result = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	result = as_cache_get_components_by_suggested (priv->cache, suggested_id, &tmp_error);
+	if (result == NULL) {
+		g_warning ("Unable find suggesting components in session cache: %s",
+			   tmp_error->message);
+		return as_component_box_new_simple ();
+	}
+
+	return result;
+}
+
 /**
  * as_pool_get_components_by_bundle_id:
  * @pool: An instance of #AsPool.
@@ -2087,6 +3598,176 @@ as_pool_get_components_by_bundle_id (AsPool *pool,
 	return result;
 }
 
+/**
+ * as_pool_get_language_stats:
+ * @pool: An instance of #AsPool.
+ *
+ * Get a histogram of translation coverage across the whole pool: a table
+ * mapping locale names to the number of components that list the
+ * respective language.
+ *
+ * The histogram is aggregated from the cache without loading any
+ * component and is memoized until the pool contents change, so repeated
+ * queries are cheap. The returned table must not be modified.
+ *
+ * Returns: (transfer full) (element-type utf8 guint): locale → component count
+ *
+ * Since: 1.0.5
+ */
+GHashTable *
+as_pool_get_language_stats (AsPool *pool)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GError) tmp_error = NULL;
+	GHashTable *stats;
+	gint generation;
+	g_autoptr(GMutexLocker) stats_locker = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	generation = g_atomic_int_get (&priv->content_generation);
+	stats_locker = g_mutex_locker_new (&priv->language_stats_mutex);
+	if (priv->language_stats != NULL && priv->language_stats_generation == generation)
+		return g_hash_table_ref (priv->language_stats);
+	g_clear_pointer (&priv->language_stats, g_hash_table_unref);
+
+	stats = as_cache_get_language_stats (priv->cache, &tmp_error);
+	if (stats == NULL) {
+		g_warning ("Unable to aggregate language statistics: %s", tmp_error->message);
+		return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	}
+
+	priv->language_stats = g_hash_table_ref (stats);
+	priv->language_stats_generation = generation;
+	return stats;
+}
+
+/**
+ * as_pool_relations_for_kind:
+ *
+ * Get the relations list of the given kind from a component.
+ */
+static GPtrArray *
+as_pool_relations_for_kind (AsComponent *cpt, AsRelationKind rel_kind)
+{
+	if (rel_kind == AS_RELATION_KIND_REQUIRES)
+		return as_component_get_requires (cpt);
+	if (rel_kind == AS_RELATION_KIND_RECOMMENDS)
+		return as_component_get_recommends (cpt);
+	if (rel_kind == AS_RELATION_KIND_SUPPORTS)
+		return as_component_get_supports (cpt);
+	return NULL;
+}
+
+/**
+ * as_pool_check_relations:
+ * @pool: An instance of #AsPool.
+ * @cbox: the components to check relations for.
+ * @sysinfo: (nullable): an #AsSystemInfo to use for system information.
+ * @rel_kind: the kind of relations to check.
+ *
+ * Check the relations of the given kind for many components at once.
+ *
+ * This performs the same check as running as_component_check_relations() on
+ * every component individually, but first collects all distinct requirements
+ * and probes each system fact only once, grouped so that expensive device
+ * enumerations are not repeated per component. Use this when evaluating
+ * system compatibility for a large set of components, e.g. a whole
+ * application grid.
+ *
+ * Returns: (transfer container) (element-type utf8 GLib.PtrArray): A mapping of
+ *   component data-IDs to arrays of #AsRelationCheckResult.
+ *
+ * Since: 1.0.5
+ */
+GHashTable *
+as_pool_check_relations (AsPool *pool,
+			 AsComponentBox *cbox,
+			 AsSystemInfo *sysinfo,
+			 AsRelationKind rel_kind)
+{
+	g_autoptr(AsSystemInfo) sinfo = NULL;
+	g_autoptr(GHashTable) modalias_globs = NULL;
+	gboolean need_kernel = FALSE;
+	gboolean need_memory = FALSE;
+	gboolean need_controls = FALSE;
+	GHashTableIter ht_iter;
+	gpointer ht_key;
+	GHashTable *results;
+
+	g_return_val_if_fail (AS_IS_POOL (pool), NULL);
+	g_return_val_if_fail (AS_IS_COMPONENT_BOX (cbox), NULL);
+
+	sinfo = (sysinfo == NULL) ? as_system_info_get_current () : g_object_ref (sysinfo);
+	modalias_globs = g_hash_table_new (g_str_hash, g_str_equal);
+
+	/* collect all distinct requirements first */
+	for (guint i = 0; i < as_component_box_len (cbox); i++) {
+		AsComponent *cpt = as_component_box_index (cbox, i);
+		GPtrArray *relations;
+
+		/* compatibility for older metadata */
+		as_component_make_implicit_relations_explicit (cpt);
+
+		relations = as_pool_relations_for_kind (cpt, rel_kind);
+		if (relations == NULL)
+			continue;
+		for (guint j = 0; j < relations->len; j++) {
+			AsRelation *relation = AS_RELATION (g_ptr_array_index (relations, j));
+
+			switch (as_relation_get_item_kind (relation)) {
+			case AS_RELATION_ITEM_KIND_KERNEL:
+				need_kernel = TRUE;
+				break;
+			case AS_RELATION_ITEM_KIND_MEMORY:
+				need_memory = TRUE;
+				break;
+			case AS_RELATION_ITEM_KIND_CONTROL:
+				need_controls = TRUE;
+				break;
+			case AS_RELATION_ITEM_KIND_MODALIAS:
+				if (as_relation_get_value_str (relation) != NULL)
+					g_hash_table_add (
+					    modalias_globs,
+					    (gchar *) as_relation_get_value_str (relation));
+				break;
+			default:
+				/* all other facts either need no system probing or are
+				 * resolved via the pool itself during evaluation */
+				break;
+			}
+		}
+	}
+
+	/* probe each distinct fact once, cheap file reads before device enumerations */
+	if (need_kernel)
+		as_system_info_get_kernel_name (sinfo);
+	if (need_memory)
+		as_system_info_get_memory_total (sinfo);
+	if (need_controls) {
+		/* a single probe scans for all input control kinds at once */
+		as_system_info_has_input_control (sinfo, AS_CONTROL_KIND_KEYBOARD, NULL);
+	}
+	g_hash_table_iter_init (&ht_iter, modalias_globs);
+	while (g_hash_table_iter_next (&ht_iter, &ht_key, NULL)) {
+		/* the first match walks sysfs once, every result is memoized per glob */
+		as_system_info_has_device_matching_modalias (sinfo, (const gchar *) ht_key);
+	}
+
+	/* now evaluate all components against the warm fact table */
+	results = g_hash_table_new_full (g_str_hash,
+					 g_str_equal,
+					 g_free,
+					 (GDestroyNotify) g_ptr_array_unref);
+	for (guint i = 0; i < as_component_box_len (cbox); i++) {
+		AsComponent *cpt = as_component_box_index (cbox, i);
+		g_hash_table_insert (results,
+				     g_strdup (as_component_get_data_id (cpt)),
+				     as_component_check_relations (cpt, sinfo, pool, rel_kind));
+	}
+
+	return results;
+}
+
 /**
  * as_user_search_term_valid:
  *
@@ -2113,7 +3794,9 @@ as_user_search_term_valid (const gchar *term)
  * @search: the (user-provided) search phrase.
  *
  * Splits up a string into an array of tokens that are suitable for searching.
- * This includes stripping whitespaces, casefolding the terms and removing greylist words.
+ * This includes stripping whitespaces, casefolding the terms, removing greylist
+ * words and expanding terms with their synonyms, if a synonym table was
+ * configured for this system.
  *
  * This function is usually called automatically when needed, you will only need to
  * run it explicitly when you need to check which search tokens the pool will actually
@@ -2129,8 +3812,7 @@ as_pool_build_search_tokens (AsPool *pool, const gchar *search)
 	g_autofree gchar *search_norm = NULL;
 	g_auto(GStrv) words = NULL;
 	g_auto(GStrv) strv = NULL;
-	gchar **terms;
-	guint idx;
+	GPtrArray *terms;
 
 	if (search == NULL)
 		return NULL;
@@ -2158,34 +3840,384 @@ as_pool_build_search_tokens (AsPool *pool, const gchar *search)
 		search_norm = g_utf8_casefold (search, -1);
 	}
 
-	strv = g_str_tokenize_and_fold (search_norm, priv->locale_posix, NULL);
-	/* we might still be able to extract tokens if g_str_tokenize_and_fold() can't do it or +/- were found */
-	if (strv == NULL) {
-		g_autofree gchar *delim = NULL;
-		delim = g_utf8_strdown (search_norm, -1);
-		g_strdelimit (delim, "/,.;:", ' ');
-		strv = g_strsplit (delim, " ", -1);
-	}
+	strv = g_str_tokenize_and_fold (search_norm, priv->locale_posix, NULL);
+	/* we might still be able to extract tokens if g_str_tokenize_and_fold() can't do it or +/- were found */
+	if (strv == NULL) {
+		/* @search_norm is already case-folded, so folding the ASCII range in place is sufficient */
+		as_utils_strdown_inplace (search_norm);
+		g_strdelimit (search_norm, "/,.;:", ' ');
+		strv = g_strsplit (search_norm, " ", -1);
+	}
+
+	terms = g_ptr_array_new_with_free_func (g_free);
+	stemmer = g_object_ref (as_stemmer_get (priv->locale_posix));
+	for (guint i = 0; strv[i] != NULL; i++) {
+		gchar *token;
+		gchar **synonyms;
+		if (!as_user_search_term_valid (strv[i]))
+			continue;
+		/* stem the string and add it to terms */
+		token = as_stemmer_stem (stemmer, strv[i]);
+		if (token != NULL)
+			g_ptr_array_add (terms, token);
+
+		/* expand the (unstemmed) term with any synonyms configured for it */
+		synonyms = g_hash_table_lookup (priv->search_synonyms, strv[i]);
+		if (synonyms == NULL)
+			continue;
+		for (guint j = 0; synonyms[j] != NULL; j++) {
+			g_autofree gchar *syn_token = NULL;
+			gboolean known = FALSE;
+			if (synonyms[j][0] == '\0')
+				continue;
+			syn_token = as_stemmer_stem (stemmer, synonyms[j]);
+			if (syn_token == NULL)
+				continue;
+			for (guint k = 0; k < terms->len; k++) {
+				if (g_strcmp0 (g_ptr_array_index (terms, k), syn_token) == 0) {
+					known = TRUE;
+					break;
+				}
+			}
+			if (!known)
+				g_ptr_array_add (terms, g_steal_pointer (&syn_token));
+		}
+	}
+	/* if we have no valid terms, return NULL */
+	if (terms->len == 0) {
+		g_ptr_array_unref (terms);
+		return NULL;
+	}
+
+	g_ptr_array_add (terms, NULL);
+	return (gchar **) g_ptr_array_free (terms, FALSE);
+}
+
+/**
+ * as_pool_search_strv_cmp:
+ */
+static int
+as_pool_search_strv_cmp (const void *a, const void *b)
+{
+	return g_strcmp0 (*(const gchar *const *) a, *(const gchar *const *) b);
+}
+
+/**
+ * as_pool_search_memo_key:
+ *
+ * Build a lookup key for the search memoization table from the
+ * normalized search tokens and the result limit.
+ */
+static gchar *
+as_pool_search_memo_key (gchar **tokens, guint limit)
+{
+	g_auto(GStrv) sorted = g_strdupv (tokens);
+	g_autofree gchar *joined = NULL;
+
+	/* normalize the token order, so "web browser" and "browser web"
+	 * share a memoized result */
+	qsort (sorted, g_strv_length (sorted), sizeof (gchar *), as_pool_search_strv_cmp);
+	joined = g_strjoinv (" ", sorted);
+	return g_strdup_printf ("%u:%s", limit, joined);
+}
+
+/**
+ * as_pool_search_exact_prepass:
+ *
+ * Try to answer a search query that looks like a machine identifier
+ * (component-ID, package name or binary name) with an exact cache lookup,
+ * so pasting an ID does not go through tokenizing and scoring the
+ * whole pool.
+ *
+ * Returns: (transfer full) (nullable): the matched components, or %NULL
+ * if the query does not qualify or nothing matched exactly.
+ */
+static AsComponentBox *
+as_pool_search_exact_prepass (AsPool *pool, const gchar *search, guint limit)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(AsComponentBox) result = NULL;
+	gboolean id_like = FALSE;
+
+	/* only queries without spaces and with just the characters common to
+	 * component IDs and package names qualify for the fast path */
+	if (search[0] == '\0')
+		return NULL;
+	for (guint i = 0; search[i] != '\0'; i++) {
+		const gchar c = search[i];
+		if (g_ascii_isalnum (c) || c == '-' || c == '_' || c == '+')
+			continue;
+		if (c == '.') {
+			id_like = TRUE;
+			continue;
+		}
+		return NULL;
+	}
+
+	/* exact component-ID match (dotted queries only, like reverse-DNS IDs) */
+	if (id_like)
+		result = as_cache_get_components_by_id (priv->cache, search, NULL);
+
+	/* exact package name */
+	if (result == NULL || as_component_box_len (result) == 0) {
+		g_clear_object (&result);
+		result = as_cache_get_components_by_bundle_id (priv->cache,
+							       AS_BUNDLE_KIND_PACKAGE,
+							       search,
+							       FALSE, /* no prefix match */
+							       NULL);
+	}
+
+	/* exact binary name, e.g. "gnome-software" */
+	if (result == NULL || as_component_box_len (result) == 0) {
+		g_clear_object (&result);
+		result = as_cache_get_components_by_provided_item (priv->cache,
+								   AS_PROVIDED_KIND_BINARY,
+								   search,
+								   NULL);
+	}
+
+	if (result == NULL || as_component_box_len (result) == 0) {
+		g_clear_object (&result);
+		return NULL;
+	}
+
+	if (limit > 0 && as_component_box_len (result) > limit) {
+		g_autoptr(AsComponentBox) all = g_steal_pointer (&result);
+		result = as_component_box_new_simple ();
+		for (guint i = 0; i < limit; i++)
+			as_component_box_add (result, as_component_box_index (all, i), NULL);
+	}
+
+	return g_steal_pointer (&result);
+}
+
+/**
+ * as_pool_cancel_index_warmup:
+ *
+ * Stop any running background search-index warmup, so it does not
+ * compete with a real query for I/O and CPU time.
+ */
+static void
+as_pool_cancel_index_warmup (AsPool *pool)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->warm_mutex);
+
+	if (priv->warm_cancellable != NULL)
+		g_cancellable_cancel (priv->warm_cancellable);
+}
+
+/**
+ * as_pool_search_internal:
+ */
+static AsComponentBox *
+as_pool_search_internal (AsPool *pool, const gchar *search, guint limit)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	AsComponentBox *result = NULL;
+	g_auto(GStrv) tokens = NULL;
+	g_autofree gchar *memo_key = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	ptask = as_profile_start_literal (priv->profile, "AsPool:search");
+
+	/* a real query arrived, any still-running index warmup must yield to it */
+	as_pool_cancel_index_warmup (pool);
+
+	/* check if the query is an exact identifier before going through
+	 * full-text search, making the "paste an ID" flow instant */
+	if (search != NULL) {
+		g_autofree gchar *stripped = g_strdup (search);
+		AsComponentBox *exact;
+
+		as_strstripnl (stripped);
+		exact = as_pool_search_exact_prepass (pool, stripped, limit);
+		if (exact != NULL) {
+			g_debug ("Exact identifier match for '%s', skipping full-text search.",
+				 stripped);
+			return exact;
+		}
+	}
+
+	/* sanitize user's search term */
+	tokens = as_pool_build_search_tokens (pool, search);
+
+	if (tokens == NULL) {
+		/* the query was invalid */
+		g_autofree gchar *tmp = g_strdup (search);
+		as_strstripnl (tmp);
+		if (strlen (tmp) <= 1) {
+			/* we have a one-letter search query - we cheat here and just return everything */
+			g_debug ("Search query too broad. Matching everything.");
+			result = as_pool_get_components (pool);
+			if (limit > 0 && as_component_box_get_size (result) > limit) {
+				g_autoptr(AsComponentBox) all = result;
+				result = as_component_box_new_simple ();
+				for (guint i = 0; i < limit; i++)
+					as_component_box_add (result,
+							      as_component_box_index (all, i),
+							      NULL);
+			}
+			return result;
+		} else {
+			g_debug ("No valid search tokens. Can not find any results.");
+			return as_component_box_new_simple ();
+		}
+	} else {
+		g_autofree gchar *tmp_str = NULL;
+		tmp_str = g_strjoinv (" ", tokens);
+		g_debug ("Searching for: %s", tmp_str);
+	}
+
+	/* check if we have memoized this exact query for the current pool contents */
+	if (as_flags_contains (priv->flags, AS_POOL_FLAG_CACHE_SEARCH_RESULTS)) {
+		AsPoolSearchMemoEntry *entry;
+
+		memo_key = as_pool_search_memo_key (tokens, limit);
+		g_mutex_lock (&priv->search_memo_mutex);
+		entry = g_hash_table_lookup (priv->search_memo, memo_key);
+		if (entry != NULL &&
+		    entry->generation == g_atomic_int_get (&priv->content_generation)) {
+			result = as_component_box_new_simple ();
+			for (guint i = 0; i < entry->cpts->len; i++)
+				as_component_box_add (result,
+						      g_ptr_array_index (entry->cpts, i),
+						      NULL);
+			g_mutex_unlock (&priv->search_memo_mutex);
+			g_debug ("Returning memoized search result.");
+			return result;
+		}
+		g_mutex_unlock (&priv->search_memo_mutex);
+	}
+
+	result = as_cache_search (priv->cache,
+				  (const gchar *const *) tokens,
+				  /* if we re-rank below, the cache does not need to pre-sort */
+				  priv->priors_entries == NULL && priv->ranking_fn == NULL,
+				  limit,
+				  &tmp_error);
+	if (result == NULL) {
+		g_warning ("Search failed: %s", tmp_error->message);
+		return as_component_box_new_simple ();
+	}
+
+	/* fold popularity priors and the custom ranking hook into the relevance
+	 * scores, then sort once on the combined score */
+	if (priv->priors_entries != NULL || priv->ranking_fn != NULL) {
+		for (guint i = 0; i < as_component_box_len (result); i++) {
+			AsComponent *cpt = as_component_box_index (result, i);
+			guint score = as_component_get_sort_score (cpt);
+
+			if (priv->priors_entries != NULL)
+				score = score * as_pool_priors_lookup_weight (
+						    priv,
+						    as_component_get_id (cpt)) /
+					100;
+			if (priv->ranking_fn != NULL)
+				score = priv->ranking_fn (pool,
+							  cpt,
+							  score,
+							  priv->ranking_fn_udata);
+			as_component_set_sort_score (cpt, score);
+		}
+		as_component_box_sort_by_score (result);
+	}
+
+	/* memoize the ranked result for repeated storefront queries */
+	if (memo_key != NULL) {
+		AsPoolSearchMemoEntry *entry = g_new0 (AsPoolSearchMemoEntry, 1);
+
+		entry->generation = g_atomic_int_get (&priv->content_generation);
+		entry->cpts = g_ptr_array_new_with_free_func (g_object_unref);
+		for (guint i = 0; i < as_component_box_len (result); i++)
+			g_ptr_array_add (entry->cpts,
+					 g_object_ref (as_component_box_index (result, i)));
+
+		g_mutex_lock (&priv->search_memo_mutex);
+		/* coarse eviction, the table is small and rebuilt quickly */
+		if (g_hash_table_size (priv->search_memo) >= AS_POOL_SEARCH_MEMO_MAX_ENTRIES)
+			g_hash_table_remove_all (priv->search_memo);
+		g_hash_table_insert (priv->search_memo, g_steal_pointer (&memo_key), entry);
+		g_mutex_unlock (&priv->search_memo_mutex);
+	}
+
+	return result;
+}
+
+/**
+ * as_pool_warm_index_thread:
+ *
+ * Background thread warming the search index of the pool's cache.
+ */
+static gpointer
+as_pool_warm_index_thread (gpointer user_data)
+{
+	g_autoptr(AsPool) pool = AS_POOL (user_data);
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+
+	as_cache_warm_search_index (priv->cache, priv->warm_cancellable);
+	return NULL;
+}
+
+/**
+ * as_pool_warm_search_index_async:
+ * @pool: An instance of #AsPool.
+ *
+ * Start building the full-text search index in a background thread, so the
+ * first real search does not have to pay for query compilation and faulting
+ * in the memory-mapped cache pages. Call this right after the pool has been
+ * loaded, before the user had a chance to type a query.
+ *
+ * This function returns immediately. The warmup yields all locks frequently
+ * and is cancelled automatically as soon as a real search arrives, so it
+ * never delays actual queries.
+ *
+ * Since: 1.0.5
+ */
+void
+as_pool_warm_search_index_async (AsPool *pool)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->warm_mutex);
+
+	/* we warm the index at most once per pool instance - subsequent calls
+	 * would only repeat work the first search has done long ago anyway */
+	if (priv->warm_thread != NULL)
+		return;
+
+	priv->warm_cancellable = g_cancellable_new ();
+	priv->warm_thread = g_thread_new ("pool-warm-index",
+					  as_pool_warm_index_thread,
+					  g_object_ref (pool));
+}
 
-	terms = g_new0 (gchar *, g_strv_length (strv) + 1);
-	idx = 0;
-	stemmer = g_object_ref (as_stemmer_get (priv->locale_posix));
-	for (guint i = 0; strv[i] != NULL; i++) {
-		gchar *token;
-		if (!as_user_search_term_valid (strv[i]))
-			continue;
-		/* stem the string and add it to terms */
-		token = as_stemmer_stem (stemmer, strv[i]);
-		if (token != NULL)
-			terms[idx++] = token;
-	}
-	/* if we have no valid terms, return NULL */
-	if (idx == 0) {
-		g_strfreev (terms);
-		return NULL;
-	}
+/**
+ * as_pool_freeze:
+ * @pool: An instance of #AsPool.
+ *
+ * Create an immutable snapshot of the current contents of this pool.
+ * All components and query indices are materialized when the snapshot
+ * is taken, so its query functions never take locks and may be called
+ * from any number of threads concurrently.
+ *
+ * The snapshot is not updated when the pool changes, e.g. due to a
+ * metadata refresh - take a new snapshot to pick up new data.
+ *
+ * Returns: (transfer full): an #AsPoolSnapshot of the current pool contents.
+ *
+ * Since: 1.0.5
+ */
+AsPoolSnapshot *
+as_pool_freeze (AsPool *pool)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(AsProfileTask) ptask = NULL;
 
-	return terms;
+	ptask = as_profile_start_literal (priv->profile, "AsPool:freeze");
+	return as_pool_snapshot_new (pool);
 }
 
 /**
@@ -2203,46 +4235,90 @@ as_pool_build_search_tokens (AsPool *pool, const gchar *search)
 AsComponentBox *
 as_pool_search (AsPool *pool, const gchar *search)
 {
-	AsPoolPrivate *priv = GET_PRIVATE (pool);
-	g_autoptr(AsProfileTask) ptask = NULL;
-	g_autoptr(GError) tmp_error = NULL;
-	AsComponentBox *result = NULL;
-	g_auto(GStrv) tokens = NULL;
-	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+	return as_pool_search_internal (pool, search, 0);
+}
 
-	ptask = as_profile_start_literal (priv->profile, "AsPool:search");
+/**
+ * as_pool_search_ranked:
+ * @pool: An instance of #AsPool
+ * @search: A search string
+ * @limit: Maximum amount of results to return, or 0 for no limit.
+ *
+ * Search for components matching the search term, returning only
+ * the @limit highest-scoring results, ordered by match score.
+ *
+ * If the caller only displays the first few results anyway, this is
+ * much faster than as_pool_search() on broad queries, as only the
+ * best matches need to be deserialized from the cache.
+ *
+ * Returns: (transfer full): an #AsComponentBox of the found components.
+ *
+ * Since: 1.0.5
+ */
+AsComponentBox *
+as_pool_search_ranked (AsPool *pool, const gchar *search, guint limit)
+{
+	return as_pool_search_internal (pool, search, limit);
+}
 
-	/* sanitize user's search term */
-	tokens = as_pool_build_search_tokens (pool, search);
+/**
+ * as_pool_search_thread:
+ */
+static void
+as_pool_search_thread (GTask *task,
+		       gpointer source_object,
+		       gpointer task_data,
+		       GCancellable *cancellable)
+{
+	AsPool *pool = AS_POOL (source_object);
+	const gchar *search = task_data;
 
-	if (tokens == NULL) {
-		/* the query was invalid */
-		g_autofree gchar *tmp = g_strdup (search);
-		as_strstripnl (tmp);
-		if (strlen (tmp) <= 1) {
-			/* we have a one-letter search query - we cheat here and just return everything */
-			g_debug ("Search query too broad. Matching everything.");
-			return as_pool_get_components (pool);
-		} else {
-			g_debug ("No valid search tokens. Can not find any results.");
-			return as_component_box_new_simple ();
-		}
-	} else {
-		g_autofree gchar *tmp_str = NULL;
-		tmp_str = g_strjoinv (" ", tokens);
-		g_debug ("Searching for: %s", tmp_str);
-	}
+	g_task_return_pointer (task, as_pool_search (pool, search), g_object_unref);
+}
 
-	result = as_cache_search (priv->cache,
-				  (const gchar *const *) tokens,
-				  TRUE, /* sort */
-				  &tmp_error);
-	if (result == NULL) {
-		g_warning ("Search failed: %s", tmp_error->message);
-		return as_component_box_new_simple ();
-	}
+/**
+ * as_pool_search_async:
+ * @pool: An instance of #AsPool
+ * @search: A search string
+ * @cancellable: a #GCancellable.
+ * @callback: A #GAsyncReadyCallback
+ * @user_data: Data to pass to @callback
+ *
+ * Asynchronously search for a list of components matching the search term.
+ * Equivalent to as_pool_search() (but asynchronous), so UI applications
+ * can search without blocking their main loop while the query runs.
+ *
+ * Since: 1.0.5
+ **/
+void
+as_pool_search_async (AsPool *pool,
+		      const gchar *search,
+		      GCancellable *cancellable,
+		      GAsyncReadyCallback callback,
+		      gpointer user_data)
+{
+	g_autoptr(GTask) task = g_task_new (pool, cancellable, callback, user_data);
+	g_task_set_task_data (task, g_strdup (search), g_free);
+	g_task_run_in_thread (task, as_pool_search_thread);
+}
 
-	return result;
+/**
+ * as_pool_search_finish:
+ * @pool: An instance of #AsPool
+ * @result: A #GAsyncResult
+ * @error: A #GError or %NULL.
+ *
+ * Retrieve the result of as_pool_search_async().
+ *
+ * Returns: (transfer full): an #AsComponentBox of the found components.
+ *
+ * Since: 1.0.5
+ **/
+AsComponentBox *
+as_pool_search_finish (AsPool *pool, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, pool), NULL);
+	return g_task_propagate_pointer (G_TASK (result), error);
 }
 
 /**
@@ -2541,6 +4617,8 @@ as_pool_set_flags (AsPool *pool, AsPoolFlags flags)
 	priv->flags = flags;
 	as_cache_set_resolve_addons (priv->cache,
 				     as_flags_contains (priv->flags, AS_POOL_FLAG_RESOLVE_ADDONS));
+	as_cache_set_throttled (priv->cache,
+				as_flags_contains (priv->flags, AS_POOL_FLAG_THROTTLE_REFRESH));
 }
 
 /**
@@ -2562,6 +4640,8 @@ as_pool_add_flags (AsPool *pool, AsPoolFlags flags)
 	as_flags_add (priv->flags, flags);
 	as_cache_set_resolve_addons (priv->cache,
 				     as_flags_contains (priv->flags, AS_POOL_FLAG_RESOLVE_ADDONS));
+	as_cache_set_throttled (priv->cache,
+				as_flags_contains (priv->flags, AS_POOL_FLAG_THROTTLE_REFRESH));
 }
 
 /**
@@ -2583,6 +4663,59 @@ as_pool_remove_flags (AsPool *pool, AsPoolFlags flags)
 	as_flags_remove (priv->flags, flags);
 	as_cache_set_resolve_addons (priv->cache,
 				     as_flags_contains (priv->flags, AS_POOL_FLAG_RESOLVE_ADDONS));
+	as_cache_set_throttled (priv->cache,
+				as_flags_contains (priv->flags, AS_POOL_FLAG_THROTTLE_REFRESH));
+}
+
+/**
+ * as_pool_add_load_kind:
+ * @pool: An instance of #AsPool.
+ * @kind: The #AsComponentKind to load.
+ *
+ * Restrict this pool to components of the selected kinds.
+ * By default, components of all kinds are loaded. Once one or more
+ * kinds have been added via this function, metadata entries of any
+ * other kind are skipped while loading, before their components are
+ * constructed, which reduces both load time and memory usage
+ * proportionally to the amount of filtered data.
+ *
+ * This function must be called before as_pool_load(). Cache sections
+ * compiled with a load-kind filter are stored separately from
+ * unfiltered ones, so different filter configurations do not
+ * invalidate each other's caches.
+ *
+ * Note that merge components and addons of excluded kinds are skipped
+ * as well, so %AS_POOL_FLAG_RESOLVE_ADDONS is only useful if
+ * %AS_COMPONENT_KIND_ADDON is part of the selected kinds.
+ *
+ * Since: 1.0.5
+ */
+void
+as_pool_add_load_kind (AsPool *pool, AsComponentKind kind)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+
+	g_return_if_fail (kind > AS_COMPONENT_KIND_UNKNOWN && kind < AS_COMPONENT_KIND_LAST);
+	priv->load_kinds |= 1U << kind;
+}
+
+/**
+ * as_pool_reset_load_kinds:
+ * @pool: An instance of #AsPool.
+ *
+ * Reset the load-kind filter of this pool, so components
+ * of all kinds are loaded again.
+ *
+ * Since: 1.0.5
+ */
+void
+as_pool_reset_load_kinds (AsPool *pool)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+
+	priv->load_kinds = 0;
 }
 
 /**
@@ -2618,6 +4751,352 @@ as_pool_set_load_std_data_locations (AsPool *pool, gboolean enabled)
 	}
 }
 
+/**
+ * as_pool_set_query_stats_enabled:
+ * @pool: An instance of #AsPool.
+ * @enabled: %TRUE to record query statistics.
+ *
+ * Enable or disable collection of per-query statistics for this pool.
+ * When enabled, every metadata query records its duration, result count
+ * and which cache sections contributed results, which is helpful for
+ * analyzing slow queries.
+ * Collecting statistics adds a small overhead to every query, so this
+ * should only be enabled for debugging and performance analysis.
+ *
+ * Since: 1.0.5
+ */
+void
+as_pool_set_query_stats_enabled (AsPool *pool, gboolean enabled)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	as_cache_set_query_stats_enabled (priv->cache, enabled);
+}
+
+/**
+ * as_pool_get_query_stats_report:
+ * @pool: An instance of #AsPool.
+ *
+ * Render all query statistics recorded so far into a human-readable
+ * report, with the most expensive query shapes listed first.
+ * Requires statistics collection to be enabled via
+ * %as_pool_set_query_stats_enabled.
+ *
+ * Returns: (transfer full) (nullable): the report text, or %NULL if nothing was recorded.
+ *
+ * Since: 1.0.5
+ */
+gchar *
+as_pool_get_query_stats_report (AsPool *pool)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	return as_cache_get_query_stats_report (priv->cache);
+}
+
+/**
+ * as_pool_set_progress_func:
+ * @pool: An instance of #AsPool.
+ * @func: (nullable) (scope notified): the #AsPoolProgressFn to call, or %NULL to unset.
+ * @user_data: user data for @func.
+ *
+ * Set a function to be called with fine-grained progress updates while
+ * metadata cache sections are rebuilt, e.g. during as_pool_load() on
+ * first start or after system updates.
+ * Rebuilding the cache can take a long time on slower machines, and the
+ * reported values allow displaying an actual progress bar for it.
+ *
+ * Since: 1.0.5
+ */
+void
+as_pool_set_progress_func (AsPool *pool, AsPoolProgressFn func, gpointer user_data)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	as_cache_set_progress_func (priv->cache, func, user_data);
+}
+
+/**
+ * as_pool_priors_hash_cid:
+ *
+ * 64bit FNV-1a hash of a component-ID, used as key in the popularity
+ * prior table. Unlike g_str_hash(), this is a stable part of the file
+ * format and must never change.
+ */
+static guint64
+as_pool_priors_hash_cid (const gchar *cid)
+{
+	guint64 h = G_GUINT64_CONSTANT (0xcbf29ce484222325);
+	for (const guchar *c = (const guchar *) cid; *c != '\0'; c++) {
+		h ^= *c;
+		h *= G_GUINT64_CONSTANT (0x100000001b3);
+	}
+	return h;
+}
+
+/**
+ * as_pool_priors_lookup_weight:
+ *
+ * Binary-search the mapped prior table for the given component-ID.
+ * Returns the neutral weight of 100 if no entry exists.
+ * The caller must hold at least a read lock on the pool.
+ */
+static guint
+as_pool_priors_lookup_weight (AsPoolPrivate *priv, const gchar *cid)
+{
+	guint64 cid_hash;
+	guint lo, hi;
+
+	if (priv->priors_entries == NULL || cid == NULL)
+		return 100;
+
+	cid_hash = as_pool_priors_hash_cid (cid);
+	lo = 0;
+	hi = priv->priors_n_entries;
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		const guint8 *entry = priv->priors_entries + (gsize) mid * AS_POOL_PRIORS_ENTRY_SIZE;
+		guint64 entry_hash;
+
+		memcpy (&entry_hash, entry, sizeof (entry_hash));
+		entry_hash = GUINT64_FROM_LE (entry_hash);
+		if (entry_hash == cid_hash) {
+			guint32 weight;
+			memcpy (&weight, entry + sizeof (entry_hash), sizeof (weight));
+			return GUINT32_FROM_LE (weight);
+		}
+		if (entry_hash < cid_hash)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return 100;
+}
+
+/**
+ * as_pool_load_popularity_priors:
+ * @pool: An instance of #AsPool.
+ * @fname: Filename of the prior table to load.
+ * @error: A #GError or %NULL.
+ *
+ * Load per-component popularity priors from a compact binary table,
+ * e.g. one derived from anonymized software-center interaction data.
+ * The table is memory-mapped, so even very large tables add next to no
+ * load time or memory overhead.
+ *
+ * Each component may have a prior weight in percent, with 100 being
+ * neutral. During full-text search, the relevance score of each result
+ * is multiplied with its weight, so popular components rank above
+ * equally-relevant obscure ones without a separate re-ranking pass.
+ * Tables are created with as_pool_save_popularity_priors().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.0.5
+ */
+gboolean
+as_pool_load_popularity_priors (AsPool *pool, const gchar *fname, GError **error)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GMappedFile) mfile = NULL;
+	const guint8 *data;
+	gsize len;
+	guint32 version;
+	guint32 n_entries;
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
+
+	mfile = g_mapped_file_new (fname, FALSE, error);
+	if (mfile == NULL)
+		return FALSE;
+
+	data = (const guint8 *) g_mapped_file_get_contents (mfile);
+	len = g_mapped_file_get_length (mfile);
+	if (len < AS_POOL_PRIORS_HEADER_SIZE ||
+	    memcmp (data, AS_POOL_PRIORS_MAGIC, strlen (AS_POOL_PRIORS_MAGIC)) != 0) {
+		g_set_error (error,
+			     AS_POOL_ERROR,
+			     AS_POOL_ERROR_FAILED,
+			     "File '%s' is no valid popularity prior table.",
+			     fname);
+		return FALSE;
+	}
+	memcpy (&version, data + 4, sizeof (version));
+	memcpy (&n_entries, data + 8, sizeof (n_entries));
+	version = GUINT32_FROM_LE (version);
+	n_entries = GUINT32_FROM_LE (n_entries);
+	if (version != AS_POOL_PRIORS_FORMAT_VERSION) {
+		g_set_error (error,
+			     AS_POOL_ERROR,
+			     AS_POOL_ERROR_FAILED,
+			     "Popularity prior table '%s' has unsupported version %u.",
+			     fname,
+			     version);
+		return FALSE;
+	}
+	if (len < AS_POOL_PRIORS_HEADER_SIZE + (gsize) n_entries * AS_POOL_PRIORS_ENTRY_SIZE) {
+		g_set_error (error,
+			     AS_POOL_ERROR,
+			     AS_POOL_ERROR_FAILED,
+			     "Popularity prior table '%s' is truncated.",
+			     fname);
+		return FALSE;
+	}
+
+	locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+	g_clear_pointer (&priv->priors_mfile, g_mapped_file_unref);
+	priv->priors_mfile = g_steal_pointer (&mfile);
+	priv->priors_entries = data + AS_POOL_PRIORS_HEADER_SIZE;
+	priv->priors_n_entries = n_entries;
+
+	return TRUE;
+}
+
+typedef struct {
+	guint64 cid_hash;
+	guint32 weight;
+} AsPoolPriorEntry;
+
+static gint
+as_pool_prior_entry_cmp (gconstpointer a, gconstpointer b)
+{
+	const AsPoolPriorEntry *e1 = a;
+	const AsPoolPriorEntry *e2 = b;
+	if (e1->cid_hash < e2->cid_hash)
+		return -1;
+	if (e1->cid_hash > e2->cid_hash)
+		return 1;
+	return 0;
+}
+
+/**
+ * as_pool_save_popularity_priors:
+ * @fname: Filename to write the prior table to.
+ * @prior_weights: (element-type utf8 guint): Map of component-ID to prior weight in percent.
+ * @error: A #GError or %NULL.
+ *
+ * Write a popularity prior table for use with
+ * as_pool_load_popularity_priors(). Component-IDs are stored as stable
+ * 64bit hashes, so the table stays compact regardless of ID lengths and
+ * contains no plain-text record of its input data.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.0.5
+ */
+gboolean
+as_pool_save_popularity_priors (const gchar *fname, GHashTable *prior_weights, GError **error)
+{
+	g_autoptr(GByteArray) buf = NULL;
+	g_autoptr(GArray) entries = NULL;
+	GHashTableIter iter;
+	gpointer key, value;
+	guint32 tmp_le;
+
+	entries = g_array_new (FALSE, FALSE, sizeof (AsPoolPriorEntry));
+	g_hash_table_iter_init (&iter, prior_weights);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		AsPoolPriorEntry entry;
+		entry.cid_hash = as_pool_priors_hash_cid ((const gchar *) key);
+		entry.weight = GPOINTER_TO_UINT (value);
+		g_array_append_val (entries, entry);
+	}
+	/* entries are sorted by hash, so lookups can binary-search the mapped file */
+	g_array_sort (entries, as_pool_prior_entry_cmp);
+
+	buf = g_byte_array_new ();
+	g_byte_array_append (buf,
+			     (const guint8 *) AS_POOL_PRIORS_MAGIC,
+			     strlen (AS_POOL_PRIORS_MAGIC));
+	tmp_le = GUINT32_TO_LE (AS_POOL_PRIORS_FORMAT_VERSION);
+	g_byte_array_append (buf, (const guint8 *) &tmp_le, sizeof (tmp_le));
+	tmp_le = GUINT32_TO_LE (entries->len);
+	g_byte_array_append (buf, (const guint8 *) &tmp_le, sizeof (tmp_le));
+
+	for (guint i = 0; i < entries->len; i++) {
+		AsPoolPriorEntry *entry = &g_array_index (entries, AsPoolPriorEntry, i);
+		guint64 hash_le = GUINT64_TO_LE (entry->cid_hash);
+		tmp_le = GUINT32_TO_LE (entry->weight);
+		g_byte_array_append (buf, (const guint8 *) &hash_le, sizeof (hash_le));
+		g_byte_array_append (buf, (const guint8 *) &tmp_le, sizeof (tmp_le));
+	}
+
+	return g_file_set_contents (fname, (const gchar *) buf->data, buf->len, error);
+}
+
+/**
+ * as_pool_get_popularity_prior:
+ * @pool: An instance of #AsPool.
+ * @cid: an AppStream component-ID.
+ *
+ * Get the popularity prior weight recorded for a component, in percent.
+ * Returns the neutral weight of 100 if no prior table is loaded or the
+ * component has no entry in it.
+ *
+ * Returns: the prior weight of the component.
+ *
+ * Since: 1.0.5
+ */
+guint
+as_pool_get_popularity_prior (AsPool *pool, const gchar *cid)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+	return as_pool_priors_lookup_weight (priv, cid);
+}
+
+/**
+ * as_pool_set_ranking_func:
+ * @pool: An instance of #AsPool.
+ * @func: (nullable) (scope notified): the #AsPoolRankingFn to call, or %NULL to unset.
+ * @user_data: user data for @func.
+ *
+ * Set a function to adjust the match score of every full-text search
+ * result, e.g. to fold in client-specific relevance signals that go
+ * beyond the built-in popularity priors.
+ * The hook runs while results are scored, before they are sorted and
+ * before any result limit is applied to the final list.
+ *
+ * Since: 1.0.5
+ */
+void
+as_pool_set_ranking_func (AsPool *pool, AsPoolRankingFn func, gpointer user_data)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new (&priv->rw_lock);
+	priv->ranking_fn = func;
+	priv->ranking_fn_udata = user_data;
+}
+
+/**
+ * as_pool_get_reload_stats:
+ * @pool: An instance of #AsPool.
+ * @n_triggered: (out) (optional): Change batches which requested a reload.
+ * @n_executed: (out) (optional): Cache reloads which were actually performed.
+ * @n_shed: (out) (optional): Scheduled reloads shed because a newer trigger superseded them.
+ *
+ * Get statistics about the automatic cache reloads performed by this
+ * pool in response to source data changes, which only happen if
+ * %AS_POOL_FLAG_MONITOR is set.
+ * The difference between @n_triggered and @n_executed is the amount of
+ * redundant reload work avoided by coalescing change notifications.
+ *
+ * Since: 1.0.5
+ */
+void
+as_pool_get_reload_stats (AsPool *pool,
+			  guint64 *n_triggered,
+			  guint64 *n_executed,
+			  guint64 *n_shed)
+{
+	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
+
+	if (n_triggered != NULL)
+		*n_triggered = priv->reloads_triggered;
+	if (n_executed != NULL)
+		*n_executed = priv->reloads_executed;
+	if (n_shed != NULL)
+		*n_shed = priv->reloads_shed;
+}
+
 /**
  * as_pool_get_os_metadata_cache_age:
  * @pool: An instance of #AsPool.
@@ -2628,11 +5107,11 @@ time_t
 as_pool_get_os_metadata_cache_age (AsPool *pool)
 {
 	AsPoolPrivate *priv = GET_PRIVATE (pool);
+	g_autofree gchar *section_key = NULL;
 	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new (&priv->rw_lock);
-	return as_cache_get_ctime (priv->cache,
-				   AS_COMPONENT_SCOPE_SYSTEM,
-				   OS_CATALOG_CACHE_KEY,
-				   NULL);
+
+	section_key = as_pool_build_section_cache_key (pool, OS_CATALOG_CACHE_KEY);
+	return as_cache_get_ctime (priv->cache, AS_COMPONENT_SCOPE_SYSTEM, section_key, NULL);
 }
 
 /**
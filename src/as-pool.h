@@ -30,6 +30,8 @@
 
 #include "as-component.h"
 #include "as-component-box.h"
+#include "as-pool-snapshot.h"
+#include "as-system-info.h"
 
 G_BEGIN_DECLS
 
@@ -59,6 +61,10 @@ struct _AsPoolClass {
  * @AS_POOL_FLAG_RESOLVE_ADDONS:	Always resolve addons for returned components.
  * @AS_POOL_FLAG_PREFER_OS_METAINFO:	Prefer local metainfo data over the system-provided catalog data. Useful for previewing local data.
  * @AS_POOL_FLAG_MONITOR:		Monitor registered directories for changes, and auto-reload metadata if necessary.
+ * @AS_POOL_FLAG_STRICT_LOCALE:		Only load the active locale and the untranslated fallback, ignoring other compatible locale variants. Reduces memory usage.
+ * @AS_POOL_FLAG_THROTTLE_REFRESH:	Reduce scheduling priority and yield regularly while rebuilding the metadata cache, keeping interactive sessions responsive at the cost of slower refreshes. (Since: 1.0.5)
+ * @AS_POOL_FLAG_CACHE_SEARCH_RESULTS:	Memoize ranked search results, so frequently repeated queries are answered without re-running the token matcher. Useful for storefronts. (Since: 1.0.5)
+ * @AS_POOL_FLAG_STAGED_LOAD:		Make OS data queryable as soon as it is loaded, instead of waiting for all metadata sections. #AsPool::changed is emitted once the OS data is available and again when the remaining sections (e.g. Flatpak remotes) have been merged in. (Since: 1.0.5)
  *
  * Flags controlling the metadata pool behavior.
  **/
@@ -72,6 +78,10 @@ typedef enum {
 	AS_POOL_FLAG_RESOLVE_ADDONS	   = 1 << 5,
 	AS_POOL_FLAG_PREFER_OS_METAINFO	   = 1 << 6,
 	AS_POOL_FLAG_MONITOR		   = 1 << 7,
+	AS_POOL_FLAG_STRICT_LOCALE	   = 1 << 8,
+	AS_POOL_FLAG_THROTTLE_REFRESH	   = 1 << 9,
+	AS_POOL_FLAG_CACHE_SEARCH_RESULTS  = 1 << 10,
+	AS_POOL_FLAG_STAGED_LOAD	   = 1 << 11,
 } AsPoolFlags;
 
 /**
@@ -92,6 +102,68 @@ typedef enum {
 	AS_CACHE_FLAG_REFRESH_SYSTEM = 1 << 3,
 } AsCacheFlags;
 
+/**
+ * AsPoolProgressKind:
+ * @AS_POOL_PROGRESS_KIND_SERIALIZING:	Components of a cache section are serialized. The
+ *					counters contain the amount of processed components.
+ * @AS_POOL_PROGRESS_KIND_COMPILING:	A cache section is compiled into its binary on-disk
+ *					format. The counters are zero, as no progress estimate
+ *					is available for this step.
+ * @AS_POOL_PROGRESS_KIND_WRITING:	A compiled cache section was written to disk. The
+ *					counters contain the amount of bytes written.
+ *
+ * The kind of work a progress report refers to while (re)building
+ * the metadata cache.
+ *
+ * Since: 1.0.5
+ **/
+typedef enum {
+	AS_POOL_PROGRESS_KIND_SERIALIZING,
+	AS_POOL_PROGRESS_KIND_COMPILING,
+	AS_POOL_PROGRESS_KIND_WRITING,
+} AsPoolProgressKind;
+
+/**
+ * AsPoolProgressFn:
+ * @kind: the kind of work progress is reported for.
+ * @section_key: the cache section that is being processed.
+ * @processed: amount of processed items, depending on @kind.
+ * @total: total amount of items to process, depending on @kind.
+ * @user_data: Additional data.
+ *
+ * Callback function periodically invoked while cache sections are
+ * rebuilt, e.g. during as_pool_load(). It may be called from the
+ * thread performing the load operation, so GUI applications should
+ * forward the values to their main context.
+ *
+ * Since: 1.0.5
+ */
+typedef void (*AsPoolProgressFn) (AsPoolProgressKind kind,
+				  const gchar	    *section_key,
+				  guint64	     processed,
+				  guint64	     total,
+				  gpointer	     user_data);
+
+/**
+ * AsPoolRankingFn:
+ * @pool: the #AsPool the search runs on.
+ * @cpt: the matched component.
+ * @score: the combined relevance score of the match so far.
+ * @user_data: Additional data.
+ *
+ * Callback function invoked for every full-text search result to
+ * adjust its ranking score, after any loaded popularity priors have
+ * already been applied. Results are sorted by the returned score.
+ *
+ * Returns: the new ranking score for @cpt.
+ *
+ * Since: 1.0.5
+ */
+typedef guint (*AsPoolRankingFn) (AsPool	*pool,
+				  AsComponent	*cpt,
+				  guint		 score,
+				  gpointer	 user_data);
+
 /**
  * AsPoolError:
  * @AS_POOL_ERROR_FAILED:		Generic failure
@@ -133,6 +205,7 @@ gboolean	as_pool_add_components (AsPool *pool, AsComponentBox *cbox, GError **er
 
 AsComponentBox *as_pool_get_components (AsPool *pool);
 AsComponentBox *as_pool_get_components_by_id (AsPool *pool, const gchar *cid);
+AsComponentBox *as_pool_get_components_by_ids (AsPool *pool, const gchar *const *cids);
 AsComponentBox *as_pool_get_components_by_provided_item (AsPool	       *pool,
 							 AsProvidedKind kind,
 							 const gchar   *item);
@@ -142,12 +215,42 @@ AsComponentBox *as_pool_get_components_by_launchable (AsPool	      *pool,
 						      AsLaunchableKind kind,
 						      const gchar     *id);
 AsComponentBox *as_pool_get_components_by_extends (AsPool *pool, const gchar *extended_id);
+AsComponentBox *as_pool_get_components_by_suggested (AsPool *pool, const gchar *suggested_id);
 AsComponentBox *as_pool_get_components_by_bundle_id (AsPool	 *pool,
 						     AsBundleKind kind,
 						     const gchar *bundle_id,
 						     gboolean	  match_prefix);
+GHashTable     *as_pool_get_language_stats (AsPool *pool);
+
+typedef struct _AsComponentHandle AsComponentHandle;
+
+#define AS_TYPE_COMPONENT_HANDLE (as_component_handle_get_type ())
+GType		   as_component_handle_get_type (void);
+AsComponentHandle *as_component_handle_copy (AsComponentHandle *handle);
+void		   as_component_handle_free (AsComponentHandle *handle);
+const gchar	  *as_component_handle_get_data_id (AsComponentHandle *handle);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (AsComponentHandle, as_component_handle_free)
+
+AsComponentHandle *as_pool_create_component_handle (AsPool *pool, AsComponent *cpt);
+AsComponent	  *as_pool_resolve_component_handle (AsPool *pool, AsComponentHandle *handle);
+
+GHashTable     *as_pool_check_relations (AsPool		*pool,
+					 AsComponentBox *cbox,
+					 AsSystemInfo	*sysinfo,
+					 AsRelationKind	 rel_kind);
 AsComponentBox *as_pool_search (AsPool *pool, const gchar *search);
+AsComponentBox *as_pool_search_ranked (AsPool *pool, const gchar *search, guint limit);
+void		as_pool_search_async (AsPool		 *pool,
+				      const gchar	 *search,
+				      GCancellable	 *cancellable,
+				      GAsyncReadyCallback callback,
+				      gpointer		  user_data);
+AsComponentBox *as_pool_search_finish (AsPool *pool, GAsyncResult *result, GError **error);
 gchar	      **as_pool_build_search_tokens (AsPool *pool, const gchar *search);
+void		as_pool_warm_search_index_async (AsPool *pool);
+
+AsPoolSnapshot *as_pool_freeze (AsPool *pool);
 
 void		as_pool_reset_extra_data_locations (AsPool *pool);
 void		as_pool_add_extra_data_location (AsPool	      *pool,
@@ -159,8 +262,30 @@ void		as_pool_set_flags (AsPool *pool, AsPoolFlags flags);
 void		as_pool_add_flags (AsPool *pool, AsPoolFlags flags);
 void		as_pool_remove_flags (AsPool *pool, AsPoolFlags flags);
 
+void		as_pool_add_load_kind (AsPool *pool, AsComponentKind kind);
+void		as_pool_reset_load_kinds (AsPool *pool);
+
 void		as_pool_set_load_std_data_locations (AsPool *pool, gboolean enabled);
 
+void		as_pool_set_query_stats_enabled (AsPool *pool, gboolean enabled);
+gchar	       *as_pool_get_query_stats_report (AsPool *pool);
+
+void		as_pool_get_reload_stats (AsPool *pool,
+					  guint64 *n_triggered,
+					  guint64 *n_executed,
+					  guint64 *n_shed);
+
+void		as_pool_set_progress_func (AsPool *pool, AsPoolProgressFn func, gpointer user_data);
+
+gboolean	as_pool_load_popularity_priors (AsPool	    *pool,
+						const gchar *fname,
+						GError	   **error);
+gboolean	as_pool_save_popularity_priors (const gchar *fname,
+						GHashTable  *prior_weights,
+						GError	   **error);
+guint		as_pool_get_popularity_prior (AsPool *pool, const gchar *cid);
+void		as_pool_set_ranking_func (AsPool *pool, AsPoolRankingFn func, gpointer user_data);
+
 G_END_DECLS
 
 #endif /* __AS_POOL_H */
@@ -21,8 +21,14 @@
 #include "config.h"
 
 #include <glib/gi18n-lib.h>
+#include <string.h>
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define AS_PROFILE_HAVE_MALLINFO2 1
+#endif
 
 #include "as-profile.h"
+#include "as-version.h"
 
 struct _AsProfile {
 	GObject parent_instance;
@@ -33,6 +39,8 @@ struct _AsProfile {
 	guint autodump_id;
 	guint autoprune_duration;
 	guint duration_min;
+	gboolean mem_accounting;
+	GHashTable *mem_domains; /* of utf8:AsProfileMemDomain */
 };
 
 typedef struct {
@@ -40,8 +48,16 @@ typedef struct {
 	gint64 time_start;
 	gint64 time_stop;
 	gboolean threaded;
+	gssize mem_start;
+	gboolean mem_tracked;
 } AsProfileItem;
 
+typedef struct {
+	gssize net;	 /* net heap change over all completed tasks */
+	gssize peak_task; /* largest heap growth seen in a single task */
+	guint n_tasks;
+} AsProfileMemDomain;
+
 G_DEFINE_TYPE (AsProfile, as_profile, G_TYPE_OBJECT)
 
 struct _AsProfileTask {
@@ -64,6 +80,44 @@ as_profile_item_free_cb (AsProfileItem *item, gpointer user_data)
 	as_profile_item_free (item);
 }
 
+/**
+ * as_profile_heap_in_use:
+ *
+ * Get the amount of heap memory currently handed out by the allocator,
+ * or -1 if the platform provides no cheap way to determine it.
+ */
+static gssize
+as_profile_heap_in_use (void)
+{
+#ifdef AS_PROFILE_HAVE_MALLINFO2
+	struct mallinfo2 mi = mallinfo2 ();
+	return (gssize) (mi.uordblks + mi.hblkhd);
+#else
+	return -1;
+#endif
+}
+
+/**
+ * as_profile_mem_domain_for_id:
+ *
+ * Derive the accounting domain from a task ID by dropping any per-item
+ * suffix, so e.g. "AsCache:compile-section:os-catalog" and
+ * "AsCache:compile-section:flatpak" share the "AsCache:compile-section"
+ * domain.
+ */
+static gchar *
+as_profile_mem_domain_for_id (const gchar *id)
+{
+	const gchar *colon = strchr (id, ':');
+
+	if (colon != NULL) {
+		colon = strchr (colon + 1, ':');
+		if (colon != NULL)
+			return g_strndup (id, colon - id);
+	}
+	return g_strdup (id);
+}
+
 static AsProfileItem *
 as_profile_item_find (GPtrArray *array, const gchar *id)
 {
@@ -211,6 +265,118 @@ as_profile_dump_safe (AsProfile *profile)
 	}
 }
 
+static void
+as_profile_json_append_escaped (GString *str, const gchar *text)
+{
+	for (guint i = 0; text[i] != '\0'; i++) {
+		const gchar c = text[i];
+		if (c == '"' || c == '\\')
+			g_string_append_c (str, '\\');
+		if ((guchar) c < 0x20) {
+			g_string_append_printf (str, "\\u%04x", c);
+			continue;
+		}
+		g_string_append_c (str, c);
+	}
+}
+
+/**
+ * as_profile_export_to_json: (skip)
+ * @profile: A #AsProfile
+ *
+ * Exports all recorded profiling events as a machine-readable JSON report,
+ * suitable for telemetry collection and regression tracking.
+ *
+ * Returns: (transfer full): JSON report data.
+ *
+ * Since: 1.0.5
+ **/
+gchar *
+as_profile_export_to_json (AsProfile *profile)
+{
+	GString *json;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail (AS_IS_PROFILE (profile), NULL);
+	locker = g_mutex_locker_new (&profile->mutex);
+
+	g_ptr_array_sort (profile->archived, as_profile_sort_cb);
+
+	json = g_string_new ("{\n");
+	g_string_append_printf (json,
+				"  \"appstream_version\": \"%s\",\n",
+				as_version_string ());
+	g_string_append_printf (json,
+				"  \"generated_at_us\": %" G_GINT64_FORMAT ",\n",
+				g_get_real_time ());
+	g_string_append (json, "  \"events\": [\n");
+	for (guint i = 0; i < profile->archived->len; i++) {
+		AsProfileItem *item = g_ptr_array_index (profile->archived, i);
+
+		g_string_append (json, "    {\"id\": \"");
+		as_profile_json_append_escaped (json, item->id);
+		g_string_append_printf (json,
+					"\", \"threaded\": %s, "
+					"\"start_us\": %" G_GINT64_FORMAT ", "
+					"\"duration_us\": %" G_GINT64_FORMAT "}%s\n",
+					item->threaded ? "true" : "false",
+					item->time_start,
+					item->time_stop - item->time_start,
+					(i + 1 < profile->archived->len) ? "," : "");
+	}
+	g_string_append (json, "  ]\n}");
+
+	return g_string_free (json, FALSE);
+}
+
+/**
+ * as_profile_dump_folded: (skip)
+ * @profile: A #AsProfile
+ *
+ * Dumps all recorded events to stderr in collapsed-stack format,
+ * with durations aggregated per event ID in microseconds, so the
+ * output can be fed directly to flamegraph.pl.
+ *
+ * Since: 1.0.5
+ **/
+void
+as_profile_dump_folded (AsProfile *profile)
+{
+	g_autoptr(GHashTable) totals = NULL;
+	g_autofree gpointer *keys = NULL;
+	guint n_keys = 0;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (AS_IS_PROFILE (profile));
+	locker = g_mutex_locker_new (&profile->mutex);
+
+	/* aggregate durations per event ID, with any thread prefix removed */
+	totals = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	for (guint i = 0; i < profile->archived->len; i++) {
+		AsProfileItem *item = g_ptr_array_index (profile->archived, i);
+		const gchar *id = item->id;
+		const gchar *tmp = strstr (id, "~");
+		gchar *stack;
+		gint64 duration_us;
+
+		if (tmp != NULL)
+			id = tmp + 1;
+
+		/* event IDs use colons as component separators, stacks use semicolons */
+		stack = g_strdelimit (g_strdup (id), ":", ';');
+		duration_us = (gint64) (gintptr) g_hash_table_lookup (totals, stack);
+		duration_us += item->time_stop - item->time_start;
+		g_hash_table_replace (totals, stack, (gpointer) (gintptr) duration_us);
+	}
+
+	keys = g_hash_table_get_keys_as_array (totals, &n_keys);
+	for (guint i = 0; i < n_keys; i++) {
+		const gchar *stack = keys[i];
+		gint64 duration_us = (gint64) (gintptr) g_hash_table_lookup (totals, stack);
+		g_printerr ("%s %" G_GINT64_FORMAT "\n", stack, duration_us);
+	}
+}
+
 /**
  * as_profile_start: (skip)
  * @profile: A #AsProfile
@@ -281,6 +447,10 @@ as_profile_start_literal (AsProfile *profile, const gchar *id)
 	item = g_new0 (AsProfileItem, 1);
 	item->id = g_strdup (id_thr);
 	item->time_start = g_get_real_time ();
+	if (profile->mem_accounting) {
+		item->mem_start = as_profile_heap_in_use ();
+		item->mem_tracked = item->mem_start >= 0;
+	}
 	g_ptr_array_add (profile->current, item);
 	g_debug ("run %s", id_thr);
 
@@ -326,6 +496,25 @@ as_profile_task_free_internal (AsProfile *profile, const gchar *id)
 	/* update */
 	item->time_stop = g_get_real_time ();
 
+	/* account the heap delta of this task to its domain */
+	if (item->mem_tracked) {
+		gssize mem_delta = as_profile_heap_in_use () - item->mem_start;
+		g_autofree gchar *domain = as_profile_mem_domain_for_id (id);
+		AsProfileMemDomain *mdom;
+
+		mdom = g_hash_table_lookup (profile->mem_domains, domain);
+		if (mdom == NULL) {
+			mdom = g_new0 (AsProfileMemDomain, 1);
+			g_hash_table_insert (profile->mem_domains,
+					     g_steal_pointer (&domain),
+					     mdom);
+		}
+		mdom->net += mem_delta;
+		if (mem_delta > mdom->peak_task)
+			mdom->peak_task = mem_delta;
+		mdom->n_tasks++;
+	}
+
 	/* move to archive */
 	g_ptr_array_remove (profile->current, item);
 	g_ptr_array_add (profile->archived, item);
@@ -364,6 +553,7 @@ as_profile_clear (AsProfile *profile)
 {
 	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&profile->mutex);
 	g_ptr_array_set_size (profile->archived, 0);
+	g_hash_table_remove_all (profile->mem_domains);
 }
 
 /**
@@ -414,6 +604,77 @@ as_profile_set_duration_min (AsProfile *profile, guint duration_min)
 	profile->duration_min = duration_min;
 }
 
+/**
+ * as_profile_set_mem_accounting:
+ * @profile: A #AsProfile
+ * @enabled: %TRUE to enable heap accounting
+ *
+ * Enables or disables heap allocation accounting for profiled tasks.
+ * When enabled, the heap in use is sampled when each task starts and
+ * stops, and the difference is attributed to the task's domain (the
+ * task ID up to its second colon, e.g. "AsCache:compile-section").
+ *
+ * The attribution is approximate when tasks run concurrently, since
+ * all threads share one heap, but it is cheap enough for production
+ * use and usually sufficient to pin a memory regression on a subsystem.
+ *
+ * Since: 1.0.5
+ **/
+void
+as_profile_set_mem_accounting (AsProfile *profile, gboolean enabled)
+{
+	g_return_if_fail (AS_IS_PROFILE (profile));
+	profile->mem_accounting = enabled;
+}
+
+/**
+ * as_profile_get_mem_report:
+ * @profile: A #AsProfile
+ *
+ * Creates a human-readable report of the heap allocation accounting
+ * data gathered so far, listing for each domain the net heap growth,
+ * the largest growth caused by a single task and the amount of tasks.
+ *
+ * Returns: the report as a string. Free with g_free().
+ *
+ * Since: 1.0.5
+ **/
+gchar *
+as_profile_get_mem_report (AsProfile *profile)
+{
+	GString *str;
+	g_autoptr(GList) domains = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&profile->mutex);
+
+	g_return_val_if_fail (AS_IS_PROFILE (profile), NULL);
+
+	str = g_string_new ("Heap usage by domain:\n");
+#ifndef AS_PROFILE_HAVE_MALLINFO2
+	g_string_append (str, "  (unavailable: this platform does not provide mallinfo2)\n");
+#endif
+	domains = g_list_sort (g_hash_table_get_keys (profile->mem_domains),
+			       (GCompareFunc) g_strcmp0);
+	for (GList *l = domains; l != NULL; l = l->next) {
+		const gchar *domain = l->data;
+		AsProfileMemDomain *mdom = g_hash_table_lookup (profile->mem_domains, domain);
+		g_autofree gchar *net_str = g_format_size ((guint64) ABS (mdom->net));
+		g_autofree gchar *peak_str = g_format_size ((guint64) ABS (mdom->peak_task));
+
+		g_string_append_printf (str,
+					"  %s: net %s%s, peak-task %s%s, %u task(s)\n",
+					domain,
+					mdom->net < 0 ? "-" : "+",
+					net_str,
+					mdom->peak_task < 0 ? "-" : "+",
+					peak_str,
+					mdom->n_tasks);
+	}
+	if (domains == NULL)
+		g_string_append (str, "  (no data recorded)\n");
+
+	return g_string_free (str, FALSE);
+}
+
 /**
  * as_profile_dump:
  * @profile: A #AsProfile
@@ -466,6 +727,7 @@ as_profile_finalize (GObject *object)
 	g_ptr_array_foreach (profile->current, (GFunc) as_profile_item_free_cb, NULL);
 	g_ptr_array_unref (profile->current);
 	g_ptr_array_unref (profile->archived);
+	g_hash_table_unref (profile->mem_domains);
 	g_mutex_clear (&profile->mutex);
 
 	G_OBJECT_CLASS (as_profile_parent_class)->finalize (object);
@@ -485,6 +747,7 @@ as_profile_init (AsProfile *profile)
 	profile->current = g_ptr_array_new ();
 	profile->unthreaded = g_thread_self ();
 	profile->archived = g_ptr_array_new_with_free_func ((GDestroyNotify) as_profile_item_free);
+	profile->mem_domains = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 	g_mutex_init (&profile->mutex);
 }
 
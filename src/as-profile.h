@@ -42,6 +42,10 @@ AsProfileTask		     *as_profile_start (AsProfile *profile, const gchar *fmt, ...
 void as_profile_clear (AsProfile *profile);
 void as_profile_prune (AsProfile *profile, guint duration);
 void as_profile_dump (AsProfile *profile);
+gchar *as_profile_export_to_json (AsProfile *profile) G_GNUC_WARN_UNUSED_RESULT;
+void as_profile_dump_folded (AsProfile *profile);
+void as_profile_set_mem_accounting (AsProfile *profile, gboolean enabled);
+gchar *as_profile_get_mem_report (AsProfile *profile) G_GNUC_WARN_UNUSED_RESULT;
 void as_profile_set_autodump (AsProfile *profile, guint delay);
 void as_profile_set_autoprune (AsProfile *profile, guint duration);
 void as_profile_set_duration_min (AsProfile *profile, guint duration_min);
@@ -28,6 +28,8 @@ G_BEGIN_DECLS
 
 /* NOTE: XML and YAML parsing is done in AsComponent, since we can not do it efficiently here */
 
+void as_provided_reserve_items (AsProvided *prov, guint n_items);
+
 #pragma GCC visibility pop
 G_END_DECLS
 
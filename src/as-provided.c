@@ -283,6 +283,28 @@ as_provided_add_item (AsProvided *prov, const gchar *item)
 	g_ptr_array_add (priv->items, g_strdup (item));
 }
 
+/**
+ * as_provided_reserve_items:
+ * @prov: a #AsProvided instance.
+ * @n_items: the expected amount of items.
+ *
+ * Presize the internal item storage for the expected amount of items,
+ * so adding them does not need to grow the array repeatedly.
+ * This is only a hint and has no effect if items were already added.
+ */
+void
+as_provided_reserve_items (AsProvided *prov, guint n_items)
+{
+	AsProvidedPrivate *priv = GET_PRIVATE (prov);
+
+	/* GPtrArray can only be presized at construction time, so we swap out
+	 * the empty array - if data exists already, this hint comes too late */
+	if (priv->items->len != 0 || n_items == 0)
+		return;
+	g_ptr_array_unref (priv->items);
+	priv->items = g_ptr_array_new_full (n_items, g_free);
+}
+
 /**
  * as_provided_new:
  *
@@ -1476,7 +1476,10 @@ as_relation_is_satisfied (AsRelation *relation,
 	g_autoptr(AsSystemInfo) sysinfo = NULL;
 	g_autoptr(AsRelationCheckResult) rcres = NULL;
 
-	sysinfo = (system_info == NULL) ? as_system_info_new () : g_object_ref (system_info);
+	/* use the shared system info if the caller did not provide one, so system
+	 * facts are only gathered once even when checking many components */
+	sysinfo = (system_info == NULL) ? as_system_info_get_current ()
+					: g_object_ref (system_info);
 
 	rcres = as_relation_check_result_new ();
 	as_relation_check_result_set_relation (rcres, relation);
@@ -36,6 +36,8 @@
 
 #include "as-release-private.h"
 
+#include <string.h>
+
 #include "as-utils.h"
 #include "as-utils-private.h"
 #include "as-vercmp.h"
@@ -211,7 +213,7 @@ as_release_init (AsRelease *release)
 	priv->description = g_hash_table_new_full (g_str_hash,
 						   g_str_equal,
 						   (GDestroyNotify) as_ref_string_release,
-						   g_free);
+						   (GDestroyNotify) as_ref_string_release);
 	priv->issues = g_ptr_array_new_with_free_func (g_object_unref);
 	priv->artifacts = g_ptr_array_new_with_free_func (g_object_unref);
 	priv->tags = g_ptr_array_new_with_free_func (g_free);
@@ -565,6 +567,34 @@ as_release_get_description (AsRelease *release)
 					    NULL /* locale override */);
 }
 
+/**
+ * as_release_get_description_bytes:
+ * @release: a #AsRelease instance.
+ *
+ * Get the localized release description markup as a #GBytes view of the
+ * internal storage, without copying the string data.
+ *
+ * The returned #GBytes holds a reference on the release, but the view
+ * becomes invalid as soon as the description is modified or the release
+ * is reloaded from a refreshed metadata pool. Borrow the data only for
+ * immediate consumption, e.g. for hashing during a catalog index build.
+ *
+ * Returns: (transfer full) (nullable): the description data, or %NULL if no description exists.
+ *
+ * Since: 1.0.5
+ **/
+GBytes *
+as_release_get_description_bytes (AsRelease *release)
+{
+	const gchar *value = as_release_get_description (release);
+	if (value == NULL)
+		return NULL;
+	return g_bytes_new_with_free_func (value,
+					   strlen (value),
+					   g_object_unref,
+					   g_object_ref (release));
+}
+
 /**
  * as_release_set_description:
  * @release: a #AsRelease instance.
@@ -579,7 +609,31 @@ as_release_set_description (AsRelease *release, const gchar *description, const
 	AsReleasePrivate *priv = GET_PRIVATE (release);
 	g_return_if_fail (AS_IS_RELEASE (release));
 	g_return_if_fail (description != NULL);
-	as_context_localized_ht_set (priv->context, priv->description, description, locale);
+
+	/* release descriptions are interned: distributions ship identical changelogs
+	 * in many (e.g. architecture-split) catalogs, so identical description markup
+	 * is stored only once process-wide */
+	as_context_localized_ht_set_intern (priv->context, priv->description, description, locale);
+}
+
+/**
+ * as_release_description_absorb_table:
+ *
+ * Move localized description values from a plain table into the interned
+ * release description table.
+ */
+static void
+as_release_description_absorb_table (AsRelease *release, GHashTable *tmp_desc)
+{
+	AsReleasePrivate *priv = GET_PRIVATE (release);
+	GHashTableIter iter;
+	gpointer key, value;
+
+	g_hash_table_iter_init (&iter, tmp_desc);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+		g_hash_table_insert (priv->description,
+				     g_ref_string_new_intern ((const gchar *) key),
+				     g_ref_string_new_intern ((const gchar *) value));
 }
 
 /**
@@ -936,10 +990,13 @@ as_release_load_from_xml (AsRelease *release, AsContext *ctx, xmlNode *node, GEr
 
 	for (iter = node->children; iter != NULL; iter = iter->next) {
 		g_autofree gchar *content = NULL;
+		AsTag tag_id;
 		if (iter->type != XML_ELEMENT_NODE)
 			continue;
+		tag_id = as_xml_tag_from_string ((const gchar *) iter->name);
 
-		if (as_str_equal0 (iter->name, "artifacts")) {
+		switch (tag_id) {
+		case AS_TAG_ARTIFACTS: {
 			for (xmlNode *iter2 = iter->children; iter2 != NULL; iter2 = iter2->next) {
 				g_autoptr(AsArtifact) artifact = NULL;
 
@@ -950,10 +1007,12 @@ as_release_load_from_xml (AsRelease *release, AsContext *ctx, xmlNode *node, GEr
 				if (as_artifact_load_from_xml (artifact, ctx, iter2, NULL))
 					as_release_add_artifact (release, artifact);
 			}
-		} else if (as_str_equal0 (iter->name, "description")) {
+			break;
+		}
+		case AS_TAG_DESCRIPTION: {
 			g_hash_table_remove_all (priv->description);
 			if (as_context_get_style (ctx) == AS_FORMAT_STYLE_CATALOG) {
-				g_autofree gchar *lang = NULL;
+				const gchar *lang = NULL;
 
 				/* for catalog XML, the "description" tag has a language property, so parsing it is simple */
 				content = as_xml_dump_node_children (iter);
@@ -961,9 +1020,13 @@ as_release_load_from_xml (AsRelease *release, AsContext *ctx, xmlNode *node, GEr
 				if (lang != NULL)
 					as_release_set_description (release, content, lang);
 			} else {
-				as_xml_parse_metainfo_description_node (ctx,
-									iter,
-									priv->description);
+				g_autoptr(GHashTable) tmp_desc = g_hash_table_new_full (
+				    g_str_hash,
+				    g_str_equal,
+				    (GDestroyNotify) as_ref_string_release,
+				    g_free);
+				as_xml_parse_metainfo_description_node (ctx, iter, tmp_desc);
+				as_release_description_absorb_table (release, tmp_desc);
 
 				priv->desc_translatable = TRUE;
 				prop = as_xml_get_prop_value (iter, "translatable");
@@ -972,11 +1035,15 @@ as_release_load_from_xml (AsRelease *release, AsContext *ctx, xmlNode *node, GEr
 					g_free (prop);
 				}
 			}
-		} else if (as_str_equal0 (iter->name, "url")) {
+			break;
+		}
+		case AS_TAG_URL: {
 			/* NOTE: Currently, every url in releases is a "details" URL */
 			content = as_xml_get_node_value (iter);
 			as_release_set_url (release, AS_RELEASE_URL_KIND_DETAILS, content);
-		} else if (as_str_equal0 (iter->name, "issues")) {
+			break;
+		}
+		case AS_TAG_ISSUES: {
 			for (xmlNode *iter2 = iter->children; iter2 != NULL; iter2 = iter2->next) {
 				g_autoptr(AsIssue) issue = NULL;
 
@@ -987,8 +1054,9 @@ as_release_load_from_xml (AsRelease *release, AsContext *ctx, xmlNode *node, GEr
 				if (as_issue_load_from_xml (issue, ctx, iter2, NULL))
 					as_release_add_issue (release, issue);
 			}
-
-		} else if (as_str_equal0 (iter->name, "tags")) {
+			break;
+		}
+		case AS_TAG_TAGS: {
 			for (xmlNode *sn = iter->children; sn != NULL; sn = sn->next) {
 				g_autofree gchar *ns = NULL;
 				g_autofree gchar *value = NULL;
@@ -998,6 +1066,10 @@ as_release_load_from_xml (AsRelease *release, AsContext *ctx, xmlNode *node, GEr
 				value = as_xml_get_node_value (sn);
 				as_release_add_tag (release, ns, value);
 			}
+			break;
+		}
+		default:
+			break;
 		}
 	}
 
@@ -1129,7 +1201,13 @@ as_release_load_from_yaml (AsRelease *release, AsContext *ctx, GNode *node, GErr
 		} else if (as_str_equal0 (key, "urgency")) {
 			priv->urgency = as_urgency_kind_from_string (value);
 		} else if (as_str_equal0 (key, "description")) {
-			as_yaml_set_localized_table (ctx, n, priv->description);
+			g_autoptr(GHashTable) tmp_desc = g_hash_table_new_full (
+			    g_str_hash,
+			    g_str_equal,
+			    (GDestroyNotify) as_ref_string_release,
+			    g_free);
+			as_yaml_set_localized_table (ctx, n, tmp_desc);
+			as_release_description_absorb_table (release, tmp_desc);
 		} else if (as_str_equal0 (key, "url")) {
 			GNode *urls_n;
 			AsReleaseUrlKind url_kind;
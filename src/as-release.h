@@ -135,6 +135,7 @@ guint64		 as_release_get_timestamp_eol (AsRelease *release);
 void		 as_release_set_timestamp_eol (AsRelease *release, guint64 timestamp);
 
 const gchar	*as_release_get_description (AsRelease *release);
+GBytes		*as_release_get_description_bytes (AsRelease *release);
 void as_release_set_description (AsRelease *release, const gchar *description, const gchar *locale);
 
 AsUrgencyKind as_release_get_urgency (AsRelease *release);
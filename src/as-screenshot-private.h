@@ -31,6 +31,8 @@ AS_BEGIN_PRIVATE_DECLS
 AS_INTERNAL_VISIBLE
 void	 as_screenshot_set_context_locale (AsScreenshot *screenshot, const gchar *locale);
 
+void	 as_screenshot_set_lazy_load (AsScreenshot *screenshot, gboolean lazy);
+
 gboolean as_screenshot_load_from_xml (AsScreenshot *screenshot,
 				      AsContext	   *ctx,
 				      xmlNode	   *node,
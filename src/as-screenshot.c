@@ -51,11 +51,18 @@ typedef struct {
 
 	gint position;
 	AsContext *context;
+
+	gboolean lazy_load;    /* defer deserialization of media & caption children */
+	gint lazy_done;	       /* atomic, %TRUE once no deferred data is pending */
+	xmlNode *lazy_node;    /* deferred subtree, or NULL */
+	AsContext *lazy_ctx;   /* the context the deferred subtree belongs to */
 } AsScreenshotPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (AsScreenshot, as_screenshot, G_TYPE_OBJECT)
 #define GET_PRIVATE(o) (as_screenshot_get_instance_private (o))
 
+static void as_screenshot_lazy_materialize (AsScreenshot *screenshot);
+
 /**
  * as_screenshot_init:
  **/
@@ -75,6 +82,7 @@ as_screenshot_init (AsScreenshot *screenshot)
 	priv->images_lang = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
 	priv->videos = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
 	priv->videos_lang = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	priv->lazy_done = TRUE;
 }
 
 /**
@@ -94,6 +102,10 @@ as_screenshot_finalize (GObject *object)
 	as_ref_string_release (priv->environment);
 	if (priv->context != NULL)
 		g_object_unref (priv->context);
+	if (priv->lazy_node != NULL)
+		xmlFreeNode (priv->lazy_node);
+	if (priv->lazy_ctx != NULL)
+		g_object_unref (priv->lazy_ctx);
 
 	G_OBJECT_CLASS (as_screenshot_parent_class)->finalize (object);
 }
@@ -187,6 +199,7 @@ AsScreenshotMediaKind
 as_screenshot_get_media_kind (AsScreenshot *screenshot)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	as_screenshot_lazy_materialize (screenshot);
 	return priv->media_kind;
 }
 
@@ -258,6 +271,7 @@ GPtrArray *
 as_screenshot_get_images (AsScreenshot *screenshot)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	as_screenshot_lazy_materialize (screenshot);
 	if (priv->images_lang->len == 0)
 		return as_screenshot_get_images_all (screenshot);
 	return priv->images_lang;
@@ -319,6 +333,20 @@ as_screenshot_get_image (AsScreenshot *screenshot, guint width, guint height, gu
 	return im_best;
 }
 
+/**
+ * as_screenshot_add_image_internal:
+ */
+static void
+as_screenshot_add_image_internal (AsScreenshot *screenshot, AsImage *image)
+{
+	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	g_ptr_array_add (priv->images, g_object_ref (image));
+
+	if (as_utils_locale_is_compatible (as_image_get_locale (image),
+					   as_screenshot_get_active_locale (screenshot)))
+		g_ptr_array_add (priv->images_lang, g_object_ref (image));
+}
+
 /**
  * as_screenshot_add_image:
  * @screenshot: a #AsScreenshot instance.
@@ -329,12 +357,8 @@ as_screenshot_get_image (AsScreenshot *screenshot, guint width, guint height, gu
 void
 as_screenshot_add_image (AsScreenshot *screenshot, AsImage *image)
 {
-	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
-	g_ptr_array_add (priv->images, g_object_ref (image));
-
-	if (as_utils_locale_is_compatible (as_image_get_locale (image),
-					   as_screenshot_get_active_locale (screenshot)))
-		g_ptr_array_add (priv->images_lang, g_object_ref (image));
+	as_screenshot_lazy_materialize (screenshot);
+	as_screenshot_add_image_internal (screenshot, image);
 }
 
 /**
@@ -350,6 +374,7 @@ as_screenshot_clear_images (AsScreenshot *screenshot)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
 
+	as_screenshot_lazy_materialize (screenshot);
 	g_ptr_array_remove_range (priv->images, 0, priv->images->len);
 	g_ptr_array_remove_range (priv->images_lang, 0, priv->images_lang->len);
 }
@@ -367,6 +392,7 @@ GPtrArray *
 as_screenshot_get_videos_all (AsScreenshot *screenshot)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	as_screenshot_lazy_materialize (screenshot);
 	return priv->images;
 }
 
@@ -383,11 +409,27 @@ GPtrArray *
 as_screenshot_get_videos (AsScreenshot *screenshot)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	as_screenshot_lazy_materialize (screenshot);
 	if (priv->videos_lang->len == 0)
 		return priv->videos;
 	return priv->videos_lang;
 }
 
+/**
+ * as_screenshot_add_video_internal:
+ */
+static void
+as_screenshot_add_video_internal (AsScreenshot *screenshot, AsVideo *video)
+{
+	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	priv->media_kind = AS_SCREENSHOT_MEDIA_KIND_VIDEO;
+	g_ptr_array_add (priv->videos, g_object_ref (video));
+
+	if (as_utils_locale_is_compatible (as_video_get_locale (video),
+					   as_screenshot_get_active_locale (screenshot)))
+		g_ptr_array_add (priv->videos_lang, g_object_ref (video));
+}
+
 /**
  * as_screenshot_add_video:
  * @screenshot: a #AsScreenshot instance.
@@ -398,13 +440,8 @@ as_screenshot_get_videos (AsScreenshot *screenshot)
 void
 as_screenshot_add_video (AsScreenshot *screenshot, AsVideo *video)
 {
-	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
-	priv->media_kind = AS_SCREENSHOT_MEDIA_KIND_VIDEO;
-	g_ptr_array_add (priv->videos, g_object_ref (video));
-
-	if (as_utils_locale_is_compatible (as_video_get_locale (video),
-					   as_screenshot_get_active_locale (screenshot)))
-		g_ptr_array_add (priv->videos_lang, g_object_ref (video));
+	as_screenshot_lazy_materialize (screenshot);
+	as_screenshot_add_video_internal (screenshot, video);
 }
 
 /**
@@ -419,6 +456,7 @@ const gchar *
 as_screenshot_get_caption (AsScreenshot *screenshot)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	as_screenshot_lazy_materialize (screenshot);
 	return as_context_localized_ht_get (priv->context,
 					    priv->caption,
 					    NULL /* locale override */);
@@ -435,6 +473,7 @@ void
 as_screenshot_set_caption (AsScreenshot *screenshot, const gchar *caption, const gchar *locale)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	as_screenshot_lazy_materialize (screenshot);
 	as_context_localized_ht_set (priv->context, priv->caption, caption, locale);
 }
 
@@ -450,6 +489,7 @@ gboolean
 as_screenshot_is_valid (AsScreenshot *screenshot)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	as_screenshot_lazy_materialize (screenshot);
 	return priv->images->len > 0;
 }
 
@@ -510,6 +550,11 @@ as_screenshot_set_context_locale (AsScreenshot *screenshot, const gchar *locale)
 	if (priv->context == NULL) {
 		g_autoptr(AsContext) context = as_context_new ();
 		as_screenshot_set_context (screenshot, context);
+	} else if (as_context_is_sealed (priv->context)) {
+		/* never modify a sealed context - it may be shared with other
+		 * threads without locking, so swap in a private copy instead */
+		g_autoptr(AsContext) context = as_context_clone_unsealed (priv->context);
+		as_screenshot_set_context (screenshot, context);
 	}
 	as_context_set_locale (priv->context, locale);
 	as_screenshot_rebuild_suitable_media_list (screenshot);
@@ -530,6 +575,7 @@ GPtrArray *
 as_screenshot_get_images_all (AsScreenshot *screenshot)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	as_screenshot_lazy_materialize (screenshot);
 	return priv->images;
 }
 
@@ -605,6 +651,93 @@ as_screenshot_set_position (AsScreenshot *screenshot, gint pos)
 	priv->position = pos;
 }
 
+/**
+ * as_screenshot_load_children_from_xml:
+ *
+ * Deserialize the media and caption children of a screenshot node.
+ */
+static void
+as_screenshot_load_children_from_xml (AsScreenshot *screenshot, AsContext *ctx, xmlNode *node)
+{
+	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+
+	for (xmlNode *iter = node->children; iter != NULL; iter = iter->next) {
+		AsTag tag_id;
+		/* discard spaces */
+		if (iter->type != XML_ELEMENT_NODE)
+			continue;
+		tag_id = as_xml_tag_from_string ((const gchar *) iter->name);
+
+		if (tag_id == AS_TAG_IMAGE) {
+			g_autoptr(AsImage) image = as_image_new ();
+			if (as_image_load_from_xml (image, ctx, iter, NULL))
+				as_screenshot_add_image_internal (screenshot, image);
+		} else if (tag_id == AS_TAG_VIDEO) {
+			g_autoptr(AsVideo) video = as_video_new ();
+			if (as_video_load_from_xml (video, ctx, iter, NULL))
+				as_screenshot_add_video_internal (screenshot, video);
+		} else if (tag_id == AS_TAG_CAPTION) {
+			g_autofree gchar *content = NULL;
+			const gchar *lang = NULL;
+
+			content = as_xml_get_node_value (iter);
+			if (content == NULL)
+				continue;
+
+			lang = as_xml_get_node_locale_match (ctx, iter);
+			if (lang != NULL)
+				as_context_localized_ht_set (priv->context,
+							     priv->caption,
+							     content,
+							     lang);
+		}
+	}
+}
+
+/**
+ * as_screenshot_lazy_materialize:
+ *
+ * Deserialize the media & caption subtree whose parsing was deferred
+ * by a lazy screenshot load.
+ * This function is threadsafe, so lazy screenshots may be part of
+ * components that are shared between multiple users.
+ */
+static void
+as_screenshot_lazy_materialize (AsScreenshot *screenshot)
+{
+	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	static GMutex mutex;
+
+	if (G_LIKELY (g_atomic_int_get (&priv->lazy_done)))
+		return;
+
+	g_mutex_lock (&mutex);
+	if (priv->lazy_node != NULL) {
+		as_screenshot_load_children_from_xml (screenshot, priv->lazy_ctx, priv->lazy_node);
+		as_screenshot_rebuild_suitable_media_list (screenshot);
+		g_clear_pointer (&priv->lazy_node, xmlFreeNode);
+		g_clear_object (&priv->lazy_ctx);
+	}
+	g_atomic_int_set (&priv->lazy_done, TRUE);
+	g_mutex_unlock (&mutex);
+}
+
+/**
+ * as_screenshot_set_lazy_load:
+ * @screenshot: an #AsScreenshot instance.
+ * @lazy: %TRUE to defer deserialization of media & caption data.
+ *
+ * Make a subsequent XML load defer deserialization of this screenshot's
+ * media and caption children until the data is accessed for the first
+ * time. Only the screenshot attributes are parsed immediately.
+ */
+void
+as_screenshot_set_lazy_load (AsScreenshot *screenshot, gboolean lazy)
+{
+	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
+	priv->lazy_load = lazy;
+}
+
 /**
  * as_screenshot_load_from_xml:
  * @screenshot: an #AsScreenshot instance.
@@ -621,7 +754,6 @@ as_screenshot_load_from_xml (AsScreenshot *screenshot,
 			     GError **error)
 {
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
-	xmlNode *iter;
 	g_autofree gchar *prop = NULL;
 	gboolean children_found = FALSE;
 
@@ -636,34 +768,10 @@ as_screenshot_load_from_xml (AsScreenshot *screenshot,
 	as_ref_string_assign_transfer (&priv->environment,
 				       as_xml_get_prop_value_refstr (node, "environment"));
 
-	/* screenshot media */
-	for (iter = node->children; iter != NULL; iter = iter->next) {
-		const gchar *node_name;
-		/* discard spaces */
-		if (iter->type != XML_ELEMENT_NODE)
-			continue;
-		node_name = (const gchar *) iter->name;
-		children_found = TRUE;
-
-		if (g_strcmp0 (node_name, "image") == 0) {
-			g_autoptr(AsImage) image = as_image_new ();
-			if (as_image_load_from_xml (image, ctx, iter, NULL))
-				as_screenshot_add_image (screenshot, image);
-		} else if (g_strcmp0 (node_name, "video") == 0) {
-			g_autoptr(AsVideo) video = as_video_new ();
-			if (as_video_load_from_xml (video, ctx, iter, NULL))
-				as_screenshot_add_video (screenshot, video);
-		} else if (g_strcmp0 (node_name, "caption") == 0) {
-			g_autofree gchar *content = NULL;
-			g_autofree gchar *lang = NULL;
-
-			content = as_xml_get_node_value (iter);
-			if (content == NULL)
-				continue;
-
-			lang = as_xml_get_node_locale_match (ctx, iter);
-			if (lang != NULL)
-				as_screenshot_set_caption (screenshot, content, lang);
+	for (xmlNode *iter = node->children; iter != NULL; iter = iter->next) {
+		if (iter->type == XML_ELEMENT_NODE) {
+			children_found = TRUE;
+			break;
 		}
 	}
 
@@ -675,9 +783,17 @@ as_screenshot_load_from_xml (AsScreenshot *screenshot,
 		g_autoptr(AsImage) image = as_image_new ();
 
 		if (as_image_load_from_xml (image, ctx, node, NULL))
-			as_screenshot_add_image (screenshot, image);
+			as_screenshot_add_image_internal (screenshot, image);
 		else
 			return FALSE; /* this screenshot is invalid */
+	} else if (priv->lazy_load) {
+		/* defer the (comparatively expensive) deserialization of all media
+		 * and caption children until the data is actually requested */
+		priv->lazy_node = xmlCopyNode (node, 1);
+		priv->lazy_ctx = g_object_ref (ctx);
+		g_atomic_int_set (&priv->lazy_done, FALSE);
+	} else {
+		as_screenshot_load_children_from_xml (screenshot, ctx, node);
 	}
 
 	/* propagate context - we do this last so the image list for the selected locale is rebuilt properly */
@@ -700,6 +816,8 @@ as_screenshot_to_xml_node (AsScreenshot *screenshot, AsContext *ctx, xmlNode *ro
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
 	xmlNode *subnode;
 
+	as_screenshot_lazy_materialize (screenshot);
+
 	subnode = as_xml_add_node (root, "screenshot");
 	if (priv->kind == AS_SCREENSHOT_KIND_DEFAULT)
 		as_xml_add_text_prop (subnode, "type", "default");
@@ -798,6 +916,8 @@ as_screenshot_emit_yaml (AsScreenshot *screenshot, AsContext *ctx, yaml_emitter_
 	AsScreenshotPrivate *priv = GET_PRIVATE (screenshot);
 	AsImage *source_img = NULL;
 
+	as_screenshot_lazy_materialize (screenshot);
+
 	as_yaml_mapping_start (emitter);
 
 	if (priv->kind == AS_SCREENSHOT_KIND_DEFAULT)
@@ -143,6 +143,63 @@ as_spdx_license_tokenize_drop (AsSpdxHelper *helper)
 	g_string_truncate (helper->collect, 0);
 }
 
+/**
+ * as_spdx_license_info_table:
+ *
+ * A lazily-built lookup table over the known SPDX license IDs,
+ * to avoid scanning the whole license list on every ID test.
+ */
+static GHashTable *
+as_spdx_license_info_table (void)
+{
+	static GHashTable *table = NULL;
+
+	if (g_once_init_enter (&table)) {
+		GHashTable *tmp = g_hash_table_new (g_str_hash, g_str_equal);
+		for (guint i = 0; as_spdx_license_info_list[i].id != NULL; i++)
+			g_hash_table_insert (tmp,
+					     (gchar *) as_spdx_license_info_list[i].id,
+					     &as_spdx_license_info_list[i]);
+		g_once_init_leave (&table, tmp);
+	}
+
+	return table;
+}
+
+/**
+ * as_spdx_exception_info_table:
+ *
+ * A lazily-built lookup table over the known SPDX license exception IDs.
+ */
+static GHashTable *
+as_spdx_exception_info_table (void)
+{
+	static GHashTable *table = NULL;
+
+	if (g_once_init_enter (&table)) {
+		GHashTable *tmp = g_hash_table_new (g_str_hash, g_str_equal);
+		for (guint i = 0; as_spdx_exception_info_list[i].id != NULL; i++)
+			g_hash_table_insert (tmp,
+					     (gchar *) as_spdx_exception_info_list[i].id,
+					     &as_spdx_exception_info_list[i]);
+		g_once_init_leave (&table, tmp);
+	}
+
+	return table;
+}
+
+/**
+ * as_spdx_license_info_lookup:
+ *
+ * Find the license info entry for a single SPDX license ID,
+ * or %NULL if the ID is not a known SPDX license.
+ */
+static const AsSpdxLicenseInfo *
+as_spdx_license_info_lookup (const gchar *license_id)
+{
+	return g_hash_table_lookup (as_spdx_license_info_table (), license_id);
+}
+
 /**
  * as_is_spdx_license_id:
  * @license_id: a single SPDX license ID, e.g. "GPL-3.0"
@@ -166,12 +223,7 @@ as_is_spdx_license_id (const gchar *license_id)
 	if (g_str_has_prefix (license_id, "LicenseRef-"))
 		return TRUE;
 
-	for (guint i = 0; as_spdx_license_info_list[i].id != NULL; i++) {
-		if (as_str_equal0 (as_spdx_license_info_list[i].id, license_id))
-			return TRUE;
-	}
-
-	return FALSE;
+	return as_spdx_license_info_lookup (license_id) != NULL;
 }
 
 /**
@@ -193,14 +245,288 @@ as_is_spdx_license_exception_id (const gchar *exception_id)
 	if (exception_id == NULL || exception_id[0] == '\0')
 		return FALSE;
 
-	for (guint i = 0; as_spdx_exception_info_list[i].id != NULL; i++) {
-		if (as_str_equal0 (as_spdx_exception_info_list[i].id, exception_id))
-			return TRUE;
+	return g_hash_table_contains (as_spdx_exception_info_table (), exception_id);
+}
+
+typedef struct {
+	GRefString *value;		/* interned token, e.g. "@GPL-2.0+" or "&" */
+	const AsSpdxLicenseInfo *linfo; /* info entry, if the token is a known SPDX license ID */
+	gboolean id_valid;		/* the "@"-stripped token is a valid license ID */
+	gboolean raw_id_valid;		/* the raw token is a valid license ID */
+	gboolean is_exception;		/* the "@"-stripped token is a known license exception */
+	gboolean is_metadata_id;	/* the token is a vetted metadata license ID */
+} AsSpdxExprToken;
+
+/* verdicts which we precompute for a compiled license expression */
+typedef enum {
+	AS_SPDX_EXPR_NONE     = 0,
+	AS_SPDX_EXPR_VALID    = 1 << 0,
+	AS_SPDX_EXPR_FREE     = 1 << 1,
+	AS_SPDX_EXPR_METADATA = 1 << 2,
+} AsSpdxExprFlags;
+
+/**
+ * AsSpdxExpr:
+ *
+ * A license expression compiled into classified tokens over interned
+ * license IDs, with all expensive verdicts computed just once.
+ */
+typedef struct {
+	AsSpdxExprToken *tokens;
+	guint n_tokens;
+	AsSpdxExprFlags flags;
+} AsSpdxExpr;
+
+static void
+as_spdx_expr_free (AsSpdxExpr *expr)
+{
+	for (guint i = 0; i < expr->n_tokens; i++)
+		as_ref_string_release (expr->tokens[i].value);
+	g_free (expr->tokens);
+	g_free (expr);
+}
+
+/**
+ * as_spdx_expr_eval_valid:
+ *
+ * Check whether the compiled expression is a valid SPDX license expression,
+ * mirroring the logic of as_is_spdx_license_expression().
+ */
+static gboolean
+as_spdx_expr_eval_valid (const AsSpdxExpr *expr)
+{
+	gboolean expect_exception = FALSE;
+
+	for (guint i = 0; i < expr->n_tokens; i++) {
+		const AsSpdxExprToken *tok = &expr->tokens[i];
+		const gchar *value = tok->value;
+
+		if (value[0] == '@') {
+			if (expect_exception) {
+				expect_exception = FALSE;
+				if (tok->is_exception)
+					continue;
+			} else {
+				if (tok->id_valid)
+					continue;
+			}
+		}
+		if (tok->raw_id_valid)
+			continue;
+		if (g_strcmp0 (value, "&") == 0)
+			continue;
+		if (g_strcmp0 (value, "|") == 0)
+			continue;
+		if (g_strcmp0 (value, "+") == 0)
+			continue;
+		if (g_strcmp0 (value, "(") == 0)
+			continue;
+		if (g_strcmp0 (value, ")") == 0)
+			continue;
+		if (g_strcmp0 (value, "^") == 0) {
+			expect_exception = TRUE;
+			continue;
+		}
+		return FALSE;
 	}
 
+	return TRUE;
+}
+
+/**
+ * as_spdx_expr_eval_free:
+ *
+ * Check whether the compiled expression only contains free-as-in-freedom
+ * licenses, mirroring the logic of as_license_is_free_license().
+ */
+static gboolean
+as_spdx_expr_eval_free (const AsSpdxExpr *expr)
+{
+	/* assume we have a free software license, unless proven otherwise */
+	gboolean is_free = TRUE;
+
+	for (guint i = 0; i < expr->n_tokens; i++) {
+		const AsSpdxExprToken *tok = &expr->tokens[i];
+		const gchar *value = tok->value;
+
+		if (g_strcmp0 (value, "&") == 0 || g_strcmp0 (value, "+") == 0 ||
+		    g_strcmp0 (value, "|") == 0 || g_strcmp0 (value, "^") == 0 ||
+		    g_strcmp0 (value, "(") == 0 || g_strcmp0 (value, ")") == 0)
+			continue;
+
+		if (g_str_has_prefix (value, "@LicenseRef")) {
+			/* we only consider license ref's to be free if they explicitly state so */
+			if (!g_str_has_prefix (value, "@LicenseRef-free")) {
+				is_free = FALSE;
+				break;
+			}
+		} else if (g_str_has_prefix (value, "@NOASSERTION") ||
+			   g_str_has_prefix (value, "@NONE")) {
+			/* no license info is fishy as well */
+			is_free = FALSE;
+			break;
+		}
+
+		if (value[0] != '@') {
+			/* if token has no license-id prefix, consider the license to be non-free */
+			is_free = FALSE;
+			break;
+		}
+
+		if (tok->is_exception) {
+			/* for now, we assume any SPDX license exception is still fine and doesn't change the
+			 * "free-ness" status of a software component */
+			continue;
+		}
+
+		/* check the free-ness status of this license ID */
+		is_free = (tok->linfo != NULL) ? tok->linfo->is_floss : FALSE;
+		if (!is_free)
+			break;
+	}
+
+	return is_free;
+}
+
+/**
+ * as_spdx_expr_eval_metadata_license:
+ *
+ * Check whether the compiled expression is a suitable metadata license,
+ * mirroring the logic of as_license_is_metadata_license().
+ */
+static gboolean
+as_spdx_expr_eval_metadata_license (const AsSpdxExpr *expr)
+{
+	gboolean requires_all_tokens = TRUE;
+	guint license_bad_cnt = 0;
+	guint license_good_cnt = 0;
+
+	/* this is too complicated to process */
+	for (guint i = 0; i < expr->n_tokens; i++) {
+		const gchar *value = expr->tokens[i].value;
+		if (g_strcmp0 (value, "(") == 0 || g_strcmp0 (value, ")") == 0)
+			return FALSE;
+	}
+
+	/* this is a simple expression parser and can be easily tricked */
+	for (guint i = 0; i < expr->n_tokens; i++) {
+		const AsSpdxExprToken *tok = &expr->tokens[i];
+
+		if (g_strcmp0 (tok->value, "+") == 0)
+			continue;
+		if (g_strcmp0 (tok->value, "|") == 0) {
+			requires_all_tokens = FALSE;
+			continue;
+		}
+		if (g_strcmp0 (tok->value, "&") == 0) {
+			requires_all_tokens = TRUE;
+			continue;
+		}
+		if (tok->is_metadata_id)
+			license_good_cnt++;
+		else
+			license_bad_cnt++;
+	}
+
+	/* any valid token makes this valid */
+	if (!requires_all_tokens && license_good_cnt > 0)
+		return TRUE;
+
+	/* all tokens are required to be valid */
+	if (requires_all_tokens && license_bad_cnt == 0)
+		return TRUE;
+
+	/* looks like the license was bad */
 	return FALSE;
 }
 
+/**
+ * as_spdx_expr_compile:
+ *
+ * Tokenize a license expression once and classify all of its tokens,
+ * then precompute all verdicts so the result is immutable.
+ */
+static AsSpdxExpr *
+as_spdx_expr_compile (const gchar *license)
+{
+	AsSpdxExpr *expr;
+	g_auto(GStrv) tokens = NULL;
+
+	tokens = as_spdx_license_tokenize (license);
+	if (tokens == NULL)
+		return NULL;
+
+	expr = g_new0 (AsSpdxExpr, 1);
+	expr->n_tokens = g_strv_length (tokens);
+	expr->tokens = g_new0 (AsSpdxExprToken, expr->n_tokens);
+	for (guint i = 0; i < expr->n_tokens; i++) {
+		AsSpdxExprToken *tok = &expr->tokens[i];
+		const gchar *value = tokens[i];
+
+		tok->value = g_ref_string_new_intern (value);
+		if (value[0] == '@') {
+			tok->linfo = as_spdx_license_info_lookup (value + 1);
+			tok->id_valid = as_is_spdx_license_id (value + 1);
+			tok->is_exception = as_is_spdx_license_exception_id (value + 1);
+		}
+		tok->raw_id_valid = as_is_spdx_license_id (value);
+		tok->is_metadata_id = as_license_is_metadata_license_id (value);
+	}
+
+	if (as_spdx_expr_eval_valid (expr))
+		expr->flags |= AS_SPDX_EXPR_VALID;
+	if (as_spdx_expr_eval_free (expr))
+		expr->flags |= AS_SPDX_EXPR_FREE;
+	if (as_spdx_expr_eval_metadata_license (expr))
+		expr->flags |= AS_SPDX_EXPR_METADATA;
+
+	return expr;
+}
+
+/* protects the global cache of compiled license expressions */
+static GMutex as_spdx_expr_cache_mutex;
+static GHashTable *as_spdx_expr_cache = NULL;
+
+/* maximum amount of compiled license expressions we keep around */
+#define AS_SPDX_EXPR_CACHE_MAX_SIZE 512
+
+/**
+ * as_spdx_expr_get_flags:
+ *
+ * Obtain the precomputed verdict flags for a license expression,
+ * compiling and caching its parsed representation if necessary.
+ */
+static AsSpdxExprFlags
+as_spdx_expr_get_flags (const gchar *license)
+{
+	AsSpdxExpr *expr;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	if (license == NULL)
+		return AS_SPDX_EXPR_NONE;
+
+	locker = g_mutex_locker_new (&as_spdx_expr_cache_mutex);
+	if (G_UNLIKELY (as_spdx_expr_cache == NULL))
+		as_spdx_expr_cache = g_hash_table_new_full (g_str_hash,
+							    g_str_equal,
+							    g_free,
+							    (GDestroyNotify) as_spdx_expr_free);
+
+	expr = g_hash_table_lookup (as_spdx_expr_cache, license);
+	if (expr == NULL) {
+		expr = as_spdx_expr_compile (license);
+		if (expr == NULL)
+			return AS_SPDX_EXPR_NONE;
+
+		/* keep the cache from growing indefinitely on hostile input */
+		if (g_hash_table_size (as_spdx_expr_cache) >= AS_SPDX_EXPR_CACHE_MAX_SIZE)
+			g_hash_table_remove_all (as_spdx_expr_cache);
+		g_hash_table_insert (as_spdx_expr_cache, g_strdup (license), expr);
+	}
+
+	return expr->flags;
+}
+
 /**
  * as_is_spdx_license_expression:
  * @license: a SPDX license string, e.g. "CC-BY-3.0 and GFDL-1.3"
@@ -215,10 +541,6 @@ as_is_spdx_license_exception_id (const gchar *exception_id)
 gboolean
 as_is_spdx_license_expression (const gchar *license)
 {
-	guint i;
-	g_auto(GStrv) tokens = NULL;
-	gboolean expect_exception = FALSE;
-
 	/* handle nothing set */
 	if (as_is_empty (license))
 		return FALSE;
@@ -231,41 +553,7 @@ as_is_spdx_license_expression (const gchar *license)
 	if (g_strcmp0 (license, "NOASSERTION") == 0)
 		return TRUE;
 
-	tokens = as_spdx_license_tokenize (license);
-	if (tokens == NULL)
-		return FALSE;
-
-	for (i = 0; tokens[i] != NULL; i++) {
-		if (tokens[i][0] == '@') {
-			if (expect_exception) {
-				expect_exception = FALSE;
-				if (as_is_spdx_license_exception_id (tokens[i] + 1))
-					continue;
-			} else {
-				if (as_is_spdx_license_id (tokens[i] + 1))
-					continue;
-			}
-		}
-		if (as_is_spdx_license_id (tokens[i]))
-			continue;
-		if (g_strcmp0 (tokens[i], "&") == 0)
-			continue;
-		if (g_strcmp0 (tokens[i], "|") == 0)
-			continue;
-		if (g_strcmp0 (tokens[i], "+") == 0)
-			continue;
-		if (g_strcmp0 (tokens[i], "(") == 0)
-			continue;
-		if (g_strcmp0 (tokens[i], ")") == 0)
-			continue;
-		if (g_strcmp0 (tokens[i], "^") == 0) {
-			expect_exception = TRUE;
-			continue;
-		}
-		return FALSE;
-	}
-
-	return TRUE;
+	return as_flags_contains (as_spdx_expr_get_flags (license), AS_SPDX_EXPR_VALID);
 }
 
 /**
@@ -594,52 +882,7 @@ as_license_is_metadata_license_id (const gchar *license_id)
 gboolean
 as_license_is_metadata_license (const gchar *license)
 {
-	gboolean requires_all_tokens = TRUE;
-	guint license_bad_cnt = 0;
-	guint license_good_cnt = 0;
-	g_auto(GStrv) tokens = NULL;
-
-	tokens = as_spdx_license_tokenize (license);
-	/* not a valid SPDX expression */
-	if (tokens == NULL)
-		return FALSE;
-
-	/* this is too complicated to process */
-	for (guint i = 0; tokens[i] != NULL; i++) {
-		if (g_strcmp0 (tokens[i], "(") == 0 || g_strcmp0 (tokens[i], ")") == 0) {
-			return FALSE;
-		}
-	}
-
-	/* this is a simple expression parser and can be easily tricked */
-	for (guint i = 0; tokens[i] != NULL; i++) {
-		if (g_strcmp0 (tokens[i], "+") == 0)
-			continue;
-		if (g_strcmp0 (tokens[i], "|") == 0) {
-			requires_all_tokens = FALSE;
-			continue;
-		}
-		if (g_strcmp0 (tokens[i], "&") == 0) {
-			requires_all_tokens = TRUE;
-			continue;
-		}
-		if (as_license_is_metadata_license_id (tokens[i])) {
-			license_good_cnt++;
-		} else {
-			license_bad_cnt++;
-		}
-	}
-
-	/* any valid token makes this valid */
-	if (!requires_all_tokens && license_good_cnt > 0)
-		return TRUE;
-
-	/* all tokens are required to be valid */
-	if (requires_all_tokens && license_bad_cnt == 0)
-		return TRUE;
-
-	/* looks like the license was bad */
-	return FALSE;
+	return as_flags_contains (as_spdx_expr_get_flags (license), AS_SPDX_EXPR_METADATA);
 }
 
 /**
@@ -656,6 +899,7 @@ gchar *
 as_get_license_name (const gchar *license)
 {
 	g_autoptr(GString) license_id = NULL;
+	const AsSpdxLicenseInfo *linfo;
 
 	if (license == NULL)
 		return NULL;
@@ -671,10 +915,9 @@ as_get_license_name (const gchar *license)
 	if (!as_is_spdx_license_id (license_id->str))
 		return NULL;
 
-	for (guint i = 0; as_spdx_license_info_list[i].id != NULL; i++) {
-		if (as_str_equal0 (as_spdx_license_info_list[i].id, license_id->str))
-			return g_strdup (as_spdx_license_info_list[i].name);
-	}
+	linfo = as_spdx_license_info_lookup (license_id->str);
+	if (linfo != NULL)
+		return g_strdup (linfo->name);
 
 	return NULL;
 }
@@ -774,69 +1017,11 @@ as_get_license_url (const gchar *license)
 gboolean
 as_license_is_free_license (const gchar *license)
 {
-	g_auto(GStrv) tokens = NULL;
-	gboolean is_free;
-
 	/* no license at all is "non-free" */
 	if (as_is_empty (license))
 		return FALSE;
 	if (g_strcmp0 (license, "NONE") == 0)
 		return FALSE;
 
-	/* assume we have a free software license, unless proven otherwise */
-	is_free = TRUE;
-	tokens = as_spdx_license_tokenize (license);
-	if (tokens == NULL)
-		return FALSE;
-	for (guint i = 0; tokens[i] != NULL; i++) {
-		const gchar *license_id;
-
-		if (g_strcmp0 (tokens[i], "&") == 0 || g_strcmp0 (tokens[i], "+") == 0 ||
-		    g_strcmp0 (tokens[i], "|") == 0 || g_strcmp0 (tokens[i], "^") == 0 ||
-		    g_strcmp0 (tokens[i], "(") == 0 || g_strcmp0 (tokens[i], ")") == 0)
-			continue;
-
-		if (g_str_has_prefix (tokens[i], "@LicenseRef")) {
-			/* we only consider license ref's to be free if they explicitly state so */
-			if (!g_str_has_prefix (tokens[i], "@LicenseRef-free")) {
-				is_free = FALSE;
-				break;
-			}
-		} else if (g_str_has_prefix (tokens[i], "@NOASSERTION") ||
-			   g_str_has_prefix (tokens[i], "@NONE")) {
-			/* no license info is fishy as well */
-			is_free = FALSE;
-			break;
-		}
-
-		if (tokens[i][0] != '@') {
-			/* if token has no license-id prefix, consider the license to be non-free */
-			is_free = FALSE;
-			break;
-		}
-
-		license_id = tokens[i] + 1;
-		if (as_is_spdx_license_exception_id (license_id)) {
-			/* for now, we assume any SPDX license exception is still fine and doesn't change the
-			 * "free-ness" status of a software component */
-			continue;
-		}
-
-		/* assume non-free by default from now on */
-		is_free = FALSE;
-
-		/* check our list of free licenses */
-		for (guint k = 0; as_spdx_license_info_list[k].id != NULL; k++) {
-			if (as_str_equal0 (as_spdx_license_info_list[k].id, license_id)) {
-				/* save the free-ness status */
-				is_free = as_spdx_license_info_list[k].is_floss;
-				break;
-			}
-		}
-
-		if (!is_free)
-			break;
-	}
-
-	return is_free;
+	return as_flags_contains (as_spdx_expr_get_flags (license), AS_SPDX_EXPR_FREE);
 }
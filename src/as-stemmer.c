@@ -38,15 +38,43 @@
 struct _AsStemmer {
 	GObject parent_instance;
 
-	struct sb_stemmer *sb;
 	gchar *current_lang;
 	GMutex mutex;
+
+	GHashTable *memo; /* term -> stemmed term ("" for filtered tokens) */
+	GRWLock memo_lock;
 };
 
+/* upper bound for the term->stem memoization table, to keep its memory use
+ * in check when untrusted data floods us with unique tokens */
+#define AS_STEMMER_MEMO_MAX_ENTRIES 16384
+
 G_DEFINE_TYPE (AsStemmer, as_stemmer, G_TYPE_OBJECT)
 
 static gpointer as_stemmer_object = NULL;
 
+#ifdef HAVE_STEMMING
+/* Snowball stemmers are cheap to build but not thread-safe, so every thread
+ * keeps its own instance. The shared stemmer object only holds the current
+ * language; a global serial is bumped on each language change, and threads
+ * rebuild their private instance lazily when they notice a stale serial. */
+typedef struct {
+	struct sb_stemmer *sb;
+	gint serial;
+} AsStemmerTL;
+
+static gint as_stemmer_lang_serial = 0;
+
+static void
+as_stemmer_tl_free (AsStemmerTL *tl)
+{
+	sb_stemmer_delete (tl->sb);
+	g_free (tl);
+}
+
+static GPrivate as_stemmer_tls = G_PRIVATE_INIT ((GDestroyNotify) as_stemmer_tl_free);
+#endif
+
 static void as_stemmer_reload_internal (AsStemmer *stemmer, const gchar *locale, gboolean force);
 
 /**
@@ -58,7 +86,9 @@ as_stemmer_finalize (GObject *object)
 #ifdef HAVE_STEMMING
 	AsStemmer *stemmer = AS_STEMMER (object);
 
-	sb_stemmer_delete (stemmer->sb);
+	g_free (stemmer->current_lang);
+	g_hash_table_unref (stemmer->memo);
+	g_rw_lock_clear (&stemmer->memo_lock);
 	g_mutex_clear (&stemmer->mutex);
 #endif
 
@@ -75,6 +105,8 @@ as_stemmer_init (AsStemmer *stemmer)
 	g_autofree gchar *locale = NULL;
 
 	g_mutex_init (&stemmer->mutex);
+	g_rw_lock_init (&stemmer->memo_lock);
+	stemmer->memo = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 
 	/* we don't use the locale in XML, so it can be POSIX */
 	locale = as_get_current_locale_posix ();
@@ -102,13 +134,14 @@ as_stemmer_reload_internal (AsStemmer *stemmer, const gchar *locale, gboolean fo
 	g_free (stemmer->current_lang);
 	stemmer->current_lang = g_steal_pointer (&lang);
 
-	/* reload stemmer */
-	sb_stemmer_delete (stemmer->sb);
-	stemmer->sb = sb_stemmer_new (stemmer->current_lang, NULL);
-	if (stemmer->sb == NULL)
-		g_debug ("Language %s can not be stemmed.", stemmer->current_lang);
-	else
-		g_debug ("Stemming language is now: %s", stemmer->current_lang);
+	/* make all per-thread stemmer instances rebuild themselves lazily */
+	g_atomic_int_inc (&as_stemmer_lang_serial);
+	g_debug ("Stemming language is now: %s", stemmer->current_lang);
+
+	/* all memoized stems belonged to the previous language */
+	g_rw_lock_writer_lock (&stemmer->memo_lock);
+	g_hash_table_remove_all (stemmer->memo);
+	g_rw_lock_writer_unlock (&stemmer->memo_lock);
 
 	g_mutex_locker_free (locker);
 #endif
@@ -142,24 +175,72 @@ as_stemmer_stem (AsStemmer *stemmer, const gchar *term)
 {
 #ifdef HAVE_STEMMING
 	gchar *result;
-	GMutexLocker *locker = g_mutex_locker_new (&stemmer->mutex);
-	if (stemmer->sb == NULL) {
+	const gchar *cached;
+	AsStemmerTL *tl;
+	gint serial;
+
+	/* fast path: terms repeat a lot while token caches are built, so we
+	 * likely know the stem already and can answer under a shared lock */
+	g_rw_lock_reader_lock (&stemmer->memo_lock);
+	cached = g_hash_table_lookup (stemmer->memo, term);
+	if (cached != NULL) {
+		result = (cached[0] == '\0') ? NULL : g_strdup (cached);
+		g_rw_lock_reader_unlock (&stemmer->memo_lock);
+		return result;
+	}
+	g_rw_lock_reader_unlock (&stemmer->memo_lock);
+
+	tl = g_private_get (&as_stemmer_tls);
+	if (tl == NULL) {
+		tl = g_new0 (AsStemmerTL, 1);
+		tl->serial = -1;
+		g_private_set (&as_stemmer_tls, tl);
+	}
+
+	serial = g_atomic_int_get (&as_stemmer_lang_serial);
+	if (tl->serial != serial) {
+		g_autofree gchar *lang = NULL;
+		GMutexLocker *locker = NULL;
+
+		/* language changed - rebuild our thread-local Snowball instance.
+		 * we only need the shared lock for the brief language lookup */
+		locker = g_mutex_locker_new (&stemmer->mutex);
+		lang = g_strdup (stemmer->current_lang);
+		serial = g_atomic_int_get (&as_stemmer_lang_serial);
 		g_mutex_locker_free (locker);
-		return g_strdup (term);
+
+		sb_stemmer_delete (tl->sb);
+		tl->sb = sb_stemmer_new (lang, NULL);
+		if (tl->sb == NULL)
+			g_debug ("Language %s can not be stemmed.", lang);
+		tl->serial = serial;
 	}
 
+	if (tl->sb == NULL)
+		return g_strdup (term);
+
 	result = g_strdup (
-	    (gchar *) sb_stemmer_stem (stemmer->sb, (unsigned char *) term, strlen (term)));
+	    (gchar *) sb_stemmer_stem (tl->sb, (unsigned char *) term, strlen (term)));
 
-	g_mutex_locker_free (locker);
+	/* remember the stem for subsequent calls, dropping the whole (cheaply
+	 * recomputable) table if it grew beyond its size bound */
+	g_rw_lock_writer_lock (&stemmer->memo_lock);
+	if (g_hash_table_size (stemmer->memo) >= AS_STEMMER_MEMO_MAX_ENTRIES)
+		g_hash_table_remove_all (stemmer->memo);
+	g_hash_table_insert (stemmer->memo,
+			     g_strdup (term),
+			     g_strdup ((result != NULL) ? result : ""));
+	g_rw_lock_writer_unlock (&stemmer->memo_lock);
 
 	/* Snowball sometimes stems tokens to an empty string,
 	 * for example the Turkish "leri" token. See issue #264
 	 * In this case, we currently just filter out the token,
 	 * as this sort of stemming seems to generally indicate an
 	 * unsuitable search token. */
-	if ((result != NULL) && (result[0] == '\0'))
+	if ((result != NULL) && (result[0] == '\0')) {
+		g_free (result);
 		return NULL;
+	}
 	return result;
 #else
 	return g_strdup (term);
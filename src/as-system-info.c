@@ -80,6 +80,7 @@ typedef struct {
 
 	GPtrArray *modaliases;
 	GHashTable *modalias_to_sysfs;
+	GHashTable *modalias_match_cache;
 
 	gboolean inputs_scanned;
 	guint input_controls;
@@ -167,6 +168,7 @@ as_system_info_init (AsSystemInfo *sysinfo)
 
 	priv->modaliases = g_ptr_array_new ();
 	priv->modalias_to_sysfs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	priv->modalias_match_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 
 	/* we assume a GUI is present by default */
 	priv->has_gui = TRUE;
@@ -189,6 +191,7 @@ as_system_info_finalize (GObject *object)
 
 	g_ptr_array_unref (priv->modaliases);
 	g_hash_table_unref (priv->modalias_to_sysfs);
+	g_hash_table_unref (priv->modalias_match_cache);
 
 #ifdef HAVE_SYSTEMD
 	if (priv->hwdb != NULL)
@@ -610,6 +613,15 @@ as_system_info_populate_modaliases_map_cb (AsSystemInfo *sysinfo, const gchar *r
 }
 #endif
 
+/**
+ * as_system_info_modalias_cmp:
+ */
+static gint
+as_system_info_modalias_cmp (gconstpointer a, gconstpointer b)
+{
+	return g_strcmp0 (*((const gchar **) a), *((const gchar **) b));
+}
+
 /**
  * as_system_info_populate_modaliases:
  */
@@ -629,6 +641,10 @@ as_system_info_populate_modaliases (AsSystemInfo *sysinfo)
 	g_hash_table_iter_init (&ht_iter, priv->modalias_to_sysfs);
 	while (g_hash_table_iter_next (&ht_iter, &ht_key, NULL))
 		g_ptr_array_add (priv->modaliases, ht_key);
+
+	/* keep the list sorted, so glob matching can narrow its scan to entries
+	 * sharing a glob's literal prefix via binary search */
+	g_ptr_array_sort (priv->modaliases, as_system_info_modalias_cmp);
 #endif
 }
 
@@ -678,18 +694,63 @@ gboolean
 as_system_info_has_device_matching_modalias (AsSystemInfo *sysinfo, const gchar *modalias_glob)
 {
 	AsSystemInfoPrivate *priv = GET_PRIVATE (sysinfo);
+	gboolean found = FALSE;
+	gpointer cached_value;
+	gsize prefix_len;
 	as_system_info_populate_modaliases (sysinfo);
 
-	for (guint i = 0; i < priv->modaliases->len; i++) {
-		const gchar *modalias = (const gchar *) g_ptr_array_index (priv->modaliases, i);
-		if (g_strcmp0 (modalias, modalias_glob) == 0)
-			return TRUE;
+	/* the same modalias globs are tested for many components, so we memoize
+	 * the match results instead of rescanning the device list every time */
+	if (g_hash_table_lookup_extended (priv->modalias_match_cache,
+					  modalias_glob,
+					  NULL,
+					  &cached_value))
+		return GPOINTER_TO_INT (cached_value);
+
+	/* a glob without any wildcards is a plain modalias that we can look up directly */
+	prefix_len = strcspn (modalias_glob, "*?");
+	if (modalias_glob[prefix_len] == '\0') {
+		found = g_hash_table_contains (priv->modalias_to_sysfs, modalias_glob);
+	} else {
+		GPatternSpec *pspec;
+		guint lo = 0;
+		guint hi = priv->modaliases->len;
+
+		/* the device list is sorted, so we can binary-search for the first entry
+		 * sharing the glob's literal prefix and only run the pattern over that
+		 * narrow range instead of over every device on the system */
+		while (lo < hi) {
+			guint mid = lo + (hi - lo) / 2;
+			const gchar *modalias = (const gchar *)
+						    g_ptr_array_index (priv->modaliases, mid);
+			if (strncmp (modalias, modalias_glob, prefix_len) < 0)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
 
-		if (g_pattern_match_simple (modalias_glob, modalias))
-			return TRUE;
+		/* compile the glob once, instead of once per tested device */
+		pspec = g_pattern_spec_new (modalias_glob);
+		for (guint i = lo; i < priv->modaliases->len; i++) {
+			const gchar *modalias = (const gchar *)
+						    g_ptr_array_index (priv->modaliases, i);
+			if (strncmp (modalias, modalias_glob, prefix_len) != 0)
+				break;
+#if GLIB_CHECK_VERSION(2, 70, 0)
+			found = g_pattern_spec_match_string (pspec, modalias);
+#else
+			found = g_pattern_match_string (pspec, modalias);
+#endif
+			if (found)
+				break;
+		}
+		g_pattern_spec_free (pspec);
 	}
 
-	return FALSE;
+	g_hash_table_insert (priv->modalias_match_cache,
+			     g_strdup (modalias_glob),
+			     GINT_TO_POINTER (found));
+	return found;
 }
 
 /**
@@ -1135,6 +1196,33 @@ as_system_info_new (void)
 	return AS_SYSTEM_INFO (sysinfo);
 }
 
+/**
+ * as_system_info_get_current:
+ *
+ * Obtain a shared #AsSystemInfo for the current system, creating it on
+ * first use. Since an #AsSystemInfo caches every system fact it has read,
+ * using the shared instance means each fact is gathered only once per
+ * process, no matter how many relation checks are performed.
+ *
+ * This function is thread-safe, but the returned object should not be
+ * used from multiple threads at the same time.
+ *
+ * Returns: (transfer full): a reference to the shared #AsSystemInfo
+ *
+ * Since: 1.0.5
+ **/
+AsSystemInfo *
+as_system_info_get_current (void)
+{
+	static AsSystemInfo *sysinfo_shared = NULL;
+	static GMutex mutex;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&mutex);
+
+	if (sysinfo_shared == NULL)
+		sysinfo_shared = as_system_info_new ();
+	return g_object_ref (sysinfo_shared);
+}
+
 /**
  * as_system_info_new_template_for_chassis:
  * @chassis: the #AsChassisKind to generate a template for
@@ -108,6 +108,7 @@ GQuark	      as_system_info_error_quark (void);
 
 AsSystemInfo *as_system_info_new (void);
 AsSystemInfo *as_system_info_new_template_for_chassis (AsChassisKind chassis, GError **error);
+AsSystemInfo *as_system_info_get_current (void);
 
 const gchar  *as_system_info_get_os_id (AsSystemInfo *sysinfo);
 const gchar  *as_system_info_get_os_cid (AsSystemInfo *sysinfo);
@@ -79,6 +79,16 @@ G_BEGIN_DECLS
  * @AS_TAG_LI:				Description markup `li`
  * @AS_TAG_OL:				Description markup `ol`
  * @AS_TAG_UL:				Description markup `ul`
+ * @AS_TAG_ARTIFACTS:			Release child `artifacts`
+ * @AS_TAG_ISSUES:			Release child `issues`
+ * @AS_TAG_IMAGE:			Screenshot child `image`
+ * @AS_TAG_VIDEO:			Screenshot child `video`
+ * @AS_TAG_CAPTION:			Screenshot child `caption`
+ * @AS_TAG_LOCATION:			Artifact child `location`
+ * @AS_TAG_FILENAME:			Artifact child `filename`
+ * @AS_TAG_CHECKSUM:			Artifact child `checksum`
+ * @AS_TAG_SIZE:			Artifact child `size`
+ * @AS_TAG_LANG:			Languages child `lang`
  *
  * The tag type.
  **/
@@ -131,9 +141,21 @@ typedef enum {
 	AS_TAG_UL,
 	AS_TAG_OL,
 
+	AS_TAG_ARTIFACTS,
+	AS_TAG_ISSUES,
+	AS_TAG_IMAGE,
+	AS_TAG_VIDEO,
+	AS_TAG_CAPTION,
+	AS_TAG_LOCATION,
+	AS_TAG_FILENAME,
+	AS_TAG_CHECKSUM,
+	AS_TAG_SIZE,
+	AS_TAG_LANG,
+
 	AS_TAG_INTERNAL_SCOPE,
 	AS_TAG_INTERNAL_ORIGIN,
 	AS_TAG_INTERNAL_BRANCH,
+	AS_TAG_INTERNAL_TOKENS,
 
 	/*< private >*/
 	AS_TAG_LAST
@@ -91,6 +91,13 @@ gboolean     as_arch_compatible (const gchar *arch1, const gchar *arch2);
 
 gboolean     as_utils_search_token_valid (const gchar *token);
 
+gchar	    *as_utils_strdown_inplace (gchar *str);
+const gchar *as_utils_strdown_buf (const gchar *str,
+				   gchar       *buf,
+				   gsize	buf_len,
+				   gchar      **heap_buf);
+gboolean     as_utils_str_equal_fold (const gchar *str1, const gchar *str2);
+
 AsBundleKind as_utils_get_component_bundle_kind (AsComponent *cpt);
 gchar	    *as_utils_build_data_id_for_cpt (AsComponent *cpt);
 
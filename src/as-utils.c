@@ -1278,6 +1278,132 @@ as_utils_search_token_valid (const gchar *token)
 	return TRUE;
 }
 
+/**
+ * as_utils_strdown_inplace:
+ * @str: the string to lowercase.
+ *
+ * Lowercase all ASCII characters of a string in place, without any
+ * allocation. Bytes outside the ASCII range are left untouched, which
+ * keeps UTF-8 multibyte sequences intact.
+ *
+ * Returns: (transfer none): @str, for convenience.
+ **/
+gchar *
+as_utils_strdown_inplace (gchar *str)
+{
+	for (gchar *c = str; *c != '\0'; c++)
+		*c = g_ascii_tolower (*c);
+	return str;
+}
+
+/**
+ * as_utils_strdown_buf:
+ * @str: the string to lowercase.
+ * @buf: a scratch buffer to write the lowercased string to.
+ * @buf_len: size of @buf in bytes.
+ * @heap_buf: (out): set to a newly allocated copy if @buf could not be used, free with g_free().
+ *
+ * Create a lowercased copy of a string without allocating memory, as long
+ * as the string is plain ASCII and fits into the provided scratch buffer.
+ * Longer or non-ASCII strings fall back to g_utf8_strdown(), with the
+ * allocated copy returned via @heap_buf so the caller can free it.
+ *
+ * Returns: (transfer none): the lowercased string, valid as long as @buf and @heap_buf are.
+ **/
+const gchar *
+as_utils_strdown_buf (const gchar *str, gchar *buf, gsize buf_len, gchar **heap_buf)
+{
+	gsize i;
+
+	for (i = 0; str[i] != '\0'; i++) {
+		if (G_UNLIKELY ((guchar) str[i] > 0x7F || i + 1 >= buf_len)) {
+			*heap_buf = g_utf8_strdown (str, -1);
+			return *heap_buf;
+		}
+		buf[i] = g_ascii_tolower (str[i]);
+	}
+	buf[i] = '\0';
+	*heap_buf = NULL;
+	return buf;
+}
+
+/**
+ * as_utils_str_equal_fold:
+ * @str1: (nullable): a string.
+ * @str2: (nullable): another string.
+ *
+ * Compare two strings ignoring case, like comparing the g_utf8_casefold()
+ * result of both strings, but without allocating folded copies as long as
+ * the compared characters are plain ASCII.
+ * Two %NULL strings compare as equal.
+ *
+ * Returns: %TRUE if both strings are equal, ignoring case.
+ **/
+gboolean
+as_utils_str_equal_fold (const gchar *str1, const gchar *str2)
+{
+	if (str1 == NULL || str2 == NULL)
+		return str1 == str2;
+
+	/* allocation-free fast path for the ASCII range */
+	while (((guchar) *str1 | (guchar) *str2) <= 0x7F) {
+		if (g_ascii_tolower (*str1) != g_ascii_tolower (*str2))
+			return FALSE;
+		if (*str1 == '\0')
+			return TRUE;
+		str1++;
+		str2++;
+	}
+
+	/* non-ASCII data needs full Unicode case folding */
+	{
+		g_autofree gchar *folded1 = g_utf8_casefold (str1, -1);
+		g_autofree gchar *folded2 = g_utf8_casefold (str2, -1);
+		return g_strcmp0 (folded1, folded2) == 0;
+	}
+}
+
+/**
+ * as_utils_get_xdg_category_names_set:
+ *
+ * Get a set of all registered XDG category names, built once
+ * from our data section and then kept for the process lifetime.
+ */
+static GHashTable *
+as_utils_get_xdg_category_names_set (void)
+{
+	static GHashTable *names_set = NULL;
+	static gsize initialized = 0;
+
+	if (g_once_init_enter (&initialized)) {
+		g_autoptr(GBytes) data = NULL;
+		GResource *resource = as_get_resource_safe ();
+
+		names_set = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+		data = g_resource_lookup_data (resource,
+					       "/org/freedesktop/appstream/xdg-category-names.txt",
+					       G_RESOURCE_LOOKUP_FLAGS_NONE,
+					       NULL);
+		if (data != NULL) {
+			gsize len = 0;
+			const gchar *raw = g_bytes_get_data (data, &len);
+			g_autofree gchar *text = g_strndup (raw, len);
+			g_auto(GStrv) lines = g_strsplit (text, "\n", -1);
+
+			for (guint i = 0; lines[i] != NULL; i++) {
+				/* ignore empty lines and comments */
+				if (lines[i][0] == '\0' || lines[i][0] == '#')
+					continue;
+				g_hash_table_add (names_set, g_strdup (lines[i]));
+			}
+		}
+
+		g_once_init_leave (&initialized, 1);
+	}
+
+	return names_set;
+}
+
 /**
  * as_utils_is_category_name:
  * @category_name: a XDG category name, e.g. "ProjectManagement"
@@ -1293,27 +1419,11 @@ as_utils_search_token_valid (const gchar *token)
 gboolean
 as_utils_is_category_name (const gchar *category_name)
 {
-	g_autoptr(GBytes) data = NULL;
-	g_autofree gchar *key = NULL;
-	GResource *resource = as_get_resource_safe ();
-
 	/* custom spec-extensions are generally valid if prefixed correctly */
 	if (g_str_has_prefix (category_name, "X-"))
 		return TRUE;
 
-	/* safeguard against accidentally matching comments */
-	if (g_str_has_prefix (category_name, "#"))
-		return FALSE;
-
-	/* load the readonly data section and look for the category name */
-	data = g_resource_lookup_data (resource,
-				       "/org/freedesktop/appstream/xdg-category-names.txt",
-				       G_RESOURCE_LOOKUP_FLAGS_NONE,
-				       NULL);
-	if (data == NULL)
-		return FALSE;
-	key = g_strdup_printf ("\n%s\n", category_name);
-	return g_strstr_len (g_bytes_get_data (data, NULL), -1, key) != NULL;
+	return g_hash_table_contains (as_utils_get_xdg_category_names_set (), category_name);
 }
 
 /**
@@ -1399,6 +1509,19 @@ as_utils_is_tld (const gchar *tld)
 	return g_strstr_len (g_bytes_get_data (data, NULL), -1, key) != NULL;
 }
 
+/**
+ * as_env_data_entry_cmp:
+ *
+ * Comparator for finding an entry in the generated desktop-environment
+ * data tables, which are sorted by ID in byte order. Both table entry
+ * types start with their ID string, so this works for either of them.
+ */
+static int
+as_env_data_entry_cmp (const void *key, const void *entry)
+{
+	return strcmp ((const gchar *) key, ((const AsDesktopEnvData *) entry)->id);
+}
+
 /**
  * as_utils_is_desktop_environment:
  * @de_id: a desktop environment id.
@@ -1417,12 +1540,11 @@ as_utils_is_desktop_environment (const gchar *de_id)
 	if (de_id == NULL || de_id[0] == '\0')
 		return FALSE;
 
-	for (guint i = 0; as_desktop_env_data[i].id != NULL; i++) {
-		if (as_str_equal0 (as_desktop_env_data[i].id, de_id))
-			return TRUE;
-	}
-
-	return FALSE;
+	return bsearch (de_id,
+			as_desktop_env_data,
+			G_N_ELEMENTS (as_desktop_env_data) - 1,
+			sizeof (AsDesktopEnvData),
+			as_env_data_entry_cmp) != NULL;
 }
 
 /**
@@ -1439,16 +1561,18 @@ as_utils_is_desktop_environment (const gchar *de_id)
 const gchar *
 as_utils_get_desktop_environment_name (const gchar *de_id)
 {
+	const AsDesktopEnvData *entry;
+
 	/* handle invalid */
 	if (de_id == NULL || de_id[0] == '\0')
 		return NULL;
 
-	for (guint i = 0; as_desktop_env_data[i].id != NULL; i++) {
-		if (as_str_equal0 (as_desktop_env_data[i].id, de_id))
-			return as_desktop_env_data[i].name;
-	}
-
-	return NULL;
+	entry = bsearch (de_id,
+			 as_desktop_env_data,
+			 G_N_ELEMENTS (as_desktop_env_data) - 1,
+			 sizeof (AsDesktopEnvData),
+			 as_env_data_entry_cmp);
+	return entry != NULL ? entry->name : NULL;
 }
 
 /**
@@ -1468,12 +1592,11 @@ as_utils_is_gui_environment_style (const gchar *env_style)
 	if (env_style == NULL || env_style[0] == '\0')
 		return FALSE;
 
-	for (guint i = 0; as_gui_env_style_data[i].id != NULL; i++) {
-		if (as_str_equal0 (as_gui_env_style_data[i].id, env_style))
-			return TRUE;
-	}
-
-	return FALSE;
+	return bsearch (env_style,
+			as_gui_env_style_data,
+			G_N_ELEMENTS (as_gui_env_style_data) - 1,
+			sizeof (AsGUIEnvStyleData),
+			as_env_data_entry_cmp) != NULL;
 }
 
 /**
@@ -1490,16 +1613,18 @@ as_utils_is_gui_environment_style (const gchar *env_style)
 const gchar *
 as_utils_get_gui_environment_style_name (const gchar *env_style)
 {
+	const AsGUIEnvStyleData *entry;
+
 	/* handle invalid */
 	if (env_style == NULL || env_style[0] == '\0')
 		return NULL;
 
-	for (guint i = 0; as_gui_env_style_data[i].id != NULL; i++) {
-		if (as_str_equal0 (as_gui_env_style_data[i].id, env_style))
-			return as_gui_env_style_data[i].name;
-	}
-
-	return NULL;
+	entry = bsearch (env_style,
+			 as_gui_env_style_data,
+			 G_N_ELEMENTS (as_gui_env_style_data) - 1,
+			 sizeof (AsGUIEnvStyleData),
+			 as_env_data_entry_cmp);
+	return entry != NULL ? entry->name : NULL;
 }
 
 /**
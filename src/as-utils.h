@@ -109,6 +109,9 @@ GQuark	     as_utils_error_quark (void);
 gchar	   **as_markup_strsplit_words (const gchar *text, guint line_len);
 gchar	    *as_markup_convert (const gchar *markup, AsMarkupKind to_kind, GError **error);
 
+/* declared here instead of as-component.h, as it needs #AsMarkupKind */
+const gchar *as_component_get_description_converted (AsComponent *cpt, AsMarkupKind markup_kind);
+
 gboolean     as_utils_locale_is_compatible (const gchar *locale1, const gchar *locale2);
 gchar	    *as_utils_posix_locale_to_bcp47 (const gchar *locale);
 
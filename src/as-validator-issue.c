@@ -34,14 +34,17 @@
 #include "as-utils-private.h"
 
 typedef struct {
-	gchar *tag;
+	/* interned - archive validation creates huge amounts of issues which
+	 * mostly repeat the same tag/filename/component-id/explanation values,
+	 * so all issues of a validation run share one allocation per value */
+	GRefString *tag;
 	AsIssueSeverity severity;
 
 	gchar *hint;
-	gchar *explanation;
+	GRefString *explanation;
 
-	gchar *fname;
-	gchar *cid;
+	GRefString *fname;
+	GRefString *cid;
 	glong line;
 } AsValidatorIssuePrivate;
 
@@ -103,12 +106,12 @@ as_validator_issue_finalize (GObject *object)
 	AsValidatorIssue *issue = AS_VALIDATOR_ISSUE (object);
 	AsValidatorIssuePrivate *priv = GET_PRIVATE (issue);
 
-	g_free (priv->tag);
+	as_ref_string_release (priv->tag);
 	g_free (priv->hint);
-	g_free (priv->explanation);
+	as_ref_string_release (priv->explanation);
 
-	g_free (priv->fname);
-	g_free (priv->cid);
+	as_ref_string_release (priv->fname);
+	as_ref_string_release (priv->cid);
 
 	G_OBJECT_CLASS (as_validator_issue_parent_class)->finalize (object);
 }
@@ -164,7 +167,7 @@ void
 as_validator_issue_set_tag (AsValidatorIssue *issue, const gchar *tag)
 {
 	AsValidatorIssuePrivate *priv = GET_PRIVATE (issue);
-	as_assign_string_safe (priv->tag, tag);
+	as_ref_string_assign_safe (&priv->tag, tag);
 }
 
 /**
@@ -260,7 +263,7 @@ void
 as_validator_issue_set_explanation (AsValidatorIssue *issue, const gchar *explanation)
 {
 	AsValidatorIssuePrivate *priv = GET_PRIVATE (issue);
-	as_assign_string_safe (priv->explanation, explanation);
+	as_ref_string_assign_safe (&priv->explanation, explanation);
 }
 
 /**
@@ -289,7 +292,7 @@ void
 as_validator_issue_set_cid (AsValidatorIssue *issue, const gchar *cid)
 {
 	AsValidatorIssuePrivate *priv = GET_PRIVATE (issue);
-	as_assign_string_safe (priv->cid, cid);
+	as_ref_string_assign_safe (&priv->cid, cid);
 }
 
 /**
@@ -347,7 +350,7 @@ void
 as_validator_issue_set_filename (AsValidatorIssue *issue, const gchar *fname)
 {
 	AsValidatorIssuePrivate *priv = GET_PRIVATE (issue);
-	as_assign_string_safe (priv->fname, fname);
+	as_ref_string_assign_safe (&priv->fname, fname);
 }
 
 /**
@@ -0,0 +1,42 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2014-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __AS_VALIDATOR_PRIVATE_H
+#define __AS_VALIDATOR_PRIVATE_H
+
+#include "as-macros-private.h"
+#include "as-validator.h"
+#include "as-component.h"
+#include "as-context.h"
+#include "as-xml.h"
+
+AS_BEGIN_PRIVATE_DECLS
+
+AS_INTERNAL_VISIBLE
+AsComponent *as_validator_validate_component_node (AsValidator *validator,
+						   AsContext   *ctx,
+						   xmlNode     *root);
+
+AS_INTERNAL_VISIBLE
+void	     as_validator_clear_issues (AsValidator *validator);
+
+AS_END_PRIVATE_DECLS
+
+#endif /* __AS_VALIDATOR_PRIVATE_H */
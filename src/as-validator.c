@@ -34,9 +34,11 @@
 #include <gio/gio.h>
 #include <libxml/tree.h>
 #include <libxml/parser.h>
+#include <libxml/xmlreader.h>
 #include <string.h>
 
 #include "as-validator.h"
+#include "as-validator-private.h"
 #include "as-validator-issue.h"
 #include "as-validator-issue-tag.h"
 
@@ -53,10 +55,9 @@
 #include "as-zstd-decompressor.h"
 
 typedef struct {
-	GHashTable *issue_tags; /* of utf8:AsValidatorIssueTag */
-
 	GHashTable *issues;	     /* of utf8:AsValidatorIssue */
 	GHashTable *issues_per_file; /* of utf8:GPtrArray<AsValidatorIssue> */
+	GHashTable *source_index;    /* of utf8:AsValidatorSourceIndex */
 
 	AsComponent *current_cpt;
 	gchar *current_fname;
@@ -65,7 +66,10 @@ typedef struct {
 
 	gboolean check_urls;
 	gboolean strict;
+	gboolean use_result_cache;
+	guint max_threads;
 	AsCurl *acurl;
+	GPtrArray *pending_url_checks; /* of AsPendingUrlCheck */
 } AsValidatorPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (AsValidator, as_validator, G_TYPE_OBJECT)
@@ -103,6 +107,583 @@ as_release_data_pair_free (AsReleaseDataPair *pair)
 	g_free (pair);
 }
 
+/* source data of a validated file, with a line-offset index for fast snippet extraction */
+typedef struct {
+	GBytes *bytes;	      /* copy of the validated source data */
+	GArray *line_offsets; /* of gsize, start offset of each line */
+} AsValidatorSourceIndex;
+
+static void
+as_validator_source_index_free (AsValidatorSourceIndex *sidx)
+{
+	g_bytes_unref (sidx->bytes);
+	g_array_unref (sidx->line_offsets);
+	g_free (sidx);
+}
+
+/* a queued web URL availability check, with the issue tag to raise on failure */
+typedef struct {
+	xmlNode *node; /* no ref, owned by the document being validated */
+	gchar *url;
+	gchar *tag;
+} AsPendingUrlCheck;
+
+static void
+as_pending_url_check_free (AsPendingUrlCheck *pending)
+{
+	g_free (pending->url);
+	g_free (pending->tag);
+	g_free (pending);
+}
+
+typedef struct {
+	AsValidatorIssueTag **entries;
+	guint n_entries;
+} AsValidatorIssueTagIndex;
+
+static gint
+as_validator_issue_tag_index_cmp (gconstpointer a, gconstpointer b)
+{
+	const AsValidatorIssueTag *tag_a = *((AsValidatorIssueTag *const *) a);
+	const AsValidatorIssueTag *tag_b = *((AsValidatorIssueTag *const *) b);
+	return g_strcmp0 (tag_a->tag, tag_b->tag);
+}
+
+/**
+ * as_validator_issue_tag_index:
+ *
+ * Get the process-global index over the static issue-tag registry, sorted by
+ * tag name. It is built only once and shared by all validator instances,
+ * so creating a validator no longer copies the complete tag registry.
+ */
+static const AsValidatorIssueTagIndex *
+as_validator_issue_tag_index (void)
+{
+	static AsValidatorIssueTagIndex *index = NULL;
+
+	if (g_once_init_enter (&index)) {
+		AsValidatorIssueTagIndex *tmp;
+		GPtrArray *entries = g_ptr_array_new ();
+
+		for (guint i = 0; as_validator_issue_tag_list[i].tag != NULL; i++)
+			g_ptr_array_add (entries, &as_validator_issue_tag_list[i]);
+		g_ptr_array_sort (entries, as_validator_issue_tag_index_cmp);
+
+		tmp = g_new0 (AsValidatorIssueTagIndex, 1);
+		tmp->n_entries = entries->len;
+		tmp->entries = (AsValidatorIssueTag **) g_ptr_array_free (entries, FALSE);
+
+		for (guint i = 1; i < tmp->n_entries; i++) {
+			if (G_UNLIKELY (g_strcmp0 (tmp->entries[i - 1]->tag,
+						   tmp->entries[i]->tag) == 0))
+				g_critical ("Duplicate issue-tag '%s' found in tag list. This is "
+					    "a bug in the validator.",
+					    tmp->entries[i]->tag);
+		}
+
+		g_once_init_leave (&index, tmp);
+	}
+
+	return index;
+}
+
+/**
+ * as_validator_issue_tag_lookup:
+ *
+ * Find the registry entry for an issue tag via binary search,
+ * without hashing the tag string.
+ *
+ * Returns: The #AsValidatorIssueTag, or %NULL if the tag is unknown.
+ */
+static AsValidatorIssueTag *
+as_validator_issue_tag_lookup (const gchar *tag)
+{
+	const AsValidatorIssueTagIndex *index = as_validator_issue_tag_index ();
+	guint lo = 0;
+	guint hi = index->n_entries;
+
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		gint cmp = strcmp (index->entries[mid]->tag, tag);
+
+		if (cmp == 0)
+			return index->entries[mid];
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return NULL;
+}
+
+/* re-verify a cached known-good URL only after this time has passed */
+#define AS_VALIDATOR_URL_CACHE_TTL (24 * 60 * 60)
+
+/* drop cached URL check results entirely after this time */
+#define AS_VALIDATOR_URL_CACHE_MAX_AGE (30 * 24 * 60 * 60)
+
+typedef struct {
+	gint64 checked_time;
+	gchar *etag;
+} AsUrlCheckRecord;
+
+static GHashTable *as_url_check_cache = NULL; /* utf8 URL -> AsUrlCheckRecord */
+static gboolean as_url_check_cache_changed = FALSE;
+static GMutex as_url_check_cache_mutex;
+
+static void
+as_url_check_record_free (AsUrlCheckRecord *record)
+{
+	g_free (record->etag);
+	g_free (record);
+}
+
+/**
+ * as_validator_url_cache_fname:
+ *
+ * Get the location of the persistent URL-check cache.
+ */
+static gchar *
+as_validator_url_cache_fname (void)
+{
+	g_autofree gchar *cache_dir = NULL;
+
+	cache_dir = as_get_user_cache_dir (NULL);
+	if (cache_dir == NULL)
+		return NULL;
+	return g_build_filename (cache_dir, "url-checks.cache", NULL);
+}
+
+/**
+ * as_validator_url_cache_ensure_locked:
+ *
+ * Load the persistent URL-check cache, dropping any ancient entries.
+ * Must be called with the cache mutex held.
+ */
+static void
+as_validator_url_cache_ensure_locked (void)
+{
+	g_autoptr(GKeyFile) kf = NULL;
+	g_autofree gchar *fname = NULL;
+	g_auto(GStrv) groups = NULL;
+	gint64 now;
+
+	if (as_url_check_cache != NULL)
+		return;
+
+	as_url_check_cache = g_hash_table_new_full (g_str_hash,
+						    g_str_equal,
+						    g_free,
+						    (GDestroyNotify) as_url_check_record_free);
+
+	fname = as_validator_url_cache_fname ();
+	if (fname == NULL)
+		return;
+	kf = g_key_file_new ();
+	if (!g_key_file_load_from_file (kf, fname, G_KEY_FILE_NONE, NULL))
+		return;
+
+	now = g_get_real_time () / G_USEC_PER_SEC;
+	groups = g_key_file_get_groups (kf, NULL);
+	for (guint i = 0; groups[i] != NULL; i++) {
+		AsUrlCheckRecord *record;
+		gint64 checked_time;
+
+		checked_time = g_key_file_get_int64 (kf, groups[i], "checked-time", NULL);
+		if (checked_time <= 0 || now - checked_time > AS_VALIDATOR_URL_CACHE_MAX_AGE)
+			continue;
+
+		record = g_new0 (AsUrlCheckRecord, 1);
+		record->checked_time = checked_time;
+		record->etag = g_key_file_get_string (kf, groups[i], "etag", NULL);
+		g_hash_table_insert (as_url_check_cache, g_strdup (groups[i]), record);
+	}
+}
+
+/**
+ * as_validator_url_cache_record:
+ *
+ * Remember that the given URL was reachable just now.
+ */
+static void
+as_validator_url_cache_record (const gchar *url, const gchar *etag)
+{
+	AsUrlCheckRecord *record;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&as_url_check_cache_mutex);
+
+	/* square brackets would corrupt the key-file group name */
+	if (strchr (url, '[') != NULL || strchr (url, ']') != NULL)
+		return;
+
+	as_validator_url_cache_ensure_locked ();
+	record = g_new0 (AsUrlCheckRecord, 1);
+	record->checked_time = g_get_real_time () / G_USEC_PER_SEC;
+	record->etag = g_strdup (etag);
+	g_hash_table_insert (as_url_check_cache, g_strdup (url), record);
+	as_url_check_cache_changed = TRUE;
+}
+
+/**
+ * as_validator_url_cache_check_valid:
+ *
+ * Check whether the given URL is known to be reachable, either because it
+ * was verified recently or because the server still reports the same ETag
+ * that it did when the URL was last verified.
+ */
+static gboolean
+as_validator_url_cache_check_valid (AsValidator *validator, const gchar *url)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	g_autofree gchar *etag = NULL;
+	g_autofree gchar *current_etag = NULL;
+	gint64 now = g_get_real_time () / G_USEC_PER_SEC;
+
+	{
+		g_autoptr(GMutexLocker) locker = g_mutex_locker_new (
+		    &as_url_check_cache_mutex);
+		AsUrlCheckRecord *record;
+
+		as_validator_url_cache_ensure_locked ();
+		record = g_hash_table_lookup (as_url_check_cache, url);
+		if (record == NULL)
+			return FALSE;
+		if (now - record->checked_time < AS_VALIDATOR_URL_CACHE_TTL)
+			return TRUE;
+		etag = g_strdup (record->etag);
+	}
+
+	/* the entry has expired - if we know an ETag, cheaply ask the server
+	 * whether the resource changed at all before re-fetching it */
+	if (etag == NULL)
+		return FALSE;
+	current_etag = as_curl_query_etag (priv->acurl, url, NULL);
+	if (current_etag == NULL || g_strcmp0 (etag, current_etag) != 0)
+		return FALSE;
+
+	as_validator_url_cache_record (url, current_etag);
+	return TRUE;
+}
+
+/**
+ * as_validator_url_cache_save:
+ *
+ * Write the URL-check cache back to disk, if it was modified.
+ */
+static void
+as_validator_url_cache_save (void)
+{
+	g_autoptr(GKeyFile) kf = NULL;
+	g_autofree gchar *fname = NULL;
+	GHashTableIter iter;
+	gpointer key, value;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&as_url_check_cache_mutex);
+
+	if (as_url_check_cache == NULL || !as_url_check_cache_changed)
+		return;
+	fname = as_validator_url_cache_fname ();
+	if (fname == NULL)
+		return;
+
+	kf = g_key_file_new ();
+	g_hash_table_iter_init (&iter, as_url_check_cache);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		AsUrlCheckRecord *record = value;
+
+		g_key_file_set_int64 (kf, key, "checked-time", record->checked_time);
+		if (record->etag != NULL)
+			g_key_file_set_string (kf, key, "etag", record->etag);
+	}
+
+	if (g_key_file_save_to_file (kf, fname, NULL))
+		as_url_check_cache_changed = FALSE;
+}
+
+/* drop cached per-file validation results entirely after this time */
+#define AS_VALIDATOR_RESULT_CACHE_MAX_AGE (30 * 24 * 60 * 60)
+
+typedef struct {
+	gint64 checked_time;
+	gboolean valid;
+	gchar **issues; /* serialized, one entry per issue */
+} AsValidationResultRecord;
+
+static GHashTable *as_validation_result_cache = NULL; /* utf8 key -> AsValidationResultRecord */
+static gboolean as_validation_result_cache_changed = FALSE;
+static GMutex as_validation_result_cache_mutex;
+
+static void
+as_validation_result_record_free (AsValidationResultRecord *record)
+{
+	g_strfreev (record->issues);
+	g_free (record);
+}
+
+/**
+ * as_validator_result_cache_fname:
+ *
+ * Get the location of the persistent validation-result cache.
+ */
+static gchar *
+as_validator_result_cache_fname (void)
+{
+	g_autofree gchar *cache_dir = NULL;
+
+	cache_dir = as_get_user_cache_dir (NULL);
+	if (cache_dir == NULL)
+		return NULL;
+	return g_build_filename (cache_dir, "validation-results.cache", NULL);
+}
+
+/**
+ * as_validator_result_cache_ensure_locked:
+ *
+ * Load the persistent validation-result cache, dropping any ancient entries
+ * as well as everything written by a different AppStream version (the issue
+ * tag registry may have changed between releases).
+ * Must be called with the cache mutex held.
+ */
+static void
+as_validator_result_cache_ensure_locked (void)
+{
+	g_autoptr(GKeyFile) kf = NULL;
+	g_autofree gchar *fname = NULL;
+	g_auto(GStrv) groups = NULL;
+	gint64 now;
+
+	if (as_validation_result_cache != NULL)
+		return;
+
+	as_validation_result_cache = g_hash_table_new_full (
+	    g_str_hash,
+	    g_str_equal,
+	    g_free,
+	    (GDestroyNotify) as_validation_result_record_free);
+
+	fname = as_validator_result_cache_fname ();
+	if (fname == NULL)
+		return;
+	kf = g_key_file_new ();
+	if (!g_key_file_load_from_file (kf, fname, G_KEY_FILE_NONE, NULL))
+		return;
+
+	now = g_get_real_time () / G_USEC_PER_SEC;
+	groups = g_key_file_get_groups (kf, NULL);
+	for (guint i = 0; groups[i] != NULL; i++) {
+		AsValidationResultRecord *record;
+		g_autofree gchar *version = NULL;
+		gint64 checked_time;
+
+		checked_time = g_key_file_get_int64 (kf, groups[i], "checked-time", NULL);
+		if (checked_time <= 0 || now - checked_time > AS_VALIDATOR_RESULT_CACHE_MAX_AGE)
+			continue;
+		version = g_key_file_get_string (kf, groups[i], "version", NULL);
+		if (g_strcmp0 (version, PACKAGE_VERSION) != 0)
+			continue;
+
+		record = g_new0 (AsValidationResultRecord, 1);
+		record->checked_time = checked_time;
+		record->valid = g_key_file_get_boolean (kf, groups[i], "valid", NULL);
+		record->issues = g_key_file_get_string_list (kf, groups[i], "issues", NULL, NULL);
+		g_hash_table_insert (as_validation_result_cache, g_strdup (groups[i]), record);
+	}
+}
+
+/**
+ * as_validator_result_cache_record:
+ *
+ * Remember the validation result for a file with the given content hash,
+ * serializing all issues that validating it has just produced.
+ * The issues registered for each file are compared against their @baseline
+ * count, so only issues added by the most recent validation run are stored.
+ */
+static void
+as_validator_result_cache_record (AsValidator *validator,
+				  const gchar *hash_key,
+				  const gchar *fname_basename,
+				  gboolean valid,
+				  GHashTable *baseline)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	AsValidationResultRecord *record;
+	g_autoptr(GPtrArray) serialized = NULL;
+	GHashTableIter iter;
+	gpointer key, value;
+
+	serialized = g_ptr_array_new_with_free_func (g_free);
+	g_hash_table_iter_init (&iter, priv->issues_per_file);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		const gchar *issue_fname = key;
+		GPtrArray *ilist = value;
+		guint start = GPOINTER_TO_UINT (g_hash_table_lookup (baseline, issue_fname));
+
+		for (guint i = start; i < ilist->len; i++) {
+			AsValidatorIssue *issue = g_ptr_array_index (ilist, i);
+			const gchar *cid = as_validator_issue_get_cid (issue);
+			const gchar *hint = as_validator_issue_get_hint (issue);
+
+			/* an empty filename field means "the validated file itself", so a
+			 * cached result stays valid even if the file is renamed */
+			g_ptr_array_add (
+			    serialized,
+			    g_strdup_printf ("%s\x1f%s\x1f%s\x1f%li\x1f%s",
+					     g_strcmp0 (issue_fname, fname_basename) == 0
+						 ? ""
+						 : issue_fname,
+					     as_validator_issue_get_tag (issue),
+					     cid != NULL ? cid : "",
+					     as_validator_issue_get_line (issue),
+					     hint != NULL ? hint : ""));
+		}
+	}
+	g_ptr_array_add (serialized, NULL);
+
+	record = g_new0 (AsValidationResultRecord, 1);
+	record->checked_time = g_get_real_time () / G_USEC_PER_SEC;
+	record->valid = valid;
+	record->issues = (gchar **) g_ptr_array_free (g_steal_pointer (&serialized), FALSE);
+
+	{
+		g_autoptr(GMutexLocker) locker = g_mutex_locker_new (
+		    &as_validation_result_cache_mutex);
+		as_validator_result_cache_ensure_locked ();
+		g_hash_table_insert (as_validation_result_cache, g_strdup (hash_key), record);
+		as_validation_result_cache_changed = TRUE;
+	}
+}
+
+/**
+ * as_validator_result_cache_replay:
+ *
+ * Re-register the cached issues for a file with the given content hash,
+ * if we have a cached result for it. Severities and explanations are taken
+ * from the current tag registry, so severity overrides still apply.
+ *
+ * Returns: %TRUE if a cached result was replayed, with @valid set to the
+ * validity verdict of the original run.
+ */
+static gboolean
+as_validator_result_cache_replay (AsValidator *validator,
+				  const gchar *hash_key,
+				  const gchar *fname_basename,
+				  gboolean *valid)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	g_auto(GStrv) issues_strv = NULL;
+	g_autoptr(GPtrArray) issues = NULL;
+
+	{
+		g_autoptr(GMutexLocker) locker = g_mutex_locker_new (
+		    &as_validation_result_cache_mutex);
+		AsValidationResultRecord *record;
+
+		as_validator_result_cache_ensure_locked ();
+		record = g_hash_table_lookup (as_validation_result_cache, hash_key);
+		if (record == NULL)
+			return FALSE;
+		*valid = record->valid;
+		issues_strv = g_strdupv (record->issues);
+	}
+
+	/* materialize all issues first - if any entry is damaged or refers to a
+	 * tag we no longer know, discard the whole record and validate afresh */
+	issues = g_ptr_array_new_with_free_func (g_object_unref);
+	for (guint i = 0; issues_strv != NULL && issues_strv[i] != NULL; i++) {
+		g_auto(GStrv) fields = g_strsplit (issues_strv[i], "\x1f", -1);
+		const AsValidatorIssueTag *tag_data;
+		AsValidatorIssue *issue;
+		glong line;
+
+		if (g_strv_length (fields) != 5)
+			return FALSE;
+		tag_data = as_validator_issue_tag_lookup (fields[1]);
+		if (tag_data == NULL)
+			return FALSE;
+
+		issue = as_validator_issue_new ();
+		as_validator_issue_set_tag (issue, fields[1]);
+		as_validator_issue_set_severity (issue, tag_data->severity);
+		as_validator_issue_set_explanation (issue, tag_data->explanation);
+		as_validator_issue_set_filename (issue,
+						 fields[0][0] != '\0' ? fields[0]
+								      : fname_basename);
+		if (fields[2][0] != '\0')
+			as_validator_issue_set_cid (issue, fields[2]);
+		line = (glong) g_ascii_strtoll (fields[3], NULL, 10);
+		if (line > 0)
+			as_validator_issue_set_line (issue, line);
+		if (fields[4][0] != '\0')
+			as_validator_issue_set_hint (issue, fields[4]);
+		g_ptr_array_add (issues, issue);
+	}
+
+	for (guint i = 0; i < issues->len; i++) {
+		AsValidatorIssue *issue = g_ptr_array_index (issues, i);
+		g_autofree gchar *location = as_validator_issue_get_location (issue);
+		const gchar *fname_key = as_validator_issue_get_filename (issue);
+		GPtrArray *ilist;
+		gchar *id_str;
+
+		id_str = g_strdup_printf ("%s/%s/%s",
+					  location,
+					  as_validator_issue_get_tag (issue),
+					  as_validator_issue_get_hint (issue));
+		/* str ownership is transferred to the hashtable */
+		if (g_hash_table_insert (priv->issues, id_str, g_object_ref (issue))) {
+			ilist = g_hash_table_lookup (priv->issues_per_file, fname_key);
+			if (ilist == NULL) {
+				ilist = g_ptr_array_new_with_free_func (g_object_unref);
+				g_hash_table_insert (priv->issues_per_file,
+						     g_strdup (fname_key),
+						     ilist);
+			}
+			g_ptr_array_add (ilist, g_object_ref (issue));
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * as_validator_result_cache_save:
+ *
+ * Write the validation-result cache back to disk, if it was modified.
+ */
+static void
+as_validator_result_cache_save (void)
+{
+	g_autoptr(GKeyFile) kf = NULL;
+	g_autofree gchar *fname = NULL;
+	GHashTableIter iter;
+	gpointer key, value;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&as_validation_result_cache_mutex);
+
+	if (as_validation_result_cache == NULL || !as_validation_result_cache_changed)
+		return;
+	fname = as_validator_result_cache_fname ();
+	if (fname == NULL)
+		return;
+
+	kf = g_key_file_new ();
+	g_hash_table_iter_init (&iter, as_validation_result_cache);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		AsValidationResultRecord *record = value;
+
+		g_key_file_set_int64 (kf, key, "checked-time", record->checked_time);
+		g_key_file_set_string (kf, key, "version", PACKAGE_VERSION);
+		g_key_file_set_boolean (kf, key, "valid", record->valid);
+		if (record->issues != NULL)
+			g_key_file_set_string_list (kf,
+						    key,
+						    "issues",
+						    (const gchar *const *) record->issues,
+						    g_strv_length (record->issues));
+	}
+
+	if (g_key_file_save_to_file (kf, fname, NULL))
+		as_validation_result_cache_changed = FALSE;
+}
+
 /**
  * as_validator_init:
  **/
@@ -111,17 +692,6 @@ as_validator_init (AsValidator *validator)
 {
 	AsValidatorPrivate *priv = GET_PRIVATE (validator);
 
-	priv->issue_tags = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
-	for (guint i = 0; as_validator_issue_tag_list[i].tag != NULL; i++) {
-		gboolean r = g_hash_table_insert (priv->issue_tags,
-						  g_strdup (as_validator_issue_tag_list[i].tag),
-						  &as_validator_issue_tag_list[i]);
-		if (G_UNLIKELY (!r))
-			g_critical ("Duplicate issue-tag '%s' found in tag list. This is a bug in "
-				    "the validator.",
-				    as_validator_issue_tag_list[i].tag);
-	}
-
 	/* set of issues */
 	priv->issues = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
 	/* filename -> issue list mapping */
@@ -129,14 +699,24 @@ as_validator_init (AsValidator *validator)
 						       g_str_equal,
 						       g_free,
 						       (GDestroyNotify) g_ptr_array_unref);
+	/* filename -> retained source data mapping, for snippet extraction */
+	priv->source_index = g_hash_table_new_full (
+	    g_str_hash,
+	    g_str_equal,
+	    g_free,
+	    (GDestroyNotify) as_validator_source_index_free);
 	/* registry for injected release metadata */
 	priv->release_data = g_ptr_array_new_with_free_func (
 	    (GDestroyNotify) as_release_data_pair_free);
+	/* web URLs queued for a batched availability check */
+	priv->pending_url_checks = g_ptr_array_new_with_free_func (
+	    (GDestroyNotify) as_pending_url_check_free);
 
 	priv->current_fname = NULL;
 	priv->current_cpt = NULL;
 	priv->check_urls = FALSE;
 	priv->strict = FALSE;
+	priv->use_result_cache = FALSE;
 }
 
 /**
@@ -148,19 +728,26 @@ as_validator_finalize (GObject *object)
 	AsValidator *validator = AS_VALIDATOR (object);
 	AsValidatorPrivate *priv = GET_PRIVATE (validator);
 
-	g_hash_table_unref (priv->issue_tags);
-
 	g_hash_table_unref (priv->issues_per_file);
 	g_hash_table_unref (priv->issues);
+	g_hash_table_unref (priv->source_index);
 
 	g_free (priv->current_fname);
 	g_free (priv->current_dir);
 	if (priv->current_cpt != NULL)
 		g_object_unref (priv->current_cpt);
 	g_ptr_array_unref (priv->release_data);
+	g_ptr_array_unref (priv->pending_url_checks);
 
-	if (priv->acurl != NULL)
+	if (priv->acurl != NULL) {
+		/* persist the results of any URL checks we performed */
+		as_validator_url_cache_save ();
 		g_object_unref (priv->acurl);
+	}
+
+	/* persist any per-file validation results we recorded */
+	if (priv->use_result_cache)
+		as_validator_result_cache_save ();
 
 	G_OBJECT_CLASS (as_validator_parent_class)->finalize (object);
 }
@@ -190,7 +777,7 @@ as_validator_add_issue (AsValidator *validator,
 	g_autofree gchar *location = NULL;
 	AsValidatorIssue *issue;
 	gchar *id_str;
-	const AsValidatorIssueTag *tag_data = g_hash_table_lookup (priv->issue_tags, tag);
+	const AsValidatorIssueTag *tag_data = as_validator_issue_tag_lookup (tag);
 
 	if (tag_data == NULL) {
 		/* we requested data about an invalid tag */
@@ -268,6 +855,32 @@ as_validator_set_current_dir (AsValidator *validator, const gchar *dirname)
 	priv->current_dir = g_strdup (dirname);
 }
 
+/**
+ * as_validator_register_source:
+ *
+ * Retain a copy of the source data being validated for the current file,
+ * together with an index of its line start offsets, so context snippets
+ * for issues can later be extracted without re-reading the file.
+ */
+static void
+as_validator_register_source (AsValidator *validator, const gchar *data, gsize len)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	AsValidatorSourceIndex *sidx;
+	const gchar *fname_key = priv->current_fname ? priv->current_fname : "";
+
+	sidx = g_new0 (AsValidatorSourceIndex, 1);
+	sidx->bytes = g_bytes_new (data, len);
+	sidx->line_offsets = g_array_new (FALSE, FALSE, sizeof (gsize));
+
+	for (gsize i = 0; i < len; i++) {
+		if (i == 0 || data[i - 1] == '\n')
+			g_array_append_val (sidx->line_offsets, i);
+	}
+
+	g_hash_table_insert (priv->source_index, g_strdup (fname_key), sidx);
+}
+
 /**
  * as_validator_clear_current_fname:
  *
@@ -314,12 +927,13 @@ as_validator_clear_current_cpt (AsValidator *validator)
  *
  * Clears the list of issues
  **/
-static void
+void
 as_validator_clear_issues (AsValidator *validator)
 {
 	AsValidatorPrivate *priv = GET_PRIVATE (validator);
 	g_hash_table_remove_all (priv->issues_per_file);
 	g_hash_table_remove_all (priv->issues);
+	g_hash_table_remove_all (priv->source_index);
 }
 
 /**
@@ -394,6 +1008,10 @@ as_validator_setup_networking (AsValidator *validator)
  *
  * Check if an URL is valid and is reachable, creating a new
  * issue tag of value @tag in case of errors.
+ *
+ * The actual network access is deferred: all URLs queued while validating
+ * a component are checked concurrently in one batch at the end of its
+ * validation pass, see as_validator_flush_url_checks().
  */
 static gboolean
 as_validator_check_web_url (AsValidator *validator,
@@ -402,7 +1020,7 @@ as_validator_check_web_url (AsValidator *validator,
 			    const gchar *tag)
 {
 	AsValidatorPrivate *priv = GET_PRIVATE (validator);
-	g_autoptr(GError) tmp_error = NULL;
+	AsPendingUrlCheck *pending;
 
 	if (g_str_has_prefix (url, "ftp:")) {
 		/* we can't check FTP URLs here, and those shouldn't generally be used in AppStream */
@@ -424,18 +1042,81 @@ as_validator_check_web_url (AsValidator *validator,
 	if (!priv->check_urls)
 		return TRUE;
 
-	g_debug ("Checking URL availability: %s", url);
+	/* skip the network round-trip if this URL was recently verified to exist */
+	if (as_validator_url_cache_check_valid (validator, url))
+		return TRUE;
 
-	/* try to download first few bytes of the file, get error if that fails */
-	if (!as_curl_check_url_exists (priv->acurl, url, &tmp_error)) {
-		as_validator_add_issue (validator, node, tag, "%s - %s", url, tmp_error->message);
-		return FALSE;
-	}
+	/* queue the check - the node stays valid until the component subtree
+	 * is validated completely, which is when the queue is flushed */
+	pending = g_new0 (AsPendingUrlCheck, 1);
+	pending->node = node;
+	pending->url = g_strdup (url);
+	pending->tag = g_strdup (tag);
+	g_ptr_array_add (priv->pending_url_checks, pending);
 
-	/* if we we din't get a zero-length file, we just assume everything is fine here */
 	return TRUE;
 }
 
+/**
+ * as_validator_flush_url_checks:
+ *
+ * Perform all queued web URL availability checks as one concurrent
+ * batch and raise issues for any URL that was not reachable.
+ * Checking the URLs together lets requests to the same host share a
+ * small, rate-limited connection pool instead of doing a full serial
+ * round-trip per URL.
+ */
+static void
+as_validator_flush_url_checks (AsValidator *validator)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	g_autoptr(GPtrArray) checks = NULL;
+	g_autoptr(GHashTable) checks_by_url = NULL;
+
+	if (priv->pending_url_checks->len == 0)
+		return;
+	if (priv->acurl == NULL) {
+		/* networking setup failed, we can not check anything */
+		g_ptr_array_set_size (priv->pending_url_checks, 0);
+		return;
+	}
+
+	/* deduplicate, the same URL may be referenced multiple times */
+	checks = g_ptr_array_new_with_free_func ((GDestroyNotify) as_curl_url_check_free);
+	checks_by_url = g_hash_table_new (g_str_hash, g_str_equal);
+	for (guint i = 0; i < priv->pending_url_checks->len; i++) {
+		AsPendingUrlCheck *pending = g_ptr_array_index (priv->pending_url_checks, i);
+		AsCurlUrlCheck *check;
+
+		if (g_hash_table_contains (checks_by_url, pending->url))
+			continue;
+		g_debug ("Checking URL availability: %s", pending->url);
+		check = as_curl_url_check_new (pending->url);
+		g_ptr_array_add (checks, check);
+		g_hash_table_insert (checks_by_url, check->url, check);
+	}
+
+	/* failures are reported per-check, a global error is of no interest here */
+	as_curl_check_urls_exist (priv->acurl, checks, 0, NULL);
+
+	for (guint i = 0; i < priv->pending_url_checks->len; i++) {
+		AsPendingUrlCheck *pending = g_ptr_array_index (priv->pending_url_checks, i);
+		AsCurlUrlCheck *check = g_hash_table_lookup (checks_by_url, pending->url);
+
+		if (check->error != NULL)
+			as_validator_add_issue (validator,
+						pending->node,
+						pending->tag,
+						"%s - %s",
+						pending->url,
+						check->error->message);
+		else
+			as_validator_url_cache_record (pending->url, check->etag);
+	}
+
+	g_ptr_array_set_size (priv->pending_url_checks, 0);
+}
+
 /**
  * as_validator_clear_release_data:
  * @validator: a #AsValidator instance.
@@ -614,6 +1295,84 @@ as_validator_set_strict (AsValidator *validator, gboolean is_strict)
 	priv->strict = is_strict;
 }
 
+/**
+ * as_validator_get_use_result_cache:
+ * @validator: a #AsValidator instance.
+ *
+ * Returns: %TRUE if validation results are cached between runs.
+ *
+ * Since: 1.0.5
+ */
+gboolean
+as_validator_get_use_result_cache (AsValidator *validator)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	return priv->use_result_cache;
+}
+
+/**
+ * as_validator_set_use_result_cache:
+ * @validator: a #AsValidator instance.
+ * @use_cache: %TRUE to enable the validation-result cache.
+ *
+ * Enable or disable the persistent validation-result cache used by
+ * as_validator_validate_tree(). With the cache enabled, the validation result
+ * of each metainfo file is stored on disk keyed by a hash of its contents,
+ * and files whose contents did not change since the previous run have their
+ * issues replayed from the cache instead of being validated again. This
+ * drastically speeds up repeated validation of large trees where only few
+ * files change between runs, e.g. in per-commit CI checks.
+ *
+ * Issue severities are re-read from the current tag registry when cached
+ * results are replayed, so severity overrides still take effect.
+ * Keep the cache disabled if external release-description files may change
+ * independently of the metainfo files that reference them, as only the
+ * metainfo file contents are hashed.
+ *
+ * Since: 1.0.5
+ */
+void
+as_validator_set_use_result_cache (AsValidator *validator, gboolean use_cache)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	priv->use_result_cache = use_cache;
+}
+
+/**
+ * as_validator_get_max_threads:
+ * @validator: a #AsValidator instance.
+ *
+ * Returns: the maximum amount of worker threads used for tree validation,
+ * or 0 if the amount is selected automatically.
+ *
+ * Since: 1.0.5
+ */
+guint
+as_validator_get_max_threads (AsValidator *validator)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	return priv->max_threads;
+}
+
+/**
+ * as_validator_set_max_threads:
+ * @validator: a #AsValidator instance.
+ * @max_threads: maximum amount of worker threads, or 0 for automatic selection.
+ *
+ * Set the maximum amount of worker threads that as_validator_validate_tree()
+ * may use to validate metainfo files in parallel.
+ * By default the amount is selected automatically based on the available
+ * processors, set this to 1 to validate everything serially.
+ *
+ * Since: 1.0.5
+ */
+void
+as_validator_set_max_threads (AsValidator *validator, guint max_threads)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	priv->max_threads = max_threads;
+}
+
 /**
  * as_validator_add_override:
  * @validator: a #AsValidator instance.
@@ -636,7 +1395,6 @@ as_validator_add_override (AsValidator *validator,
 			   AsIssueSeverity severity_override,
 			   GError **error)
 {
-	AsValidatorPrivate *priv = GET_PRIVATE (validator);
 	AsValidatorIssueTag *tag_data = NULL;
 	AsIssueSeverity real_severity;
 
@@ -674,7 +1432,7 @@ as_validator_add_override (AsValidator *validator,
 		return FALSE;
 	}
 
-	tag_data = g_hash_table_lookup (priv->issue_tags, tag);
+	tag_data = as_validator_issue_tag_lookup (tag);
 	if (tag_data == NULL) {
 		g_set_error (
 		    error,
@@ -3048,8 +3806,12 @@ as_validator_check_custom (AsValidator *validator, xmlNode *node)
 
 /**
  * as_validator_validate_component_node:
+ *
+ * Validate a single component XML node, in the format style set on @ctx.
+ * Internally visible so appstream-compose can verify generated component
+ * nodes in-memory, without a serialize/re-parse cycle.
  **/
-static AsComponent *
+AsComponent *
 as_validator_validate_component_node (AsValidator *validator, AsContext *ctx, xmlNode *root)
 {
 	AsComponent *cpt;
@@ -3740,49 +4502,227 @@ as_validator_validate_component_node (AsValidator *validator, AsContext *ctx, xm
 		AsReleaseList *releases = as_component_get_releases_plain (cpt);
 		AsRelease *release_prev = as_release_list_index (releases, 0);
 
-		for (guint i = 1; i < as_release_list_len (releases); i++) {
-			AsRelease *release = as_release_list_index (releases, i);
-			const gchar *version = as_release_get_version (release);
-			const gchar *version_prev = as_release_get_version (release_prev);
-			if (version == NULL || version_prev == NULL)
+		for (guint i = 1; i < as_release_list_len (releases); i++) {
+			AsRelease *release = as_release_list_index (releases, i);
+			const gchar *version = as_release_get_version (release);
+			const gchar *version_prev = as_release_get_version (release_prev);
+			if (version == NULL || version_prev == NULL)
+				continue;
+			if (as_vercmp_simple (version_prev, version) < 0) {
+				as_validator_add_issue (validator,
+							NULL,
+							"releases-not-in-order",
+							"%s << %s",
+							version_prev,
+							version);
+			}
+			release_prev = release;
+		}
+	} else {
+		/* we have no release information! */
+		AsComponentKind kind = as_component_get_kind (cpt);
+		if (kind == AS_COMPONENT_KIND_DESKTOP_APP ||
+		    kind == AS_COMPONENT_KIND_CONSOLE_APP) {
+			/* show an info about missing age rating for application-type components */
+			as_validator_add_issue (validator, NULL, "releases-info-missing", NULL);
+		}
+	}
+
+	/* check content_rating */
+	if (as_component_get_content_ratings (cpt)->len == 0 && !is_merge_cpt) {
+		AsComponentKind kind = as_component_get_kind (cpt);
+		if (kind == AS_COMPONENT_KIND_DESKTOP_APP ||
+		    kind == AS_COMPONENT_KIND_CONSOLE_APP || kind == AS_COMPONENT_KIND_WEB_APP) {
+			/* show an info about missing age rating for application-type components */
+			as_validator_add_issue (validator, NULL, "content-rating-missing", NULL);
+		}
+	}
+
+	/* check if we had a developer tag */
+	if (!g_hash_table_contains (found_tags, "developer")) {
+		as_validator_add_issue (validator, NULL, "developer-info-missing", NULL);
+	}
+
+	/* run any queued URL availability checks while their nodes are still valid */
+	as_validator_flush_url_checks (validator);
+
+	as_validator_clear_current_cpt (validator);
+	return cpt;
+}
+
+/**
+ * as_validator_xml_read_cb:
+ *
+ * Feed decompressed chunks from a #GInputStream to the libxml2 reader.
+ */
+static int
+as_validator_xml_read_cb (void *context, char *buffer, int len)
+{
+	return (int)
+	    g_input_stream_read (G_INPUT_STREAM (context), buffer, (gsize) len, NULL, NULL);
+}
+
+/**
+ * as_validator_xml_reader_error_cb:
+ *
+ * Collect parser errors emitted while reading an XML stream.
+ */
+static void
+as_validator_xml_reader_error_cb (void *arg,
+				  const char *msg,
+				  xmlParserSeverities severity,
+				  xmlTextReaderLocatorPtr locator)
+{
+	gchar **error_str_ptr = arg;
+	gchar *old_msg = *error_str_ptr;
+
+	if (severity != XML_PARSER_SEVERITY_ERROR && severity != XML_PARSER_SEVERITY_VALIDITY_ERROR)
+		return;
+
+	*error_str_ptr = g_strdup_printf ("%sline %i: %s",
+					  (old_msg != NULL) ? old_msg : "",
+					  xmlTextReaderLocatorLineNumber (locator),
+					  msg);
+	g_free (old_msg);
+}
+
+/**
+ * as_validator_validate_stream:
+ *
+ * Validate AppStream XML read incrementally from @stream.
+ * For catalog metadata, only one component subtree is held in memory at a
+ * time, so even huge (compressed) catalogs can be validated with a bounded
+ * amount of memory.
+ */
+static gboolean
+as_validator_validate_stream (AsValidator *validator, GInputStream *stream)
+{
+	g_autoptr(AsContext) ctx = NULL;
+	g_autofree gchar *xml_error_msg = NULL;
+	xmlTextReader *reader = NULL;
+	const gchar *root_name = NULL;
+	gboolean ret = TRUE;
+	AsComponent *cpt;
+	gint r;
+
+	/* setup networking, in case we want to check URLs */
+	as_validator_setup_networking (validator);
+
+	/* clear any issues from previous runs */
+	as_validator_clear_issues (validator);
+
+	ctx = as_context_new ();
+	as_context_set_locale (ctx, "C");
+
+	reader = xmlReaderForIO (as_validator_xml_read_cb,
+				 NULL, /* close callback */
+				 stream,
+				 NULL, /* URL */
+				 "utf-8",
+				 XML_PARSE_NOBLANKS | XML_PARSE_NONET | XML_PARSE_BIG_LINES |
+				     XML_PARSE_PEDANTIC);
+	if (reader == NULL) {
+		as_validator_add_issue (validator,
+					NULL,
+					"xml-markup-invalid",
+					"Unable to create XML reader.");
+		return FALSE;
+	}
+	xmlTextReaderSetErrorHandler (reader, as_validator_xml_reader_error_cb, &xml_error_msg);
+
+	/* advance to the root element */
+	while ((r = xmlTextReaderRead (reader)) == 1) {
+		if (xmlTextReaderNodeType (reader) == XML_READER_TYPE_ELEMENT)
+			break;
+	}
+	if (r != 1) {
+		as_validator_add_issue (validator,
+					NULL,
+					"xml-markup-invalid",
+					"%s",
+					(xml_error_msg != NULL) ? xml_error_msg
+								: "The XML document is empty.");
+		xmlFreeTextReader (reader);
+		return FALSE;
+	}
+
+	root_name = (const gchar *) xmlTextReaderConstName (reader);
+	if (g_strcmp0 (root_name, "components") == 0) {
+		as_context_set_style (ctx, AS_FORMAT_STYLE_CATALOG);
+
+		r = xmlTextReaderRead (reader);
+		while (r == 1) {
+			const gchar *node_name;
+
+			/* we only care about the component elements below the root */
+			if (xmlTextReaderNodeType (reader) != XML_READER_TYPE_ELEMENT ||
+			    xmlTextReaderDepth (reader) != 1) {
+				r = xmlTextReaderRead (reader);
 				continue;
-			if (as_vercmp_simple (version_prev, version) < 0) {
+			}
+
+			node_name = (const gchar *) xmlTextReaderConstName (reader);
+			if (g_strcmp0 (node_name, "component") == 0) {
+				/* materialize just this component's subtree, the reader
+				 * prunes it again once we move past it */
+				xmlNode *node = xmlTextReaderExpand (reader);
+				if (node == NULL) {
+					ret = FALSE;
+					r = -1;
+					break;
+				}
+				cpt = as_validator_validate_component_node (validator, ctx, node);
+				if (cpt != NULL)
+					g_object_unref (cpt);
+			} else {
 				as_validator_add_issue (validator,
 							NULL,
-							"releases-not-in-order",
-							"%s << %s",
-							version_prev,
-							version);
+							"component-catalog-tag-invalid",
+							"%s",
+							node_name);
+				ret = FALSE;
 			}
-			release_prev = release;
+
+			/* skip over the subtree we just processed */
+			r = xmlTextReaderNext (reader);
 		}
-	} else {
-		/* we have no release information! */
-		AsComponentKind kind = as_component_get_kind (cpt);
-		if (kind == AS_COMPONENT_KIND_DESKTOP_APP ||
-		    kind == AS_COMPONENT_KIND_CONSOLE_APP) {
-			/* show an info about missing age rating for application-type components */
-			as_validator_add_issue (validator, NULL, "releases-info-missing", NULL);
+		if (r < 0) {
+			as_validator_add_issue (validator,
+						NULL,
+						"xml-markup-invalid",
+						"%s",
+						(xml_error_msg != NULL) ? xml_error_msg
+									: "Unable to parse XML data.");
+			ret = FALSE;
 		}
-	}
+	} else if (g_strcmp0 (root_name, "component") == 0) {
+		/* metainfo files are small, expanding the whole document is fine */
+		xmlNode *root = xmlTextReaderExpand (reader);
 
-	/* check content_rating */
-	if (as_component_get_content_ratings (cpt)->len == 0 && !is_merge_cpt) {
-		AsComponentKind kind = as_component_get_kind (cpt);
-		if (kind == AS_COMPONENT_KIND_DESKTOP_APP ||
-		    kind == AS_COMPONENT_KIND_CONSOLE_APP || kind == AS_COMPONENT_KIND_WEB_APP) {
-			/* show an info about missing age rating for application-type components */
-			as_validator_add_issue (validator, NULL, "content-rating-missing", NULL);
+		as_context_set_style (ctx, AS_FORMAT_STYLE_METAINFO);
+		if (root == NULL) {
+			as_validator_add_issue (validator,
+						NULL,
+						"xml-markup-invalid",
+						"%s",
+						(xml_error_msg != NULL) ? xml_error_msg
+									: "Unable to parse XML data.");
+			xmlFreeTextReader (reader);
+			return FALSE;
 		}
+		cpt = as_validator_validate_component_node (validator, ctx, root);
+		if (cpt != NULL)
+			g_object_unref (cpt);
+	} else if (g_str_has_prefix (root_name, "application")) {
+		as_validator_add_issue (validator, NULL, "metainfo-ancient", NULL);
+		ret = FALSE;
+	} else {
+		as_validator_add_issue (validator, NULL, "root-tag-unknown", "%s", root_name);
+		ret = FALSE;
 	}
 
-	/* check if we had a developer tag */
-	if (!g_hash_table_contains (found_tags, "developer")) {
-		as_validator_add_issue (validator, NULL, "developer-info-missing", NULL);
-	}
-
-	as_validator_clear_current_cpt (validator);
-	return cpt;
+	xmlFreeTextReader (reader);
+	return ret && as_validator_check_success (validator);
 }
 
 /**
@@ -3859,6 +4799,14 @@ as_validator_validate_file (AsValidator *validator, GFile *metadata_file)
 		stream_data = g_object_ref (file_stream);
 	}
 
+	if (conv != NULL) {
+		/* compressed catalogs can be huge - validate them as a stream, so we
+		 * never have to hold the fully decompressed document in memory */
+		ret = as_validator_validate_stream (validator, stream_data);
+		as_validator_clear_current_fname (validator);
+		return ret;
+	}
+
 	asxmldata = g_string_new ("");
 	buffer = g_malloc (buffer_size);
 	while ((len = g_input_stream_read (stream_data, buffer, buffer_size, NULL, &tmp_error)) >
@@ -3947,6 +4895,8 @@ as_validator_validate_bytes (AsValidator *validator, GBytes *metadata)
 	as_context_set_locale (ctx, "C");
 
 	data = g_bytes_get_data (metadata, &data_len);
+	/* retain the source for later context-snippet extraction */
+	as_validator_register_source (validator, data, data_len);
 	doc = as_validator_open_xml_document (validator, data, data_len);
 	if (doc == NULL)
 		return FALSE;
@@ -4174,6 +5124,281 @@ as_validator_analyze_component_metainfo_relation_cb (const gchar *fname,
 	as_validator_clear_current_fname (data->validator);
 }
 
+/**
+ * as_validator_merge_issues:
+ *
+ * Copy all issues registered in @source into @validator, keeping the
+ * deduplication semantics of as_validator_add_issue() intact.
+ **/
+static void
+as_validator_merge_issues (AsValidator *validator, AsValidator *source)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	AsValidatorPrivate *spriv = GET_PRIVATE (source);
+	GHashTableIter iter;
+	gpointer key, value;
+
+	g_hash_table_iter_init (&iter, spriv->issues);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		AsValidatorIssue *issue = AS_VALIDATOR_ISSUE (value);
+		const gchar *fname_key;
+		GPtrArray *ilist;
+
+		if (g_hash_table_contains (priv->issues, (const gchar *) key))
+			continue;
+		g_hash_table_insert (priv->issues,
+				     g_strdup ((const gchar *) key),
+				     g_object_ref (issue));
+
+		/* the issue is new, we can add it to our by-file listing */
+		fname_key = as_validator_issue_get_filename (issue);
+		if (fname_key == NULL)
+			fname_key = "";
+		ilist = g_hash_table_lookup (priv->issues_per_file, fname_key);
+		if (ilist == NULL) {
+			ilist = g_ptr_array_new_with_free_func (g_object_unref);
+			g_hash_table_insert (priv->issues_per_file, g_strdup (fname_key), ilist);
+		}
+		g_ptr_array_add (ilist, g_object_ref (issue));
+	}
+
+	/* adopt the retained source data, so snippet extraction keeps
+	 * working for the merged issues */
+	g_hash_table_iter_init (&iter, spriv->source_index);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		AsValidatorSourceIndex *sidx = value;
+		AsValidatorSourceIndex *copy;
+
+		if (g_hash_table_contains (priv->source_index, (const gchar *) key))
+			continue;
+		copy = g_new0 (AsValidatorSourceIndex, 1);
+		copy->bytes = g_bytes_ref (sidx->bytes);
+		copy->line_offsets = g_array_ref (sidx->line_offsets);
+		g_hash_table_insert (priv->source_index, g_strdup ((const gchar *) key), copy);
+	}
+}
+
+/**
+ * as_validator_validate_file_for_tree:
+ *
+ * Validate a single metainfo file as part of a tree validation run,
+ * registering any component that was read in @validated_cpts.
+ *
+ * Returns: %FALSE if the file can not be considered valid metainfo at all.
+ **/
+static gboolean
+as_validator_validate_file_for_tree (AsValidator *validator,
+				     AsContext *ctx,
+				     const gchar *fname,
+				     GHashTable *validated_cpts)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GInputStream) file_stream = NULL;
+	g_autoptr(GError) tmp_error = NULL;
+	g_autoptr(GString) asdata = NULL;
+	gssize len;
+	const gsize buffer_size = 1024 * 24;
+	g_autofree gchar *buffer = NULL;
+	xmlNode *root;
+	xmlDoc *doc;
+	g_autofree gchar *fname_basename = NULL;
+	g_autofree gchar *hash_key = NULL;
+	g_autoptr(GHashTable) pf_baseline = NULL;
+	gboolean ret = TRUE;
+
+	file = g_file_new_for_path (fname);
+	if (!g_file_query_exists (file, NULL)) {
+		g_warning ("File '%s' suddenly vanished.", fname);
+		return TRUE;
+	}
+
+	fname_basename = g_path_get_basename (fname);
+	as_validator_set_current_fname (validator, fname_basename);
+
+	/* load a plaintext file */
+	file_stream = G_INPUT_STREAM (g_file_read (file, NULL, &tmp_error));
+	if (tmp_error != NULL) {
+		as_validator_add_issue (validator, NULL, "file-read-failed", "%s", tmp_error->message);
+		return TRUE;
+	}
+
+	asdata = g_string_new ("");
+	buffer = g_malloc (buffer_size);
+	while ((len = g_input_stream_read (file_stream, buffer, buffer_size, NULL, &tmp_error)) >
+	       0) {
+		g_string_append_len (asdata, buffer, len);
+	}
+	/* check if there was an error */
+	if (tmp_error != NULL) {
+		as_validator_add_issue (validator, NULL, "file-read-failed", "%s", tmp_error->message);
+		return TRUE;
+	}
+
+	/* retain the source for later context-snippet extraction */
+	as_validator_register_source (validator, asdata->str, asdata->len);
+
+	if (priv->use_result_cache) {
+		g_autofree gchar *checksum = NULL;
+		GHashTableIter pf_iter;
+		gpointer pf_key, pf_value;
+		gboolean cached_valid = TRUE;
+
+		/* the cached result only depends on the file contents and on whether
+		 * web URLs were verified as part of the validation */
+		checksum = g_compute_checksum_for_data (G_CHECKSUM_SHA256,
+							(const guchar *) asdata->str,
+							asdata->len);
+		hash_key = g_strdup_printf ("%s-net%d", checksum, priv->check_urls ? 1 : 0);
+
+		if (as_validator_result_cache_replay (validator,
+						      hash_key,
+						      fname_basename,
+						      &cached_valid)) {
+			/* the file is unchanged and its issues were replayed - we still
+			 * parse the component quietly, as cross-file checks performed
+			 * later need it registered in @validated_cpts */
+			doc = as_xml_parse_document (asdata->str, asdata->len, FALSE, NULL);
+			if (doc != NULL) {
+				root = xmlDocGetRootElement (doc);
+				if (g_strcmp0 ((gchar *) root->name, "component") == 0) {
+					g_autoptr(AsComponent) cpt = as_component_new ();
+					if (as_component_load_from_xml (cpt, ctx, root, NULL))
+						g_hash_table_insert (
+						    validated_cpts,
+						    g_strdup (fname_basename),
+						    g_steal_pointer (&cpt));
+				}
+				xmlFreeDoc (doc);
+			}
+			as_validator_clear_current_fname (validator);
+			return cached_valid;
+		}
+
+		/* no cached result - remember how many issues each file has already,
+		 * so we can tell later which ones this validation run added */
+		pf_baseline = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+		g_hash_table_iter_init (&pf_iter, priv->issues_per_file);
+		while (g_hash_table_iter_next (&pf_iter, &pf_key, &pf_value))
+			g_hash_table_insert (pf_baseline,
+					     g_strdup (pf_key),
+					     GUINT_TO_POINTER (((GPtrArray *) pf_value)->len));
+	}
+
+	/* now read the XML */
+	doc = as_validator_open_xml_document (validator, asdata->str, asdata->len);
+	if (doc == NULL) {
+		as_validator_clear_current_fname (validator);
+		return TRUE;
+	}
+	root = xmlDocGetRootElement (doc);
+
+	if (g_strcmp0 ((gchar *) root->name, "component") == 0) {
+		AsComponent *cpt;
+		cpt = as_validator_validate_component_node (validator, ctx, root);
+		if (cpt != NULL)
+			g_hash_table_insert (validated_cpts, g_strdup (fname_basename), cpt);
+	} else if (g_strcmp0 ((gchar *) root->name, "components") == 0) {
+		as_validator_add_issue (validator, root, "metainfo-multiple-components", NULL);
+		ret = FALSE;
+	} else if (g_str_has_prefix ((gchar *) root->name, "application")) {
+		as_validator_add_issue (validator, root, "metainfo-ancient", NULL);
+		ret = FALSE;
+	}
+
+	as_validator_clear_current_fname (validator);
+	xmlFreeDoc (doc);
+
+	if (pf_baseline != NULL)
+		as_validator_result_cache_record (validator,
+						  hash_key,
+						  fname_basename,
+						  ret,
+						  pf_baseline);
+
+	return ret;
+}
+
+/**
+ * AsValidatorTreeShard:
+ *
+ * Per-thread state for validating a subset of the metainfo files
+ * of a tree, with its own issue accumulator.
+ */
+typedef struct {
+	AsValidator *validator;
+	GPtrArray   *fnames; /* borrowed from the metainfo file list */
+	GHashTable  *validated_cpts;
+	gboolean     ret;
+} AsValidatorTreeShard;
+
+static AsValidatorTreeShard *
+as_validator_tree_shard_new (AsValidator *parent)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (parent);
+	AsValidatorPrivate *shard_priv;
+	AsValidatorTreeShard *shard;
+
+	shard = g_new0 (AsValidatorTreeShard, 1);
+	shard->validator = as_validator_new ();
+	shard->fnames = g_ptr_array_new ();
+	shard->validated_cpts = g_hash_table_new_full (g_str_hash,
+						       g_str_equal,
+						       g_free,
+						       g_object_unref);
+	shard->ret = TRUE;
+
+	/* inherit all settings from the coordinating validator - the issue-tag
+	 * registry (including any severity overrides) is shared process-wide
+	 * and immutable during validation, so it needs no copying */
+	as_validator_set_strict (shard->validator, priv->strict);
+	as_validator_set_allow_net (shard->validator, priv->check_urls);
+	as_validator_set_use_result_cache (shard->validator, priv->use_result_cache);
+
+	shard_priv = GET_PRIVATE (shard->validator);
+	for (guint i = 0; i < priv->release_data->len; i++) {
+		AsReleaseDataPair *pair = g_ptr_array_index (priv->release_data, i);
+		g_ptr_array_add (shard_priv->release_data,
+				 as_release_data_pair_new (pair->fname, pair->bytes));
+	}
+
+	return shard;
+}
+
+static void
+as_validator_tree_shard_free (AsValidatorTreeShard *shard)
+{
+	g_object_unref (shard->validator);
+	g_ptr_array_unref (shard->fnames);
+	g_hash_table_unref (shard->validated_cpts);
+	g_free (shard);
+}
+
+/**
+ * as_validator_tree_shard_run_cb:
+ *
+ * Validate all metainfo files assigned to this shard.
+ **/
+static void
+as_validator_tree_shard_run_cb (AsValidatorTreeShard *shard, gpointer user_data)
+{
+	g_autoptr(AsContext) ctx = NULL;
+
+	/* set up XML parser */
+	ctx = as_context_new ();
+	as_context_set_locale (ctx, "C");
+	as_context_set_style (ctx, AS_FORMAT_STYLE_METAINFO);
+
+	for (guint i = 0; i < shard->fnames->len; i++) {
+		const gchar *fname = (const gchar *) g_ptr_array_index (shard->fnames, i);
+		if (!as_validator_validate_file_for_tree (shard->validator,
+							  ctx,
+							  fname,
+							  shard->validated_cpts))
+			shard->ret = FALSE;
+	}
+}
+
 /**
  * as_validator_validate_tree:
  * @validator: An instance of #AsValidator.
@@ -4186,6 +5411,7 @@ as_validator_analyze_component_metainfo_relation_cb (const gchar *fname,
 gboolean
 as_validator_validate_tree (AsValidator *validator, const gchar *root_dir)
 {
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
 	g_autofree gchar *metainfo_dir = NULL;
 	g_autofree gchar *apps_dir = NULL;
 	g_autoptr(GPtrArray) mfiles = NULL;
@@ -4193,8 +5419,8 @@ as_validator_validate_tree (AsValidator *validator, const gchar *root_dir)
 	GHashTable *dfilenames = NULL;
 	GHashTable *validated_cpts = NULL;
 	guint i;
+	guint n_threads;
 	gboolean ret = TRUE;
-	g_autoptr(AsContext) ctx = NULL;
 	struct MInfoCheckData ht_helper;
 
 	/* cleanup */
@@ -4231,11 +5457,6 @@ as_validator_validate_tree (AsValidator *validator, const gchar *root_dir)
 	/* holds a filename -> component mapping */
 	validated_cpts = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
 
-	/* set up XML parser */
-	ctx = as_context_new ();
-	as_context_set_locale (ctx, "C");
-	as_context_set_style (ctx, AS_FORMAT_STYLE_METAINFO);
-
 	/* validate all metainfo files */
 	mfiles = as_utils_find_files_matching (metainfo_dir, "*.xml", FALSE, NULL);
 
@@ -4244,88 +5465,77 @@ as_validator_validate_tree (AsValidator *validator, const gchar *root_dir)
 	if (mfiles == NULL)
 		mfiles = g_ptr_array_new_with_free_func (g_free);
 
-	for (i = 0; i < mfiles->len; i++) {
-		const gchar *fname;
-		g_autoptr(GFile) file = NULL;
-		g_autoptr(GInputStream) file_stream = NULL;
+	n_threads = priv->max_threads == 0 ? g_get_num_processors () : priv->max_threads;
+	n_threads = MIN (n_threads, mfiles->len);
+	if (n_threads <= 1) {
+		/* not enough work for multiple threads, validate everything serially */
+		g_autoptr(AsContext) ctx = NULL;
+
+		/* set up XML parser */
+		ctx = as_context_new ();
+		as_context_set_locale (ctx, "C");
+		as_context_set_style (ctx, AS_FORMAT_STYLE_METAINFO);
+
+		for (i = 0; i < mfiles->len; i++) {
+			const gchar *fname = (const gchar *) g_ptr_array_index (mfiles, i);
+			if (!as_validator_validate_file_for_tree (validator,
+								  ctx,
+								  fname,
+								  validated_cpts))
+				ret = FALSE;
+		}
+	} else {
+		/* validate the individual files concurrently, each worker thread
+		 * accumulating issues in a validator of its own */
+		g_autoptr(GPtrArray) shards = NULL;
 		g_autoptr(GError) tmp_error = NULL;
-		g_autoptr(GString) asdata = NULL;
-		gssize len;
-		const gsize buffer_size = 1024 * 24;
-		g_autofree gchar *buffer = NULL;
-		xmlNode *root;
-		xmlDoc *doc;
-		g_autofree gchar *fname_basename = NULL;
-
-		fname = (const gchar *) g_ptr_array_index (mfiles, i);
-		file = g_file_new_for_path (fname);
-		if (!g_file_query_exists (file, NULL)) {
-			g_warning ("File '%s' suddenly vanished.", fname);
-			g_object_unref (file);
-			continue;
+		GThreadPool *tpool;
+
+		shards = g_ptr_array_new_with_free_func (
+		    (GDestroyNotify) as_validator_tree_shard_free);
+		for (i = 0; i < n_threads; i++)
+			g_ptr_array_add (shards, as_validator_tree_shard_new (validator));
+		for (i = 0; i < mfiles->len; i++) {
+			AsValidatorTreeShard *shard = g_ptr_array_index (shards, i % n_threads);
+			g_ptr_array_add (shard->fnames, g_ptr_array_index (mfiles, i));
 		}
 
-		fname_basename = g_path_get_basename (fname);
-		as_validator_set_current_fname (validator, fname_basename);
+		tpool = g_thread_pool_new ((GFunc) as_validator_tree_shard_run_cb,
+					   NULL,
+					   n_threads,
+					   FALSE,
+					   &tmp_error);
+		if (tpool == NULL) {
+			g_warning ("Unable to create thread pool for metadata validation "
+				   "(will validate serially): %s",
+				   tmp_error->message);
+			for (i = 0; i < shards->len; i++)
+				as_validator_tree_shard_run_cb (g_ptr_array_index (shards, i),
+								NULL);
+		} else {
+			for (i = 0; i < shards->len; i++)
+				g_thread_pool_push (tpool, g_ptr_array_index (shards, i), NULL);
 
-		/* load a plaintext file */
-		file_stream = G_INPUT_STREAM (g_file_read (file, NULL, &tmp_error));
-		if (tmp_error != NULL) {
-			as_validator_add_issue (validator,
-						NULL,
-						"file-read-failed",
-						"%s",
-						tmp_error->message);
-			continue;
+			/* wait for all validation tasks to complete */
+			g_thread_pool_free (tpool, FALSE, TRUE);
 		}
 
-		asdata = g_string_new ("");
-		buffer = g_malloc (buffer_size);
-		while ((len = g_input_stream_read (file_stream,
-						   buffer,
-						   buffer_size,
-						   NULL,
-						   &tmp_error)) > 0) {
-			g_string_append_len (asdata, buffer, len);
-		}
-		/* check if there was an error */
-		if (tmp_error != NULL) {
-			as_validator_add_issue (validator,
-						NULL,
-						"file-read-failed",
-						"%s",
-						tmp_error->message);
-			continue;
-		}
+		/* merge the per-thread results back into this validator */
+		for (i = 0; i < shards->len; i++) {
+			AsValidatorTreeShard *shard = g_ptr_array_index (shards, i);
+			GHashTableIter cpt_iter;
+			gpointer key, value;
 
-		/* now read the XML */
-		doc = as_validator_open_xml_document (validator, asdata->str, asdata->len);
-		if (doc == NULL) {
-			as_validator_clear_current_fname (validator);
-			continue;
-		}
-		root = xmlDocGetRootElement (doc);
+			if (!shard->ret)
+				ret = FALSE;
+			as_validator_merge_issues (validator, shard->validator);
 
-		if (g_strcmp0 ((gchar *) root->name, "component") == 0) {
-			AsComponent *cpt;
-			cpt = as_validator_validate_component_node (validator, ctx, root);
-			if (cpt != NULL)
+			g_hash_table_iter_init (&cpt_iter, shard->validated_cpts);
+			while (g_hash_table_iter_next (&cpt_iter, &key, &value))
 				g_hash_table_insert (validated_cpts,
-						     g_strdup (fname_basename),
-						     cpt);
-		} else if (g_strcmp0 ((gchar *) root->name, "components") == 0) {
-			as_validator_add_issue (validator,
-						root,
-						"metainfo-multiple-components",
-						NULL);
-			ret = FALSE;
-		} else if (g_str_has_prefix ((gchar *) root->name, "application")) {
-			as_validator_add_issue (validator, root, "metainfo-ancient", NULL);
-			ret = FALSE;
+						     g_strdup ((const gchar *) key),
+						     g_object_ref (AS_COMPONENT (value)));
 		}
-
-		as_validator_clear_current_fname (validator);
-		xmlFreeDoc (doc);
 	}
 
 	/* check if we have matching .desktop files */
@@ -4407,6 +5617,75 @@ as_validator_get_issues_per_file (AsValidator *validator)
 	return priv->issues_per_file;
 }
 
+/**
+ * as_validator_get_source_snippet:
+ * @validator: An instance of #AsValidator.
+ * @issue: The #AsValidatorIssue to extract a source snippet for.
+ * @context_lines: Amount of context lines to include before and after the issue line.
+ * @first_line: (out) (optional): Line number of the first returned line.
+ *
+ * Extract the source lines surrounding the location of @issue from the
+ * data that was validated in this run. The source is retained in memory
+ * by the validator, so no file needs to be re-read for this operation.
+ *
+ * Returns: (transfer full) (nullable): the source snippet, or %NULL if no source
+ *	    data or line information is available for @issue.
+ *
+ * Since: 1.0.5
+ */
+gchar *
+as_validator_get_source_snippet (AsValidator *validator,
+				 AsValidatorIssue *issue,
+				 guint context_lines,
+				 glong *first_line)
+{
+	AsValidatorPrivate *priv = GET_PRIVATE (validator);
+	AsValidatorSourceIndex *sidx;
+	const gchar *fname_key;
+	const gchar *data;
+	gsize data_len;
+	glong line;
+	gsize n_lines;
+	gsize line_start;
+	gsize line_end;
+	gsize start_off;
+	gsize end_off;
+
+	line = as_validator_issue_get_line (issue);
+	if (line <= 0)
+		return NULL;
+
+	fname_key = as_validator_issue_get_filename (issue);
+	if (fname_key == NULL)
+		fname_key = "";
+	sidx = g_hash_table_lookup (priv->source_index, fname_key);
+	if (sidx == NULL)
+		return NULL;
+
+	data = g_bytes_get_data (sidx->bytes, &data_len);
+	n_lines = sidx->line_offsets->len;
+	if ((gsize) line > n_lines)
+		return NULL;
+
+	/* line numbers are 1-based */
+	line_start = (gsize) line > (gsize) context_lines + 1 ? line - context_lines : 1;
+	line_end = MIN ((gsize) line + context_lines, n_lines);
+
+	start_off = g_array_index (sidx->line_offsets, gsize, line_start - 1);
+	if (line_end < n_lines)
+		end_off = g_array_index (sidx->line_offsets, gsize, line_end);
+	else
+		end_off = data_len;
+	/* drop the trailing newline of the last included line */
+	while (end_off > start_off &&
+	       (data[end_off - 1] == '\n' || data[end_off - 1] == '\r'))
+		end_off--;
+
+	if (first_line != NULL)
+		*first_line = (glong) line_start;
+	return g_strndup (data + start_off, end_off - start_off);
+}
+
 /**
  * as_validator_yaml_write_handler_cb:
  *
@@ -4437,8 +5716,7 @@ gchar *
 as_validator_get_report_yaml (AsValidator *validator, GError **error)
 {
 	AsValidatorPrivate *priv = GET_PRIVATE (validator);
-	GHashTableIter ht_iter;
-	gpointer ht_key, ht_value;
+	g_autoptr(GList) issue_files = NULL;
 	yaml_emitter_t emitter;
 	yaml_event_t event;
 	gboolean res = FALSE;
@@ -4462,10 +5740,13 @@ as_validator_get_report_yaml (AsValidator *validator, GError **error)
 		return NULL;
 	}
 
-	g_hash_table_iter_init (&ht_iter, priv->issues_per_file);
-	while (g_hash_table_iter_next (&ht_iter, &ht_key, &ht_value)) {
-		const gchar *filename = (const gchar *) ht_key;
-		GPtrArray *issues = (GPtrArray *) ht_value;
+	/* emit the report ordered by filename, so results are deterministic
+	 * even if the files were validated by multiple threads */
+	issue_files = g_hash_table_get_keys (priv->issues_per_file);
+	issue_files = g_list_sort (issue_files, (GCompareFunc) g_strcmp0);
+	for (GList *link = issue_files; link != NULL; link = link->next) {
+		const gchar *filename = (const gchar *) link->data;
+		GPtrArray *issues = g_hash_table_lookup (priv->issues_per_file, filename);
 		gboolean validation_passed = TRUE;
 
 		/* new document for this file */
@@ -4548,8 +5829,7 @@ as_validator_get_report_yaml (AsValidator *validator, GError **error)
 const gchar *
 as_validator_get_tag_explanation (AsValidator *validator, const gchar *tag)
 {
-	AsValidatorPrivate *priv = GET_PRIVATE (validator);
-	const AsValidatorIssueTag *tag_data = g_hash_table_lookup (priv->issue_tags, tag);
+	const AsValidatorIssueTag *tag_data = as_validator_issue_tag_lookup (tag);
 	if (tag_data == NULL)
 		return NULL;
 	return tag_data->explanation;
@@ -4566,8 +5846,7 @@ as_validator_get_tag_explanation (AsValidator *validator, const gchar *tag)
 AsIssueSeverity
 as_validator_get_tag_severity (AsValidator *validator, const gchar *tag)
 {
-	AsValidatorPrivate *priv = GET_PRIVATE (validator);
-	const AsValidatorIssueTag *tag_data = g_hash_table_lookup (priv->issue_tags, tag);
+	const AsValidatorIssueTag *tag_data = as_validator_issue_tag_lookup (tag);
 	if (tag_data == NULL)
 		return AS_ISSUE_SEVERITY_UNKNOWN;
 	return tag_data->severity;
@@ -4584,17 +5863,12 @@ as_validator_get_tag_severity (AsValidator *validator, const gchar *tag)
 gchar **
 as_validator_get_tags (AsValidator *validator)
 {
-	AsValidatorPrivate *priv = GET_PRIVATE (validator);
-	GHashTableIter iter;
-	gpointer ht_key;
-	guint i = 0;
+	const AsValidatorIssueTagIndex *index = as_validator_issue_tag_index ();
 	gchar **result;
 
-	result = g_new0 (gchar *, g_hash_table_size (priv->issue_tags) + 1);
-	g_hash_table_iter_init (&iter, priv->issue_tags);
-	while (g_hash_table_iter_next (&iter, &ht_key, NULL)) {
-		result[i++] = g_strdup ((const gchar *) ht_key);
-	}
+	result = g_new0 (gchar *, index->n_entries + 1);
+	for (guint i = 0; i < index->n_entries; i++)
+		result[i] = g_strdup (index->entries[i]->tag);
 
 	return result;
 }
@@ -82,6 +82,10 @@ gboolean	as_validator_add_release_file (AsValidator *validator,
 guint		as_validator_get_issue_files_count (AsValidator *validator);
 GList	       *as_validator_get_issues (AsValidator *validator);
 GHashTable     *as_validator_get_issues_per_file (AsValidator *validator);
+gchar	       *as_validator_get_source_snippet (AsValidator	  *validator,
+						 AsValidatorIssue *issue,
+						 guint		   context_lines,
+						 glong		  *first_line);
 gchar	       *as_validator_get_report_yaml (AsValidator *validator, GError **error);
 gboolean	as_validator_check_success (AsValidator *validator);
 
@@ -91,6 +95,12 @@ void		as_validator_set_allow_net (AsValidator *validator, gboolean value);
 gboolean	as_validator_get_strict (AsValidator *validator);
 void		as_validator_set_strict (AsValidator *validator, gboolean is_strict);
 
+gboolean	as_validator_get_use_result_cache (AsValidator *validator);
+void		as_validator_set_use_result_cache (AsValidator *validator, gboolean use_cache);
+
+guint		as_validator_get_max_threads (AsValidator *validator);
+void		as_validator_set_max_threads (AsValidator *validator, guint max_threads);
+
 gboolean	as_validator_add_override (AsValidator	  *validator,
 					   const gchar	  *tag,
 					   AsIssueSeverity severity_override,
@@ -141,6 +141,37 @@ cmp_part (const gchar *a, const gchar *a_end, const gchar *b, const gchar *b_end
 	return 0;
 }
 
+/**
+ * as_vercmp_versions:
+ *
+ * Compare two pre-parsed version representations.
+ */
+static gint
+as_vercmp_versions (const AsVersion *ver_a, const AsVersion *ver_b, AsVercmpFlags flags)
+{
+	gint res = 0;
+
+	if (G_UNLIKELY (ver_a->epoch != ver_b->epoch) &&
+	    (!as_flags_contains (flags, AS_VERCMP_FLAG_IGNORE_EPOCH)) &&
+	    (res = cmp_number (ver_a->epoch, ver_b->epoch, NULL, NULL)) != 0)
+		goto out;
+	else if ((res = cmp_part (ver_a->version,
+				  ver_a->version_end,
+				  ver_b->version,
+				  ver_b->version_end)) != 0)
+		goto out;
+	/* Optimizes for native version numbers (where revision is a string literal) */
+	else if (G_LIKELY (ver_a->revision != ver_b->revision) &&
+		 (res = cmp_part (ver_a->revision,
+				  ver_a->revision_end,
+				  ver_b->revision,
+				  ver_b->revision_end)) != 0)
+		goto out;
+
+out:
+	return res;
+}
+
 /**
  * as_vercmp:
  * @a: First version number
@@ -158,7 +189,6 @@ gint
 as_vercmp (const gchar *a, const gchar *b, AsVercmpFlags flags)
 {
 	AsVersion ver_a, ver_b;
-	gint res = 0;
 
 	if (a == 0 && b == 0)
 		return 0;
@@ -184,25 +214,72 @@ as_vercmp (const gchar *a, const gchar *b, AsVercmpFlags flags)
 	as_version_parse (&ver_a, a);
 	as_version_parse (&ver_b, b);
 
-	if (G_UNLIKELY (ver_a.epoch != ver_b.epoch) &&
-	    (!as_flags_contains (flags, AS_VERCMP_FLAG_IGNORE_EPOCH)) &&
-	    (res = cmp_number (ver_a.epoch, ver_b.epoch, NULL, NULL)) != 0)
-		goto out;
-	else if ((res = cmp_part (ver_a.version,
-				  ver_a.version_end,
-				  ver_b.version,
-				  ver_b.version_end)) != 0)
-		goto out;
-	/* Optimizes for native version numbers (where revision is a string literal) */
-	else if (G_LIKELY (ver_a.revision != ver_b.revision) &&
-		 (res = cmp_part (ver_a.revision,
-				  ver_a.revision_end,
-				  ver_b.revision,
-				  ver_b.revision_end)) != 0)
-		goto out;
+	return as_vercmp_versions (&ver_a, &ver_b, flags);
+}
 
-out:
-	return res;
+/**
+ * as_vercmp_batch:
+ * @a: Version number to compare all other versions against.
+ * @versions: (array length=n_versions): Version numbers to compare with.
+ * @n_versions: Number of entries in @versions.
+ * @results: (array length=n_versions) (out caller-allocates): Comparison results.
+ * @flags: Flags, e.g. %AS_VERCMP_FLAG_NONE
+ *
+ * Compare one version number against many others in a single call,
+ * with the same semantics as as_vercmp().
+ * The fixed version @a is only parsed once, which makes this faster
+ * than calling as_vercmp() in a loop when comparing a candidate
+ * version against a large set of versions.
+ *
+ * Each entry of @results is set to the result of comparing @a with
+ * the respective entry of @versions.
+ *
+ * Since: 1.0.5
+ */
+void
+as_vercmp_batch (const gchar *a,
+		 const gchar *const *versions,
+		 gsize n_versions,
+		 gint *results,
+		 AsVercmpFlags flags)
+{
+	AsVersion ver_a, ver_b;
+	const gboolean ignore_epoch = as_flags_contains (flags, AS_VERCMP_FLAG_IGNORE_EPOCH);
+
+	g_return_if_fail (versions != NULL || n_versions == 0);
+	g_return_if_fail (results != NULL || n_versions == 0);
+
+	if (a == NULL) {
+		for (gsize i = 0; i < n_versions; i++)
+			results[i] = (versions[i] == NULL) ? 0 : -1;
+		return;
+	}
+
+	/* parse the fixed side only once */
+	as_version_parse (&ver_a, a);
+
+	for (gsize i = 0; i < n_versions; i++) {
+		const gchar *b = versions[i];
+
+		if (b == NULL) {
+			results[i] = 1;
+			continue;
+		}
+		if (a == b || g_strcmp0 (a, b) == 0) {
+			results[i] = 0;
+			continue;
+		}
+
+		/* Optimize the case of differing single digit epochs. */
+		if (!ignore_epoch && *a != *b && *a != '\0' && *b != '\0' && a[1] == ':' &&
+		    b[1] == ':') {
+			results[i] = *a < *b ? -1 : 1;
+			continue;
+		}
+
+		as_version_parse (&ver_b, b);
+		results[i] = as_vercmp_versions (&ver_a, &ver_b, flags);
+	}
 }
 
 /**
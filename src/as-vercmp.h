@@ -44,6 +44,11 @@ typedef enum {
 
 gint	 as_vercmp (const gchar *a, const gchar *b, AsVercmpFlags flags);
 gint	 as_vercmp_simple (const gchar *a, const gchar *b);
+void	 as_vercmp_batch (const gchar	     *a,
+			  const gchar *const *versions,
+			  gsize		      n_versions,
+			  gint		     *results,
+			  AsVercmpFlags	      flags);
 
 gboolean as_vercmp_test_match (const gchar	*ver1,
 			       AsRelationCompare compare,
@@ -348,7 +348,7 @@ as_video_load_from_xml (AsVideo *video, AsContext *ctx, xmlNode *node, GError **
 	g_autofree gchar *content = NULL;
 	g_autofree gchar *codec_kind = NULL;
 	g_autofree gchar *container_kind = NULL;
-	g_autofree gchar *lang = NULL;
+	const gchar *lang = NULL;
 	gchar *str;
 
 	content = as_xml_get_node_value (node);
@@ -22,7 +22,10 @@
 
 #include <string.h>
 #include <libxml/xmlversion.h>
+#include <libxml/dict.h>
+#include <libxml/xmlsave.h>
 
+#include "as-context-private.h"
 #include "as-utils.h"
 #include "as-utils-private.h"
 
@@ -112,16 +115,17 @@ as_xml_get_prop_value_as_int (const xmlNode *node, const gchar *prop_name)
  * as_xml_get_node_locale:
  * @node: a XML node
  *
- * Returns: The locale of a node, "C" if untranslated. Free result with %g_free
+ * Returns: The locale of a node, "C" if untranslated. The string is interned
+ * in the scratch arena of @ctx and must not be freed.
  */
-gchar *
+const gchar *
 as_xml_get_node_locale (AsContext *ctx, xmlNode *node)
 {
-	gchar *lang = (gchar *) xmlGetProp (node, (xmlChar *) "lang");
+	g_autofree gchar *lang = (gchar *) xmlGetProp (node, (xmlChar *) "lang");
 	if (lang == NULL)
-		lang = g_strdup ("C");
+		return "C";
 
-	return lang;
+	return as_context_scratch_intern (ctx, lang);
 }
 
 /**
@@ -130,35 +134,40 @@ as_xml_get_node_locale (AsContext *ctx, xmlNode *node)
  *
  * Returns: The locale of a node, if the node should be considered for inclusion.
  * %NULL if the node should be ignored due to a not-matching locale.
+ * The string is interned in the scratch arena of @ctx and must not be freed.
  */
-gchar *
+const gchar *
 as_xml_get_node_locale_match (AsContext *ctx, xmlNode *node)
 {
-	gchar *lang;
+	g_autofree gchar *lang = NULL;
 
 	lang = (gchar *) xmlGetProp (node, (xmlChar *) "lang");
 
-	if (lang == NULL) {
-		lang = g_strdup ("C");
-		goto out;
-	}
+	if (lang == NULL)
+		return "C";
 
 	if (as_context_get_locale_use_all (ctx)) {
 		/* we should read all languages */
-		goto out;
+		return as_context_scratch_intern (ctx, lang);
 	}
 
-	if (as_utils_locale_is_compatible (as_context_get_locale (ctx), lang)) {
-		goto out;
+	if (as_context_get_locale_strict (ctx)) {
+		/* only accept an exact locale or plain language code match */
+		const gchar *active = as_context_get_locale (ctx);
+		g_autofree gchar *active_lang = as_utils_locale_to_language (active);
+
+		if (g_strcmp0 (lang, active) == 0 || g_strcmp0 (lang, active_lang) == 0)
+			return as_context_scratch_intern (ctx, lang);
+		return NULL;
 	}
 
+	if (as_utils_locale_is_compatible (as_context_get_locale (ctx), lang))
+		return as_context_scratch_intern (ctx, lang);
+
 	/* If we are here, we haven't found a matching locale.
 	 * In that case, we return %NULL to indicate that this element should not be added.
 	 */
-	g_free (g_steal_pointer (&lang));
-
-out:
-	return lang;
+	return NULL;
 }
 
 /**
@@ -288,6 +297,27 @@ as_xml_dump_desc_para_node_content_raw (xmlNode *node)
 	}
 }
 
+/**
+ * as_xml_get_children_count:
+ *
+ * Count the element children of a node, e.g. to presize the container
+ * the parsed children will be stored in.
+ */
+guint
+as_xml_get_children_count (xmlNode *node)
+{
+	guint count = 0;
+
+	for (xmlNode *iter = node->children; iter != NULL; iter = iter->next) {
+		/* discard spaces */
+		if (iter->type != XML_ELEMENT_NODE)
+			continue;
+		count++;
+	}
+
+	return count;
+}
+
 /**
  * as_xml_add_children_values_to_array:
  */
@@ -310,6 +340,33 @@ as_xml_add_children_values_to_array (xmlNode *node, const gchar *element_name, G
 	}
 }
 
+/**
+ * as_xml_add_children_values_to_refstr_array:
+ *
+ * Like %as_xml_add_children_values_to_array, but stores the values as
+ * interned #GRefString, so highly repetitive values (like category names)
+ * are shared between all components in memory.
+ */
+void
+as_xml_add_children_values_to_refstr_array (xmlNode *node,
+					    const gchar *element_name,
+					    GPtrArray *array)
+{
+	xmlNode *iter;
+
+	for (iter = node->children; iter != NULL; iter = iter->next) {
+		/* discard spaces */
+		if (iter->type != XML_ELEMENT_NODE)
+			continue;
+
+		if (g_strcmp0 ((const gchar *) iter->name, element_name) == 0) {
+			g_autofree gchar *content = as_xml_get_node_value (iter);
+			if (content != NULL)
+				g_ptr_array_add (array, g_ref_string_new_intern (content));
+		}
+	}
+}
+
 /**
  * as_xml_get_children_as_string_list:
  */
@@ -318,7 +375,9 @@ as_xml_get_children_as_string_list (xmlNode *node, const gchar *element_name)
 {
 	GPtrArray *list;
 
-	list = g_ptr_array_new_with_free_func (g_free);
+	/* the child count is only an upper bound in case other elements are
+	 * interleaved, but it saves us all reallocations in the common case */
+	list = g_ptr_array_new_full (as_xml_get_children_count (node), g_free);
 	as_xml_add_children_values_to_array (node, element_name, list);
 	return list;
 }
@@ -508,7 +567,7 @@ as_xml_parse_metainfo_description_node (AsContext *ctx, xmlNode *node, GHashTabl
 		tag_id = as_xml_tag_from_string (node_name);
 
 		if (tag_id == AS_TAG_P) {
-			g_autofree gchar *lang = NULL;
+			const gchar *lang = NULL;
 			g_autofree gchar *content = NULL;
 
 			lang = as_xml_get_node_locale_match (ctx, iter);
@@ -543,7 +602,7 @@ as_xml_parse_metainfo_description_node (AsContext *ctx, xmlNode *node, GHashTabl
 			}
 
 			for (iter2 = iter->children; iter2 != NULL; iter2 = iter2->next) {
-				g_autofree gchar *lang = NULL;
+				const gchar *lang = NULL;
 				g_autofree gchar *content = NULL;
 				AsTag iter2_tag_id = as_xml_tag_from_string (
 				    (const gchar *) iter2->name);
@@ -1141,6 +1200,241 @@ as_xml_parse_document (const gchar *data, gssize len, gboolean pedantic, GError
 	return doc;
 }
 
+/**
+ * as_xml_parse_document_from_stream:
+ *
+ * Parse an XML document incrementally from an input stream, using
+ * libxml2's push parser. Chunks are handed to the parser as they are
+ * read (and possibly decompressed by a #GConverterInputStream), so the
+ * document is never assembled in an intermediate memory buffer first.
+ */
+xmlDoc *
+as_xml_parse_document_from_stream (GInputStream *stream, gboolean pedantic, GError **error)
+{
+	xmlParserCtxt *ctxt;
+	xmlDoc *doc;
+	xmlNode *root;
+	gint parser_options;
+	gssize len;
+	const gsize buffer_size = 1024 * 32;
+	g_autofree gchar *buffer = NULL;
+	g_autofree gchar *error_msg_str = NULL;
+	GError *tmp_error = NULL;
+
+	parser_options = XML_PARSE_NOBLANKS | XML_PARSE_NONET | XML_PARSE_BIG_LINES;
+	if (pedantic)
+		parser_options |= XML_PARSE_PEDANTIC;
+
+	as_xml_set_out_of_context_error (&error_msg_str);
+	ctxt = xmlCreatePushParserCtxt (NULL, NULL, NULL, 0, NULL);
+	if (ctxt == NULL) {
+		as_xml_set_out_of_context_error (NULL);
+		g_set_error_literal (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "Unable to create XML push parser context.");
+		return NULL;
+	}
+	xmlCtxtUseOptions (ctxt, parser_options);
+
+	buffer = g_malloc (buffer_size);
+	while ((len = g_input_stream_read (stream, buffer, buffer_size, NULL, &tmp_error)) > 0) {
+		if (xmlParseChunk (ctxt, buffer, len, 0) != 0)
+			break;
+	}
+	if (len < 0) {
+		as_xml_set_out_of_context_error (NULL);
+		xmlFreeDoc (ctxt->myDoc);
+		xmlFreeParserCtxt (ctxt);
+		g_propagate_error (error, tmp_error);
+		return NULL;
+	}
+	xmlParseChunk (ctxt, NULL, 0, 1);
+
+	doc = ctxt->myDoc;
+	if (!ctxt->wellFormed || doc == NULL) {
+		if (error_msg_str == NULL) {
+			g_set_error (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "Could not parse XML data (no details received)");
+		} else {
+			g_set_error (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "Could not parse XML data: %s",
+				     error_msg_str);
+		}
+		as_xml_set_out_of_context_error (NULL);
+		xmlFreeDoc (doc);
+		xmlFreeParserCtxt (ctxt);
+		return NULL;
+	}
+	as_xml_set_out_of_context_error (NULL);
+	xmlFreeParserCtxt (ctxt);
+
+	root = xmlDocGetRootElement (doc);
+	if (root == NULL) {
+		g_set_error_literal (error,
+				     AS_METADATA_ERROR,
+				     AS_METADATA_ERROR_PARSE,
+				     "The XML document is empty.");
+		xmlFreeDoc (doc);
+		return NULL;
+	}
+
+	return doc;
+}
+
+/**
+ * as_xml_serialization_doc_new:
+ *
+ * Create a new XML document to act as a shared serialization context when
+ * building node trees for many components in sequence.
+ * The document carries a string dictionary that is pre-seeded with the
+ * constant tag and attribute names used by AppStream metadata, so libxml2
+ * interns these names instead of duplicating them for every single node.
+ *
+ * Nodes created in this document may be adopted into other documents via
+ * xmlDocSetRootElement(), as long as the adopting document references the
+ * same dictionary first (see as_xml_doc_inherit_dict()).
+ *
+ * Returns: (transfer full): a new #xmlDoc. Free with xmlFreeDoc().
+ */
+xmlDoc *
+as_xml_serialization_doc_new (void)
+{
+	xmlDoc *doc;
+	xmlDictPtr dict;
+
+	/* constant names that appear in almost every serialized component,
+	 * interned up front so not even their first occurrence needs a
+	 * fresh allocation */
+	static const gchar *const common_names[] = {
+		"component",	    "id",	  "name",	  "summary",
+		"description",	    "p",	  "ul",		  "ol",
+		"li",		    "url",	  "type",	  "pkgname",
+		"icon",		    "categories", "category",	  "keywords",
+		"keyword",	    "provides",	  "launchable",	  "releases",
+		"release",	    "version",	  "date",	  "timestamp",
+		"screenshots",	    "screenshot", "image",	  "caption",
+		"width",	    "height",	  "languages",	  "lang",
+		"percentage",	    "bundle",	  "custom",	  "value",
+		"key",		    "xml:lang",	  "priority",	  "mimetypes",
+		"metadata_license", "project_license",		  "project_group",
+		"developer",	    "developer_name",		  "extends",
+		"translation",	    "content_rating",		  "content_attribute",
+		NULL,
+	};
+
+	doc = xmlNewDoc ((xmlChar *) NULL);
+	dict = xmlDictCreate ();
+	for (guint i = 0; common_names[i] != NULL; i++)
+		xmlDictLookup (dict, (xmlChar *) common_names[i], -1);
+	doc->dict = dict;
+
+	return doc;
+}
+
+/**
+ * as_xml_doc_inherit_dict:
+ * @doc: the document that will adopt @node.
+ * @node: an XML node, possibly owned by a dictionary-backed document.
+ *
+ * Make @doc reference the string dictionary of the document that @node
+ * currently belongs to, if there is one.
+ * This must be called before adopting @node into @doc, so that any
+ * dictionary-interned names in the node tree stay valid for the whole
+ * lifetime of @doc.
+ */
+void
+as_xml_doc_inherit_dict (xmlDoc *doc, xmlNode *node)
+{
+	if (node == NULL || node->doc == NULL || node->doc->dict == NULL)
+		return;
+	if (doc->dict == node->doc->dict)
+		return;
+
+	if (doc->dict != NULL)
+		xmlDictFree (doc->dict);
+	xmlDictReference (node->doc->dict);
+	doc->dict = node->doc->dict;
+}
+
+/**
+ * as_xml_escape_content_cb:
+ *
+ * Fast content escaper for XML serialization. The stock libxml2 escaper
+ * walks the text character by character, validating UTF-8 as it goes, which
+ * shows up prominently when serializing megabytes of mostly-clean
+ * description text. We scan ahead for the next character that actually
+ * needs escaping in a tight loop the compiler can vectorize, and bulk-copy
+ * the clean spans in between. The input must be valid UTF-8, which holds
+ * for all text we place in our own documents.
+ */
+static int
+as_xml_escape_content_cb (unsigned char *out, int *outlen, const unsigned char *in, int *inlen)
+{
+	const unsigned char *in_end = in + *inlen;
+	const unsigned char *cur = in;
+	unsigned char *out_start = out;
+	unsigned char *out_end = out + *outlen;
+
+	while (cur < in_end) {
+		const unsigned char *span = cur;
+		const gchar *entity;
+		gsize entity_len;
+		gsize span_len;
+
+		/* scan over the clean span */
+		while (span < in_end) {
+			const unsigned char c = *span;
+			if (c == '<' || c == '>' || c == '&' || c == '\r')
+				break;
+			span++;
+		}
+
+		span_len = (gsize) (span - cur);
+		if ((gsize) (out_end - out) < span_len)
+			break;
+		memcpy (out, cur, span_len);
+		out += span_len;
+		cur = span;
+
+		if (cur >= in_end)
+			break;
+
+		switch (*cur) {
+		case '<':
+			entity = "&lt;";
+			entity_len = 4;
+			break;
+		case '>':
+			entity = "&gt;";
+			entity_len = 4;
+			break;
+		case '&':
+			entity = "&amp;";
+			entity_len = 5;
+			break;
+		default:
+			entity = "&#13;";
+			entity_len = 5;
+			break;
+		}
+
+		if ((gsize) (out_end - out) < entity_len)
+			break;
+		memcpy (out, entity, entity_len);
+		out += entity_len;
+		cur++;
+	}
+
+	*outlen = (int) (out - out_start);
+	*inlen = (int) (cur - in);
+	return 0;
+}
+
 /**
  * as_xml_node_free_to_str:
  * @root: The document root node.
@@ -1155,6 +1449,8 @@ gchar *
 as_xml_node_free_to_str (xmlNode *root, GError **error)
 {
 	xmlDoc *doc;
+	xmlBuffer *buf;
+	xmlSaveCtxt *sctx;
 	gchar *xmlstr = NULL;
 	g_autofree gchar *error_msg_str = NULL;
 
@@ -1163,8 +1459,21 @@ as_xml_node_free_to_str (xmlNode *root, GError **error)
 	if (root == NULL)
 		goto out;
 
+	as_xml_doc_inherit_dict (doc, root);
 	xmlDocSetRootElement (doc, root);
-	xmlDocDumpFormatMemoryEnc (doc, (xmlChar **) (&xmlstr), NULL, "utf-8", TRUE);
+
+	buf = xmlBufferCreate ();
+	sctx = xmlSaveToBuffer (buf, "utf-8", XML_SAVE_FORMAT);
+	if (sctx == NULL) {
+		xmlBufferFree (buf);
+		goto out;
+	}
+	/* use our fast span-based escaper instead of the per-character default */
+	xmlSaveSetEscape (sctx, as_xml_escape_content_cb);
+	xmlSaveDoc (sctx, doc);
+	xmlSaveClose (sctx);
+	xmlstr = (gchar *) xmlBufferDetach (buf);
+	xmlBufferFree (buf);
 
 	if (error_msg_str != NULL) {
 		if (error == NULL) {
@@ -25,6 +25,7 @@
 #ifndef __AS_XML_H
 #define __AS_XML_H
 
+#include <gio/gio.h>
 #include <libxml/tree.h>
 #include <libxml/parser.h>
 #include <libxml/xmlsave.h>
@@ -43,12 +44,16 @@ GRefString	      *as_xml_get_node_value_refstr (const xmlNode *node);
 GRefString *as_xml_get_prop_value_refstr (const xmlNode *node, const gchar *prop_name);
 gint	    as_xml_get_prop_value_as_int (const xmlNode *node, const gchar *prop_name);
 
-gchar	   *as_xml_get_node_locale (AsContext *ctx, xmlNode *node);
-gchar	   *as_xml_get_node_locale_match (AsContext *ctx, xmlNode *node);
+const gchar *as_xml_get_node_locale (AsContext *ctx, xmlNode *node);
+const gchar *as_xml_get_node_locale_match (AsContext *ctx, xmlNode *node);
 
+guint	    as_xml_get_children_count (xmlNode *node);
 void	    as_xml_add_children_values_to_array (xmlNode     *node,
 						 const gchar *element_name,
 						 GPtrArray   *array);
+void	    as_xml_add_children_values_to_refstr_array (xmlNode	    *node,
+							const gchar *element_name,
+							GPtrArray   *array);
 
 GPtrArray  *as_xml_get_children_as_string_list (xmlNode *node, const gchar *element_name);
 gchar	  **as_xml_get_children_as_strv (xmlNode *node, const gchar *element_name);
@@ -89,6 +94,10 @@ xmlAttr *as_xml_add_text_prop (xmlNode *node, const gchar *name, const gchar *va
 xmlAttr *as_xml_add_uint_prop (xmlNode *node, const gchar *name, guint64 value);
 
 xmlDoc	*as_xml_parse_document (const gchar *data, gssize len, gboolean pedantic, GError **error);
+xmlDoc	*as_xml_parse_document_from_stream (GInputStream *stream, gboolean pedantic, GError **error);
+
+xmlDoc	*as_xml_serialization_doc_new (void);
+void	 as_xml_doc_inherit_dict (xmlDoc *doc, xmlNode *node);
 
 gchar	*as_xml_node_free_to_str (xmlNode *root, GError **error);
 
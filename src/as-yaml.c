@@ -53,10 +53,13 @@ as_str_is_numeric (const gchar *s)
 /**
  * as_yaml_parse_layer:
  *
- * Create GNode tree from DEP-11 YAML document
+ * Create GNode tree from DEP-11 YAML document.
+ * All node data is allocated from @strchunk, so the whole tree can be
+ * released by destroying the root node and freeing the string chunk,
+ * without an additional traversal to free the individual scalar values.
  */
 void
-as_yaml_parse_layer (yaml_parser_t *parser, GNode *data, GError **error)
+as_yaml_parse_layer (yaml_parser_t *parser, GNode *data, GStringChunk *strchunk, GError **error)
 {
 	GNode *last_leaf = data;
 	GNode *last_scalar;
@@ -81,7 +84,8 @@ as_yaml_parse_layer (yaml_parser_t *parser, GNode *data, GError **error)
 		 * or as a leaf value (one of them, in case it's a sequence) */
 		switch (event.type) {
 		case YAML_SCALAR_EVENT:
-			string_scalar = g_strdup ((gchar *) event.data.scalar.value);
+			string_scalar = g_string_chunk_insert (strchunk,
+							       (gchar *) event.data.scalar.value);
 			g_strstrip (string_scalar);
 			if (storage)
 				g_node_append_data (last_leaf, string_scalar);
@@ -103,7 +107,7 @@ as_yaml_parse_layer (yaml_parser_t *parser, GNode *data, GError **error)
 			if (in_sequence)
 				last_leaf = g_node_append (last_leaf, g_node_new (NULL));
 
-			as_yaml_parse_layer (parser, last_leaf, &tmp_error);
+			as_yaml_parse_layer (parser, last_leaf, strchunk, &tmp_error);
 			if (tmp_error != NULL) {
 				g_propagate_error (error, tmp_error);
 				parse = FALSE;
@@ -126,18 +130,6 @@ as_yaml_parse_layer (yaml_parser_t *parser, GNode *data, GError **error)
 	}
 }
 
-/**
- * as_yaml_free_node:
- */
-gboolean
-as_yaml_free_node (GNode *node, gpointer data)
-{
-	if (node->data != NULL)
-		g_free (node->data);
-
-	return FALSE;
-}
-
 /**
  * as_yaml_node_get_key:
  *
@@ -300,9 +292,11 @@ as_yaml_emit_scalar_uint64 (yaml_emitter_t *emitter, guint64 value)
 {
 	gint ret;
 	yaml_event_t event;
-	g_autofree gchar *value_str = NULL;
+	gchar value_str[24];
 
-	value_str = g_strdup_printf ("%" G_GUINT64_FORMAT, value);
+	/* format on the stack - this runs for every numeric scalar of every
+	 * component in a catalog write, so avoid a heap allocation per value */
+	g_snprintf (value_str, sizeof (value_str), "%" G_GUINT64_FORMAT, value);
 	yaml_scalar_event_initialize (&event,
 				      NULL,
 				      NULL,
@@ -374,23 +368,8 @@ as_yaml_emit_entry_uint64 (yaml_emitter_t *emitter, const gchar *key, guint64 va
 void
 as_yaml_emit_entry_timestamp (yaml_emitter_t *emitter, const gchar *key, guint64 unixtime)
 {
-	g_autofree gchar *time_str = NULL;
-	yaml_event_t event;
-	gint ret;
-
 	as_yaml_emit_scalar_key (emitter, key);
-
-	time_str = g_strdup_printf ("%" G_GUINT64_FORMAT, unixtime);
-	yaml_scalar_event_initialize (&event,
-				      NULL,
-				      NULL,
-				      (yaml_char_t *) time_str,
-				      -1,
-				      TRUE,
-				      TRUE,
-				      YAML_ANY_SCALAR_STYLE);
-	ret = yaml_emitter_emit (emitter, &event);
-	g_assert (ret);
+	as_yaml_emit_scalar_uint64 (emitter, unixtime);
 }
 
 /**
@@ -488,6 +467,16 @@ as_yaml_get_node_locale (AsContext *ctx, GNode *node)
 		return key;
 	}
 
+	if (as_context_get_locale_strict (ctx)) {
+		/* only accept an exact locale or plain language code match */
+		const gchar *active = as_context_get_locale (ctx);
+		g_autofree gchar *active_lang = as_utils_locale_to_language (active);
+
+		if (g_strcmp0 (key, active) == 0 || g_strcmp0 (key, active_lang) == 0)
+			return key;
+		return NULL;
+	}
+
 	if (as_utils_locale_is_compatible (as_context_get_locale (ctx), key)) {
 		return key;
 	} else {
@@ -610,6 +599,23 @@ as_yaml_list_to_str_array (GNode *node, GPtrArray *array)
 	}
 }
 
+/**
+ * as_yaml_list_to_refstr_array:
+ *
+ * Like %as_yaml_list_to_str_array, but stores the values as interned
+ * #GRefString, so highly repetitive values are shared between all
+ * components in memory.
+ */
+void
+as_yaml_list_to_refstr_array (GNode *node, GPtrArray *array)
+{
+	for (GNode *n = node->children; n != NULL; n = n->next) {
+		const gchar *val = as_yaml_node_get_key (n);
+		if (val != NULL)
+			g_ptr_array_add (array, g_ref_string_new_intern (val));
+	}
+}
+
 /**
  * as_yaml_emit_sequence_from_str_array:
  */
@@ -33,9 +33,10 @@
 G_BEGIN_DECLS
 #pragma GCC visibility push(hidden)
 
-void		       as_yaml_parse_layer (yaml_parser_t *parser, GNode *data, GError **error);
-
-gboolean	       as_yaml_free_node (GNode *node, gpointer data);
+void		       as_yaml_parse_layer (yaml_parser_t *parser,
+					    GNode	  *data,
+					    GStringChunk  *strchunk,
+					    GError	 **error);
 
 const gchar	      *as_yaml_node_get_key (GNode *n);
 const gchar	      *as_yaml_node_get_value (GNode *n);
@@ -82,6 +83,7 @@ void as_yaml_emit_long_localized_entry (yaml_emitter_t *emitter,
 					GHashTable     *ltab);
 
 void as_yaml_list_to_str_array (GNode *node, GPtrArray *array);
+void as_yaml_list_to_refstr_array (GNode *node, GPtrArray *array);
 
 #pragma GCC visibility pop
 G_END_DECLS
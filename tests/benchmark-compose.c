@@ -0,0 +1,171 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2012-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark harness for libappstream-compose, run via the "benchmark"
+ * Meson target.
+ *
+ * Measures a full asc_compose_run() over a synthetic directory unit with
+ * many metainfo files, with network access, validation and icon handling
+ * disabled so only the compose machinery itself is timed. Results are
+ * emitted as JSON so they can be trended over time in CI.
+ *
+ * Environment:
+ *   AS_BENCHMARK_SCALE    Number of synthetic components (default: 1000)
+ *   AS_BENCHMARK_RESULTS  File to write the JSON report to (default: stdout only)
+ */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <glib/gstdio.h>
+
+#include "appstream-compose.h"
+#include "as-utils-private.h"
+
+/**
+ * asc_bench_generate_unit:
+ *
+ * Create a synthetic directory unit with @scale metainfo files below
+ * usr/share/metainfo, as an OS root for compose to process.
+ */
+static void
+asc_bench_generate_unit (const gchar *root_dir, guint scale)
+{
+	g_autofree gchar *mi_dir = g_build_filename (root_dir,
+						     "usr",
+						     "share",
+						     "metainfo",
+						     NULL);
+
+	g_mkdir_with_parents (mi_dir, 0755);
+	for (guint i = 0; i < scale; i++) {
+		g_autofree gchar *fname = NULL;
+		g_autofree gchar *xml = NULL;
+		g_autoptr(GError) error = NULL;
+
+		xml = g_strdup_printf (
+		    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		    "<component>\n"
+		    "  <id>org.example.benchmark.item%06u</id>\n"
+		    "  <name>Benchmark Item %u</name>\n"
+		    "  <summary>Synthetic component for compose benchmarking</summary>\n"
+		    "  <metadata_license>FSFAP</metadata_license>\n"
+		    "  <project_license>FSFAP</project_license>\n"
+		    "  <description>\n"
+		    "    <p>This component only exists to measure the throughput "
+		    "of the compose machinery itself.</p>\n"
+		    "  </description>\n"
+		    "</component>\n",
+		    i,
+		    i);
+
+		fname = g_strdup_printf ("%s/org.example.benchmark.item%06u.metainfo.xml",
+					 mi_dir,
+					 i);
+		if (!g_file_set_contents (fname, xml, -1, &error))
+			g_error ("Unable to write metainfo file: %s", error->message);
+	}
+}
+
+/**
+ * main:
+ */
+int
+main (int argc, char **argv)
+{
+	g_autoptr(GTimer) timer = g_timer_new ();
+	g_autoptr(GString) report = g_string_new (NULL);
+	g_autofree gchar *scratch_dir = NULL;
+	g_autofree gchar *unit_dir = NULL;
+	g_autoptr(GError) error = NULL;
+	const gchar *results_fname;
+	gdouble total_ms = 0;
+	gdouble min_ms = 0;
+	guint scale = 1000;
+	const guint loops = 3;
+
+	if (g_getenv ("AS_BENCHMARK_SCALE") != NULL)
+		scale = (guint) g_ascii_strtoull (g_getenv ("AS_BENCHMARK_SCALE"), NULL, 10);
+	if (scale == 0)
+		g_error ("Invalid benchmark scale set.");
+
+	scratch_dir = g_dir_make_tmp ("asc-benchmark-XXXXXX", &error);
+	if (scratch_dir == NULL)
+		g_error ("Unable to create scratch directory: %s", error->message);
+	unit_dir = g_build_filename (scratch_dir, "root", NULL);
+
+	g_printerr ("Generating synthetic unit with %u metainfo files...\n", scale);
+	asc_bench_generate_unit (unit_dir, scale);
+
+	for (guint i = 0; i < loops; i++) {
+		g_autoptr(AscCompose) compose = asc_compose_new ();
+		g_autoptr(AscDirectoryUnit) dirunit = asc_directory_unit_new (unit_dir);
+		g_autofree gchar *result_dir = NULL;
+		GPtrArray *results;
+		gdouble elapsed_ms;
+
+		result_dir = g_strdup_printf ("%s/export-%u", scratch_dir, i);
+		asc_compose_set_origin (compose, "benchmark");
+		asc_compose_set_data_result_dir (compose, result_dir);
+		asc_compose_remove_flags (compose,
+					  ASC_COMPOSE_FLAG_ALLOW_NET | ASC_COMPOSE_FLAG_VALIDATE);
+		asc_compose_add_flags (compose, ASC_COMPOSE_FLAG_IGNORE_ICONS);
+
+		asc_unit_set_bundle_id (ASC_UNIT (dirunit), "benchmark");
+		asc_compose_add_unit (compose, ASC_UNIT (dirunit));
+
+		g_timer_reset (timer);
+		results = asc_compose_run (compose, NULL, &error);
+		elapsed_ms = g_timer_elapsed (timer, NULL) * 1000;
+		if (results == NULL)
+			g_error ("Compose run failed: %s", error->message);
+
+		total_ms += elapsed_ms;
+		if (i == 0 || elapsed_ms < min_ms)
+			min_ms = elapsed_ms;
+	}
+
+	g_string_append_printf (report,
+				"{\n  \"suite\": \"appstream-compose\",\n"
+				"  \"version\": \"%s\",\n"
+				"  \"scale\": %u,\n  \"results\": [\n"
+				"    {\"name\": \"compose-run\", \"iterations\": %u, "
+				"\"mean_ms\": %.4f, \"min_ms\": %.4f}\n  ]\n}\n",
+				as_version_string (),
+				scale,
+				loops,
+				total_ms / loops,
+				min_ms);
+	g_print ("%s", report->str);
+	g_printerr ("  %-24s %10.2f ms (best of %u: %.2f ms)\n",
+		    "compose-run",
+		    total_ms / loops,
+		    loops,
+		    min_ms);
+
+	results_fname = g_getenv ("AS_BENCHMARK_RESULTS");
+	if (results_fname != NULL) {
+		if (!g_file_set_contents (results_fname, report->str, report->len, &error))
+			g_error ("Unable to write results file: %s", error->message);
+	}
+
+	as_utils_delete_dir_recursive (scratch_dir);
+	return 0;
+}
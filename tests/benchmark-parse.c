@@ -0,0 +1,375 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2012-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Metainfo parse microbenchmark, run via the "benchmark" Meson target.
+ *
+ * Real-world metainfo files occasionally take orders of magnitude longer
+ * than the median to parse, usually due to pathologically large single
+ * constructs (huge description lists, thousands of releases, ...).
+ * This harness runs as_metadata_parse_data() over a corpus of documents,
+ * one per construct type, generated at a reproducible scale from the
+ * sample metainfo data, and reports p50/p99 parse latency per construct
+ * so parse-path regressions show up before release.
+ *
+ * Environment:
+ *   AS_BENCHMARK_PARSE_SCALE  Element count of the pathological constructs (default: 2000)
+ *   AS_BENCHMARK_PARSE_LOOPS  Parse iterations per construct (default: 50)
+ *   AS_BENCHMARK_RESULTS      File to write the JSON report to (default: stdout only)
+ */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "appstream.h"
+
+static gchar *datadir = NULL;
+
+/**
+ * as_bench_doc_new:
+ *
+ * Start a new synthetic metainfo document with the usual boilerplate.
+ */
+static GString *
+as_bench_doc_new (const gchar *cid)
+{
+	GString *xml = g_string_sized_new (64 * 1024);
+	g_string_append (xml, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	g_string_append (xml, "<component type=\"desktop-application\">\n");
+	g_string_append_printf (xml, "  <id>%s</id>\n", cid);
+	g_string_append (xml, "  <metadata_license>FSFAP</metadata_license>\n");
+	g_string_append (xml, "  <name>Benchmark</name>\n");
+	g_string_append (xml, "  <summary>A synthetic parse benchmark component</summary>\n");
+	return xml;
+}
+
+static gchar *
+as_bench_doc_finish (GString *xml)
+{
+	g_string_append (xml, "</component>\n");
+	return g_string_free (xml, FALSE);
+}
+
+/**
+ * as_bench_make_description_list:
+ *
+ * A description consisting of one enumeration with @scale items, the
+ * construct most commonly seen in pathologically slow real-world files.
+ */
+static gchar *
+as_bench_make_description_list (guint scale)
+{
+	GString *xml = as_bench_doc_new ("org.example.benchmark.desc_list");
+
+	g_string_append (xml, "  <description>\n    <p>A very enumerative description.</p>\n");
+	g_string_append (xml, "    <ul>\n");
+	for (guint i = 0; i < scale; i++)
+		g_string_append_printf (xml,
+					"      <li>Item %06u of an excessively long list</li>\n",
+					i);
+	g_string_append (xml, "    </ul>\n  </description>\n");
+
+	return as_bench_doc_finish (xml);
+}
+
+/**
+ * as_bench_make_description_paragraphs:
+ *
+ * A description made of @scale individual paragraphs.
+ */
+static gchar *
+as_bench_make_description_paragraphs (guint scale)
+{
+	GString *xml = as_bench_doc_new ("org.example.benchmark.desc_paragraphs");
+
+	g_string_append (xml, "  <description>\n");
+	for (guint i = 0; i < scale; i++)
+		g_string_append_printf (
+		    xml,
+		    "    <p>Paragraph %06u, repeating itself in slight variation.</p>\n",
+		    i);
+	g_string_append (xml, "  </description>\n");
+
+	return as_bench_doc_finish (xml);
+}
+
+/**
+ * as_bench_make_releases:
+ *
+ * @scale release entries, each with a short description.
+ */
+static gchar *
+as_bench_make_releases (guint scale)
+{
+	GString *xml = as_bench_doc_new ("org.example.benchmark.releases");
+
+	g_string_append (xml, "  <releases>\n");
+	for (guint i = scale; i > 0; i--) {
+		g_string_append_printf (xml,
+					"    <release version=\"1.%u\" date=\"2024-01-01\">\n"
+					"      <description><p>Bugfix release %u.</p></description>\n"
+					"    </release>\n",
+					i,
+					i);
+	}
+	g_string_append (xml, "  </releases>\n");
+
+	return as_bench_doc_finish (xml);
+}
+
+/**
+ * as_bench_make_screenshots:
+ *
+ * @scale screenshots with captions and multiple image sizes each.
+ */
+static gchar *
+as_bench_make_screenshots (guint scale)
+{
+	GString *xml = as_bench_doc_new ("org.example.benchmark.screenshots");
+
+	g_string_append (xml, "  <screenshots>\n");
+	for (guint i = 0; i < scale; i++) {
+		g_string_append_printf (
+		    xml,
+		    "    <screenshot%s>\n"
+		    "      <caption>View number %u</caption>\n"
+		    "      <image type=\"source\" width=\"1600\" height=\"900\">"
+		    "https://example.org/shots/%u/main.png</image>\n"
+		    "      <image type=\"thumbnail\" width=\"624\" height=\"351\">"
+		    "https://example.org/shots/%u/thumb.png</image>\n"
+		    "    </screenshot>\n",
+		    i == 0 ? " type=\"default\"" : "",
+		    i,
+		    i,
+		    i);
+	}
+	g_string_append (xml, "  </screenshots>\n");
+
+	return as_bench_doc_finish (xml);
+}
+
+/**
+ * as_bench_make_provides:
+ *
+ * One provides block with @scale mediatype items.
+ */
+static gchar *
+as_bench_make_provides (guint scale)
+{
+	GString *xml = as_bench_doc_new ("org.example.benchmark.provides");
+
+	g_string_append (xml, "  <provides>\n");
+	for (guint i = 0; i < scale; i++)
+		g_string_append_printf (xml,
+					"    <mediatype>application/x-benchmark-%06u</mediatype>\n",
+					i);
+	g_string_append (xml, "  </provides>\n");
+
+	return as_bench_doc_finish (xml);
+}
+
+/**
+ * as_bench_make_translated_text:
+ *
+ * Name, summary and keywords repeated for many locales, exercising the
+ * locale matching on every localized node.
+ */
+static gchar *
+as_bench_make_translated_text (guint scale)
+{
+	GString *xml = as_bench_doc_new ("org.example.benchmark.l10n");
+
+	for (guint i = 0; i < scale; i++) {
+		g_string_append_printf (xml,
+					"  <name xml:lang=\"x-bench-%03u\">Benchmark %03u</name>\n",
+					i,
+					i);
+		g_string_append_printf (
+		    xml,
+		    "  <summary xml:lang=\"x-bench-%03u\">Translated summary %03u</summary>\n",
+		    i,
+		    i);
+	}
+
+	return as_bench_doc_finish (xml);
+}
+
+/**
+ * as_bench_load_sample_metainfo:
+ *
+ * The unmodified sample metainfo file, serving as the median baseline.
+ */
+static gchar *
+as_bench_load_sample_metainfo (void)
+{
+	g_autofree gchar *fname = NULL;
+	g_autoptr(GError) error = NULL;
+	gchar *contents = NULL;
+
+	fname = g_build_filename (datadir, "appdata.xml", NULL);
+	if (!g_file_get_contents (fname, &contents, NULL, &error))
+		g_error ("Unable to read sample metainfo file: %s", error->message);
+	return contents;
+}
+
+static gint
+as_bench_cmp_double (gconstpointer a, gconstpointer b)
+{
+	gdouble d = *(const gdouble *) a - *(const gdouble *) b;
+	return d < 0 ? -1 : (d > 0 ? 1 : 0);
+}
+
+/**
+ * as_bench_percentile:
+ *
+ * Nearest-rank percentile of an already sorted sample array.
+ */
+static gdouble
+as_bench_percentile (GArray *sorted_ms, gdouble percentile)
+{
+	guint idx = (guint) ((sorted_ms->len - 1) * percentile / 100.0 + 0.5);
+	return g_array_index (sorted_ms, gdouble, idx);
+}
+
+/**
+ * as_bench_parse_construct:
+ *
+ * Parse one corpus document repeatedly and append its latency
+ * distribution to the JSON report.
+ */
+static void
+as_bench_parse_construct (GString *json, const gchar *name, const gchar *data, guint loops)
+{
+	g_autoptr(GTimer) timer = g_timer_new ();
+	g_autoptr(GArray) samples = g_array_sized_new (FALSE, FALSE, sizeof (gdouble), loops);
+
+	for (guint i = 0; i < loops; i++) {
+		g_autoptr(AsMetadata) metad = as_metadata_new ();
+		g_autoptr(GError) error = NULL;
+		gdouble elapsed_ms;
+
+		as_metadata_set_locale (metad, "C");
+
+		g_timer_reset (timer);
+		as_metadata_parse_data (metad, data, -1, AS_FORMAT_KIND_XML, &error);
+		elapsed_ms = g_timer_elapsed (timer, NULL) * 1000;
+		if (error != NULL)
+			g_error ("Parsing construct '%s' failed: %s", name, error->message);
+
+		g_array_append_val (samples, elapsed_ms);
+	}
+	g_array_sort (samples, as_bench_cmp_double);
+
+	if (json->len > 0)
+		g_string_append (json, ",\n");
+	g_string_append_printf (json,
+				"    {\"name\": \"parse[%s]\", \"iterations\": %u, "
+				"\"p50_ms\": %.4f, \"p99_ms\": %.4f, \"min_ms\": %.4f}",
+				name,
+				loops,
+				as_bench_percentile (samples, 50),
+				as_bench_percentile (samples, 99),
+				g_array_index (samples, gdouble, 0));
+	g_printerr ("  %-28s p50: %8.3f ms   p99: %8.3f ms   (%u runs)\n",
+		    name,
+		    as_bench_percentile (samples, 50),
+		    as_bench_percentile (samples, 99),
+		    loops);
+}
+
+/**
+ * main:
+ */
+int
+main (int argc, char **argv)
+{
+	g_autoptr(GString) json = g_string_new (NULL);
+	g_autoptr(GString) report = g_string_new (NULL);
+	g_autoptr(GError) error = NULL;
+	const gchar *results_fname;
+	guint scale = 2000;
+	guint loops = 50;
+	struct {
+		const gchar *name;
+		gchar *data;
+	} corpus[8];
+	guint n_docs = 0;
+
+	if (argc <= 1)
+		g_error ("No test directory specified!");
+	datadir = g_build_filename (argv[1], "samples", NULL);
+	if (!g_file_test (datadir, G_FILE_TEST_EXISTS))
+		g_error ("Sample data directory %s does not exist.", datadir);
+
+	if (g_getenv ("AS_BENCHMARK_PARSE_SCALE") != NULL)
+		scale = (guint) g_ascii_strtoull (g_getenv ("AS_BENCHMARK_PARSE_SCALE"),
+						  NULL,
+						  10);
+	if (g_getenv ("AS_BENCHMARK_PARSE_LOOPS") != NULL)
+		loops = (guint) g_ascii_strtoull (g_getenv ("AS_BENCHMARK_PARSE_LOOPS"),
+						  NULL,
+						  10);
+	if (scale == 0 || loops == 0)
+		g_error ("Invalid benchmark scale or iteration count set.");
+
+	corpus[n_docs].name = "baseline-sample";
+	corpus[n_docs++].data = as_bench_load_sample_metainfo ();
+	corpus[n_docs].name = "description-list";
+	corpus[n_docs++].data = as_bench_make_description_list (scale);
+	corpus[n_docs].name = "description-paragraphs";
+	corpus[n_docs++].data = as_bench_make_description_paragraphs (scale);
+	corpus[n_docs].name = "releases";
+	corpus[n_docs++].data = as_bench_make_releases (scale);
+	corpus[n_docs].name = "screenshots";
+	corpus[n_docs++].data = as_bench_make_screenshots (scale / 4 + 1);
+	corpus[n_docs].name = "provides-items";
+	corpus[n_docs++].data = as_bench_make_provides (scale);
+	corpus[n_docs].name = "translated-text";
+	corpus[n_docs++].data = as_bench_make_translated_text (scale / 10 + 1);
+
+	g_printerr ("Parsing corpus of %u constructs, scale %u, %u runs each...\n",
+		    n_docs,
+		    scale,
+		    loops);
+	for (guint i = 0; i < n_docs; i++)
+		as_bench_parse_construct (json, corpus[i].name, corpus[i].data, loops);
+
+	g_string_append_printf (report,
+				"{\n  \"suite\": \"appstream-parse\",\n"
+				"  \"version\": \"%s\",\n"
+				"  \"scale\": %u,\n  \"results\": [\n%s\n  ]\n}\n",
+				as_version_string (),
+				scale,
+				json->str);
+	g_print ("%s", report->str);
+
+	results_fname = g_getenv ("AS_BENCHMARK_RESULTS");
+	if (results_fname != NULL) {
+		if (!g_file_set_contents (results_fname, report->str, report->len, &error))
+			g_error ("Unable to write results file: %s", error->message);
+	}
+
+	for (guint i = 0; i < n_docs; i++)
+		g_free (corpus[i].data);
+	g_free (datadir);
+	return 0;
+}
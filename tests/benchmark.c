@@ -0,0 +1,391 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2012-2024 Matthias Klumpp <matthias@tenstral.net>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark harness for libappstream, run via the "benchmark" Meson target.
+ *
+ * Unlike the performance unit test, this program works on a synthetic
+ * catalog generated from the sample data, so its scale is reproducible
+ * and independent of the (small) test fixtures. Results are emitted as
+ * JSON so they can be trended over time in CI.
+ *
+ * Environment:
+ *   AS_BENCHMARK_SCALE    Number of synthetic components (default: 10000)
+ *   AS_BENCHMARK_RESULTS  File to write the JSON report to (default: stdout only)
+ */
+
+#include <glib.h>
+#include <glib/gprintf.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include "appstream.h"
+#include "as-utils-private.h"
+#include "as-pool-private.h"
+#include "as-cache.h"
+
+static gchar *datadir = NULL;
+
+/**
+ * as_bench_load_template_chunks:
+ *
+ * Extract the raw `<component/>` XML chunks from the sample catalog, which
+ * serve as templates for the synthetic catalog.
+ */
+static GPtrArray *
+as_bench_load_template_chunks (void)
+{
+	g_autoptr(GPtrArray) chunks = g_ptr_array_new_with_free_func (g_free);
+	g_autofree gchar *fname = NULL;
+	g_autofree gchar *contents = NULL;
+	g_autoptr(GError) error = NULL;
+	const gchar *pos;
+
+	fname = g_build_filename (datadir, "catalog", "xml", "foobar-1.xml", NULL);
+	if (!g_file_get_contents (fname, &contents, NULL, &error))
+		g_error ("Unable to read template catalog: %s", error->message);
+
+	pos = contents;
+	while (TRUE) {
+		const gchar *start = strstr (pos, "<component");
+		const gchar *end;
+
+		if (start == NULL)
+			break;
+		end = strstr (start, "</component>");
+		if (end == NULL)
+			break;
+		end += strlen ("</component>");
+		g_ptr_array_add (chunks, g_strndup (start, end - start));
+		pos = end;
+	}
+
+	if (chunks->len == 0)
+		g_error ("No component templates found in %s", fname);
+
+	return g_steal_pointer (&chunks);
+}
+
+/**
+ * as_bench_generate_catalog:
+ *
+ * Write a synthetic catalog XML file with @scale components, cycling
+ * through the template chunks and giving every copy a unique ID.
+ */
+static void
+as_bench_generate_catalog (const gchar *xml_dir, GPtrArray *chunks, guint scale)
+{
+	g_autoptr(GString) xml = g_string_sized_new (scale * 1024);
+	g_autofree gchar *fname = NULL;
+	g_autoptr(GError) error = NULL;
+
+	g_string_append (xml,
+			 "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+			 "<components version=\"0.16\" origin=\"benchmark\">\n");
+	for (guint i = 0; i < scale; i++) {
+		const gchar *chunk = g_ptr_array_index (chunks, i % chunks->len);
+		const gchar *id_start = strstr (chunk, "<id>");
+		const gchar *id_end = id_start == NULL ? NULL : strstr (id_start, "</id>");
+
+		if (id_end == NULL)
+			g_error ("Component template without ID encountered.");
+		id_start += strlen ("<id>");
+
+		g_string_append_len (xml, chunk, id_start - chunk);
+		g_string_append_printf (xml, "org.example.benchmark.item%06u", i);
+		g_string_append (xml, id_end);
+		g_string_append_c (xml, '\n');
+	}
+	g_string_append (xml, "</components>\n");
+
+	fname = g_build_filename (xml_dir, "benchmark.xml", NULL);
+	if (!g_file_set_contents (fname, xml->str, xml->len, &error))
+		g_error ("Unable to write synthetic catalog: %s", error->message);
+}
+
+/**
+ * as_bench_new_pool:
+ *
+ * Create a pool which reads only the synthetic catalog and keeps its
+ * cache in the benchmark's private scratch directory.
+ */
+static AsPool *
+as_bench_new_pool (const gchar *catalog_dir, const gchar *cache_dir)
+{
+	AsPool *pool;
+	AsPoolFlags flags;
+
+	pool = as_pool_new ();
+	as_pool_set_locale (pool, "C");
+
+	flags = as_pool_get_flags (pool);
+	as_flags_remove (flags, AS_POOL_FLAG_LOAD_OS_CATALOG);
+	as_flags_remove (flags, AS_POOL_FLAG_LOAD_OS_DESKTOP_FILES);
+	as_flags_remove (flags, AS_POOL_FLAG_LOAD_OS_METAINFO);
+	as_flags_remove (flags, AS_POOL_FLAG_LOAD_FLATPAK);
+	as_flags_add (flags, AS_POOL_FLAG_IGNORE_CACHE_AGE);
+	as_pool_set_flags (pool, flags);
+
+	as_pool_add_extra_data_location (pool, catalog_dir, AS_FORMAT_STYLE_CATALOG);
+	as_pool_override_cache_locations (pool, cache_dir, NULL);
+
+	return pool;
+}
+
+/**
+ * as_bench_report:
+ *
+ * Append one timing series to the JSON report.
+ */
+static void
+as_bench_report (GString *json,
+		 const gchar *name,
+		 guint iterations,
+		 gdouble total_ms,
+		 gdouble min_ms)
+{
+	if (json->len > 0)
+		g_string_append (json, ",\n");
+	g_string_append_printf (json,
+				"    {\"name\": \"%s\", \"iterations\": %u, "
+				"\"mean_ms\": %.4f, \"min_ms\": %.4f}",
+				name,
+				iterations,
+				total_ms / iterations,
+				min_ms);
+	g_printerr ("  %-24s %10.2f ms (best of %u: %.2f ms)\n",
+		    name,
+		    total_ms / iterations,
+		    iterations,
+		    min_ms);
+}
+
+/**
+ * as_bench_pool_load:
+ *
+ * Measure as_pool_load() with a cold cache (every iteration recompiles the
+ * cache from XML) and with a warm cache.
+ */
+static void
+as_bench_pool_load (GString *json, const gchar *catalog_dir, const gchar *cache_dir, guint scale)
+{
+	g_autoptr(GTimer) timer = g_timer_new ();
+	gdouble total_ms = 0;
+	gdouble min_ms = 0;
+	const guint cold_loops = 3;
+	const guint warm_loops = 5;
+
+	for (guint i = 0; i < cold_loops; i++) {
+		g_autoptr(AsPool) pool = NULL;
+		g_autoptr(AsComponentBox) cbox = NULL;
+		g_autoptr(GError) error = NULL;
+		gdouble elapsed_ms;
+
+		as_utils_delete_dir_recursive (cache_dir);
+		pool = as_bench_new_pool (catalog_dir, cache_dir);
+
+		g_timer_reset (timer);
+		as_pool_load (pool, NULL, &error);
+		elapsed_ms = g_timer_elapsed (timer, NULL) * 1000;
+		if (error != NULL)
+			g_error ("Pool load failed: %s", error->message);
+
+		cbox = as_pool_get_components (pool);
+		if (as_component_box_len (cbox) != scale)
+			g_error ("Expected %u components, got %u.",
+				 scale,
+				 as_component_box_len (cbox));
+
+		total_ms += elapsed_ms;
+		if (i == 0 || elapsed_ms < min_ms)
+			min_ms = elapsed_ms;
+	}
+	as_bench_report (json, "pool-load-cold", cold_loops, total_ms, min_ms);
+
+	total_ms = 0;
+	for (guint i = 0; i < warm_loops; i++) {
+		g_autoptr(AsPool) pool = as_bench_new_pool (catalog_dir, cache_dir);
+		g_autoptr(GError) error = NULL;
+		gdouble elapsed_ms;
+
+		g_timer_reset (timer);
+		as_pool_load (pool, NULL, &error);
+		elapsed_ms = g_timer_elapsed (timer, NULL) * 1000;
+		if (error != NULL)
+			g_error ("Pool load failed: %s", error->message);
+
+		total_ms += elapsed_ms;
+		if (i == 0 || elapsed_ms < min_ms)
+			min_ms = elapsed_ms;
+	}
+	as_bench_report (json, "pool-load-warm", warm_loops, total_ms, min_ms);
+}
+
+/**
+ * as_bench_pool_search:
+ *
+ * Measure full-text search on a loaded pool, covering a common term,
+ * a multi-word query and a guaranteed miss.
+ */
+static void
+as_bench_pool_search (GString *json, AsPool *pool)
+{
+	g_autoptr(GTimer) timer = g_timer_new ();
+	const gchar *queries[] = { "game", "zero install", "benchmrk-nonexistent", NULL };
+	const guint loops = 25;
+
+	for (guint q = 0; queries[q] != NULL; q++) {
+		g_autofree gchar *name = NULL;
+		gdouble total_ms = 0;
+		gdouble min_ms = 0;
+
+		for (guint i = 0; i < loops; i++) {
+			g_autoptr(AsComponentBox) result = NULL;
+			gdouble elapsed_ms;
+
+			g_timer_reset (timer);
+			result = as_pool_search (pool, queries[q]);
+			elapsed_ms = g_timer_elapsed (timer, NULL) * 1000;
+
+			total_ms += elapsed_ms;
+			if (i == 0 || elapsed_ms < min_ms)
+				min_ms = elapsed_ms;
+		}
+
+		name = g_strdup_printf ("pool-search[%s]", queries[q]);
+		as_bench_report (json, name, loops, total_ms, min_ms);
+	}
+}
+
+/**
+ * as_bench_cache_write:
+ *
+ * Measure as_cache_set_contents_for_path(), i.e. refining, serializing and
+ * compiling all components into a binary cache section.
+ */
+static void
+as_bench_cache_write (GString *json, AsPool *pool, const gchar *scratch_dir)
+{
+	g_autoptr(GTimer) timer = g_timer_new ();
+	g_autoptr(AsComponentBox) cbox = as_pool_get_components (pool);
+	g_autofree gchar *cache_dir = g_build_filename (scratch_dir, "cache-write", NULL);
+	gdouble total_ms = 0;
+	gdouble min_ms = 0;
+	const guint loops = 3;
+
+	for (guint i = 0; i < loops; i++) {
+		g_autoptr(AsCache) cache = as_cache_new ();
+		g_autoptr(GError) error = NULL;
+		gdouble elapsed_ms;
+
+		g_mkdir_with_parents (cache_dir, 0755);
+		as_cache_set_locale (cache, "C");
+		as_cache_set_locations (cache, cache_dir, cache_dir);
+
+		g_timer_reset (timer);
+		as_cache_set_contents_for_path (cache,
+						as_component_box_as_array (cbox),
+						"benchmark",
+						NULL,
+						&error);
+		elapsed_ms = g_timer_elapsed (timer, NULL) * 1000;
+		if (error != NULL)
+			g_error ("Cache write failed: %s", error->message);
+
+		total_ms += elapsed_ms;
+		if (i == 0 || elapsed_ms < min_ms)
+			min_ms = elapsed_ms;
+
+		as_utils_delete_dir_recursive (cache_dir);
+	}
+	as_bench_report (json, "cache-set-contents", loops, total_ms, min_ms);
+}
+
+/**
+ * main:
+ */
+int
+main (int argc, char **argv)
+{
+	g_autoptr(GPtrArray) chunks = NULL;
+	g_autoptr(GString) json = g_string_new (NULL);
+	g_autoptr(GString) report = g_string_new (NULL);
+	g_autofree gchar *scratch_dir = NULL;
+	g_autofree gchar *catalog_dir = NULL;
+	g_autofree gchar *xml_dir = NULL;
+	g_autofree gchar *cache_dir = NULL;
+	g_autoptr(GError) error = NULL;
+	const gchar *results_fname;
+	guint scale = 10000;
+
+	if (argc <= 1)
+		g_error ("No test directory specified!");
+	datadir = g_build_filename (argv[1], "samples", NULL);
+	if (!g_file_test (datadir, G_FILE_TEST_EXISTS))
+		g_error ("Sample data directory %s does not exist.", datadir);
+
+	if (g_getenv ("AS_BENCHMARK_SCALE") != NULL)
+		scale = (guint) g_ascii_strtoull (g_getenv ("AS_BENCHMARK_SCALE"), NULL, 10);
+	if (scale == 0)
+		g_error ("Invalid benchmark scale set.");
+
+	scratch_dir = g_dir_make_tmp ("as-benchmark-XXXXXX", &error);
+	if (scratch_dir == NULL)
+		g_error ("Unable to create scratch directory: %s", error->message);
+	catalog_dir = g_build_filename (scratch_dir, "catalog", NULL);
+	xml_dir = g_build_filename (catalog_dir, "xml", NULL);
+	cache_dir = g_build_filename (scratch_dir, "cache", NULL);
+	g_mkdir_with_parents (xml_dir, 0755);
+
+	g_printerr ("Generating synthetic catalog with %u components...\n", scale);
+	chunks = as_bench_load_template_chunks ();
+	as_bench_generate_catalog (xml_dir, chunks, scale);
+
+	as_bench_pool_load (json, catalog_dir, cache_dir, scale);
+
+	{
+		g_autoptr(AsPool) pool = as_bench_new_pool (catalog_dir, cache_dir);
+		as_pool_load (pool, NULL, &error);
+		if (error != NULL)
+			g_error ("Pool load failed: %s", error->message);
+
+		as_bench_pool_search (json, pool);
+		as_bench_cache_write (json, pool, scratch_dir);
+	}
+
+	g_string_append_printf (report,
+				"{\n  \"suite\": \"appstream\",\n"
+				"  \"version\": \"%s\",\n"
+				"  \"scale\": %u,\n  \"results\": [\n%s\n  ]\n}\n",
+				as_version_string (),
+				scale,
+				json->str);
+	g_print ("%s", report->str);
+
+	results_fname = g_getenv ("AS_BENCHMARK_RESULTS");
+	if (results_fname != NULL) {
+		if (!g_file_set_contents (results_fname, report->str, report->len, &error))
+			g_error ("Unable to write results file: %s", error->message);
+	}
+
+	as_utils_delete_dir_recursive (scratch_dir);
+	g_free (datadir);
+	return 0;
+}
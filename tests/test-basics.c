@@ -61,6 +61,49 @@ test_strstripnl (void)
 	g_free (tmp);
 }
 
+/**
+ * test_strdown_fold:
+ *
+ * Test the allocation-free case folding helpers.
+ */
+static void
+test_strdown_fold (void)
+{
+	gchar buf[16];
+	gchar *tmp;
+	g_autofree gchar *heap = NULL;
+	const gchar *res;
+
+	tmp = g_strdup ("FooBAR-2.0 Bäz");
+	as_utils_strdown_inplace (tmp);
+	g_assert_cmpstr (tmp, ==, "foobar-2.0 bäz");
+	g_free (tmp);
+
+	/* short ASCII strings must use the scratch buffer */
+	res = as_utils_strdown_buf ("Org.Example.Foo", buf, sizeof (buf), &heap);
+	g_assert_cmpstr (res, ==, "org.example.foo");
+	g_assert_true (res == buf);
+	g_assert_null (heap);
+
+	/* strings that do not fit fall back to an allocation */
+	res = as_utils_strdown_buf ("Org.Example.FooBarBazApplication", buf, sizeof (buf), &heap);
+	g_assert_cmpstr (res, ==, "org.example.foobarbazapplication");
+	g_assert_true (res == heap);
+	g_clear_pointer (&heap, g_free);
+
+	/* non-ASCII strings need real Unicode folding */
+	res = as_utils_strdown_buf ("BÄR", buf, sizeof (buf), &heap);
+	g_assert_cmpstr (res, ==, "bär");
+	g_assert_true (res == heap);
+	g_clear_pointer (&heap, g_free);
+
+	g_assert_true (as_utils_str_equal_fold ("Application", "aPPlicaTION"));
+	g_assert_true (as_utils_str_equal_fold ("grün", "GRÜN"));
+	g_assert_true (as_utils_str_equal_fold (NULL, NULL));
+	g_assert_false (as_utils_str_equal_fold ("Application", NULL));
+	g_assert_false (as_utils_str_equal_fold ("Application", "Applications"));
+}
+
 /**
  * test_random:
  */
@@ -299,6 +342,273 @@ test_component (void)
 			 "</components>\n");
 }
 
+/**
+ * test_component_bytes:
+ *
+ * Test the compact binary component serialization for a round trip over
+ * a fully populated component, and that malformed data is rejected.
+ */
+static void
+test_component_bytes (void)
+{
+	g_autoptr(AsMetadata) metad = NULL;
+	g_autoptr(AsContext) ctx = NULL;
+	g_autoptr(AsComponent) cpt = NULL;
+	g_autoptr(AsComponent) restored = NULL;
+	g_autoptr(AsBundle) bundle = NULL;
+	g_autoptr(GBytes) bytes = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autofree gchar *xml_orig = NULL;
+	g_autofree gchar *xml_restored = NULL;
+	const guint8 *data;
+	gsize data_len;
+	gboolean ret;
+
+	const gchar *sample_xml =
+	    "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+	    "<component type=\"desktop-application\">\n"
+	    "  <id>org.example.BytesTest</id>\n"
+	    "  <name>Bytes Test</name>\n"
+	    "  <name xml:lang=\"de\">Bytes-Test</name>\n"
+	    "  <summary>Serialization test data</summary>\n"
+	    "  <description><p>First paragraph.</p><p>Second paragraph.</p></description>\n"
+	    "  <metadata_license>FSFAP</metadata_license>\n"
+	    "  <project_license>GPL-3.0-or-later</project_license>\n"
+	    "  <project_group>Example</project_group>\n"
+	    "  <developer id=\"example.org\"><name>The Example Project</name></developer>\n"
+	    "  <pkgname>bytes-test</pkgname>\n"
+	    "  <compulsory_for_desktop>GNOME</compulsory_for_desktop>\n"
+	    "  <launchable type=\"desktop-id\">org.example.BytesTest.desktop</launchable>\n"
+	    "  <provides>\n"
+	    "    <binary>bytes-test</binary>\n"
+	    "    <mediatype>text/x-bytestest</mediatype>\n"
+	    "  </provides>\n"
+	    "  <icon type=\"stock\">bytes-test</icon>\n"
+	    "  <icon type=\"cached\" width=\"64\" height=\"64\">bytes-test_64.png</icon>\n"
+	    "  <url type=\"homepage\">https://example.org</url>\n"
+	    "  <url type=\"bugtracker\">https://example.org/bugs</url>\n"
+	    "  <categories>\n"
+	    "    <category>Network</category>\n"
+	    "    <category>Development</category>\n"
+	    "  </categories>\n"
+	    "  <keywords>\n"
+	    "    <keyword>serialization</keyword>\n"
+	    "    <keyword>binary</keyword>\n"
+	    "  </keywords>\n"
+	    "  <screenshots>\n"
+	    "    <screenshot type=\"default\">\n"
+	    "      <caption>The main window</caption>\n"
+	    "      <image type=\"source\" width=\"1600\" height=\"900\">https://example.org/scr.png</image>\n"
+	    "    </screenshot>\n"
+	    "  </screenshots>\n"
+	    "  <releases>\n"
+	    "    <release version=\"1.2\" date=\"2024-04-01\"><description><p>Fixes.</p></description></release>\n"
+	    "    <release version=\"1.0\" date=\"2024-01-01\"/>\n"
+	    "  </releases>\n"
+	    "  <requires>\n"
+	    "    <display_length compare=\"ge\">360</display_length>\n"
+	    "  </requires>\n"
+	    "  <recommends>\n"
+	    "    <memory>2048</memory>\n"
+	    "  </recommends>\n"
+	    "  <content_rating type=\"oars-1.1\">\n"
+	    "    <content_attribute id=\"social-chat\">moderate</content_attribute>\n"
+	    "  </content_rating>\n"
+	    "  <translation type=\"gettext\">bytes-test</translation>\n"
+	    "  <custom>\n"
+	    "    <value key=\"Example::test\">custom value</value>\n"
+	    "  </custom>\n"
+	    "</component>\n";
+
+	metad = as_metadata_new ();
+	as_metadata_set_locale (metad, "ALL");
+	as_metadata_parse_data (metad, sample_xml, -1, AS_FORMAT_KIND_XML, &error);
+	g_assert_no_error (error);
+	cpt = g_object_ref (as_component_box_index (as_metadata_get_components (metad), 0));
+
+	/* add catalog data the metainfo XML does not carry */
+	as_component_add_language (cpt, "de", 96);
+	as_component_add_language (cpt, "en", 100);
+	bundle = as_bundle_new ();
+	as_bundle_set_kind (bundle, AS_BUNDLE_KIND_FLATPAK);
+	as_bundle_set_id (bundle, "app/org.example.BytesTest/x86_64/stable");
+	as_component_add_bundle (cpt, bundle);
+	as_component_add_tag (cpt, "example", "tagged");
+
+	/* serialize and restore */
+	ctx = as_context_new ();
+	as_context_set_locale (ctx, "ALL");
+	bytes = as_component_to_bytes (cpt, ctx, &error);
+	g_assert_no_error (error);
+	g_assert_nonnull (bytes);
+
+	restored = as_component_new ();
+	ret = as_component_from_bytes (restored, ctx, bytes, &error);
+	g_assert_no_error (error);
+	g_assert_true (ret);
+
+	/* spot-check data that only lives in the binary fields */
+	g_assert_cmpstr (as_component_get_id (restored), ==, "org.example.BytesTest");
+	g_assert_cmpint (as_component_get_kind (restored),
+			 ==,
+			 AS_COMPONENT_KIND_DESKTOP_APP);
+	g_assert_cmpint (as_component_get_language (restored, "de"), ==, 96);
+	g_assert_cmpint (as_component_get_language (restored, "en"), ==, 100);
+	g_assert_nonnull (as_component_get_bundle (restored, AS_BUNDLE_KIND_FLATPAK));
+	g_assert_cmpstr (as_bundle_get_id (
+			     as_component_get_bundle (restored, AS_BUNDLE_KIND_FLATPAK)),
+			 ==,
+			 "app/org.example.BytesTest/x86_64/stable");
+	g_assert_true (as_component_has_tag (restored, "example", "tagged"));
+	g_assert_cmpstr (as_component_get_custom_value (restored, "Example::test"),
+			 ==,
+			 "custom value");
+
+	/* the XML serializations of original and restored component must be
+	 * identical, which covers every remaining field in one comparison */
+	{
+		g_autoptr(AsMetadata) metad_out = NULL;
+
+		metad_out = as_metadata_new ();
+		as_metadata_set_locale (metad_out, "ALL");
+		as_metadata_add_component (metad_out, cpt);
+		xml_orig = as_metadata_component_to_metainfo (metad_out,
+							      AS_FORMAT_KIND_XML,
+							      &error);
+		g_assert_no_error (error);
+
+		g_clear_object (&metad_out);
+		metad_out = as_metadata_new ();
+		as_metadata_set_locale (metad_out, "ALL");
+		as_metadata_add_component (metad_out, restored);
+		xml_restored = as_metadata_component_to_metainfo (metad_out,
+								  AS_FORMAT_KIND_XML,
+								  &error);
+		g_assert_no_error (error);
+	}
+	g_assert_true (as_test_compare_lines (xml_restored, xml_orig));
+
+	data = g_bytes_get_data (bytes, &data_len);
+
+	/* data that is no binary component serialization at all */
+	{
+		g_autoptr(GBytes) junk = g_bytes_new_static ("XXXXJUNKJUNK", 12);
+		g_autoptr(AsComponent) c = as_component_new ();
+
+		ret = as_component_from_bytes (c, ctx, junk, &error);
+		g_assert_error (error, AS_METADATA_ERROR, AS_METADATA_ERROR_PARSE);
+		g_assert_false (ret);
+		g_clear_error (&error);
+	}
+
+	/* unsupported format revision */
+	{
+		const guint8 raw[] = { 'A', 's', 'C', 'b', 0xff, 0xff, 0xff, 0xff };
+		g_autoptr(GBytes) bad = g_bytes_new_static (raw, sizeof (raw));
+		g_autoptr(AsComponent) c = as_component_new ();
+
+		ret = as_component_from_bytes (c, ctx, bad, &error);
+		g_assert_error (error, AS_METADATA_ERROR, AS_METADATA_ERROR_PARSE);
+		g_assert_false (ret);
+		g_clear_error (&error);
+	}
+
+	/* frame header cut off after the field identifier */
+	{
+		g_autoptr(GBytes) trunc = g_bytes_new (data, 9);
+		g_autoptr(AsComponent) c = as_component_new ();
+
+		ret = as_component_from_bytes (c, ctx, trunc, &error);
+		g_assert_error (error, AS_METADATA_ERROR, AS_METADATA_ERROR_PARSE);
+		g_assert_false (ret);
+		g_clear_error (&error);
+	}
+
+	/* last frame truncated by one byte */
+	{
+		g_autoptr(GBytes) trunc = g_bytes_new (data, data_len - 1);
+		g_autoptr(AsComponent) c = as_component_new ();
+
+		ret = as_component_from_bytes (c, ctx, trunc, &error);
+		g_assert_error (error, AS_METADATA_ERROR, AS_METADATA_ERROR_PARSE);
+		g_assert_false (ret);
+		g_clear_error (&error);
+	}
+
+	/* field frame with an oversized length prefix */
+	{
+		const guint8 raw[] = { 'A', 's',  'C',	'b',  0x01, 0x00, 0x00,
+				       0x00, 0x06, 0xf0, 0xff, 0xff, 0xff };
+		g_autoptr(GBytes) bad = g_bytes_new_static (raw, sizeof (raw));
+		g_autoptr(AsComponent) c = as_component_new ();
+
+		ret = as_component_from_bytes (c, ctx, bad, &error);
+		g_assert_error (error, AS_METADATA_ERROR, AS_METADATA_ERROR_PARSE);
+		g_assert_false (ret);
+		g_clear_error (&error);
+	}
+
+	/* string length prefix exceeding its field frame */
+	{
+		const guint8 raw[] = { 'A',  's',  'C',	 'b',  0x01, 0x00, 0x00, 0x00, 0x06,
+				       0x04, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00 };
+		g_autoptr(GBytes) bad = g_bytes_new_static (raw, sizeof (raw));
+		g_autoptr(AsComponent) c = as_component_new ();
+
+		ret = as_component_from_bytes (c, ctx, bad, &error);
+		g_assert_error (error, AS_METADATA_ERROR, AS_METADATA_ERROR_PARSE);
+		g_assert_false (ret);
+		g_clear_error (&error);
+	}
+
+	/* package-name list with an absurd element count */
+	{
+		const guint8 raw[] = { 'A',  's',  'C',	 'b',  0x01, 0x00, 0x00, 0x00, 0x0f,
+				       0x04, 0x00, 0x00, 0x00, 0xfe, 0xff, 0xff, 0xff };
+		g_autoptr(GBytes) bad = g_bytes_new_static (raw, sizeof (raw));
+		g_autoptr(AsComponent) c = as_component_new ();
+
+		ret = as_component_from_bytes (c, ctx, bad, &error);
+		g_assert_error (error, AS_METADATA_ERROR, AS_METADATA_ERROR_PARSE);
+		g_assert_false (ret);
+		g_clear_error (&error);
+	}
+}
+
+/**
+ * test_context_seal:
+ *
+ * Test sealing a metadata context for concurrent sharing.
+ */
+static void
+test_context_seal (void)
+{
+	g_autoptr(AsContext) ctx = NULL;
+	g_autoptr(AsComponent) cpt = NULL;
+
+	ctx = as_context_new ();
+	as_context_set_locale (ctx, "de");
+	as_context_set_origin (ctx, "sealtest");
+	g_assert_false (as_context_is_sealed (ctx));
+
+	as_context_seal (ctx);
+	g_assert_true (as_context_is_sealed (ctx));
+	g_assert_cmpstr (as_context_get_locale (ctx), ==, "de");
+	g_assert_cmpstr (as_context_get_origin (ctx), ==, "sealtest");
+
+	/* changing the locale via a component must not touch the sealed context,
+	 * but give the component its own mutable copy instead */
+	cpt = as_component_new ();
+	as_component_set_id (cpt, "org.example.SealTest");
+	as_component_set_context (cpt, ctx);
+	as_component_set_context_locale (cpt, "fr");
+
+	g_assert_true (as_component_get_context (cpt) != ctx);
+	g_assert_false (as_context_is_sealed (as_component_get_context (cpt)));
+	g_assert_cmpstr (as_context_get_locale (as_component_get_context (cpt)), ==, "fr");
+	g_assert_cmpstr (as_context_get_locale (ctx), ==, "de");
+}
+
 /**
  * test_component_box:
  *
@@ -359,6 +669,150 @@ test_component_box (void)
 	g_assert_cmpint (as_component_box_len (cbox), ==, 3);
 	as_component_box_remove_at (cbox, 1);
 	g_assert_cmpint (as_component_box_len (cbox), ==, 2);
+
+	/* test read-only views and lazy iteration */
+	{
+		g_autoptr(AsComponentBox) view = NULL;
+		AsComponentBoxIter iter;
+		AsComponent *c;
+		guint count = 0;
+
+		view = as_component_box_new_view (cbox, 1, 0);
+		g_assert_cmpint (as_component_box_len (view), ==, 1);
+		g_assert_true (as_component_box_index (view, 0) ==
+			       as_component_box_index (cbox, 1));
+
+		as_component_box_iter_init (&iter, cbox);
+		while ((c = as_component_box_iter_next (&iter)) != NULL) {
+			g_assert_cmpstr (as_component_get_id (c), ==, "org.example.AComponent");
+			count++;
+		}
+		g_assert_cmpint (count, ==, 2);
+	}
+
+	/* test ID-sorted boxes with binary-search lookup and merging */
+	{
+		g_autoptr(AsComponentBox) sbox1 = NULL;
+		g_autoptr(AsComponentBox) sbox2 = NULL;
+		const gchar *cids1[] = { "org.example.Cherry", "org.example.Apple", NULL };
+		const gchar *cids2[] = { "org.example.Banana",
+					 "org.example.Apple",
+					 "org.example.Date",
+					 NULL };
+
+		sbox1 = as_component_box_new (AS_COMPONENT_BOX_FLAG_SORTED);
+		sbox2 = as_component_box_new (AS_COMPONENT_BOX_FLAG_SORTED);
+		for (guint i = 0; cids1[i] != NULL; i++) {
+			g_autoptr(AsComponent) c = as_component_new ();
+			as_component_set_id (c, cids1[i]);
+			ret = as_component_box_add (sbox1, c, &error);
+			g_assert_no_error (error);
+			g_assert_true (ret);
+		}
+		for (guint i = 0; cids2[i] != NULL; i++) {
+			g_autoptr(AsComponent) c = as_component_new ();
+			as_component_set_id (c, cids2[i]);
+			ret = as_component_box_add (sbox2, c, &error);
+			g_assert_no_error (error);
+			g_assert_true (ret);
+		}
+
+		/* insertion must have kept the components ID-sorted */
+		g_assert_cmpstr (as_component_get_id (as_component_box_index (sbox1, 0)),
+				 ==,
+				 "org.example.Apple");
+		g_assert_cmpstr (as_component_get_id (as_component_box_index (sbox1, 1)),
+				 ==,
+				 "org.example.Cherry");
+
+		g_assert_cmpint (as_component_box_index_of (sbox1, "org.example.Cherry"), ==, 1);
+		g_assert_cmpint (as_component_box_index_of (sbox1, "org.example.Durian"), ==, -1);
+
+		/* merge the boxes, skipping the duplicate entry */
+		ret = as_component_box_merge (sbox1, sbox2, &error);
+		g_assert_no_error (error);
+		g_assert_true (ret);
+		g_assert_cmpint (as_component_box_len (sbox1), ==, 4);
+		g_assert_cmpstr (as_component_get_id (as_component_box_index (sbox1, 0)),
+				 ==,
+				 "org.example.Apple");
+		g_assert_cmpstr (as_component_get_id (as_component_box_index (sbox1, 1)),
+				 ==,
+				 "org.example.Banana");
+		g_assert_cmpstr (as_component_get_id (as_component_box_index (sbox1, 2)),
+				 ==,
+				 "org.example.Cherry");
+		g_assert_cmpstr (as_component_get_id (as_component_box_index (sbox1, 3)),
+				 ==,
+				 "org.example.Date");
+		g_assert_cmpint (as_component_box_index_of (sbox1, "org.example.Date"), ==, 3);
+	}
+
+	/* test diffing two component sets */
+	{
+		g_autoptr(AsComponentBox) box_old = NULL;
+		g_autoptr(AsComponentBox) box_new = NULL;
+		g_autoptr(AsComponentBox) added = NULL;
+		g_autoptr(AsComponentBox) removed = NULL;
+		g_autoptr(AsComponentBox) changed = NULL;
+		g_autoptr(GHashTable) changed_fields = NULL;
+		g_autoptr(AsComponent) cpt_a1 = NULL;
+		g_autoptr(AsComponent) cpt_a2 = NULL;
+		g_autoptr(AsComponent) cpt_b = NULL;
+		g_autoptr(AsComponent) cpt_c = NULL;
+		guint mask;
+
+		cpt_a1 = as_component_new ();
+		as_component_set_id (cpt_a1, "org.example.Alpha");
+		as_component_set_name (cpt_a1, "Alpha", "C");
+		cpt_a2 = as_component_new ();
+		as_component_set_id (cpt_a2, "org.example.Alpha");
+		as_component_set_name (cpt_a2, "Alpha II", "C");
+		as_component_set_summary (cpt_a2, "Now with more alpha", "C");
+		cpt_b = as_component_new ();
+		as_component_set_id (cpt_b, "org.example.Beta");
+		cpt_c = as_component_new ();
+		as_component_set_id (cpt_c, "org.example.Gamma");
+
+		box_old = as_component_box_new_simple ();
+		as_component_box_add (box_old, cpt_a1, NULL);
+		as_component_box_add (box_old, cpt_b, NULL);
+		box_new = as_component_box_new_simple ();
+		as_component_box_add (box_new, cpt_a2, NULL);
+		as_component_box_add (box_new, cpt_c, NULL);
+
+		ret = as_component_box_diff (box_old,
+					     box_new,
+					     &added,
+					     &removed,
+					     &changed,
+					     &changed_fields);
+		g_assert_true (ret);
+
+		g_assert_cmpint (as_component_box_len (added), ==, 1);
+		g_assert_cmpstr (as_component_get_id (as_component_box_index (added, 0)),
+				 ==,
+				 "org.example.Gamma");
+		g_assert_cmpint (as_component_box_len (removed), ==, 1);
+		g_assert_cmpstr (as_component_get_id (as_component_box_index (removed, 0)),
+				 ==,
+				 "org.example.Beta");
+		g_assert_cmpint (as_component_box_len (changed), ==, 1);
+		g_assert_cmpstr (as_component_get_id (as_component_box_index (changed, 0)),
+				 ==,
+				 "org.example.Alpha");
+
+		mask = GPOINTER_TO_UINT (g_hash_table_lookup (
+		    changed_fields,
+		    as_component_get_data_id (cpt_a2)));
+		g_assert_cmpint (mask,
+				 ==,
+				 AS_COMPONENT_DIFF_FLAG_NAME | AS_COMPONENT_DIFF_FLAG_SUMMARY);
+
+		/* identical boxes must yield no difference */
+		ret = as_component_box_diff (box_new, box_new, NULL, NULL, NULL, NULL);
+		g_assert_false (ret);
+	}
 }
 
 /**
@@ -644,7 +1098,8 @@ test_read_desktop_entry_simple (void)
 						 "Type=Application\n"
 						 "Name=FooBar\n"
 						 "Name[de_DE]=FööBär\n"
-						 "Comment=A foo-ish bar.\n"
+						 "Comment=A foo-ish\\sbar.\n"
+						 "Icon=foobar.png\n"
 						 "Keywords=Hobbes;Bentham;Locke;\n"
 						 "Keywords[de_DE]=Heidegger;Kant;Hegel;\n";
 
@@ -671,10 +1126,22 @@ test_read_desktop_entry_simple (void)
 	as_component_set_context_locale (cpt, "C.UTF-8");
 	g_assert_cmpstr (as_component_get_id (cpt), ==, "foobar.desktop");
 	g_assert_cmpstr (as_component_get_name (cpt), ==, "FooBar");
+	g_assert_cmpstr (as_component_get_summary (cpt), ==, "A foo-ish bar.");
 	tmp = as_ptr_array_strjoin (as_component_get_keywords (cpt), ", ");
 	g_assert_cmpstr (tmp, ==, "Hobbes, Bentham, Locke");
 	g_free (tmp);
 
+	/* the stock icon must have its filename suffix stripped */
+	{
+		GPtrArray *icons = as_component_get_icons (cpt);
+		AsIcon *icon;
+
+		g_assert_cmpint (icons->len, ==, 1);
+		icon = AS_ICON (g_ptr_array_index (icons, 0));
+		g_assert_cmpint (as_icon_get_kind (icon), ==, AS_ICON_KIND_STOCK);
+		g_assert_cmpstr (as_icon_get_name (icon), ==, "foobar");
+	}
+
 	as_component_set_context_locale (cpt, "de_DE");
 	g_assert_cmpstr (as_component_get_name (cpt), ==, "FööBär");
 	tmp = as_ptr_array_strjoin (as_component_get_keywords (cpt), ", ");
@@ -890,6 +1357,23 @@ test_version_compare (void)
 	    as_vercmp_test_match ("4", AS_RELATION_COMPARE_GE, "3", AS_VERCMP_FLAG_NONE));
 	g_assert_false (
 	    as_vercmp_test_match ("5", AS_RELATION_COMPARE_GE, "6", AS_VERCMP_FLAG_NONE));
+
+	/* batch comparison */
+	{
+		const gchar *versions[] = { "1.2.2", "1.2.3", "1.2.4", "1:1.0", "1.2.3~rc1", NULL };
+		gint results[6] = { 9, 9, 9, 9, 9, 9 };
+
+		as_vercmp_batch ("1.2.3", versions, 6, results, AS_VERCMP_FLAG_NONE);
+		g_assert_cmpint (results[0], >, 0);
+		g_assert_cmpint (results[1], ==, 0);
+		g_assert_cmpint (results[2], <, 0);
+		g_assert_cmpint (results[3], <, 0);
+		g_assert_cmpint (results[4], >, 0);
+		g_assert_cmpint (results[5], >, 0);
+
+		as_vercmp_batch ("1.2.3", versions, 6, results, AS_VERCMP_FLAG_IGNORE_EPOCH);
+		g_assert_cmpint (results[3], >, 0);
+	}
 }
 
 /**
@@ -1040,6 +1524,39 @@ test_content_rating_mappings (void)
 			  0);
 }
 
+/* Test that as_content_rating_get_all_values() returns one value per known
+ * rating ID and always agrees with per-attribute as_content_rating_get_value()
+ * calls, for rated and unrated attributes alike. */
+static void
+test_content_rating_all_values (void)
+{
+	g_autoptr(AsContentRating) rating = NULL;
+	g_autofree const gchar **ids = as_content_rating_get_all_rating_ids ();
+	g_autofree AsContentRatingValue *values = NULL;
+	gsize n_values = 0;
+
+	rating = as_content_rating_new ();
+	as_content_rating_set_kind (rating, "oars-1.1");
+	as_content_rating_set_value (rating,
+				     "violence-bloodshed",
+				     AS_CONTENT_RATING_VALUE_MODERATE);
+	as_content_rating_set_value (rating, "social-chat", AS_CONTENT_RATING_VALUE_INTENSE);
+
+	values = as_content_rating_get_all_values (rating, &n_values);
+	g_assert_nonnull (values);
+
+	for (gsize i = 0; i < n_values; i++) {
+		g_assert_nonnull (ids[i]);
+		g_assert_cmpint (values[i], ==, as_content_rating_get_value (rating, ids[i]));
+	}
+	g_assert_null (ids[n_values]);
+
+	/* unrated attributes of a known kind must default to "none" */
+	g_assert_cmpint (as_content_rating_get_value (rating, "drugs-alcohol"),
+			 ==,
+			 AS_CONTENT_RATING_VALUE_NONE);
+}
+
 /* Test that gs_utils_content_rating_system_from_locale() returns the correct
  * rating system for various standard locales and various forms of locale name.
  * See `locale -a` for the list of all available locales which some of these
@@ -1258,6 +1775,7 @@ main (int argc, char **argv)
 	g_log_set_fatal_mask (NULL, G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL);
 
 	g_test_add_func ("/AppStream/Strstrip", test_strstripnl);
+	g_test_add_func ("/AppStream/StrdownFold", test_strdown_fold);
 	g_test_add_func ("/AppStream/Random", test_random);
 	g_test_add_func ("/AppStream/SafeAssign", test_safe_assign);
 	g_test_add_func ("/AppStream/VerifyIntStr", test_verify_int_str);
@@ -1265,6 +1783,8 @@ main (int argc, char **argv)
 	g_test_add_func ("/AppStream/Categories", test_categories);
 	g_test_add_func ("/AppStream/SimpleMarkupConvert", test_simplemarkup);
 	g_test_add_func ("/AppStream/Component", test_component);
+	g_test_add_func ("/AppStream/ComponentBytes", test_component_bytes);
+	g_test_add_func ("/AppStream/ContextSeal", test_context_seal);
 	g_test_add_func ("/AppStream/ComponentBox", test_component_box);
 	g_test_add_func ("/AppStream/SPDX", test_spdx);
 	g_test_add_func ("/AppStream/DesktopEnv", test_desktop_env);
@@ -1277,6 +1797,7 @@ main (int argc, char **argv)
 	g_test_add_func ("/AppStream/rDNSConvert", test_rdns_convert);
 	g_test_add_func ("/AppStream/URIToBasename", test_filebasename_from_uri);
 	g_test_add_func ("/AppStream/ContentRating/Mapings", test_content_rating_mappings);
+	g_test_add_func ("/AppStream/ContentRating/all-values", test_content_rating_all_values);
 	g_test_add_func ("/AppStream/ContentRating/from-locale",
 			 as_test_content_rating_from_locale);
 
@@ -111,6 +111,53 @@ test_utils (void)
 	g_free (tmp);
 }
 
+/**
+ * test_compose_tarball:
+ *
+ * Test the streaming tarball writer.
+ */
+static void
+test_compose_tarball (void)
+{
+	g_autofree gchar *tmp_root = NULL;
+	g_autofree gchar *subdir = NULL;
+	g_autofree gchar *fname = NULL;
+	g_autofree gchar *tar_fname = NULL;
+	g_autofree gchar *tar_data = NULL;
+	gsize tar_len = 0;
+	g_autoptr(GError) error = NULL;
+	gboolean ret;
+
+	tmp_root = g_dir_make_tmp ("asc-tartest-XXXXXX", &error);
+	g_assert_no_error (error);
+
+	subdir = g_build_filename (tmp_root, "64x64", NULL);
+	g_assert_cmpint (g_mkdir_with_parents (subdir, 0755), ==, 0);
+	fname = g_build_filename (subdir, "org.example.app.png", NULL);
+	ret = g_file_set_contents (fname, "fake-icon-data", -1, &error);
+	g_assert_no_error (error);
+	g_assert_true (ret);
+
+	tar_fname = g_build_filename (tmp_root, "icons.tar", NULL);
+	ret = asc_tarball_write_from_dir (tar_fname, tmp_root, &error);
+	g_assert_no_error (error);
+	g_assert_true (ret);
+
+	ret = g_file_get_contents (tar_fname, &tar_data, &tar_len, &error);
+	g_assert_no_error (error);
+	g_assert_true (ret);
+
+	/* directory entry, file entry, file data block, two end-of-archive blocks */
+	g_assert_cmpint (tar_len, ==, 5 * 512);
+	g_assert_cmpstr (tar_data, ==, "64x64/");
+	g_assert_cmpstr (tar_data + 512, ==, "64x64/org.example.app.png");
+	/* ustar magic of the file entry header */
+	g_assert_cmpstr (tar_data + 512 + 257, ==, "ustar");
+	g_assert_nonnull (g_strstr_len (tar_data + 1024, 512, "fake-icon-data"));
+
+	as_utils_delete_dir_recursive (tmp_root);
+}
+
 /**
  * test_compose_issue_tag_sanity:
  */
@@ -329,6 +376,17 @@ test_image_transform (void)
 				       &error);
 	g_assert_no_error (error);
 	g_assert_true (ret);
+
+	/* create a scaled copy, leaving the source image untouched */
+	{
+		g_autoptr(AscImage) thumb = NULL;
+		thumb = asc_image_new_scaled (image, 62, 62);
+		g_assert_nonnull (thumb);
+		g_assert_cmpint (asc_image_get_width (thumb), ==, 62);
+		g_assert_cmpint (asc_image_get_height (thumb), ==, 62);
+		g_assert_cmpint (asc_image_get_width (image), ==, 124);
+		g_assert_cmpint (asc_image_get_height (image), ==, 124);
+	}
 }
 
 /**
@@ -678,12 +736,11 @@ teardown (Fixture *fixture, gconstpointer user_data)
 static void
 test_compose_optipng_not_found (Fixture *fixture, gconstpointer user_data)
 {
-	g_test_expect_message (G_LOG_DOMAIN,
-			       G_LOG_LEVEL_CRITICAL,
-			       "*Refusing to enable optipng: not found in $PATH");
+	/* with no optipng in $PATH, PNG optimization must still be possible
+	 * through the in-process optimizer */
 	asc_globals_set_use_optipng (TRUE);
-	g_assert_false (asc_globals_get_use_optipng ());
-	g_test_assert_expected_messages ();
+	g_assert_true (asc_globals_get_use_optipng ());
+	g_assert_null (asc_globals_get_optipng_binary ());
 }
 
 /**
@@ -724,6 +781,133 @@ test_compose_directory_unit (void)
 	g_assert_null (data);
 }
 
+/**
+ * test_compose_memory_unit:
+ */
+static void
+test_compose_memory_unit (void)
+{
+	g_autoptr(GError) error = NULL;
+	gboolean ret;
+	GPtrArray *contents;
+	g_autoptr(GBytes) mi_bytes = NULL;
+	g_autoptr(GBytes) data = NULL;
+	g_autoptr(AscMemoryUnit) munit = asc_memory_unit_new ("org.example.pkg");
+
+	mi_bytes = g_bytes_new_static ("Hello Universe!\n", 16);
+	asc_memory_unit_add_data (munit,
+				  "/usr/share/metainfo/org.example.app.metainfo.xml",
+				  mi_bytes);
+	asc_memory_unit_add_data (munit, "/usr/share/applications/org.example.app.desktop", mi_bytes);
+
+	ret = asc_unit_open (ASC_UNIT (munit), &error);
+	g_assert_no_error (error);
+	g_assert_true (ret);
+
+	contents = asc_unit_get_contents (ASC_UNIT (munit));
+	g_assert_cmpint (contents->len, ==, 2);
+
+	/* read existent data */
+	g_assert_true (asc_unit_file_exists (ASC_UNIT (munit),
+					     "/usr/share/metainfo/org.example.app.metainfo.xml"));
+	g_assert_true (asc_unit_dir_exists (ASC_UNIT (munit), "/usr/share/metainfo"));
+	data = asc_unit_read_data (ASC_UNIT (munit),
+				   "/usr/share/metainfo/org.example.app.metainfo.xml",
+				   &error);
+	g_assert_no_error (error);
+	g_assert_nonnull (data);
+	g_assert_cmpstr ((const gchar *) g_bytes_get_data (data, NULL), ==, "Hello Universe!\n");
+
+	/* read nonexistent data */
+	g_bytes_unref (data);
+	g_assert_false (asc_unit_file_exists (ASC_UNIT (munit), "/nonexistent"));
+	g_assert_false (asc_unit_dir_exists (ASC_UNIT (munit), "/usr/lib"));
+	data = asc_unit_read_data (ASC_UNIT (munit), "/nonexistent", &error);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND);
+	g_assert_null (data);
+}
+
+/**
+ * test_compose_tar_unit:
+ *
+ * Read file data straight from tar archives, without extraction.
+ */
+static void
+test_compose_tar_unit (void)
+{
+	g_autofree gchar *tmp_root = NULL;
+	g_autofree gchar *src_dir = NULL;
+	g_autofree gchar *mi_dir = NULL;
+	g_autofree gchar *mi_fname = NULL;
+	g_autoptr(GError) error = NULL;
+	gboolean ret;
+	const gchar *tar_names[] = { "tree.tar", "tree.tar.gz", NULL };
+
+	tmp_root = g_dir_make_tmp ("asc-tarunit-test-XXXXXX", &error);
+	g_assert_no_error (error);
+
+	/* create a small tree and pack it into tarballs */
+	src_dir = g_build_filename (tmp_root, "root", NULL);
+	mi_dir = g_build_filename (src_dir, "usr", "share", "metainfo", NULL);
+	g_assert_cmpint (g_mkdir_with_parents (mi_dir, 0755), ==, 0);
+	mi_fname = g_build_filename (mi_dir, "org.example.app.metainfo.xml", NULL);
+	ret = g_file_set_contents (mi_fname, "Hello Universe!\n", -1, &error);
+	g_assert_no_error (error);
+	g_assert_true (ret);
+
+	/* check both the seek-based plain and the in-memory compressed read paths */
+	for (guint i = 0; tar_names[i] != NULL; i++) {
+		g_autofree gchar *tar_fname = NULL;
+		g_autoptr(GBytes) data = NULL;
+		g_autoptr(AscTarUnit) tarunit = NULL;
+		GPtrArray *contents;
+
+		tar_fname = g_build_filename (tmp_root, tar_names[i], NULL);
+		ret = asc_tarball_write_from_dir (tar_fname, src_dir, &error);
+		g_assert_no_error (error);
+		g_assert_true (ret);
+
+		tarunit = asc_tar_unit_new (tar_fname);
+		ret = asc_unit_open (ASC_UNIT (tarunit), &error);
+		g_assert_no_error (error);
+		g_assert_true (ret);
+
+		contents = asc_unit_get_contents (ASC_UNIT (tarunit));
+		g_assert_cmpint (contents->len, ==, 1);
+		g_assert_cmpstr (g_ptr_array_index (contents, 0),
+				 ==,
+				 "/usr/share/metainfo/org.example.app.metainfo.xml");
+
+		/* read existent data */
+		g_assert_true (
+		    asc_unit_file_exists (ASC_UNIT (tarunit),
+					  "/usr/share/metainfo/org.example.app.metainfo.xml"));
+		g_assert_true (asc_unit_dir_exists (ASC_UNIT (tarunit), "/usr/share/metainfo"));
+		data = asc_unit_read_data (ASC_UNIT (tarunit),
+					   "/usr/share/metainfo/org.example.app.metainfo.xml",
+					   &error);
+		g_assert_no_error (error);
+		g_assert_nonnull (data);
+		g_assert_cmpmem (g_bytes_get_data (data, NULL),
+				 g_bytes_get_size (data),
+				 "Hello Universe!\n",
+				 16);
+
+		/* read nonexistent data */
+		g_bytes_unref (data);
+		g_assert_false (asc_unit_file_exists (ASC_UNIT (tarunit), "/nonexistent"));
+		g_assert_false (asc_unit_dir_exists (ASC_UNIT (tarunit), "/usr/lib"));
+		data = asc_unit_read_data (ASC_UNIT (tarunit), "/nonexistent", &error);
+		g_assert_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND);
+		g_assert_null (data);
+		g_clear_error (&error);
+
+		asc_unit_close (ASC_UNIT (tarunit));
+	}
+
+	as_utils_delete_dir_recursive (tmp_root);
+}
+
 /**
  * test_compose_locale_stats:
  */
@@ -1012,6 +1196,7 @@ main (int argc, char **argv)
 		    test_compose_optipng_not_found,
 		    teardown);
 	g_test_add_func ("/AppStream/Compose/Utils", test_utils);
+	g_test_add_func ("/AppStream/Compose/Tarball", test_compose_tarball);
 	g_test_add_func ("/AppStream/Compose/IssueTagSanity", test_compose_issue_tag_sanity);
 	g_test_add_func ("/AppStream/Compose/FontInfo", test_read_fontinfo);
 	g_test_add_func ("/AppStream/Compose/Image", test_image_transform);
@@ -1020,6 +1205,8 @@ main (int argc, char **argv)
 	g_test_add_func ("/AppStream/Compose/Result", test_compose_result);
 	g_test_add_func ("/AppStream/Compose/DesktopEntry", test_compose_desktop_entry);
 	g_test_add_func ("/AppStream/Compose/DirectoryUnit", test_compose_directory_unit);
+	g_test_add_func ("/AppStream/Compose/MemoryUnit", test_compose_memory_unit);
+	g_test_add_func ("/AppStream/Compose/TarUnit", test_compose_tar_unit);
 	g_test_add_func ("/AppStream/Compose/LocaleStats", test_compose_locale_stats);
 	g_test_add_func ("/AppStream/Compose/SourceLocale", test_compose_source_locale);
 	g_test_add_func ("/AppStream/Compose/VideoInfo", test_compose_video_info);
@@ -19,6 +19,7 @@
  */
 
 #include <glib.h>
+#include <glib/gstdio.h>
 #include "appstream.h"
 #include "as-news-convert.h"
 #include "as-utils-private.h"
@@ -285,6 +286,59 @@ test_readwrite_text_news (void)
 	g_free (tmp);
 }
 
+/**
+ * test_batch_news_convert:
+ */
+static void
+test_batch_news_convert (void)
+{
+	static const gchar *text_news_data = "Version 1.2.0\n"
+					     "~~~~~~~~~~~~~\n"
+					     "Released: 2024-04-02\n"
+					     "\n"
+					     "Features:\n"
+					     " * Alpha\n"
+					     " * Beta\n";
+	g_autofree gchar *tmpdir = NULL;
+	g_autoptr(GPtrArray) rels_list = NULL;
+	g_autoptr(GError) error = NULL;
+	gchar *fnames[4] = { NULL };
+
+	tmpdir = g_dir_make_tmp ("asnews-batch-XXXXXX", &error);
+	g_assert_no_error (error);
+
+	for (guint i = 0; i < 2; i++) {
+		fnames[i] = g_strdup_printf ("%s/NEWS-%u.txt", tmpdir, i);
+		g_assert_true (g_file_set_contents (fnames[i], text_news_data, -1, NULL));
+	}
+	/* a nonexistent file must yield an empty release list, not abort the batch */
+	fnames[2] = g_build_filename (tmpdir, "NEWS-missing.txt", NULL);
+
+	rels_list = as_news_to_releases_from_filenames ((const gchar *const *) fnames,
+							AS_NEWS_FORMAT_KIND_UNKNOWN,
+							-1,
+							-1);
+	g_assert_nonnull (rels_list);
+	g_assert_cmpint (rels_list->len, ==, 3);
+
+	for (guint i = 0; i < 2; i++) {
+		GPtrArray *releases = g_ptr_array_index (rels_list, i);
+		AsRelease *release;
+
+		g_assert_cmpint (releases->len, ==, 1);
+		release = AS_RELEASE (g_ptr_array_index (releases, 0));
+		g_assert_cmpstr (as_release_get_version (release), ==, "1.2.0");
+	}
+	g_assert_cmpint (((GPtrArray *) g_ptr_array_index (rels_list, 2))->len, ==, 0);
+
+	/* cleanup */
+	for (guint i = 0; fnames[i] != NULL; i++) {
+		g_remove (fnames[i]);
+		g_free (fnames[i]);
+	}
+	g_remove (tmpdir);
+}
+
 /**
  * test_locale_strip_encoding:
  */
@@ -478,6 +532,7 @@ main (int argc, char **argv)
 
 	g_test_add_func ("/AppStream/Misc/YAMLNews", test_readwrite_yaml_news);
 	g_test_add_func ("/AppStream/Misc/TextNews", test_readwrite_text_news);
+	g_test_add_func ("/AppStream/Misc/BatchNewsConvert", test_batch_news_convert);
 	g_test_add_func ("/AppStream/Misc/StripLocaleEncoding", test_locale_strip_encoding);
 	g_test_add_func ("/AppStream/Misc/RelationSatisfyCheck", test_relation_satisfy_check);
 	g_test_add_func ("/AppStream/Misc/SysCompatScores", test_syscompat_scores);
@@ -296,6 +296,83 @@ test_cache (void)
 	as_utils_delete_dir_recursive (cache_testpath);
 }
 
+/**
+ * test_cache_cold_clustering:
+ *
+ * Test that cache data survives a round trip unharmed when the cold
+ * payload (descriptions, releases, screenshots) is clustered into a
+ * separate silo region.
+ */
+static void
+test_cache_cold_clustering (void)
+{
+	g_autoptr(AsCache) cache = NULL;
+	g_autoptr(GPtrArray) cpts = NULL;
+	g_autoptr(AsComponentBox) result = NULL;
+	g_autoptr(GError) error = NULL;
+	gboolean ret;
+	g_autofree gchar *cache_testpath = g_build_filename (cache_dummy_dir,
+							     "ctest-cluster",
+							     NULL);
+
+	cpts = g_ptr_array_new_with_free_func (g_object_unref);
+	for (guint i = 0; i < 4; i++) {
+		AsComponent *cpt = as_component_new ();
+		g_autofree gchar *cid = g_strdup_printf ("org.example.ClusterTest%u", i);
+		g_autoptr(AsRelease) rel = as_release_new ();
+
+		as_component_set_kind (cpt, AS_COMPONENT_KIND_GENERIC);
+		as_component_set_id (cpt, cid);
+		as_component_set_name (cpt, "ClusterTest", "C");
+		as_component_set_summary (cpt, "Cold-data clustering test.", "C");
+		as_component_set_description (
+		    cpt,
+		    "<p>A long description that belongs into the cold region.</p>",
+		    "C");
+		as_release_set_version (rel, "1.2");
+		as_component_add_release (cpt, rel);
+		g_ptr_array_add (cpts, cpt);
+	}
+
+	cache = as_cache_new ();
+	as_cache_set_locale (cache, "C");
+	as_cache_set_locations (cache, cache_testpath, cache_testpath);
+	as_cache_set_cluster_hot_fields (cache, TRUE);
+
+	ret = as_cache_set_contents_for_path (cache, cpts, "/cluster/dummy", NULL, &error);
+	g_assert_no_error (error);
+	g_assert_true (ret);
+
+	/* reload via a fresh cache instance */
+	g_clear_pointer (&cache, g_object_unref);
+	cache = as_cache_new ();
+	as_cache_set_locale (cache, "C");
+	as_cache_set_locations (cache, cache_testpath, cache_testpath);
+	as_cache_load_section_for_path (cache, "/cluster/dummy", NULL, NULL);
+
+	result = as_cache_get_components_all (cache, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (as_component_box_len (result), ==, 4);
+
+	/* the cold data must be fetched transparently on access */
+	for (guint i = 0; i < as_component_box_len (result); i++) {
+		AsComponent *cpt = as_component_box_index (result, i);
+		AsReleaseList *rels;
+
+		g_assert_nonnull (as_component_get_description (cpt));
+		g_assert_nonnull (strstr (as_component_get_description (cpt), "cold region"));
+
+		rels = as_component_get_releases_plain (cpt);
+		g_assert_cmpint (as_release_list_len (rels), ==, 1);
+		g_assert_cmpstr (as_release_get_version (as_release_list_index (rels, 0)),
+				 ==,
+				 "1.2");
+	}
+
+	/* cleanup */
+	as_utils_delete_dir_recursive (cache_testpath);
+}
+
 /**
  * test_pool_read:
  *
@@ -323,6 +400,9 @@ test_pool_read (void)
 	as_pool_load (dpool, NULL, &error);
 	g_assert_no_error (error);
 
+	/* record statistics for the queries this test runs */
+	as_pool_set_query_stats_enabled (dpool, TRUE);
+
 	/* enusre DeleteMe component was removed via its remove-component merge request */
 	result = as_pool_get_components_by_id (dpool, "org.example.DeleteMe");
 	g_assert_cmpint (as_component_box_len (result), ==, 0);
@@ -333,6 +413,10 @@ test_pool_read (void)
 	g_assert_nonnull (all_cpts);
 	g_assert_cmpint (as_component_box_len (all_cpts), ==, 20);
 
+	/* warm the search index in the background - searches must behave
+	 * identically no matter how far the warmup has progressed */
+	as_pool_warm_search_index_async (dpool);
+
 	/* generic tests */
 	result = as_pool_search (dpool, "kig");
 	print_cptbox (result);
@@ -374,6 +458,16 @@ test_pool_read (void)
 	g_assert_cmpint (as_component_box_len (result), ==, 20);
 	g_clear_pointer (&result, g_object_unref);
 
+	/* repeated queries with result memoization enabled must yield identical results */
+	as_pool_add_flags (dpool, AS_POOL_FLAG_CACHE_SEARCH_RESULTS);
+	result = as_pool_search (dpool, "strategy game");
+	g_assert_cmpint (as_component_box_len (result), ==, 2);
+	g_clear_pointer (&result, g_object_unref);
+	result = as_pool_search (dpool, "game strategy");
+	g_assert_cmpint (as_component_box_len (result), ==, 2);
+	g_clear_pointer (&result, g_object_unref);
+	as_pool_remove_flags (dpool, AS_POOL_FLAG_CACHE_SEARCH_RESULTS);
+
 	strv = g_strsplit ("Science", ";", 0);
 	result = as_pool_get_components_by_categories (dpool, strv);
 	g_strfreev (strv);
@@ -381,6 +475,36 @@ test_pool_read (void)
 	g_assert_cmpint (as_component_box_len (result), ==, 3);
 	g_clear_pointer (&result, g_object_unref);
 
+	/* the queries above must have left traces in the query statistics */
+	{
+		g_autofree gchar *stats_report = as_pool_get_query_stats_report (dpool);
+		g_assert_nonnull (stats_report);
+		g_assert_nonnull (g_strstr_len (stats_report, -1, "fts:search"));
+		g_assert_nonnull (g_strstr_len (stats_report, -1, "categories"));
+	}
+
+	/* a frozen snapshot must yield the same results as the pool it was taken from */
+	{
+		g_autoptr(AsPoolSnapshot) snapshot = as_pool_freeze (dpool);
+		g_autoptr(AsComponentBox) snap_cpts = NULL;
+
+		snap_cpts = as_pool_snapshot_get_components (snapshot);
+		g_assert_cmpint (as_component_box_len (snap_cpts), ==, 20);
+
+		result = as_pool_snapshot_get_components_by_id (snapshot, "org.inkscape.Inkscape");
+		g_assert_cmpint (as_component_box_len (result), ==, 1);
+		g_clear_pointer (&result, g_object_unref);
+
+		result = as_pool_snapshot_search (snapshot, "strategy game");
+		print_cptbox (result);
+		g_assert_cmpint (as_component_box_len (result), ==, 2);
+		g_clear_pointer (&result, g_object_unref);
+
+		result = as_pool_snapshot_search (snapshot, "s");
+		g_assert_cmpint (as_component_box_len (result), ==, 20);
+		g_clear_pointer (&result, g_object_unref);
+	}
+
 	result = as_pool_get_components_by_provided_item (dpool,
 							  AS_PROVIDED_KIND_BINARY,
 							  "inkscape");
@@ -740,6 +864,97 @@ test_pool_empty (void)
 	g_clear_pointer (&result, g_object_unref);
 }
 
+/**
+ * test_pool_component_handle:
+ *
+ * Test resolving stable component handles.
+ */
+static void
+test_pool_component_handle (void)
+{
+	g_autoptr(AsPool) pool = NULL;
+	g_autoptr(AsComponentBox) cbox = NULL;
+	g_autoptr(AsComponentHandle) handle = NULL;
+	g_autoptr(AsComponent) resolved = NULL;
+	g_autoptr(GError) error = NULL;
+	AsComponent *cpt = NULL;
+	gboolean ret;
+
+	pool = as_pool_new ();
+	as_pool_set_load_std_data_locations (pool, FALSE);
+	as_pool_override_cache_locations (pool, cache_dummy_dir, NULL);
+	as_pool_reset_extra_data_locations (pool);
+	as_pool_set_locale (pool, "C");
+
+	/* create dummy app to add */
+	cpt = as_component_new ();
+	as_component_set_kind (cpt, AS_COMPONENT_KIND_DESKTOP_APP);
+	as_component_set_id (cpt, "org.freedesktop.HandleTest");
+	as_component_set_name (cpt, "Handle test", "C");
+	as_component_set_summary (cpt, "An app to test handles with.", "C");
+
+	cbox = as_component_box_new_simple ();
+	g_assert_true (as_component_box_add (cbox, cpt, NULL));
+	ret = as_pool_add_components (pool, cbox, &error);
+	g_assert_no_error (error);
+	g_assert_true (ret);
+
+	handle = as_pool_create_component_handle (pool, cpt);
+	g_object_unref (cpt);
+	g_assert_nonnull (handle);
+
+	resolved = as_pool_resolve_component_handle (pool, handle);
+	g_assert_nonnull (resolved);
+	g_assert_cmpstr (as_component_get_id (resolved), ==, "org.freedesktop.HandleTest");
+	g_clear_object (&resolved);
+
+	/* resolving again is served from the handle's memoized component */
+	resolved = as_pool_resolve_component_handle (pool, handle);
+	g_assert_nonnull (resolved);
+
+	/* a handle for a component that does not exist resolves to nothing */
+	g_clear_pointer (&handle, as_component_handle_free);
+	cpt = as_component_new ();
+	as_component_set_id (cpt, "org.freedesktop.NotThere");
+	handle = as_pool_create_component_handle (pool, cpt);
+	g_object_unref (cpt);
+	g_clear_object (&resolved);
+	resolved = as_pool_resolve_component_handle (pool, handle);
+	g_assert_null (resolved);
+}
+
+/**
+ * test_pool_language_stats:
+ *
+ * Test aggregating the language histogram across the whole pool.
+ */
+static void
+test_pool_language_stats (void)
+{
+	g_autoptr(AsPool) pool = NULL;
+	g_autoptr(GHashTable) stats = NULL;
+	g_autoptr(GHashTable) stats2 = NULL;
+	g_autoptr(GError) error = NULL;
+
+	pool = test_get_sampledata_pool (FALSE);
+	as_pool_load (pool, NULL, &error);
+	g_assert_no_error (error);
+
+	stats = as_pool_get_language_stats (pool);
+	g_assert_nonnull (stats);
+
+	/* four sample components are translated into German */
+	g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (stats, "de")), ==, 4);
+	g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (stats, "sv")), ==, 3);
+
+	/* unknown languages just have no entry */
+	g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (stats, "tlh")), ==, 0);
+
+	/* querying again is served from the memoized histogram */
+	stats2 = as_pool_get_language_stats (pool);
+	g_assert_true (stats2 == stats);
+}
+
 static void
 monitor_test_cb (AsFileMonitor *mon, const gchar *filename, guint *cnt)
 {
@@ -1081,7 +1296,10 @@ main (int argc, char **argv)
 	g_test_add_func ("/AppStream/PoolRead", test_pool_read);
 	g_test_add_func ("/AppStream/PoolReadAsync", test_pool_read_async);
 	g_test_add_func ("/AppStream/PoolEmpty", test_pool_empty);
+	g_test_add_func ("/AppStream/PoolComponentHandle", test_pool_component_handle);
+	g_test_add_func ("/AppStream/PoolLanguageStats", test_pool_language_stats);
 	g_test_add_func ("/AppStream/Cache", test_cache);
+	g_test_add_func ("/AppStream/CacheColdClustering", test_cache_cold_clustering);
 	g_test_add_func ("/AppStream/Merges", test_merge_components);
 #ifdef HAVE_STEMMING
 	g_test_add_func ("/AppStream/Stemming", test_search_stemming);
@@ -20,6 +20,7 @@
 
 #include <glib.h>
 #include <glib/gprintf.h>
+#include <glib/gstdio.h>
 
 #include "appstream.h"
 #include "as-component-private.h"
@@ -212,6 +213,24 @@ test_appstream_parser_locale (void)
 
 	/* check if we loaded the right amount of icons */
 	g_assert_cmpint (as_component_get_icons (cpt)->len, ==, 2);
+
+	/* in strict mode, "de" is merely compatible with the "de-DE" data, so it is ignored */
+	as_metadata_clear_components (metad);
+	as_metadata_set_parse_flags (metad, AS_PARSE_FLAG_STRICT_LOCALE);
+	as_metadata_set_locale (metad, "de");
+	as_metadata_parse_file (metad, file, AS_FORMAT_KIND_XML, &error);
+	cpt = as_metadata_get_component (metad);
+	g_assert_no_error (error);
+	g_assert_cmpstr (as_component_get_name (cpt), ==, "Firefox");
+
+	/* an exact locale match is still read in strict mode */
+	as_metadata_clear_components (metad);
+	as_metadata_set_locale (metad, "de_DE");
+	as_metadata_parse_file (metad, file, AS_FORMAT_KIND_XML, &error);
+	cpt = as_metadata_get_component (metad);
+	g_assert_no_error (error);
+	g_assert_cmpstr (as_component_get_name (cpt), ==, "Feuerfuchs");
+	as_metadata_set_parse_flags (metad, AS_PARSE_FLAG_NONE);
 }
 
 /**
@@ -287,6 +306,18 @@ test_appstream_write_locale (void)
 	g_object_unref (metad);
 }
 
+/**
+ * as_xml_test_write_chunk_cb:
+ *
+ * Collect chunks emitted by the streaming catalog serializer.
+ */
+static gboolean
+as_xml_test_write_chunk_cb (const gchar *data, gsize data_len, gpointer user_data)
+{
+	g_string_append_len ((GString *) user_data, data, data_len);
+	return TRUE;
+}
+
 /**
  * test_appstream_write_description:
  *
@@ -470,6 +501,18 @@ test_appstream_write_description (void)
 	/* test catalog XML conversion */
 	tmp = as_metadata_components_to_catalog (metad, AS_FORMAT_KIND_XML, NULL);
 	g_assert_true (as_xml_test_compare_xml (tmp, EXPECTED_XML_DISTRO));
+
+	/* the streaming serializer must produce identical output */
+	{
+		g_autoptr(GString) stream_data = g_string_new ("");
+		g_assert_true (as_metadata_components_to_catalog_stream (metad,
+									 AS_FORMAT_KIND_XML,
+									 as_xml_test_write_chunk_cb,
+									 stream_data,
+									 &error));
+		g_assert_no_error (error);
+		g_assert_cmpstr (stream_data->str, ==, tmp);
+	}
 	g_free (tmp);
 
 	/* test catalog XMl -> metainfo XML */
@@ -2436,6 +2479,258 @@ test_xml_rw_references (void)
 	g_assert_true (as_xml_test_compare_xml (res, xmldata_tags));
 }
 
+/**
+ * test_xml_rw_catalog_delta:
+ *
+ * Test creating delta catalog data and applying it on top of a base catalog.
+ */
+static void
+test_xml_rw_catalog_delta (void)
+{
+	static const gchar *xmldata_base =
+	    "<components version=\"1.0\" origin=\"example\">\n"
+	    "  <component>\n"
+	    "    <id>org.example.Alpha</id>\n"
+	    "    <name>Alpha</name>\n"
+	    "    <summary>The first component.</summary>\n"
+	    "  </component>\n"
+	    "  <component>\n"
+	    "    <id>org.example.Beta</id>\n"
+	    "    <name>Beta</name>\n"
+	    "    <summary>The second component.</summary>\n"
+	    "  </component>\n"
+	    "</components>\n";
+	static const gchar *xmldata_delta_expected =
+	    "<components type=\"delta\" version=\"1.0\" base_checksum=\"1234abcd\" "
+	    "origin=\"example\">\n"
+	    "  <component>\n"
+	    "    <id>org.example.Alpha</id>\n"
+	    "    <name>Alpha</name>\n"
+	    "    <summary>The first component, updated.</summary>\n"
+	    "  </component>\n"
+	    "  <removed id=\"org.example.Beta\"/>\n"
+	    "</components>\n";
+	g_autoptr(AsMetadata) metad = NULL;
+	g_autoptr(AsMetadata) metad_delta = NULL;
+	g_autoptr(AsComponent) ncpt = NULL;
+	g_autoptr(GPtrArray) removed_ids = NULL;
+	g_autofree gchar *delta_xml = NULL;
+	g_autoptr(GError) error = NULL;
+	AsComponentBox *cbox;
+
+	/* create delta catalog data */
+	metad_delta = as_metadata_new ();
+	as_metadata_set_locale (metad_delta, "ALL");
+	as_metadata_set_origin (metad_delta, "example");
+
+	ncpt = as_component_new ();
+	as_component_set_kind (ncpt, AS_COMPONENT_KIND_GENERIC);
+	as_component_set_id (ncpt, "org.example.Alpha");
+	as_component_set_name (ncpt, "Alpha", "C");
+	as_component_set_summary (ncpt, "The first component, updated.", "C");
+	as_metadata_add_component (metad_delta, ncpt);
+
+	removed_ids = g_ptr_array_new_with_free_func (g_free);
+	g_ptr_array_add (removed_ids, g_strdup ("org.example.Beta"));
+
+	delta_xml = as_metadata_components_to_catalog_delta (metad_delta, "1234abcd", removed_ids);
+	g_assert_true (as_xml_test_compare_xml (delta_xml, xmldata_delta_expected));
+
+	/* apply the delta on top of the base catalog */
+	metad = as_metadata_new ();
+	as_metadata_set_locale (metad, "ALL");
+	as_metadata_set_format_style (metad, AS_FORMAT_STYLE_CATALOG);
+
+	as_metadata_parse_data (metad, xmldata_base, -1, AS_FORMAT_KIND_XML, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (as_component_box_len (as_metadata_get_components (metad)), ==, 2);
+
+	as_metadata_add_delta_base_checksum (metad, "1234abcd");
+	as_metadata_parse_data (metad, delta_xml, -1, AS_FORMAT_KIND_XML, &error);
+	g_assert_no_error (error);
+
+	cbox = as_metadata_get_components (metad);
+	g_assert_cmpint (as_component_box_len (cbox), ==, 1);
+	g_assert_cmpstr (as_component_get_id (as_component_box_index (cbox, 0)),
+			 ==,
+			 "org.example.Alpha");
+	g_assert_cmpstr (as_component_get_summary (as_component_box_index (cbox, 0)),
+			 ==,
+			 "The first component, updated.");
+
+	/* deltas made for an unknown base catalog must be rejected */
+	g_object_unref (g_steal_pointer (&metad));
+	metad = as_metadata_new ();
+	as_metadata_set_locale (metad, "ALL");
+	as_metadata_set_format_style (metad, AS_FORMAT_STYLE_CATALOG);
+
+	as_metadata_add_delta_base_checksum (metad, "something-else");
+	as_metadata_parse_data (metad, delta_xml, -1, AS_FORMAT_KIND_XML, &error);
+	g_assert_error (error, AS_METADATA_ERROR, AS_METADATA_ERROR_FAILED);
+	g_clear_error (&error);
+	g_assert_true (as_component_box_is_empty (as_metadata_get_components (metad)));
+}
+
+/**
+ * test_xml_write_catalog_sharded:
+ *
+ * Test writing a sharded catalog with an index manifest and reading
+ * all shards back.
+ */
+static void
+test_xml_write_catalog_sharded (void)
+{
+	g_autoptr(AsMetadata) metad = NULL;
+	g_autoptr(AsMetadata) metad_read = NULL;
+	g_autofree gchar *tmpdir = NULL;
+	g_autofree gchar *manifest_fname = NULL;
+	g_autofree gchar *manifest_data = NULL;
+	g_autoptr(GPtrArray) shard_fnames = NULL;
+	g_autoptr(GError) error = NULL;
+	gboolean ret;
+
+	metad = as_metadata_new ();
+	as_metadata_set_locale (metad, "ALL");
+	as_metadata_set_origin (metad, "example");
+
+	for (guint i = 0; i < 24; i++) {
+		g_autoptr(AsComponent) cpt = as_component_new ();
+		g_autofree gchar *cid = g_strdup_printf ("org.example.App%02u", i);
+		as_component_set_kind (cpt, AS_COMPONENT_KIND_GENERIC);
+		as_component_set_id (cpt, cid);
+		as_component_set_name (cpt, "Test", "C");
+		as_component_set_summary (cpt, "Sharded catalog test.", "C");
+		as_metadata_add_component (metad, cpt);
+	}
+
+	tmpdir = g_dir_make_tmp ("asmeta-shards-XXXXXX", &error);
+	g_assert_no_error (error);
+	manifest_fname = g_build_filename (tmpdir, "Components.shards.xml", NULL);
+
+	ret = as_metadata_save_catalog_sharded (metad,
+						manifest_fname,
+						AS_FORMAT_KIND_XML,
+						4,
+						&error);
+	g_assert_no_error (error);
+	g_assert_true (ret);
+
+	/* read the manifest and parse every referenced shard */
+	g_assert_true (g_file_get_contents (manifest_fname, &manifest_data, NULL, NULL));
+
+	shard_fnames = g_ptr_array_new_with_free_func (g_free);
+	{
+		g_auto(GStrv) lines = g_strsplit (manifest_data, "\n", -1);
+		for (guint i = 0; lines[i] != NULL; i++) {
+			g_autofree gchar *shard_base = NULL;
+			gchar *start, *end;
+
+			start = g_strrstr (lines[i], "<shard");
+			if (start == NULL)
+				continue;
+			start = g_strstr_len (start, -1, ">");
+			g_assert_nonnull (start);
+			end = g_strrstr (lines[i], "</shard>");
+			g_assert_nonnull (end);
+
+			shard_base = g_strndup (start + 1, end - start - 1);
+			g_ptr_array_add (shard_fnames,
+					 g_build_filename (tmpdir, shard_base, NULL));
+		}
+	}
+	g_assert_cmpint (shard_fnames->len, >, 1);
+
+	metad_read = as_metadata_new ();
+	as_metadata_set_locale (metad_read, "ALL");
+	as_metadata_set_format_style (metad_read, AS_FORMAT_STYLE_CATALOG);
+	for (guint i = 0; i < shard_fnames->len; i++) {
+		g_autoptr(GFile) file = g_file_new_for_path (
+		    (const gchar *) g_ptr_array_index (shard_fnames, i));
+		as_metadata_parse_file (metad_read, file, AS_FORMAT_KIND_UNKNOWN, &error);
+		g_assert_no_error (error);
+	}
+
+	/* all components must turn up in exactly one shard */
+	g_assert_cmpint (as_component_box_len (as_metadata_get_components (metad_read)), ==, 24);
+
+	/* cleanup */
+	for (guint i = 0; i < shard_fnames->len; i++)
+		g_remove ((const gchar *) g_ptr_array_index (shard_fnames, i));
+	g_remove (manifest_fname);
+	g_remove (tmpdir);
+}
+
+/**
+ * test_xml_write_catalog_checksums:
+ *
+ * Test canonical checksum computation during catalog serialization.
+ */
+static void
+test_xml_write_catalog_checksums (void)
+{
+	g_autoptr(AsMetadata) metad = NULL;
+	g_autoptr(AsComponent) cpt1 = NULL;
+	g_autoptr(AsComponent) cpt2 = NULL;
+	g_autofree gchar *catalog_cksum1 = NULL;
+	g_autofree gchar *cpt1_cksum1 = NULL;
+	g_autofree gchar *cpt2_cksum1 = NULL;
+	g_autofree gchar *tmp = NULL;
+
+	metad = as_metadata_new ();
+	as_metadata_set_locale (metad, "ALL");
+	as_metadata_set_origin (metad, "example");
+	as_metadata_set_compute_checksums (metad, TRUE);
+	g_assert_true (as_metadata_get_compute_checksums (metad));
+
+	cpt1 = as_component_new ();
+	as_component_set_kind (cpt1, AS_COMPONENT_KIND_GENERIC);
+	as_component_set_id (cpt1, "org.example.CksumOne");
+	as_component_set_name (cpt1, "One", "C");
+	as_component_set_summary (cpt1, "First checksum test component.", "C");
+	as_metadata_add_component (metad, cpt1);
+
+	cpt2 = as_component_new ();
+	as_component_set_kind (cpt2, AS_COMPONENT_KIND_GENERIC);
+	as_component_set_id (cpt2, "org.example.CksumTwo");
+	as_component_set_name (cpt2, "Two", "C");
+	as_component_set_summary (cpt2, "Second checksum test component.", "C");
+	as_metadata_add_component (metad, cpt2);
+
+	/* nothing was serialized yet */
+	g_assert_null (as_metadata_get_catalog_checksum (metad));
+
+	tmp = as_metadata_components_to_catalog (metad, AS_FORMAT_KIND_XML, NULL);
+	g_assert_nonnull (tmp);
+
+	catalog_cksum1 = g_strdup (as_metadata_get_catalog_checksum (metad));
+	cpt1_cksum1 = g_strdup (as_metadata_get_component_checksum (metad, "org.example.CksumOne"));
+	cpt2_cksum1 = g_strdup (as_metadata_get_component_checksum (metad, "org.example.CksumTwo"));
+	g_assert_nonnull (catalog_cksum1);
+	g_assert_nonnull (cpt1_cksum1);
+	g_assert_nonnull (cpt2_cksum1);
+	g_assert_null (as_metadata_get_component_checksum (metad, "org.example.Unknown"));
+
+	/* an unchanged serialization must yield identical digests */
+	g_free (tmp);
+	tmp = as_metadata_components_to_catalog (metad, AS_FORMAT_KIND_XML, NULL);
+	g_assert_cmpstr (as_metadata_get_catalog_checksum (metad), ==, catalog_cksum1);
+	g_assert_cmpstr (as_metadata_get_component_checksum (metad, "org.example.CksumOne"),
+			 ==,
+			 cpt1_cksum1);
+
+	/* changing one component must only change its own digest (and the catalog one) */
+	as_component_set_summary (cpt2, "Second checksum test component, modified.", "C");
+	g_free (tmp);
+	tmp = as_metadata_components_to_catalog (metad, AS_FORMAT_KIND_XML, NULL);
+	g_assert_cmpstr (as_metadata_get_catalog_checksum (metad), !=, catalog_cksum1);
+	g_assert_cmpstr (as_metadata_get_component_checksum (metad, "org.example.CksumOne"),
+			 ==,
+			 cpt1_cksum1);
+	g_assert_cmpstr (as_metadata_get_component_checksum (metad, "org.example.CksumTwo"),
+			 !=,
+			 cpt2_cksum1);
+}
+
 /**
  * main:
  */
@@ -2509,6 +2804,9 @@ main (int argc, char **argv)
 	g_test_add_func ("/XML/ReadWrite/Developer", test_xml_rw_developer);
 	g_test_add_func ("/XML/ReadWrite/ExternalReleases", test_xml_rw_external_releases);
 	g_test_add_func ("/XML/ReadWrite/References", test_xml_rw_references);
+	g_test_add_func ("/XML/ReadWrite/CatalogDelta", test_xml_rw_catalog_delta);
+	g_test_add_func ("/XML/Write/CatalogSharded", test_xml_write_catalog_sharded);
+	g_test_add_func ("/XML/Write/CatalogChecksums", test_xml_write_catalog_checksums);
 
 	ret = g_test_run ();
 	g_free (datadir);
@@ -183,7 +183,14 @@ main (int argc, char **argv)
 	g_autofree gchar *components_str = NULL;
 	g_autofree gchar *icon_policy_str = NULL;
 	g_autofree gchar *custom_keys_str = NULL;
+	g_autofree gchar *fc_cache_dir = NULL;
+	g_autofree gchar *stats_file = NULL;
 	gboolean no_partial_urls = FALSE;
+	gboolean verify_output = FALSE;
+	gboolean spill_results = FALSE;
+	gboolean emit_search_tokens = FALSE;
+	gint max_memory_mib = 0;
+	gint stage_budget_secs = 0;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(AscCompose) compose = NULL;
 	AscComposeFlags compose_flags;
@@ -310,6 +317,55 @@ main (int argc, char **argv)
 		  _("A comma-separated list of component-IDs to accept."),
 		  "COMPONENT-IDs" },
 
+		{ "verify-output",
+		  '\0', 0,
+		  G_OPTION_ARG_NONE, &verify_output,
+		  /* TRANSLATORS: ascompose flag description for: --verify-output */
+		  _("Validate the generated output and report any issues found with it as hints."),
+		  NULL },
+
+		{ "spill-results",
+		  '\0', 0,
+		  G_OPTION_ARG_NONE, &spill_results,
+		  /* TRANSLATORS: ascompose flag description for: --spill-results */
+		  _("Serialize finished results to temporary disk storage immediately, so composing very large data sets needs much less memory."),
+		  NULL },
+
+		{ "emit-search-tokens",
+		  '\0', 0,
+		  G_OPTION_ARG_NONE, &emit_search_tokens,
+		  /* TRANSLATORS: ascompose flag description for: --emit-search-tokens */
+		  _("Emit a prebuilt search token index for each component into the XML catalog output."),
+		  NULL },
+
+		{ "max-memory",
+		  '\0', 0,
+		  G_OPTION_ARG_INT, &max_memory_mib,
+		  /* TRANSLATORS: ascompose flag description for: --max-memory */
+		  _("Set a memory budget in MiB that parallel processing should try to stay below."),
+		  "MiB" },
+
+		{ "stage-time-budget",
+		  '\0', 0,
+		  G_OPTION_ARG_INT, &stage_budget_secs,
+		  /* TRANSLATORS: ascompose flag description for: --stage-time-budget */
+		  _("Time in seconds a single processing stage of a unit may take before the unit is flagged as too slow."),
+		  "SECONDS" },
+
+		{ "stats-file",
+		  '\0', 0,
+		  G_OPTION_ARG_FILENAME, &stats_file,
+		  /* TRANSLATORS: ascompose flag description for: --stats-file */
+		  _("File to persist per-unit processing statistics in, used to schedule expensive units first on subsequent runs."),
+		  "FILE" },
+
+		{ "fontconfig-cache",
+		  '\0', 0,
+		  G_OPTION_ARG_FILENAME, &fc_cache_dir,
+		  /* TRANSLATORS: ascompose flag description for: --fontconfig-cache */
+		  _("Use a prebuilt fontconfig cache directory (read-only) instead of rebuilding the font caches."),
+		  "DIR" },
+
 		{ NULL }
 	};
 	/* clang-format on */
@@ -379,8 +435,24 @@ main (int argc, char **argv)
 		as_flags_remove (compose_flags, ASC_COMPOSE_FLAG_ALLOW_NET);
 	if (no_partial_urls)
 		as_flags_add (compose_flags, ASC_COMPOSE_FLAG_NO_PARTIAL_URLS);
+	if (verify_output)
+		as_flags_add (compose_flags, ASC_COMPOSE_FLAG_VERIFY_RESULTS);
+	if (spill_results)
+		as_flags_add (compose_flags, ASC_COMPOSE_FLAG_SPILL_RESULTS);
+	if (emit_search_tokens)
+		as_flags_add (compose_flags, ASC_COMPOSE_FLAG_EMIT_SEARCH_TOKENS);
 	asc_compose_set_flags (compose, compose_flags);
 
+	/* use a prebuilt font cache bundle, if one was provided */
+	if (fc_cache_dir != NULL) {
+		if (!asc_globals_set_fontconfig_cache_dir (fc_cache_dir, &error)) {
+			/* TRANSLATORS: Error message of appstream-compose */
+			ascli_print_stderr (_("Unable to use the prebuilt font cache: %s"),
+					    error->message);
+			return EXIT_FAILURE;
+		}
+	}
+
 	/* sanity checks & defaults */
 	if (prefix == NULL)
 		prefix = g_strdup ("/usr");
@@ -430,6 +502,11 @@ main (int argc, char **argv)
 	asc_compose_set_hints_result_dir (compose, hints_dir);
 	asc_compose_set_media_result_dir (compose, media_dir);
 	asc_compose_set_media_baseurl (compose, media_baseurl);
+	if (max_memory_mib > 0)
+		asc_compose_set_max_memory_usage (compose, (guint64) max_memory_mib * 1024 * 1024);
+	if (stage_budget_secs > 0)
+		asc_compose_set_stage_time_budget (compose, (guint) stage_budget_secs);
+	asc_compose_set_stats_cache_file (compose, stats_file);
 
 	/* we need at least one unit to process */
 	if (argc <= 1) {
@@ -109,12 +109,31 @@ const GOptionEntry find_options[] = {
 	{ NULL }
 };
 
+/* used by dump_options */
+static gboolean optn_dump_raw = FALSE;
+
+/**
+ * Options for dumping metadata.
+ */
+const GOptionEntry dump_options[] = {
+	{ "raw",
+	  0, 0,
+	  G_OPTION_ARG_NONE, &optn_dump_raw,
+	  /* TRANSLATORS: ascli flag description for: --raw (used by the "dump" command) */
+	  N_ ("Dump the cached catalog XML directly, without reprocessing the data. "
+	      "If no component-ID is given, all components are exported."),
+	  NULL },
+	{ NULL }
+};
+
 /* used by validate_options */
 static gboolean optn_pedantic = FALSE;
 static gboolean optn_explain = FALSE;
 static gboolean optn_no_net = FALSE;
 static gboolean optn_validate_strict = FALSE;
 static gchar *optn_issue_overrides = NULL;
+static gint optn_jobs = 0;
+static gboolean optn_use_cache = FALSE;
 
 /**
  * General options for validation.
@@ -160,6 +179,19 @@ const GOptionEntry validate_options[] = {
 	  /* TRANSLATORS: ascli flag description for: --override  when validating XML files */
 	  N_ ("Override the severities of selected issue tags."),
 	  NULL },
+	{ "jobs",
+	  'j', 0,
+	  G_OPTION_ARG_INT, &optn_jobs,
+	  /* TRANSLATORS: ascli flag description for: --jobs (used by the "validate-tree" command) */
+	  N_ ("Amount of parallel validation jobs to run (0 to select automatically)."),
+	  NULL },
+	{ "use-cache",
+	  (gchar) 0,
+	  0, G_OPTION_ARG_NONE,
+	  &optn_use_cache,
+	  /* TRANSLATORS: ascli flag description for: --use-cache (used by the "validate-tree" command) */
+	  N_ ("Cache validation results and reuse them for files that did not change."),
+	  NULL },
 
 	{ NULL }
 };
@@ -310,6 +342,39 @@ as_client_run_refresh_cache (const gchar *command, char **argv, int argc)
 				    optn_force);
 }
 
+/**
+ * as_client_run_vacuum_cache:
+ *
+ * Clean up the per-user AppStream caches.
+ */
+static int
+as_client_run_vacuum_cache (const gchar *command, char **argv, int argc)
+{
+	g_autoptr(GOptionContext) opt_context = NULL;
+	gint ret;
+	gint optn_size_budget = 0;
+
+	const GOptionEntry vacuum_options[] = {
+		{ "size-budget",
+		  (gchar) 0,
+		  0, G_OPTION_ARG_INT,
+		  &optn_size_budget,
+		  /* TRANSLATORS: ascli flag description for: --size-budget in a cache vacuum action */
+		  _("Maximum size of the user cache directory in MiB (0 to use the default budget)."),
+		     NULL },
+		  { NULL }
+	};
+
+	opt_context = as_client_new_subcommand_option_context (command, vacuum_options);
+	g_option_context_add_main_entries (opt_context, data_catalog_options, NULL);
+
+	ret = as_client_option_context_parse (opt_context, command, &argc, &argv);
+	if (ret != 0)
+		return ret;
+
+	return ascli_vacuum_cache (optn_cachepath, optn_size_budget);
+}
+
 /**
  * as_client_run_search:
  *
@@ -321,9 +386,28 @@ as_client_run_search (const gchar *command, char **argv, int argc)
 	g_autoptr(GOptionContext) opt_context = NULL;
 	g_autoptr(GString) search = NULL;
 	gint ret;
+	gint optn_limit = 0;
+	gint optn_offset = 0;
+
+	const GOptionEntry search_options[] = {
+		{ "limit",
+		  (gchar) 0,
+		  0, G_OPTION_ARG_INT,
+		  &optn_limit,
+		  /* TRANSLATORS: ascli flag description for: --limit in a search action */
+		  _("Maximum number of results to display (0 for unlimited)."), NULL },
+		  { "offset",
+		    (gchar) 0,
+		    0, G_OPTION_ARG_INT,
+		    &optn_offset,
+		    /* TRANSLATORS: ascli flag description for: --offset in a search action */
+		    _("Number of top-ranked results to skip before displaying anything."), NULL },
+		    { NULL }
+	};
 
 	opt_context = as_client_new_subcommand_option_context (command, find_options);
 	g_option_context_add_main_entries (opt_context, data_catalog_options, NULL);
+	g_option_context_add_main_entries (opt_context, search_options, NULL);
 
 	ret = as_client_option_context_parse (opt_context, command, &argc, &argv);
 	if (ret != 0)
@@ -343,7 +427,44 @@ as_client_run_search (const gchar *command, char **argv, int argc)
 	return ascli_search_component (optn_cachepath,
 				       (search->len == 0) ? NULL : search->str,
 				       optn_details,
-				       optn_no_cache);
+				       optn_no_cache,
+				       (optn_limit > 0) ? (guint) optn_limit : 0,
+				       (optn_offset > 0) ? (guint) optn_offset : 0);
+}
+
+/**
+ * as_client_run_explain_query:
+ *
+ * Run a search query with instrumentation enabled and show query statistics.
+ */
+static int
+as_client_run_explain_query (const gchar *command, char **argv, int argc)
+{
+	g_autoptr(GOptionContext) opt_context = NULL;
+	g_autoptr(GString) search = NULL;
+	gint ret;
+
+	opt_context = as_client_new_subcommand_option_context (command, find_options);
+	g_option_context_add_main_entries (opt_context, data_catalog_options, NULL);
+
+	ret = as_client_option_context_parse (opt_context, command, &argc, &argv);
+	if (ret != 0)
+		return ret;
+
+	search = g_string_new ("");
+	if (argc > 2) {
+		for (gint i = 2; i < argc; i++) {
+			g_string_append (search, argv[i]);
+			g_string_append_c (search, ' ');
+		}
+		/* drop trailing space */
+		if (search->len > 0)
+			g_string_truncate (search, search->len - 1);
+	}
+
+	return ascli_explain_query (optn_cachepath,
+				    (search->len == 0) ? NULL : search->str,
+				    optn_no_cache);
 }
 
 /**
@@ -386,6 +507,7 @@ as_client_run_dump (const gchar *command, char **argv, int argc)
 
 	opt_context = as_client_new_subcommand_option_context (command, data_catalog_options);
 	g_option_context_add_main_entries (opt_context, format_options, NULL);
+	g_option_context_add_main_entries (opt_context, dump_options, NULL);
 
 	ret = as_client_option_context_parse (opt_context, command, &argc, &argv);
 	if (ret != 0)
@@ -395,7 +517,7 @@ as_client_run_dump (const gchar *command, char **argv, int argc)
 		value = argv[2];
 
 	mformat = as_format_kind_from_string (optn_format);
-	return ascli_dump_component (optn_cachepath, value, mformat, optn_no_cache);
+	return ascli_dump_component (optn_cachepath, value, mformat, optn_no_cache, optn_dump_raw);
 }
 
 /**
@@ -515,13 +637,17 @@ as_client_run_validate_tree (const gchar *command, char **argv, int argc)
 					    optn_explain,
 					    optn_validate_strict,
 					    !optn_no_net,
-					    optn_issue_overrides);
+					    optn_issue_overrides,
+					    optn_jobs > 0 ? (guint) optn_jobs : 0,
+					    optn_use_cache);
 	} else {
 		return ascli_validate_tree_format (value,
 						   optn_format,
 						   optn_validate_strict,
 						   !optn_no_net,
-						   optn_issue_overrides);
+						   optn_issue_overrides,
+						   optn_jobs > 0 ? (guint) optn_jobs : 0,
+						   optn_use_cache);
 	}
 }
 
@@ -1347,6 +1473,7 @@ as_client_run (char **argv, int argc)
 	g_autoptr(AsProfile) profile = NULL;
 	AsProfileTask *ptask;
 	gboolean enable_profiling = FALSE;
+	g_autofree gchar *profile_format = NULL;
 	gint retval = 0;
 	const gchar *command = NULL;
 
@@ -1373,6 +1500,12 @@ as_client_run (char **argv, int argc)
 			G_OPTION_ARG_NONE, &enable_profiling,
 			/* TRANSLATORS: ascli flag description for: --profile */
 			_("Enable profiling"), NULL },
+			{ "profile-format",
+			  '\0', 0,
+			  G_OPTION_ARG_STRING, &profile_format,
+			  /* TRANSLATORS: ascli flag description for: --profile-format */
+			  _("Output format for profiling data (timechart, json or folded)."),
+			  "FORMAT" },
 			{ NULL }
 	 };
 
@@ -1427,6 +1560,22 @@ as_client_run (char **argv, int argc)
 		       NULL,
 		       /* TRANSLATORS: `appstreamcli refresh-cache` command description. */
 		       _("Rebuild the component metadata cache."), as_client_run_refresh_cache);
+	ascli_add_cmd (commands,
+		       1,
+		       "vacuum-cache",
+		       "vacuum",
+		       NULL,
+		       /* TRANSLATORS: `appstreamcli vacuum-cache` command description. */
+		       _("Remove stale per-user metadata caches and enforce a cache size budget."),
+			  as_client_run_vacuum_cache);
+	ascli_add_cmd (commands,
+		       1,
+		       "explain-query",
+		       NULL,
+		       "TERM",
+		       /* TRANSLATORS: `appstreamcli explain-query` command description. */
+		       _("Run a search query with instrumentation enabled and show statistics about the performed metadata queries."),
+			  as_client_run_explain_query);
 
 	ascli_add_cmd (commands,
 		       2,
@@ -1641,6 +1790,8 @@ as_client_run (char **argv, int argc)
 
 	/* prepare profiler */
 	profile = as_profile_new ();
+	if (enable_profiling || profile_format != NULL)
+		as_profile_set_mem_accounting (profile, TRUE);
 
 	/* run subcommand */
 	ptask = as_profile_start (profile, "%s: %s", argv[0], command);
@@ -1648,8 +1799,19 @@ as_client_run (char **argv, int argc)
 	as_profile_task_free (ptask);
 
 	/* profile */
-	if (enable_profiling)
-		as_profile_dump (profile);
+	if (enable_profiling || profile_format != NULL) {
+		if (g_strcmp0 (profile_format, "json") == 0) {
+			g_autofree gchar *json = as_profile_export_to_json (profile);
+			g_print ("%s\n", json);
+		} else if (g_strcmp0 (profile_format, "folded") == 0) {
+			as_profile_dump_folded (profile);
+		} else {
+			g_autofree gchar *mem_report = NULL;
+			as_profile_dump (profile);
+			mem_report = as_profile_get_mem_report (profile);
+			g_printerr ("%s", mem_report);
+		}
+	}
 
 	return retval;
 }
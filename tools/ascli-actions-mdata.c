@@ -28,6 +28,7 @@
 #include "ascli-utils.h"
 #include "as-utils-private.h"
 #include "as-pool-private.h"
+#include "as-cache.h"
 
 /**
  * ascli_refresh_cache:
@@ -111,6 +112,39 @@ ascli_refresh_cache (const gchar *cachepath,
 	return 0;
 }
 
+/**
+ * ascli_vacuum_cache:
+ */
+int
+ascli_vacuum_cache (const gchar *cachepath, gint size_budget_mib)
+{
+	g_autoptr(AsCache) cache = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autofree gchar *freed_str = NULL;
+	g_autofree gchar *tmp = NULL;
+	guint64 bytes_freed = 0;
+
+	cache = as_cache_new ();
+	if (cachepath != NULL)
+		as_cache_set_locations (cache, cachepath, cachepath);
+
+	if (!as_cache_vacuum (cache,
+			      size_budget_mib > 0 ? (guint64) size_budget_mib * 1024 * 1024 : 0,
+			      &bytes_freed,
+			      &error)) {
+		g_printerr ("✘ %s\n", error->message);
+		return 2;
+	}
+
+	freed_str = g_format_size (bytes_freed);
+	/* TRANSLATORS: In ascli: The cache vacuum operation finished, %s is an amount of reclaimed disk space, e.g. "2.4 MB" */
+	tmp = g_strdup_printf (_("Cache was vacuumed successfully, %s of disk space were reclaimed."),
+			       freed_str);
+	g_print ("✔ %s\n", tmp);
+
+	return 0;
+}
+
 /**
  * ascli_get_component:
  *
@@ -156,7 +190,9 @@ int
 ascli_search_component (const gchar *cachepath,
 			const gchar *search_term,
 			gboolean detailed,
-			gboolean no_cache)
+			gboolean no_cache,
+			guint limit,
+			guint offset)
 {
 	g_autoptr(AsPool) pool = NULL;
 	g_autoptr(AsComponentBox) result = NULL;
@@ -173,15 +209,77 @@ ascli_search_component (const gchar *cachepath,
 		return 1;
 	}
 
-	result = as_pool_search (pool, search_term);
-	if (as_component_box_is_empty (result)) {
+	/* if only one result page is requested, we can stop materializing components
+	 * from the cache as soon as that page is filled */
+	if (limit > 0)
+		result = as_pool_search_ranked (pool, search_term, offset + limit);
+	else
+		result = as_pool_search (pool, search_term);
+
+	if (as_component_box_is_empty (result) || offset >= as_component_box_len (result)) {
 		/* TRANSLATORS: We got no full-text search results */
 		ascli_print_stdout (_("No component matching '%s' found."), search_term);
 		return 0;
 	}
 
-	/* show the result */
-	ascli_print_components (result, detailed);
+	/* show the result, or just the requested page of it */
+	if (offset > 0 || limit > 0) {
+		g_autoptr(AsComponentBox) page = as_component_box_new_simple ();
+		guint page_end = as_component_box_len (result);
+
+		if (limit > 0 && offset + limit < page_end)
+			page_end = offset + limit;
+		for (guint i = offset; i < page_end; i++)
+			as_component_box_add (page, as_component_box_index (result, i), NULL);
+		ascli_print_components (page, detailed);
+	} else {
+		ascli_print_components (result, detailed);
+	}
+
+	return 0;
+}
+
+/**
+ * ascli_explain_query:
+ *
+ * Run a full-text search with query instrumentation enabled and
+ * display the recorded per-query statistics.
+ */
+int
+ascli_explain_query (const gchar *cachepath, const gchar *search_term, gboolean no_cache)
+{
+	g_autoptr(AsPool) pool = NULL;
+	g_autoptr(AsComponentBox) result = NULL;
+	g_autofree gchar *stats_report = NULL;
+	g_autoptr(GError) error = NULL;
+
+	if (search_term == NULL) {
+		fprintf (stderr, "%s\n", _("You need to specify a term to search for."));
+		return 2;
+	}
+
+	pool = ascli_data_pool_new_and_open (cachepath, no_cache, &error);
+	if (error != NULL) {
+		g_printerr ("%s\n", error->message);
+		return 1;
+	}
+	as_pool_set_query_stats_enabled (pool, TRUE);
+
+	result = as_pool_search (pool, search_term);
+	/* TRANSLATORS: Result summary of an `appstreamcli explain-query` run */
+	ascli_print_stdout (_("The query for '%s' returned %i results."),
+			    search_term,
+			    as_component_box_len (result));
+
+	stats_report = as_pool_get_query_stats_report (pool);
+	if (stats_report == NULL) {
+		/* TRANSLATORS: The query instrumentation of `appstreamcli explain-query` yielded no data */
+		g_printerr ("%s\n", _("No query statistics were recorded."));
+		return 1;
+	}
+
+	/* the statistics table is debug output and therefore not translated */
+	g_print ("\n%s", stats_report);
 
 	return 0;
 }
@@ -285,25 +383,54 @@ int
 ascli_dump_component (const gchar *cachepath,
 		      const gchar *identifier,
 		      AsFormatKind mformat,
-		      gboolean no_cache)
+		      gboolean no_cache,
+		      gboolean raw)
 {
 	g_autoptr(AsPool) pool = NULL;
 	g_autoptr(AsComponentBox) result = NULL;
 	g_autoptr(AsMetadata) metad = NULL;
 	g_autoptr(GError) error = NULL;
 
-	if (identifier == NULL) {
+	if (identifier == NULL && !raw) {
 		/* TRANSLATORS: ascli was told to find a software component by its ID, but no component-id was specified. */
 		fprintf (stderr, "%s\n", _("You need to specify a component-ID."));
 		return 2;
 	}
 
+	if (raw && mformat == AS_FORMAT_KIND_YAML) {
+		/* TRANSLATORS: The user combined `appstreamcli dump --raw` with an incompatible format selection */
+		fprintf (stderr, "%s\n", _("Only XML data can be dumped in raw form."));
+		return 2;
+	}
+
 	pool = ascli_data_pool_new_and_open (cachepath, no_cache, &error);
 	if (error != NULL) {
 		g_printerr ("%s\n", error->message);
 		return 1;
 	}
 
+	if (raw) {
+		g_autoptr(GPtrArray) fragments = NULL;
+
+		/* stream the cached XML fragments directly, without the costly detour
+		 * through AsComponent deserialization and re-serialization */
+		fragments = as_pool_get_components_xml_by_id (pool, identifier, &error);
+		if (fragments == NULL) {
+			g_printerr ("%s\n", error->message);
+			return 1;
+		}
+		if (fragments->len == 0 && identifier != NULL) {
+			ascli_print_stderr (_("Unable to find component with ID '%s'!"),
+					    identifier);
+			return 4;
+		}
+
+		for (guint i = 0; i < fragments->len; i++)
+			g_print ("%s\n", (const gchar *) g_ptr_array_index (fragments, i));
+
+		return 0;
+	}
+
 	result = as_pool_get_components_by_id (pool, identifier);
 	if (as_component_box_is_empty (result)) {
 		ascli_print_stderr (_("Unable to find component with ID '%s'!"), identifier);
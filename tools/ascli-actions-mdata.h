@@ -34,7 +34,11 @@ int  ascli_what_provides (const gchar *cachepath,
 int  ascli_search_component (const gchar *cachepath,
 			     const gchar *search_term,
 			     gboolean	  detailed,
-			     gboolean	  no_cache);
+			     gboolean	  no_cache,
+			     guint	  limit,
+			     guint	  offset);
+
+int  ascli_explain_query (const gchar *cachepath, const gchar *search_term, gboolean no_cache);
 
 int  ascli_get_component (const gchar *cachepath,
 			  const gchar *identifier,
@@ -51,10 +55,13 @@ int  ascli_refresh_cache (const gchar	     *cachepath,
 			  const gchar *const *sources_str,
 			  gboolean	      forced);
 
+int  ascli_vacuum_cache (const gchar *cachepath, gint size_budget_mib);
+
 int  ascli_dump_component (const gchar *cachepath,
 			   const gchar *identifier,
 			   AsFormatKind mformat,
-			   gboolean	no_cache);
+			   gboolean	no_cache,
+			   gboolean	raw);
 
 int  ascli_put_metainfo (const gchar *fname, const gchar *origin, gboolean for_user);
 
@@ -26,6 +26,7 @@
 #include "as-utils-private.h"
 #include "as-macros-private.h"
 #include "as-pool-private.h"
+#include "as-cache.h"
 #include "ascli-utils.h"
 #include "as-component.h"
 #include "as-news-convert.h"
@@ -92,6 +93,33 @@ ascli_show_status (void)
 					  error->message);
 		ascli_print_stderr ("%s %s", ASCLI_CHAR_FAIL, tmp);
 	}
+	g_print ("\n");
+
+	/* TRANSLATORS: In the status report of ascli: Header for cache usage counters of this process */
+	ascli_print_highlight (_("Cache activity (this process):"));
+	{
+		AsCacheUsageCounters counters;
+		g_autofree gchar *queries_str = NULL;
+		g_autofree gchar *sections_str = NULL;
+		g_autofree gchar *cpts_str = NULL;
+		g_autofree gchar *mapped_size_str = NULL;
+
+		as_cache_get_usage_counters (&counters);
+		queries_str = g_strdup_printf ("%" G_GUINT64_FORMAT, counters.queries_served);
+		sections_str = g_strdup_printf ("%" G_GUINT64_FORMAT, counters.sections_loaded);
+		cpts_str = g_strdup_printf ("%" G_GUINT64_FORMAT,
+					    counters.components_materialized);
+		mapped_size_str = g_format_size (counters.bytes_mapped);
+
+		/* TRANSLATORS: In ascli status: amount of cache queries this process has run */
+		ascli_print_stdout (_("Queries served: %s"), queries_str);
+		/* TRANSLATORS: In ascli status: amount of cache sections this process has loaded */
+		ascli_print_stdout (_("Sections loaded: %s"), sections_str);
+		/* TRANSLATORS: In ascli status: amount of components deserialized from cache data */
+		ascli_print_stdout (_("Components materialized: %s"), cpts_str);
+		/* TRANSLATORS: In ascli status: amount of cache data mapped into memory */
+		ascli_print_stdout (_("Cache data mapped: %s"), mapped_size_str);
+	}
 
 	return 0;
 }
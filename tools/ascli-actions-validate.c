@@ -112,14 +112,46 @@ create_issue_info_print_string (AsValidatorIssue *issue, guint indent)
 	return g_string_free (str, FALSE);
 }
 
+/**
+ * create_issue_snippet_print_string:
+ *
+ * Render the source lines around the issue location with a line-number gutter.
+ **/
+static gchar *
+create_issue_snippet_print_string (AsValidator *validator, AsValidatorIssue *issue, gint indent)
+{
+	GString *str;
+	g_autofree gchar *snippet = NULL;
+	g_auto(GStrv) lines = NULL;
+	glong first_line = 0;
+
+	snippet = as_validator_get_source_snippet (validator, issue, 2, &first_line);
+	if (snippet == NULL)
+		return NULL;
+
+	str = g_string_new ("");
+	lines = g_strsplit (snippet, "\n", -1);
+	for (guint i = 0; lines[i] != NULL; i++)
+		g_string_append_printf (str,
+					"%*s%4li | %s\n",
+					indent + 3,
+					"",
+					first_line + i,
+					lines[i]);
+
+	return g_string_free (str, FALSE);
+}
+
 /**
  * print_single_issue:
  **/
 static gboolean
-print_single_issue (AsValidatorIssue *issue,
+print_single_issue (AsValidator *validator,
+		    AsValidatorIssue *issue,
 		    gboolean pedantic,
 		    gboolean explained,
 		    gint indent,
+		    GHashTable *explain_cache,
 		    gulong *error_count,
 		    gulong *warning_count,
 		    gulong *info_count,
@@ -156,11 +188,30 @@ print_single_issue (AsValidatorIssue *issue,
 
 	title = create_issue_info_print_string (issue, indent);
 	if (explained) {
-		g_autofree gchar *explanation = ascli_format_long_output (
-		    as_validator_issue_get_explanation (issue),
-		    100,
-		    indent + 3);
-		g_print ("%s\n%s\n\n", title, explanation);
+		g_autofree gchar *snippet = NULL;
+		const gchar *explanation;
+
+		/* explanations are identical for all issues with the same tag, so we
+		 * render them only once per tag - with many issues, the line-wrapping
+		 * otherwise dominates the time spent on the report */
+		explanation = g_hash_table_lookup (explain_cache,
+						   as_validator_issue_get_tag (issue));
+		if (explanation == NULL) {
+			gchar *rendered = ascli_format_long_output (
+			    as_validator_issue_get_explanation (issue),
+			    100,
+			    indent + 3);
+			g_hash_table_insert (explain_cache,
+					     g_strdup (as_validator_issue_get_tag (issue)),
+					     rendered);
+			explanation = rendered;
+		}
+
+		snippet = create_issue_snippet_print_string (validator, issue, indent);
+		if (snippet != NULL)
+			g_print ("%s\n%s%s\n\n", title, snippet, explanation);
+		else
+			g_print ("%s\n%s\n\n", title, explanation);
 	} else {
 		g_print ("%s\n", title);
 	}
@@ -183,18 +234,25 @@ ascli_print_validation_result (AsValidator *validator,
 			       gulong *pedantic_count)
 {
 	GHashTable *issues_files;
-	GHashTableIter hiter;
-	gpointer hkey, hvalue;
+	g_autoptr(GList) files = NULL;
+	g_autoptr(GHashTable) explain_cache = NULL;
 	gboolean print_filenames;
 	gboolean validation_passed = TRUE;
 
+	/* cache of rendered explanation texts, keyed by issue tag */
+	explain_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
 	print_filenames = as_validator_get_issue_files_count (validator) > 1 || always_print_fnames;
 	issues_files = as_validator_get_issues_per_file (validator);
 
-	g_hash_table_iter_init (&hiter, issues_files);
-	while (g_hash_table_iter_next (&hiter, &hkey, &hvalue)) {
-		const gchar *filename = (const gchar *) hkey;
-		const GPtrArray *issues = (const GPtrArray *) hvalue;
+	/* print results sorted by filename, so the order is stable no matter
+	 * how many threads were used for validation */
+	files = g_hash_table_get_keys (issues_files);
+	files = g_list_sort (files, (GCompareFunc) g_strcmp0);
+	for (GList *link = files; link != NULL; link = link->next) {
+		const gchar *filename = (const gchar *) link->data;
+		const GPtrArray *issues = (const GPtrArray *)
+		    g_hash_table_lookup (issues_files, filename);
 
 		if (print_filenames) {
 			if (filename == NULL)
@@ -209,10 +267,12 @@ ascli_print_validation_result (AsValidator *validator,
 			AsValidatorIssue *issue = AS_VALIDATOR_ISSUE (
 			    g_ptr_array_index (issues, i));
 
-			if (!print_single_issue (issue,
+			if (!print_single_issue (validator,
+						 issue,
 						 pedantic,
 						 explain,
 						 print_filenames ? 2 : 0,
+						 explain_cache,
 						 error_count,
 						 warning_count,
 						 info_count,
@@ -538,7 +598,9 @@ ascli_validate_tree (const gchar *root_dir,
 		     gboolean explain,
 		     gboolean validate_strict,
 		     gboolean use_net,
-		     const gchar *overrides_str)
+		     const gchar *overrides_str,
+		     guint n_jobs,
+		     gboolean use_cache)
 {
 	gboolean validation_passed = TRUE;
 	AsValidator *validator;
@@ -555,6 +617,8 @@ ascli_validate_tree (const gchar *root_dir,
 	validator = as_validator_new ();
 	as_validator_set_allow_net (validator, use_net);
 	as_validator_set_strict (validator, validate_strict);
+	as_validator_set_max_threads (validator, n_jobs);
+	as_validator_set_use_result_cache (validator, use_cache);
 
 	if (!ascli_validate_apply_overrides_from_string (validator, overrides_str))
 		return 1;
@@ -609,7 +673,9 @@ ascli_validate_tree_format (const gchar *root_dir,
 			    const gchar *format,
 			    gboolean validate_strict,
 			    gboolean use_net,
-			    const gchar *overrides_str)
+			    const gchar *overrides_str,
+			    guint n_jobs,
+			    gboolean use_cache)
 {
 	if (g_strcmp0 (format, "text") == 0) {
 		/* "text" is pretty much the default output,
@@ -620,7 +686,9 @@ ascli_validate_tree_format (const gchar *root_dir,
 					    TRUE, /* explain */
 					    validate_strict,
 					    use_net,
-					    overrides_str);
+					    overrides_str,
+					    n_jobs,
+					    use_cache);
 	}
 
 	if (g_strcmp0 (format, "yaml") == 0) {
@@ -637,6 +705,8 @@ ascli_validate_tree_format (const gchar *root_dir,
 		validator = as_validator_new ();
 		as_validator_set_allow_net (validator, use_net);
 		as_validator_set_strict (validator, validate_strict);
+		as_validator_set_max_threads (validator, n_jobs);
+		as_validator_set_use_result_cache (validator, use_cache);
 		validation_passed = as_validator_validate_tree (validator, root_dir);
 
 		yaml_result = as_validator_get_report_yaml (validator, NULL);
@@ -44,12 +44,16 @@ gint ascli_validate_tree (const gchar *root_dir,
 			  gboolean     pedantic,
 			  gboolean     validate_strict,
 			  gboolean     use_net,
-			  const gchar *overrides_str);
+			  const gchar *overrides_str,
+			  guint	       n_jobs,
+			  gboolean     use_cache);
 gint ascli_validate_tree_format (const gchar *root_dir,
 				 const gchar *format,
 				 gboolean     validate_strict,
 				 gboolean     use_net,
-				 const gchar *overrides_str);
+				 const gchar *overrides_str,
+				 guint	       n_jobs,
+				 gboolean     use_cache);
 
 gint ascli_check_license (const gchar *license);
 